@@ -0,0 +1,90 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures AES throughput (GB/s) of the block, CTR and GCM paths on several message sizes
+*/
+
+template <class FUNC>
+static void Measure(const char* name, sl_size sizeMessage, const FUNC& func)
+{
+	// process about 1GB per measurement
+	sl_uint32 nIterations = (sl_uint32)((SLIB_UINT64(1) << 30) / sizeMessage);
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		func();
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	if (s <= 0) {
+		s = 0.000001;
+	}
+	Println("%s (%d bytes): %.3f GB/s", name, sizeMessage, (double)sizeMessage * nIterations / s / 1000000000.0);
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("AES hardware acceleration: %s", AES::isHardwareAccelerated() ? "yes" : "no");
+	
+	sl_uint8 key[32];
+	sl_uint8 iv[16];
+	for (sl_uint32 i = 0; i < 32; i++) {
+		key[i] = (sl_uint8)(i * 7 + 1);
+	}
+	for (sl_uint32 i = 0; i < 16; i++) {
+		iv[i] = (sl_uint8)(i * 13 + 5);
+	}
+	
+	const sl_size sizes[] = { 64, 1024, 16384, 1048576 };
+	Memory mem = Memory::create(1048576 + 16);
+	sl_uint8* buf = (sl_uint8*)(mem.getData());
+	Base::zeroMemory(buf, mem.getSize());
+	
+	for (sl_uint32 lenKey = 16; lenKey <= 32; lenKey += 16) {
+		Println("AES-%d", lenKey * 8);
+		AES aes;
+		aes.setKey(key, lenKey);
+		AES_GCM gcm;
+		gcm.setKey(key, lenKey);
+		sl_uint8 tag[16];
+		for (sl_uint32 i = 0; i < CountOfArray(sizes); i++) {
+			sl_size size = sizes[i];
+			Measure("  encryptBlocks (ECB)", size, [&]() {
+				aes.encryptBlocks(buf, buf, size);
+			});
+			Measure("  encrypt_CTR", size, [&]() {
+				aes.encrypt_CTR(iv, 0, buf, size, buf);
+			});
+			Measure("  GCM encrypt", size, [&]() {
+				gcm.encrypt(iv, 12, sl_null, 0, buf, buf, size, tag);
+			});
+			Measure("  GCM decrypt", size, [&]() {
+				gcm.decrypt(iv, 12, sl_null, 0, buf, buf, size, tag);
+			});
+		}
+	}
+	
+	return 0;
+}
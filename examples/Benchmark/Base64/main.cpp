@@ -0,0 +1,94 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures Base64 throughput (GB/s of binary data): allocating `encode/decode`, and the variants writing into the caller's buffer
+*/
+
+template <class FUNC>
+static void Measure(const char* name, sl_size sizeMessage, const FUNC& func)
+{
+	// process about 1GB per measurement
+	sl_uint32 nIterations = (sl_uint32)((SLIB_UINT64(1) << 30) / sizeMessage);
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		func();
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	if (s <= 0) {
+		s = 0.000001;
+	}
+	Println("%s (%d bytes): %.3f GB/s", name, sizeMessage, (double)sizeMessage * nIterations / s / 1000000000.0);
+}
+
+int main(int argc, const char * argv[])
+{
+	const sl_size sizes[] = { 48, 1024, 65536, 1048576 };
+	Memory mem = Memory::create(1048576);
+	sl_uint8* buf = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < mem.getSize(); i++) {
+		buf[i] = (sl_uint8)(i * 31 + 7);
+	}
+	String text = String::allocate(Base64::getEncodedLength(mem.getSize()));
+	Memory output = Memory::create(mem.getSize());
+	
+	volatile sl_size result = 0;
+	for (sl_uint32 i = 0; i < CountOfArray(sizes); i++) {
+		sl_size size = sizes[i];
+		Measure("Encode", size, [&]() {
+			result = Base64::encode(buf, size).getLength();
+		});
+		Measure("Encode into buffer", size, [&]() {
+			result = Base64::encodeTo(buf, size, text.getData());
+		});
+		sl_size len = Base64::getEncodedLength(size);
+		String encoded = Base64::encode(buf, size);
+		Measure("Decode", size, [&]() {
+			result = Base64::decode(encoded).getSize();
+		});
+		Measure("Decode into buffer", size, [&]() {
+			result = Base64::decode(text.getData(), len, output.getData());
+		});
+		if (Base::compareMemory((sl_uint8*)(output.getData()), buf, size)) {
+			Println("Mismatched!");
+		}
+	}
+	
+	// MIME style: line break per 76 characters
+	String mime = Base64::encode(buf, 65536);
+	StringBuffer sb;
+	for (sl_size i = 0; i < mime.getLength(); i += 76) {
+		sb.add(mime.substring(i, i + 76));
+		sb.addStatic("\r\n", 2);
+	}
+	mime = sb.merge();
+	Measure("Decode (76 characters per line)", 65536, [&]() {
+		result = Base64::decode(mime.getData(), mime.getLength(), output.getData());
+	});
+	
+	return 0;
+}
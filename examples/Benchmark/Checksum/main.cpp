@@ -0,0 +1,118 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures checksum throughput (GB/s): CRC32, CRC32C, Adler32 and 1's complement sum of TCP/IP,
+	and compares the incremental checksum update (RFC 1624) with the full recomputation for a rewritten packet header
+*/
+
+template <class FUNC>
+static void Measure(const char* name, sl_size sizeMessage, const FUNC& func)
+{
+	// process about 1GB per measurement
+	sl_uint32 nIterations = (sl_uint32)((SLIB_UINT64(1) << 30) / sizeMessage);
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		func();
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	if (s <= 0) {
+		s = 0.000001;
+	}
+	Println("%s (%d bytes): %.3f GB/s", name, sizeMessage, (double)sizeMessage * nIterations / s / 1000000000.0);
+}
+
+// word-by-word sum, as a baseline
+static sl_uint16 SumByWords(const void* data, sl_size size)
+{
+	sl_uint32 sum = 0;
+	const sl_uint8* p = (const sl_uint8*)data;
+	while (size > 1) {
+		sum += ((sl_uint32)(p[0]) << 8) | p[1];
+		p += 2;
+		size -= 2;
+	}
+	if (size) {
+		sum += ((sl_uint32)(p[0]) << 8);
+	}
+	while (sum >> 16) {
+		sum = (sum >> 16) + (sum & 0xffff);
+	}
+	return (sl_uint16)sum;
+}
+
+int main(int argc, const char * argv[])
+{
+	const sl_size sizes[] = { 64, 1500, 65536, 1048576 };
+	Memory mem = Memory::create(1048576);
+	sl_uint8* buf = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < mem.getSize(); i++) {
+		buf[i] = (sl_uint8)(i * 31 + 7);
+	}
+	
+	volatile sl_uint32 result = 0;
+	for (sl_uint32 i = 0; i < CountOfArray(sizes); i++) {
+		sl_size size = sizes[i];
+		Measure("CRC32", size, [&]() {
+			result = CRC32::get(buf, size);
+		});
+		Measure("CRC32C", size, [&]() {
+			result = CRC32C::get(buf, size);
+		});
+		Measure("Adler32", size, [&]() {
+			result = Adler32::get(buf, size);
+		});
+		Measure("1's complement sum", size, [&]() {
+			result = TCP_IP::calculateOneComplementSum(buf, size);
+		});
+		Measure("1's complement sum (word by word)", size, [&]() {
+			result = SumByWords(buf, size);
+		});
+	}
+	
+	// rewriting the source port of a 1500 bytes segment
+	sl_uint16 checksum = TCP_IP::calculateChecksum(buf, 1500);
+	sl_uint32 nIterations = 10000000;
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		sl_uint16 portOld = MIO::readUint16BE(buf);
+		sl_uint16 portNew = (sl_uint16)(portOld + 1);
+		MIO::writeUint16BE(buf, portNew);
+		checksum = TCP_IP::adjustChecksum(checksum, portOld, portNew);
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	Println("Incremental update: %.1f ns/packet (%s)", s * 1000000000.0 / nIterations, checksum == TCP_IP::calculateChecksum(buf, 1500) ? "matched" : "mismatched");
+	nIterations = 1000000;
+	t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		MIO::writeUint16BE(buf, (sl_uint16)(MIO::readUint16BE(buf) + 1));
+		result = TCP_IP::calculateChecksum(buf, 1500);
+	}
+	s = (Time::now() - t).getSecondsCountf();
+	Println("Full recomputation: %.1f ns/packet", s * 1000000000.0 / nIterations);
+	
+	return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures ratio and throughput (MB/s) of zlib, LZ4 and Zstandard on a generated JSON payload (or the file given as argument),
+	and the gain of a trained Zstandard dictionary on small payloads
+*/
+
+static String GenerateRecord(sl_uint32 index)
+{
+	static const char* names[] = { "alice", "bob", "carol", "dave", "erin", "frank" };
+	static const char* states[] = { "active", "disabled", "pending" };
+	return String::format("{\"id\":%d,\"user\":\"%s\",\"email\":\"%s@example.com\",\"status\":\"%s\",\"score\":%d,\"created\":\"2024-%02d-%02dT10:%02d:00Z\"}\n",
+		index, names[Math::randomInt() % 6], names[Math::randomInt() % 6], states[Math::randomInt() % 3], Math::randomInt() % 1000, 1 + Math::randomInt() % 12, 1 + Math::randomInt() % 28, Math::randomInt() % 60);
+}
+
+static void Measure(CompressionMethod method, const char* name, sl_int32 level, const Memory& input)
+{
+	sl_size size = input.getSize();
+	sl_uint32 nIterations = (sl_uint32)(SLIB_MAX(1, (sl_size)(256 << 20) / size));
+	Memory compressed;
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		compressed = Compression::compress(method, input, level);
+	}
+	double sc = (Time::now() - t).getSecondsCountf();
+	Memory output;
+	t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		output = Compression::decompress(method, compressed);
+	}
+	double sd = (Time::now() - t).getSecondsCountf();
+	sl_bool flagMatched = output.getSize() == size && Base::equalsMemory(output.getData(), input.getData(), size);
+	Println("%s (level %d): ratio %.3f, compress %.1f MB/s, decompress %.1f MB/s%s", name, level, (double)size / compressed.getSize(),
+		(double)size * nIterations / sc / 1000000.0, (double)size * nIterations / sd / 1000000.0, flagMatched ? "" : " (MISMATCHED)");
+}
+
+int main(int argc, const char * argv[])
+{
+	Memory input;
+	if (argc > 1) {
+		input = File::readAllBytes(argv[1]);
+	} else {
+		StringBuffer sb;
+		for (sl_uint32 i = 0; i < 50000; i++) {
+			sb.add(GenerateRecord(i));
+		}
+		String s = sb.merge();
+		input = Memory::create(s.getData(), s.getLength());
+	}
+	Println("Input: %d bytes", input.getSize());
+
+	Measure(CompressionMethod::Zlib, "zlib", 1, input);
+	Measure(CompressionMethod::Zlib, "zlib", 6, input);
+	Measure(CompressionMethod::LZ4, "LZ4", 1, input);
+	Measure(CompressionMethod::LZ4, "LZ4", 9, input);
+	Measure(CompressionMethod::Zstd, "Zstd", 1, input);
+	Measure(CompressionMethod::Zstd, "Zstd", 3, input);
+	Measure(CompressionMethod::Zstd, "Zstd", 9, input);
+
+	// small payloads: dictionary trained from similar records
+	List<Memory> samples;
+	for (sl_uint32 i = 0; i < 2000; i++) {
+		String s = GenerateRecord(i);
+		samples.add(Memory::create(s.getData(), s.getLength()));
+	}
+	Memory memDictionary = Zstd::trainDictionary(samples, 16384);
+	Ref<ZstdDictionary> dictionary = ZstdDictionary::create(memDictionary);
+	if (dictionary.isNull()) {
+		Println("Failed to train dictionary");
+		return 1;
+	}
+	sl_size sizeRaw = 0, sizePlain = 0, sizeDictionary = 0;
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < 10000; i++) {
+		String s = GenerateRecord(100000 + i);
+		sizeRaw += s.getLength();
+		sizePlain += Zstd::compress(s.getData(), s.getLength()).getSize();
+		sizeDictionary += Zstd::compress(dictionary, s.getData(), s.getLength()).getSize();
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	Println("Small payloads (%d bytes avg): ratio %.3f without dictionary, %.3f with %d bytes dictionary, %.1f us/payload",
+		sizeRaw / 10000, (double)sizeRaw / sizePlain, (double)sizeRaw / sizeDictionary, memDictionary.getSize(), s * 1000000.0 / 10000);
+
+	return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures the elliptic-curve signatures (operations per second): Ed25519 and ECDSA P-256 (JWT EdDSA/ES256)
+*/
+
+template <class FUNC>
+static void Measure(const char* name, sl_uint32 nIterations, const FUNC& func)
+{
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		func();
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	if (s <= 0) {
+		s = 0.000001;
+	}
+	Println("%s: %.1f ops/s", name, (double)nIterations / s);
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint8 message[256];
+	for (sl_uint32 i = 0; i < sizeof(message); i++) {
+		message[i] = (sl_uint8)(i * 31 + 7);
+	}
+	volatile sl_bool result = sl_false;
+
+	sl_uint8 edPrivateKey[Ed25519::PrivateKeySize];
+	sl_uint8 edPublicKey[Ed25519::PublicKeySize];
+	sl_uint8 edSignature[Ed25519::SignatureSize];
+	Ed25519::generatePrivateKey(edPrivateKey);
+	Ed25519::getPublicKey(edPrivateKey, edPublicKey);
+	Measure("Ed25519 Sign", 5000, [&]() {
+		Ed25519::sign(edPrivateKey, edPublicKey, message, sizeof(message), edSignature);
+	});
+	Measure("Ed25519 Verify", 2000, [&]() {
+		result = Ed25519::verify(edPublicKey, message, sizeof(message), edSignature);
+	});
+	if (!result) {
+		Println("Ed25519: Verification failed!");
+	}
+
+	sl_uint8 ecPrivateKey[ECDSA_P256::PrivateKeySize];
+	sl_uint8 ecPublicKey[ECDSA_P256::PublicKeySize];
+	sl_uint8 ecSignature[ECDSA_P256::SignatureSize];
+	ECDSA_P256::generatePrivateKey(ecPrivateKey);
+	ECDSA_P256::getPublicKey(ecPrivateKey, ecPublicKey);
+	Measure("ECDSA P-256 Sign", 5000, [&]() {
+		ECDSA_P256::signMessage(ecPrivateKey, message, sizeof(message), ecSignature);
+	});
+	Measure("ECDSA P-256 Verify", 2000, [&]() {
+		result = ECDSA_P256::verifyMessage(ecPublicKey, message, sizeof(message), ecSignature);
+	});
+	if (!result) {
+		Println("ECDSA P-256: Verification failed!");
+	}
+	return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures number formatting and parsing on numeric-heavy JSON documents
+	(telemetry like payloads, about 70% of the values are doubles)
+*/
+
+static sl_uint64 g_seed = 0x2545F4914F6CDD1D;
+
+static sl_uint64 NextRandom()
+{
+	g_seed ^= g_seed << 13;
+	g_seed ^= g_seed >> 7;
+	g_seed ^= g_seed << 17;
+	return g_seed;
+}
+
+static double NextDouble()
+{
+	sl_uint64 r = NextRandom();
+	switch (r & 3) {
+		case 0:
+			return (double)((sl_int64)(r >> 20) % 100000000) / 1000.0;
+		case 1:
+			return (double)(r >> 11) / (double)(SLIB_UINT64(1) << 53) * 360.0 - 180.0;
+		case 2:
+			return (double)(r >> 11) * 1e-300;
+		default:
+			return (double)((r >> 40) & 0xFFFF) / 16.0;
+	}
+}
+
+static String GenerateDocument(sl_uint32 nRecords)
+{
+	StringBuffer sb;
+	sb.addStatic("[", 1);
+	for (sl_uint32 i = 0; i < nRecords; i++) {
+		if (i) {
+			sb.addStatic(",", 1);
+		}
+		Json item;
+		item.putItem("id", (sl_int32)i);
+		item.putItem("device", String::format("dev-%d", i % 100));
+		item.putItem("ok", (i % 7) != 0);
+		for (sl_uint32 k = 0; k < 7; k++) {
+			item.putItem(String::format("v%d", k), NextDouble());
+		}
+		sb.add(item.toJsonString());
+	}
+	sb.addStatic("]", 1);
+	return sb.merge();
+}
+
+template <class FUNC>
+static void Measure(const char* name, sl_uint32 nIterations, sl_size bytesPerIteration, const FUNC& func)
+{
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		func();
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	if (s <= 0) {
+		s = 0.000001;
+	}
+	if (bytesPerIteration) {
+		Println("%s: %.3f ms/iter, %.1f MB/s", name, s * 1000 / nIterations, (double)bytesPerIteration * nIterations / s / 1048576.0);
+	} else {
+		Println("%s: %.3f ms/iter", name, s * 1000 / nIterations);
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	String doc = GenerateDocument(20000);
+	sl_size size = doc.getLength();
+	Println("Document size: %d bytes", size);
+	
+	Json json = Json::parseJson(doc);
+	Measure("Json::parseJson", 10, size, [&]() {
+		json = Json::parseJson(doc);
+	});
+	Measure("Json::toJsonString", 10, size, [&]() {
+		doc = json.toJsonString();
+	});
+	
+	const sl_uint32 nNumbers = 1000000;
+	List<double> values;
+	for (sl_uint32 i = 0; i < nNumbers; i++) {
+		values.add_NoLock(NextDouble());
+	}
+	List<String> strings;
+	Measure("String::fromDouble", 1, 0, [&]() {
+		ListElements<double> list(values);
+		for (sl_size i = 0; i < list.count; i++) {
+			strings.add_NoLock(String::fromDouble(list[i]));
+		}
+	});
+	double sum = 0;
+	Measure("String::parseDouble", 1, 0, [&]() {
+		ListElements<String> list(strings);
+		for (sl_size i = 0; i < list.count; i++) {
+			sum += list[i].parseDouble();
+		}
+	});
+	
+	sl_size nMismatch = 0;
+	{
+		ListElements<double> list1(values);
+		ListElements<String> list2(strings);
+		for (sl_size i = 0; i < list1.count; i++) {
+			if (list2[i].parseDouble() != list1[i]) {
+				nMismatch++;
+			}
+		}
+	}
+	Println("Round-trip mismatches: %d / %d (checksum %g)", nMismatch, nNumbers, sum);
+	
+	return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures RSA-2048 throughput (operations per second) with a fixed test key, and the multiplication of large integers
+*/
+
+template <class FUNC>
+static void Measure(const char* name, sl_uint32 nIterations, const FUNC& func)
+{
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < nIterations; i++) {
+		func();
+	}
+	double s = (Time::now() - t).getSecondsCountf();
+	if (s <= 0) {
+		s = 0.000001;
+	}
+	Println("%s: %.1f ops/s", name, (double)nIterations / s);
+}
+
+int main(int argc, const char * argv[])
+{
+	RSAPrivateKey key;
+	key.N = BigInt::fromHexString(
+		"A9ACB45F26C4E1788FA608BE0B7AFFA9EDB986174083E1A9FBDD04ACB13DBA09"
+		"E3E60D5869C731E14965763F327DAAAE8A6CB00A1A1CDC3684F4E7C7F75C8588"
+		"3F90765137F2B78DDEA8209C928B60089B5E6A188EBF92067386B09C16BEAF74"
+		"0552FED41FCD228AE81290BAFF13C277D3BC3207D570E337EE67667620301092"
+		"F22403379A37727C6BA55794B296CFF12166012A1E13E2C998BC04ED41CDAAB1"
+		"B277DDE56EEE9D21650026C51DE45A2C93447D05241A8D8086A2F2277FE82C46"
+		"E40FFAC4A6E9EA8638C55261C3EEDB19A91A3834E5CA9DD0799517706B983FE3"
+		"348A636FEAA32391A15319111AB2AD89101ED54539B8FD8E1B7795C4202BC67F");
+	key.D = BigInt::fromHexString(
+		"5B796474B7EE04B07EA140AD547B2742718B47A35980C0346838ABC07E7D8CC2"
+		"B03EE28AFBDC0C242CF1AA623FD2482679324765EAD60C52C833509219E5A387"
+		"E4DCF92CA8410E7C49C1D27316FE54F3CEEF83BB619A1E1BA444C50A21A903E6"
+		"44C88DE1C6934D401E0584498C2317008B0236E6CA4765F84D6B296E1DC44BEA"
+		"4BECC2907D0FB2DA4F9B5F1ED0B8D8E4FFF60D36D081F62551BB5B6A8755026F"
+		"8EA61E568423E31F67DABF820B426E141848EC4776B3250F9DADD062720E40BC"
+		"74082F959433E69218EDBA48DF7121B1DE7B7661D4E0098B8CB140EBDDBA72C2"
+		"8E393AA9C1AE9E3CD8D736C0D9C5C5CF995E29B74EA450851B562781166CA3E1");
+	key.P = BigInt::fromHexString(
+		"DABB400B0DBB1DCB6229D61A2CF596913065BFE0AD6595D540F3CF5DDE202391"
+		"E13ED52AF94DFF1B59FBF80F6A024C4D496EF3EFFB57F0FB0EF9DC7E32482738"
+		"E0491EB83C15137A391474652C3C797802AE02DA43298A334DDDB288365C795F"
+		"4D989EB8983A305444C4D3A083514033E5DCB2F4CF391335E8D93A26D389241B");
+	key.Q = BigInt::fromHexString(
+		"C695AAB4379FD5AD47CF9F1524AFCA5C05C9C28A94690AF796FCC6500B152060"
+		"D10968BDEB5D624472FD2C62AD720EA2EE27ED88414A0C0DCF16E98C6B53A90B"
+		"A960690158FF224C9A92BB37D944E0D778033315849E7ACB2DA701ECB5C0BE0B"
+		"8F9086D1422D5CFFED081D8F4F059D49CF5B789CCF81664A8C52ECEFD3A6A56D");
+	key.DP = BigInt::fromHexString(
+		"DA74559C3494834753BD10F6879CA84A4D99F1AF45BEC58C7D18842CEDE20F64"
+		"6D2041EA6F9FB47FEEB936A0BE71991F3F8E2ED7A9A1C52E1960F7149AC77154"
+		"DEBC688FFC81D83823B60821DBB27266A7D67F46D9F92CEBDC82E50221B8EE07"
+		"7F0A44CB7C4DF162D863F430C5B66A76EAC6277D55515D9C63F84099F27F6FAD");
+	key.DQ = BigInt::fromHexString(
+		"71BDCDBD5552CE0F66DF2B6DEFCA642C5B0059D607F5365BE3763A9C240CE0B3"
+		"B36721400E6C39599D47174219B8075C18EE73A5A447A629CEA07FFA768ABF7B"
+		"37734A118488F57B4CD99833FFD4ECB75D3CEFE876425370C6602EC106C533D4"
+		"E950CD7753E129B048726A83E7ADFE8E051F8E30BAC591F246F744508538A0ED");
+	key.IQ = BigInt::fromHexString(
+		"C6BDD596FB23EA66DE096FAED613DCE500103BB224D7FE35C14EB91EC87CCA2B"
+		"82F0035D47293E2106846B44F10E5356A79576F05249DABB36708CC4022A958B"
+		"8A5155B23428F435AD1E2C5F42FCDFB286A40648DD77EE3BE38EFF576FEFD669"
+		"32B3F27DFA9F55C9889C9E71745339DEE2E8D40AC4E206B3F6B5449CBAB2D113");
+	key.E = BigInt::fromInt32(65537);
+	RSAPublicKey keyPublic;
+	keyPublic.N = key.N;
+	keyPublic.E = key.E;
+
+	sl_uint8 message[256];
+	sl_uint8 signature[256];
+	sl_uint8 output[256];
+	for (sl_uint32 i = 0; i < sizeof(message); i++) {
+		message[i] = (sl_uint8)(i * 31 + 7);
+	}
+	message[0] = 0;
+
+	Measure("Private (CRT)", 2000, [&]() {
+		RSA::executePrivate(key, message, signature);
+	});
+	RSA::executePublic(keyPublic, signature, output);
+	if (Base::compareMemory(message, output, sizeof(message))) {
+		Println("Mismatched!");
+	}
+	Measure("Public", 50000, [&]() {
+		RSA::executePublic(keyPublic, signature, output);
+	});
+	key.flagUseOnlyD = sl_true;
+	Measure("Private (D only)", 500, [&]() {
+		RSA::executePrivate(key, message, output);
+	});
+	if (Base::compareMemory(signature, output, sizeof(signature))) {
+		Println("Mismatched!");
+	}
+
+	const sl_uint32 bits[] = { 2048, 4096, 8192, 32768 };
+	for (sl_uint32 i = 0; i < CountOfArray(bits); i++) {
+		BigInt a = (key.N << (bits[i] - 2048)) + key.D;
+		BigInt b = a - key.P;
+		sl_uint32 nWords = bits[i] >> 5;
+		volatile sl_size result = 0;
+		Measure(String::format("Multiply %d bits", bits[i]).getData(), 2000000000 / nWords / nWords, [&]() {
+			result = (a * b).getMostSignificantBits();
+		});
+	}
+	return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib.h>
+
+using namespace slib;
+
+/*
+	Measures write and read transactions per second of SQLite under the connection profiles below.
+	The database files are created in the directory given as argument (default: temporary directory).
+	Pass "config" as second argument to disable the memory statistics of SQLite and use a page cache arena.
+*/
+
+#define ROWS_COUNT 100000
+#define DURATION_WRITE 2000
+#define READS_COUNT 200000
+#define READER_THREADS_COUNT 4
+
+static String GenerateName(sl_uint32 index)
+{
+	return String::format("user%d@example.com", index);
+}
+
+static void PrintStatus(const String& name, double count, double ms)
+{
+	Println("  %s: %.0f/s", name, count * 1000.0 / ms);
+}
+
+static void MeasureWrites(const SQLiteParam& param)
+{
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(param);
+	if (db.isNull()) {
+		Println("  Failed to connect");
+		return;
+	}
+	db->execute("CREATE TABLE users (id INTEGER PRIMARY KEY, name TEXT, score INTEGER)");
+
+	// a transaction for each row
+	sl_uint32 n = 0;
+	Time t = Time::now();
+	double ms = 0;
+	while (ms < DURATION_WRITE) {
+		db->execute("INSERT INTO users (id, name, score) VALUES (?, ?, ?)", ROWS_COUNT + n, GenerateName(n), n % 1000);
+		n++;
+		if (!(n & 15)) {
+			ms = (Time::now() - t).getMillisecondsCountf();
+		}
+	}
+	PrintStatus("write transactions", n, ms);
+
+	// rows in batched transactions
+	List<VariantList> rows;
+	for (sl_uint32 i = 0; i < ROWS_COUNT; i++) {
+		rows.add_NoLock(VariantList::createFromElements(i, GenerateName(i), i % 1000));
+	}
+	t = Time::now();
+	db->executeMany("INSERT INTO users (id, name, score) VALUES (?, ?, ?)", rows);
+	PrintStatus("batched inserts", ROWS_COUNT, (Time::now() - t).getMillisecondsCountf());
+}
+
+static void MeasureReads(const SQLiteParam& _param)
+{
+	SQLiteParam param = _param;
+	param.flagCreate = sl_false;
+	param.flagReadonly = sl_true;
+	{
+		Ref<SQLiteDatabase> db = SQLiteDatabase::connect(param);
+		if (db.isNull()) {
+			Println("  Failed to connect");
+			return;
+		}
+		Time t = Time::now();
+		for (sl_uint32 i = 0; i < READS_COUNT; i++) {
+			db->getValueForQueryResult("SELECT name FROM users WHERE id = ?", (sl_uint32)(Math::randomInt()) % ROWS_COUNT);
+		}
+		PrintStatus("point reads", READS_COUNT, (Time::now() - t).getMillisecondsCountf());
+		t = Time::now();
+		for (sl_uint32 i = 0; i < 20; i++) {
+			db->getValueForQueryResult("SELECT SUM(score) FROM users WHERE name LIKE ?", String::format("user%d%%", i));
+		}
+		PrintStatus("range scans", 20, (Time::now() - t).getMillisecondsCountf());
+	}
+
+	List< Ref<Thread> > threads;
+	Time t = Time::now();
+	for (sl_uint32 k = 0; k < READER_THREADS_COUNT; k++) {
+		threads.add_NoLock(Thread::start([param]() {
+			Ref<SQLiteDatabase> db = SQLiteDatabase::connect(param);
+			if (db.isNull()) {
+				return;
+			}
+			for (sl_uint32 i = 0; i < READS_COUNT; i++) {
+				db->getValueForQueryResult("SELECT name FROM users WHERE id = ?", (sl_uint32)(Math::randomInt()) % ROWS_COUNT);
+			}
+		}));
+	}
+	ListElements< Ref<Thread> > items(threads);
+	for (sl_size i = 0; i < items.count; i++) {
+		items[i]->finishAndWait();
+	}
+	PrintStatus(String::format("point reads (%d threads)", READER_THREADS_COUNT), READS_COUNT * READER_THREADS_COUNT, (Time::now() - t).getMillisecondsCountf());
+}
+
+static void Measure(const char* name, SQLiteParam& param, const String& dir)
+{
+	param.path = String::format("%s/benchmark_sqlite_%s.db", dir, name);
+	File::deleteFile(param.path);
+	File::deleteFile(param.path + "-wal");
+	File::deleteFile(param.path + "-shm");
+	Println("%s", name);
+	MeasureWrites(param);
+	MeasureReads(param);
+	File::deleteFile(param.path);
+	File::deleteFile(param.path + "-wal");
+	File::deleteFile(param.path + "-shm");
+}
+
+int main(int argc, const char * argv[])
+{
+	String dir;
+	if (argc > 1) {
+		dir = argv[1];
+	} else {
+		dir = System::getTempDirectory();
+	}
+	if (argc > 2 && String(argv[2]) == "config") {
+		SQLiteConfig config;
+		config.flagMemoryStatus = sl_false;
+		config.pageCacheSlotSize = 4096 + 256;
+		config.pageCacheSlotsCount = 4096;
+		if (!(SQLiteDatabase::configure(config))) {
+			Println("Failed to configure SQLite");
+		}
+	}
+
+	SQLiteParam param;
+	param.busyTimeout = 5000;
+	Measure("default", param, dir);
+
+	param.journalMode = SQLiteJournalMode::WAL;
+	param.synchronousMode = SQLiteSynchronousMode::Normal;
+	Measure("wal", param, dir);
+
+	param.mmapSize = 256 << 20;
+	param.cacheSize = -65536;
+	param.tempStore = SQLiteTempStore::Memory;
+	Measure("wal_mmap", param, dir);
+
+	param.synchronousMode = SQLiteSynchronousMode::Off;
+	Measure("wal_mmap_nosync", param, dir);
+
+	return 0;
+}
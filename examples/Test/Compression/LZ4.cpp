@@ -0,0 +1,265 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	LZ4 frames made by the `lz4` command line tool, round trips of the frame and block formats
+	at every level around the block boundaries, streaming with flush, and corrupted input
+*/
+
+static Memory FromHex(const char* hex)
+{
+	String str(hex);
+	Memory mem = Memory::create(str.getLength() / 2);
+	if (mem.isNotNull()) {
+		str.parseHexString(mem.getData());
+	}
+	return mem;
+}
+
+static Memory MakeText(sl_size size, sl_uint32 seed)
+{
+	static const char* words[] = { "alpha ", "beta ", "gamma ", "delta ", "epsilon ", "zeta ", "eta ", "theta\n" };
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_uint32 s = seed;
+	sl_size i = 0;
+	while (i < size) {
+		s = s * 1103515245 + 12345;
+		const char* w = words[(s >> 16) & 7];
+		while (*w && i < size) {
+			p[i++] = (sl_uint8)(*(w++));
+		}
+		if (!((s >> 20) & 15) && i < size) {
+			p[i++] = (sl_uint8)(s >> 24);
+		}
+	}
+	return mem;
+}
+
+static Memory MakeRepeat(sl_size nRepeat)
+{
+	Memory text = MakeText(1000, 3);
+	MemoryBuffer buf;
+	for (sl_size i = 0; i < nRepeat; i++) {
+		buf.add(text);
+	}
+	return buf.merge();
+}
+
+// incompressible
+static Memory MakeRandom(sl_size size, sl_uint64 seed)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_uint64 s = seed;
+	for (sl_size i = 0; i < size; i++) {
+		s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+		p[i] = (sl_uint8)(s >> 56);
+	}
+	return mem;
+}
+
+static sl_bool IsEqual(const Memory& a, const Memory& b)
+{
+	return a.getSize() == b.getSize() && Base::equalsMemory(a.getData(), b.getData(), a.getSize());
+}
+
+// feeds the input in uneven pieces, flushing once in the middle
+static Memory CompressPieces(Compressor* compressor, const Memory& data)
+{
+	MemoryBuffer buf;
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	sl_size size = data.getSize();
+	sl_size pos = 0;
+	sl_size piece = 1;
+	sl_bool flagFlushed = sl_false;
+	while (pos < size) {
+		sl_size n = Math::min(piece, size - pos);
+		Memory out = compressor->compress(p + pos, n, sl_false);
+		buf.add(out);
+		pos += n;
+		piece = piece * 5 + 3;
+		if (!flagFlushed && pos >= size / 2) {
+			sl_uint8 tmp[0x10000];
+			for (;;) {
+				sl_uint32 nUsed = 0;
+				sl_int32 iRet = compressor->flush(tmp, sizeof(tmp), nUsed);
+				buf.add(Memory::create(tmp, nUsed));
+				if (iRet <= 0) {
+					break;
+				}
+			}
+			flagFlushed = sl_true;
+		}
+	}
+	buf.add(compressor->compress(sl_null, 0, sl_true));
+	return buf.merge();
+}
+
+// feeds the input in uneven pieces into small output buffers
+static Memory DecompressPieces(Decompressor* decompressor, const Memory& data)
+{
+	MemoryBuffer buf;
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	sl_size size = data.getSize();
+	sl_size pos = 0;
+	sl_uint32 piece = 1;
+	sl_uint8 out[777];
+	for (;;) {
+		sl_uint32 n = (sl_uint32)(Math::min((sl_size)piece, size - pos));
+		sl_uint32 nPassed = 0;
+		sl_uint32 nUsed = 0;
+		sl_int32 iRet = decompressor->decompress(p + pos, n, nPassed, out, sizeof(out), nUsed);
+		buf.add(Memory::create(out, nUsed));
+		pos += nPassed;
+		if (iRet == 0) {
+			return buf.merge();
+		}
+		if (iRet < 0 || (!nPassed && !nUsed && pos >= size)) {
+			return sl_null;
+		}
+		piece = piece * 3 + 1;
+		if (piece > 5000) {
+			piece = 1;
+		}
+	}
+}
+
+// `lz4 -9 -BD --content-size`: MakeText(2000, 11), linked blocks
+static const char* g_frameText =
+	"04224d186c40d007000000000000f044020000f3097a65746120616c7068612064656c746120657073696c6f6e1400001e006074686574610a0a001062050076"
+	"67616d6d61207a1a00083e0011091800011d0006590016622c00051a00011400023400066000025b00020600023b00099a000b220025b97a490014ebb6000866"
+	"00031300084f00024900024500080c0002370002120014b63900065f0008e8000206000737010e2f00087e0005110008d6000850001f622e0002094c00068101"
+	"020a000ec000082d010a0b0108200016629c0108700019626d0007d9010210010c7800020c000769010217000a3802192954003fdf7a656b01020967000a7802"
+	"09c500022200014f001ef1030106a70005c000026b0017b40c000f9e010908c101000400186aaa00041e0017e83e010742000ab70001240016aedb02070e0309"
+	"df0008d7020ec80105350008d701083402041e0107180107a802075b030cdd03011b001f5c910000129780001b88a60307ed0208ac030bd5022e866227040f5f"
+	"03002f6574d603010b4c001c62b3000f2402011cd57e010a9c010869020800032a6574be020a60031a4d74020153002bca629a000a24051b7aee001b7ae90406"
+	"05000785020f3400010951000241001d2a14040dde010d68010433001be3bc010aa2030b200205ca0209c4011c7af7031c625a011c2ae3021f62fc01021398e6"
+	"0206a30108f8004e746120901b030e5f030c02060c20000d61040e62030a10060af5040863030761011ea47f000f25020017d152000a67042ebb622706079701"
+	"0919040d6c010c2f030c22040b50017064656c74612062000000004ae1584e";
+
+// `lz4 -1`: MakeText(1000, 3) repeated 100 times
+static const char* g_frameRepeat =
+	"04224d18645008690300006264656c7461200600f2077a65746120616c7068612065746120657073696c6f6e17006274686574610a1d00020c00011700146537"
+	"0015620a00022400043d00040800026200021c00080c00042000021a00040e004667616d6d0e00065c00042000078200022b000206000259001565d100013900"
+	"03150008cd0002bb00031200012500060500011c00117b06000266000474000123001288a800010c00012400041e00026600021e00020600023e00022500074e"
+	"01043100066c0102bc000235002865745d000255000206002b65742a0003bf0013651c00016900019800062a00025a0004220002910001230003530003430001"
+	"130017702d00031800013900030c000a3200020e0002320002b900014400021100021d001233070004ef001155a000022c00020600022d000206000a2c0002a9"
+	"00043a00013900022100023900011100041e00077800011800010500022e00010b00012000025100021600024400043f00021400012a00020b00022b00011100"
+	"010500021000023500141436000508000a6a02022c0008d200020c00061c00022200026a00015f000259000450000a0e00164b3e0052657461208e3d00021500"
+	"080c00043e00021400025d00024a00020600011800021700020600087a00079a02011700012d000fe803ffffffffffffffffffffffffffffffffffffffffffff"
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+	"fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff650746865746100000000f99522a7";
+
+static void TestFrames()
+{
+	TEST_CHECK(IsEqual(LZ4::decompress(FromHex(g_frameText)), MakeText(2000, 11)));
+	TEST_CHECK(IsEqual(LZ4::decompress(FromHex(g_frameRepeat)), MakeRepeat(100)));
+
+	Memory frame = FromHex(g_frameText);
+	LZ4Decompress decompress;
+	TEST_CHECK(decompress.start());
+	TEST_CHECK(IsEqual(DecompressPieces(&decompress, frame), MakeText(2000, 11)));
+
+	// content checksum
+	sl_uint8* p = (sl_uint8*)(frame.getData());
+	p[frame.getSize() - 1] ^= 1;
+	TEST_CHECK(LZ4::decompress(frame).isNull());
+	p[frame.getSize() - 1] ^= 1;
+	// truncated
+	TEST_CHECK(LZ4::decompress(frame.getData(), frame.getSize() - 5).isNull());
+	// bad magic
+	p[0] ^= 1;
+	TEST_CHECK(LZ4::decompress(frame).isNull());
+}
+
+static void TestRoundTrip()
+{
+	static const sl_size sizes[] = { 0, 1, 15, 1000, 0xffff, 0x10000, 0x10001, 300000 };
+	static const sl_int32 levels[] = { 1, 3, 9, 12 };
+	for (sl_uint32 i = 0; i < CountOfArray(sizes); i++) {
+		Memory text = MakeText(sizes[i], i);
+		Memory random = MakeRandom(sizes[i], i);
+		for (sl_uint32 k = 0; k < CountOfArray(levels); k++) {
+			Memory c = LZ4::compress(text, levels[k]);
+			TEST_CHECK(IsEqual(LZ4::decompress(c), text));
+			c = LZ4::compress(random, levels[k]);
+			TEST_CHECK(IsEqual(LZ4::decompress(c), random));
+			// incompressible blocks are stored
+			TEST_CHECK(c.getSize() <= sizes[i] + (sizes[i] >> 8) + 64);
+		}
+		TEST_CHECK(IsEqual(Compression::decompress(CompressionMethod::LZ4, Compression::compress(CompressionMethod::LZ4, text)), text));
+	}
+	Memory repeat = MakeRepeat(300);
+	Memory c = LZ4::compress(repeat, 9);
+	TEST_CHECK(c.getSize() < repeat.getSize() / 50);
+	TEST_CHECK(IsEqual(LZ4::decompress(c), repeat));
+}
+
+static void TestStreaming()
+{
+	Memory text = MakeText(500000, 21);
+	static const sl_uint32 blockSizes[] = { 0x10000, 0x40000 };
+	for (sl_uint32 i = 0; i < CountOfArray(blockSizes); i++) {
+		LZ4Compress compress;
+		TEST_CHECK(compress.start(i ? 9 : 1, blockSizes[i], i == 0));
+		Memory c = CompressPieces(&compress, text);
+		TEST_CHECK(IsEqual(LZ4::decompress(c), text));
+		LZ4Decompress decompress;
+		TEST_CHECK(decompress.start());
+		TEST_CHECK(IsEqual(DecompressPieces(&decompress, c), text));
+	}
+}
+
+static void TestBlock()
+{
+	Memory text = MakeText(100000, 8);
+	sl_size bound = LZ4::getCompressBound(text.getSize());
+	Memory block = Memory::create(bound);
+	sl_size n = LZ4::compressBlock(text.getData(), text.getSize(), block.getData(), bound, 6);
+	TEST_CHECK(n > 0 && n < text.getSize());
+	Memory out = Memory::create(text.getSize());
+	TEST_CHECK_EQUAL(LZ4::decompressBlock(block.getData(), n, out.getData(), out.getSize()), (sl_reg)(text.getSize()));
+	TEST_CHECK(IsEqual(out, text));
+	// the output buffer is too small
+	TEST_CHECK(LZ4::decompressBlock(block.getData(), n, out.getData(), out.getSize() - 1) < 0);
+	// the compressed block is cut
+	TEST_CHECK(LZ4::decompressBlock(block.getData(), n - 3, out.getData(), out.getSize()) < 0);
+	TEST_CHECK_EQUAL(LZ4::compressBlock(text.getData(), text.getSize(), block.getData(), 100, 6), 0);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestFrames();
+	TestRoundTrip();
+	TestStreaming();
+	TestBlock();
+	return TestResult("LZ4");
+}
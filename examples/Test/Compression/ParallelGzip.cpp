@@ -0,0 +1,161 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Parallel gzip compression: round trips of the one-shot and streaming paths, many
+	compressions running at once on a shared pool, and a pool whose workers are all busy
+*/
+
+static Memory MakeText(sl_size size, sl_uint32 seed)
+{
+	static const char* words[] = { "alpha ", "beta ", "gamma ", "delta ", "epsilon ", "zeta ", "eta ", "theta\n" };
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_uint32 s = seed;
+	sl_size i = 0;
+	while (i < size) {
+		s = s * 1103515245 + 12345;
+		const char* w = words[(s >> 16) & 7];
+		while (*w && i < size) {
+			p[i++] = (sl_uint8)(*(w++));
+		}
+		if (!((s >> 20) & 15) && i < size) {
+			p[i++] = (sl_uint8)(s >> 24);
+		}
+	}
+	return mem;
+}
+
+static sl_bool CheckRoundTrip(const Memory& compressed, const Memory& original)
+{
+	if (compressed.getSize() < 18) {
+		return sl_false;
+	}
+	Memory output = Zlib::decompress(compressed.getData(), compressed.getSize());
+	if (output.getSize() != original.getSize()) {
+		return sl_false;
+	}
+	return Base::equalsMemory(output.getData(), original.getData(), original.getSize());
+}
+
+static void TestOneShot()
+{
+	static const sl_size sizes[] = { 0, 1, 1000, 0x8000, 0x8001, 200000, 1000000 };
+	ZlibParallelParam param;
+	param.threadsCount = 4;
+	param.blockSize = 0x8000;
+	for (sl_uint32 i = 0; i < CountOfArray(sizes); i++) {
+		Memory data = MakeText(sizes[i], i);
+		TEST_CHECK(CheckRoundTrip(Zlib::compressGzipParallel(GzipParam(), param, data.getData(), data.getSize()), data));
+		TEST_CHECK(CheckRoundTrip(Zlib::compressGzipParallel(data.getData(), data.getSize()), data));
+	}
+}
+
+static void TestStreaming()
+{
+	Memory data = MakeText(700000, 77);
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	ZlibParallelParam param;
+	param.threadsCount = 3;
+	param.blockSize = 0x8000;
+	param.maxPendingBlocks = 2;
+	ZlibCompress compress;
+	TEST_CHECK(compress.startParallelGzip(param));
+	MemoryBuffer buf;
+	sl_size pos = 0;
+	sl_size piece = 1;
+	while (pos < data.getSize()) {
+		sl_size n = Math::min(piece, data.getSize() - pos);
+		buf.add(compress.compress(p + pos, n, sl_false));
+		pos += n;
+		piece = piece * 3 + 7;
+	}
+	buf.add(compress.compress(sl_null, 0, sl_true));
+	TEST_CHECK(CheckRoundTrip(buf.merge(), data));
+}
+
+static void TestSharedPool()
+{
+	Ref<ThreadPool> pool = ThreadPool::create(0, 2);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	const sl_int32 nThreads = 8;
+	const sl_int32 nRounds = 10;
+	sl_int32 nSuccess = 0;
+	sl_int32* pSuccess = &nSuccess;
+	List< Ref<Thread> > threads;
+	for (sl_int32 i = 0; i < nThreads; i++) {
+		threads.add(Thread::start([pool, pSuccess, i]() {
+			for (sl_int32 k = 0; k < nRounds; k++) {
+				Memory data = MakeText(100000 + (i * nRounds + k) * 3001, i * nRounds + k);
+				ZlibParallelParam param;
+				param.threadPool = pool;
+				param.blockSize = 0x8000;
+				param.maxPendingBlocks = 3;
+				if (CheckRoundTrip(Zlib::compressGzipParallel(GzipParam(), param, data.getData(), data.getSize()), data)) {
+					Base::interlockedIncrement32(pSuccess);
+				}
+			}
+		}));
+	}
+	for (auto& thread : threads) {
+		TEST_CHECK(thread->join(120000));
+	}
+	TEST_CHECK_EQUAL(nSuccess, nThreads * nRounds);
+	pool->release();
+}
+
+static void TestBusyPool()
+{
+	// the only worker of the pool is blocked: the blocks must run on the caller
+	Ref<ThreadPool> pool = ThreadPool::create(1, 1);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	Ref<Event> ev = Event::create();
+	pool->addTask([ev]() {
+		ev->wait(60000);
+	});
+	Memory data = MakeText(300000, 5);
+	ZlibParallelParam param;
+	param.threadPool = pool;
+	param.blockSize = 0x8000;
+	TEST_CHECK(CheckRoundTrip(Zlib::compressGzipParallel(GzipParam(), param, data.getData(), data.getSize()), data));
+	ev->set();
+	pool->release();
+}
+
+int main(int argc, const char * argv[])
+{
+	TestOneShot();
+	TestStreaming();
+	TestSharedPool();
+	TestBusyPool();
+	return TestResult("ParallelGzip");
+}
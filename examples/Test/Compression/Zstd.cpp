@@ -0,0 +1,303 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Zstandard frames made by the `zstd` command line tool (single and concatenated), round trips
+	at the levels of each matcher, streaming with flush, dictionaries, corrupted input, and the
+	selection of the HTTP content coding
+*/
+
+static Memory FromHex(const char* hex)
+{
+	String str(hex);
+	Memory mem = Memory::create(str.getLength() / 2);
+	if (mem.isNotNull()) {
+		str.parseHexString(mem.getData());
+	}
+	return mem;
+}
+
+static Memory MakeText(sl_size size, sl_uint32 seed)
+{
+	static const char* words[] = { "alpha ", "beta ", "gamma ", "delta ", "epsilon ", "zeta ", "eta ", "theta\n" };
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_uint32 s = seed;
+	sl_size i = 0;
+	while (i < size) {
+		s = s * 1103515245 + 12345;
+		const char* w = words[(s >> 16) & 7];
+		while (*w && i < size) {
+			p[i++] = (sl_uint8)(*(w++));
+		}
+		if (!((s >> 20) & 15) && i < size) {
+			p[i++] = (sl_uint8)(s >> 24);
+		}
+	}
+	return mem;
+}
+
+static Memory MakeRepeat(sl_size nRepeat)
+{
+	Memory text = MakeText(1000, 3);
+	MemoryBuffer buf;
+	for (sl_size i = 0; i < nRepeat; i++) {
+		buf.add(text);
+	}
+	return buf.merge();
+}
+
+// incompressible
+static Memory MakeRandom(sl_size size, sl_uint64 seed)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_uint64 s = seed;
+	for (sl_size i = 0; i < size; i++) {
+		s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+		p[i] = (sl_uint8)(s >> 56);
+	}
+	return mem;
+}
+
+static sl_bool IsEqual(const Memory& a, const Memory& b)
+{
+	return a.getSize() == b.getSize() && Base::equalsMemory(a.getData(), b.getData(), a.getSize());
+}
+
+// feeds the input in uneven pieces, flushing once in the middle
+static Memory CompressPieces(Compressor* compressor, const Memory& data)
+{
+	MemoryBuffer buf;
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	sl_size size = data.getSize();
+	sl_size pos = 0;
+	sl_size piece = 1;
+	sl_bool flagFlushed = sl_false;
+	while (pos < size) {
+		sl_size n = Math::min(piece, size - pos);
+		Memory out = compressor->compress(p + pos, n, sl_false);
+		buf.add(out);
+		pos += n;
+		piece = piece * 5 + 3;
+		if (!flagFlushed && pos >= size / 2) {
+			sl_uint8 tmp[0x10000];
+			for (;;) {
+				sl_uint32 nUsed = 0;
+				sl_int32 iRet = compressor->flush(tmp, sizeof(tmp), nUsed);
+				buf.add(Memory::create(tmp, nUsed));
+				if (iRet <= 0) {
+					break;
+				}
+			}
+			flagFlushed = sl_true;
+		}
+	}
+	buf.add(compressor->compress(sl_null, 0, sl_true));
+	return buf.merge();
+}
+
+// feeds the input in uneven pieces into small output buffers
+static Memory DecompressPieces(Decompressor* decompressor, const Memory& data)
+{
+	MemoryBuffer buf;
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	sl_size size = data.getSize();
+	sl_size pos = 0;
+	sl_uint32 piece = 1;
+	sl_uint8 out[777];
+	for (;;) {
+		sl_uint32 n = (sl_uint32)(Math::min((sl_size)piece, size - pos));
+		sl_uint32 nPassed = 0;
+		sl_uint32 nUsed = 0;
+		sl_int32 iRet = decompressor->decompress(p + pos, n, nPassed, out, sizeof(out), nUsed);
+		buf.add(Memory::create(out, nUsed));
+		pos += nPassed;
+		if (iRet == 0) {
+			return buf.merge();
+		}
+		if (iRet < 0 || (!nPassed && !nUsed && pos >= size)) {
+			return sl_null;
+		}
+		piece = piece * 3 + 1;
+		if (piece > 5000) {
+			piece = 1;
+		}
+	}
+}
+
+// `zstd -19 --check`: MakeText(2000, 11)
+static const char* g_frameText =
+	"28b52ffd64d0063d0c00e4047a65746120616c7068612064656c746120657073696c6f6e74686574610a6267616d6d61207a097a657462b97aebb6627a29dff1"
+	"b46ae8ae7a5c9788866262d54dca622ae3622a62989062a4d1bb80a2a801378542fb1d2042639ca3f31120088222861a5366aad6b0191638156c562613fe163d"
+	"0e42daac681255235cc5a09094608f2cb02e447f49ca5a424638262a302b16aec751efb747a67f3abbfe5f31e75dd718511b1d933f6a335c7f3fe5ba2609c7ff"
+	"d7203e957b1544f37efc93da5c63933d71229f5710afb13d18ba9508f74f94818f4ea84d990790c0ecbdb626a042646c509be13525359f0765a3bcbb42fabc6a"
+	"abd2c607ed1b040e61bc659036ce7581de62d97b1f678358076815421013867ef1eb4ac34a7e30f812be849106f2d7d371897885dc21ea8e6c917fec62823550"
+	"f1735672c14b9a749a1c56f4c97c103ee604549ca73ad0269b3a44c51106223579102beb775f68980fc746d2d53907895997f979af8ff50ae3df698fbd29cfe0"
+	"d8023480c7cd9d7040d4034360716da90203b3beb2";
+
+// `zstd -3 --check`: MakeText(1000, 3) repeated 100 times
+static const char* g_frameRepeat =
+	"28b52ffda4a08601003d080022040e15b0a903271d4c4cae25e7dbaecde96081e032682006d714ef21e81d21a4b637b35caf4688460df03e47123b94e4e25d3c"
+	"c958bcaf7873116ba8013785b4df0130428598550f12003198044859201aa86a65ffffef8d82ebb3819d9063d4892423dd5cd0169167613140f2015484d317e3"
+	"2ab139af58844a95e98cabe59e871c10e9a2bc6923284d413247a5795758875ff0e0fb691dcbb144df61620303936a75896185798ba6d23f1d63fb77e602b388"
+	"033930037cd943d562dedc4e503f78f7ea1ffde6b449199552bd12aff0565c8d7ddbdf95fcc4449fc47d68c530d480a89b0b21dd57e00bef833a1f66e658ef3c"
+	"2ee12d819db2caa33f8eeeb1825ea559855cd464d9a801";
+
+static void TestFrames()
+{
+	Memory text = MakeText(2000, 11);
+	Memory repeat = MakeRepeat(100);
+	TEST_CHECK(IsEqual(Zstd::decompress(FromHex(g_frameText)), text));
+	TEST_CHECK(IsEqual(Zstd::decompress(FromHex(g_frameRepeat)), repeat));
+
+	MemoryBuffer buf;
+	buf.add(FromHex(g_frameText));
+	buf.add(FromHex(g_frameRepeat));
+	Memory frames = buf.merge();
+	MemoryBuffer bufContent;
+	bufContent.add(text);
+	bufContent.add(repeat);
+	TEST_CHECK(IsEqual(Zstd::decompress(frames), bufContent.merge()));
+
+	Memory frame = FromHex(g_frameRepeat);
+	ZstdDecompress decompress;
+	TEST_CHECK(decompress.start());
+	TEST_CHECK(IsEqual(DecompressPieces(&decompress, frame), repeat));
+
+	// content checksum
+	sl_uint8* p = (sl_uint8*)(frame.getData());
+	p[frame.getSize() - 1] ^= 1;
+	TEST_CHECK(Zstd::decompress(frame).isNull());
+	p[frame.getSize() - 1] ^= 1;
+	// truncated
+	TEST_CHECK(Zstd::decompress(frame.getData(), frame.getSize() - 7).isNull());
+	// damaged entropy tables or sequences must fail without crashing
+	for (sl_size i = 6; i < frame.getSize() - 4; i += 5) {
+		p[i] ^= 0x5a;
+		Memory out = Zstd::decompress(frame);
+		TEST_CHECK(out.isNull() || !(IsEqual(out, repeat)));
+		p[i] ^= 0x5a;
+	}
+}
+
+static void TestRoundTrip()
+{
+	static const sl_size sizes[] = { 0, 1, 15, 1000, 0x1ffff, 0x20000, 0x20001, 300000 };
+	static const sl_int32 levels[] = { 1, 2, 3, 9, 19 };
+	for (sl_uint32 i = 0; i < CountOfArray(sizes); i++) {
+		Memory text = MakeText(sizes[i], i);
+		Memory random = MakeRandom(sizes[i], i);
+		for (sl_uint32 k = 0; k < CountOfArray(levels); k++) {
+			Memory c = Zstd::compress(text, levels[k]);
+			TEST_CHECK(IsEqual(Zstd::decompress(c), text));
+			c = Zstd::compress(random, levels[k]);
+			TEST_CHECK(IsEqual(Zstd::decompress(c), random));
+			// incompressible blocks are stored
+			TEST_CHECK(c.getSize() <= sizes[i] + (sizes[i] >> 8) + 64);
+		}
+		TEST_CHECK(IsEqual(Compression::decompress(CompressionMethod::Zstd, Compression::compress(CompressionMethod::Zstd, text)), text));
+	}
+	Memory repeat = MakeRepeat(300);
+	Memory c = Zstd::compress(repeat, 3);
+	TEST_CHECK(c.getSize() < repeat.getSize() / 100);
+	TEST_CHECK(IsEqual(Zstd::decompress(c), repeat));
+}
+
+static void TestStreaming()
+{
+	Memory text = MakeText(500000, 21);
+	for (sl_uint32 i = 0; i < 2; i++) {
+		ZstdCompress compress;
+		TEST_CHECK(compress.start(i ? 9 : 1, i == 0));
+		Memory c = CompressPieces(&compress, text);
+		TEST_CHECK(IsEqual(Zstd::decompress(c), text));
+		ZstdDecompress decompress;
+		TEST_CHECK(decompress.start());
+		TEST_CHECK(IsEqual(DecompressPieces(&decompress, c), text));
+	}
+}
+
+static void TestDictionary()
+{
+	List<Memory> samples;
+	for (sl_uint32 i = 0; i < 300; i++) {
+		samples.add(MakeText(400 + (i % 7) * 50, 1000 + i));
+	}
+	Memory data = Zstd::trainDictionary(samples, 8192, 1234);
+	TEST_CHECK(data.isNotNull());
+	Ref<ZstdDictionary> dictionary = ZstdDictionary::create(data);
+	TEST_CHECK(dictionary.isNotNull());
+	if (dictionary.isNull()) {
+		return;
+	}
+	TEST_CHECK_EQUAL(dictionary->getId(), 1234);
+	sl_size sizeWith = 0;
+	sl_size sizeWithout = 0;
+	for (sl_uint32 i = 0; i < 20; i++) {
+		Memory text = MakeText(500, 5000 + i);
+		Memory c = Zstd::compress(dictionary, text, 3);
+		TEST_CHECK(IsEqual(Zstd::decompress(dictionary, c), text));
+		// the frame refers to the dictionary ID
+		TEST_CHECK(Zstd::decompress(c).isNull());
+		sizeWith += c.getSize();
+		sizeWithout += Zstd::compress(text, 3).getSize();
+	}
+	TEST_CHECK(sizeWith < sizeWithout);
+
+	// raw content dictionary
+	Ref<ZstdDictionary> raw = ZstdDictionary::create(MakeText(4000, 77));
+	TEST_CHECK(raw.isNotNull());
+	if (raw.isNotNull()) {
+		TEST_CHECK_EQUAL(raw->getId(), 0);
+		Memory text = MakeText(3000, 77);
+		Memory c = Zstd::compress(raw, text, 9);
+		TEST_CHECK(c.getSize() < 100);
+		TEST_CHECK(IsEqual(Zstd::decompress(raw, c), text));
+	}
+}
+
+static void TestContentEncoding()
+{
+	TEST_CHECK(Compression::selectContentEncoding("gzip, deflate, br, zstd") == CompressionMethod::Zstd);
+	TEST_CHECK(Compression::selectContentEncoding("gzip;q=1.0, zstd;q=0.5") == CompressionMethod::Gzip);
+	TEST_CHECK(Compression::selectContentEncoding("*;q=0.1, zstd;q=0") == CompressionMethod::Gzip);
+	TEST_CHECK(Compression::selectContentEncoding("deflate") == CompressionMethod::Zlib);
+	TEST_CHECK(Compression::selectContentEncoding("identity") == CompressionMethod::None);
+	TEST_CHECK(Compression::selectContentEncoding("") == CompressionMethod::None);
+	TEST_CHECK(Compression::getMethodFromContentEncoding(" ZSTD ") == CompressionMethod::Zstd);
+	TEST_CHECK_EQUAL(Compression::getContentEncoding(CompressionMethod::Zstd), "zstd");
+}
+
+int main(int argc, const char * argv[])
+{
+	TestFrames();
+	TestRoundTrip();
+	TestStreaming();
+	TestDictionary();
+	TestContentEncoding();
+	return TestResult("Zstd");
+}
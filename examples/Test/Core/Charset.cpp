@@ -0,0 +1,240 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	UTF-8/16/32 converters and validators of Charsets, checked against
+	simple scalar reference implementations on random texts.
+	Lengths up to a few hundred units exercise both the block (SIMD) and the scalar paths.
+*/
+
+static sl_uint64 g_seed = 0x2545F4914F6CDD1D;
+
+static sl_uint32 NextRandom()
+{
+	g_seed ^= g_seed << 13;
+	g_seed ^= g_seed >> 7;
+	g_seed ^= g_seed << 17;
+	return (sl_uint32)(g_seed >> 16);
+}
+
+static sl_char32 RandomCodePoint()
+{
+	switch (NextRandom() % 8) {
+		case 0:
+			return 0x80 + NextRandom() % 0x780;
+		case 1:
+			for (;;) {
+				sl_char32 c = 0x800 + NextRandom() % 0xF800;
+				if (c < 0xD800 || c > 0xDFFF) {
+					return c;
+				}
+			}
+		case 2:
+			return 0x10000 + NextRandom() % 0x100000;
+		default:
+			// ASCII runs dominate real texts
+			return 0x20 + NextRandom() % 0x5F;
+	}
+}
+
+static sl_size EncodeUtf8(const sl_char32* s, sl_size n, sl_uint8* out)
+{
+	sl_size k = 0;
+	for (sl_size i = 0; i < n; i++) {
+		sl_char32 c = s[i];
+		if (c < 0x80) {
+			out[k++] = (sl_uint8)c;
+		} else if (c < 0x800) {
+			out[k++] = (sl_uint8)(0xC0 | (c >> 6));
+			out[k++] = (sl_uint8)(0x80 | (c & 0x3F));
+		} else if (c < 0x10000) {
+			out[k++] = (sl_uint8)(0xE0 | (c >> 12));
+			out[k++] = (sl_uint8)(0x80 | ((c >> 6) & 0x3F));
+			out[k++] = (sl_uint8)(0x80 | (c & 0x3F));
+		} else {
+			out[k++] = (sl_uint8)(0xF0 | (c >> 18));
+			out[k++] = (sl_uint8)(0x80 | ((c >> 12) & 0x3F));
+			out[k++] = (sl_uint8)(0x80 | ((c >> 6) & 0x3F));
+			out[k++] = (sl_uint8)(0x80 | (c & 0x3F));
+		}
+	}
+	return k;
+}
+
+static sl_size EncodeUtf16(const sl_char32* s, sl_size n, sl_char16* out)
+{
+	sl_size k = 0;
+	for (sl_size i = 0; i < n; i++) {
+		sl_char32 c = s[i];
+		if (c < 0x10000) {
+			out[k++] = (sl_char16)c;
+		} else {
+			c -= 0x10000;
+			out[k++] = (sl_char16)(0xD800 | (c >> 10));
+			out[k++] = (sl_char16)(0xDC00 | (c & 0x3FF));
+		}
+	}
+	return k;
+}
+
+// Table 3-7 of the Unicode Standard
+static sl_bool IsValidUtf8(const sl_uint8* s, sl_size n)
+{
+	sl_size i = 0;
+	while (i < n) {
+		sl_uint8 c = s[i];
+		if (c < 0x80) {
+			i++;
+			continue;
+		}
+		sl_uint32 len;
+		sl_uint8 lo = 0x80, hi = 0xBF;
+		if (c >= 0xC2 && c <= 0xDF) {
+			len = 2;
+		} else if (c >= 0xE0 && c <= 0xEF) {
+			len = 3;
+			if (c == 0xE0) {
+				lo = 0xA0;
+			} else if (c == 0xED) {
+				hi = 0x9F;
+			}
+		} else if (c >= 0xF0 && c <= 0xF4) {
+			len = 4;
+			if (c == 0xF0) {
+				lo = 0x90;
+			} else if (c == 0xF4) {
+				hi = 0x8F;
+			}
+		} else {
+			return sl_false;
+		}
+		if (i + len > n) {
+			return sl_false;
+		}
+		if (s[i + 1] < lo || s[i + 1] > hi) {
+			return sl_false;
+		}
+		for (sl_uint32 k = 2; k < len; k++) {
+			if ((s[i + k] & 0xC0) != 0x80) {
+				return sl_false;
+			}
+		}
+		i += len;
+	}
+	return sl_true;
+}
+
+static void TestConversions()
+{
+	sl_char32 text[600];
+	sl_uint8 utf8[2400];
+	sl_char16 utf16[1200];
+	sl_char8 out8[2400];
+	sl_char16 out16[1200];
+	sl_char32 out32[600];
+	sl_uint32 nFailures = 0;
+	for (sl_uint32 iter = 0; iter < 20000; iter++) {
+		sl_size n = NextRandom() % 600;
+		for (sl_size i = 0; i < n; i++) {
+			text[i] = RandomCodePoint();
+		}
+		sl_size n8 = EncodeUtf8(text, n, utf8);
+		sl_size n16 = EncodeUtf16(text, n, utf16);
+		
+		sl_bool flagOk = sl_true;
+		flagOk = flagOk && Charsets::utf8ToUtf16((sl_char8*)utf8, n8, sl_null, -1) == n16;
+		flagOk = flagOk && Charsets::utf8ToUtf16((sl_char8*)utf8, n8, out16, 1200) == n16 && Base::equalsMemory(out16, utf16, n16 * 2);
+		flagOk = flagOk && Charsets::utf8ToUtf32((sl_char8*)utf8, n8, out32, 600) == n && Base::equalsMemory(out32, text, n * 4);
+		flagOk = flagOk && Charsets::utf16ToUtf8(utf16, n16, sl_null, -1) == n8;
+		flagOk = flagOk && Charsets::utf16ToUtf8(utf16, n16, out8, 2400) == n8 && Base::equalsMemory(out8, utf8, n8);
+		flagOk = flagOk && Charsets::utf32ToUtf8(text, n, out8, 2400) == n8 && Base::equalsMemory(out8, utf8, n8);
+		flagOk = flagOk && Charsets::utf16ToUtf32(utf16, n16, out32, 600) == n && Base::equalsMemory(out32, text, n * 4);
+		flagOk = flagOk && Charsets::utf32ToUtf16(text, n, out16, 1200) == n16 && Base::equalsMemory(out16, utf16, n16 * 2);
+		flagOk = flagOk && Charsets::isValidUtf8((sl_char8*)utf8, n8);
+		flagOk = flagOk && Charsets::isValidUtf16(utf16, n16);
+		flagOk = flagOk && Charsets::utf8ToUtf16Strict((sl_char8*)utf8, n8, out16, 1200) == (sl_reg)n16;
+		flagOk = flagOk && Charsets::utf8ToUtf32Strict((sl_char8*)utf8, n8, out32, 600) == (sl_reg)n;
+		flagOk = flagOk && Charsets::utf16ToUtf8Strict(utf16, n16, out8, 2400) == (sl_reg)n8;
+		if (!flagOk) {
+			nFailures++;
+		}
+	}
+	TEST_CHECK_EQUAL(nFailures, 0);
+}
+
+static void TestValidation()
+{
+	sl_char32 text[300];
+	sl_uint8 utf8[1200];
+	sl_char16 out16[1200];
+	sl_uint32 nFailures = 0;
+	sl_uint32 nInvalid = 0;
+	for (sl_uint32 iter = 0; iter < 50000; iter++) {
+		sl_size n = NextRandom() % 300;
+		for (sl_size i = 0; i < n; i++) {
+			text[i] = RandomCodePoint();
+		}
+		sl_size n8 = EncodeUtf8(text, n, utf8);
+		// corrupts a few bytes: truncations, overlongs, surrogates, out of range and stray continuations
+		sl_uint32 nMutations = NextRandom() % 3;
+		for (sl_uint32 k = 0; k < nMutations && n8; k++) {
+			sl_size pos = NextRandom() % n8;
+			static const sl_uint8 bytes[] = { 0x80, 0xBF, 0xC0, 0xC1, 0xE0, 0xED, 0xF4, 0xF5, 0xFF, 0xA0, 0x90, 0x8F };
+			utf8[pos] = bytes[NextRandom() % sizeof(bytes)];
+		}
+		if (NextRandom() % 4 == 0 && n8) {
+			n8 -= NextRandom() % 3 % (n8 + 1);
+		}
+		sl_bool flagValid = IsValidUtf8(utf8, n8);
+		if (!flagValid) {
+			nInvalid++;
+		}
+		if (Charsets::isValidUtf8((sl_char8*)utf8, n8) != flagValid) {
+			nFailures++;
+		}
+		if ((Charsets::utf8ToUtf16Strict((sl_char8*)utf8, n8, out16, 1200) >= 0) != flagValid) {
+			nFailures++;
+		}
+	}
+	TEST_CHECK_EQUAL(nFailures, 0);
+	TEST_CHECK(nInvalid > 10000);
+	
+	sl_char16 unpaired[] = { 'a', 0xD800, 'b' };
+	TEST_CHECK(!(Charsets::isValidUtf16(unpaired, 3)));
+	sl_char16 reversed[] = { 0xDC00, 0xD800 };
+	TEST_CHECK(!(Charsets::isValidUtf16(reversed, 2)));
+	sl_char16 pair[] = { 0xD83D, 0xDE00 };
+	TEST_CHECK(Charsets::isValidUtf16(pair, 2));
+	sl_char8 out8[16];
+	TEST_CHECK(Charsets::utf16ToUtf8Strict(unpaired, 3, out8, 16) < 0);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestConversions();
+	TestValidation();
+	return TestResult("Charset");
+}
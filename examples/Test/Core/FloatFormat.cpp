@@ -0,0 +1,202 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+#include <stdlib.h>
+
+using namespace slib;
+
+/*
+	Shortest round-trip formatting (String::fromDouble/fromFloat) and
+	exact parsing (String::parseDouble/parseFloat), checked against strtod
+*/
+
+static sl_uint64 g_seed = 0x9E3779B97F4A7C15;
+
+static sl_uint64 NextRandom()
+{
+	g_seed ^= g_seed << 13;
+	g_seed ^= g_seed >> 7;
+	g_seed ^= g_seed << 17;
+	return g_seed;
+}
+
+static double ToDouble(sl_uint64 bits)
+{
+	double d;
+	Base::copyMemory(&d, &bits, 8);
+	return d;
+}
+
+static float ToFloat(sl_uint32 bits)
+{
+	float f;
+	Base::copyMemory(&f, &bits, 4);
+	return f;
+}
+
+static sl_bool IsSameDouble(double a, double b)
+{
+	return Base::equalsMemory(&a, &b, 8);
+}
+
+static void TestFormat()
+{
+	TEST_CHECK_EQUAL(String::fromDouble(0.1), "0.1");
+	TEST_CHECK_EQUAL(String::fromDouble(0.3), "0.3");
+	TEST_CHECK_EQUAL(String::fromDouble(100), "100.0");
+	TEST_CHECK_EQUAL(String::fromDouble(2.5), "2.5");
+	TEST_CHECK_EQUAL(String::fromDouble(123456.789), "123456.789");
+	TEST_CHECK_EQUAL(String::fromDouble(1.0 / 3), "0.3333333333333333");
+	TEST_CHECK_EQUAL(String::fromDouble(1e23), "1.0e+23");
+	TEST_CHECK_EQUAL(String::fromDouble(1.7976931348623157e308), "1.7976931348623157e+308");
+	static const double values[] = { 0, -0.0, 1.5, -1e-300, 1e300, 1.0 / 0.0, 0.0 / 0.0 };
+	for (sl_size i = 0; i < CountOfArray(values); i++) {
+		sl_char8 buf[64];
+		sl_size len = String::fromDouble(values[i], buf);
+		TEST_CHECK_EQUAL(String(buf, len), String::fromDouble(values[i]));
+	}
+	TEST_CHECK_EQUAL(String::fromFloat(0.1f), "0.1");
+	TEST_CHECK_EQUAL(String::fromFloat(1.0f / 3), "0.33333334");
+	TEST_CHECK_EQUAL(String::fromFloat(123456.789f), "123456.79");
+}
+
+static void TestRoundTrip()
+{
+	sl_uint32 nMismatch = 0;
+	for (sl_uint32 i = 0; i < 200000; i++) {
+		double d = ToDouble(NextRandom());
+		if (Math::isNaN(d) || Math::isInfinite(d)) {
+			continue;
+		}
+		String s = String::fromDouble(d);
+		// the buffer version writes the same characters
+		sl_char8 buf[64];
+		sl_size len = String::fromDouble(d, buf);
+		if (!(s == String(buf, len))) {
+			nMismatch++;
+		}
+		double r = 0;
+		if (!(s.parseDouble(&r)) || !(IsSameDouble(d, r) || (d == 0 && r == 0))) {
+			if (nMismatch < 10) {
+				Println("double round-trip mismatch: %s", s);
+			}
+			nMismatch++;
+		}
+		if (!(strtod(s.getData(), sl_null) == d)) {
+			nMismatch++;
+		}
+	}
+	TEST_CHECK_EQUAL(nMismatch, 0);
+	nMismatch = 0;
+	for (sl_uint32 i = 0; i < 200000; i++) {
+		float f = ToFloat((sl_uint32)(NextRandom()));
+		if (Math::isNaN(f) || Math::isInfinite(f)) {
+			continue;
+		}
+		String s = String::fromFloat(f);
+		float r = 0;
+		if (!(s.parseFloat(&r)) || !(r == f)) {
+			if (nMismatch < 10) {
+				Println("float round-trip mismatch: %s", s);
+			}
+			nMismatch++;
+		}
+	}
+	TEST_CHECK_EQUAL(nMismatch, 0);
+}
+
+static void TestParse()
+{
+	static const char* hardCases[] = {
+		"2.2250738585072011e-308",
+		"2.2250738585072012e-308",
+		"4.9406564584124654e-324",
+		"2.4703282292062327e-324",
+		"2.4703282292062328e-324",
+		"9007199254740993",
+		"9007199254740992.99999999999999999999999999999",
+		"1.00000000000000011102230246251565404236316680908203125",
+		"1.00000000000000011102230246251565404236316680908203124",
+		"0.1",
+		"1e-400",
+		"1.7976931348623158e308",
+		"179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497791.9999999999999999999999999999999999999999999999999999999999999999999999",
+		"7.038531e-26",
+		"123456789012345678901234567890e-20",
+		"0.000000000000000000000000000000000000000000001e300"
+	};
+	for (sl_size i = 0; i < CountOfArray(hardCases); i++) {
+		double d = 0;
+		TEST_CHECK(String(hardCases[i]).parseDouble(&d));
+		double e = strtod(hardCases[i], sl_null);
+		if (!(IsSameDouble(d, e))) {
+			TEST_CHECK(IsSameDouble(d, e));
+			Println("parse mismatch: %s", hardCases[i]);
+		}
+	}
+	// random decimal strings with many digits and wide exponents
+	sl_uint32 nMismatch = 0;
+	for (sl_uint32 i = 0; i < 100000; i++) {
+		char sz[128];
+		sl_uint32 nDigits = 1 + (sl_uint32)(NextRandom() % 40);
+		sl_uint32 k = 0;
+		for (sl_uint32 j = 0; j < nDigits; j++) {
+			sz[k++] = (char)('0' + NextRandom() % 10);
+			if (j == 0 && nDigits > 1 && (NextRandom() & 1)) {
+				sz[k++] = '.';
+			}
+		}
+		snprintf(sz + k, sizeof(sz) - k, "e%d", (int)(NextRandom() % 700) - 350);
+		double d = 0;
+		String(sz).parseDouble(&d);
+		double e = strtod(sz, sl_null);
+		if (!(IsSameDouble(d, e))) {
+			if (nMismatch < 10) {
+				Println("parse mismatch: %s", sz);
+			}
+			nMismatch++;
+		}
+		float f = 0;
+		String(sz).parseFloat(&f);
+		if (!(f == strtof(sz, sl_null))) {
+			if (nMismatch < 10) {
+				Println("float parse mismatch: %s", sz);
+			}
+			nMismatch++;
+		}
+	}
+	TEST_CHECK_EQUAL(nMismatch, 0);
+	double d = 0;
+	TEST_CHECK(!(String("1.").parseDouble(&d)));
+	TEST_CHECK(!(String(".5").parseDouble(&d)));
+	TEST_CHECK(!(String("1e").parseDouble(&d)));
+}
+
+int main(int argc, const char * argv[])
+{
+	TestFormat();
+	TestRoundTrip();
+	TestParse();
+	return TestResult("FloatFormat");
+}
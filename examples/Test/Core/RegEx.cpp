@@ -0,0 +1,137 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Native ECMAScript engine against the results of a JavaScript engine (V8),
+	focusing on the quantified atoms which can match the empty string and
+	the captures inside the quantified atoms
+*/
+
+struct RegExCase
+{
+	const char* pattern;
+	const char* subject;
+	// positions of the groups ("u": not participated), or "-" if no match
+	const char* expected;
+};
+
+static String FormatResult(RegExMatchResult& result)
+{
+	StringBuffer buf;
+	for (sl_uint32 i = 0; i < result.getGroupCount(); i++) {
+		if (i) {
+			buf.addStatic(" ", 1);
+		}
+		if (result.isMatched(i)) {
+			buf.add(String::format("%d,%d", result.getStart(i), result.getEnd(i)));
+		} else {
+			buf.addStatic("u", 1);
+		}
+	}
+	return buf.merge();
+}
+
+static void TestDifferential()
+{
+	static const RegExCase cases[] = {
+		{"(?:^|ab?\?(?:\\Bac|ab?\?)?\?){1,2}", "a_c", "0,1"},
+		{"(?:(a)|b)+", "ab", "0,2 u"},
+		{"(?:(a)|(b))+", "ab", "0,2 u 1,2"},
+		{"((a)|b)*", "aab", "0,3 2,3 u"},
+		{"(?:(a)|b){2}", "ab", "0,2 u"},
+		{"(a?)?", "b", "0,0 u"},
+		{"(a*)?", "b", "0,0 u"},
+		{"(a*)*", "b", "0,0 u"},
+		{"(a*)+", "b", "0,0 0,0"},
+		{"(a*)+", "aab", "0,2 0,2"},
+		{"(a|)+", "aab", "0,2 1,2"},
+		{"(?:a|()){0,2}", "b", "0,0 u"},
+		{"(\\b|aca{2,}|)?(a|a\\b|((?:)?\?c)+?)()+?", "_ba", "2,3 u 2,3 u 3,3"},
+		{"a(?:b?\?|(?:)(|($c|)a(?:a_|[ab]c)+|^(\\b.)b{0,2}?){0,2}|)?|a", "cabcb_", "1,3 u u u"},
+		{"((_{2}a)){2,}?|(?:a\\B\\B|\\b)(|b){2,}[ab]", "bb", "0,2 u u 0,1"},
+		{"._{1,2}?(\\Bb||c?b)?", "ba_ab", "1,3 u"},
+		{"((_a{0,1}|[ab]){2,}())(){0,2}\\B|a{2,}", "_b_b__", "0,5 0,5 4,5 5,5 u"},
+		{"(?:b*?(|.b[ab]){0,2})()_{0,2}||ba", "__abc", "0,2 u 0,0"},
+		{".(){0,1}b", "ab", "0,2 u"},
+		{"(|\\b_){0,2}(a{2,}\\B^|(($|b{2,}.{1,2}a)||(?:a|[ab])b{2}?(^))ba|^.*?)||b", "cab", "0,0 u 0,0 u u u"},
+		{"(?:(?:a?)+?b)*c", "abbc", "0,4"},
+		{"(a+|b*)*c", "aabbc", "0,5 2,4"},
+		{"(?:(x)|(y)|z)*", "xyz", "0,3 u u"},
+		{"(\\d+)(?:,(\\d+))*", "1,22,333", "0,8 0,1 5,8"},
+		{"([ab]*?)(b)?c", "aabc", "0,4 0,2 2,3"},
+	};
+	for (sl_size i = 0; i < CountOfArray(cases); i++) {
+		const RegExCase& c = cases[i];
+		RegEx re(c.pattern);
+		TEST_CHECK(re.isNotNull());
+		if (re.isNull()) {
+			continue;
+		}
+		RegExMatchResult result;
+		sl_bool flagFound = re.search(c.subject, &result);
+		String ret = flagFound ? FormatResult(result) : String("-");
+		if (ret != c.expected) {
+			Println("pattern: %s, subject: \"%s\"", c.pattern, c.subject);
+		}
+		TEST_CHECK_EQUAL(ret, c.expected);
+		// boolean search (DFA) must agree
+		TEST_CHECK_EQUAL(re.search(c.subject), flagFound);
+	}
+}
+
+static void TestMatch()
+{
+	RegEx re("(?:(a)|b)*(c)?");
+	RegExMatchResult result;
+	TEST_CHECK(re.match("abab", &result));
+	TEST_CHECK_EQUAL(FormatResult(result), "0,4 u u");
+	TEST_CHECK(re.match("ababac", &result));
+	TEST_CHECK_EQUAL(FormatResult(result), "0,6 4,5 5,6");
+	TEST_CHECK(!(re.match("abx")));
+	TEST_CHECK(RegEx("(a*)*").match(""));
+	TEST_CHECK(RegEx("(?:a?){2,}b").match("aab"));
+}
+
+static void TestLinearTime()
+{
+	// exponential for the backtracking engines
+	String subject = String('a', 100000) + "c";
+	RegEx re("(a*)*b");
+	RegExMatchResult result;
+	TEST_CHECK(!(re.search(subject, &result)));
+	TEST_CHECK(!(re.search(subject)));
+	re = RegEx("((a|b?)+)+c");
+	TEST_CHECK(re.search(subject, &result));
+	TEST_CHECK_EQUAL(FormatResult(result), "0,100001 0,100000 99999,100000");
+}
+
+int main(int argc, const char * argv[])
+{
+	TestDifferential();
+	TestMatch();
+	TestLinearTime();
+	return TestResult("RegEx");
+}
@@ -0,0 +1,115 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	SLIB_FORMAT must produce the same output as String::format,
+	which parses the format string at runtime
+*/
+
+#define CHECK_FORMAT(FORMAT, ...) TEST_CHECK_EQUAL(SLIB_FORMAT(FORMAT, ##__VA_ARGS__), String::format(FORMAT, ##__VA_ARGS__))
+
+static void TestIntegers()
+{
+	sl_int32 values[] = { 0, 1, -1, 42, -1234567, 2147483647, (sl_int32)0x80000000 };
+	for (sl_size i = 0; i < CountOfArray(values); i++) {
+		sl_int32 v = values[i];
+		CHECK_FORMAT("%d", v);
+		CHECK_FORMAT("[%8d]", v);
+		CHECK_FORMAT("[%-8d]", v);
+		CHECK_FORMAT("[%08d]", v);
+		CHECK_FORMAT("[%+d]", v);
+		CHECK_FORMAT("[% d]", v);
+		CHECK_FORMAT("[%,d]", v);
+		CHECK_FORMAT("[%(d]", v);
+		CHECK_FORMAT("%x %X %o", v, v, v);
+	}
+	sl_uint64 u = SLIB_UINT64(18446744073709551615);
+	CHECK_FORMAT("%d %x", u, u);
+	sl_int64 n = SLIB_INT64(-9223372036854775807);
+	CHECK_FORMAT("%d|%,d", n, n);
+	CHECK_FORMAT("%c%c", 'A', 'z');
+}
+
+static void TestFloats()
+{
+	double values[] = { 0, 0.1, -2.5, 3.14159265358979, 1e23, 1e-7, 123456.789 };
+	for (sl_size i = 0; i < CountOfArray(values); i++) {
+		double v = values[i];
+		CHECK_FORMAT("%f", v);
+		CHECK_FORMAT("%.2f", v);
+		CHECK_FORMAT("[%10.3f]", v);
+		CHECK_FORMAT("%e %E", v, v);
+		CHECK_FORMAT("%g %G", v, v);
+		CHECK_FORMAT("%.3e", v);
+		CHECK_FORMAT("[%,.1f]", v);
+	}
+	CHECK_FORMAT("%f", 1.5f);
+}
+
+static void TestStrings()
+{
+	String s = "hello";
+	String16 s16 = SLIB_UNICODE("wide");
+	StringView view("view-text", 4);
+	const char* sz = "literal";
+	CHECK_FORMAT("%s, %s!", s, sz);
+	CHECK_FORMAT("[%10s][%-10s]", s, s);
+	CHECK_FORMAT("%s", s16);
+	TEST_CHECK_EQUAL(SLIB_FORMAT("%s", view), "view");
+	CHECK_FORMAT("%s %d", sl_true, sl_false);
+	CHECK_FORMAT("%d%% done%n", 100);
+	TEST_CHECK_EQUAL(SLIB_FORMAT("100%% done%n"), "100% done\r\n");
+	CHECK_FORMAT("%2$s %1$s", "world", "hello");
+	TEST_CHECK_EQUAL(SLIB_FORMAT("%s", String::null()), "");
+}
+
+static void TestTime()
+{
+	Time t(2019, 3, 5, 7, 8, 9, 10);
+	CHECK_FORMAT("%y-%m-%d %H:%M:%S.%l", t, t, t, t, t, t, t);
+	CHECK_FORMAT("%D %T", t, t);
+	CHECK_FORMAT("%s", t);
+	CHECK_FORMAT("%w %W", t, t);
+	CHECK_FORMAT("%uH:%uM", t, t);
+	CHECK_FORMAT("%02m", t);
+}
+
+static void TestLong()
+{
+	// longer than the stack buffer of the writer
+	String s = String('x', 5000);
+	CHECK_FORMAT("<%s>%d<%s>", s, 12345, s);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestIntegers();
+	TestFloats();
+	TestStrings();
+	TestTime();
+	TestLong();
+	return TestResult("StringFormat");
+}
@@ -0,0 +1,108 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	StringPool interning, AtomString lookups,
+	and sharing the pooled keys while parsing JSON
+*/
+
+static void TestPool()
+{
+	StringPool pool;
+	String a = pool.add(StringView("alpha"));
+	String b = pool.add(String("alpha"));
+	TEST_CHECK(a.getData() == b.getData());
+	TEST_CHECK(pool.contains("alpha"));
+	TEST_CHECK(!(pool.contains("beta")));
+	TEST_CHECK(pool.get("beta").isNull());
+	TEST_CHECK_EQUAL(pool.getCount(), 1);
+	String c = pool.add(StringView("beta"));
+	TEST_CHECK(pool.get("beta").getData() == c.getData());
+	TEST_CHECK_EQUAL(pool.getCount(), 2);
+	pool.clear();
+	TEST_CHECK_EQUAL(pool.getCount(), 0);
+	TEST_CHECK(pool.add(StringView("alpha")).getData() != a.getData());
+	TEST_CHECK(pool.add(StringView("")).isEmpty());
+}
+
+static void TestAtom()
+{
+	TEST_CHECK(AtomString::lookup("test_atom_not_interned").isNull());
+	AtomString a("test_atom_key");
+	AtomString b = AtomString::lookup("test_atom_key");
+	TEST_CHECK(a.isNotNull());
+	TEST_CHECK(a.getData() == b.getData());
+	TEST_CHECK(a == b);
+	TEST_CHECK_EQUAL(a.getHashCode(), String("test_atom_key").getHashCode());
+}
+
+static void TestJsonKeys()
+{
+	StringPool* pool = StringPool::getDefault();
+	AtomString known("test_json_known");
+	AtomString escaped("test_json_escaped");
+	sl_size nCount = pool->getCount();
+
+	JsonParseParam param;
+	param.flagInternKeys = sl_true;
+	String src = "{\"test_json_known\": 1, \"test_json_unknown\": 2, \"test_json_\\u0065scaped\": 3, test_json_known2: 4}";
+	Json json = Json::parseJson(src, param);
+	TEST_CHECK(!(param.flagError));
+	JsonMap map = json.getJsonMap();
+	TEST_CHECK_EQUAL(map.getCount(), 4);
+	sl_uint32 nShared = 0;
+	for (auto& item : map) {
+		if (item.key == "test_json_known") {
+			TEST_CHECK(item.key.getData() == known.getData());
+			nShared++;
+		} else if (item.key == "test_json_escaped") {
+			TEST_CHECK(item.key.getData() == escaped.getData());
+			nShared++;
+		}
+	}
+	TEST_CHECK_EQUAL(nShared, 2);
+	TEST_CHECK_EQUAL(json["test_json_unknown"].getInt32(), 2);
+	TEST_CHECK_EQUAL(json["test_json_known2"].getInt32(), 4);
+
+	// unknown keys must not grow the pool
+	TEST_CHECK_EQUAL(pool->getCount(), nCount);
+	TEST_CHECK(!(pool->contains("test_json_unknown")));
+	TEST_CHECK(!(pool->contains("test_json_known2")));
+
+	String16 src16(src);
+	json = Json::parseJson16(src16, param);
+	TEST_CHECK(!(param.flagError));
+	TEST_CHECK_EQUAL(json["test_json_known"].getInt32(), 1);
+	TEST_CHECK_EQUAL(pool->getCount(), nCount);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestPool();
+	TestAtom();
+	TestJsonKeys();
+	return TestResult("StringPool");
+}
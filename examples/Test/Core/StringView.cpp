@@ -0,0 +1,131 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	StringView/StringView16 operations against the String equivalents,
+	and HashMap lookups by StringView
+*/
+
+static void TestView()
+{
+	String str = "  key=value; other = 42 ;x  ";
+	StringView view(str);
+	TEST_CHECK(view.getData() == str.getData());
+	TEST_CHECK_EQUAL(view.getLength(), str.getLength());
+	TEST_CHECK(view.equals(StringView("  key=value; other = 42 ;x  ")));
+	TEST_CHECK_EQUAL(view.trim().toString(), str.trim());
+	TEST_CHECK_EQUAL(view.trimLeft().toString(), str.trimLeft());
+	TEST_CHECK_EQUAL(view.trimRight().toString(), str.trimRight());
+	TEST_CHECK_EQUAL(view.indexOf('='), str.indexOf('='));
+	TEST_CHECK_EQUAL(view.indexOf("other"), str.indexOf("other"));
+	TEST_CHECK_EQUAL(view.indexOf("other", 20), -1);
+	TEST_CHECK_EQUAL(view.lastIndexOf('='), str.lastIndexOf('='));
+	TEST_CHECK_EQUAL(view.lastIndexOf(" "), str.lastIndexOf(" "));
+	TEST_CHECK_EQUAL(view.substring(2, 5).toString(), str.substring(2, 5));
+	TEST_CHECK_EQUAL(view.left(5).toString(), str.left(5));
+	TEST_CHECK_EQUAL(view.right(4).toString(), str.right(4));
+	TEST_CHECK_EQUAL(view.mid(2, 3).toString(), str.mid(2, 3));
+	TEST_CHECK(view.trim().startsWith("key"));
+	TEST_CHECK(view.trim().endsWith('x'));
+	TEST_CHECK(view.contains("value"));
+	TEST_CHECK(!(view.contains("values")));
+	
+	List<StringView> items = view.trim().split(";");
+	TEST_CHECK_EQUAL(items.getCount(), 3);
+	if (items.getCount() == 3) {
+		TEST_CHECK_EQUAL(items[0].toString(), "key=value");
+		TEST_CHECK_EQUAL(items[1].trim().toString(), "other = 42");
+		TEST_CHECK_EQUAL(items[1].trim().right(2).parseInt32(), 42);
+		TEST_CHECK_EQUAL(items[2].toString(), "x");
+	}
+	
+	TEST_CHECK(StringView("abc") < StringView("abd"));
+	TEST_CHECK(StringView("abc") < StringView("abcd"));
+	TEST_CHECK(StringView("ABC").equalsIgnoreCase("abc"));
+	TEST_CHECK_EQUAL(StringView("ABC").compareIgnoreCase("abd"), String("ABC").compareIgnoreCase("abd"));
+	TEST_CHECK_EQUAL(StringView("hello").getHashCode(), String("hello").getHashCode());
+	TEST_CHECK_EQUAL(StringView("Hello").getHashCodeIgnoreCase(), String("hello").getHashCodeIgnoreCase());
+	
+	StringView empty;
+	TEST_CHECK(empty.isNull() && empty.isEmpty());
+	TEST_CHECK(empty.toString().isNull());
+	TEST_CHECK(StringView("").isEmpty());
+	TEST_CHECK(StringView("").isNotNull());
+}
+
+static void TestParse()
+{
+	// views must stop at their length, not at the terminating null of the source
+	String str = "12345678901234567890";
+	StringView view(str.getData(), 4);
+	TEST_CHECK_EQUAL(view.parseInt32(), 1234);
+	TEST_CHECK_EQUAL(StringView(str).parseUint64(), SLIB_UINT64(12345678901234567890));
+	sl_int64 n = 0;
+	TEST_CHECK(!(StringView(str.getData(), 0).parseInt64(10, &n)));
+	TEST_CHECK_EQUAL(StringView("-ff").parseInt32(16), -255);
+	TEST_CHECK_EQUAL(StringView("3.25e2xyz", 6).parseDouble(), 325.0);
+	TEST_CHECK(StringView("true").parseBoolean());
+	sl_uint8 hex[2] = { 0 };
+	TEST_CHECK(StringView("a1ff").parseHexString(hex));
+	TEST_CHECK(hex[0] == 0xa1 && hex[1] == 0xff);
+	sl_int32 v = 0;
+	TEST_CHECK(!(StringView("12a").parseInt32(10, &v)));
+}
+
+static void TestView16()
+{
+	String16 str = SLIB_UNICODE("  Hello, World  ");
+	StringView16 view(str);
+	TEST_CHECK_EQUAL(view.getLength(), str.getLength());
+	TEST_CHECK(view.trim().toString() == str.trim());
+	TEST_CHECK_EQUAL(view.indexOf(SLIB_UNICODE("World")), str.indexOf(SLIB_UNICODE("World")));
+	TEST_CHECK(view.trim().startsWith(SLIB_UNICODE("Hello")));
+	TEST_CHECK_EQUAL(StringView16(SLIB_UNICODE("-123")).parseInt32(), -123);
+}
+
+static void TestHashMapLookup()
+{
+	HashMap<String, sl_int32> map;
+	map.put("content-type", 1);
+	map.put("content-length", 2);
+	String header = "Content-Length: 10";
+	StringView key = StringView(header).left(14);
+	TEST_CHECK(!(map.find(key)));
+	TEST_CHECK_EQUAL(map.getValue(StringView("content-length"), 0), 2);
+	TEST_CHECK_EQUAL(map.getValue(StringView("content-type", 12), 0), 1);
+	TEST_CHECK_EQUAL(map.getValue(StringView("content-typ"), -1), -1);
+	sl_int32 v = 0;
+	TEST_CHECK(map.get(StringView(String("content-type")), &v) && v == 1);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestView();
+	TestParse();
+	TestView16();
+	TestHashMapLookup();
+	return TestResult("StringView");
+}
@@ -0,0 +1,95 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	ThreadPool must not lose the tasks added while the only worker is going idle
+	(the worker used to exit or sleep without seeing the task)
+*/
+
+static void TestIdleWorker(sl_uint32 minThreads, sl_uint32 nRounds)
+{
+	Ref<ThreadPool> pool = ThreadPool::create(minThreads, 1);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	Ref<Event> ev = Event::create();
+	sl_uint32 nLost = 0;
+	for (sl_uint32 i = 0; i < nRounds; i++) {
+		TEST_CHECK(pool->addTask([ev]() {
+			ev->set();
+		}));
+		if (!(ev->wait(5000))) {
+			nLost++;
+			break;
+		}
+	}
+	TEST_CHECK_EQUAL(nLost, 0);
+	pool->release();
+}
+
+static void TestManyProducers()
+{
+	Ref<ThreadPool> pool = ThreadPool::create(0, 3);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	const sl_int32 nProducers = 8;
+	const sl_int32 nTasksPerProducer = 5000;
+	sl_int32 nDone = 0;
+	sl_int32* pDone = &nDone;
+	List< Ref<Thread> > producers;
+	for (sl_int32 i = 0; i < nProducers; i++) {
+		producers.add(Thread::start([pool, pDone]() {
+			for (sl_int32 k = 0; k < nTasksPerProducer; k++) {
+				pool->addTask([pDone]() {
+					Base::interlockedIncrement32(pDone);
+				});
+				if (!(k & 63)) {
+					Thread::sleep(1);
+				}
+			}
+		}));
+	}
+	for (auto& thread : producers) {
+		thread->join();
+	}
+	sl_int32 nTotal = nProducers * nTasksPerProducer;
+	for (sl_uint32 i = 0; i < 1000 && Base::interlockedAdd32(pDone, 0) < nTotal; i++) {
+		Thread::sleep(10);
+	}
+	TEST_CHECK_EQUAL(Base::interlockedAdd32(pDone, 0), nTotal);
+	pool->release();
+}
+
+int main(int argc, const char * argv[])
+{
+	TestIdleWorker(0, 20000);
+	TestIdleWorker(1, 20000);
+	TestManyProducers();
+	return TestResult("ThreadPool");
+}
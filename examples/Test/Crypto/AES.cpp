@@ -0,0 +1,247 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	AES block, CTR and GCM against the standard test vectors (FIPS-197, SP 800-38A, GCM spec),
+	and the pipelined paths against the results of OpenSSL on the longer inputs
+*/
+
+static Memory FromHex(const char* hex)
+{
+	String str(hex);
+	Memory mem = Memory::create(str.getLength() / 2);
+	if (mem.isNotNull()) {
+		str.parseHexString(mem.getData());
+	}
+	return mem;
+}
+
+static String ToHex(const void* data, sl_size size)
+{
+	return String::makeHexString(data, size);
+}
+
+static Memory MakeData(sl_size size)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < size; i++) {
+		p[i] = (sl_uint8)(i * 7 + 3);
+	}
+	return mem;
+}
+
+static String HashHex(const void* data, sl_size size)
+{
+	sl_uint8 h[32];
+	SHA256::hash(data, size, h);
+	return ToHex(h, 32);
+}
+
+static void TestBlock()
+{
+	static const char* keys[] = {
+		"000102030405060708090a0b0c0d0e0f",
+		"000102030405060708090a0b0c0d0e0f1011121314151617",
+		"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+	};
+	static const char* outputs[] = {
+		"69c4e0d86a7b0430d8cdb78070b4c55a",
+		"dda97ca4864cdfe06eaf70a0ec0d7191",
+		"8ea2b7ca516745bfeafc49904b496089"
+	};
+	Memory input = FromHex("00112233445566778899aabbccddeeff");
+	for (sl_uint32 i = 0; i < 3; i++) {
+		Memory key = FromHex(keys[i]);
+		AES aes;
+		TEST_CHECK(aes.setKey(key.getData(), (sl_uint32)(key.getSize())));
+		sl_uint8 enc[16], dec[16];
+		aes.encryptBlock(input.getData(), enc);
+		TEST_CHECK_EQUAL(ToHex(enc, 16), outputs[i]);
+		aes.decryptBlock(enc, dec);
+		TEST_CHECK(Base::equalsMemory(dec, input.getData(), 16));
+	}
+	AES aes;
+	TEST_CHECK(!(aes.setKey("0123456789", 10)));
+}
+
+static void TestCBC()
+{
+	AES aes;
+	aes.setKey_SHA256("cbc key");
+	for (sl_size n = 0; n < 100; n += 7) {
+		Memory data = MakeData(n);
+		Memory enc = aes.encrypt_CBC_PKCS7Padding(data);
+		TEST_CHECK_EQUAL(enc.getSize(), 16 + (n / 16 + 1) * 16);
+		Memory dec = aes.decrypt_CBC_PKCS7Padding(enc);
+		TEST_CHECK_EQUAL(dec.getSize(), n);
+		TEST_CHECK(Base::equalsMemory(dec.getData(), data.getData(), n));
+	}
+}
+
+static void TestCTR()
+{
+	// SP 800-38A F.5.1
+	AES aes;
+	Memory key = FromHex("2b7e151628aed2a6abf7158809cf4f3c");
+	aes.setKey(key.getData(), 16);
+	Memory input = FromHex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+	Memory counter = FromHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+	sl_uint8 output[64];
+	TEST_CHECK_EQUAL(aes.encryptBlocks_CTR(counter.getData(), input.getData(), output, 64), 64);
+	TEST_CHECK_EQUAL(ToHex(output, 64), "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+	TEST_CHECK_EQUAL(ToHex(counter.getData(), 16), "f0f1f2f3f4f5f6f7f8f9fafbfcfdff03");
+
+	// OpenSSL aes-128-ctr
+	static const sl_size sizes[] = { 1, 16, 17, 129, 4099, 100000 };
+	static const char* hashes[] = {
+		"3f79bb7b435b05321651daefd374cdc681dc06faa65e374e38337b88ca046dea",
+		"1e9ba52cb42479205a66b3c682e21db52ab2919f7400e35fe9f6fa58d197d25a",
+		"dbd973164f522257e7d1810aba0a5673d2d88813978825c809640ff658ad8dbe",
+		"00186f55f0b3d244573b76ff3b439de60cf4a8d2929237445c42d50479a83ef8",
+		"35a0f2fa09ea0e8160d8dde73f11de89af3601c1bd7e8a44a3181c1446326008",
+		"f0c646707e6d2d0b658dc041c42c67ae0c9050dfaa80b120157b02e2fbcdceb4"
+	};
+	key = FromHex("000102030405060708090a0b0c0d0e0f");
+	aes.setKey(key.getData(), 16);
+	for (sl_size i = 0; i < CountOfArray(sizes); i++) {
+		sl_size n = sizes[i];
+		Memory data = MakeData(n);
+		Memory enc = Memory::create(n);
+		counter = FromHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+		TEST_CHECK_EQUAL(aes.encrypt_CTR(data.getData(), n, enc.getData(), counter.getData()), n);
+		TEST_CHECK_EQUAL(HashHex(enc.getData(), n), hashes[i]);
+	}
+
+	// carry over the low 64 bits, with OpenSSL aes-256-ctr
+	key = FromHex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+	aes.setKey(key.getData(), 32);
+	Memory data = MakeData(1600);
+	Memory enc = Memory::create(1600);
+	counter = FromHex("0001020304050607fffffffffffffffd");
+	TEST_CHECK_EQUAL(aes.encryptBlocks_CTR(counter.getData(), data.getData(), enc.getData(), 1600), 1600);
+	TEST_CHECK_EQUAL(HashHex(enc.getData(), 1600), "ab9e68b86c4e6c210496ba6d4a3198071562aa04260159911750e87101e7af25");
+	TEST_CHECK_EQUAL(ToHex(counter.getData(), 16), "00010203040506080000000000000061");
+
+	// GCTR wraps in the low 32 bits, against the single block encryption
+	Memory start = FromHex("000102030405060708090a0bfffffff0");
+	counter = start.duplicate();
+	TEST_CHECK_EQUAL(aes.encryptBlocks_GCTR(counter.getData(), data.getData(), enc.getData(), 1600), 1600);
+	sl_uint8 block[16];
+	Base::copyMemory(block, start.getData(), 16);
+	sl_bool flagEqual = sl_true;
+	for (sl_size i = 0; i < 100; i++) {
+		sl_uint8 pad[16];
+		aes.encryptBlock(block, pad);
+		for (sl_uint32 k = 0; k < 16; k++) {
+			if ((sl_uint8)(((sl_uint8*)(data.getData()))[i * 16 + k] ^ pad[k]) != ((sl_uint8*)(enc.getData()))[i * 16 + k]) {
+				flagEqual = sl_false;
+			}
+		}
+		MIO::writeUint32BE(block + 12, MIO::readUint32BE(block + 12) + 1);
+	}
+	TEST_CHECK(flagEqual);
+	TEST_CHECK(Base::equalsMemory(counter.getData(), block, 16));
+}
+
+static void TestGCM()
+{
+	// GCM spec, test case 4
+	AES_GCM gcm;
+	Memory key = FromHex("feffe9928665731c6d6a8f9467308308");
+	gcm.setKey(key.getData(), 16);
+	Memory iv = FromHex("cafebabefacedbaddecaf888");
+	Memory aad = FromHex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+	Memory input = FromHex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39");
+	sl_size n = input.getSize();
+	Memory enc = Memory::create(n);
+	Memory dec = Memory::create(n);
+	sl_uint8 tag[16];
+	TEST_CHECK(gcm.encrypt(iv.getData(), iv.getSize(), aad.getData(), aad.getSize(), input.getData(), enc.getData(), n, tag));
+	TEST_CHECK_EQUAL(ToHex(enc.getData(), n), "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091");
+	TEST_CHECK_EQUAL(ToHex(tag, 16), "5bc94fbc3221a5db94fae95ae7121a47");
+	TEST_CHECK(gcm.decrypt(iv.getData(), iv.getSize(), aad.getData(), aad.getSize(), enc.getData(), dec.getData(), n, tag));
+	TEST_CHECK(Base::equalsMemory(dec.getData(), input.getData(), n));
+	tag[0] ^= 1;
+	TEST_CHECK(!(gcm.decrypt(iv.getData(), iv.getSize(), aad.getData(), aad.getSize(), enc.getData(), dec.getData(), n, tag)));
+
+	// OpenSSL aes-128-gcm and aes-256-gcm
+	static const sl_size sizes[] = { 0, 1, 15, 16, 17, 127, 128, 129, 4099, 100000 };
+	static const char* tags128[] = {
+		"c7f18cdac337998b8ae103900c212479", "3de0af827453e443be1846e99c2d989d", "e64bd14f94c9ba83461aec36b8992c51",
+		"9572fb29d0dbe587771a081c700a1abc", "e084e2e0fc4c3dbca88a4d5093002b10", "ddd384e58490b8cb4d0bba2e3a230714",
+		"2e6963e391582eb1253c6b84691a07f1", "af859a01793ce110dd1ed9c4470bd2df", "e32676020e9405cc8668f959611c8da0",
+		"955500b7c834644faaf168317b2ffd3d"
+	};
+	static const char* tags256[] = {
+		"b12efb26223cb629af03d5b9e14082a2", "e36212969664c3142c19090ad6a145ef", "19c30024e19d51cae3d30b5c90fb21be",
+		"9b819d40c716252010afaad7e2f4f8c7", "95caf8e5410197857d333ec68c53d7c0", "bcb33850c8f81b16cee5ce5f732f6aac",
+		"c1ca34b807f47329a917491f926f0b2f", "2b2d5acb4addb2ab539325eb62ebd2c0", "5b15cbf6581decee353906c722c901d5",
+		"2b8b745c6f2d842e843dcd79106f807d"
+	};
+	aad = FromHex("feedfacedeadbeef");
+	for (sl_uint32 k = 0; k < 2; k++) {
+		key = FromHex(k ? "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f" : "000102030405060708090a0b0c0d0e0f");
+		gcm.setKey(key.getData(), (sl_uint32)(key.getSize()));
+		for (sl_size i = 0; i < CountOfArray(sizes); i++) {
+			n = sizes[i];
+			Memory data = MakeData(n);
+			enc = Memory::create(n);
+			dec = Memory::create(n);
+			TEST_CHECK(gcm.encrypt(iv.getData(), iv.getSize(), aad.getData(), aad.getSize(), data.getData(), enc.getData(), n, tag));
+			TEST_CHECK_EQUAL(ToHex(tag, 16), k ? tags256[i] : tags128[i]);
+			TEST_CHECK(gcm.decrypt(iv.getData(), iv.getSize(), aad.getData(), aad.getSize(), enc.getData(), dec.getData(), n, tag));
+			TEST_CHECK(Base::equalsMemory(dec.getData(), data.getData(), n));
+
+			// incremental API, in the chunks of whole blocks
+			Memory enc2 = Memory::create(n);
+			sl_uint8 tag2[16];
+			gcm.start(iv.getData(), iv.getSize());
+			gcm.put(aad.getData(), aad.getSize());
+			sl_size pos = 0;
+			sl_size chunk = 16;
+			while (pos < n) {
+				sl_size m = Math::min(chunk, n - pos);
+				gcm.encrypt((sl_uint8*)(data.getData()) + pos, (sl_uint8*)(enc2.getData()) + pos, m);
+				pos += m;
+				chunk += 48;
+			}
+			gcm.finish(aad.getSize(), n, tag2);
+			TEST_CHECK(Base::equalsMemory(tag2, tag, 16));
+			TEST_CHECK(Base::equalsMemory(enc2.getData(), enc.getData(), n));
+		}
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("AES hardware acceleration: %s", AES::isHardwareAccelerated() ? "yes" : "no");
+	TestBlock();
+	TestCBC();
+	TestCTR();
+	TestGCM();
+	return TestResult("AES");
+}
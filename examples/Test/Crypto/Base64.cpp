@@ -0,0 +1,142 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Base64 codecs (standard and URL alphabets) against Python's base64 module,
+	the caller-buffer variants, the incremental encoder/decoder and the invalid inputs
+*/
+
+static Memory MakeData(sl_size size)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < size; i++) {
+		p[i] = (sl_uint8)(i * 7 + 3);
+	}
+	return mem;
+}
+
+static String HashHex(const StringBuffer& _buf)
+{
+	String str = ((StringBuffer&)_buf).merge();
+	sl_uint8 h[32];
+	SHA256::hash(str.getData(), str.getLength(), h);
+	return String::makeHexString(h, 32);
+}
+
+static void TestEncode()
+{
+	TEST_CHECK_EQUAL(Base64::encode(String("")), "");
+	TEST_CHECK_EQUAL(Base64::encode(String("f")), "Zg==");
+	TEST_CHECK_EQUAL(Base64::encode(String("fo")), "Zm8=");
+	TEST_CHECK_EQUAL(Base64::encode(String("foo")), "Zm9v");
+	TEST_CHECK_EQUAL(Base64::encode(String("foobar")), "Zm9vYmFy");
+	TEST_CHECK_EQUAL(Base64::encodeUrl(String("\xfb\xff")), "-_8");
+
+	Memory mem = MakeData(300);
+	const sl_uint8* data = (const sl_uint8*)(mem.getData());
+	StringBuffer bufStd, bufUrl;
+	char output[512];
+	for (sl_size n = 0; n < 300; n++) {
+		String s = Base64::encode(data, n);
+		bufStd.add(s);
+		bufStd.addStatic("\n", 1);
+		String u = Base64::encodeUrl(data, n);
+		bufUrl.add(u);
+		bufUrl.addStatic("\n", 1);
+
+		TEST_CHECK_EQUAL(s.getLength(), Base64::getEncodedLength(n));
+		TEST_CHECK_EQUAL(Base64::encodeTo(data, n, output), s.getLength());
+		TEST_CHECK(Base::equalsMemory(output, s.getData(), s.getLength()));
+		TEST_CHECK_EQUAL(Base64::encodeUrlTo(data, n, output), u.getLength());
+		TEST_CHECK(Base::equalsMemory(output, u.getData(), u.getLength()));
+
+		Memory d = Base64::decode(s);
+		TEST_CHECK_EQUAL(d.getSize(), n);
+		TEST_CHECK(Base::equalsMemory(d.getData(), data, n));
+		sl_uint8 decoded[300];
+		TEST_CHECK_EQUAL(Base64::decode(u.getData(), u.getLength(), decoded, 0), n);
+		TEST_CHECK(Base::equalsMemory(decoded, data, n));
+	}
+	TEST_CHECK_EQUAL(HashHex(bufStd), "a3374eca8f46f45da71b92e20b984af271a17e0adc52c5eeb96e620174f41f2a");
+	TEST_CHECK_EQUAL(HashHex(bufUrl), "08e2091d32cfd7a20f73c4716c279d43e1424b7129a0ff6d15312d75a637a58d");
+}
+
+static void TestInvalid()
+{
+	sl_uint8 output[64];
+	TEST_CHECK_EQUAL(Base64::decode("Zm9v*mFy", 8, output), 0);
+	TEST_CHECK_EQUAL(Base64::decode("Zm9vYmF\x80", 8, output), 0);
+	TEST_CHECK(Base64::decode(String("Zm9v*mFy")).isNull());
+	// line breaks are skipped
+	Memory mem = Base64::decode(String("Zm9v\r\nYmFy\r\n"));
+	TEST_CHECK_EQUAL(String((char*)(mem.getData()), mem.getSize()), "foobar");
+	// a long valid prefix for the SIMD path, with an invalid character near the end
+	String s = Base64::encode(MakeData(200));
+	char buf[300];
+	Base::copyMemory(buf, s.getData(), s.getLength());
+	buf[s.getLength() - 5] = '#';
+	sl_uint8 out[300];
+	TEST_CHECK_EQUAL(Base64::decode(buf, s.getLength(), out), 0);
+}
+
+static void TestIncremental()
+{
+	Memory mem = MakeData(1000);
+	const sl_uint8* data = (const sl_uint8*)(mem.getData());
+	String expected = Base64::encode(mem);
+	for (sl_size piece = 1; piece < 70; piece += 4) {
+		Base64Encoder encoder;
+		StringBuffer buf;
+		for (sl_size pos = 0; pos < 1000; pos += piece) {
+			buf.add(encoder.update(data + pos, Math::min(piece, (sl_size)(1000 - pos))));
+		}
+		buf.add(encoder.finish());
+		TEST_CHECK_EQUAL(buf.merge(), expected);
+
+		Base64Decoder decoder;
+		MemoryBuffer bufDecoded;
+		for (sl_size pos = 0; pos < expected.getLength(); pos += piece) {
+			bufDecoded.add(decoder.update(expected.getData() + pos, Math::min(piece, expected.getLength() - pos)));
+		}
+		TEST_CHECK(!(decoder.isError()));
+		Memory decoded = bufDecoded.merge();
+		TEST_CHECK_EQUAL(decoded.getSize(), 1000);
+		TEST_CHECK(Base::equalsMemory(decoded.getData(), data, 1000));
+	}
+	Base64Decoder decoder;
+	decoder.update("Zm9v", 4);
+	decoder.update("Y!Fy", 4);
+	TEST_CHECK(decoder.isError());
+}
+
+int main(int argc, const char * argv[])
+{
+	TestEncode();
+	TestInvalid();
+	TestIncremental();
+	return TestResult("Base64");
+}
@@ -0,0 +1,273 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	BigInt arithmetic around the Karatsuba and word boundaries and modular exponentiation
+	against the results of Python, and RSA against a key and ciphertexts made by OpenSSL
+*/
+
+static BigInt MakeNumber(sl_uint32 bits, sl_uint64 seed)
+{
+	sl_uint32 n = (bits + 7) >> 3;
+	Memory mem = Memory::create(n);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_uint64 s = seed;
+	for (sl_uint32 i = 0; i < n; i++) {
+		s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+		p[i] = (sl_uint8)(s >> 56);
+	}
+	sl_uint32 r = bits & 7;
+	if (r) {
+		p[0] &= (sl_uint8)((1 << r) - 1);
+		p[0] |= (sl_uint8)(1 << (r - 1));
+	} else {
+		p[0] |= 0x80;
+	}
+	return BigInt::fromBytesBE(mem);
+}
+
+static Memory FromHex(const char* hex)
+{
+	String str(hex);
+	Memory mem = Memory::create(str.getLength() / 2);
+	if (mem.isNotNull()) {
+		str.parseHexString(mem.getData());
+	}
+	return mem;
+}
+
+static String HashHex(const String& str)
+{
+	sl_uint8 h[32];
+	SHA256::hash(str.getData(), str.getLength(), h);
+	return String::makeHexString(h, 32);
+}
+
+static void TestSmall()
+{
+	BigInt a = BigInt::fromString("123456789012345678901234567890");
+	BigInt b = BigInt::fromString("-987654321098765432109876543210");
+	TEST_CHECK_EQUAL(BigInt::add(a, b).toString(), "-864197532086419753208641975320");
+	TEST_CHECK_EQUAL(BigInt::mul(a, b).toString(), "-121932631137021795226185032733622923332237463801111263526900");
+	TEST_CHECK_EQUAL(BigInt::fromHexString("FFFFFFFFFFFFFFFF").toString(), "18446744073709551615");
+	TEST_CHECK_EQUAL(BigInt::add(BigInt::fromHexString("FFFFFFFFFFFFFFFF"), (sl_uint32)1).toHexString(), "10000000000000000");
+	TEST_CHECK_EQUAL(BigInt::fromString("0").toString(), "0");
+	TEST_CHECK_EQUAL(BigInt::pow_mod(BigInt::fromUint32(4), BigInt::fromUint32(13), BigInt::fromUint32(497)).toString(), "445");
+	TEST_CHECK_EQUAL(BigInt::inverseMod(BigInt::fromUint32(3), BigInt::fromUint32(11)).toString(), "4");
+	TEST_CHECK_EQUAL(BigInt::gcd(BigInt::fromUint32(462), BigInt::fromUint32(1071)).toString(), "21");
+}
+
+static void TestArithmetic()
+{
+	static const sl_uint32 pairs[][2] = {
+		{31, 17}, {64, 64}, {65, 33}, {128, 64}, {500, 250}, {1024, 512}, {1024, 1024}, {1500, 1500},
+		{2048, 1000}, {3000, 1500}, {4096, 2048}, {4096, 4096}, {8192, 3000}, {8192, 8192}
+	};
+	StringBuffer out;
+	for (sl_uint32 i = 0; i < CountOfArray(pairs); i++) {
+		BigInt a = MakeNumber(pairs[i][0], i * 2 + 1);
+		BigInt b = MakeNumber(pairs[i][1], i * 2 + 2);
+		BigInt product = BigInt::mul(a, b);
+		BigInt remainder;
+		BigInt quotient = BigInt::div(a, b, &remainder);
+		TEST_CHECK(BigInt::add(BigInt::mul(quotient, b), remainder).compare(a) == 0);
+		// the product of the swapped operands runs the other split of the unbalanced Karatsuba
+		TEST_CHECK(BigInt::mul(b, a).compare(product) == 0);
+		out.add(BigInt::add(a, b).toHexString());
+		out.addStatic("\n", 1);
+		out.add(BigInt::sub(b, a).toHexString());
+		out.addStatic("\n", 1);
+		out.add(product.toHexString());
+		out.addStatic("\n", 1);
+		out.add(quotient.toHexString());
+		out.addStatic("\n", 1);
+		out.add(remainder.toHexString());
+		out.addStatic("\n", 1);
+		out.add(BigInt::gcd(a, b).toHexString());
+		out.addStatic("\n", 1);
+		String dec = product.toString();
+		TEST_CHECK(BigInt::fromString(dec).compare(product) == 0);
+		out.add(dec);
+		out.addStatic("\n", 1);
+	}
+	TEST_CHECK_EQUAL(HashHex(out.merge()), "3e11ff74cee70019a2f7f0b0e15eff14fec1df1f1cb66b5167750e44e785c892");
+}
+
+static void TestModular()
+{
+	static const sl_uint32 sizes[][2] = {
+		{64, 64}, {127, 100}, {512, 512}, {1024, 1024}, {1024, 17}, {2048, 2048}, {3072, 256}, {4096, 64}
+	};
+	StringBuffer out;
+	for (sl_uint32 i = 0; i < CountOfArray(sizes); i++) {
+		BigInt m = MakeNumber(sizes[i][0], 100 + i);
+		if (!(m.getBit(0))) {
+			m.add((sl_uint32)1);
+		}
+		BigInt a = MakeNumber(sizes[i][0] + 8, 200 + i);
+		BigInt e = MakeNumber(sizes[i][1], 300 + i);
+		BigInt c = BigInt::pow_mod(a, e, m);
+		TEST_CHECK(BigInt::pow_montgomery(a, e, m).compare(c) == 0);
+		Ref<MontgomeryContext> context = MontgomeryContext::create(m);
+		TEST_CHECK(context.isNotNull());
+		if (context.isNotNull()) {
+			BigInt r = BigInt::mod(a, m);
+			TEST_CHECK(context->pow(r, e).compare(c) == 0);
+			TEST_CHECK(context->mulMod(r, c).compare(BigInt::mod(BigInt::mul(r, c), m)) == 0);
+		}
+		out.add(c.toHexString());
+		out.addStatic("\n", 1);
+		if (BigInt::gcd(a, m).compare((sl_uint32)1) == 0) {
+			BigInt inv = BigInt::inverseMod(a, m);
+			TEST_CHECK(BigInt::mod(BigInt::mul(inv, a), m).compare((sl_uint32)1) == 0);
+			out.add(inv.toHexString());
+		} else {
+			out.addStatic("-", 1);
+		}
+		out.addStatic("\n", 1);
+	}
+	TEST_CHECK_EQUAL(HashHex(out.merge()), "d17a62495ca020a50b31c1c112c25eebeb28090eaacd1b95fbd3db7ca40897fb");
+}
+
+// 2048-bit key generated by OpenSSL
+static const char* g_rsaP =
+	"dbfc4586d3009ed6d1dc59dc1aad950e565823d0cec1a3fbb97cfe6cce746a1712c77e507a018dc8ebb2feeb7fa1ebfabf0fbd03f53857dc9d4d9c05ff812726"
+	"282595dd6e1e027997174e93b9224e52724e30da651dbabb541de9c694a3993a411b753019b3a1c652015ac4c41be2c8c0bfdafaace15b641b0d729f286a068b"
+;
+
+static const char* g_rsaQ =
+	"baa9d8e2e585fbb53698d28cd53edaad59934ad78242b8651d3ffb2bba17e232139cc350fa041bbfa1fd00bbf20016bf7fb5e557f1371d83ab5aebbc2a17d5c9"
+	"26c80cc9c09ffc0393a8b23b381d2f9cf6500a649ed4eaea9bfad0f211d706f3314d7a09f78e04fb1fb004b4b16b414a0a4fcbc655da15cac07da165975a0b77"
+;
+
+// "SLIB RSA-OAEP interoperability test" encrypted by OpenSSL (OAEP, SHA-256)
+static const char* g_rsaOaepCipher =
+	"0f33dea54536ecce83561dab2035ca16d7584c80a0945eb1c9ae2973eeaaf198dd8667976ea6b452caec443d62c4e30996f85f2ae20b5f35b8552d22b536e323"
+	"c0bf89bb9d4bf0254f55ba7daa4402a0b81c181e954cad4dce6e2968a44904a25dc255bb3d64ad3d76fad62c48f4f42889782a886d13fba88f7308f68b6e9386"
+	"209da9f9bd8267cabd76791762c3e93da3d31ed66b16908a7fc6e5ca135aefbc173654e9eab65157e80088ab42b9d531f56e434a50fc85d033fd0475b21fc4aa"
+	"81552e7b1e04e4deedf416a9723f3c1e944bdbe11323b2f687d591f62a96a45d00a585f588d85f96f8fd16f5ecd3f5f6335e4c714e45f516088e7ad40b44c599"
+;
+
+// "SLIB RSA PKCS#1 v1.5 signature" encrypted by OpenSSL (PKCS#1 v1.5)
+static const char* g_rsaPkcs1Cipher =
+	"8e39f1282d7909636983d9f7ea64bb1157ffd40cd68a55fa9105a4f195eca7f69b8e1aaade475ed0361efc5450e0276a9222e51354e73952336bbf79684ad46b"
+	"7f9d3017b93516bba3195c8f0abc105260a745aa718081f24f134b144d7259007aadc77de9f33fe0595a483a3f648ddba102ae03af36ae8ebcc07ccd7e696a94"
+	"a22ed5fd852f3630f5323a713c2a4337833ce632b8430faac14327b08c7a5d53dacf7d3da382ce1f1ad838b31013a059d53567631e0ec86d238c0eb89f3e9e1f"
+	"1e0acbe86f2ad17b1f08dc245da865b89fc754de381a6f0bcc87246c91f0771c07ddbe813127d06b9d86fcb5a3f3ea4d2ad9671b894dc5f5dcfcf94448ca004d"
+;
+
+static void MakeKey(RSAPrivateKey& key)
+{
+	key.P = BigInt::fromHexString(g_rsaP);
+	key.Q = BigInt::fromHexString(g_rsaQ);
+	key.N = BigInt::mul(key.P, key.Q);
+	key.E = 65537;
+	BigInt P1 = BigInt::sub(key.P, (sl_uint32)1);
+	BigInt Q1 = BigInt::sub(key.Q, (sl_uint32)1);
+	key.D = BigInt::inverseMod(key.E, BigInt::mul(P1, Q1));
+	key.DP = BigInt::mod(key.D, P1);
+	key.DQ = BigInt::mod(key.D, Q1);
+	key.IQ = BigInt::inverseMod(key.Q, key.P);
+}
+
+static void TestRSA()
+{
+	RSAPrivateKey key;
+	MakeKey(key);
+	RSAPublicKey pub;
+	pub.N = key.N;
+	pub.E = key.E;
+	TEST_CHECK_EQUAL(key.getLength(), 256);
+
+	// raw operations: CRT and N/D only, against the plain modular exponentiation
+	sl_uint8 m[256], c[256], d1[256], d2[256];
+	BigInt M = BigInt::mod(MakeNumber(2047, 7), key.N);
+	M.getBytesBE(m, 256);
+	TEST_CHECK(RSA::executePublic(pub, m, c));
+	TEST_CHECK(BigInt::fromBytesBE(c, 256).compare(BigInt::pow_mod(M, key.E, key.N)) == 0);
+	TEST_CHECK(RSA::executePrivate(key, c, d1));
+	TEST_CHECK(Base::equalsMemory(m, d1, 256));
+	key.flagUseOnlyD = sl_true;
+	TEST_CHECK(RSA::executePrivate(key, c, d2));
+	TEST_CHECK(Base::equalsMemory(m, d2, 256));
+	key.flagUseOnlyD = sl_false;
+
+	// a new modulus must not reuse the cached Montgomery contexts
+	{
+		RSAPublicKey other;
+		other.N = key.N;
+		other.E = key.E;
+		TEST_CHECK(RSA::executePublic(other, m, d1));
+		other.N = BigInt::mul(key.Q, BigInt::fromHexString("F7"));
+		BigInt M2 = BigInt::mod(M, other.N);
+		sl_uint32 n2 = other.getLength();
+		sl_uint8 m2[256], c2[256];
+		M2.getBytesBE(m2, n2);
+		TEST_CHECK(RSA::executePublic(other, m2, c2));
+		TEST_CHECK(BigInt::fromBytesBE(c2, n2).compare(BigInt::pow_mod(M2, other.E, other.N)) == 0);
+	}
+
+	// decryption of the ciphertexts made by OpenSSL
+	Ref<CryptoHash> sha256 = CryptoHash::sha256();
+	sl_uint8 out[256];
+	Memory cipher = FromHex(g_rsaOaepCipher);
+	sl_uint32 n = RSA::decryptPrivate_oaep_v21(key, sha256, cipher.getData(), out, sizeof(out));
+	TEST_CHECK_EQUAL(String((char*)out, n), "SLIB RSA-OAEP interoperability test");
+	cipher = FromHex(g_rsaPkcs1Cipher);
+	n = RSA::decryptPrivate_pkcs1_v15(key, cipher.getData(), out, sizeof(out));
+	TEST_CHECK_EQUAL(String((char*)out, n), "SLIB RSA PKCS#1 v1.5 signature");
+
+	// signature padding is deterministic: the result of `openssl pkeyutl -sign`
+	const char* text = "SLIB RSA PKCS#1 v1.5 signature";
+	sl_uint32 lenText = (sl_uint32)(Base::getStringLength(text));
+	TEST_CHECK(RSA::encryptPrivate_pkcs1_v15(key, text, lenText, c));
+	sl_uint8 h[32];
+	SHA256::hash(c, 256, h);
+	TEST_CHECK_EQUAL(String::makeHexString(h, 32), "58b1f3691d5c68543696da8ca5aebce5b156490b1a60232ad1c25fb69f364581");
+	sl_bool flagSign = sl_false;
+	n = RSA::decryptPublic_pkcs1_v15(pub, c, out, sizeof(out), &flagSign);
+	TEST_CHECK(flagSign);
+	TEST_CHECK_EQUAL(String((char*)out, n), text);
+
+	// round trips of the random paddings
+	TEST_CHECK(RSA::encryptPublic_pkcs1_v15(pub, text, lenText, c));
+	n = RSA::decryptPrivate_pkcs1_v15(key, c, out, sizeof(out));
+	TEST_CHECK_EQUAL(String((char*)out, n), text);
+	TEST_CHECK(RSA::encryptPublic_oaep_v21(pub, sha256, text, lenText, c, "label", 5));
+	n = RSA::decryptPrivate_oaep_v21(key, sha256, c, out, sizeof(out), "label", 5);
+	TEST_CHECK_EQUAL(String((char*)out, n), text);
+	n = RSA::decryptPrivate_oaep_v21(key, sha256, c, out, sizeof(out), "lab3l", 5);
+	TEST_CHECK_EQUAL(n, 0);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestSmall();
+	TestArithmetic();
+	TestModular();
+	TestRSA();
+	return TestResult("BigInt");
+}
@@ -0,0 +1,198 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	CRC32, CRC32C and Adler-32 against zlib (Python) on the lengths around the SIMD block sizes,
+	chained `extend` calls, the Internet checksum against the scalar RFC 1071 sum, and XXH32/XXH64
+*/
+
+static Memory MakeData(sl_size size)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < size; i++) {
+		p[i] = (sl_uint8)(i * 7 + 3);
+	}
+	return mem;
+}
+
+static sl_size GetLength(sl_size index)
+{
+	static const sl_size extra[] = { 511, 512, 513, 1000, 1500, 4096, 4097, 65536, 100000 };
+	if (index < 300) {
+		return index;
+	}
+	return extra[index - 300];
+}
+
+template <class CHECKSUM>
+static void TestChecksum(const void* data, const char* hashLengths)
+{
+	// SHA-256 of the little-endian checksums of the lengths
+	MemoryBuffer buf;
+	for (sl_size i = 0; i < 309; i++) {
+		sl_size n = GetLength(i);
+		sl_uint32 value = CHECKSUM::get(data, n);
+		sl_uint8 bytes[4];
+		MIO::writeUint32LE(bytes, value);
+		buf.add(Memory::create(bytes, 4));
+		// chained in two pieces
+		sl_size k = n / 3;
+		sl_uint32 chained = CHECKSUM::extend(CHECKSUM::get(data, k), (const sl_uint8*)data + k, n - k);
+		TEST_CHECK_EQUAL(chained, value);
+	}
+	Memory all = buf.merge();
+	sl_uint8 h[32];
+	SHA256::hash(all.getData(), all.getSize(), h);
+	TEST_CHECK_EQUAL(String::makeHexString(h, 32), hashLengths);
+}
+
+static void TestCRC()
+{
+	Memory data = MakeData(100000);
+	TEST_CHECK_EQUAL(CRC32::get("123456789", 9), 0xCBF43926);
+	TEST_CHECK_EQUAL(CRC32C::get("123456789", 9), 0xE3069283);
+	TEST_CHECK_EQUAL(Adler32::get("Wikipedia", 9), 0x11E60398);
+	TestChecksum<CRC32>(data.getData(), "f1bc8a8a091f666a8901d39232db59d39aaaa42bd8717f554393a800954d27d2");
+	TestChecksum<CRC32C>(data.getData(), "089b7e2f5185f13d755f3f82c48f8795cb3ef475c4a76f12177fa6c35963a7fa");
+	TestChecksum<Adler32>(data.getData(), "85be80273d43a9393d6e408cacc1cb36fdcbe2433036d109cfdbc0ecb4635d00");
+
+	// maximum byte values for the overflow of the SIMD accumulators
+	Memory ones = Memory::create(1000000);
+	Base::resetMemory(ones.getData(), 0xFF, ones.getSize());
+	TEST_CHECK_EQUAL(Adler32::get(ones), 0x3843E1BE);
+	TEST_CHECK_EQUAL(CRC32::get(ones), 0x13FBDA0D);
+}
+
+static sl_uint16 GetOneComplementSum(const void* data, sl_size size, sl_uint32 add)
+{
+	sl_uint32 sum = add;
+	const sl_uint8* p = (const sl_uint8*)data;
+	while (size > 1) {
+		sum += ((sl_uint32)(p[0]) << 8) | p[1];
+		p += 2;
+		size -= 2;
+	}
+	if (size) {
+		sum += (sl_uint32)(p[0]) << 8;
+	}
+	while (sum >> 16) {
+		sum = (sum >> 16) + (sum & 0xffff);
+	}
+	return (sl_uint16)sum;
+}
+
+static sl_bool IsSameOneComplement(sl_uint16 a, sl_uint16 b)
+{
+	// 0x0000 and 0xFFFF are both zero
+	return a == b || ((a == 0 || a == 0xFFFF) && (b == 0 || b == 0xFFFF));
+}
+
+static void TestInternetChecksum()
+{
+	Memory mem = MakeData(70000);
+	sl_uint8* data = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < 309; i++) {
+		sl_size n = GetLength(i);
+		if (n > mem.getSize()) {
+			continue;
+		}
+		// unaligned start
+		for (sl_size offset = 0; offset < 2; offset++) {
+			if (n + offset > mem.getSize()) {
+				continue;
+			}
+			TEST_CHECK_EQUAL(TCP_IP::calculateOneComplementSum(data + offset, n, 0x1234), GetOneComplementSum(data + offset, n, 0x1234));
+		}
+	}
+	// incremental update (RFC 1624)
+	sl_uint8 packet[64];
+	Base::copyMemory(packet, data, 64);
+	sl_uint16 checksum = TCP_IP::calculateChecksum(packet, 64);
+	for (sl_uint32 i = 0; i < 32; i++) {
+		sl_uint16 oldValue = MIO::readUint16BE(packet + i * 2);
+		sl_uint16 newValue = (sl_uint16)(oldValue * 31 + i);
+		MIO::writeUint16BE(packet + i * 2, newValue);
+		checksum = TCP_IP::adjustChecksum(checksum, oldValue, newValue);
+		TEST_CHECK(IsSameOneComplement(checksum, TCP_IP::calculateChecksum(packet, 64)));
+	}
+	sl_uint8 old[8];
+	Base::copyMemory(old, packet + 12, 8);
+	for (sl_uint32 i = 0; i < 8; i++) {
+		packet[12 + i] ^= (sl_uint8)(0x5A + i);
+	}
+	checksum = TCP_IP::adjustChecksum(checksum, old, packet + 12, 8);
+	TEST_CHECK(IsSameOneComplement(checksum, TCP_IP::calculateChecksum(packet, 64)));
+}
+
+static void TestXXHash()
+{
+	TEST_CHECK_EQUAL(XXHash32::get("", 0), 0x02cc5d05);
+	TEST_CHECK_EQUAL(XXHash32::get("abc", 3), 0x32d153ff);
+	TEST_CHECK_EQUAL(XXHash64::get("", 0), SLIB_UINT64(0xef46db3751d8e999));
+	TEST_CHECK_EQUAL(XXHash64::get("abc", 3), SLIB_UINT64(0x44bc2cf5ad770999));
+
+	// SHA-256 of the hashes (with and without seed) of the lengths 0 ~ 300, in hex lines
+	Memory data = MakeData(300);
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	StringBuffer sb;
+	for (sl_size n = 0; n <= 300; n++) {
+		sl_uint32 h32 = XXHash32::get(p, n);
+		sl_uint32 h32s = XXHash32::get(p, n, 0x9E3779B1);
+		sl_uint64 h64 = XXHash64::get(p, n);
+		sl_uint64 h64s = XXHash64::get(p, n, SLIB_UINT64(0x9E3779B97F4A7C15));
+		sb.add(String::format("%08x %08x %016x %016x\n", h32, h32s, h64, h64s));
+
+		// incremental updates in uneven pieces
+		XXHash32 hash32;
+		XXHash64 hash64;
+		hash32.start();
+		hash64.start();
+		sl_size pos = 0;
+		sl_size piece = 1;
+		while (pos < n) {
+			sl_size m = Math::min(piece, n - pos);
+			hash32.update(p + pos, m);
+			hash64.update(p + pos, m);
+			pos += m;
+			piece = piece * 3 + 1;
+		}
+		TEST_CHECK_EQUAL(hash32.finish(), h32);
+		TEST_CHECK_EQUAL(hash64.finish(), h64);
+	}
+	String str = sb.merge();
+	sl_uint8 h[32];
+	SHA256::hash(str.getData(), str.getLength(), h);
+	TEST_CHECK_EQUAL(String::makeHexString(h, 32), "035db13ce864589fb21606db79753eaf435265dc3a22c9859527875e7fdd2ea1");
+}
+
+int main(int argc, const char * argv[])
+{
+	TestCRC();
+	TestInternetChecksum();
+	TestXXHash();
+	return TestResult("Checksum");
+}
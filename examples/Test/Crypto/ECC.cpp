@@ -0,0 +1,166 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Ed25519 against the RFC 8032 vectors and the signatures of Node.js (OpenSSL) for the message
+	lengths 0 ~ 200, which cover the SHA-512 padding boundary of R || A || M at 48 ~ 55 bytes,
+	and ECDSA P-256 against the RFC 6979 vector and the signatures of Node.js
+*/
+
+static Memory FromHex(const char* hex)
+{
+	String str(hex);
+	Memory mem = Memory::create(str.getLength() / 2);
+	if (mem.isNotNull()) {
+		str.parseHexString(mem.getData());
+	}
+	return mem;
+}
+
+static String ToHex(const void* data, sl_size size)
+{
+	return String::makeHexString(data, size);
+}
+
+static Memory MakeData(sl_size size, sl_size offset = 0)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < size; i++) {
+		p[i] = (sl_uint8)((i + offset) * 7 + 3);
+	}
+	return mem;
+}
+
+static void TestEd25519Vector(const char* hexPrivate, const char* hexPublic, const char* hexMessage, const char* hexSignature)
+{
+	Memory priv = FromHex(hexPrivate);
+	Memory msg = FromHex(hexMessage);
+	sl_uint8 pub[32], sig[64];
+	Ed25519::getPublicKey(priv.getData(), pub);
+	TEST_CHECK_EQUAL(ToHex(pub, 32), hexPublic);
+	Ed25519::sign(priv.getData(), sl_null, msg.getData(), msg.getSize(), sig);
+	TEST_CHECK_EQUAL(ToHex(sig, 64), hexSignature);
+	TEST_CHECK(Ed25519::verify(pub, msg.getData(), msg.getSize(), sig));
+	sig[10] ^= 1;
+	TEST_CHECK(!(Ed25519::verify(pub, msg.getData(), msg.getSize(), sig)));
+}
+
+static void TestEd25519()
+{
+	// RFC 8032, 7.1 TEST 1 and TEST 3
+	TestEd25519Vector(
+		"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+		"d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+		"",
+		"e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b");
+	TestEd25519Vector(
+		"c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+		"fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+		"af82",
+		"6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a");
+
+	static const char* signatures48[] = {
+		"dc2b7474b2c3f23cf2c19f7abf217e4855b100252472e5277e0b1eca9bbde24fe1f0d7730ff97fac5e91e842343d94cbf89eec803e8f97ca37615fc0cf34cd04",
+		"da375145454cdb6661d59e330b91d864bb79c4b11387430a15c5c5d55e8fb74d081a705691feb1cf2137ec46d3ed937eed2925d5ba49a2847e30d9d3d2d33d06",
+		"f568024ff81b72f470045f576c6f242c59520cf2484fcbf0a43c0a787f754bf7cb2933d7850b3a36628f2051df874a1df3dfefd776622943c1a87b6031885e06",
+		"28def1a454020507de01193767b278cd3ba751571c903fc830c29318670ab2c154b0d35b81fe1b0d8216a08d51b22dd618a51e439b99f7068ee618d1cde78100",
+		"cbef7efebda3e2d5af5403fd99e0cc3cf0a8f1349c279e6c9b09cb5d9b478e02007bf72afe5ade6d985fbafdfb88959620e7d97ec850482344cdc9243b045c0b",
+		"a6cf016d8b3278bff98c6e95849be1aad51a12ab097b0c7d87412d283532210577bcbe8b85eb1957e69e078f65652577f9836da51b5d76a10e0026b3c8f77a02",
+		"33b01aaf200e42fb9af8cf783c9f90c33360162d3631881c4449b646bac66a7babe456c793d913f0a788084d54a5f27c69b926e6dd78b64d2fad022f91be5407",
+		"231f3458976fadc3d78241fcbd7ce93c928d09ef261c4eb46eb5c58fecf2dc8965e91a96fefd9eec839f0eda501197b6361f04c20866f3cb77d8c339d574ad06"
+	};
+
+	Memory priv = MakeData(32, 1000);
+	sl_uint8 pub[32];
+	Ed25519::getPublicKey(priv.getData(), pub);
+	TEST_CHECK_EQUAL(ToHex(pub, 32), "d328987a90e052beed064ce067b53dced7a6c9f2f03364d97492175c2eaff447");
+	Memory data = MakeData(200);
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	MemoryBuffer buf;
+	for (sl_size n = 0; n <= 200; n++) {
+		sl_uint8 sig[64];
+		Ed25519::sign(priv.getData(), pub, p, n, sig);
+		buf.add(Memory::create(sig, 64));
+		if (n >= 48 && n <= 55) {
+			TEST_CHECK_EQUAL(ToHex(sig, 64), signatures48[n - 48]);
+		}
+		TEST_CHECK(Ed25519::verify(pub, p, n, sig));
+		if (n) {
+			TEST_CHECK(!(Ed25519::verify(pub, p, n - 1, sig)));
+		}
+	}
+	// SHA-256 of the concatenated signatures of the lengths 0 ~ 200
+	Memory all = buf.merge();
+	sl_uint8 h[32];
+	SHA256::hash(all.getData(), all.getSize(), h);
+	TEST_CHECK_EQUAL(ToHex(h, 32), "4d244d222ac9bf77455eda2ee8683a04c445b3aef123714507812c5e6ccc45a7");
+}
+
+static void TestECDSA()
+{
+	// RFC 6979, A.2.5 (P-256, SHA-256, "sample")
+	{
+		Memory priv = FromHex("c9afa9d845ba75166b5c215767b1d6934e50c3db36e89b127b8a622b120f6721");
+		sl_uint8 pub[64], sig[64];
+		TEST_CHECK(ECDSA_P256::getPublicKey(priv.getData(), pub));
+		TEST_CHECK_EQUAL(ToHex(pub, 64), "60fed4ba255a9d31c961eb74c6356d68c049b8923b61fa6ce669622e60f29fb67903fe1008b8bc99a41ae9e95628bc64f2f1b20c2d7e9f5177a3c294d4462299");
+		TEST_CHECK(ECDSA_P256::signMessage(priv.getData(), "sample", 6, sig));
+		TEST_CHECK_EQUAL(ToHex(sig, 64), "efd48b2aacb6a8fd1140dd9cd45e81d69d2c877b56aaf991c34d0ea84eaf3716f7cb1c942d657c41d436c7a1b6e29f65f3e900dbb9aff4064dc4ab2f843acda8");
+		TEST_CHECK(ECDSA_P256::verifyMessage(pub, "sample", 6, sig));
+		TEST_CHECK(!(ECDSA_P256::verifyMessage(pub, "samplf", 6, sig)));
+	}
+	// signatures of Node.js (random nonces)
+	{
+		static const sl_size lengths[] = { 0, 55, 200 };
+		static const char* signatures[] = {
+			"fe18f48f36eb81de96b0d4a4c6368185b6f7e302bdadfd7892d389eb2e2cba2dd49f219ae3c735256385948a225edb53c80cc1c41ba8fc26b12f2a20d75a215b",
+			"f7a10a32e8e5e3dae9fadc7dcb5ec5d6bf250b301ac52f65eaee54ad37367ee581c5587c479ab6352d686a4dc54ebdeb4b54dbea8cf2a86692fffe88395e13b2",
+			"9a9cbc14bc4a9ac7b9f6c203a586d24082e169e652a978f0ad89e696b84142736f56ce7c1e07e0d1ef0af8ef0c0d90ebbf68cc8ab825afb6dcf7501d49b9a1ef"
+		};
+		Memory priv = MakeData(32, 2000);
+		sl_uint8 pub[64];
+		TEST_CHECK(ECDSA_P256::getPublicKey(priv.getData(), pub));
+		TEST_CHECK_EQUAL(ToHex(pub, 64), "f6af141a4410f667a4b418f508ae21cad4c4148547fad2cb98bb417f20b2ad1ef3083cbaead70eee8be710ee26c1505eb86d53046d8273422de20cd33d3c80a2");
+		Memory data = MakeData(200);
+		for (sl_uint32 i = 0; i < CountOfArray(lengths); i++) {
+			Memory sig = FromHex(signatures[i]);
+			TEST_CHECK(ECDSA_P256::verifyMessage(pub, data.getData(), lengths[i], sig.getData()));
+			sl_uint8 sig2[64];
+			TEST_CHECK(ECDSA_P256::signMessage(priv.getData(), data.getData(), lengths[i], sig2));
+			TEST_CHECK(ECDSA_P256::verifyMessage(pub, data.getData(), lengths[i], sig2));
+			sig2[40] ^= 0x80;
+			TEST_CHECK(!(ECDSA_P256::verifyMessage(pub, data.getData(), lengths[i], sig2)));
+		}
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	TestEd25519();
+	TestECDSA();
+	return TestResult("ECC");
+}
@@ -0,0 +1,369 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	AES_GCM_StreamFilter over an in-memory stream which completes the requests asynchronously (`pump()`):
+	round-trips between the roles, and the tampered, reordered, truncated, extended and reflected streams
+*/
+
+class MemoryPipe : public AsyncStream
+{
+public:
+	Memory input;
+	sl_size posInput;
+	sl_uint32 sizeReadMax;
+	MemoryBuffer output;
+	LinkedQueue< Ref<AsyncStreamRequest> > requests;
+	sl_bool flagOpened;
+
+public:
+	MemoryPipe(): posInput(0), sizeReadMax(0x7fffffff), flagOpened(sl_true) {}
+
+public:
+	void close() override
+	{
+		flagOpened = sl_false;
+	}
+
+	sl_bool isOpened() override
+	{
+		return flagOpened;
+	}
+
+	sl_bool read(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject) override
+	{
+		return requests.push(AsyncStreamRequest::createRead(data, size, userObject, callback));
+	}
+
+	sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject) override
+	{
+		return requests.push(AsyncStreamRequest::createWrite(data, size, userObject, callback));
+	}
+
+	sl_bool addTask(const Function<void()>& callback) override
+	{
+		callback();
+		return sl_true;
+	}
+
+	// completes a pending request, returns `sl_false` if there is none
+	sl_bool pump()
+	{
+		Ref<AsyncStreamRequest> request;
+		if (!(requests.pop(&request))) {
+			return sl_false;
+		}
+		if (request->flagRead) {
+			if (!(request->data) || !(request->size)) {
+				request->runCallback(this, 0, sl_false);
+				return sl_true;
+			}
+			sl_size n = input.getSize() - posInput;
+			if (!n) {
+				// end of the stream
+				request->runCallback(this, 0, sl_true);
+				return sl_true;
+			}
+			if (n > request->size) {
+				n = request->size;
+			}
+			if (n > sizeReadMax) {
+				n = sizeReadMax;
+			}
+			Base::copyMemory(request->data, (sl_uint8*)(input.getData()) + posInput, n);
+			posInput += n;
+			request->runCallback(this, (sl_uint32)n, sl_false);
+		} else {
+			output.add(Memory::create(request->data, request->size));
+			request->runCallback(this, request->size, sl_false);
+		}
+		return sl_true;
+	}
+
+	void pumpAll()
+	{
+		while (pump());
+	}
+
+};
+
+static Memory MakeData(sl_size size, sl_uint32 seed)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < size; i++) {
+		p[i] = (sl_uint8)(i * 7 + seed);
+	}
+	return mem;
+}
+
+static const sl_uint8 g_key[32] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static Ref<AES_GCM_StreamFilter> CreateFilter(const Ref<MemoryPipe>& pipe, sl_uint32 lenKey, sl_bool flagServer, const String& password)
+{
+	if (password.isNotNull()) {
+		return AES_GCM_StreamFilter::create(pipe, password, flagServer);
+	} else {
+		return AES_GCM_StreamFilter::create(pipe, g_key, lenKey, flagServer);
+	}
+}
+
+// writes `chunks` and the final frame (`flagFinish`), returns the encrypted stream
+static Memory Encrypt(const List<Memory>& chunks, sl_bool flagFinish, sl_bool flagServer = sl_false, sl_uint32 lenKey = 32, const String& password = sl_null)
+{
+	Ref<MemoryPipe> pipe = new MemoryPipe;
+	Ref<AES_GCM_StreamFilter> filter = CreateFilter(pipe, lenKey, flagServer, password);
+	TEST_CHECK(filter.isNotNull());
+	if (filter.isNull()) {
+		return sl_null;
+	}
+	sl_size sizeTotal = 0;
+	sl_size sizeWritten = 0;
+	sl_bool flagError = sl_false;
+	auto callback = [&sizeWritten, &flagError](AsyncStreamResult* result) {
+		sizeWritten += result->size;
+		if (result->flagError) {
+			flagError = sl_true;
+		}
+	};
+	ListElements<Memory> items(chunks);
+	for (sl_size i = 0; i < items.count; i++) {
+		TEST_CHECK(filter->write(items[i].getData(), (sl_uint32)(items[i].getSize()), callback));
+		sizeTotal += items[i].getSize();
+		if (i & 1) {
+			pipe->pumpAll();
+		}
+	}
+	if (flagFinish) {
+		TEST_CHECK(filter->finishWriting(callback));
+		// nothing can be written after the final frame
+		TEST_CHECK(!(filter->write("x", 1, callback)));
+		TEST_CHECK(!(filter->finishWriting(callback)));
+	}
+	pipe->pumpAll();
+	TEST_CHECK(!flagError);
+	TEST_CHECK_EQUAL(sizeWritten, sizeTotal);
+	return pipe->output.merge();
+}
+
+struct DecryptResult
+{
+	Memory data;
+	sl_bool flagFinished;
+	sl_bool flagError;
+};
+
+static DecryptResult Decrypt(const Memory& input, sl_uint32 sizeReadMax, sl_bool flagServer = sl_true, sl_uint32 lenKey = 32, const String& password = sl_null)
+{
+	DecryptResult ret;
+	ret.flagFinished = sl_false;
+	ret.flagError = sl_true;
+	Ref<MemoryPipe> pipe = new MemoryPipe;
+	pipe->input = input;
+	pipe->sizeReadMax = sizeReadMax;
+	Ref<AES_GCM_StreamFilter> filter = CreateFilter(pipe, lenKey, flagServer, password);
+	TEST_CHECK(filter.isNotNull());
+	if (filter.isNull()) {
+		return ret;
+	}
+	MemoryBuffer buf;
+	char bufRead[5000];
+	sl_bool flagEnded = sl_false;
+	Function<void(AsyncStreamResult*)> callback;
+	callback = [&](AsyncStreamResult* result) {
+		if (result->size) {
+			buf.add(Memory::create(result->data, result->size));
+		}
+		if (result->flagError) {
+			flagEnded = sl_true;
+			return;
+		}
+		if (!(filter->read(bufRead, sizeof(bufRead), callback))) {
+			flagEnded = sl_true;
+		}
+	};
+	if (!(filter->read(bufRead, sizeof(bufRead), callback))) {
+		flagEnded = sl_true;
+	}
+	pipe->pumpAll();
+	TEST_CHECK(flagEnded);
+	ret.data = buf.merge();
+	ret.flagFinished = filter->isReadingFinished();
+	ret.flagError = filter->isReadingError();
+	callback.setNull();
+	return ret;
+}
+
+static sl_bool IsEqual(const Memory& m1, const Memory& m2)
+{
+	return m1.getSize() == m2.getSize() && Base::equalsMemory(m1.getData(), m2.getData(), m1.getSize());
+}
+
+static Memory Concat(const List<Memory>& chunks)
+{
+	MemoryBuffer buf;
+	ListElements<Memory> items(chunks);
+	for (sl_size i = 0; i < items.count; i++) {
+		buf.add(items[i]);
+	}
+	return buf.merge();
+}
+
+static void TestRoundTrip()
+{
+	List<Memory> chunks;
+	chunks.add(Memory::create("Hello", 5));
+	chunks.add(MakeData(200000, 1));
+	chunks.add(MakeData(5000, 2));
+	chunks.add(MakeData(1, 3));
+	Memory plain = Concat(chunks);
+	static const sl_uint32 lenKeys[] = { 16, 24, 32 };
+	for (sl_uint32 i = 0; i < CountOfArray(lenKeys); i++) {
+		// client to server
+		Memory cipher = Encrypt(chunks, sl_true, sl_false, lenKeys[i]);
+		static const sl_uint32 sizesRead[] = { 0x7fffffff, 777, 13 };
+		for (sl_uint32 k = 0; k < CountOfArray(sizesRead); k++) {
+			DecryptResult result = Decrypt(cipher, sizesRead[k], sl_true, lenKeys[i]);
+			TEST_CHECK(IsEqual(result.data, plain));
+			TEST_CHECK(result.flagFinished);
+			TEST_CHECK(!(result.flagError));
+		}
+		// server to client
+		cipher = Encrypt(chunks, sl_true, sl_true, lenKeys[i]);
+		DecryptResult result = Decrypt(cipher, 1000, sl_false, lenKeys[i]);
+		TEST_CHECK(IsEqual(result.data, plain));
+		TEST_CHECK(result.flagFinished);
+		TEST_CHECK(!(result.flagError));
+	}
+	// empty stream with the final frame only
+	Memory cipher = Encrypt(List<Memory>(), sl_true);
+	TEST_CHECK_EQUAL(cipher.getSize(), 36);
+	DecryptResult result = Decrypt(cipher, 5);
+	TEST_CHECK_EQUAL(result.data.getSize(), 0);
+	TEST_CHECK(result.flagFinished);
+	TEST_CHECK(!(result.flagError));
+	// the random salts make the streams different
+	TEST_CHECK(!(IsEqual(Encrypt(chunks, sl_true), Encrypt(chunks, sl_true))));
+}
+
+static void TestPassword()
+{
+	List<Memory> chunks;
+	chunks.add(MakeData(3000, 5));
+	Memory cipher = Encrypt(chunks, sl_true, sl_false, 0, "secret");
+	DecryptResult result = Decrypt(cipher, 100, sl_true, 0, "secret");
+	TEST_CHECK(IsEqual(result.data, chunks.getValueAt(0)));
+	TEST_CHECK(result.flagFinished);
+	TEST_CHECK(!(result.flagError));
+	result = Decrypt(cipher, 100, sl_true, 0, "Secret");
+	TEST_CHECK_EQUAL(result.data.getSize(), 0);
+	TEST_CHECK(result.flagError);
+}
+
+static void TestAttacks()
+{
+	// frames of 10 bytes: 16 bytes (salt) + 30 bytes * 4 + 20 bytes (final frame)
+	List<Memory> chunks;
+	for (sl_uint32 i = 0; i < 4; i++) {
+		chunks.add(MakeData(10, i));
+	}
+	Memory plain = Concat(chunks);
+	Memory cipher = Encrypt(chunks, sl_true);
+	TEST_CHECK_EQUAL(cipher.getSize(), 156);
+	if (cipher.getSize() != 156) {
+		return;
+	}
+	DecryptResult result = Decrypt(cipher, 1000);
+	TEST_CHECK(IsEqual(result.data, plain));
+	TEST_CHECK(result.flagFinished);
+	TEST_CHECK(!(result.flagError));
+
+	// reflected to the writer
+	result = Decrypt(cipher, 1000, sl_false);
+	TEST_CHECK_EQUAL(result.data.getSize(), 0);
+	TEST_CHECK(result.flagError);
+
+	// wrong key
+	result = Decrypt(cipher, 1000, sl_true, 16);
+	TEST_CHECK_EQUAL(result.data.getSize(), 0);
+	TEST_CHECK(result.flagError);
+
+	// tampered ciphertext of the third frame
+	Memory tampered = cipher.duplicate();
+	((sl_uint8*)(tampered.getData()))[16 + 60 + 8] ^= 1;
+	result = Decrypt(tampered, 1000);
+	TEST_CHECK(IsEqual(result.data, plain.sub(0, 20)));
+	TEST_CHECK(!(result.flagFinished));
+	TEST_CHECK(result.flagError);
+
+	// final flag set on the second frame
+	tampered = cipher.duplicate();
+	((sl_uint8*)(tampered.getData()))[16 + 30] |= 0x80;
+	result = Decrypt(tampered, 1000);
+	TEST_CHECK(IsEqual(result.data, plain.sub(0, 10)));
+	TEST_CHECK(!(result.flagFinished));
+	TEST_CHECK(result.flagError);
+
+	// reordered frames
+	Memory reordered = cipher.duplicate();
+	Base::copyMemory((sl_uint8*)(reordered.getData()) + 16 + 30, (sl_uint8*)(cipher.getData()) + 16 + 60, 30);
+	Base::copyMemory((sl_uint8*)(reordered.getData()) + 16 + 60, (sl_uint8*)(cipher.getData()) + 16 + 30, 30);
+	result = Decrypt(reordered, 1000);
+	TEST_CHECK(IsEqual(result.data, plain.sub(0, 10)));
+	TEST_CHECK(!(result.flagFinished));
+	TEST_CHECK(result.flagError);
+
+	// truncated on the frame boundary (without the final frame)
+	result = Decrypt(cipher.sub(0, 136), 1000);
+	TEST_CHECK(IsEqual(result.data, plain));
+	TEST_CHECK(!(result.flagFinished));
+	TEST_CHECK(result.flagError);
+
+	// not finished by the writer
+	result = Decrypt(Encrypt(chunks, sl_false), 1000);
+	TEST_CHECK(IsEqual(result.data, plain));
+	TEST_CHECK(!(result.flagFinished));
+	TEST_CHECK(result.flagError);
+
+	// data after the final frame
+	MemoryBuffer buf;
+	buf.add(cipher);
+	buf.add(cipher.sub(16, 30));
+	result = Decrypt(buf.merge(), 1000);
+	TEST_CHECK(IsEqual(result.data, plain));
+	TEST_CHECK(result.flagError);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestRoundTrip();
+	TestPassword();
+	TestAttacks();
+	return TestResult("GCMStream");
+}
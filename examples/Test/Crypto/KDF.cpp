@@ -0,0 +1,148 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	HMAC, HKDF and PBKDF2 against the standard test vectors (RFC 4231, RFC 5869, RFC 6070)
+	and the results of Python's hashlib on the longer outputs
+*/
+
+static Memory FromHex(const char* hex)
+{
+	String str(hex);
+	Memory mem = Memory::create(str.getLength() / 2);
+	if (mem.isNotNull()) {
+		str.parseHexString(mem.getData());
+	}
+	return mem;
+}
+
+static String ToHex(const void* data, sl_size size)
+{
+	return String::makeHexString(data, size);
+}
+
+static void TestHMAC()
+{
+	// RFC 4231, test case 2
+	const char* key = "Jefe";
+	const char* message = "what do ya want for nothing?";
+	const char* expected = "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843";
+	sl_uint8 output[32];
+	HMAC<SHA256>::execute(key, 4, message, 28, output);
+	TEST_CHECK_EQUAL(ToHex(output, 32), expected);
+
+	// incremental
+	HMAC<SHA256> mac;
+	mac.setKey(key, 4);
+	for (sl_uint32 i = 0; i < 2; i++) {
+		mac.start();
+		mac.update(message, 10);
+		mac.update(message + 10, 18);
+		mac.finish(output);
+		TEST_CHECK_EQUAL(ToHex(output, 32), expected);
+	}
+}
+
+static void TestHKDF()
+{
+	struct Vector
+	{
+		const char* ikm;
+		const char* salt;
+		const char* info;
+		sl_uint32 len;
+		const char* okm;
+	} vectors[] = {
+		// RFC 5869, test cases 1~3
+		{
+			"0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+			"000102030405060708090a0b0c",
+			"f0f1f2f3f4f5f6f7f8f9",
+			42,
+			"3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865"
+		},
+		{
+			"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f",
+			"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+			"b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+			82,
+			"b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c59045a99cac7827271cb41c65e590e09da3275600c2f09b8367793a9aca3db71cc30c58179ec3e87c14c01d5c1f3434f1d87"
+		},
+		{
+			"0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+			"",
+			"",
+			42,
+			"8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8"
+		}
+	};
+	for (sl_size i = 0; i < CountOfArray(vectors); i++) {
+		Memory ikm = FromHex(vectors[i].ikm);
+		Memory salt = FromHex(vectors[i].salt);
+		Memory info = FromHex(vectors[i].info);
+		sl_uint8 okm[128];
+		HKDF<SHA256>::execute(salt.getData(), salt.getSize(), ikm.getData(), ikm.getSize(), info.getData(), info.getSize(), okm, vectors[i].len);
+		TEST_CHECK_EQUAL(ToHex(okm, vectors[i].len), vectors[i].okm);
+	}
+}
+
+static void TestPBKDF2()
+{
+	struct Vector
+	{
+		const char* password;
+		const char* salt;
+		sl_uint32 nIterations;
+		sl_uint32 len;
+		const char* output;
+	} vectors[] = {
+		{ "password", "salt", 1, 32, "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b" },
+		{ "password", "salt", 2, 32, "ae4d0c95af6b46d32d0adff928f06dd02a303f8ef3c251dfd6e2d85a95474c43" },
+		{ "password", "salt", 4096, 32, "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a" },
+		{ "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 40, "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9" },
+		// the password longer than the block is hashed
+		{ "kkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkk", "salt", 3, 70, "219c68bb88f1010f4a763b7c8fd58639c2280baf6820814c6d404891fcd85c3d19af9f11e8544f706d60a2c0a33eeca0b531a9b66b76636312434826f41291ebd47e61ed1d58" }
+	};
+	for (sl_size i = 0; i < CountOfArray(vectors); i++) {
+		StringView password = vectors[i].password;
+		StringView salt = vectors[i].salt;
+		sl_uint8 output[128];
+		PBKDF2_HMAC<SHA256>::execute(password.getData(), password.getLength(), salt.getData(), salt.getLength(), vectors[i].nIterations, output, vectors[i].len);
+		TEST_CHECK_EQUAL(ToHex(output, vectors[i].len), vectors[i].output);
+	}
+	// RFC 6070, PBKDF2-HMAC-SHA1
+	sl_uint8 output[20];
+	PBKDF2_HMAC<SHA1>::execute("password", 8, "salt", 4, 4096, output, 20);
+	TEST_CHECK_EQUAL(ToHex(output, 20), "4b007901b765489abead49d926f721d065a429c1");
+}
+
+int main(int argc, const char * argv[])
+{
+	TestHMAC();
+	TestHKDF();
+	TestPBKDF2();
+	return TestResult("KDF");
+}
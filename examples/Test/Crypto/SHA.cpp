@@ -0,0 +1,129 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	SHA-1/SHA-2 family against the FIPS 180 examples and OpenSSL results for the lengths
+	around the block and padding boundaries, incremental updates, and SHA-256 batch hashing
+*/
+
+static Memory MakeData(sl_size size)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < size; i++) {
+		p[i] = (sl_uint8)(i * 7 + 3);
+	}
+	return mem;
+}
+
+template <class HASH>
+static String HashHex(const void* data, sl_size size)
+{
+	sl_uint8 h[HASH::HashSize];
+	HASH::hash(data, size, h);
+	return String::makeHexString(h, HASH::HashSize);
+}
+
+template <class HASH>
+static void TestHash(const char* hashAbc, const char* hashMillion, const char* hashLengths)
+{
+	TEST_CHECK_EQUAL(HashHex<HASH>("abc", 3), hashAbc);
+	String million('a', 1000000);
+	TEST_CHECK_EQUAL(HashHex<HASH>(million.getData(), million.getLength()), hashMillion);
+
+	// SHA-256 of the concatenated hashes of the lengths 0 ~ 299
+	Memory data = MakeData(300);
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	MemoryBuffer buf;
+	for (sl_size n = 0; n < 300; n++) {
+		sl_uint8 h[HASH::HashSize];
+		HASH::hash(p, n, h);
+		buf.add(Memory::create(h, HASH::HashSize));
+
+		// incremental updates in uneven pieces
+		HASH hash;
+		hash.start();
+		sl_size pos = 0;
+		sl_size piece = 1;
+		while (pos < n) {
+			sl_size m = Math::min(piece, n - pos);
+			hash.update(p + pos, m);
+			pos += m;
+			piece = piece * 3 + 1;
+		}
+		sl_uint8 h2[HASH::HashSize];
+		hash.finish(h2);
+		TEST_CHECK(Base::equalsMemory(h, h2, HASH::HashSize));
+	}
+	Memory all = buf.merge();
+	TEST_CHECK_EQUAL(HashHex<SHA256>(all.getData(), all.getSize()), hashLengths);
+}
+
+static void TestBatch()
+{
+	Memory data = MakeData(5000);
+	const sl_uint8* p = (const sl_uint8*)(data.getData());
+	Memory prefix = MakeData(128);
+	const sl_uint32 nCount = 19;
+	const void* inputs[nCount];
+	sl_size sizes[nCount];
+	sl_uint8 outputs[nCount][32];
+	void* pOutputs[nCount];
+	for (sl_uint32 i = 0; i < nCount; i++) {
+		inputs[i] = p + i * 3;
+		sizes[i] = (i * 277) % 1000;
+		pOutputs[i] = outputs[i];
+	}
+	for (sl_uint32 k = 0; k < 2; k++) {
+		if (k) {
+			SHA256::hashBatch(inputs, sizes, pOutputs, nCount, prefix.getData(), prefix.getSize());
+		} else {
+			SHA256::hashBatch(inputs, sizes, pOutputs, nCount);
+		}
+		for (sl_uint32 i = 0; i < nCount; i++) {
+			SHA256 hash;
+			hash.start();
+			if (k) {
+				hash.update(prefix.getData(), prefix.getSize());
+			}
+			hash.update(inputs[i], sizes[i]);
+			sl_uint8 h[32];
+			hash.finish(h);
+			TEST_CHECK(Base::equalsMemory(h, outputs[i], 32));
+		}
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	TestHash<SHA1>("a9993e364706816aba3e25717850c26c9cd0d89d", "34aa973cd4c4daa4f61eeb2bdbad27316534016f", "0da79a84a04dd3d58943db9075ffb578b9c9e0758c837bb7edf2fe6946907dc8");
+	TestHash<SHA224>("23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7", "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67", "165cef058cb7ba1011c3c322922ebd330e6005311cd84ff034930545a2d926fc");
+	TestHash<SHA256>("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", "7b074096cabb18dd0d1b468a173cb2f97f80e952525bca29542e606fd6d0753a");
+	TestHash<SHA384>("cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7", "9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b07b8b3dc38ecc4ebae97ddd87f3d8985", "0d865f7fe4b437472808551a29954f6d3ff6752b50c62e8905048b0f289ae391");
+	TestHash<SHA512>("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f", "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b", "b649c4e6577be3c259289c2fd6b50826e79fce7f8ca8e0f5080b42ace0aafb64");
+	TestBatch();
+	return TestResult("SHA");
+}
@@ -0,0 +1,220 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Asynchronous calls of the database on an in-memory SQLite connection: results and errors, order and thread of
+	the callbacks, the queue limit and counters, and the queued calls keeping the database alive
+*/
+
+static sl_bool WaitFor(volatile sl_int32& count, sl_int32 n)
+{
+	for (sl_uint32 i = 0; i < 20000; i++) {
+		if (count >= n) {
+			return sl_true;
+		}
+		Thread::sleep(1);
+	}
+	return sl_false;
+}
+
+static sl_bool WaitForCompleted(Database* db, sl_uint64 n)
+{
+	for (sl_uint32 i = 0; i < 20000; i++) {
+		if (db->getAsyncCompletedCount() >= n && !(db->getAsyncQueueLength())) {
+			return sl_true;
+		}
+		Thread::sleep(1);
+	}
+	return sl_false;
+}
+
+static void TestResults(Database* db)
+{
+	volatile sl_int32 nCallbacks = 0;
+	sl_int32 nOrdered = 0;
+	sl_bool flagMainThread = sl_false;
+	Ref<Thread> threadMain = Thread::getCurrent();
+	TEST_CHECK(db->executeAsync("CREATE TABLE t (a INTEGER, b TEXT)", [&](DatabaseAsyncResult& result) {
+		TEST_CHECK(!(result.flagError));
+		if (Thread::getCurrent() == threadMain) {
+			flagMainThread = sl_true;
+		}
+		nCallbacks++;
+	}));
+	for (sl_int32 i = 0; i < 100; i++) {
+		TEST_CHECK(db->executeAsync("INSERT INTO t (a, b) VALUES (?, ?)", [&, i](DatabaseAsyncResult& result) {
+			TEST_CHECK(!(result.flagError));
+			TEST_CHECK_EQUAL(result.affectedRowsCount, 1);
+			// callbacks are called in the order of the calls
+			if (nOrdered == i) {
+				nOrdered++;
+			}
+			nCallbacks++;
+		}, i, String::fromInt32(i)));
+	}
+	List< HashMap<String, Variant> > rows;
+	TEST_CHECK(db->queryAsync("SELECT a, b FROM t WHERE a >= ? ORDER BY a", [&](DatabaseAsyncResult& result) {
+		TEST_CHECK(!(result.flagError));
+		rows = result.rows;
+		nCallbacks++;
+	}, 90));
+	TEST_CHECK(WaitFor(nCallbacks, 102));
+	TEST_CHECK(!flagMainThread);
+	TEST_CHECK_EQUAL(nOrdered, 100);
+	TEST_CHECK_EQUAL(rows.getCount(), 10);
+	if (rows.getCount() == 10) {
+		TEST_CHECK_EQUAL(rows.getValueAt(0).getValue("a").getInt32(), 90);
+		TEST_CHECK_EQUAL(rows.getValueAt(9).getValue("b").getString(), "99");
+	}
+
+	// errors
+	db->setLoggingErrors(sl_false);
+	nCallbacks = 0;
+	sl_bool flagError1 = sl_false, flagError2 = sl_false;
+	String message;
+	TEST_CHECK(db->executeAsync("INSERT INTO no_such_table (a) VALUES (1)", [&](DatabaseAsyncResult& result) {
+		flagError1 = result.flagError;
+		message = result.errorMessage;
+		nCallbacks++;
+	}));
+	TEST_CHECK(db->queryAsync("SELECT no_such_column FROM t", [&](DatabaseAsyncResult& result) {
+		flagError2 = result.flagError && result.rows.isEmpty();
+		nCallbacks++;
+	}));
+	TEST_CHECK(WaitFor(nCallbacks, 2));
+	TEST_CHECK(flagError1);
+	TEST_CHECK(flagError2);
+	TEST_CHECK(message.contains("no_such_table"));
+	db->setLoggingErrors(sl_true);
+
+	// tasks using cursors
+	nCallbacks = 0;
+	sl_int64 sum = 0;
+	TEST_CHECK(db->dispatchAsync([&](Database* db) {
+		Ref<DatabaseCursor> cursor = db->query("SELECT a FROM t");
+		if (cursor.isNotNull()) {
+			sl_int64 a;
+			while (cursor->fetchInto(a)) {
+				sum += a;
+			}
+		}
+		nCallbacks++;
+	}));
+	TEST_CHECK(WaitFor(nCallbacks, 1));
+	TEST_CHECK_EQUAL(sum, 99 * 100 / 2);
+	TEST_CHECK(!(db->dispatchAsync(sl_null)));
+}
+
+static void TestQueueLimit(Database* db)
+{
+	TEST_CHECK(WaitForCompleted(db, db->getAsyncCompletedCount()));
+	sl_uint64 nCompleted = db->getAsyncCompletedCount();
+	sl_uint64 nRejected = db->getAsyncRejectedCount();
+	db->setAsyncQueueLimit(3);
+	TEST_CHECK_EQUAL(db->getAsyncQueueLimit(), 3);
+	Ref<Event> ev = Event::create();
+	volatile sl_int32 nRun = 0;
+	// blocks the executor
+	TEST_CHECK(db->dispatchAsync([ev, &nRun](Database*) {
+		ev->wait(10000);
+		nRun++;
+	}));
+	TEST_CHECK(db->dispatchAsync([&nRun](Database*) { nRun++; }));
+	TEST_CHECK(db->executeAsync("UPDATE t SET a = a WHERE a < 0", [&nRun](DatabaseAsyncResult&) { nRun++; }));
+	TEST_CHECK_EQUAL(db->getAsyncQueueLength(), 3);
+	// rejected while the queue is full
+	TEST_CHECK(!(db->dispatchAsync([&nRun](Database*) { nRun++; })));
+	TEST_CHECK(!(db->queryAsync("SELECT 1", [&nRun](DatabaseAsyncResult&) { nRun++; })));
+	TEST_CHECK_EQUAL(db->getAsyncRejectedCount(), nRejected + 2);
+	TEST_CHECK(db->getAsyncQueuePeakLength() >= 3);
+	ev->set();
+	TEST_CHECK(WaitFor(nRun, 3));
+	TEST_CHECK(WaitForCompleted(db, nCompleted + 3));
+	TEST_CHECK_EQUAL(db->getAsyncCompletedCount(), nCompleted + 3);
+	TEST_CHECK_EQUAL(db->getAsyncQueueLength(), 0);
+	TEST_CHECK_EQUAL(nRun, 3);
+	// accepted again
+	TEST_CHECK(db->dispatchAsync([&nRun](Database*) { nRun++; }));
+	TEST_CHECK(WaitFor(nRun, 4));
+
+	// unlimited
+	db->setAsyncQueueLimit(0);
+	ev = Event::create();
+	nRun = 0;
+	TEST_CHECK(db->dispatchAsync([ev](Database*) { ev->wait(10000); }));
+	sl_uint32 nAccepted = 0;
+	for (sl_uint32 i = 0; i < 5000; i++) {
+		if (db->dispatchAsync([&nRun](Database*) { nRun++; })) {
+			nAccepted++;
+		}
+	}
+	TEST_CHECK_EQUAL(nAccepted, 5000);
+	ev->set();
+	TEST_CHECK(WaitFor(nRun, 5000));
+	TEST_CHECK(db->getAsyncQueuePeakLength() >= 5001);
+	db->setAsyncQueueLimit(SLIB_DATABASE_ASYNC_QUEUE_LIMIT_DEFAULT);
+}
+
+static void TestLifetime()
+{
+	volatile sl_int32 nCallbacks = 0;
+	sl_int32 nSuccess = 0;
+	{
+		Ref<SQLiteDatabase> db = SQLiteDatabase::connect(":memory:");
+		TEST_CHECK(db.isNotNull());
+		if (db.isNull()) {
+			return;
+		}
+		TEST_CHECK_EQUAL(db->getAsyncCompletedCount(), 0);
+		TEST_CHECK(db->executeAsync("CREATE TABLE t (a INTEGER)", [&](DatabaseAsyncResult& result) {
+			nCallbacks++;
+		}));
+		for (sl_int32 i = 0; i < 50; i++) {
+			TEST_CHECK(db->executeAsync("INSERT INTO t (a) VALUES (?)", [&](DatabaseAsyncResult& result) {
+				if (!(result.flagError)) {
+					nSuccess++;
+				}
+				nCallbacks++;
+			}, i));
+		}
+		// the queued calls keep the database after the last reference of the caller is released
+	}
+	TEST_CHECK(WaitFor(nCallbacks, 51));
+	TEST_CHECK_EQUAL(nSuccess, 50);
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(":memory:");
+	TEST_CHECK(db.isNotNull());
+	if (db.isNotNull()) {
+		TestResults(db.get());
+		TestQueueLimit(db.get());
+	}
+	db.setNull();
+	TestLifetime();
+	return TestResult("AsyncExecution");
+}
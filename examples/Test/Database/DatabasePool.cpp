@@ -0,0 +1,304 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	DatabasePool over in-memory SQLite connections: leasing limits and timeouts, reuse, discard, validation,
+	idle expiry, close, concurrent leasing, and SQLiteDatabasePool with a WAL database file
+*/
+
+static sl_int32 g_nConnected = 0;
+
+static DatabasePoolParam MakeParam(sl_uint32 nMin, sl_uint32 nMax)
+{
+	DatabasePoolParam param;
+	param.minimumConnectionsCount = nMin;
+	param.maximumConnectionsCount = nMax;
+	param.onConnect = []() -> Ref<Database> {
+		Base::interlockedIncrement32(&g_nConnected);
+		return SQLiteDatabase::connect(":memory:");
+	};
+	return param;
+}
+
+static void TestLease()
+{
+	g_nConnected = 0;
+	DatabasePoolParam param = MakeParam(1, 3);
+	param.statementCacheSize = 7;
+	Ref<DatabasePool> pool = DatabasePool::create(param);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	TEST_CHECK_EQUAL(pool->getConnectionsCount(), 1);
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), 1);
+	TEST_CHECK_EQUAL(g_nConnected, 1);
+
+	DatabaseLease lease1 = pool->acquire();
+	TEST_CHECK(lease1.isNotNull());
+	TEST_CHECK_EQUAL(lease1->getStatementCacheSize(), 7);
+	TEST_CHECK_EQUAL(lease1->getValueForQueryResult("SELECT 1 + 1").getInt32(), 2);
+	DatabaseLease lease2 = pool->acquire();
+	DatabaseLease lease3 = pool->acquire();
+	TEST_CHECK(lease2.isNotNull());
+	TEST_CHECK(lease3.isNotNull());
+	TEST_CHECK_EQUAL(pool->getConnectionsCount(), 3);
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), 0);
+	TEST_CHECK_EQUAL(g_nConnected, 3);
+
+	// no more connection
+	TEST_CHECK(pool->acquire(0).isNull());
+	sl_int64 t = Time::now().getMillisecondsCount();
+	TEST_CHECK(pool->acquire(100).isNull());
+	TEST_CHECK(Time::now().getMillisecondsCount() - t >= 90);
+
+	// the released connection is reused
+	Database* db2 = lease2.get();
+	lease2.release();
+	TEST_CHECK(lease2.isNull());
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), 1);
+	DatabaseLease lease4 = pool->acquire(0);
+	TEST_CHECK(lease4.get() == db2);
+	TEST_CHECK_EQUAL(g_nConnected, 3);
+
+	// moved lease
+	DatabaseLease lease5(Move(lease4));
+	TEST_CHECK(lease4.isNull());
+	TEST_CHECK(lease5.get() == db2);
+	lease4 = Move(lease5);
+	TEST_CHECK(lease4.get() == db2);
+
+	// the discarded connection is replaced
+	lease3.discard();
+	TEST_CHECK_EQUAL(pool->getConnectionsCount(), 2);
+	lease3 = pool->acquire(0);
+	TEST_CHECK(lease3.isNotNull());
+	TEST_CHECK_EQUAL(g_nConnected, 4);
+
+	// a waiter is woken by the release
+	sl_bool flagAcquired = sl_false;
+	Ref<Thread> thread = Thread::start([pool, &flagAcquired]() {
+		DatabaseLease lease = pool->acquire(10000);
+		flagAcquired = lease.isNotNull();
+	});
+	TEST_CHECK(thread.isNotNull());
+	Thread::sleep(50);
+	TEST_CHECK(!flagAcquired);
+	lease1.release();
+	TEST_CHECK(thread->join(10000));
+	TEST_CHECK(flagAcquired);
+
+	// closed
+	pool->close();
+	TEST_CHECK(pool->isClosed());
+	TEST_CHECK(pool->acquire(0).isNull());
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), 0);
+	TEST_CHECK_EQUAL(pool->getConnectionsCount(), 2);
+	lease3.release();
+	lease4.release();
+	TEST_CHECK_EQUAL(pool->getConnectionsCount(), 0);
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), 0);
+}
+
+static void TestValidation()
+{
+	g_nConnected = 0;
+	sl_int32 nValidated = 0;
+	sl_bool flagValid = sl_true;
+	DatabasePoolParam param = MakeParam(0, 2);
+	param.validationInterval = 0;
+	param.onValidate = [&nValidated, &flagValid](Database* db) {
+		nValidated++;
+		return flagValid;
+	};
+	Ref<DatabasePool> pool = DatabasePool::create(param);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	TEST_CHECK_EQUAL(pool->getConnectionsCount(), 0);
+	{
+		// new connection is not validated
+		DatabaseLease lease = pool->acquire();
+		TEST_CHECK(lease.isNotNull());
+		TEST_CHECK_EQUAL(nValidated, 0);
+	}
+	{
+		DatabaseLease lease = pool->acquire();
+		TEST_CHECK(lease.isNotNull());
+		TEST_CHECK_EQUAL(nValidated, 1);
+		TEST_CHECK_EQUAL(g_nConnected, 1);
+	}
+	// the broken connection is replaced
+	flagValid = sl_false;
+	{
+		DatabaseLease lease = pool->acquire();
+		TEST_CHECK(lease.isNotNull());
+		TEST_CHECK_EQUAL(nValidated, 2);
+		TEST_CHECK_EQUAL(g_nConnected, 2);
+		TEST_CHECK_EQUAL(pool->getConnectionsCount(), 1);
+	}
+
+	// validated only after the interval
+	param.validationInterval = 100000;
+	nValidated = 0;
+	pool = DatabasePool::create(param);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	for (sl_uint32 i = 0; i < 3; i++) {
+		DatabaseLease lease = pool->acquire();
+		TEST_CHECK(lease.isNotNull());
+	}
+	TEST_CHECK_EQUAL(nValidated, 0);
+}
+
+static void TestIdleTimeout()
+{
+	DatabasePoolParam param = MakeParam(1, 4);
+	param.idleTimeout = 50;
+	Ref<DatabasePool> pool = DatabasePool::create(param);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	{
+		DatabaseLease lease1 = pool->acquire();
+		DatabaseLease lease2 = pool->acquire();
+		DatabaseLease lease3 = pool->acquire();
+		TEST_CHECK_EQUAL(pool->getConnectionsCount(), 3);
+	}
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), 3);
+	Thread::sleep(100);
+	pool->closeExpiredConnections();
+	// the minimum count is kept
+	TEST_CHECK_EQUAL(pool->getConnectionsCount(), 1);
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), 1);
+}
+
+static void TestConcurrent()
+{
+	static const sl_uint32 nThreads = 8;
+	static const sl_uint32 nRounds = 200;
+	static const sl_uint32 nMax = 3;
+	Ref<DatabasePool> pool = DatabasePool::create(MakeParam(0, nMax));
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	sl_int32 nLeased = 0;
+	sl_int32 nLeasedMax = 0;
+	sl_int32 nSuccess = 0;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nThreads; i++) {
+		threads.add(Thread::start([pool, i, &nLeased, &nLeasedMax, &nSuccess]() {
+			for (sl_uint32 k = 0; k < nRounds; k++) {
+				DatabaseLease lease = pool->acquire(30000);
+				if (lease.isNull()) {
+					continue;
+				}
+				sl_int32 n = Base::interlockedIncrement32(&nLeased);
+				for (;;) {
+					sl_int32 m = nLeasedMax;
+					if (n <= m || Base::interlockedCompareExchange32(&nLeasedMax, n, m)) {
+						break;
+					}
+				}
+				if (lease->getValueForQueryResult("SELECT ? * 2", i * nRounds + k).getUint32() == (i * nRounds + k) * 2) {
+					Base::interlockedIncrement32(&nSuccess);
+				}
+				if (k % 10 == 0) {
+					Thread::sleep(1);
+				}
+				Base::interlockedDecrement32(&nLeased);
+			}
+		}));
+	}
+	ListElements< Ref<Thread> > items(threads);
+	for (sl_size i = 0; i < items.count; i++) {
+		TEST_CHECK(items[i].isNotNull() && items[i]->join(120000));
+	}
+	TEST_CHECK_EQUAL(nSuccess, (sl_int32)(nThreads * nRounds));
+	TEST_CHECK(nLeasedMax <= (sl_int32)nMax);
+	TEST_CHECK(pool->getConnectionsCount() <= nMax);
+	TEST_CHECK_EQUAL(pool->getIdleConnectionsCount(), pool->getConnectionsCount());
+}
+
+static void TestSQLitePool()
+{
+	String path = System::getTempDirectory() + "/slib_test_pool_" + String::fromUint32(System::getProcessId()) + ".db";
+	File::deleteFile(path);
+	Ref<SQLiteDatabasePool> pool = SQLiteDatabasePool::create(path, 2);
+	TEST_CHECK(pool.isNotNull());
+	if (pool.isNull()) {
+		return;
+	}
+	{
+		DatabaseLease writer = pool->acquireWriter();
+		TEST_CHECK(writer.isNotNull());
+		if (writer.isNotNull()) {
+			TEST_CHECK_EQUAL(writer->getValueForQueryResult("PRAGMA journal_mode").getString(), "wal");
+			TEST_CHECK(writer->execute("CREATE TABLE t (a INTEGER)") >= 0);
+			TEST_CHECK_EQUAL(writer->execute("INSERT INTO t (a) VALUES (?)", 1), 1);
+			// single writer
+			TEST_CHECK(pool->acquireWriter(0).isNull());
+		}
+		DatabaseLease reader1 = pool->acquireReader();
+		DatabaseLease reader2 = pool->acquireReader();
+		TEST_CHECK(reader1.isNotNull());
+		TEST_CHECK(reader2.isNotNull());
+		TEST_CHECK(pool->acquireReader(0).isNull());
+		if (reader1.isNotNull() && reader2.isNotNull() && writer.isNotNull()) {
+			// readers are not blocked by the open transaction of the writer
+			TEST_CHECK(writer->execute("BEGIN") >= 0);
+			TEST_CHECK_EQUAL(writer->execute("INSERT INTO t (a) VALUES (?)", 2), 1);
+			TEST_CHECK_EQUAL(reader1->getValueForQueryResult("SELECT COUNT(*) FROM t").getInt32(), 1);
+			TEST_CHECK(writer->execute("COMMIT") >= 0);
+			TEST_CHECK_EQUAL(reader2->getValueForQueryResult("SELECT COUNT(*) FROM t").getInt32(), 2);
+			// readers are read-only
+			reader1->setLoggingErrors(sl_false);
+			TEST_CHECK(reader1->execute("INSERT INTO t (a) VALUES (?)", 3) < 0);
+		}
+	}
+	pool->close();
+	TEST_CHECK(pool->acquireReader(0).isNull());
+	TEST_CHECK(pool->acquireWriter(0).isNull());
+	pool.setNull();
+	File::deleteFile(path);
+	File::deleteFile(path + "-wal");
+	File::deleteFile(path + "-shm");
+}
+
+int main(int argc, const char * argv[])
+{
+	TestLease();
+	TestValidation();
+	TestIdleTimeout();
+	TestConcurrent();
+	TestSQLitePool();
+	return TestResult("DatabasePool");
+}
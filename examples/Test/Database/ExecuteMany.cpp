@@ -0,0 +1,169 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	`executeMany()` on an in-memory SQLite connection: batches in transactions, per-row errors,
+	rolled back batches on the failed commit, params count mismatch, and the statement API
+*/
+
+static List<VariantList> MakeRows(sl_uint32 start, sl_uint32 count)
+{
+	List<VariantList> rows;
+	for (sl_uint32 i = start; i < start + count; i++) {
+		rows.add_NoLock(VariantList::createFromElements(i, "name" + String::fromUint32(i)));
+	}
+	return rows;
+}
+
+static void TestBatches(Database* db)
+{
+	TEST_CHECK(db->execute("CREATE TABLE t (a INTEGER PRIMARY KEY, b TEXT)") >= 0);
+	static const sl_uint32 sizesBatch[] = { 100, 7, 1, 0 };
+	sl_uint32 start = 0;
+	for (sl_uint32 i = 0; i < CountOfArray(sizesBatch); i++) {
+		db->setBatchSize(sizesBatch[i]);
+		List<DatabaseBatchError> errors;
+		TEST_CHECK_EQUAL(db->executeMany("INSERT INTO t (a, b) VALUES (?, ?)", MakeRows(start, 250), &errors), 250);
+		TEST_CHECK(errors.isEmpty());
+		start += 250;
+	}
+	db->setBatchSize(SLIB_DATABASE_BATCH_SIZE_DEFAULT);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM t").getInt32(), 1000);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT SUM(a) FROM t").getInt64(), 999 * 1000 / 2);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT b FROM t WHERE a = ?", 777).getString(), "name777");
+
+	// flat params
+	Variant params[] = { 1000, "x", 1001, "y", 1002, "z" };
+	TEST_CHECK_EQUAL(db->executeManyBy("INSERT INTO t (a, b) VALUES (?, ?)", params, 2, 3), 3);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT b FROM t WHERE a = ?", 1002).getString(), "z");
+
+	// updates count the affected rows
+	List<VariantList> rows;
+	rows.add_NoLock(VariantList::createFromElements("even", 0));
+	rows.add_NoLock(VariantList::createFromElements("odd", 1));
+	TEST_CHECK_EQUAL(db->executeMany("UPDATE t SET b = ? WHERE a % 2 = ? AND a < 1000", rows), 1000);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM t WHERE b = 'odd'").getInt32(), 500);
+
+	// empty
+	TEST_CHECK_EQUAL(db->executeMany("INSERT INTO t (a, b) VALUES (?, ?)", List<VariantList>()), 0);
+}
+
+static void TestRowErrors(Database* db)
+{
+	db->setLoggingErrors(sl_false);
+	db->setBatchSize(10);
+	TEST_CHECK(db->execute("CREATE TABLE u (a INTEGER PRIMARY KEY, b TEXT)") >= 0);
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO u (a, b) VALUES (?, ?)", 5, "x"), 1);
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO u (a, b) VALUES (?, ?)", 23, "x"), 1);
+	// rows 5 and 23 violate the primary key, the other rows are committed
+	List<DatabaseBatchError> errors;
+	TEST_CHECK_EQUAL(db->executeMany("INSERT INTO u (a, b) VALUES (?, ?)", MakeRows(0, 30), &errors), 28);
+	TEST_CHECK_EQUAL(errors.getCount(), 2);
+	if (errors.getCount() == 2) {
+		TEST_CHECK_EQUAL(errors.getValueAt(0).row, 5);
+		TEST_CHECK_EQUAL(errors.getValueAt(1).row, 23);
+		// row by row errors cover one row each
+		TEST_CHECK_EQUAL(errors.getValueAt(0).count, 1);
+		TEST_CHECK(errors.getValueAt(0).message.contains("UNIQUE"));
+	}
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM u").getInt32(), 30);
+
+	// params count mismatch: nothing is executed
+	List<VariantList> rows = MakeRows(100, 5);
+	rows.add_NoLock(VariantList::createFromElements(105));
+	errors.setNull();
+	TEST_CHECK_EQUAL(db->executeMany("INSERT INTO u (a, b) VALUES (?, ?)", rows, &errors), -1);
+	TEST_CHECK_EQUAL(errors.getCount(), 1);
+	if (errors.getCount() == 1) {
+		TEST_CHECK_EQUAL(errors.getValueAt(0).row, 5);
+	}
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM u").getInt32(), 30);
+
+	// the failed commit rolls back the whole batch
+	TEST_CHECK(db->execute("PRAGMA foreign_keys = ON") >= 0);
+	TEST_CHECK(db->execute("CREATE TABLE child (a INTEGER, p INTEGER REFERENCES u(a) DEFERRABLE INITIALLY DEFERRED)") >= 0);
+	rows.setNull();
+	for (sl_uint32 i = 0; i < 30; i++) {
+		// the parent of row 14 doesn't exist
+		rows.add_NoLock(VariantList::createFromElements(i, i == 14 ? 1000 : i));
+	}
+	errors.setNull();
+	TEST_CHECK_EQUAL(db->executeMany("INSERT INTO child (a, p) VALUES (?, ?)", rows, &errors), 20);
+	TEST_CHECK_EQUAL(errors.getCount(), 10);
+	if (errors.getCount() == 10) {
+		TEST_CHECK_EQUAL(errors.getValueAt(0).row, 10);
+		TEST_CHECK_EQUAL(errors.getValueAt(9).row, 19);
+	}
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM child").getInt32(), 20);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM child WHERE a >= 10 AND a < 20").getInt32(), 0);
+	db->setBatchSize(SLIB_DATABASE_BATCH_SIZE_DEFAULT);
+	db->setLoggingErrors(sl_true);
+}
+
+static void TestTransaction(Database* db)
+{
+	// the batches join the transaction of the caller
+	TEST_CHECK(db->execute("CREATE TABLE v (a INTEGER)") >= 0);
+	List<VariantList> rows;
+	for (sl_uint32 i = 0; i < 50; i++) {
+		rows.add_NoLock(VariantList::createFromElements(i));
+	}
+	TEST_CHECK(db->execute("BEGIN") >= 0);
+	TEST_CHECK_EQUAL(db->executeMany("INSERT INTO v (a) VALUES (?)", rows), 50);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM v").getInt32(), 50);
+	TEST_CHECK(db->execute("ROLLBACK") >= 0);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM v").getInt32(), 0);
+}
+
+static void TestStatement(Database* db)
+{
+	Ref<DatabaseStatement> statement = db->prepareStatement("INSERT INTO v (a) VALUES (?)");
+	TEST_CHECK(statement.isNotNull());
+	if (statement.isNull()) {
+		return;
+	}
+	List<VariantList> rows;
+	for (sl_uint32 i = 0; i < 40; i++) {
+		rows.add_NoLock(VariantList::createFromElements(i));
+	}
+	TEST_CHECK_EQUAL(statement->executeMany(rows), 40);
+	Variant params[] = { 100, 101 };
+	TEST_CHECK_EQUAL(statement->executeManyBy(params, 1, 2), 2);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT SUM(a) FROM v").getInt32(), 39 * 40 / 2 + 201);
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(":memory:");
+	TEST_CHECK(db.isNotNull());
+	if (db.isNotNull()) {
+		TestBatches(db.get());
+		TestRowErrors(db.get());
+		TestTransaction(db.get());
+		TestStatement(db.get());
+	}
+	return TestResult("ExecuteMany");
+}
@@ -0,0 +1,284 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Streaming export of the cursor rows (`writeJson()`, `writeCsv()`) on an in-memory SQLite connection:
+	each column type, escaping and quoting, rows and blobs across the chunk boundaries, writer errors,
+	the HTTP output buffer, and a cursor using the default text access
+*/
+
+static String ToString(const Memory& mem)
+{
+	return String((const sl_char8*)(mem.getData()), mem.getSize());
+}
+
+static String ExportJson(DatabaseCursor* cursor, sl_int64& nRows)
+{
+	MemoryWriter writer;
+	nRows = cursor->writeJson(&writer);
+	return ToString(writer.getData());
+}
+
+static String ExportCsv(DatabaseCursor* cursor, sl_int64& nRows, sl_bool flagHeader = sl_true)
+{
+	MemoryWriter writer;
+	nRows = cursor->writeCsv(&writer, flagHeader);
+	return ToString(writer.getData());
+}
+
+static void TestTypes(Database* db)
+{
+	TEST_CHECK(db->execute("CREATE TABLE t (i INTEGER, f REAL, s TEXT, b BLOB)") >= 0);
+	sl_uint8 blob[4] = { 0, 1, 0xfe, 0xff };
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (i, f, s, b) VALUES (?, ?, ?, ?)", (sl_int64)SLIB_INT64(-9223372036854775807) - 1, 0.1, "a\"b\\c\nd\x01", Memory::create(blob, 4)), 1);
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (i, f, s, b) VALUES (?, ?, ?, NULL)", 42, 3.0, "x,y"), 1);
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (i, f, s, b) VALUES (NULL, 1e20, '', NULL)"), 1);
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (i, f, s, b) VALUES (-7, 9e999, NULL, NULL)"), 1);
+
+	sl_int64 nRows = 0;
+	Ref<DatabaseCursor> cursor = db->query("SELECT i, f, s, b FROM t ORDER BY rowid");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		String json = ExportJson(cursor.get(), nRows);
+		TEST_CHECK_EQUAL(nRows, 4);
+		TEST_CHECK_EQUAL(json, "["
+			"{\"i\":-9223372036854775808,\"f\":0.1,\"s\":\"a\\\"b\\\\c\\nd\\u0001\",\"b\":\"AAH+/w==\"},"
+			"{\"i\":42,\"f\":3.0,\"s\":\"x,y\",\"b\":null},"
+			"{\"i\":null,\"f\":1.0e+20,\"s\":\"\",\"b\":null},"
+			"{\"i\":-7,\"f\":null,\"s\":null,\"b\":null}"
+			"]");
+		// parsed back to the same values
+		Json parsed = Json::parseJson(json);
+		TEST_CHECK_EQUAL(parsed[0]["s"].getString(), "a\"b\\c\nd\x01");
+		TEST_CHECK_EQUAL(parsed[0]["i"].getInt64(), (sl_int64)SLIB_INT64(-9223372036854775807) - 1);
+		TEST_CHECK_EQUAL(parsed[0]["f"].getDouble(), 0.1);
+	}
+
+	cursor = db->query("SELECT i, f, s, b FROM t ORDER BY rowid");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		String csv = ExportCsv(cursor.get(), nRows);
+		TEST_CHECK_EQUAL(nRows, 4);
+		TEST_CHECK_EQUAL(csv,
+			"i,f,s,b\r\n"
+			"-9223372036854775808,0.1,\"a\"\"b\\c\nd\x01\",AAH+/w==\r\n"
+			"42,3.0,\"x,y\",\r\n"
+			",1.0e+20,,\r\n"
+			"-7,Infinity,,\r\n");
+	}
+
+	// no header, and no rows
+	cursor = db->query("SELECT i, s FROM t WHERE i = ?", 42);
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		String csv = ExportCsv(cursor.get(), nRows, sl_false);
+		TEST_CHECK_EQUAL(csv, "42,\"x,y\"\r\n");
+		TEST_CHECK_EQUAL(nRows, 1);
+	}
+	cursor = db->query("SELECT i FROM t WHERE i = 0");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		String json = ExportJson(cursor.get(), nRows);
+		TEST_CHECK_EQUAL(json, "[]");
+		TEST_CHECK_EQUAL(nRows, 0);
+	}
+}
+
+static void TestLarge(Database* db)
+{
+	TEST_CHECK(db->execute("CREATE TABLE big (n INTEGER, f REAL, s TEXT)") >= 0);
+	TEST_CHECK(db->execute("CREATE TABLE blobs (b BLOB)") >= 0);
+	static const sl_uint32 nRows = 20000;
+	StringBuffer expectedJson;
+	expectedJson.add("[");
+	TEST_CHECK(db->execute("BEGIN") >= 0);
+	for (sl_uint32 i = 0; i < nRows; i++) {
+		String s = "row \"" + String::fromUint32(i) + "\"";
+		double f = i / 4.0;
+		TEST_CHECK_EQUAL(db->execute("INSERT INTO big (n, f, s) VALUES (?, ?, ?)", i, f, s), 1);
+		if (i) {
+			expectedJson.add(",");
+		}
+		expectedJson.add("{\"n\":" + String::fromUint32(i) + ",\"f\":" + String::fromDouble(f) + ",\"s\":\"row \\\"" + String::fromUint32(i) + "\\\"\"}");
+	}
+	TEST_CHECK(db->execute("COMMIT") >= 0);
+	expectedJson.add("]");
+
+	sl_int64 n = 0;
+	Ref<DatabaseCursor> cursor = db->query("SELECT n, f, s FROM big ORDER BY n");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		String json = ExportJson(cursor.get(), n);
+		TEST_CHECK_EQUAL(n, nRows);
+		TEST_CHECK(json.getLength() > 0x20000);
+		TEST_CHECK(json == expectedJson.merge());
+	}
+
+	// a blob larger than the chunk
+	Memory blob = Memory::create(200001);
+	TEST_CHECK(blob.isNotNull());
+	if (blob.isNull()) {
+		return;
+	}
+	sl_uint8* p = (sl_uint8*)(blob.getData());
+	for (sl_size i = 0; i < blob.getSize(); i++) {
+		p[i] = (sl_uint8)(i * 7 + (i >> 8));
+	}
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO blobs (b) VALUES (?)", blob), 1);
+	cursor = db->query("SELECT b FROM blobs");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		String csv = ExportCsv(cursor.get(), n, sl_false);
+		TEST_CHECK_EQUAL(n, 1);
+		TEST_CHECK(csv == Base64::encode(blob) + "\r\n");
+	}
+
+	// the HTTP output buffer receives the same text
+	cursor = db->query("SELECT n, f, s FROM big ORDER BY n");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		HttpOutputBuffer output;
+		TEST_CHECK_EQUAL(cursor->writeJson(&output), nRows);
+		TEST_CHECK_EQUAL(output.getOutputLength(), expectedJson.getLength());
+	}
+}
+
+class FailingWriter : public IWriter
+{
+public:
+	sl_size nWritten = 0;
+
+public:
+	sl_reg write(const void* buf, sl_size size) override
+	{
+		if (nWritten) {
+			return -1;
+		}
+		nWritten += size;
+		return size;
+	}
+};
+
+static void TestWriterError(Database* db)
+{
+	Ref<DatabaseCursor> cursor = db->query("SELECT n, f, s FROM big ORDER BY n");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		FailingWriter writer;
+		TEST_CHECK_EQUAL(cursor->writeJson(&writer), -1);
+		// stopped at the second chunk
+		TEST_CHECK(writer.nWritten > 0);
+		TEST_CHECK(cursor->moveNext());
+	}
+	cursor = db->query("SELECT n FROM big");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		TEST_CHECK_EQUAL(cursor->writeCsv((IWriter*)sl_null), -1);
+	}
+}
+
+// a cursor which provides only the text of the values, as the drivers not overriding the typed getters
+class TextCursor : public DatabaseCursor
+{
+public:
+	sl_uint32 m_row = 0;
+
+public:
+	sl_uint32 getColumnsCount() override
+	{
+		return 2;
+	}
+
+	String getColumnName(sl_uint32 index) override
+	{
+		return index ? "b" : "a";
+	}
+
+	sl_int32 getColumnIndex(const String& name) override
+	{
+		if (name == "a") {
+			return 0;
+		}
+		if (name == "b") {
+			return 1;
+		}
+		return -1;
+	}
+
+	HashMap<String, Variant> getRow() override
+	{
+		HashMap<String, Variant> row;
+		row.put("a", getValue(0));
+		row.put("b", getValue(1));
+		return row;
+	}
+
+	String getString(sl_uint32 index) override
+	{
+		if (index) {
+			return "v\"" + String::fromUint32(m_row);
+		}
+		return String::fromUint32(m_row * 10);
+	}
+
+	Memory getBlob(sl_uint32 index) override
+	{
+		return sl_null;
+	}
+
+	sl_bool moveNext() override
+	{
+		if (m_row < 2) {
+			m_row++;
+			return sl_true;
+		}
+		return sl_false;
+	}
+};
+
+static void TestDefaultCursor()
+{
+	TextCursor cursor;
+	TEST_CHECK(cursor.getColumnType(0) == DatabaseColumnType::Text);
+	TEST_CHECK_EQUAL(String(cursor.getStringView(1)), "v\"0");
+	MemoryWriter writer;
+	TEST_CHECK_EQUAL(cursor.writeJson(&writer), 2);
+	String json = ToString(writer.getData());
+	TEST_CHECK_EQUAL(json, "[{\"a\":\"10\",\"b\":\"v\\\"1\"},{\"a\":\"20\",\"b\":\"v\\\"2\"}]");
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(":memory:");
+	TEST_CHECK(db.isNotNull());
+	if (db.isNotNull()) {
+		TestTypes(db.get());
+		TestLarge(db.get());
+		TestWriterError(db.get());
+	}
+	TestDefaultCursor();
+	return TestResult("Export");
+}
@@ -0,0 +1,479 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	AsyncRedisClient against a fake server on the loopback interface: reply types of RESP2 and RESP3 received in
+	small pieces, large arrays, pipelining order, transactions, subscriptions, and the protocol errors closing the connection
+*/
+
+class FakeRedisServer : public Referable
+{
+public:
+	// returns the reply of the command
+	Function<String(const List<String>& command)> onCommand;
+	// bytes of each send, 0 sends the reply at once
+	sl_uint32 sizeChunk;
+	sl_uint16 port;
+	sl_uint32 nCommands;
+
+private:
+	Ref<Socket> m_listener;
+	Ref<Thread> m_thread;
+	sl_bool m_flagStop;
+
+public:
+	FakeRedisServer(): sizeChunk(0), port(0), nCommands(0), m_flagStop(sl_false) {}
+
+	~FakeRedisServer()
+	{
+		stop();
+	}
+
+public:
+	sl_bool start()
+	{
+		m_listener = Socket::openTcp();
+		if (m_listener.isNull()) {
+			return sl_false;
+		}
+		if (!(m_listener->bind(SocketAddress(IPv4Address(127, 0, 0, 1), 0)) && m_listener->listen())) {
+			return sl_false;
+		}
+		SocketAddress address;
+		if (!(m_listener->getLocalAddress(address))) {
+			return sl_false;
+		}
+		port = (sl_uint16)(address.port);
+		m_listener->setOption_ReceiveTimeout(50);
+		m_thread = Thread::start(SLIB_FUNCTION_REF(FakeRedisServer, run, this));
+		return m_thread.isNotNull();
+	}
+
+	void stop()
+	{
+		m_flagStop = sl_true;
+		if (m_thread.isNotNull()) {
+			m_thread->join(10000);
+			m_thread.setNull();
+		}
+	}
+
+private:
+	void run()
+	{
+		Ref<Socket> client;
+		SocketAddress address;
+		while (!m_flagStop) {
+			if (m_listener->accept(client, address)) {
+				break;
+			}
+		}
+		if (client.isNull()) {
+			return;
+		}
+		client->setOption_ReceiveTimeout(50);
+		client->setOption_TcpNoDelay(sl_true);
+		MemoryBuffer buf;
+		String input;
+		char data[4096];
+		while (!m_flagStop) {
+			sl_int32 n = client->receive(data, sizeof(data));
+			if (n < 0) {
+				break;
+			}
+			if (!n) {
+				continue;
+			}
+			input += String(data, n);
+			sl_size pos = 0;
+			List<String> command;
+			while (parseCommand(input, pos, command)) {
+				nCommands++;
+				String reply = onCommand(command);
+				if (!(sendReply(client.get(), reply))) {
+					return;
+				}
+				command.setNull();
+			}
+			input = input.substring(pos);
+		}
+	}
+
+	static sl_bool parseLine(const String& input, sl_size& pos, sl_char8 type, sl_uint32& value)
+	{
+		sl_reg end = input.indexOf("\r\n", pos);
+		if (end < 0 || input.getAt(pos) != type) {
+			return sl_false;
+		}
+		value = input.substring(pos + 1, end).parseUint32();
+		pos = end + 2;
+		return sl_true;
+	}
+
+	static sl_bool parseCommand(const String& input, sl_size& _pos, List<String>& command)
+	{
+		sl_size pos = _pos;
+		sl_uint32 nArgs;
+		if (!(parseLine(input, pos, '*', nArgs))) {
+			return sl_false;
+		}
+		for (sl_uint32 i = 0; i < nArgs; i++) {
+			sl_uint32 len;
+			if (!(parseLine(input, pos, '$', len))) {
+				return sl_false;
+			}
+			if (pos + len + 2 > input.getLength()) {
+				return sl_false;
+			}
+			command.add_NoLock(input.substring(pos, pos + len));
+			pos += len + 2;
+		}
+		_pos = pos;
+		return sl_true;
+	}
+
+	sl_bool sendReply(Socket* client, const String& reply)
+	{
+		const sl_char8* data = reply.getData();
+		sl_size size = reply.getLength();
+		while (size) {
+			sl_uint32 n = (sl_uint32)size;
+			if (sizeChunk && n > sizeChunk) {
+				n = sizeChunk;
+			}
+			sl_int32 m = client->send(data, n);
+			if (m < 0) {
+				return sl_false;
+			}
+			data += m;
+			size -= m;
+			if (sizeChunk) {
+				Thread::sleep(1);
+			}
+		}
+		return sl_true;
+	}
+
+};
+
+static String Bulk(const String& s)
+{
+	return String::format("$%d\r\n%s\r\n", s.getLength(), s);
+}
+
+static sl_bool WaitFor(volatile sl_int32& count, sl_int32 n)
+{
+	for (sl_uint32 i = 0; i < 20000; i++) {
+		if (count >= n) {
+			return sl_true;
+		}
+		Thread::sleep(1);
+	}
+	return sl_false;
+}
+
+static Ref<AsyncRedisClient> Connect(FakeRedisServer* server, volatile sl_int32* nErrors = sl_null)
+{
+	AsyncRedisClientParam param;
+	param.port = server->port;
+	param.flagLogError = sl_false;
+	if (nErrors) {
+		param.onError = [nErrors](AsyncRedisClient*) {
+			Base::interlockedIncrement32((sl_int32*)nErrors);
+		};
+	}
+	return AsyncRedisClient::create(param);
+}
+
+static String ReplyCommand(const List<String>& command)
+{
+	String name = command.getValueAt(0);
+	if (name == "SET" || name == "MULTI") {
+		return "+OK\r\n";
+	}
+	if (name == "GET") {
+		String key = command.getValueAt(1);
+		if (key == "missing") {
+			return "$-1\r\n";
+		}
+		if (key == "binary") {
+			return "$6\r\na\r\nb\r\n\r\n";
+		}
+		return Bulk(key + "-value");
+	}
+	if (name == "INCRBY") {
+		return ":" + command.getValueAt(2) + "\r\n";
+	}
+	if (name == "LRANGE") {
+		StringBuffer sb;
+		sb.add("*10000\r\n");
+		for (sl_uint32 i = 0; i < 10000; i++) {
+			sb.add(Bulk("item" + String::fromUint32(i)));
+		}
+		return sb.merge();
+	}
+	if (name == "NESTED") {
+		return "*4\r\n*2\r\n:1\r\n*1\r\n+deep\r\n*0\r\n$-1\r\n$0\r\n\r\n";
+	}
+	if (name == "RESP3") {
+		// map with an attribute before the value of "b", set, double, boolean and null
+		return "*3\r\n%2\r\n+a\r\n:1\r\n+b\r\n|1\r\n+ttl\r\n:3\r\n,1.5\r\n~2\r\n#t\r\n_\r\n(12345678901234567890\r\n";
+	}
+	if (name == "FAIL") {
+		return "-ERR boom\r\n";
+	}
+	if (name == "EXEC") {
+		return "*2\r\n+OK\r\n:43\r\n";
+	}
+	return "+QUEUED\r\n";
+}
+
+static void TestReplies()
+{
+	Ref<FakeRedisServer> server = new FakeRedisServer;
+	server->onCommand = &ReplyCommand;
+	// replies are received in pieces
+	server->sizeChunk = 3;
+	TEST_CHECK(server->start());
+	volatile sl_int32 nErrors = 0;
+	Ref<AsyncRedisClient> client = Connect(server.get(), &nErrors);
+	TEST_CHECK(client.isNotNull());
+	if (client.isNull()) {
+		return;
+	}
+	volatile sl_int32 nReplies = 0;
+	sl_int32 nExpected = 0;
+	List<RedisReply> replies;
+	Function<void(RedisReply&)> callback = [&nReplies, &replies](RedisReply& reply) {
+		replies.add(reply);
+		Base::interlockedIncrement32((sl_int32*)&nReplies);
+	};
+	TEST_CHECK(client->set("key", "value", 0, callback)); nExpected++;
+	TEST_CHECK(client->get("key", callback)); nExpected++;
+	TEST_CHECK(client->get("missing", callback)); nExpected++;
+	TEST_CHECK(client->get("binary", callback)); nExpected++;
+	TEST_CHECK(client->execute(callback, "NESTED")); nExpected++;
+	TEST_CHECK(client->execute(callback, "RESP3")); nExpected++;
+	TEST_CHECK(client->execute(callback, "FAIL")); nExpected++;
+	TEST_CHECK(WaitFor(nReplies, nExpected));
+	TEST_CHECK_EQUAL(replies.getCount(), (sl_size)nExpected);
+	if (replies.getCount() == (sl_size)nExpected) {
+		RedisReply* r = replies.getData();
+		TEST_CHECK(r[0].type == RedisReplyType::Status && r[0].string == "OK");
+		TEST_CHECK(r[1].type == RedisReplyType::String && r[1].string == "key-value");
+		TEST_CHECK(r[2].isNull());
+		TEST_CHECK_EQUAL(r[3].string, "a\r\nb\r\n");
+		TEST_CHECK(r[4].type == RedisReplyType::Array && r[4].elements.getCount() == 4);
+		TEST_CHECK_EQUAL(r[4].toVariant().toJsonString(), "[[1, [\"deep\"]], null, null, \"\"]");
+		TEST_CHECK(r[4].elements.getValueAt(1).type == RedisReplyType::Array);
+		TEST_CHECK(r[5].type == RedisReplyType::Array && r[5].elements.getCount() == 3);
+		TEST_CHECK_EQUAL(r[5].toVariant().toJsonString(), "[{\"a\": 1, \"b\": 1.5}, [true, null], \"12345678901234567890\"]");
+		if (r[5].elements.getCount() == 3) {
+			RedisReply* items = r[5].elements.getData();
+			TEST_CHECK(items[0].type == RedisReplyType::Map && items[0].elements.getCount() == 4);
+			TEST_CHECK(items[1].type == RedisReplyType::Set);
+			TEST_CHECK(items[2].type == RedisReplyType::BigNumber);
+		}
+		TEST_CHECK(r[6].isError() && r[6].string == "ERR boom");
+	}
+
+	// large array received in many pieces
+	server->sizeChunk = 997;
+	replies.setNull();
+	nReplies = 0;
+	TEST_CHECK(client->execute(callback, "LRANGE", "list", 0, -1));
+	TEST_CHECK(WaitFor(nReplies, 1));
+	if (replies.getCount() == 1) {
+		RedisReply& r = *(replies.getData());
+		TEST_CHECK(r.type == RedisReplyType::Array);
+		TEST_CHECK_EQUAL(r.elements.getCount(), 10000);
+		if (r.elements.getCount() == 10000) {
+			TEST_CHECK_EQUAL(r.elements.getValueAt(9999).string, "item9999");
+		}
+	}
+
+	// pipelined commands are answered in order
+	server->sizeChunk = 0;
+	sl_int32 nOrdered = 0;
+	nReplies = 0;
+	for (sl_int32 i = 0; i < 1000; i++) {
+		TEST_CHECK(client->incrby("counter", i, [i, &nOrdered, &nReplies](RedisReply& reply) {
+			if (reply.getInteger(-1) == i && nOrdered == i) {
+				nOrdered++;
+			}
+			Base::interlockedIncrement32((sl_int32*)&nReplies);
+		}));
+	}
+	TEST_CHECK(WaitFor(nReplies, 1000));
+	TEST_CHECK_EQUAL(nOrdered, 1000);
+
+	// transaction
+	replies.setNull();
+	nReplies = 0;
+	List<VariantList> commands;
+	commands.add_NoLock(VariantList::createFromElements("SET", "a", 1));
+	commands.add_NoLock(VariantList::createFromElements("INCRBY", "a", 42));
+	TEST_CHECK(client->executeTransaction(commands, callback));
+	TEST_CHECK(WaitFor(nReplies, 1));
+	if (replies.getCount() == 1) {
+		TEST_CHECK_EQUAL(replies.getValueAt(0).toVariant().toJsonString(), "[\"OK\", 43]");
+	}
+	// the invalid transaction is not sent
+	sl_uint32 nCommands = server->nCommands;
+	commands.add_NoLock(VariantList());
+	TEST_CHECK(!(client->executeTransaction(commands, callback)));
+	replies.setNull();
+	nReplies = 0;
+	TEST_CHECK(client->get("after", callback));
+	TEST_CHECK(WaitFor(nReplies, 1));
+	if (replies.getCount() == 1) {
+		TEST_CHECK_EQUAL(replies.getValueAt(0).string, "after-value");
+	}
+	TEST_CHECK_EQUAL(server->nCommands, nCommands + 1);
+	TEST_CHECK(client->isConnected());
+	TEST_CHECK_EQUAL(nErrors, 0);
+	client->close();
+	server->stop();
+}
+
+static String ReplySubscription(const List<String>& command)
+{
+	String name = command.getValueAt(0);
+	if (name == "LRANGE") {
+		// list starting with "message"
+		return "*3\r\n" + Bulk("message") + Bulk("a") + Bulk("b");
+	}
+	if (name == "SUBSCRIBE") {
+		return "*3\r\n" + Bulk("subscribe") + Bulk(command.getValueAt(1)) + ":1\r\n" + "*3\r\n" + Bulk("message") + Bulk(command.getValueAt(1)) + Bulk("hello");
+	}
+	if (name == "UNSUBSCRIBE") {
+		return "*3\r\n" + Bulk("unsubscribe") + Bulk(command.getValueAt(1)) + ":0\r\n";
+	}
+	return "+OK\r\n";
+}
+
+static void TestSubscription()
+{
+	Ref<FakeRedisServer> server = new FakeRedisServer;
+	server->onCommand = &ReplySubscription;
+	TEST_CHECK(server->start());
+	volatile sl_int32 nMessages = 0;
+	String channelMessage;
+	String textMessage;
+	AsyncRedisClientParam param;
+	param.port = server->port;
+	param.flagLogError = sl_false;
+	param.onMessage = [&nMessages, &channelMessage, &textMessage](AsyncRedisClient*, const String& channel, RedisReply& message) {
+		channelMessage = channel;
+		textMessage = message.string;
+		Base::interlockedIncrement32((sl_int32*)&nMessages);
+	};
+	Ref<AsyncRedisClient> client = AsyncRedisClient::create(param);
+	TEST_CHECK(client.isNotNull());
+	if (client.isNull()) {
+		return;
+	}
+	volatile sl_int32 nReplies = 0;
+	List<RedisReply> replies;
+	Function<void(RedisReply&)> callback = [&nReplies, &replies](RedisReply& reply) {
+		replies.add(reply);
+		Base::interlockedIncrement32((sl_int32*)&nReplies);
+	};
+	// the reply of the command pipelined before subscribing is not a message
+	TEST_CHECK(client->execute(callback, "LRANGE", "list", 0, -1));
+	TEST_CHECK(client->subscribe("ch", callback));
+	TEST_CHECK(client->unsubscribe("ch", callback));
+	// not subscribed after the confirmation of unsubscription
+	TEST_CHECK(client->execute(callback, "LRANGE", "list", 0, -1));
+	TEST_CHECK(WaitFor(nReplies, 4));
+	TEST_CHECK(WaitFor(nMessages, 1));
+	TEST_CHECK_EQUAL(nMessages, 1);
+	TEST_CHECK_EQUAL(channelMessage, "ch");
+	TEST_CHECK_EQUAL(textMessage, "hello");
+	TEST_CHECK_EQUAL(replies.getCount(), 4);
+	if (replies.getCount() == 4) {
+		RedisReply* r = replies.getData();
+		TEST_CHECK_EQUAL(r[0].toVariant().toJsonString(), "[\"message\", \"a\", \"b\"]");
+		TEST_CHECK_EQUAL(r[1].toVariant().toJsonString(), "[\"subscribe\", \"ch\", 1]");
+		TEST_CHECK_EQUAL(r[2].toVariant().toJsonString(), "[\"unsubscribe\", \"ch\", 0]");
+		TEST_CHECK_EQUAL(r[3].toVariant().toJsonString(), "[\"message\", \"a\", \"b\"]");
+	}
+	client->close();
+	server->stop();
+}
+
+static void TestProtocolError(const String& reply)
+{
+	Ref<FakeRedisServer> server = new FakeRedisServer;
+	server->onCommand = [reply](const List<String>&) {
+		return reply;
+	};
+	TEST_CHECK(server->start());
+	volatile sl_int32 nErrors = 0;
+	Ref<AsyncRedisClient> client = Connect(server.get(), &nErrors);
+	TEST_CHECK(client.isNotNull());
+	if (client.isNull()) {
+		return;
+	}
+	volatile sl_int32 nReplies = 0;
+	sl_bool flagErrorReply = sl_false;
+	TEST_CHECK(client->get("key", [&nReplies, &flagErrorReply](RedisReply& reply) {
+		flagErrorReply = reply.isError();
+		nReplies++;
+	}));
+	TEST_CHECK(WaitFor(nErrors, 1));
+	TEST_CHECK(WaitFor(nReplies, 1));
+	TEST_CHECK(flagErrorReply);
+	TEST_CHECK(client->isClosed());
+	server->stop();
+}
+
+static void TestProtocolErrors()
+{
+	// no CRLF after the bulk
+	TestProtocolError("$3\r\nabcXY\r\n");
+	// bulk longer than the limit
+	TestProtocolError("$999999999999\r\n");
+	// invalid length
+	TestProtocolError("$abc\r\n");
+	// nested too deep
+	StringBuffer sb;
+	for (sl_uint32 i = 0; i < 100; i++) {
+		sb.add("*1\r\n");
+	}
+	TestProtocolError(sb.merge());
+	// unknown type
+	TestProtocolError("?\r\n");
+}
+
+int main(int argc, const char * argv[])
+{
+	TestReplies();
+	TestSubscription();
+	TestProtocolErrors();
+	AsyncIoLoop::releaseDefault();
+	return TestResult("RedisClient");
+}
@@ -0,0 +1,163 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Typed access of the database cursor on an in-memory SQLite connection:
+	`fetchInto()` into variables, tuples and bound fields, and `fetchColumns()` into per-column arrays
+*/
+
+struct User
+{
+	sl_int64 id;
+	String name;
+	double score;
+	sl_bool flagActive;
+	Memory avatar;
+	String missing;
+};
+
+static void Prepare(Database* db)
+{
+	TEST_CHECK(db->execute("CREATE TABLE users (id INTEGER, name TEXT, score REAL, active INTEGER, avatar BLOB)") >= 0);
+	for (sl_uint32 i = 0; i < 10; i++) {
+		sl_uint8 avatar[3] = { (sl_uint8)i, (sl_uint8)(i + 1), (sl_uint8)(i + 2) };
+		TEST_CHECK_EQUAL(db->execute("INSERT INTO users (id, name, score, active, avatar) VALUES (?, ?, ?, ?, ?)", (sl_int64)i + 10000000000LL, "user" + String::fromUint32(i), i * 0.5, i & 1, Memory::create(avatar, 3)), 1);
+	}
+}
+
+static void TestFetchValues(Database* db)
+{
+	Ref<DatabaseCursor> cursor = db->query("SELECT id, name, score, active, avatar, NULL FROM users ORDER BY id");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNull()) {
+		return;
+	}
+	sl_int64 id;
+	String name;
+	double score;
+	sl_bool flagActive;
+	Memory avatar;
+	Variant null;
+	sl_uint32 n = 0;
+	while (cursor->fetchInto(id, name, score, flagActive, avatar, null)) {
+		TEST_CHECK_EQUAL(id, (sl_int64)n + 10000000000LL);
+		TEST_CHECK_EQUAL(name, "user" + String::fromUint32(n));
+		TEST_CHECK_EQUAL(score, n * 0.5);
+		TEST_CHECK_EQUAL(flagActive, (n & 1) != 0);
+		TEST_CHECK(avatar.getSize() == 3 && ((sl_uint8*)(avatar.getData()))[2] == n + 2);
+		TEST_CHECK(null.isNull());
+		n++;
+	}
+	TEST_CHECK_EQUAL(n, 10);
+
+	// fewer variables than the columns
+	cursor = db->query("SELECT name, id FROM users WHERE id = ?", 10000000003LL);
+	TEST_CHECK(cursor.isNotNull() && cursor->fetchInto(name));
+	TEST_CHECK_EQUAL(name, "user3");
+
+	Tuple<sl_uint64, String, float> row(0, String(), 0.0f);
+	cursor = db->query("SELECT id, name, score FROM users WHERE id = ?", 10000000005LL);
+	TEST_CHECK(cursor.isNotNull() && cursor->fetchInto(row));
+	TEST_CHECK_EQUAL(row.m1, 10000000005ULL);
+	TEST_CHECK_EQUAL(row.m2, "user5");
+	TEST_CHECK_EQUAL(row.m3, 2.5f);
+	TEST_CHECK(!(cursor->fetchInto(row)));
+}
+
+static void TestBinding(Database* db)
+{
+	DatabaseRowBinding<User> binding;
+	binding.bind("id", &User::id).bind("name", &User::name).bind("score", &User::score).bind("active", &User::flagActive).bind("avatar", &User::avatar).bind("no_such_column", &User::missing);
+	for (sl_uint32 k = 0; k < 3; k++) {
+		// cached statement, and the different column orders
+		String sql = k == 2 ? "SELECT avatar, active, score, name, id FROM users WHERE id >= ? ORDER BY id" : "SELECT id, name, score, active, avatar FROM users WHERE id >= ? ORDER BY id";
+		Ref<DatabaseCursor> cursor = db->query(sql, 10000000004LL);
+		TEST_CHECK(cursor.isNotNull());
+		if (cursor.isNull()) {
+			return;
+		}
+		User user;
+		user.missing = "unchanged";
+		sl_uint32 n = 4;
+		while (cursor->fetchInto(binding, user)) {
+			TEST_CHECK_EQUAL(user.id, (sl_int64)n + 10000000000LL);
+			TEST_CHECK_EQUAL(user.name, "user" + String::fromUint32(n));
+			TEST_CHECK_EQUAL(user.score, n * 0.5);
+			TEST_CHECK_EQUAL(user.flagActive, (n & 1) != 0);
+			TEST_CHECK(user.avatar.getSize() == 3 && ((sl_uint8*)(user.avatar.getData()))[0] == n);
+			TEST_CHECK_EQUAL(user.missing, "unchanged");
+			n++;
+		}
+		TEST_CHECK_EQUAL(n, 10);
+	}
+}
+
+static void TestFetchColumns(Database* db)
+{
+	Ref<DatabaseCursor> cursor = db->query("SELECT id, name, score FROM users ORDER BY id");
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNull()) {
+		return;
+	}
+	sl_int64 ids[4];
+	String names[4];
+	double scores[4];
+	sl_uint32 nTotal = 0;
+	sl_uint32 counts[4] = { 0 };
+	sl_uint32 nChunks = 0;
+	for (;;) {
+		sl_uint32 n = cursor->fetchColumns(4, ids, names, scores);
+		if (!n) {
+			break;
+		}
+		for (sl_uint32 i = 0; i < n; i++) {
+			TEST_CHECK_EQUAL(ids[i], (sl_int64)(nTotal + i) + 10000000000LL);
+			TEST_CHECK_EQUAL(names[i], "user" + String::fromUint32(nTotal + i));
+			TEST_CHECK_EQUAL(scores[i], (nTotal + i) * 0.5);
+		}
+		if (nChunks < 4) {
+			counts[nChunks] = n;
+		}
+		nChunks++;
+		nTotal += n;
+	}
+	TEST_CHECK_EQUAL(nTotal, 10);
+	TEST_CHECK_EQUAL(nChunks, 3);
+	TEST_CHECK(counts[0] == 4 && counts[1] == 4 && counts[2] == 2);
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(":memory:");
+	TEST_CHECK(db.isNotNull());
+	if (db.isNotNull()) {
+		Prepare(db.get());
+		TestFetchValues(db.get());
+		TestBinding(db.get());
+		TestFetchColumns(db.get());
+	}
+	return TestResult("RowBinding");
+}
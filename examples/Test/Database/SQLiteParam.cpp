@@ -0,0 +1,184 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Connection settings of `SQLiteParam` on a temporary database file:
+	the pragmas applied at connect time, the busy handler retrying a locked database until the timeout, and read-only connections
+*/
+
+static String GetTempPath(const char* name)
+{
+	return System::getTempDirectory() + "/slib_test_" + name + "_" + String::fromUint32(System::getProcessId()) + ".db";
+}
+
+static void DeleteDatabaseFiles(const String& path)
+{
+	File::deleteFile(path);
+	File::deleteFile(path + "-wal");
+	File::deleteFile(path + "-shm");
+	File::deleteFile(path + "-journal");
+}
+
+static void TestPragmas()
+{
+	String path = GetTempPath("sqlite_param");
+	DeleteDatabaseFiles(path);
+	SQLiteParam param;
+	param.path = path;
+	param.journalMode = SQLiteJournalMode::WAL;
+	param.synchronousMode = SQLiteSynchronousMode::Normal;
+	param.mmapSize = 1 << 20;
+	param.cacheSize = -4096;
+	param.tempStore = SQLiteTempStore::Memory;
+	param.pragmas.add("PRAGMA foreign_keys=ON");
+	param.pragmas.add("PRAGMA user_version=7");
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(param);
+	TEST_CHECK(db.isNotNull());
+	if (db.isNotNull()) {
+		TEST_CHECK_EQUAL(db->getValueForQueryResult("PRAGMA journal_mode").getString(), "wal");
+		TEST_CHECK_EQUAL(db->getValueForQueryResult("PRAGMA synchronous").getInt32(), 1);
+		TEST_CHECK_EQUAL(db->getValueForQueryResult("PRAGMA mmap_size").getInt64(), 1 << 20);
+		TEST_CHECK_EQUAL(db->getValueForQueryResult("PRAGMA cache_size").getInt32(), -4096);
+		TEST_CHECK_EQUAL(db->getValueForQueryResult("PRAGMA temp_store").getInt32(), 2);
+		TEST_CHECK_EQUAL(db->getValueForQueryResult("PRAGMA foreign_keys").getInt32(), 1);
+		TEST_CHECK_EQUAL(db->getValueForQueryResult("PRAGMA user_version").getInt32(), 7);
+		db.setNull();
+	}
+	DeleteDatabaseFiles(path);
+}
+
+static void TestBusyTimeout()
+{
+	String path = GetTempPath("sqlite_busy");
+	DeleteDatabaseFiles(path);
+	Ref<SQLiteDatabase> holder = SQLiteDatabase::connect(path);
+	TEST_CHECK(holder.isNotNull());
+	if (holder.isNull()) {
+		return;
+	}
+	TEST_CHECK(holder->execute("CREATE TABLE t (a INTEGER)") >= 0);
+
+	SQLiteParam param;
+	param.path = path;
+	param.busyTimeout = 300;
+	param.busyBackoffMax = 20;
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(param);
+	TEST_CHECK(db.isNotNull());
+	if (db.isNull()) {
+		return;
+	}
+	db->setLoggingErrors(sl_false);
+
+	// gives up after the timeout while the lock is held
+	TEST_CHECK(holder->execute("BEGIN EXCLUSIVE") >= 0);
+	sl_uint64 t = System::getTickCount64();
+	TEST_CHECK(db->execute("INSERT INTO t (a) VALUES (1)") < 0);
+	sl_uint64 elapsed = System::getTickCount64() - t;
+	TEST_CHECK(elapsed >= 280);
+	TEST_CHECK(elapsed < 3000);
+
+	// succeeds once the lock is released while retrying
+	Ref<Thread> thread = Thread::start([holder]() {
+		Thread::sleep(100);
+		holder->execute("COMMIT");
+	});
+	TEST_CHECK(thread.isNotNull());
+	t = System::getTickCount64();
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (a) VALUES (2)"), 1);
+	elapsed = System::getTickCount64() - t;
+	TEST_CHECK(elapsed >= 50);
+	TEST_CHECK(elapsed < 300);
+	if (thread.isNotNull()) {
+		TEST_CHECK(thread->join(10000));
+	}
+	TEST_CHECK_EQUAL(holder->getValueForQueryResult("SELECT SUM(a) FROM t").getInt32(), 2);
+
+	// no retry without the timeout
+	SQLiteParam paramNoRetry;
+	paramNoRetry.path = path;
+	paramNoRetry.busyTimeout = 0;
+	Ref<SQLiteDatabase> dbNoRetry = SQLiteDatabase::connect(paramNoRetry);
+	TEST_CHECK(dbNoRetry.isNotNull());
+	if (dbNoRetry.isNotNull()) {
+		dbNoRetry->setLoggingErrors(sl_false);
+		TEST_CHECK(holder->execute("BEGIN EXCLUSIVE") >= 0);
+		t = System::getTickCount64();
+		TEST_CHECK(dbNoRetry->execute("INSERT INTO t (a) VALUES (3)") < 0);
+		TEST_CHECK(System::getTickCount64() - t < 100);
+		TEST_CHECK(holder->execute("COMMIT") >= 0);
+		dbNoRetry.setNull();
+	}
+	db.setNull();
+	holder.setNull();
+	DeleteDatabaseFiles(path);
+}
+
+static void TestReadonly()
+{
+	String path = GetTempPath("sqlite_readonly");
+	DeleteDatabaseFiles(path);
+	{
+		SQLiteParam param;
+		param.path = path;
+		param.flagCreate = sl_false;
+		param.flagReadonly = sl_true;
+		// not created by read-only connections
+		TEST_CHECK(SQLiteDatabase::connect(param).isNull());
+	}
+	Ref<SQLiteDatabase> writer = SQLiteDatabase::connect(path);
+	TEST_CHECK(writer.isNotNull());
+	if (writer.isNull()) {
+		return;
+	}
+	TEST_CHECK(writer->execute("CREATE TABLE t (a INTEGER)") >= 0);
+	TEST_CHECK_EQUAL(writer->execute("INSERT INTO t (a) VALUES (?)", 5), 1);
+	{
+		SQLiteParam param;
+		param.path = path;
+		param.flagCreate = sl_false;
+		param.flagReadonly = sl_true;
+		param.journalMode = SQLiteJournalMode::WAL;
+		Ref<SQLiteDatabase> reader = SQLiteDatabase::connect(param);
+		TEST_CHECK(reader.isNotNull());
+		if (reader.isNotNull()) {
+			reader->setLoggingErrors(sl_false);
+			// journal mode is not changed by read-only connections
+			TEST_CHECK_EQUAL(reader->getValueForQueryResult("PRAGMA journal_mode").getString(), "delete");
+			TEST_CHECK_EQUAL(reader->getValueForQueryResult("SELECT a FROM t").getInt32(), 5);
+			TEST_CHECK(reader->execute("INSERT INTO t (a) VALUES (?)", 6) < 0);
+		}
+	}
+	writer.setNull();
+	DeleteDatabaseFiles(path);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestPragmas();
+	TestBusyTimeout();
+	TestReadonly();
+	return TestResult("SQLiteParam");
+}
@@ -0,0 +1,127 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Prepared statement cache of the database on an in-memory SQLite connection:
+	hits and misses, nested queries, invalidation by the schema changes, and the counters read while executing
+*/
+
+static void TestHitMiss(Database* db)
+{
+	TEST_CHECK(db->execute("CREATE TABLE t (a INTEGER, b TEXT)") >= 0);
+	sl_uint64 nHits = db->getStatementCacheHitCount();
+	sl_uint64 nMisses = db->getStatementCacheMissCount();
+	for (sl_uint32 i = 0; i < 10; i++) {
+		TEST_CHECK_EQUAL(db->execute("INSERT INTO t (a, b) VALUES (?, ?)", i, String::fromUint32(i)), 1);
+	}
+	TEST_CHECK_EQUAL(db->getStatementCacheMissCount(), nMisses + 1);
+	TEST_CHECK_EQUAL(db->getStatementCacheHitCount(), nHits + 9);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT SUM(a) FROM t WHERE a >= ?", 0).getInt32(), 45);
+
+	// a statement used by a cursor is not shared by the nested query
+	nHits = db->getStatementCacheHitCount();
+	nMisses = db->getStatementCacheMissCount();
+	Ref<DatabaseCursor> cursor = db->query("SELECT a FROM t WHERE a < ? ORDER BY a", 5);
+	TEST_CHECK(cursor.isNotNull());
+	if (cursor.isNotNull()) {
+		sl_uint32 n = 0;
+		while (cursor->moveNext()) {
+			sl_int32 a = cursor->getInt32(0);
+			Variant b = db->getValueForQueryResult("SELECT a FROM t WHERE a < ? ORDER BY a", a + 1);
+			TEST_CHECK_EQUAL(b.getInt32(), 0);
+			n++;
+		}
+		TEST_CHECK_EQUAL(n, 5);
+		cursor.setNull();
+	}
+	TEST_CHECK_EQUAL(db->getStatementCacheMissCount(), nMisses + 6);
+	TEST_CHECK_EQUAL(db->getStatementCacheHitCount(), nHits);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT a FROM t WHERE a < ? ORDER BY a", 3).getInt32(), 0);
+	TEST_CHECK_EQUAL(db->getStatementCacheHitCount(), nHits + 1);
+
+	// the schema change clears the cache
+	TEST_CHECK(db->execute("CREATE TABLE u (c INTEGER)") >= 0);
+	nMisses = db->getStatementCacheMissCount();
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (a, b) VALUES (?, ?)", 10, "10"), 1);
+	TEST_CHECK_EQUAL(db->getStatementCacheMissCount(), nMisses + 1);
+
+	// disabled cache
+	db->setStatementCacheSize(0);
+	nHits = db->getStatementCacheHitCount();
+	nMisses = db->getStatementCacheMissCount();
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (a, b) VALUES (?, ?)", 11, "11"), 1);
+	TEST_CHECK_EQUAL(db->execute("INSERT INTO t (a, b) VALUES (?, ?)", 12, "12"), 1);
+	TEST_CHECK_EQUAL(db->getStatementCacheHitCount(), nHits);
+	TEST_CHECK_EQUAL(db->getStatementCacheMissCount(), nMisses);
+	TEST_CHECK_EQUAL(db->getValueForQueryResult("SELECT COUNT(*) FROM t").getInt32(), 13);
+	db->setStatementCacheSize(SLIB_DATABASE_STATEMENT_CACHE_SIZE_DEFAULT);
+}
+
+static void TestConcurrentCounters(Database* db)
+{
+	static const sl_uint32 nCalls = 2000;
+	sl_uint64 nTotal = db->getStatementCacheHitCount() + db->getStatementCacheMissCount();
+	sl_uint32 nSuccess = 0;
+	Ref<Thread> thread = Thread::start([db, &nSuccess]() {
+		for (sl_uint32 i = 0; i < nCalls; i++) {
+			if (db->getValueForQueryResult("SELECT ? + 1", i).getUint32() == i + 1) {
+				nSuccess++;
+			}
+		}
+	});
+	TEST_CHECK(thread.isNotNull());
+	if (thread.isNull()) {
+		return;
+	}
+	// the counters never go back while executing
+	sl_uint64 nHitsLast = 0;
+	sl_uint64 nMissesLast = 0;
+	sl_bool flagMonotonic = sl_true;
+	while (thread->isRunning()) {
+		sl_uint64 nHits = db->getStatementCacheHitCount();
+		sl_uint64 nMisses = db->getStatementCacheMissCount();
+		if (nHits < nHitsLast || nMisses < nMissesLast) {
+			flagMonotonic = sl_false;
+		}
+		nHitsLast = nHits;
+		nMissesLast = nMisses;
+	}
+	TEST_CHECK(thread->join(60000));
+	TEST_CHECK(flagMonotonic);
+	TEST_CHECK_EQUAL(nSuccess, nCalls);
+	TEST_CHECK_EQUAL(db->getStatementCacheHitCount() + db->getStatementCacheMissCount(), nTotal + nCalls);
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<SQLiteDatabase> db = SQLiteDatabase::connect(":memory:");
+	TEST_CHECK(db.isNotNull());
+	if (db.isNotNull()) {
+		TestHitMiss(db.get());
+		TestConcurrentCounters(db.get());
+	}
+	return TestResult("StatementCache");
+}
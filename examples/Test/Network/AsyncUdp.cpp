@@ -0,0 +1,124 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+using namespace slib;
+
+/*
+	Sending of the asynchronous UDP socket on the loopback interface, without and with batching:
+	single datagrams in order, and the segmented sends delivered as datagrams of the segment size,
+	by the kernel (UDP_SEGMENT) or split by the socket when they are over the GSO limits
+*/
+
+struct Expected
+{
+	sl_uint32 size;
+	sl_uint8 tag;
+};
+
+static Memory MakeData(sl_uint32 size, sl_uint8 tag)
+{
+	Memory mem = Memory::create(size);
+	if (mem.isNotNull()) {
+		sl_uint8* p = (sl_uint8*)(mem.getData());
+		for (sl_uint32 i = 0; i < size; i++) {
+			p[i] = (sl_uint8)(tag + i / 1000);
+		}
+	}
+	return mem;
+}
+
+static void TestSend(sl_uint32 batchSize)
+{
+	Ref<Socket> receiver = Socket::openUdp();
+	TEST_CHECK(receiver.isNotNull());
+	if (receiver.isNull()) {
+		return;
+	}
+	TEST_CHECK(receiver->bind(SocketAddress(IPv4Address(127, 0, 0, 1), 0)));
+	receiver->setOption_ReceiveBufferSize(4 << 20);
+	receiver->setOption_ReceiveTimeout(3000);
+	SocketAddress addressReceiver;
+	TEST_CHECK(receiver->getLocalAddress(addressReceiver));
+
+	AsyncUdpSocketParam param;
+	param.bindAddress = SocketAddress(IPv4Address(127, 0, 0, 1), 0);
+	param.batchSize = batchSize;
+	Ref<AsyncUdpSocket> sender = AsyncUdpSocket::create(param);
+	TEST_CHECK(sender.isNotNull());
+	if (sender.isNull()) {
+		return;
+	}
+
+	List<Expected> listExpected;
+	sl_uint32 nSingles = 100;
+	for (sl_uint32 i = 0; i < nSingles; i++) {
+		sl_uint8 tag = (sl_uint8)i;
+		sl_uint32 size = 10 + i;
+		TEST_CHECK(sender->sendTo(addressReceiver, MakeData(size, tag)));
+		listExpected.add_NoLock(Expected{size, tag});
+	}
+	// 10 full segments and a shorter last one
+	TEST_CHECK(sender->sendToSegments(addressReceiver, MakeData(10500, 200), 1000));
+	for (sl_uint32 i = 0; i < 11; i++) {
+		listExpected.add_NoLock(Expected{i < 10 ? 1000u : 500u, (sl_uint8)(200 + i)});
+	}
+	// over the GSO limits
+	TEST_CHECK(sender->sendToSegments(addressReceiver, MakeData(80000, 100), 1000));
+	for (sl_uint32 i = 0; i < 80; i++) {
+		listExpected.add_NoLock(Expected{1000, (sl_uint8)(100 + i)});
+	}
+	// a segment size not smaller than the data
+	TEST_CHECK(sender->sendToSegments(addressReceiver, MakeData(700, 50), 1000));
+	listExpected.add_NoLock(Expected{700, 50});
+
+	ListElements<Expected> expected(listExpected);
+	sl_uint8 buf[2048];
+	sl_size nReceived = 0;
+	sl_size nMismatch = 0;
+	while (nReceived < expected.count) {
+		SocketAddress address;
+		sl_int32 n = receiver->receiveFrom(address, buf, sizeof(buf));
+		if (n <= 0) {
+			break;
+		}
+		Expected& e = expected[nReceived];
+		if ((sl_uint32)n != e.size || buf[0] != e.tag || buf[n - 1] != (sl_uint8)(e.tag + (n - 1) / 1000)) {
+			if (nMismatch < 5) {
+				Println("batch %d: datagram %d mismatch, size=%d expected=%d", batchSize, (sl_uint32)nReceived, n, e.size);
+			}
+			nMismatch++;
+		}
+		nReceived++;
+	}
+	TEST_CHECK_EQUAL(nReceived, expected.count);
+	TEST_CHECK_EQUAL(nMismatch, 0);
+	sender->close();
+}
+
+int main(int argc, const char * argv[])
+{
+	TestSend(1);
+	TestSend(8);
+	return TestResult("AsyncUdp");
+}
@@ -0,0 +1,177 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "../test.h"
+
+#include <unistd.h>
+
+using namespace slib;
+
+/*
+	Sending through the TX ring of the packet ring capture (Linux) on the loopback device:
+	packets sent by `sendPackets()` and `sendPacket()` are captured in order, including the packets larger than
+	the ring frame (sent by the socket) and the batches larger than the ring.
+	Requires root (packet sockets), and skipped otherwise.
+*/
+
+#define TEST_PROTOCOL 0x88B5
+#define TEST_MAGIC 0x534C4942
+#define MAX_PACKETS 1024
+
+static Mutex g_lock;
+static sl_bool g_flagSeen[MAX_PACKETS];
+static sl_uint32 g_nSeen = 0;
+static sl_uint32 g_nOutOfOrder = 0;
+static sl_int32 g_seqLast = -1;
+
+static void OnCapture(NetCapture*, NetCapturePacket* packets, sl_uint32 count)
+{
+	MutexLocker lock(&g_lock);
+	for (sl_uint32 i = 0; i < count; i++) {
+		NetCapturePacket& packet = packets[i];
+		if (packet.length < EthernetFrame::HeaderSize + 8) {
+			continue;
+		}
+		EthernetFrame* frame = (EthernetFrame*)(packet.data);
+		if ((sl_uint32)(frame->getProtocol()) != TEST_PROTOCOL) {
+			continue;
+		}
+		sl_uint8* payload = packet.data + EthernetFrame::HeaderSize;
+		if (MIO::readUint32BE(payload) != TEST_MAGIC) {
+			continue;
+		}
+		sl_uint32 seq = MIO::readUint32BE(payload + 4);
+		if (seq >= MAX_PACKETS || g_flagSeen[seq]) {
+			// the loopback device delivers each packet twice (outgoing and incoming)
+			continue;
+		}
+		g_flagSeen[seq] = sl_true;
+		g_nSeen++;
+		if ((sl_int32)seq < g_seqLast) {
+			g_nOutOfOrder++;
+		}
+		g_seqLast = seq;
+	}
+}
+
+static Memory MakePacket(sl_uint32 seq, sl_uint32 size)
+{
+	Memory mem = Memory::create(size);
+	if (mem.isNotNull()) {
+		sl_uint8* p = (sl_uint8*)(mem.getData());
+		Base::zeroMemory(p, size);
+		EthernetFrame* frame = (EthernetFrame*)p;
+		frame->setProtocol((NetworkLinkProtocol)TEST_PROTOCOL);
+		MIO::writeUint32BE(p + EthernetFrame::HeaderSize, TEST_MAGIC);
+		MIO::writeUint32BE(p + EthernetFrame::HeaderSize + 4, seq);
+	}
+	return mem;
+}
+
+static sl_bool WaitSeen(sl_uint32 n)
+{
+	for (sl_uint32 i = 0; i < 300; i++) {
+		{
+			MutexLocker lock(&g_lock);
+			if (g_nSeen >= n) {
+				return sl_true;
+			}
+		}
+		Thread::sleep(10);
+	}
+	return sl_false;
+}
+
+int main(int argc, const char * argv[])
+{
+	if (geteuid() != 0 || Socket::openPacketRaw().isNull()) {
+		Println("PacketRing: skipped (requires root)");
+		return 0;
+	}
+
+	NetCaptureParam param;
+	param.deviceName = "lo";
+	param.sizeFrame = 2048;
+	param.countSendFrames = 32;
+	param.timeoutRead = 10;
+	param.onCapturePackets = &OnCapture;
+	Ref<NetCapture> capture = NetCapture::createPacketRing(param);
+	TEST_CHECK(capture.isNotNull());
+	if (capture.isNull()) {
+		return TestResult("PacketRing");
+	}
+	Thread::sleep(100);
+
+	sl_uint32 seq = 0;
+
+	// a batch in the ring, and a packet larger than the frame in the middle
+	{
+		Memory mems[20];
+		NetCapturePacket packets[20];
+		for (sl_uint32 i = 0; i < 20; i++) {
+			mems[i] = MakePacket(seq + i, i == 10 ? 3000 : 100 + i);
+			packets[i].data = (sl_uint8*)(mems[i].getData());
+			packets[i].length = (sl_uint32)(mems[i].getSize());
+		}
+		TEST_CHECK_EQUAL(capture->sendPackets(packets, 20), 20);
+		seq += 20;
+	}
+	TEST_CHECK(WaitSeen(seq));
+
+	// single packets
+	for (sl_uint32 i = 0; i < 5; i++) {
+		Memory mem = MakePacket(seq, 60);
+		TEST_CHECK(capture->sendPacket(mem.getData(), (sl_uint32)(mem.getSize())));
+		seq++;
+	}
+	TEST_CHECK(WaitSeen(seq));
+
+	// a batch larger than the ring: the rest is sent again when the ring is full
+	{
+		static const sl_uint32 n = 200;
+		Memory mems[n];
+		NetCapturePacket packets[n];
+		for (sl_uint32 i = 0; i < n; i++) {
+			mems[i] = MakePacket(seq + i, 64);
+			packets[i].data = (sl_uint8*)(mems[i].getData());
+			packets[i].length = 64;
+		}
+		sl_uint32 nSent = 0;
+		for (sl_uint32 k = 0; k < 1000 && nSent < n; k++) {
+			nSent += capture->sendPackets(packets + nSent, n - nSent);
+			if (nSent < n) {
+				Thread::sleep(1);
+			}
+		}
+		TEST_CHECK_EQUAL(nSent, n);
+		seq += n;
+	}
+	TEST_CHECK(WaitSeen(seq));
+
+	{
+		MutexLocker lock(&g_lock);
+		TEST_CHECK_EQUAL(g_nSeen, seq);
+		TEST_CHECK_EQUAL(g_nOutOfOrder, 0);
+	}
+	capture->release();
+	return TestResult("PacketRing");
+}
@@ -0,0 +1,64 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_EXAMPLE_TEST
+#define CHECKHEADER_SLIB_EXAMPLE_TEST
+
+/*
+	Minimal checking helpers shared by the test programs.
+	Each program returns non-zero when any check fails, so they can be run by CTest.
+*/
+
+#include <slib.h>
+
+static sl_uint32 g_nTestChecks = 0;
+static sl_uint32 g_nTestFailures = 0;
+
+#define TEST_CHECK(EXPR) \
+	do { \
+		g_nTestChecks++; \
+		if (!(EXPR)) { \
+			g_nTestFailures++; \
+			slib::Println("%s:%d: check failed: %s", __FILE__, __LINE__, #EXPR); \
+		} \
+	} while (0)
+
+#define TEST_CHECK_EQUAL(A, B) \
+	do { \
+		g_nTestChecks++; \
+		if (!((A) == (B))) { \
+			g_nTestFailures++; \
+			slib::Println("%s:%d: check failed: %s == %s (%s != %s)", __FILE__, __LINE__, #A, #B, slib::Variant(A).getString(), slib::Variant(B).getString()); \
+		} \
+	} while (0)
+
+static int TestResult(const char* name)
+{
+	if (g_nTestFailures) {
+		slib::Println("%s: %d of %d checks failed", name, g_nTestFailures, g_nTestChecks);
+		return 1;
+	}
+	slib::Println("%s: %d checks passed", name, g_nTestChecks);
+	return 0;
+}
+
+#endif
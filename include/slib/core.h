@@ -52,6 +52,8 @@
 #include "core/mutex.h"
 #include "core/string.h"
 #include "core/string_buffer.h"
+#include "core/string_format.h"
+#include "core/string_pool.h"
 #include "core/memory.h"
 #include "core/time.h"
 #include "core/variant.h"
@@ -101,6 +103,7 @@
 #include "core/content_type.h"
 #include "core/locale.h"
 #include "core/charset.h"
+#include "core/cpu.h"
 #include "core/parse.h"
 #include "core/resource.h"
 #include "core/preference.h"
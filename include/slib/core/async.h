@@ -773,6 +773,49 @@ namespace slib
 	
 	
 #define SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE 16384
+#define SLIB_ASYNC_STREAM_FILTER_BUFFER_POOL_SIZE 8
+	
+	/*
+		Output of the conversion in `AsyncStreamFilter`.
+
+		The converted data is written into pooled buffers (`SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE` bytes),
+		and is appended to the queue without copy. A buffer is reused after the reader (or the source stream)
+		released all the data in it, so a filter doesn't allocate memory per chunk, and keeps at most
+		`SLIB_ASYNC_STREAM_FILTER_BUFFER_POOL_SIZE` buffers for each direction.
+	*/
+	class SLIB_EXPORT AsyncStreamFilterOutput
+	{
+	public:
+		AsyncStreamFilterOutput(MemoryQueue* queue);
+
+		~AsyncStreamFilterOutput();
+
+	public:
+		// returns the free space of the current buffer, moving to a new buffer when less than `sizeMin` bytes are free
+		void* getBuffer(sl_uint32& sizeAvailable, sl_uint32 sizeMin = 1);
+
+		// marks `size` bytes of the buffer returned by `getBuffer()` as written
+		void commit(sl_uint32 size);
+
+		sl_bool write(const void* data, sl_uint32 size);
+
+		// appends the memory without copy
+		sl_bool add(const Memory& mem);
+
+		// appends the committed data to the queue
+		sl_bool flush();
+
+	private:
+		Memory _getFreeBuffer();
+
+	private:
+		MemoryQueue* m_queue;
+		Memory m_pool[SLIB_ASYNC_STREAM_FILTER_BUFFER_POOL_SIZE];
+		Memory m_buffer;
+		sl_uint32 m_sizeWritten;
+		sl_uint32 m_sizeQueued;
+
+	};
 	
 	class SLIB_EXPORT AsyncStreamFilter : public AsyncStream
 	{
@@ -822,6 +865,14 @@ namespace slib
 		virtual Memory filterRead(void* data, sl_uint32 size, Referable* userObject);
 
 		virtual Memory filterWrite(const void* data, sl_uint32 size, Referable* userObject);
+
+		/*
+			Converts the data and writes the result to `output`. Returns `sl_false` on error.
+			Default implementations add the memory returned by `filterRead()` and `filterWrite()`.
+		*/
+		virtual sl_bool convertRead(void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output);
+
+		virtual sl_bool convertWrite(const void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output);
 	
 	protected:
 		void setReadingError();
@@ -848,10 +899,19 @@ namespace slib
 		Mutex m_lockWriting;
 		sl_bool m_flagWritingError;
 		sl_bool m_flagWritingEnded;
+		MemoryQueue m_bufWriteConverted;
+
+		AsyncStreamFilterOutput m_outputRead;
+		AsyncStreamFilterOutput m_outputWrite;
 	
 	protected:
 		sl_bool _read();
 
+		// writes the data in `m_outputWrite` to the source stream, `callback` receives `size` after the last part is written. `m_lockWriting` should be locked
+		sl_bool _writeConvertedData(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject);
+
+		sl_bool _completeReadRequests();
+
 		void _closeAllReadRequests();
 	
 	protected:
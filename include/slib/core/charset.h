@@ -50,6 +50,19 @@ namespace slib
 		static sl_size utf16ToUtf32(const sl_char16* utf16, sl_reg lenUtf16, sl_char32* utf32, sl_reg lenUtf32Buffer);
 
 		static sl_size utf32ToUtf16(const sl_char32* utf32, sl_reg lenUtf32, sl_char16* utf16, sl_reg lenUtf16Buffer);
+		
+		// rejects overlong forms, surrogates, code points above U+10FFFF and truncated sequences
+		static sl_bool isValidUtf8(const sl_char8* utf8, sl_size len);
+		
+		// rejects unpaired surrogates
+		static sl_bool isValidUtf16(const sl_char16* utf16, sl_size len);
+		
+		// Strict converters: return -1 when the source is not well-formed
+		static sl_reg utf8ToUtf16Strict(const sl_char8* utf8, sl_reg lenUtf8, sl_char16* utf16, sl_reg lenUtf16Buffer);
+		
+		static sl_reg utf8ToUtf32Strict(const sl_char8* utf8, sl_reg lenUtf8, sl_char32* utf32, sl_reg lenUtf32Buffer);
+		
+		static sl_reg utf16ToUtf8Strict(const sl_char16* utf16, sl_reg lenUtf16, sl_char8* utf8, sl_reg lenUtf8Buffer);
 
 	};
 
@@ -49,6 +49,13 @@ namespace slib
 		sl_bool operator()(const T1& a, const T2& b) const noexcept;
 	};
 
+	/*
+		Enables the lookup of the containers keyed by `KT` with the keys of `KEY` type, without constructing `KT` objects.
+		Specialized for the pairs such as (`String`, `StringView`), and `Type` is defined as `RET` for them.
+	*/
+	template <class KT, class KEY, class RET>
+	struct EnableIfLookupKey {};
+
 }
 
 #include "detail/compare.inc"
@@ -0,0 +1,98 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CORE_CPU
+#define CHECKHEADER_SLIB_CORE_CPU
+
+#include "definition.h"
+
+/*
+	SIMD code paths
+
+	SLIB_CPU_SUPPORT_SIMD_X86: x86 intrinsics (SSE ~ AVX-512) are available for the functions declared with SLIB_CPU_TARGET(),
+		and the functions should be called only after checking the features at runtime by `Cpu` class.
+	SLIB_CPU_SUPPORT_SIMD_NEON: AArch64 NEON intrinsics are always available
+*/
+
+#if (defined(SLIB_ARCH_IS_X64) || defined(SLIB_ARCH_IS_X86)) && !defined(EMSCRIPTEN) && (defined(SLIB_COMPILER_IS_VC) || defined(SLIB_COMPILER_IS_GCC))
+#	define SLIB_CPU_SUPPORT_SIMD_X86
+#endif
+
+#if defined(SLIB_ARCH_IS_ARM64) && defined(SLIB_ARCH_IS_LITTLE_ENDIAN)
+#	define SLIB_CPU_SUPPORT_SIMD_NEON
+#endif
+
+#if defined(SLIB_COMPILER_IS_GCC)
+#	define SLIB_CPU_TARGET(FEATURES) __attribute__((target(FEATURES)))
+#else
+#	define SLIB_CPU_TARGET(FEATURES)
+#endif
+
+namespace slib
+{
+	
+	class SLIB_EXPORT Cpu
+	{
+	public:
+		// x86, x64
+		static sl_bool isSSE2Supported() noexcept;
+		
+		static sl_bool isSSSE3Supported() noexcept;
+		
+		static sl_bool isSSE41Supported() noexcept;
+		
+		static sl_bool isSSE42Supported() noexcept;
+		
+		static sl_bool isAVX2Supported() noexcept;
+		
+		// AVX-512 F, BW, VL
+		static sl_bool isAVX512Supported() noexcept;
+		
+		static sl_bool isAESNISupported() noexcept;
+		
+		static sl_bool isPCLMULQDQSupported() noexcept;
+		
+		// VAES and VPCLMULQDQ
+		static sl_bool isVAESSupported() noexcept;
+		
+		static sl_bool isSHANISupported() noexcept;
+		
+		
+		// ARM, ARM64
+		static sl_bool isNEONSupported() noexcept;
+		
+		static sl_bool isARMv8AESSupported() noexcept;
+		
+		static sl_bool isARMv8PMULLSupported() noexcept;
+		
+		static sl_bool isARMv8SHA1Supported() noexcept;
+		
+		static sl_bool isARMv8SHA2Supported() noexcept;
+		
+		static sl_bool isARMv8CRC32Supported() noexcept;
+		
+	};
+
+}
+
+#endif
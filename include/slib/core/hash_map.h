@@ -192,6 +192,44 @@ namespace slib
 		
 		List<VT> getValues(const KT& key) const noexcept;
 		
+		/*
+			Lookup by the key of a different type (for example, `StringView` for the `String` keys) without converting it to `KT`.
+			Enabled for the types specialized by `EnableIfLookupKey`.
+		*/
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, NODE*>::Type find_NoLock(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, sl_bool>::Type find(const KEY& key) const noexcept;
+		
+		/* unsynchronized function */
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT*>::Type getItemPointer(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, sl_bool>::Type get_NoLock(const KEY& key, VT* _out = sl_null) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, sl_bool>::Type get(const KEY& key, VT* _out = sl_null) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue_NoLock(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue_NoLock(const KEY& key, const VT& def) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue(const KEY& key, const VT& def) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, List<VT> >::Type getValues_NoLock(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, List<VT> >::Type getValues(const KEY& key) const noexcept;
+		
 		template < class VALUE, class VALUE_EQUALS = Equals<VT, VALUE> >
 		List<VT> getValuesByKeyAndValue_NoLock(const KT& key, const VALUE& value, const VALUE_EQUALS& value_equals = VALUE_EQUALS()) const noexcept;
 		
@@ -317,6 +355,9 @@ namespace slib
 		
 		NODE* _getEntry(const KT& key) const noexcept;
 		
+		template <class KEY>
+		NODE* _getEntryByKey(const KEY& key) const noexcept;
+		
 		NODE** _getEntryPtr(const KT& key) noexcept;
 		
         void _linkNode(NODE* node, sl_size hash) noexcept;
@@ -448,6 +489,44 @@ namespace slib
 		
 		List<VT> getValues(const KT& key) const noexcept;
 		
+		/*
+			Lookup by the key of a different type (for example, `StringView` for the `String` keys) without converting it to `KT`.
+			Enabled for the types specialized by `EnableIfLookupKey`.
+		*/
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, NODE*>::Type find_NoLock(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, sl_bool>::Type find(const KEY& key) const noexcept;
+		
+		/* unsynchronized function */
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT*>::Type getItemPointer(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, sl_bool>::Type get_NoLock(const KEY& key, VT* _out = sl_null) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, sl_bool>::Type get(const KEY& key, VT* _out = sl_null) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue_NoLock(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue_NoLock(const KEY& key, const VT& def) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, VT>::Type getValue(const KEY& key, const VT& def) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, List<VT> >::Type getValues_NoLock(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<KT, KEY, List<VT> >::Type getValues(const KEY& key) const noexcept;
+		
 		template < class VALUE, class VALUE_EQUALS = Equals<VT, VALUE> >
 		List<VT> getValuesByKeyAndValue_NoLock(const KT& key, const VALUE& value, const VALUE_EQUALS& value_equals = VALUE_EQUALS()) const noexcept;
 		
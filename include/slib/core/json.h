@@ -46,6 +46,8 @@ namespace slib
 		sl_bool flagSupportComments;
 		// in
 		sl_bool flagLogError;
+		// in, shares the object keys already interned in the default `StringPool` (for example, by `AtomString`), so that the parsed documents share the key strings. Unknown keys are never added to the pool, so that untrusted input can't grow it
+		sl_bool flagInternKeys;
 
 		// out
 		sl_bool flagError;
@@ -68,6 +68,12 @@ namespace slib
 	template <class T>
 	sl_bool Parse(const AtomicString16& _str, T* _out) noexcept;
 	
+	template <class T>
+	sl_bool Parse(const StringView& str, T* _out) noexcept;
+	
+	template <class T>
+	sl_bool Parse(const StringView16& str, T* _out) noexcept;
+	
 	template <class T>
 	sl_bool Parse(const sl_char8* sz, T* _out) noexcept;
 
@@ -87,6 +93,12 @@ namespace slib
 	template <class T, class ArgType>
 	sl_bool Parse(const AtomicString16& _str, const ArgType& arg, T* _out) noexcept;
 	
+	template <class T, class ArgType>
+	sl_bool Parse(const StringView& str, const ArgType& arg, T* _out) noexcept;
+	
+	template <class T, class ArgType>
+	sl_bool Parse(const StringView16& str, const ArgType& arg, T* _out) noexcept;
+	
 	template <class T, class ArgType>
 	sl_bool Parse(const sl_char8* sz, const ArgType& arg, T* _out) noexcept;
 	
@@ -106,6 +118,12 @@ namespace slib
 	template <class T>
 	sl_bool ParseInt(const AtomicString16& _str, T* _out, sl_uint32 radix = 10) noexcept;
 
+	template <class T>
+	sl_bool ParseInt(const StringView& str, T* _out, sl_uint32 radix = 10) noexcept;
+
+	template <class T>
+	sl_bool ParseInt(const StringView16& str, T* _out, sl_uint32 radix = 10) noexcept;
+
 	template <class T>
 	sl_bool ParseInt(const sl_char8* sz, T* _out, sl_uint32 radix = 10) noexcept;
 
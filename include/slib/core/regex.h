@@ -27,6 +27,7 @@
 
 #include "object.h"
 #include "string.h"
+#include "list.h"
 
 namespace slib
 {
@@ -74,7 +75,54 @@ namespace slib
 		};
 	};
 	
-	class CRegEx : public Object
+	/*
+		Result of `match` and `search`.
+		Group 0 is the whole match, and the groups 1~ are the capturing groups of the pattern.
+		The views returned by `getGroup` refer to the subject string passed to the matching function.
+	*/
+	class SLIB_EXPORT RegExMatchResult
+	{
+	public:
+		RegExMatchResult() noexcept;
+		
+		~RegExMatchResult() noexcept;
+		
+	public:
+		// including the whole match
+		sl_uint32 getGroupCount() const noexcept;
+		
+		// returns sl_false if the group didn't participate in the match
+		sl_bool isMatched(sl_uint32 index) const noexcept;
+		
+		// returns -1 if the group didn't participate in the match
+		sl_reg getStart(sl_uint32 index) const noexcept;
+		
+		// returns -1 if the group didn't participate in the match
+		sl_reg getEnd(sl_uint32 index) const noexcept;
+		
+		StringView getGroup(sl_uint32 index) const noexcept;
+		
+		String getGroupString(sl_uint32 index) const noexcept;
+		
+	private:
+		const sl_char8* m_subject;
+		List<sl_reg> m_positions;
+		
+		friend class CRegEx;
+		
+	};
+	
+	class _priv_RegEx_Program;
+	
+	/*
+		Patterns in ECMAScript grammar (default) are compiled by the native engine which
+		guarantees the matching time linear in the length of the subject (Thompson NFA simulated
+		with the captures, and lazily built DFA for the matching without captures).
+		Backreferences, lookarounds and the other grammars (`Basic`, `Extended`, `Awk`, `Grep`, `Egrep`)
+		are handled by `std::regex`.
+		The compiled patterns are cached by the pattern string and the flags.
+	*/
+	class SLIB_EXPORT CRegEx : public Object
 	{
 		SLIB_DECLARE_OBJECT
 		
@@ -89,12 +137,24 @@ namespace slib
 		static Ref<CRegEx> create(const String& pattern, const RegExFlags& flags) noexcept;
 
 	public:
-		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		// returns sl_true if the whole string matches the pattern
+		sl_bool match(const StringView& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool match(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		// finds the leftmost match in the string
+		sl_bool search(const StringView& str, RegExMatchResult* outResult = sl_null, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		// number of the capturing groups in the pattern
+		sl_uint32 getGroupCount() noexcept;
 		
 	private:
 		static Ref<CRegEx> _create(const String& pattern, int flags) noexcept;
 		
+		sl_bool _matchStd(const StringView& str, RegExMatchResult* outResult, sl_bool flagSearch, const RegExMatchFlags& flags) noexcept;
+		
 	private:
+		_priv_RegEx_Program* m_program;
 		void* m_obj;
 		
 	};
@@ -112,7 +172,11 @@ namespace slib
 		Atomic(const String& pattern, const RegExFlags& flags) noexcept;
 		
 	public:
-		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		sl_bool match(const StringView& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool match(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool search(const StringView& str, RegExMatchResult* outResult = sl_null, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
 
 	private:
 		AtomicRef<CRegEx> ref;
@@ -132,10 +196,14 @@ namespace slib
 		RegEx(const String& pattern, const RegExFlags& flags) noexcept;
 				
 	public:
-		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		sl_bool match(const StringView& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool match(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool search(const StringView& str, RegExMatchResult* outResult = sl_null, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
 		
 	public:
-		static sl_bool matchEmail(const String& str) noexcept;
+		static sl_bool matchEmail(const StringView& str) noexcept;
 
 	private:
 		Ref<CRegEx> ref;
@@ -57,7 +57,7 @@ namespace slib
 	class SLIB_EXPORT SettingUtil
 	{
 	public:
-		static sl_bool parseUint32Range(const String& str, sl_uint32* from = sl_null, sl_uint32* to = sl_null);
+		static sl_bool parseUint32Range(const StringView& str, sl_uint32* from = sl_null, sl_uint32* to = sl_null);
 	
 	};
 
@@ -42,6 +42,7 @@
 
 #include "string8.h"
 #include "string16.h"
+#include "string_view.h"
 
 namespace slib
 {
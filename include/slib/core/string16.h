@@ -47,6 +47,8 @@ namespace slib
 	class String16;
 	typedef Atomic<String16> AtomicString16;
 	class StringData;
+	class StringView;
+	class StringView16;
 	class Variant;
 
 	class SLIB_EXPORT StringContainer16
@@ -127,6 +129,11 @@ namespace slib
 		String16(const wchar_t* str, sl_reg length) noexcept;
 		String16(const char32_t* str, sl_reg length) noexcept;
 
+		/**
+		 * Copies the characters referred by `str`
+		 */
+		explicit String16(const StringView16& str) noexcept;
+
 #ifdef SLIB_SUPPORT_STD_TYPES
 		/**
 		 * Initialize from `std::u16string`.
@@ -1995,6 +2002,12 @@ namespace slib
 	{
 	public:
 		int operator()(const String16& a, const String16& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String16, KEY, int>::Type operator()(const String16& a, const KEY& b) const noexcept
+		{
+			return -(b.compare(a));
+		}
 	};
 	
 	template <>
@@ -2009,6 +2022,12 @@ namespace slib
 	{
 	public:
 		sl_bool operator()(const String16& a, const String16& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String16, KEY, sl_bool>::Type operator()(const String16& a, const KEY& b) const noexcept
+		{
+			return b.equals(a);
+		}
 	};
 	
 	template <>
@@ -2023,6 +2042,12 @@ namespace slib
 	{
 	public:
 		sl_size operator()(const String16& a) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String16, KEY, sl_size>::Type operator()(const KEY& a) const noexcept
+		{
+			return a.getHashCode();
+		}
 	};
 	
 	template <>
@@ -2036,12 +2061,24 @@ namespace slib
 	{
 	public:
 		int operator()(const String16& a, const String16& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String16, KEY, int>::Type operator()(const String16& a, const KEY& b) const noexcept
+		{
+			return -(b.compareIgnoreCase(a));
+		}
 	};
 	
 	class EqualsIgnoreCaseString16
 	{
 	public:
 		sl_bool operator()(const String16& a, const String16& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String16, KEY, sl_bool>::Type operator()(const String16& a, const KEY& b) const noexcept
+		{
+			return b.equalsIgnoreCase(a);
+		}
 	};
 	
 	class HashIgnoreCaseString16
@@ -2049,6 +2086,12 @@ namespace slib
 	public:
 		sl_size operator()(const String16& v) const noexcept;
 		
+		template <class KEY>
+		typename EnableIfLookupKey<String16, KEY, sl_size>::Type operator()(const KEY& v) const noexcept
+		{
+			return v.getHashCodeIgnoreCase();
+		}
+		
 	};
 
 }
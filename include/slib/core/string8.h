@@ -47,6 +47,8 @@ namespace slib
 	class String16;
 	typedef Atomic<String16> AtomicString16;
 	class StringData;
+	class StringView;
+	class StringView16;
 	class Variant;
 
 	class SLIB_EXPORT StringContainer
@@ -125,6 +127,11 @@ namespace slib
 		String(const char16_t* str, sl_reg length) noexcept;
 		String(const char32_t* str, sl_reg length) noexcept;
 
+		/**
+		 * Copies the characters referred by `str`
+		 */
+		explicit String(const StringView& str) noexcept;
+
 #ifdef SLIB_SUPPORT_STD_TYPES
 		/**
 		 * Initialize from `std::string`.
@@ -1165,6 +1172,16 @@ namespace slib
 		 */
 		static String fromDouble(double value, sl_int32 precision = -1, sl_bool flagZeroPadding = sl_false, sl_uint32 minWidthIntegral = 1) noexcept;
 		
+		/**
+		 * Writes the same characters as `fromDouble(value)` without allocating a string.
+		 *
+		 * @param value The double value to be written.
+		 * @param output The buffer to receive the characters. Must have at least 64 characters.
+		 *
+		 * @return the number of the written characters.
+		 */
+		static sl_size fromDouble(double value, sl_char8* output) noexcept;
+		
 		/**
 		 * @return the string representation of the memory address.
 		 *
@@ -2023,6 +2040,12 @@ namespace slib
 	{
 	public:
 		int operator()(const String& a, const String& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String, KEY, int>::Type operator()(const String& a, const KEY& b) const noexcept
+		{
+			return -(b.compare(a));
+		}
 	};
 	
 	template <>
@@ -2037,6 +2060,12 @@ namespace slib
 	{
 	public:
 		sl_bool operator()(const String& a, const String& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String, KEY, sl_bool>::Type operator()(const String& a, const KEY& b) const noexcept
+		{
+			return b.equals(a);
+		}
 	};
 	
 	template <>
@@ -2051,6 +2080,12 @@ namespace slib
 	{
 	public:
 		sl_size operator()(const String& a) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String, KEY, sl_size>::Type operator()(const KEY& a) const noexcept
+		{
+			return a.getHashCode();
+		}
 	};
 	
 	template <>
@@ -2064,12 +2099,24 @@ namespace slib
 	{
 	public:
 		int operator()(const String& a, const String& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String, KEY, int>::Type operator()(const String& a, const KEY& b) const noexcept
+		{
+			return -(b.compareIgnoreCase(a));
+		}
 	};
 	
 	class EqualsIgnoreCaseString
 	{
 	public:
 		sl_bool operator()(const String& a, const String& b) const noexcept;
+		
+		template <class KEY>
+		typename EnableIfLookupKey<String, KEY, sl_bool>::Type operator()(const String& a, const KEY& b) const noexcept
+		{
+			return b.equalsIgnoreCase(a);
+		}
 	};
 	
 	class HashIgnoreCaseString
@@ -2077,6 +2124,12 @@ namespace slib
 	public:
 		sl_size operator()(const String& v) const noexcept;
 		
+		template <class KEY>
+		typename EnableIfLookupKey<String, KEY, sl_size>::Type operator()(const KEY& v) const noexcept
+		{
+			return v.getHashCodeIgnoreCase();
+		}
+		
 	};
 
 }
@@ -0,0 +1,245 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CORE_STRING_FORMAT
+#define CHECKHEADER_SLIB_CORE_STRING_FORMAT
+
+#include "definition.h"
+
+#include "string.h"
+#include "string_buffer.h"
+#include "time.h"
+#include "base.h"
+
+/*
+	Type-safe string formatting with the format string parsed at compile time.
+
+	The format string uses the syntax of `String::format`
+
+		%[argument_index$][flags][width][.precision]conversion
+
+	but it is parsed by constexpr functions while compiling, and the conversions are
+	checked against the types of the arguments. Mismatched conversions, wrong number
+	of arguments and malformed specifications are reported by `static_assert`.
+	The arguments are written directly into a stack buffer without `Variant` boxing.
+
+	Usage:
+
+		String s = SLIB_FORMAT("%s [%s] %d", Time::now(), tag, count);
+
+	Supported argument types and conversions:
+
+		integral types		d, x, X, o, c
+		float, double		f, e, E, g, G
+		sl_bool				s, d
+		strings				s (`String`, `AtomicString`, `String16`, `StringView`, `sl_char8*` and char arrays)
+		Time				y, m, d, w, W, H, M, S, l, D, T, s, with optional `u`/`U` prefix for UTC
+
+	Other types can be supported by specializing `StringFormatArg<T>`.
+*/
+
+namespace slib
+{
+
+	class SLIB_EXPORT StringFormatFlags
+	{
+	public:
+		enum {
+			AlignLeft = 1, // '-'
+			SignPositive = 2, // '+'
+			LeadingSpacePositive = 4, // ' '
+			ZeroPadded = 8, // '0'
+			GroupingDigits = 16, // ','
+			EncloseNegative = 32 // '('
+		};
+	};
+	
+	// A segment of the format string: literal text followed by a conversion specification
+	class SLIB_EXPORT StringFormatSpec
+	{
+	public:
+		// position and length of the literal text before the specification
+		sl_uint32 posText;
+		sl_uint32 lenText;
+		// position just after the specification
+		sl_uint32 posNext;
+		// conversion character: 0 at the end of the format, '%' and 'n' for the escapes
+		sl_char8 conversion;
+		sl_bool flagUtc;
+		sl_bool flagError;
+		sl_bool flagUsePrecision;
+		sl_uint32 argIndex;
+		sl_uint32 argIndexAuto;
+		sl_uint32 flags;
+		sl_uint32 minWidth;
+		sl_uint32 precision;
+		
+	public:
+		constexpr StringFormatSpec(sl_uint32 _posText, sl_uint32 _lenText, sl_uint32 _posNext, sl_char8 _conversion, sl_bool _flagUtc, sl_bool _flagError, sl_uint32 _argIndex, sl_uint32 _argIndexAuto, sl_uint32 _flags, sl_uint32 _minWidth, sl_bool _flagUsePrecision, sl_uint32 _precision) noexcept
+		: posText(_posText), lenText(_lenText), posNext(_posNext), conversion(_conversion), flagUtc(_flagUtc), flagError(_flagError), flagUsePrecision(_flagUsePrecision), argIndex(_argIndex), argIndexAuto(_argIndexAuto), flags(_flags), minWidth(_minWidth), precision(_precision)
+		{}
+		
+	public:
+		constexpr sl_bool isArgument() const noexcept
+		{
+			return conversion != 0 && conversion != '%' && conversion != 'n';
+		}
+		
+		constexpr sl_bool hasFlag(sl_uint32 flag) const noexcept
+		{
+			return (flags & flag) != 0;
+		}
+		
+	};
+	
+	class SLIB_EXPORT StringFormatWriter
+	{
+	public:
+		StringFormatWriter() noexcept;
+		
+		~StringFormatWriter() noexcept;
+		
+		StringFormatWriter(const StringFormatWriter&) = delete;
+		
+		StringFormatWriter& operator=(const StringFormatWriter&) = delete;
+		
+	public:
+		SLIB_INLINE const sl_char8* getData() const noexcept
+		{
+			return m_data;
+		}
+		
+		SLIB_INLINE sl_size getLength() const noexcept
+		{
+			return m_length;
+		}
+		
+		SLIB_INLINE void write(const sl_char8* str, sl_size len) noexcept
+		{
+			if (m_length + len <= m_capacity) {
+				Base::copyMemory(m_data + m_length, str, len);
+				m_length += len;
+			} else {
+				_writeSlow(str, len);
+			}
+		}
+		
+		SLIB_INLINE void write(sl_char8 ch) noexcept
+		{
+			if (m_length < m_capacity) {
+				m_data[m_length++] = ch;
+			} else {
+				_writeSlow(&ch, 1);
+			}
+		}
+		
+		void writeRepeat(sl_char8 ch, sl_size count) noexcept;
+		
+		// applies `minWidth` and `AlignLeft` flag of the specification
+		void writeAligned(const sl_char8* str, sl_size len, const StringFormatSpec& spec) noexcept;
+		
+		void writeString(const StringView& str, const StringFormatSpec& spec) noexcept;
+		
+		void writeInt32(sl_int32 value, const StringFormatSpec& spec) noexcept;
+		
+		void writeUint32(sl_uint32 value, const StringFormatSpec& spec) noexcept;
+		
+		void writeInt64(sl_int64 value, const StringFormatSpec& spec) noexcept;
+		
+		void writeUint64(sl_uint64 value, const StringFormatSpec& spec) noexcept;
+		
+		void writeFloat(float value, const StringFormatSpec& spec) noexcept;
+		
+		void writeDouble(double value, const StringFormatSpec& spec) noexcept;
+		
+		void writeBoolean(sl_bool value, const StringFormatSpec& spec) noexcept;
+		
+		void writeTime(const Time& value, const StringFormatSpec& spec) noexcept;
+		
+		String toString() const noexcept;
+		
+	private:
+		void _writeSlow(const sl_char8* str, sl_size len) noexcept;
+		
+		sl_bool _reserve(sl_size size) noexcept;
+		
+	private:
+		sl_char8* m_data;
+		sl_size m_length;
+		sl_size m_capacity;
+		sl_char8 m_buf[256];
+		
+	};
+	
+	/*
+		Specialize this class for the custom argument types:
+
+			static constexpr sl_bool accept(sl_char8 conversion, sl_bool flagUtc) noexcept;
+			static void write(StringFormatWriter& writer, const T& value, const StringFormatSpec& spec) noexcept;
+	*/
+	template <class T>
+	class StringFormatArg
+	{
+	public:
+		static constexpr sl_bool accept(sl_char8 conversion, sl_bool flagUtc) noexcept
+		{
+			return sl_false;
+		}
+		
+	};
+	
+	class SLIB_EXPORT StringFormat
+	{
+	public:
+		// `FORMAT` is the type created by `SLIB_FORMAT_STRING`
+		template <class FORMAT, class... ARGS>
+		static String format(const FORMAT& format, const ARGS&... args) noexcept;
+		
+		template <class FORMAT, class... ARGS>
+		static void formatTo(StringFormatWriter& writer, const FORMAT& format, const ARGS&... args) noexcept;
+		
+		template <class FORMAT, class... ARGS>
+		static sl_bool formatTo(StringBuffer& buffer, const FORMAT& format, const ARGS&... args) noexcept;
+		
+	};
+
+}
+
+/*
+	Wraps a string literal into an object whose type carries the literal, so that
+	the literal can be parsed in constant expressions.
+*/
+#define SLIB_FORMAT_STRING(STR) \
+	([]() { \
+		struct _priv_StringFormat_Literal \
+		{ \
+			static constexpr const sl_char8* get() noexcept { return STR; } \
+		}; \
+		return _priv_StringFormat_Literal(); \
+	}())
+
+#define SLIB_FORMAT(FORMAT, ...) slib::StringFormat::format(SLIB_FORMAT_STRING(FORMAT), ##__VA_ARGS__)
+
+#include "detail/string_format.inc"
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CORE_STRING_POOL
+#define CHECKHEADER_SLIB_CORE_STRING_POOL
+
+#include "definition.h"
+
+#include "string.h"
+#include "hash_map.h"
+#include "spin_lock.h"
+
+/*
+	StringPool is a concurrent interning table of the strings.
+
+	Interned strings having the same content share one `StringContainer`, whose
+	`hash` is computed while interning. So the comparisons between the interned
+	strings are the pointer compares, and the hash lookups don't scan the content.
+	The interned strings are kept until the pool is cleared or destroyed, so the
+	pool should be used only for the small set of the repeated strings such as keys
+	and identifiers.
+*/
+
+namespace slib
+{
+	
+#define SLIB_STRING_POOL_SHARD_COUNT 16
+
+	class SLIB_EXPORT StringPool
+	{
+	public:
+		StringPool() noexcept;
+		
+		~StringPool() noexcept;
+		
+		StringPool(const StringPool&) = delete;
+		
+		StringPool& operator=(const StringPool&) = delete;
+		
+	public:
+		// returns null when the default pool is already freed (while exiting the process)
+		static StringPool* getDefault() noexcept;
+		
+	public:
+		// returns the interned string having the same content, inserting new one if not found
+		String add(const StringView& str) noexcept;
+		
+		// `str` itself is inserted when the pool doesn't contain the same content
+		String add(const String& str) noexcept;
+		
+		// returns null if the pool doesn't contain the same content
+		String get(const StringView& str) const noexcept;
+		
+		sl_bool contains(const StringView& str) const noexcept;
+		
+		sl_size getCount() const noexcept;
+		
+		// the strings interned before clearing are not identical to the ones interned after
+		void clear() noexcept;
+		
+	private:
+		SpinLock m_locks[SLIB_STRING_POOL_SHARD_COUNT];
+		CHashMap<String, sl_bool> m_maps[SLIB_STRING_POOL_SHARD_COUNT];
+		
+	};
+	
+	/*
+		String interned in the default `StringPool`.
+		Comparing and hashing `AtomString` never touch the content of the string.
+	*/
+	class SLIB_EXPORT AtomString
+	{
+	public:
+		SLIB_INLINE constexpr AtomString() noexcept {}
+		
+		SLIB_INLINE constexpr AtomString(sl_null_t) noexcept {}
+		
+		AtomString(const StringView& str) noexcept;
+		
+		AtomString(const String& str) noexcept;
+		
+		AtomString(const sl_char8* str) noexcept;
+		
+		AtomString(const AtomString& other) = default;
+		
+		AtomString(AtomString&& other) = default;
+		
+	public:
+		AtomString& operator=(const AtomString& other) = default;
+		
+		AtomString& operator=(AtomString&& other) = default;
+		
+	public:
+		// returns null atom if the string is not interned yet
+		static AtomString lookup(const StringView& str) noexcept;
+		
+	public:
+		SLIB_INLINE const String& toString() const noexcept
+		{
+			return m_str;
+		}
+		
+		SLIB_INLINE operator const String&() const noexcept
+		{
+			return m_str;
+		}
+		
+		SLIB_INLINE sl_char8* getData() const noexcept
+		{
+			return m_str.getData();
+		}
+		
+		SLIB_INLINE sl_size getLength() const noexcept
+		{
+			return m_str.getLength();
+		}
+		
+		SLIB_INLINE sl_bool isNull() const noexcept
+		{
+			return m_str.isNull();
+		}
+		
+		SLIB_INLINE sl_bool isNotNull() const noexcept
+		{
+			return m_str.isNotNull();
+		}
+		
+		SLIB_INLINE sl_bool isEmpty() const noexcept
+		{
+			return m_str.isEmpty();
+		}
+		
+		SLIB_INLINE sl_bool isNotEmpty() const noexcept
+		{
+			return m_str.isNotEmpty();
+		}
+		
+		sl_size getHashCode() const noexcept;
+		
+	public:
+		SLIB_INLINE sl_bool operator==(const AtomString& other) const noexcept
+		{
+			return m_str.getData() == other.m_str.getData();
+		}
+		
+		SLIB_INLINE sl_bool operator!=(const AtomString& other) const noexcept
+		{
+			return m_str.getData() != other.m_str.getData();
+		}
+		
+	private:
+		String m_str;
+		
+	};
+	
+	template <>
+	class Compare<AtomString>
+	{
+	public:
+		int operator()(const AtomString& a, const AtomString& b) const noexcept;
+	};
+	
+	template <>
+	class Equals<AtomString>
+	{
+	public:
+		SLIB_INLINE sl_bool operator()(const AtomString& a, const AtomString& b) const noexcept
+		{
+			return a == b;
+		}
+	};
+	
+	template <>
+	class Hash<AtomString>
+	{
+	public:
+		SLIB_INLINE sl_size operator()(const AtomString& a) const noexcept
+		{
+			return a.getHashCode();
+		}
+	};
+
+}
+
+#endif
@@ -53,6 +53,9 @@ namespace slib
 
 		// Tick count
 		static sl_uint32 getTickCount();
+
+		// monotonic milliseconds, not affected by changes of the wall clock
+		static sl_uint64 getTickCount64();
 	
 
 		// Process & Thread
@@ -60,6 +63,9 @@ namespace slib
 
 		static sl_uint32 getThreadId();
 
+		// number of logical processors available to the process
+		static sl_uint32 getProcessorsCount();
+
 		static sl_bool createProcess(const String& pathExecutable, const String* command, sl_uint32 nCommands);
 
 		static void exec(const String& pathExecutable, const String* command, sl_uint32 nCommands);
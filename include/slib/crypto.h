@@ -30,6 +30,7 @@
 #include "crypto/sha2.h"
 #include "crypto/hash.h"
 #include "crypto/hmac.h"
+#include "crypto/checksum.h"
 
 #include "crypto/gcm.h"
 #include "crypto/block_cipher.h"
@@ -38,9 +39,13 @@
 #include "crypto/des.h"
 
 #include "crypto/rsa.h"
+#include "crypto/ecc.h"
 
 #include "crypto/jwt.h"
 
+#include "crypto/compress.h"
 #include "crypto/zlib.h"
+#include "crypto/lz4.h"
+#include "crypto/zstd.h"
 
 #endif
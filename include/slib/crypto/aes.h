@@ -26,6 +26,7 @@
 #include "definition.h"
 
 #include "../core/string.h"
+#include "../core/async.h"
 
 #include "block_cipher.h"
 #include "gcm.h"
@@ -35,6 +36,9 @@
 
 	User Key Size - 128 bits (16 bytes), 192 bits (24 bytes), 256 bits (32 bytes)
 	Block Size - 128 bits (16 bytes)
+
+	AES-NI (and VAES where available) is used when the CPU supports it,
+	otherwise falls back to the table-based implementation.
 */
 
 namespace slib
@@ -99,11 +103,24 @@ namespace slib
 
 		sl_size encrypt_CTR(const void* iv, sl_uint64 pos, const void* input, sl_size size, void* output) const;
 
+	public:
+		// Counter mode on the whole blocks, increasing 128-bit big-endian counter. Returns the size of processed bytes (multiple of 16)
+		sl_size encryptBlocks_CTR(void* counter /* 16 bytes, inout */, const void* input, void* output, sl_size size) const;
+
+		// Counter mode on the whole blocks, increasing only the low 32 bits of the counter (GCTR in GCM). Returns the size of processed bytes (multiple of 16)
+		sl_size encryptBlocks_GCTR(void* counter /* 16 bytes, inout */, const void* input, void* output, sl_size size) const;
+
+		static sl_bool isHardwareAccelerated();
+
 	private:
 		sl_uint32 m_roundKeyEnc[64];
 		sl_uint32 m_roundKeyDec[64];
 		sl_uint32 m_nCountRounds;
 
+		// round keys in byte order, for AES-NI
+		sl_uint8 m_roundKeyEncBytes[240];
+		sl_uint8 m_roundKeyDecBytes[240];
+
 	};
 	
 	class SLIB_EXPORT AES_GCM : public Object, public GCM<AES>
@@ -122,6 +139,86 @@ namespace slib
 		AES m_cipher;
 
 	};
+	
+#define SLIB_AES_GCM_STREAM_FILTER_FRAME_SIZE_MAX (SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE - 20)
+	
+	/*
+		Encrypts the data written to the source stream, and decrypts the data read from it, with AES-GCM.
+
+		Both peers share the key, and take the opposite roles (`flagServer`). Each direction is encrypted by
+		its own key, derived by HKDF-SHA256 from the shared key, the random salt of the direction and the role
+		of the writer, so the frames can not be reflected to the writer or replayed into another stream.
+
+		Stream format (each direction)
+			16 bytes: random salt
+			Frames:
+				4 bytes (big-endian), authenticated as AAD
+					bit 31: final frame
+					bit 0~30: length of the ciphertext (1 ~ `SLIB_AES_GCM_STREAM_FILTER_FRAME_SIZE_MAX`, 0 is allowed for the final frame)
+				ciphertext
+				16 bytes: tag
+			The nonce of n-th frame (from 0) is n (big-endian, in the last 8 bytes).
+
+		Each frame is verified before its plaintext is passed to the reader, so a tampered, reordered or replayed frame
+		ends the reading with error. `finishWriting()` writes the final frame. Reading ends after the final frame
+		(`isReadingFinished()`), and the end of the source stream before it (truncation) is a reading error.
+		The frames are written into the pooled buffers of the filter, so no memory is allocated per frame.
+	*/
+	class SLIB_EXPORT AES_GCM_StreamFilter : public AsyncStreamFilter
+	{
+	protected:
+		AES_GCM_StreamFilter();
+
+		~AES_GCM_StreamFilter();
+
+	public:
+		static Ref<AES_GCM_StreamFilter> create(const Ref<AsyncStream>& source, const void* key, sl_uint32 lenKey /* 16, 24, 32 bytes */, sl_bool flagServer);
+
+		// The key is derived from the password by PBKDF2-HMAC-SHA256
+		static Ref<AES_GCM_StreamFilter> create(const Ref<AsyncStream>& source, const String& password, sl_bool flagServer);
+
+	public:
+		// writes the final frame after the last `write()`
+		sl_bool finishWriting(const Function<void(AsyncStreamResult*)>& callback);
+
+		// the final frame is read
+		sl_bool isReadingFinished();
+
+	protected:
+		sl_bool convertRead(void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output) override;
+
+		sl_bool convertWrite(const void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output) override;
+
+		void onReadStream(AsyncStreamResult* result) override;
+
+	protected:
+		sl_bool _decryptFrame(const sl_uint8* frame, AsyncStreamFilterOutput& output);
+
+		sl_bool _writeFrame(const sl_uint8* data, sl_uint32 size, sl_bool flagFinal, AsyncStreamFilterOutput& output);
+
+		sl_bool _writeSalt(AsyncStreamFilterOutput& output);
+
+	protected:
+		sl_uint8 m_key[32];
+		sl_uint32 m_lenKey;
+		sl_bool m_flagServer;
+
+		AES_GCM m_gcmRead;
+		AES_GCM m_gcmWrite;
+
+		sl_uint64 m_counterRead;
+		sl_uint8 m_headerRead[20];
+		sl_uint32 m_sizeHeaderRead;
+		sl_uint32 m_sizeFrameRead;
+		sl_bool m_flagFinalFrameRead;
+		sl_bool m_flagFinishedRead;
+		Memory m_bufFrameRead;
+		sl_uint32 m_posFrameRead;
+
+		sl_uint64 m_counterWrite;
+		sl_bool m_flagWrittenSalt;
+
+	};
 
 }
 
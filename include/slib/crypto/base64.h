@@ -26,6 +26,7 @@
 #include "definition.h"
 
 #include "../core/string.h"
+#include "../core/async.h"
 
 namespace slib
 {
@@ -49,6 +50,126 @@ namespace slib
 
 		static Memory decode(const String& base64, sl_char8 padding = '=');
 		
+	public:
+		static sl_size getEncodedLength(sl_size size, sl_char8 padding = '=');
+
+		// maximum size of the data decoded from `length` characters
+		static sl_size getDecodedSize(sl_size length);
+
+		/*
+			Encodes into the caller's buffer without allocation.
+			`output` should have at least `getEncodedLength(size, padding)` characters (not null-terminated).
+			Returns the number of characters written.
+		*/
+		static sl_size encodeTo(const void* byte, sl_size size, sl_char8* output, sl_char8 padding = '=');
+
+		static sl_size encodeUrlTo(const void* byte, sl_size size, sl_char8* output, sl_char8 padding = 0);
+
+		/*
+			Decodes into the caller's buffer without allocation.
+			`output` should have at least `getDecodedSize(length)` bytes.
+			Returns the decoded size, or 0 when an invalid character is found.
+		*/
+		static sl_size decode(const sl_char8* base64, sl_size length, void* output, sl_char8 padding = '=');
+
+	};
+	
+	class SLIB_EXPORT Base64Encoder
+	{
+	public:
+		Base64Encoder(sl_bool flagUrl = sl_false, sl_char8 padding = '=');
+
+		~Base64Encoder();
+
+	public:
+		void reset();
+
+		// `output` should have at least `((size + 2) / 3) * 4` characters
+		sl_size update(const void* data, sl_size size, sl_char8* output);
+
+		String update(const void* data, sl_size size);
+
+		// writes the last partial block (up to 4 characters)
+		sl_size finish(sl_char8* output);
+
+		String finish();
+
+	protected:
+		sl_bool m_flagUrl;
+		sl_char8 m_padding;
+		sl_uint8 m_remain[2];
+		sl_uint32 m_sizeRemain;
+
+	};
+	
+	class SLIB_EXPORT Base64Decoder
+	{
+	public:
+		Base64Decoder(sl_char8 padding = '=');
+
+		~Base64Decoder();
+
+	public:
+		void reset();
+
+		// `output` should have at least `getDecodedSize(length) + 2` bytes. Returns 0 after an invalid character is found.
+		sl_size update(const sl_char8* base64, sl_size length, void* output);
+
+		Memory update(const sl_char8* base64, sl_size length);
+
+		sl_bool isError();
+
+	protected:
+		sl_char8 m_padding;
+		sl_uint32 m_posInBlock;
+		sl_uint32 m_bits;
+		sl_bool m_flagError;
+
+	};
+	
+	/*
+		Encodes (or decodes) the data read from and written to the source stream, block by block,
+		so that large contents don't need to be buffered whole. The output is written into the pooled buffers of the filter.
+	*/
+	class SLIB_EXPORT Base64StreamFilter : public AsyncStreamFilter
+	{
+	protected:
+		Base64StreamFilter();
+
+		~Base64StreamFilter();
+
+	public:
+		static Ref<Base64StreamFilter> createEncoder(const Ref<AsyncStream>& source, sl_bool flagUrl = sl_false, sl_char8 padding = '=');
+
+		static Ref<Base64StreamFilter> createDecoder(const Ref<AsyncStream>& source, sl_char8 padding = '=');
+
+	public:
+		sl_bool isEncoder();
+
+		// writes the last partial block of the encoder to the source stream, after the last `write()`
+		sl_bool finishWriting(const Function<void(AsyncStreamResult*)>& callback);
+
+	protected:
+		sl_bool convertRead(void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output) override;
+
+		sl_bool convertWrite(const void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output) override;
+
+		void onReadStream(AsyncStreamResult* result) override;
+
+	protected:
+		sl_bool _encode(Base64Encoder& encoder, const void* data, sl_uint32 size, AsyncStreamFilterOutput& output);
+
+		sl_bool _finishEncoding(Base64Encoder& encoder, AsyncStreamFilterOutput& output);
+
+		sl_bool _decode(Base64Decoder& decoder, const void* data, sl_uint32 size, AsyncStreamFilterOutput& output);
+
+	protected:
+		sl_bool m_flagEncoder;
+		Base64Encoder m_encoderRead;
+		Base64Encoder m_encoderWrite;
+		Base64Decoder m_decoderRead;
+		Base64Decoder m_decoderWrite;
+
 	};
 
 }
@@ -0,0 +1,141 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_CHECKSUM
+#define CHECKHEADER_SLIB_CRYPTO_CHECKSUM
+
+#include "definition.h"
+
+#include "../core/memory.h"
+
+/*
+	Checksums
+		CRC32 - CRC-32 (IEEE 802.3, zlib, gzip, PNG)
+		CRC32C - CRC-32C (Castagnoli, iSCSI, SCTP, ext4)
+		Adler32 - Adler-32 (RFC 1950, zlib)
+		XXHash32, XXHash64 - xxHash (LZ4 and Zstandard frames)
+
+	Hardware paths are selected at runtime:
+		CRC32 - PCLMULQDQ folding on x86, CRC32 instructions on ARMv8
+		CRC32C - SSE4.2 CRC32 instructions on x86, CRC32 instructions on ARMv8
+		Adler32 - SSSE3/AVX2 on x86
+
+	`extend()` continues the checksum of the preceding data, and `get()` starts a new one.
+	xxHash can not be extended from its result, so it is also provided as a streaming object (`start()`, `update()`, `finish()`).
+*/
+
+namespace slib
+{
+	
+	class SLIB_EXPORT CRC32
+	{
+	public:
+		static sl_uint32 extend(sl_uint32 crc, const void* data, sl_size size);
+
+		static sl_uint32 get(const void* data, sl_size size);
+
+		static sl_uint32 extend(sl_uint32 crc, const Memory& mem);
+
+		static sl_uint32 get(const Memory& mem);
+
+	};
+	
+	class SLIB_EXPORT CRC32C
+	{
+	public:
+		static sl_uint32 extend(sl_uint32 crc, const void* data, sl_size size);
+
+		static sl_uint32 get(const void* data, sl_size size);
+
+		static sl_uint32 extend(sl_uint32 crc, const Memory& mem);
+
+		static sl_uint32 get(const Memory& mem);
+
+	};
+	
+	class SLIB_EXPORT Adler32
+	{
+	public:
+		static sl_uint32 extend(sl_uint32 adler, const void* data, sl_size size);
+
+		static sl_uint32 get(const void* data, sl_size size);
+
+		static sl_uint32 extend(sl_uint32 adler, const Memory& mem);
+
+		static sl_uint32 get(const Memory& mem);
+
+	};
+	
+	class SLIB_EXPORT XXHash32
+	{
+	public:
+		XXHash32();
+
+	public:
+		void start(sl_uint32 seed = 0);
+
+		void update(const void* data, sl_size size);
+
+		sl_uint32 finish();
+
+	public:
+		static sl_uint32 get(const void* data, sl_size size, sl_uint32 seed = 0);
+
+		static sl_uint32 get(const Memory& mem, sl_uint32 seed = 0);
+
+	private:
+		sl_uint32 m_v[4];
+		sl_uint64 m_sizeTotal;
+		sl_uint8 m_buf[16];
+		sl_uint32 m_sizeBuf;
+
+	};
+	
+	class SLIB_EXPORT XXHash64
+	{
+	public:
+		XXHash64();
+
+	public:
+		void start(sl_uint64 seed = 0);
+
+		void update(const void* data, sl_size size);
+
+		sl_uint64 finish();
+
+	public:
+		static sl_uint64 get(const void* data, sl_size size, sl_uint64 seed = 0);
+
+		static sl_uint64 get(const Memory& mem, sl_uint64 seed = 0);
+
+	private:
+		sl_uint64 m_v[4];
+		sl_uint64 m_sizeTotal;
+		sl_uint8 m_buf[32];
+		sl_uint32 m_sizeBuf;
+
+	};
+
+}
+
+#endif
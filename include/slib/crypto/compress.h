@@ -0,0 +1,202 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_COMPRESS
+#define CHECKHEADER_SLIB_CRYPTO_COMPRESS
+
+#include "definition.h"
+
+#include "../core/object.h"
+#include "../core/memory.h"
+#include "../core/string.h"
+#include "../core/async.h"
+
+/*
+	Generic compression interface
+
+		Zlib - deflate with zlib wrapper (RFC 1950, HTTP `deflate`)
+		Deflate - raw deflate (RFC 1951)
+		Gzip - deflate with gzip wrapper (RFC 1952, HTTP `gzip`)
+		LZ4 - LZ4 frame format, very fast compression and decompression
+		Zstd - Zstandard frame format (RFC 8878, HTTP `zstd`), optionally with dictionary
+
+	Attention: Compressor and Decompressor objects are not thread-safe
+*/
+
+namespace slib
+{
+	
+	enum class CompressionMethod
+	{
+		None = 0,
+		Zlib = 1,
+		Deflate = 2,
+		Gzip = 3,
+		LZ4 = 10,
+		Zstd = 20
+	};
+	
+	class SLIB_EXPORT Compressor : public Object
+	{
+	public:
+		Compressor();
+
+		~Compressor();
+
+	public:
+		// returns started compressor, `level` < 0 means the default level of the method
+		static Ref<Compressor> create(CompressionMethod method, sl_int32 level = -1);
+
+	public:
+		virtual sl_bool isStarted() = 0;
+
+		/*
+			returns
+				<0: Error
+				=0: Finished
+				>0: Success
+		*/
+		virtual sl_int32 compress(
+			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed,
+			sl_bool flagFinish) = 0;
+
+		virtual Memory compress(const void* data, sl_size size, sl_bool flagFinish);
+
+		/*
+			Writes the pending output so that the data passed until now can be decoded, without ending the stream.
+			returns
+				<0: Error (or not supported)
+				=0: Flushed
+				>0: `output` is full, call again
+		*/
+		virtual sl_int32 flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed);
+
+		virtual void abort() = 0;
+
+	};
+	
+	class SLIB_EXPORT Decompressor : public Object
+	{
+	public:
+		Decompressor();
+
+		~Decompressor();
+
+	public:
+		// returns started decompressor
+		static Ref<Decompressor> create(CompressionMethod method);
+
+	public:
+		virtual sl_bool isStarted() = 0;
+
+		/*
+			returns
+				<0: Error
+				=0: Finished
+				>0: Success
+		*/
+		virtual sl_int32 decompress(
+			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) = 0;
+
+		virtual Memory decompress(const void* data, sl_size size);
+
+		virtual void abort() = 0;
+
+	};
+	
+	class SLIB_EXPORT Compression
+	{
+	public:
+		static Memory compress(CompressionMethod method, const void* data, sl_size size, sl_int32 level = -1);
+
+		static Memory compress(CompressionMethod method, const Memory& data, sl_int32 level = -1);
+
+		static Memory decompress(CompressionMethod method, const void* data, sl_size size);
+
+		static Memory decompress(CompressionMethod method, const Memory& data);
+
+	public:
+		// HTTP `Content-Encoding` token of the method (null for raw deflate and LZ4)
+		static String getContentEncoding(CompressionMethod method);
+
+		// returns `None` for `identity` and unsupported tokens
+		static CompressionMethod getMethodFromContentEncoding(const String& encoding);
+
+		/*
+			Selects the method for a response from `Accept-Encoding` request header, respecting q-values.
+			On equal preference the order is zstd, gzip, deflate. Returns `None` if nothing is acceptable.
+		*/
+		static CompressionMethod selectContentEncoding(const String& acceptEncoding);
+
+	};
+	
+	/*
+		Compresses the data written to the source stream, and decompresses the data read from it.
+		By default, the compressed data is flushed at every `write()`, so that the peer can decode it
+		without waiting for the following writes (tunnels, request/response protocols).
+		Concatenated streams (gzip members, zstd and LZ4 frames) are decompressed one after another.
+	*/
+	class SLIB_EXPORT CompressionStreamFilter : public AsyncStreamFilter
+	{
+	protected:
+		CompressionStreamFilter();
+
+		~CompressionStreamFilter();
+
+	public:
+		static Ref<CompressionStreamFilter> create(const Ref<AsyncStream>& source, CompressionMethod method, sl_int32 level = -1);
+
+	public:
+		CompressionMethod getMethod();
+
+		sl_bool isFlushingEachWrite();
+
+		void setFlushingEachWrite(sl_bool flag);
+
+		// writes the pending compressed data to the source stream
+		sl_bool flushWriting(const Function<void(AsyncStreamResult*)>& callback);
+
+		// ends the compressed stream after the last `write()`
+		sl_bool finishWriting(const Function<void(AsyncStreamResult*)>& callback);
+
+	protected:
+		sl_bool convertRead(void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output) override;
+
+		sl_bool convertWrite(const void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output) override;
+
+	protected:
+		sl_bool _flush(AsyncStreamFilterOutput& output);
+
+	protected:
+		CompressionMethod m_method;
+		sl_int32 m_level;
+		sl_bool m_flagFlushEachWrite;
+		Ref<Compressor> m_compressor;
+		Ref<Decompressor> m_decompressor;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_ECC
+#define CHECKHEADER_SLIB_CRYPTO_ECC
+
+#include "definition.h"
+
+/*
+	Elliptic-curve signatures
+
+	Ed25519 - EdDSA over edwards25519 (RFC 8032)
+		Private Key: 32 bytes (seed)
+		Public Key: 32 bytes
+		Signature: 64 bytes (R || S)
+
+	ECDSA_P256 - ECDSA over NIST P-256 (secp256r1, FIPS 186-4)
+		Private Key: 32 bytes (big-endian scalar)
+		Public Key: 64 bytes (big-endian X || Y, uncompressed point without 0x04 prefix)
+		Signature: 64 bytes (big-endian R || S, as used by JWS)
+		Nonce: deterministic (RFC 6979, HMAC-SHA256)
+
+	Operations on the private keys are constant-time, and the multiplications of the base points use the pre-computed tables (built on first use).
+*/
+
+namespace slib
+{
+	
+	class SLIB_EXPORT Ed25519
+	{
+	public:
+		enum {
+			PrivateKeySize = 32,
+			PublicKeySize = 32,
+			SignatureSize = 64
+		};
+
+	public:
+		static void generatePrivateKey(void* privateKey) noexcept;
+
+		static void getPublicKey(const void* privateKey, void* publicKey) noexcept;
+
+		// `publicKey` is computed from `privateKey` if it is null
+		static void sign(const void* privateKey, const void* publicKey, const void* message, sl_size size, void* signature) noexcept;
+
+		static sl_bool verify(const void* publicKey, const void* message, sl_size size, const void* signature) noexcept;
+
+	};
+	
+	class SLIB_EXPORT ECDSA_P256
+	{
+	public:
+		enum {
+			PrivateKeySize = 32,
+			PublicKeySize = 64,
+			SignatureSize = 64,
+			HashSize = 32
+		};
+
+	public:
+		static void generatePrivateKey(void* privateKey) noexcept;
+
+		// returns false if the private key is not in [1, n-1]
+		static sl_bool getPublicKey(const void* privateKey, void* publicKey) noexcept;
+
+		// `hash`: SHA-256 digest of the message
+		static sl_bool sign(const void* privateKey, const void* hash, void* signature) noexcept;
+
+		static sl_bool verify(const void* publicKey, const void* hash, const void* signature) noexcept;
+
+		static sl_bool signMessage(const void* privateKey, const void* message, sl_size size, void* signature) noexcept;
+
+		static sl_bool verifyMessage(const void* publicKey, const void* message, sl_size size, const void* signature) noexcept;
+
+	};
+
+}
+
+#endif
@@ -46,6 +46,8 @@ namespace slib
 	{
 	public:
 		Uint128 M[16]; // Shoup's, 4-bit table
+		sl_uint8 HP[64]; // H^1 ~ H^4 in byte-reflected order, used by carry-less multiplication (PCLMULQDQ)
+		sl_bool flagCLMUL;
 	
 	public:
 		void generateTable(const void* H /* 16 bytes */);
@@ -27,6 +27,8 @@
 
 /*
 	HMAC: Keyed-Hashing for Message Authentication (RFC-2104)
+	HKDF: HMAC-based Extract-and-Expand Key Derivation Function (RFC-5869)
+	PBKDF2: Password-Based Key Derivation Function 2 with HMAC (RFC-8018)
 */
 
 namespace slib
@@ -36,32 +38,17 @@ namespace slib
 	class SLIB_EXPORT HMAC
 	{
 	public:
-		static void execute(const void* _key, sl_size lenKey, const void* message, sl_size lenMessage, void* output)
+		static void execute(const void* key, sl_size lenKey, const void* message, sl_size lenMessage, void* output)
 		{
 			sl_size i;
-			const sl_uint8* key = (const sl_uint8*)_key;
 			sl_uint8 keyLocal[HASH::BlockSize];
-			if (lenKey > HASH::BlockSize) {
-				HASH::hash(key, lenKey, keyLocal);
-				for (i = HASH::HashSize; i < HASH::BlockSize; i++) {
-					keyLocal[i] = 0;
-				}
-				key = keyLocal;
-			} else if (lenKey < HASH::BlockSize) {
-				for (i = 0; i < lenKey; i++) {
-					keyLocal[i] = key[i];
-				}
-				for (; i < HASH::BlockSize; i++) {
-					keyLocal[i] = 0;
-				}
-				key = keyLocal;
-			}
+			_prepareKey(key, lenKey, keyLocal);
 			// hash(o_key_pad | hash(i_key_pad | message)), i_key_pad = key xor [0x36 * BlockSize], o_key_pad = key xor [0x5c * BlockSize]
 			HASH hash;
 			hash.start();
 			sl_uint8 key_pad[HASH::BlockSize];
 			for (i = 0; i < HASH::BlockSize; i++) {
-				key_pad[i] = key[i] ^ 0x36;
+				key_pad[i] = keyLocal[i] ^ 0x36;
 			}
 			hash.update(key_pad, HASH::BlockSize);
 			hash.update(message, lenMessage);
@@ -69,13 +56,190 @@ namespace slib
 			
 			hash.start();
 			for (i = 0; i < HASH::BlockSize; i++) {
-				key_pad[i] = key[i] ^ 0x5c;
+				key_pad[i] = keyLocal[i] ^ 0x5c;
 			}
 			hash.update(key_pad, HASH::BlockSize);
 			hash.update(output, HASH::HashSize);
 			hash.finish(output);
 		}
 		
+		// Computes the MACs of `count` messages under the same key. HASH should provide `hashBatch` (e.g. SHA256)
+		static void executeBatch(const void* key, sl_size lenKey, const void* const* messages, const sl_size* lenMessages, void* const* outputs, sl_size count)
+		{
+			sl_size i, k;
+			sl_uint8 keyLocal[HASH::BlockSize];
+			_prepareKey(key, lenKey, keyLocal);
+			sl_uint8 key_pad[HASH::BlockSize];
+			for (i = 0; i < HASH::BlockSize; i++) {
+				key_pad[i] = keyLocal[i] ^ 0x36;
+			}
+			HASH::hashBatch(messages, lenMessages, outputs, count, key_pad, HASH::BlockSize);
+			
+			for (i = 0; i < HASH::BlockSize; i++) {
+				key_pad[i] = keyLocal[i] ^ 0x5c;
+			}
+			const void* inner[16];
+			sl_size sizes[16];
+			for (i = 0; i < count; i += 16) {
+				sl_size n = count - i;
+				if (n > 16) {
+					n = 16;
+				}
+				for (k = 0; k < n; k++) {
+					inner[k] = outputs[i + k];
+					sizes[k] = HASH::HashSize;
+				}
+				HASH::hashBatch(inner, sizes, outputs + i, n, key_pad, HASH::BlockSize);
+			}
+		}
+		
+	public:
+		void setKey(const void* key, sl_size lenKey)
+		{
+			_prepareKey(key, lenKey, m_key);
+		}
+		
+		// computes the MAC of the message passed by `update()`, under the key set by `setKey()`
+		void start()
+		{
+			sl_uint8 key_pad[HASH::BlockSize];
+			for (sl_size i = 0; i < HASH::BlockSize; i++) {
+				key_pad[i] = m_key[i] ^ 0x36;
+			}
+			m_hash.start();
+			m_hash.update(key_pad, HASH::BlockSize);
+		}
+		
+		void update(const void* data, sl_size size)
+		{
+			m_hash.update(data, size);
+		}
+		
+		void finish(void* output)
+		{
+			sl_uint8 h[HASH::HashSize];
+			m_hash.finish(h);
+			sl_uint8 key_pad[HASH::BlockSize];
+			for (sl_size i = 0; i < HASH::BlockSize; i++) {
+				key_pad[i] = m_key[i] ^ 0x5c;
+			}
+			m_hash.start();
+			m_hash.update(key_pad, HASH::BlockSize);
+			m_hash.update(h, HASH::HashSize);
+			m_hash.finish(output);
+		}
+		
+	private:
+		static void _prepareKey(const void* _key, sl_size lenKey, sl_uint8* keyLocal)
+		{
+			sl_size i;
+			const sl_uint8* key = (const sl_uint8*)_key;
+			if (lenKey > HASH::BlockSize) {
+				HASH::hash(key, lenKey, keyLocal);
+				i = HASH::HashSize;
+			} else {
+				for (i = 0; i < lenKey; i++) {
+					keyLocal[i] = key[i];
+				}
+			}
+			for (; i < HASH::BlockSize; i++) {
+				keyLocal[i] = 0;
+			}
+		}
+		
+	private:
+		HASH m_hash;
+		sl_uint8 m_key[HASH::BlockSize];
+		
+	};
+	
+	template <class HASH>
+	class SLIB_EXPORT HKDF
+	{
+	public:
+		// `prk`: HASH::HashSize bytes
+		static void extract(const void* salt, sl_size lenSalt, const void* ikm, sl_size lenIkm, void* prk)
+		{
+			HMAC<HASH>::execute(salt, lenSalt, ikm, lenIkm, prk);
+		}
+		
+		// `lenOutput` <= 255 * HASH::HashSize
+		static void expand(const void* prk, sl_size lenPrk, const void* info, sl_size lenInfo, void* _output, sl_size lenOutput)
+		{
+			sl_uint8* output = (sl_uint8*)_output;
+			HMAC<HASH> mac;
+			mac.setKey(prk, lenPrk);
+			// T(i) = HMAC(PRK, T(i-1) | info | i)
+			sl_uint8 t[HASH::HashSize];
+			sl_uint8 counter = 1;
+			while (lenOutput) {
+				mac.start();
+				if (counter > 1) {
+					mac.update(t, HASH::HashSize);
+				}
+				mac.update(info, lenInfo);
+				mac.update(&counter, 1);
+				mac.finish(t);
+				sl_size n = lenOutput < HASH::HashSize ? lenOutput : HASH::HashSize;
+				for (sl_size i = 0; i < n; i++) {
+					output[i] = t[i];
+				}
+				output += n;
+				lenOutput -= n;
+				counter++;
+			}
+		}
+		
+		static void execute(const void* salt, sl_size lenSalt, const void* ikm, sl_size lenIkm, const void* info, sl_size lenInfo, void* output, sl_size lenOutput)
+		{
+			sl_uint8 prk[HASH::HashSize];
+			extract(salt, lenSalt, ikm, lenIkm, prk);
+			expand(prk, HASH::HashSize, info, lenInfo, output, lenOutput);
+		}
+		
+	};
+	
+	template <class HASH>
+	class SLIB_EXPORT PBKDF2_HMAC
+	{
+	public:
+		static void execute(const void* password, sl_size lenPassword, const void* salt, sl_size lenSalt, sl_uint32 nIterations, void* _output, sl_size lenOutput)
+		{
+			sl_uint8* output = (sl_uint8*)_output;
+			HMAC<HASH> mac;
+			mac.setKey(password, lenPassword);
+			// T(i) = U1 ^ U2 ^ ... ^ Uc, U1 = HMAC(P, S | INT(i)), Uj = HMAC(P, Uj-1)
+			sl_uint8 u[HASH::HashSize];
+			sl_uint8 t[HASH::HashSize];
+			sl_uint32 index = 1;
+			while (lenOutput) {
+				mac.start();
+				mac.update(salt, lenSalt);
+				sl_uint8 bytesIndex[4] = { (sl_uint8)(index >> 24), (sl_uint8)(index >> 16), (sl_uint8)(index >> 8), (sl_uint8)index };
+				mac.update(bytesIndex, 4);
+				mac.finish(u);
+				sl_size i;
+				for (i = 0; i < HASH::HashSize; i++) {
+					t[i] = u[i];
+				}
+				for (sl_uint32 k = 1; k < nIterations; k++) {
+					mac.start();
+					mac.update(u, HASH::HashSize);
+					mac.finish(u);
+					for (i = 0; i < HASH::HashSize; i++) {
+						t[i] ^= u[i];
+					}
+				}
+				sl_size n = lenOutput < HASH::HashSize ? lenOutput : HASH::HashSize;
+				for (i = 0; i < n; i++) {
+					output[i] = t[i];
+				}
+				output += n;
+				lenOutput -= n;
+				index++;
+			}
+		}
+		
 	};
 
 }
@@ -51,7 +51,8 @@ namespace slib
 		ES512 = 32, // ECDSA using P-512 and SHA-512
 		PS256 = 40, // RSASSA-PSS using SHA-256 and MGF1 with SHA-256
 		PS384 = 41, // RSASSA-PSS using SHA-384 and MGF1 with SHA-384
-		PS512 = 42  // RSASSA-PSS using SHA-512 and MGF1 with SHA-512
+		PS512 = 42, // RSASSA-PSS using SHA-512 and MGF1 with SHA-512
+		EdDSA = 50 // Ed25519 (RFC 8037)
 	};
 	
 	class SLIB_EXPORT Jwt
@@ -72,12 +73,28 @@ namespace slib
 		Jwt& operator=(Jwt&& other) noexcept;
 
 	public:
+		/*
+			`secret` for signing (encode):
+				HS256/HS384/HS512 - HMAC key
+				ES256 - P-256 private key (32 bytes, big-endian)
+				EdDSA - Ed25519 private key (32 bytes seed, or 64 bytes seed || public key)
+			`key` for verifying (decode):
+				HS256/HS384/HS512 - HMAC key
+				ES256 - P-256 public key (64 bytes X || Y, or 65 bytes with 0x04 prefix)
+				EdDSA - Ed25519 public key (32 bytes)
+		*/
 		String encode(const Memory& secret) const noexcept;
 		
+		// `secret` is an HMAC key: accepts only the tokens signed by HS256/HS384/HS512
 		sl_bool decode(const Memory& secret, const String& token) noexcept;
 		
+		// fails when the `alg` of the header is not `algorithm`, so that a public key is never used as an HMAC key
+		sl_bool decode(const Memory& key, const String& token, JwtAlgorithm algorithm) noexcept;
+		
 		String generateSignature(const Memory& secret, const void* data, sl_size size) const noexcept;
 		
+		static sl_bool verifySignature(JwtAlgorithm algorithm, const Memory& key, const void* data, sl_size size, const String& signature) noexcept;
+		
 		// header
 	public:
 		String getType() const noexcept;
@@ -0,0 +1,167 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_LZ4
+#define CHECKHEADER_SLIB_CRYPTO_LZ4
+
+#include "definition.h"
+
+#include "compress.h"
+#include "checksum.h"
+
+/*
+	LZ4 - fast LZ77 compression
+
+	Block format: sequences of literals and matches without any header.
+	Frame format: magic number (0x184D2204), descriptor, blocks, end mark and XXH32 content checksum.
+	Frames are compatible with the `lz4` command line tool and liblz4.
+
+	level
+		1 ~ 2: single hash probe (fastest)
+		3 ~ 12: hash chain search, deeper on higher level
+*/
+
+namespace slib
+{
+	
+	class SLIB_EXPORT LZ4Compress : public Compressor
+	{
+	public:
+		LZ4Compress();
+
+		~LZ4Compress();
+
+	public:
+		sl_bool isStarted() override;
+
+		/*
+			blockSize: 64KB, 256KB, 1MB or 4MB (other values are rounded up).
+			Blocks are compressed independently.
+		*/
+		sl_bool start(sl_int32 level = 1, sl_uint32 blockSize = 0x10000, sl_bool flagContentChecksum = sl_true);
+
+		sl_int32 compress(
+			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed,
+			sl_bool flagFinish) override;
+
+		Memory compress(const void* data, sl_size size, sl_bool flagFinish) override;
+
+		sl_int32 flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
+
+		void abort() override;
+
+	private:
+		sl_bool _start(sl_int32 level, sl_uint32 blockSize, sl_bool flagContentChecksum, sl_uint64 sizeContent);
+
+		void _writeBlock(const void* data, sl_uint32 size);
+
+	private:
+		sl_bool m_flagStarted;
+		sl_bool m_flagEnded;
+		sl_int32 m_level;
+		sl_bool m_flagContentChecksum;
+		sl_uint32 m_sizeBlock;
+
+		Memory m_bufInput;
+		sl_uint32 m_sizeInput;
+		Memory m_bufOutput;
+		sl_uint32 m_posOutput;
+		sl_uint32 m_sizeOutput;
+		Memory m_table;
+		sl_uint32 m_base;
+		XXHash32 m_hash;
+
+		friend class LZ4;
+
+	};
+	
+	class SLIB_EXPORT LZ4Decompress : public Decompressor
+	{
+	public:
+		LZ4Decompress();
+
+		~LZ4Decompress();
+
+	public:
+		sl_bool isStarted() override;
+
+		sl_bool start();
+
+		// finishes at the end of the first frame (skippable frames are ignored)
+		sl_int32 decompress(
+			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
+
+		Memory decompress(const void* data, sl_size size) override;
+
+		void abort() override;
+
+	private:
+		sl_bool _processInput(const sl_uint8* data, sl_uint32 size);
+
+	private:
+		sl_bool m_flagStarted;
+		sl_uint32 m_state;
+		sl_uint32 m_sizeNeeded;
+		sl_uint8 m_flags;
+		sl_uint32 m_sizeBlockMax;
+		sl_uint32 m_sizeBlock;
+
+		Memory m_bufInput;
+		sl_uint32 m_sizeInput;
+		Memory m_window;
+		sl_uint32 m_sizeHistory;
+		sl_uint32 m_posOutput;
+		sl_uint32 m_sizeOutput;
+		XXHash32 m_hash;
+
+	};
+	
+	class SLIB_EXPORT LZ4
+	{
+	public:
+		// maximum size of the compressed block
+		static sl_size getCompressBound(sl_size size);
+
+		// returns the size of compressed block, 0 when `sizeOutput` is not enough
+		static sl_size compressBlock(const void* input, sl_size size, void* output, sl_size sizeOutput, sl_int32 level = 1);
+
+		// returns the size of decompressed data, negative on corrupted block or when `sizeOutput` is not enough
+		static sl_reg decompressBlock(const void* input, sl_size size, void* output, sl_size sizeOutput);
+
+	public:
+		// frame format
+		static Memory compress(const void* data, sl_size size, sl_int32 level = 1);
+
+		static Memory compress(const Memory& data, sl_int32 level = 1);
+
+		// decompresses all concatenated frames
+		static Memory decompress(const void* data, sl_size size);
+
+		static Memory decompress(const Memory& data);
+
+	};
+
+}
+
+#endif
@@ -46,6 +46,11 @@ namespace slib
 	public:
 		sl_uint32 getLength() const;
 
+		Ref<MontgomeryContext> getMontgomeryN() const;
+
+	private:
+		mutable AtomicRef<MontgomeryContext> m_montN;
+
 	};
 	
 	class SLIB_EXPORT RSAPrivateKey
@@ -71,6 +76,17 @@ namespace slib
 	public:
 		sl_uint32 getLength() const;
 
+		Ref<MontgomeryContext> getMontgomeryN() const;
+
+		Ref<MontgomeryContext> getMontgomeryP() const;
+
+		Ref<MontgomeryContext> getMontgomeryQ() const;
+
+	private:
+		mutable AtomicRef<MontgomeryContext> m_montN;
+		mutable AtomicRef<MontgomeryContext> m_montP;
+		mutable AtomicRef<MontgomeryContext> m_montQ;
+
 	};
 	
 	class SLIB_EXPORT RSA
@@ -120,6 +120,13 @@ namespace slib
 	public:
 		static sl_uint32 make32bitChecksum(const void* input, sl_size n);
 
+		/*
+			Hashes `count` independent messages (`prefix` + `inputs[i]`) into `outputs[i]`.
+			Up to 8 messages are compressed in parallel by AVX2 when SHA-NI is not available.
+			The full blocks of `prefix` are compressed only once, so it should be a multiple of `BlockSize` (e.g. HMAC key pad).
+		*/
+		static void hashBatch(const void* const* inputs, const sl_size* sizes, void* const* outputs, sl_size count, const void* prefix = sl_null, sl_size sizePrefix = 0);
+
 	public: /* common functions for CryptoHash */
 		static void hash(const void* input, sl_size n, void* output);
 
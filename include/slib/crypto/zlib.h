@@ -25,9 +25,9 @@
 
 #include "definition.h"
 
-#include "../core/object.h"
-#include "../core/memory.h"
-#include "../core/string.h"
+#include "compress.h"
+
+#include "../core/thread_pool.h"
 
 namespace slib
 {
@@ -45,7 +45,32 @@ namespace slib
 
 	};
 
-	class SLIB_EXPORT ZlibCompress : public Object
+	/*
+		Parallel gzip compression (pigz style)
+
+		Input is split into blocks which are deflated concurrently on a thread pool.
+		Each block is primed with the last 32KB of the previous block as dictionary,
+		so the ratio stays close to single-threaded compression.
+		Blocks are stitched into one gzip member with the combined CRC32.
+	*/
+	class SLIB_EXPORT ZlibParallelParam
+	{
+	public:
+		Ref<ThreadPool> threadPool; // default: a pool with `threadsCount` workers, released when the stream ends
+		sl_uint32 threadsCount; // default: 0 (number of processors)
+		sl_uint32 blockSize; // default: 0x20000 (128KB), minimum: 0x8000 (32KB)
+		sl_uint32 maxPendingBlocks; // default: 0 (twice the number of threads)
+
+	public:
+		ZlibParallelParam();
+
+		~ZlibParallelParam();
+
+	};
+
+	class _priv_ZlibParallelCompress;
+
+	class SLIB_EXPORT ZlibCompress : public Compressor
 	{
 	public:
 		ZlibCompress();
@@ -53,7 +78,7 @@ namespace slib
 		~ZlibCompress();
 	
 	public:
-		sl_bool isStarted();
+		sl_bool isStarted() override;
 	
 		/*
 			contains zlib wrapper
@@ -75,6 +100,23 @@ namespace slib
 		sl_bool startGzip(const GzipParam& param, sl_int32 level = 6);
 
 		sl_bool startGzip(sl_int32 level = 6);
+
+		/*
+			contains gzip header, blocks are compressed in parallel
+			level = 0 ~ 9
+
+			`compress()` keeps the input until a block is full, and returns the output of the
+			completed blocks in order. It blocks only when `maxPendingBlocks` are in flight,
+			or when `flagFinish` is set (waits for all blocks and appends the trailer).
+			So it can be called from `AsyncCopyParam::onRead` with
+			`flagFinish = (copy->getReadSize() >= copy->getTotalSize())`.
+			`flush()` is not supported in this mode.
+		*/
+		sl_bool startParallelGzip(const GzipParam& param, const ZlibParallelParam& parallel, sl_int32 level = 6);
+
+		sl_bool startParallelGzip(const ZlibParallelParam& parallel, sl_int32 level = 6);
+
+		sl_bool startParallelGzip(sl_int32 level = 6);
 	
 		/*
 			returns
@@ -85,11 +127,16 @@ namespace slib
 		sl_int32 compress(
 			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
 			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed,
-			sl_bool flagFinish);
+			sl_bool flagFinish) override;
 	
-		Memory compress(const void* data, sl_size size, sl_bool flagFinish);
+		Memory compress(const void* data, sl_size size, sl_bool flagFinish) override;
+
+		sl_int32 flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
 	
-		void abort();
+		void abort() override;
+
+	private:
+		Memory _compressParallel(const void* data, sl_size size, sl_bool flagFinish, sl_bool flagStatic);
 	
 	private:
 		sl_uint8 m_stream[128]; // bigger than sizeof(z_stream)
@@ -97,12 +144,16 @@ namespace slib
 		sl_uint8 m_gzipHeader[128];
 		String m_gzipFileName;
 		String m_gzipComment;
+
+		Ref<_priv_ZlibParallelCompress> m_parallel;
 	
 		sl_bool m_flagStarted;
 
+		friend class Zlib;
+
 	};
 	
-	class SLIB_EXPORT ZlibDecompress : public Object
+	class SLIB_EXPORT ZlibDecompress : public Decompressor
 	{
 	public:
 		ZlibDecompress();
@@ -110,7 +161,7 @@ namespace slib
 		~ZlibDecompress();
 
 	public:
-		sl_bool isStarted();
+		sl_bool isStarted() override;
 	
 		// zlib and gzip wrapper
 		sl_bool start();
@@ -126,11 +177,11 @@ namespace slib
 		*/
 		sl_int32 decompress(
 			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
-			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed);
+			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
 
-		Memory decompress(const void* data, sl_size size);
+		Memory decompress(const void* data, sl_size size) override;
 	
-		void abort();
+		void abort() override;
 	
 	private:
 		sl_uint8 m_stream[128]; // bigger than sizeof(z_stream)
@@ -170,6 +221,11 @@ namespace slib
 		static Memory compressGzip(const GzipParam& param, const void* data, sl_size size, sl_int32 level = 6);
 
 		static Memory compressGzip(const void* data, sl_size size, sl_int32 level = 6);
+
+		// input is not copied, blocks are compressed in parallel
+		static Memory compressGzipParallel(const GzipParam& param, const ZlibParallelParam& parallel, const void* data, sl_size size, sl_int32 level = 6);
+
+		static Memory compressGzipParallel(const void* data, sl_size size, sl_int32 level = 6);
 	
 		/*
 			Decompress
@@ -0,0 +1,187 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_ZSTD
+#define CHECKHEADER_SLIB_CRYPTO_ZSTD
+
+#include "definition.h"
+
+#include "compress.h"
+#include "checksum.h"
+
+#include "../core/list.h"
+
+/*
+	Zstandard - LZ77 compression with Huffman and FSE (tANS) entropy coding (RFC 8878)
+
+	Frames are compatible with the `zstd` command line tool and libzstd,
+	including dictionaries (`zstd -D`, `zstd --train`).
+
+	level
+		1 ~ 2: single hash probe (fastest)
+		3 ~ 19: hash chain search with lazy matching, deeper on higher level
+*/
+
+namespace slib
+{
+
+	class _priv_ZstdEncoder;
+	class _priv_ZstdDecoder;
+	
+	/*
+		Zstandard dictionary: either the zstd format (magic number 0xEC30A437, dictionary ID,
+		entropy tables, repeat offsets and content) or raw content.
+		Immutable after creation, so it can be shared by many compressors and decompressors.
+	*/
+	class SLIB_EXPORT ZstdDictionary : public Referable
+	{
+	public:
+		ZstdDictionary();
+
+		~ZstdDictionary();
+
+	public:
+		static Ref<ZstdDictionary> create(const void* data, sl_size size);
+
+		static Ref<ZstdDictionary> create(const Memory& data);
+
+	public:
+		// 0 for raw content dictionary
+		sl_uint32 getId();
+
+		Memory getData();
+
+		const sl_uint8* getContent();
+
+		sl_size getContentSize();
+
+	protected:
+		sl_uint32 m_id;
+		Memory m_data;
+		const sl_uint8* m_content;
+		sl_size m_sizeContent;
+		sl_uint32 m_rep[3];
+		Memory m_entropy;
+
+		friend class _priv_ZstdEncoder;
+		friend class _priv_ZstdDecoder;
+
+	};
+	
+	class SLIB_EXPORT ZstdCompress : public Compressor
+	{
+	public:
+		ZstdCompress();
+
+		~ZstdCompress();
+
+	public:
+		sl_bool isStarted() override;
+
+		sl_bool start(sl_int32 level = 3, sl_bool flagContentChecksum = sl_true);
+
+		sl_bool start(const Ref<ZstdDictionary>& dictionary, sl_int32 level = 3, sl_bool flagContentChecksum = sl_true);
+
+		sl_int32 compress(
+			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed,
+			sl_bool flagFinish) override;
+
+		Memory compress(const void* data, sl_size size, sl_bool flagFinish) override;
+
+		sl_int32 flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
+
+		void abort() override;
+
+	private:
+		sl_bool _start(const Ref<ZstdDictionary>& dictionary, sl_int32 level, sl_bool flagContentChecksum, sl_uint64 sizeContent);
+
+	private:
+		Ref<_priv_ZstdEncoder> m_encoder;
+
+		friend class Zstd;
+
+	};
+	
+	class SLIB_EXPORT ZstdDecompress : public Decompressor
+	{
+	public:
+		ZstdDecompress();
+
+		~ZstdDecompress();
+
+	public:
+		sl_bool isStarted() override;
+
+		sl_bool start();
+
+		// `dictionary` is used for the frames having its ID (or no ID, for raw content dictionary)
+		sl_bool start(const Ref<ZstdDictionary>& dictionary);
+
+		// finishes at the end of the first frame (skippable frames are ignored)
+		sl_int32 decompress(
+			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
+
+		void abort() override;
+
+	private:
+		sl_bool m_flagStarted;
+		Ref<_priv_ZstdDecoder> m_decoder;
+
+	};
+	
+	class SLIB_EXPORT Zstd
+	{
+	public:
+		static Memory compress(const void* data, sl_size size, sl_int32 level = 3);
+
+		static Memory compress(const Memory& data, sl_int32 level = 3);
+
+		static Memory compress(const Ref<ZstdDictionary>& dictionary, const void* data, sl_size size, sl_int32 level = 3);
+
+		static Memory compress(const Ref<ZstdDictionary>& dictionary, const Memory& data, sl_int32 level = 3);
+
+		// decompresses all concatenated frames
+		static Memory decompress(const void* data, sl_size size);
+
+		static Memory decompress(const Memory& data);
+
+		static Memory decompress(const Ref<ZstdDictionary>& dictionary, const void* data, sl_size size);
+
+		static Memory decompress(const Ref<ZstdDictionary>& dictionary, const Memory& data);
+
+		/*
+			Builds a zstd format dictionary from the samples of typical payloads, by selecting
+			the most frequent segments (COVER algorithm) and measuring the entropy statistics.
+			`dictionaryId` = 0 generates a random ID.
+			Returns null when the samples are too small.
+		*/
+		static Memory trainDictionary(const Memory* samples, sl_size nSamples, sl_size sizeDictionary = 112640, sl_uint32 dictionaryId = 0);
+
+		static Memory trainDictionary(const List<Memory>& samples, sl_size sizeDictionary = 112640, sl_uint32 dictionaryId = 0);
+
+	};
+
+}
+
+#endif
@@ -24,10 +24,12 @@
 #define CHECKHEADER_SLIB_DB_HEADER
 
 #include "db/database.h"
+#include "db/database_pool.h"
 
 #include "db/sqlite.h"
 #include "db/mysql.h"
 
 #include "db/redis.h"
+#include "db/redis_client.h"
 
 #endif
@@ -27,11 +27,65 @@
 
 #include "../core/object.h"
 #include "../core/variant.h"
+#include "../core/tuple.h"
+#include "../core/function.h"
+
+#define SLIB_DATABASE_STATEMENT_CACHE_SIZE_DEFAULT 64
+#define SLIB_DATABASE_BATCH_SIZE_DEFAULT 1000
+#define SLIB_DATABASE_ASYNC_QUEUE_LIMIT_DEFAULT 1024
 
 namespace slib
 {
 	
 	class Database;
+	class _priv_DatabaseStatementCache;
+	class _priv_DatabaseExecutor;
+	class HttpServiceContext;
+	class HttpOutputBuffer;
+	class IWriter;
+	template <class T> class DatabaseRowBinding;
+
+	// storage class of a value in the current row
+	enum class DatabaseColumnType
+	{
+		Null = 0,
+		Integer = 1,
+		Float = 2,
+		Text = 3,
+		Blob = 4
+	};
+
+	// column names of a statement, resolved once and shared by the cursors of the statement
+	class SLIB_EXPORT _priv_DatabaseColumns : public Referable
+	{
+	public:
+		CList<String> names;
+		CHashMap<String, sl_int32> indexes;
+
+	public:
+		_priv_DatabaseColumns();
+
+		~_priv_DatabaseColumns();
+
+	public:
+		void add(const String& name);
+
+		SLIB_INLINE sl_uint32 getCount()
+		{
+			return (sl_uint32)(names.getCount());
+		}
+
+		SLIB_INLINE String* getNames()
+		{
+			return names.getData();
+		}
+
+		SLIB_INLINE sl_int32 getIndex(const String& name)
+		{
+			return indexes.getValue_NoLock(name, -1);
+		}
+
+	};
 	
 	class SLIB_EXPORT DatabaseCursor : public Object
 	{
@@ -61,9 +115,15 @@ namespace slib
 		virtual Variant getValue(const String& name);
 	
 
+		virtual DatabaseColumnType getColumnType(sl_uint32 index);
+
+
 		virtual String getString(sl_uint32 index) = 0;
 
 		virtual String getString(const String& name);
+
+		// the returned view is valid until the cursor moves or another value is read
+		virtual StringView getStringView(sl_uint32 index);
 	
 
 		virtual sl_int64 getInt64(sl_uint32 index, sl_int64 defaultValue = 0);
@@ -110,13 +170,273 @@ namespace slib
 		virtual Memory getBlob(const String& name);
 	
 
+		virtual sl_bool isNull(sl_uint32 index);
+
+		sl_bool isNull(const String& name);
+
+
 		virtual sl_bool moveNext() = 0;
-	
+
+
+		/*
+			Streaming export of the remaining rows. Values are written through a fixed-size chunk as they are read,
+			without building row maps, a JSON tree or the whole text.
+			JSON: an array of objects keyed by the column names. CSV (RFC 4180): optional header line, CRLF line breaks.
+			Blobs are written in Base64. Returns the number of written rows, or -1 when the writer fails.
+		*/
+		sl_int64 writeJson(IWriter* writer);
+
+		sl_int64 writeJson(HttpOutputBuffer* output);
+
+		sl_int64 writeCsv(IWriter* writer, sl_bool flagHeader = sl_true);
+
+		sl_int64 writeCsv(HttpOutputBuffer* output, sl_bool flagHeader = sl_true);
+
+
+		/*
+			Typed access: the values are read directly into the C++ variables, without building `HashMap` or `Variant`
+			for each row. Supported types are sl_bool, sl_int32, sl_uint32, sl_int64, sl_uint64, float, double,
+			String, Memory, Time and Variant.
+		*/
+		SLIB_INLINE void readValue(sl_uint32 index, sl_bool& _out)
+		{
+			_out = getInt32(index) != 0;
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, sl_int32& _out)
+		{
+			_out = getInt32(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, sl_uint32& _out)
+		{
+			_out = getUint32(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, sl_int64& _out)
+		{
+			_out = getInt64(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, sl_uint64& _out)
+		{
+			_out = getUint64(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, float& _out)
+		{
+			_out = getFloat(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, double& _out)
+		{
+			_out = getDouble(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, String& _out)
+		{
+			_out = getString(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, Memory& _out)
+		{
+			_out = getBlob(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, Time& _out)
+		{
+			_out = getTime(index);
+		}
+
+		SLIB_INLINE void readValue(sl_uint32 index, Variant& _out)
+		{
+			_out = getValue(index);
+		}
+
+		// moves to the next row, and reads the columns in order into `values`
+		template <class... ARGS>
+		SLIB_INLINE sl_bool fetchInto(ARGS&... values)
+		{
+			if (moveNext()) {
+				_readValues(0, values...);
+				return sl_true;
+			}
+			return sl_false;
+		}
+
+		template <class... TYPES>
+		SLIB_INLINE sl_bool fetchInto(Tuple<TYPES...>& row)
+		{
+			if (moveNext()) {
+				row.invoke(_priv_ValuesReader(this));
+				return sl_true;
+			}
+			return sl_false;
+		}
+
+		// reads the columns by the names bound in `binding`
+		template <class T>
+		SLIB_INLINE sl_bool fetchInto(DatabaseRowBinding<T>& binding, T& row)
+		{
+			if (moveNext()) {
+				binding.read(this, row);
+				return sl_true;
+			}
+			return sl_false;
+		}
+
+		// fetches up to `nMaxRows` rows into the per-column arrays, and returns the number of fetched rows
+		template <class... ARGS>
+		sl_uint32 fetchColumns(sl_uint32 nMaxRows, ARGS*... columns)
+		{
+			sl_uint32 nRows = 0;
+			while (nRows < nMaxRows && moveNext()) {
+				_readColumns(nRows, 0, columns...);
+				nRows++;
+			}
+			return nRows;
+		}
+
+	private:
+		sl_int64 _writeJson(IWriter* writer, const Function<void(Memory&)>& onChunk);
+
+		sl_int64 _writeCsv(IWriter* writer, const Function<void(Memory&)>& onChunk, sl_bool flagHeader);
+
+		SLIB_INLINE void _readValues(sl_uint32)
+		{
+		}
+
+		template <class T, class... ARGS>
+		SLIB_INLINE void _readValues(sl_uint32 index, T& value, ARGS&... values)
+		{
+			readValue(index, value);
+			_readValues(index + 1, values...);
+		}
+
+		SLIB_INLINE void _readColumns(sl_uint32, sl_uint32)
+		{
+		}
+
+		template <class T, class... ARGS>
+		SLIB_INLINE void _readColumns(sl_uint32 row, sl_uint32 index, T* column, ARGS*... columns)
+		{
+			readValue(index, column[row]);
+			_readColumns(row, index + 1, columns...);
+		}
+
+		class _priv_ValuesReader
+		{
+		public:
+			DatabaseCursor* cursor;
+
+		public:
+			SLIB_INLINE _priv_ValuesReader(DatabaseCursor* _cursor): cursor(_cursor) {}
+
+			template <class... ARGS>
+			SLIB_INLINE void operator()(ARGS&... values) const
+			{
+				cursor->_readValues(0, values...);
+			}
+		};
+
 	protected:
 		Ref<Database> m_db;
+		Ref<_priv_DatabaseColumns> m_columns;
+		String m_stringView;
+
+		template <class T> friend class DatabaseRowBinding;
+
+	};
+
+	/*
+		Binds result columns to the fields of `T` by name. The column indexes are resolved once for each statement
+		(cursors of a cached statement share the resolution), so a binding should not be used by multiple threads at once.
+
+			DatabaseRowBinding<User> binding;
+			binding.bind("id", &User::id).bind("name", &User::name);
+			User user;
+			while (cursor->fetchInto(binding, user)) { ... }
+	*/
+	template <class T>
+	class DatabaseRowBinding
+	{
+	public:
+		template <class FIELD>
+		DatabaseRowBinding& bind(const String& columnName, FIELD T::* field)
+		{
+			Item item;
+			item.name = columnName;
+			item.index = -1;
+			item.reader = [field](DatabaseCursor* cursor, sl_uint32 index, T& row) {
+				cursor->readValue(index, row.*field);
+			};
+			m_items.add_NoLock(Move(item));
+			m_columns.setNull();
+			return *this;
+		}
+
+		void read(DatabaseCursor* cursor, T& row)
+		{
+			Item* items = m_items.getData();
+			sl_size n = m_items.getCount();
+			if (cursor->m_columns.isNull() || cursor->m_columns != m_columns) {
+				for (sl_size i = 0; i < n; i++) {
+					items[i].index = cursor->getColumnIndex(items[i].name);
+				}
+				m_columns = cursor->m_columns;
+			}
+			for (sl_size i = 0; i < n; i++) {
+				if (items[i].index >= 0) {
+					items[i].reader(cursor, (sl_uint32)(items[i].index), row);
+				}
+			}
+		}
+
+	private:
+		struct Item
+		{
+			String name;
+			sl_int32 index;
+			Function<void(DatabaseCursor*, sl_uint32, T&)> reader;
+		};
+		CList<Item> m_items;
+		Ref<_priv_DatabaseColumns> m_columns;
 
 	};
 	
+	class SLIB_EXPORT DatabaseBatchError
+	{
+	public:
+		// index of the failed row
+		sl_size row;
+		// count of the rows from `row` failed as a whole, when it is not known which rows are applied
+		sl_size count;
+		String message;
+
+	public:
+		DatabaseBatchError();
+
+		~DatabaseBatchError();
+
+	};
+
+	class SLIB_EXPORT DatabaseAsyncResult
+	{
+	public:
+		sl_bool flagError;
+		String errorMessage;
+		// result of `executeAsync()`
+		sl_int64 affectedRowsCount;
+		// result of `queryAsync()`
+		List< HashMap<String, Variant> > rows;
+
+	public:
+		DatabaseAsyncResult();
+
+		~DatabaseAsyncResult();
+
+	};
+
 	class SLIB_EXPORT DatabaseStatement : public Object
 	{
 		SLIB_DECLARE_OBJECT
@@ -129,6 +449,9 @@ namespace slib
 	public:
 		Ref<Database> getDatabase();
 
+		// error of the last execution, returns the error of the database by default
+		virtual String getErrorMessage();
+
 		virtual sl_int64 executeBy(const Variant* params = sl_null, sl_uint32 nParams = 0) = 0;
 
 		SLIB_INLINE sl_int64 execute()
@@ -143,6 +466,16 @@ namespace slib
 			return executeBy(params, sizeof...(args));
 		}
 
+		/*
+			Executes the statement once for each row. `params` holds `nRows * nParamsPerRow` values.
+			Rows are grouped by the batch size of the database: in a transaction for SQLite, and in multi-row `INSERT ... VALUES` in a transaction for MySQL.
+			Returns the total count of affected rows, and the failed rows are reported to `outErrors`.
+			A failed multi-row statement is retried row by row only when it is rolled back, otherwise one error covers the rows of the statement
+		*/
+		virtual sl_int64 executeManyBy(const Variant* params, sl_uint32 nParamsPerRow, sl_size nRows, List<DatabaseBatchError>* outErrors = sl_null);
+
+		sl_int64 executeMany(const List<VariantList>& rows, List<DatabaseBatchError>* outErrors = sl_null);
+
 		virtual Ref<DatabaseCursor> queryBy(const Variant* params = sl_null, sl_uint32 nParams = 0) = 0;
 	
 		SLIB_INLINE Ref<DatabaseCursor> query()
@@ -199,9 +532,17 @@ namespace slib
 			return getValueForQueryResultBy(params, sizeof...(args));
 		}
 
+	protected:
+		// executes row by row, grouping `nBatch` rows in a transaction. `indexRowStart` is the row index reported in the errors
+		sl_int64 _executeManyByRows(const Variant* params, sl_uint32 nParamsPerRow, sl_size nRows, sl_size indexRowStart, List<DatabaseBatchError>* outErrors);
+
+		static Array<Variant> _flattenRows(const List<VariantList>& rows, sl_uint32& nParamsPerRow, sl_size& nRows, List<DatabaseBatchError>* outErrors);
+
 	protected:
 		Ref<Database> m_db;
 
+		friend class Database;
+
 	};
 	
 	class SLIB_EXPORT Database : public Object
@@ -279,7 +620,106 @@ namespace slib
 		sl_bool isLoggingErrors();
 		
 		void setLoggingErrors(sl_bool flag);
-		
+
+		// executes the SQL for each row of params. see `DatabaseStatement::executeManyBy()`
+		sl_int64 executeManyBy(const String& sql, const Variant* params, sl_uint32 nParamsPerRow, sl_size nRows, List<DatabaseBatchError>* outErrors = sl_null);
+
+		sl_int64 executeMany(const String& sql, const List<VariantList>& rows, List<DatabaseBatchError>* outErrors = sl_null);
+
+		// rows grouped in a transaction or a multi-row statement by `executeMany()` (default: SLIB_DATABASE_BATCH_SIZE_DEFAULT)
+		sl_uint32 getBatchSize();
+
+		void setBatchSize(sl_uint32 size);
+
+		/*
+			Prepared statements used by `execute()` and `query()` with parameters are cached per connection
+			(LRU, keyed by SQL text), and are reset and rebound on reuse. A cached statement still used by a cursor
+			is not shared: a temporary statement is prepared for the nested query.
+			0 disables the cache (default: SLIB_DATABASE_STATEMENT_CACHE_SIZE_DEFAULT)
+		*/
+		sl_uint32 getStatementCacheSize();
+
+		void setStatementCacheSize(sl_uint32 size);
+
+		// finalizes the cached statements, called automatically after executing `CREATE`, `ALTER`, `DROP` and `RENAME`
+		void clearStatementCache();
+
+		sl_uint64 getStatementCacheHitCount();
+
+		sl_uint64 getStatementCacheMissCount();
+
+		/*
+			Asynchronous calls are queued to the executor of this database, a dedicated thread started on the first call,
+			and are run one by one on this connection. The callbacks are invoked on the executor thread.
+			A call is rejected (returns `sl_false`) while the queue is full.
+		*/
+		sl_bool dispatchAsync(const Function<void(Database*)>& task);
+
+		sl_bool executeAsyncBy(const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		sl_bool queryAsyncBy(const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		sl_bool executeAsync(const String& sql, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		sl_bool queryAsync(const String& sql, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		template <class... ARGS>
+		SLIB_INLINE sl_bool executeAsync(const String& sql, const Function<void(DatabaseAsyncResult&)>& callback, ARGS&&... args)
+		{
+			Variant params[] = {Forward<ARGS>(args)...};
+			return executeAsyncBy(sql, params, sizeof...(args), callback);
+		}
+
+		template <class... ARGS>
+		SLIB_INLINE sl_bool queryAsync(const String& sql, const Function<void(DatabaseAsyncResult&)>& callback, ARGS&&... args)
+		{
+			Variant params[] = {Forward<ARGS>(args)...};
+			return queryAsyncBy(sql, params, sizeof...(args), callback);
+		}
+
+		/*
+			Suspends the response of `context` (see `HttpServiceContext::setAsynchronousResponse()`) while the task is queued,
+			and completes the response after the task (or the callback) returns.
+			When the call is rejected, the response is not suspended, so the handler can respond immediately.
+		*/
+		sl_bool dispatchAsync(const Ref<HttpServiceContext>& context, const Function<void(Database*)>& task);
+
+		sl_bool executeAsyncBy(const Ref<HttpServiceContext>& context, const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		sl_bool queryAsyncBy(const Ref<HttpServiceContext>& context, const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		sl_bool executeAsync(const Ref<HttpServiceContext>& context, const String& sql, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		sl_bool queryAsync(const Ref<HttpServiceContext>& context, const String& sql, const Function<void(DatabaseAsyncResult&)>& callback);
+
+		template <class... ARGS>
+		SLIB_INLINE sl_bool executeAsync(const Ref<HttpServiceContext>& context, const String& sql, const Function<void(DatabaseAsyncResult&)>& callback, ARGS&&... args)
+		{
+			Variant params[] = {Forward<ARGS>(args)...};
+			return executeAsyncBy(context, sql, params, sizeof...(args), callback);
+		}
+
+		template <class... ARGS>
+		SLIB_INLINE sl_bool queryAsync(const Ref<HttpServiceContext>& context, const String& sql, const Function<void(DatabaseAsyncResult&)>& callback, ARGS&&... args)
+		{
+			Variant params[] = {Forward<ARGS>(args)...};
+			return queryAsyncBy(context, sql, params, sizeof...(args), callback);
+		}
+
+		// maximum number of queued (including running) asynchronous calls. 0 means unlimited (default: SLIB_DATABASE_ASYNC_QUEUE_LIMIT_DEFAULT)
+		sl_uint32 getAsyncQueueLimit();
+
+		void setAsyncQueueLimit(sl_uint32 limit);
+
+		// number of queued (including running) asynchronous calls
+		sl_uint32 getAsyncQueueLength();
+
+		sl_uint32 getAsyncQueuePeakLength();
+
+		sl_uint64 getAsyncCompletedCount();
+
+		sl_uint64 getAsyncRejectedCount();
+
 	protected:
 		virtual sl_int64 _execute(const String& sql);
 		
@@ -288,6 +728,12 @@ namespace slib
 		virtual sl_int64 _executeBy(const String& sql, const Variant* params, sl_uint32 nParams);
 		
 		virtual Ref<DatabaseCursor> _queryBy(const String& sql, const Variant* params, sl_uint32 nParams);
+
+		// begins a transaction for a batch, unless the connection is already in a transaction. returns `sl_true` when it is begun
+		virtual sl_bool _beginBatch();
+
+		// commits the transaction begun by `_beginBatch()`
+		virtual sl_bool _endBatch();
 		
 		void _logSQL(const String& sql);
 		
@@ -297,9 +743,28 @@ namespace slib
 		
 		void _logError(const String& sql, const Variant* params, sl_uint32 nParams);
 
+		// `flagCached` is set when the returned statement is owned by the cache, then `_releaseStatement()` should be called after use
+		Ref<DatabaseStatement> _prepareCachedStatement(const String& sql, sl_bool& flagCached);
+
+		void _releaseStatement(DatabaseStatement* statement, sl_bool flagCached);
+
+		void _checkSchemaChange(const String& sql);
+
 	protected:
 		sl_bool m_flagLogSQL;
 		sl_bool m_flagLogErrors;
+
+		sl_uint32 m_sizeStatementCache;
+		Ref<_priv_DatabaseStatementCache> m_statementCache;
+		sl_uint64 m_nStatementCacheHits;
+		sl_uint64 m_nStatementCacheMisses;
+
+		sl_uint32 m_sizeBatch;
+
+		sl_uint32 m_nAsyncQueueLimit;
+		Ref<_priv_DatabaseExecutor> m_executor;
+
+		friend class DatabaseStatement;
 	
 	};
 
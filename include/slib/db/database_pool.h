@@ -0,0 +1,190 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_DB_DATABASE_POOL
+#define CHECKHEADER_SLIB_DB_DATABASE_POOL
+
+#include "database.h"
+
+#include "../core/function.h"
+#include "../core/event.h"
+
+namespace slib
+{
+
+	class DatabasePool;
+
+	class SLIB_EXPORT DatabasePoolParam
+	{
+	public:
+		// opens a new connection
+		Function< Ref<Database>() > onConnect;
+
+		// returns `sl_false` when the connection is broken
+		Function< sl_bool(Database*) > onValidate;
+
+		// connections opened on creation, and kept open while idle (default: 0)
+		sl_uint32 minimumConnectionsCount;
+
+		// default: 10
+		sl_uint32 maximumConnectionsCount;
+
+		// milliseconds, idle connections above the minimum count are closed after this time. 0 means never (default: 300000)
+		sl_uint32 idleTimeout;
+
+		// milliseconds, maximum time to wait for a free connection. negative means infinite (default: 30000)
+		sl_int32 waitTimeout;
+
+		// milliseconds, connections idle longer than this are validated by `onValidate` before lending (default: 5000)
+		sl_uint32 validationInterval;
+
+		// statement cache size applied to each connection (default: SLIB_DATABASE_STATEMENT_CACHE_SIZE_DEFAULT)
+		sl_uint32 statementCacheSize;
+
+	public:
+		DatabasePoolParam();
+
+		~DatabasePoolParam();
+
+	};
+
+	/*
+		A connection leased from `DatabasePool`, returned to the pool on destruction.
+		Cursors and statements of the connection should be released before the lease.
+	*/
+	class SLIB_EXPORT DatabaseLease
+	{
+	public:
+		DatabaseLease();
+
+		DatabaseLease(DatabaseLease&& other);
+
+		~DatabaseLease();
+
+	public:
+		DatabaseLease& operator=(DatabaseLease&& other);
+
+	public:
+		SLIB_INLINE sl_bool isNull() const
+		{
+			return m_db.isNull();
+		}
+
+		SLIB_INLINE sl_bool isNotNull() const
+		{
+			return m_db.isNotNull();
+		}
+
+		SLIB_INLINE Database* get() const
+		{
+			return m_db.get();
+		}
+
+		SLIB_INLINE const Ref<Database>& getDatabase() const
+		{
+			return m_db;
+		}
+
+		SLIB_INLINE Database* operator->() const
+		{
+			return m_db.get();
+		}
+
+		// returns the connection to the pool
+		void release();
+
+		// closes the connection instead of returning it (for example, after a connection error)
+		void discard();
+
+	private:
+		DatabaseLease(const DatabaseLease& other) = delete;
+
+		DatabaseLease& operator=(const DatabaseLease& other) = delete;
+
+	private:
+		Ref<DatabasePool> m_pool;
+		Ref<Database> m_db;
+
+		friend class DatabasePool;
+
+	};
+
+	class SLIB_EXPORT DatabasePool : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		DatabasePool();
+
+		~DatabasePool();
+
+	public:
+		static Ref<DatabasePool> create(const DatabasePoolParam& param);
+
+	public:
+		// waits up to `waitTimeout` of the param. returns null lease on timeout, connection failure or after `close()`
+		DatabaseLease acquire();
+
+		// milliseconds, negative means infinite
+		DatabaseLease acquire(sl_int32 timeout);
+
+		// leased, idle and opening connections
+		sl_uint32 getConnectionsCount();
+
+		sl_uint32 getIdleConnectionsCount();
+
+		// closes the idle connections expired by `idleTimeout`, also done on each acquire and release
+		void closeExpiredConnections();
+
+		// closes the idle connections and rejects further leases. leased connections are closed on release
+		void close();
+
+		sl_bool isClosed();
+
+	protected:
+		Ref<Database> _connect();
+
+		void _release(Ref<Database>& db, sl_bool flagDiscard);
+
+		void _collectExpired_NoLock(sl_int64 now, CList< Ref<Database> >& expired);
+
+	protected:
+		struct IdleConnection
+		{
+			Ref<Database> db;
+			sl_int64 timeLastUsed;
+		};
+
+		DatabasePoolParam m_param;
+
+		CList<IdleConnection> m_listIdle;
+		sl_uint32 m_nConnections;
+		sl_bool m_flagClosed;
+		Ref<Event> m_eventRelease;
+
+		friend class DatabaseLease;
+
+	};
+
+}
+
+#endif
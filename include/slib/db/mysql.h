@@ -24,6 +24,7 @@
 #define CHECKHEADER_SLIB_DB_MYSQL
 
 #include "database.h"
+#include "database_pool.h"
 
 #if defined(SLIB_PLATFORM_IS_DESKTOP)
 #define SLIB_DATABASE_SUPPORT_MYSQL
@@ -66,6 +67,9 @@ namespace slib
 		static Ref<MySQL_Database> connect(const MySQL_Param& param);
 
 		static Ref<MySQL_Database> connect(const MySQL_Param& param, String& outErrorMessage);
+
+		// `onConnect` of `poolParam` is replaced, and `ping()` is used as `onValidate` if it is not set
+		static Ref<DatabasePool> createPool(const MySQL_Param& param, const DatabasePoolParam& poolParam);
 	
 	public:
 		virtual sl_bool ping() = 0;
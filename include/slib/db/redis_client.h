@@ -0,0 +1,266 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_DB_REDIS_CLIENT
+#define CHECKHEADER_SLIB_DB_REDIS_CLIENT
+
+#include "definition.h"
+
+#include "../core/object.h"
+#include "../core/variant.h"
+#include "../core/function.h"
+#include "../core/linked_list.h"
+#include "../network/async.h"
+
+namespace slib
+{
+
+	enum class RedisReplyType
+	{
+		Null = 0,
+		Status = 1,
+		Error = 2,
+		Integer = 3,
+		String = 4,
+		Array = 5,
+		// RESP3 types
+		Double = 6,
+		Boolean = 7,
+		BigNumber = 8,
+		Map = 9, // elements are key-value pairs
+		Set = 10,
+		Push = 11
+	};
+
+	class SLIB_EXPORT RedisReply
+	{
+	public:
+		RedisReplyType type;
+		sl_int64 integer; // Integer, Boolean
+		double number; // Double
+		String string; // Status, Error, String, BigNumber
+		List<RedisReply> elements; // Array, Map, Set, Push
+
+	public:
+		RedisReply();
+
+		RedisReply(const RedisReply& other);
+
+		RedisReply(RedisReply&& other);
+
+		~RedisReply();
+
+	public:
+		RedisReply& operator=(const RedisReply& other);
+
+		RedisReply& operator=(RedisReply&& other);
+
+	public:
+		static RedisReply error(const String& message);
+
+		sl_bool isNull() const;
+
+		sl_bool isError() const;
+
+		String getString() const;
+
+		sl_int64 getInteger(sl_int64 def = 0) const;
+
+		// arrays are converted to `VariantList`, and maps to `VariantMap`
+		Variant toVariant() const;
+
+	};
+
+	class AsyncRedisClient;
+	class _priv_RedisParser;
+
+	class SLIB_EXPORT AsyncRedisClientParam
+	{
+	public:
+		String host; // default: 127.0.0.1
+		sl_uint16 port; // default: 6379
+		String user;
+		String password;
+		sl_uint32 databaseIndex;
+		sl_bool flagResp3; // default: false, uses `HELLO 3` when set
+		sl_bool flagLogError; // default: true
+
+		Ref<AsyncIoLoop> ioLoop;
+
+		Function<void(AsyncRedisClient*, sl_bool flagError)> onConnect;
+		// called when the connection is lost. the pending commands are failed with error replies
+		Function<void(AsyncRedisClient*)> onError;
+		// messages of the subscribed channels (`message`, `pmessage`), and other RESP3 push replies (`channel` is empty)
+		Function<void(AsyncRedisClient*, const String& channel, RedisReply& message)> onMessage;
+
+	public:
+		AsyncRedisClientParam();
+
+		~AsyncRedisClientParam();
+
+	};
+
+	/*
+		Commands may be issued from any thread. The commands issued while a write is in progress are pipelined into
+		the next write, and the callbacks are called on the I/O loop in the order of the commands.
+	*/
+	class SLIB_EXPORT AsyncRedisClient : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		AsyncRedisClient();
+
+		~AsyncRedisClient();
+
+	public:
+		static Ref<AsyncRedisClient> create(const AsyncRedisClientParam& param);
+
+	public:
+		void close();
+
+		sl_bool isClosed();
+
+		sl_bool isConnected();
+
+		Ref<AsyncIoLoop> getIoLoop();
+
+		// command and arguments, binary-safe for `Memory` arguments
+		sl_bool executeBy(const Variant* args, sl_uint32 nArgs, const Function<void(RedisReply&)>& callback);
+
+		template <class... ARGS>
+		SLIB_INLINE sl_bool execute(const Function<void(RedisReply&)>& callback, ARGS&&... args)
+		{
+			Variant params[] = {Forward<ARGS>(args)...};
+			return executeBy(params, sizeof...(args), callback);
+		}
+
+		// sends the commands between `MULTI` and `EXEC` in one write. `callback` receives the reply of `EXEC`
+		sl_bool executeTransaction(const List<VariantList>& commands, const Function<void(RedisReply&)>& callback);
+
+		sl_bool get(const String& key, const Function<void(RedisReply&)>& callback);
+
+		// `expiry` in milliseconds, 0 means no expiry
+		sl_bool set(const String& key, const Variant& value, sl_uint64 expiry = 0, const Function<void(RedisReply&)>& callback = sl_null);
+
+		sl_bool del(const String& key, const Function<void(RedisReply&)>& callback = sl_null);
+
+		sl_bool incrby(const String& key, sl_int64 n, const Function<void(RedisReply&)>& callback = sl_null);
+
+		sl_bool publish(const String& channel, const Variant& message, const Function<void(RedisReply&)>& callback = sl_null);
+
+		// messages are delivered to `onMessage`. With RESP2, only subscription commands can be used until all channels and patterns are unsubscribed
+		sl_bool subscribe(const String& channel, const Function<void(RedisReply&)>& callback = sl_null);
+
+		sl_bool unsubscribe(const String& channel, const Function<void(RedisReply&)>& callback = sl_null);
+
+		sl_bool psubscribe(const String& pattern, const Function<void(RedisReply&)>& callback = sl_null);
+
+		sl_bool punsubscribe(const String& pattern, const Function<void(RedisReply&)>& callback = sl_null);
+
+	protected:
+		struct Request
+		{
+			Function<void(RedisReply&)> callback;
+			sl_bool flagSubscription;
+		};
+
+		sl_bool _execute(const Variant* args, sl_uint32 nArgs, const Function<void(RedisReply&)>& callback, sl_bool flagSubscription);
+
+		// returns `sl_false` when the buffer can't be allocated, and the partially written command should be discarded by restoring `m_sizeWrite`
+		sl_bool _encodeCommand(const Variant* args, sl_uint32 nArgs);
+
+		sl_bool _reserveWrite(sl_size size);
+
+		sl_bool _writeBytes(const void* data, sl_size size);
+
+		void _flush_NoLock();
+
+		void _onConnect(AsyncTcpSocket* socket, const SocketAddress& address, sl_bool flagError);
+
+		void _onSend(AsyncStreamResult* result);
+
+		void _receive();
+
+		void _onReceive(AsyncStreamResult* result);
+
+		void _processReply(RedisReply& reply);
+
+		void _onError();
+
+	protected:
+		AsyncRedisClientParam m_param;
+		Ref<AsyncTcpSocket> m_socket;
+		sl_bool m_flagConnected;
+		sl_bool m_flagClosed;
+		// count of the subscribed channels and patterns, from the last confirmation of (un)subscription
+		sl_int64 m_nSubscriptions;
+
+		CLinkedList<Request> m_queueRequests;
+
+		Memory m_bufWrite;
+		sl_size m_sizeWrite;
+		Memory m_bufSending;
+		sl_bool m_flagSending;
+
+		Memory m_bufRead;
+		sl_size m_sizeRead;
+		sl_size m_posRead;
+		Ref<_priv_RedisParser> m_parser;
+
+		Function<void(AsyncStreamResult*)> m_callbackSend;
+		Function<void(AsyncStreamResult*)> m_callbackReceive;
+
+	};
+
+	// distributes commands over the clients connected on multiple I/O loops
+	class SLIB_EXPORT AsyncRedisClientPool : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		AsyncRedisClientPool();
+
+		~AsyncRedisClientPool();
+
+	public:
+		// creates an I/O loop for each client when `param.ioLoop` is null
+		static Ref<AsyncRedisClientPool> create(const AsyncRedisClientParam& param, sl_uint32 nClients);
+
+	public:
+		// returns the next client in round-robin order, reconnecting the closed clients
+		Ref<AsyncRedisClient> getClient();
+
+		void close();
+
+	protected:
+		AsyncRedisClientParam m_param;
+		List< Ref<AsyncRedisClient> > m_clients;
+		List< Ref<AsyncIoLoop> > m_loops;
+		sl_uint32 m_indexNext;
+		sl_bool m_flagClosed;
+
+	};
+
+}
+
+#endif
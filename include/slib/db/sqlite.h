@@ -24,10 +24,115 @@
 #define CHECKHEADER_SLIB_DB_SQLITE
 
 #include "database.h"
+#include "database_pool.h"
 
 namespace slib
 {
 
+	enum class SQLiteJournalMode
+	{
+		Default = 0,
+		Delete = 1,
+		Truncate = 2,
+		Persist = 3,
+		Memory = 4,
+		WAL = 5,
+		Off = 6
+	};
+
+	enum class SQLiteSynchronousMode
+	{
+		Default = 0,
+		Off = 1,
+		Normal = 2,
+		Full = 3,
+		Extra = 4
+	};
+
+	enum class SQLiteTempStore
+	{
+		Default = 0,
+		File = 1,
+		Memory = 2
+	};
+
+	// `Default` values leave the setting of SQLite unchanged
+	class SLIB_EXPORT SQLiteParam
+	{
+	public:
+		String path;
+
+		// default: sl_true
+		sl_bool flagCreate;
+
+		// ignored when `flagCreate` is set
+		sl_bool flagReadonly;
+
+		// opens the connection in shared-cache mode
+		sl_bool flagSharedCache;
+
+		// journal mode is not changed on read-only connections
+		SQLiteJournalMode journalMode;
+
+		SQLiteSynchronousMode synchronousMode;
+
+		// bytes, `PRAGMA mmap_size`. negative means default (default: -1)
+		sl_int64 mmapSize;
+
+		// `PRAGMA cache_size`: pages when positive, KiB when negative. 0 means default
+		sl_int32 cacheSize;
+
+		SQLiteTempStore tempStore;
+
+		// milliseconds, total time to retry a locked database. 0 means no retry
+		sl_uint32 busyTimeout;
+
+		// milliseconds, the retry interval starts at 1ms and doubles up to this value (default: 100)
+		sl_uint32 busyBackoffMax;
+
+		// executed after the settings above, for example "PRAGMA foreign_keys=ON"
+		List<String> pragmas;
+
+	public:
+		SQLiteParam();
+
+		~SQLiteParam();
+
+	};
+
+	/*
+		Process-wide settings applied by `sqlite3_config()`.
+		Effective only when applied before the first connection is opened.
+	*/
+	class SLIB_EXPORT SQLiteConfig
+	{
+	public:
+		// bytes of a page cache slot (page size plus header, for example 4096 + 256). 0 means not used
+		sl_uint32 pageCacheSlotSize;
+
+		// number of slots in the page cache arena allocated by SLib
+		sl_uint32 pageCacheSlotsCount;
+
+		// default lookaside memory of each connection. 0 means default
+		sl_uint32 lookasideSlotSize;
+
+		sl_uint32 lookasideSlotsCount;
+
+		// bytes, default and maximum of `mmap_size`. negative means default
+		sl_int64 mmapSizeDefault;
+
+		sl_int64 mmapSizeMax;
+
+		// disabling memory statistics removes a global mutex from allocations (default: sl_true)
+		sl_bool flagMemoryStatus;
+
+	public:
+		SQLiteConfig();
+
+		~SQLiteConfig();
+
+	};
+
 	class SLIB_EXPORT SQLiteDatabase : public Database
 	{
 		SLIB_DECLARE_OBJECT
@@ -38,8 +143,56 @@ namespace slib
 		~SQLiteDatabase();
 
 	public:
+		static Ref<SQLiteDatabase> connect(const SQLiteParam& param);
+
 		static Ref<SQLiteDatabase> connect(const String& filePath, sl_bool flagCreate = sl_true, sl_bool flagReadonly = sl_false);
 
+		// returns `sl_false` when SQLite is already initialized or the settings are rejected
+		static sl_bool configure(const SQLiteConfig& config);
+
+	};
+
+	/*
+		Read-only connections are leased in parallel, while writes are serialized on a single writer connection.
+		The database is switched to WAL journal mode, so that readers are not blocked by the writer.
+	*/
+	class SLIB_EXPORT SQLiteDatabasePool : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		SQLiteDatabasePool();
+
+		~SQLiteDatabasePool();
+
+	public:
+		// `onConnect` and `onValidate` of `readerParam` are ignored
+		static Ref<SQLiteDatabasePool> create(const String& filePath, const DatabasePoolParam& readerParam);
+
+		// `param` is applied to the writer and the readers (opened read-only). `journalMode` is forced to WAL
+		static Ref<SQLiteDatabasePool> create(const SQLiteParam& param, const DatabasePoolParam& readerParam);
+
+		static Ref<SQLiteDatabasePool> create(const String& filePath, sl_uint32 maximumReadersCount = 4);
+
+	public:
+		DatabaseLease acquireReader();
+
+		DatabaseLease acquireReader(sl_int32 timeout);
+
+		DatabaseLease acquireWriter();
+
+		DatabaseLease acquireWriter(sl_int32 timeout);
+
+		Ref<DatabasePool> getReaderPool();
+
+		Ref<DatabasePool> getWriterPool();
+
+		void close();
+
+	protected:
+		Ref<DatabasePool> m_poolReaders;
+		Ref<DatabasePool> m_poolWriter;
+
 	};
 
 }
@@ -969,6 +969,49 @@ namespace slib
 	BigInt operator<<(const BigInt& a, sl_size n) noexcept;
 	
 	BigInt operator>>(const BigInt& a, sl_size n) noexcept;
+	
+
+	/*
+		Pre-computed Montgomery parameters for an odd modulus M > 0,
+		reusable for repeated modular operations (e.g. RSA keys)
+	*/
+	class SLIB_EXPORT MontgomeryContext : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		MontgomeryContext() noexcept;
+
+		~MontgomeryContext() noexcept;
+
+	public:
+		static Ref<MontgomeryContext> create(const BigInt& M) noexcept;
+
+	public:
+		const BigInt& getModulus() const noexcept;
+
+		// C = A^E mod M, (E >= 0)
+		sl_bool pow(CBigInt& C, const CBigInt& A, const CBigInt& E) const noexcept;
+
+		BigInt pow(const BigInt& A, const BigInt& E) const noexcept;
+
+		// C = A * B mod M
+		sl_bool mulMod(CBigInt& C, const CBigInt& A, const CBigInt& B) const noexcept;
+
+		BigInt mulMod(const BigInt& A, const BigInt& B) const noexcept;
+
+	private:
+		sl_bool _initialize(const CBigInt& M) noexcept;
+
+	private:
+		BigInt m_modulus;
+		sl_size m_n;
+		sl_uint64 m_MI;
+		Memory m_data;
+
+		friend class CBigInt;
+
+	};
 
 
 }
@@ -174,6 +174,14 @@ namespace slib
 	class AsyncUdpSocket;
 	class AsyncUdpSocketInstance;
 
+	class SLIB_EXPORT AsyncUdpDatagram
+	{
+	public:
+		SocketAddress address;
+		void* data;
+		sl_uint32 size;
+	};
+
 	class SLIB_EXPORT AsyncUdpSocketParam
 	{
 	public:
@@ -186,8 +194,16 @@ namespace slib
 		sl_bool flagLogError; // default: true
 		sl_uint32 packetSize; // default: 65536
 		Ref<AsyncIoLoop> ioLoop;
+
+		// datagrams received or sent by a system call (recvmmsg/sendmmsg on Linux), using a receive buffer of `batchSize * packetSize` bytes. 1 disables batching (default: 1)
+		sl_uint32 batchSize;
+		// UDP_GRO (Linux): datagrams of a flow coalesced by the kernel are received at once and delivered one by one. `packetSize` should be 65536 (default: false)
+		sl_bool flagGro;
 		
 		Function<void(AsyncUdpSocket*, const SocketAddress&, void* data, sl_uint32 sizeReceived)> onReceiveFrom;
+
+		// called instead of `onReceiveFrom` when set. the data are valid only in the callback
+		Function<void(AsyncUdpSocket*, AsyncUdpDatagram* datagrams, sl_uint32 count)> onReceiveBatch;
 		
 	public:
 		AsyncUdpSocketParam();
@@ -229,17 +245,23 @@ namespace slib
 		sl_bool sendTo(const SocketAddress& addressTo, const void* data, sl_uint32 size);
 		
 		sl_bool sendTo(const SocketAddress& addressTo, const Memory& mem);
+
+		// sends `mem` as datagrams of `segmentSize` bytes (the last one can be shorter), segmented by the kernel (UDP_SEGMENT) where supported
+		sl_bool sendToSegments(const SocketAddress& addressTo, const Memory& mem, sl_uint32 segmentSize);
 		
 	protected:
 		Ref<AsyncUdpSocketInstance> _getIoInstance();
 		
 		void _onReceive(const SocketAddress& address, void* data, sl_uint32 sizeReceived);
+
+		void _onReceiveBatch(AsyncUdpDatagram* datagrams, sl_uint32 count);
 		
 	protected:
 		static Ref<AsyncUdpSocketInstance> _createInstance(const Ref<Socket>& socket, sl_uint32 packetSize);
 		
 	protected:
 		Function<void(AsyncUdpSocket*, const SocketAddress&, void* data, sl_uint32 sizeReceived)> m_onReceiveFrom;
+		Function<void(AsyncUdpSocket*, AsyncUdpDatagram* datagrams, sl_uint32 count)> m_onReceiveBatch;
 		
 		friend class AsyncUdpSocketInstance;
 		
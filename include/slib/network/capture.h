@@ -29,6 +29,7 @@
 	
 		libpcap (unix) and winpcap (win32)
 		, raw sockets, packet sockets (linux)
+		, memory-mapped packet rings (linux, TPACKET_V3)
 		
 *****************************************************************/
 
@@ -59,6 +60,20 @@ namespace slib
 		
 	};
 	
+	class SLIB_EXPORT NetCaptureStatistics
+	{
+	public:
+		sl_uint64 countPackets; // received by the kernel, including drops
+		sl_uint64 countDrops; // dropped by the kernel (ring or buffer full)
+		sl_uint64 countFreezes; // ring freezes (TPACKET_V3)
+		
+	public:
+		NetCaptureStatistics();
+		
+		~NetCaptureStatistics();
+		
+	};
+	
 	class SLIB_EXPORT NetCaptureDeviceInfo
 	{
 	public:
@@ -84,16 +99,24 @@ namespace slib
 		String deviceName; // <null> or <empty string> for any devices
 		
 		sl_bool flagPromiscuous; // ignored for "any devices" mode, used in pcap
-		sl_uint32 timeoutRead; // read timeout, in milliseconds, used in pcap
+		sl_uint32 timeoutRead; // read timeout, in milliseconds, used in pcap. block retire timeout in Packet Ring mode (0: computed by kernel)
 		sl_bool flagImmediate; // immediate mode, used in pcap
-		sl_uint32 sizeBuffer; // buffer size, used in pcap
+		sl_uint32 sizeBuffer; // buffer size, used in pcap. ring size of each thread in Packet Ring mode
 		
 		NetworkLinkDeviceType preferedLinkDeviceType; // NetworkLinkDeviceType, used in Packet Socket mode. now supported Ethernet and Raw
 		
+		sl_uint32 sizeBlock; // ring block size (multiple of page size), used in Packet Ring mode. default: 256KB
+		sl_uint32 sizeFrame; // ring frame size (maximum size of the packets sent by TX ring), used in Packet Ring mode. default: 2048
+		sl_uint32 countThreads; // capturing threads, each having its own ring joined to a PACKET_FANOUT group, used in Packet Ring mode. default: 1
+		sl_uint32 countSendFrames; // frames of the TX ring used by `sendPacket()` and `sendPackets()` (0: no TX ring), used in Packet Ring mode. default: 256
+		
 		sl_bool flagAutoStart; // default: true
 		
 		Function<void(NetCapture*, NetCapturePacket*)> onCapturePacket;
 		
+		// called instead of `onCapturePacket` when set, with the packets of a ring block in Packet Ring mode. called concurrently when `countThreads` > 1
+		Function<void(NetCapture*, NetCapturePacket* packets, sl_uint32 count)> onCapturePackets;
+		
 	public:
 		NetCaptureParam();
 		
@@ -120,6 +143,9 @@ namespace slib
 		// raw socket
 		static Ref<NetCapture> createRawIPv4(const NetCaptureParam& param);
 		
+		// linux packet socket with memory-mapped ring (TPACKET_V3)
+		static Ref<NetCapture> createPacketRing(const NetCaptureParam& param);
+		
 	public:
 		virtual void release() = 0;
 		
@@ -134,8 +160,14 @@ namespace slib
 		// send a L2-packet
 		virtual sl_bool sendPacket(const void* buf, sl_uint32 size) = 0;
 		
+		// sends L2-packets in order, and returns the number of the sent packets. In Packet Ring mode, the TX ring is flushed once for the packets (and when it is full)
+		virtual sl_uint32 sendPackets(const NetCapturePacket* packets, sl_uint32 count);
+		
 		virtual String getLastErrorMessage();
 		
+		// accumulated since the capture was created
+		virtual sl_bool getStatistics(NetCaptureStatistics& _out);
+		
 		// Pcap Utiltities
 		static List<NetCaptureDeviceInfo> getAllPcapDevices();
 		
@@ -146,8 +178,11 @@ namespace slib
 		
 		void _onCapturePacket(NetCapturePacket* packet);
 		
+		void _onCapturePackets(NetCapturePacket* packets, sl_uint32 count);
+		
 	protected:
 		Function<void(NetCapture*, NetCapturePacket*)> m_onCapturePacket;
+		Function<void(NetCapture*, NetCapturePacket*, sl_uint32)> m_onCapturePackets;
 		
 	};
 	
@@ -309,7 +309,7 @@ namespace slib
 		
 		static HashMap<String, String> parseParameters(const void* data, sl_size size);
 		
-		static HashMap<String, String> parseParameters(const String& str);
+		static HashMap<String, String> parseParameters(const StringView& str);
 		
 		Memory makeRequestPacket() const;
 		
@@ -280,6 +280,8 @@ namespace slib
 		
 		sl_bool setOption_bindToDevice(const String& ifname);
 		
+		sl_bool setOption_UdpGro(sl_bool flagEnable); // Linux only
+		
 		/****** multicast ******/
 		// interface address may be null
 		sl_bool setOption_IpAddMembership(const IPv4Address& ipMulticast, const IPv4Address& ipInterface);
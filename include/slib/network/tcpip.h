@@ -135,6 +135,14 @@ namespace slib
 
 		static sl_uint16 calculateChecksum(const void* data, sl_size size);
 
+		/*
+			Incremental update of `checksum` when a 16-bit word of the covered data is changed from `oldValue` to `newValue` (RFC 1624)
+		*/
+		static sl_uint16 adjustChecksum(sl_uint16 checksum, sl_uint16 oldValue, sl_uint16 newValue);
+
+		// `oldData` and `newData` are the old and new contents of `size` bytes, starting at an even offset of the covered data
+		static sl_uint16 adjustChecksum(sl_uint16 checksum, const void* oldData, const void* newData, sl_size size);
+
 	};
 
 	class SLIB_EXPORT IPv4Packet
@@ -50,22 +50,22 @@ namespace slib
 		~Url();
 		
 	public:
-		void parse(const String& url);
+		void parse(const StringView& url);
 		
 	public:
-		static String encodePercentByUTF8(const String& value);
+		static String encodePercentByUTF8(const StringView& value);
 		
-		static String decodePercentByUTF8(const String& value);
+		static String decodePercentByUTF8(const StringView& value);
 		
 		
-		static String encodeUriComponentByUTF8(const String& value);
+		static String encodeUriComponentByUTF8(const StringView& value);
 		
-		static String decodeUriComponentByUTF8(const String& value);
+		static String decodeUriComponentByUTF8(const StringView& value);
 		
 		
-		static String encodeUriByUTF8(const String& value);
+		static String encodeUriByUTF8(const StringView& value);
 		
-		static String decodeUriByUTF8(const String& value);
+		static String decodeUriByUTF8(const StringView& value);
 		
 	};
 
@@ -1791,6 +1791,112 @@ namespace slib
 	}
 
 
+/**********************************************
+		AsyncStreamFilterOutput
+**********************************************/
+
+	AsyncStreamFilterOutput::AsyncStreamFilterOutput(MemoryQueue* queue)
+	 : m_queue(queue), m_sizeWritten(0), m_sizeQueued(0)
+	{
+	}
+
+	AsyncStreamFilterOutput::~AsyncStreamFilterOutput()
+	{
+	}
+
+	Memory AsyncStreamFilterOutput::_getFreeBuffer()
+	{
+		for (sl_uint32 i = 0; i < SLIB_ASYNC_STREAM_FILTER_BUFFER_POOL_SIZE; i++) {
+			Memory& mem = m_pool[i];
+			if (mem.isNull()) {
+				mem = Memory::create(SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE);
+				return mem;
+			}
+			// only referenced by the pool: all the data in the buffer is consumed
+			if (mem.ref->getReferenceCount() == 1) {
+				return mem;
+			}
+		}
+		// all the pooled buffers are pending, this buffer is released after use
+		return Memory::create(SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE);
+	}
+
+	void* AsyncStreamFilterOutput::getBuffer(sl_uint32& sizeAvailable, sl_uint32 sizeMin)
+	{
+		if (sizeMin > SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE) {
+			sizeAvailable = 0;
+			return sl_null;
+		}
+		if (m_buffer.isNull() || SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE - m_sizeWritten < sizeMin) {
+			if (!(flush())) {
+				sizeAvailable = 0;
+				return sl_null;
+			}
+			m_buffer.setNull();
+			m_sizeWritten = 0;
+			m_sizeQueued = 0;
+			m_buffer = _getFreeBuffer();
+			if (m_buffer.isNull()) {
+				sizeAvailable = 0;
+				return sl_null;
+			}
+		}
+		sizeAvailable = SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE - m_sizeWritten;
+		return (sl_uint8*)(m_buffer.getData()) + m_sizeWritten;
+	}
+
+	void AsyncStreamFilterOutput::commit(sl_uint32 size)
+	{
+		m_sizeWritten += size;
+	}
+
+	sl_bool AsyncStreamFilterOutput::write(const void* _data, sl_uint32 size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		while (size) {
+			sl_uint32 n;
+			void* buf = getBuffer(n);
+			if (!buf) {
+				return sl_false;
+			}
+			if (n > size) {
+				n = size;
+			}
+			Base::copyMemory(buf, data, n);
+			commit(n);
+			data += n;
+			size -= n;
+		}
+		return sl_true;
+	}
+
+	sl_bool AsyncStreamFilterOutput::add(const Memory& mem)
+	{
+		if (mem.isNull()) {
+			return sl_true;
+		}
+		if (!(flush())) {
+			return sl_false;
+		}
+		return m_queue->add(mem);
+	}
+
+	sl_bool AsyncStreamFilterOutput::flush()
+	{
+		if (m_sizeWritten > m_sizeQueued) {
+			MemoryData data;
+			data.data = (sl_uint8*)(m_buffer.getData()) + m_sizeQueued;
+			data.size = m_sizeWritten - m_sizeQueued;
+			data.refer = m_buffer.ref;
+			if (!(m_queue->add(data))) {
+				return sl_false;
+			}
+			m_sizeQueued = m_sizeWritten;
+		}
+		return sl_true;
+	}
+
+
 /**********************************************
 		AsyncStreamFilter
 **********************************************/
@@ -1798,6 +1904,7 @@ namespace slib
 	SLIB_DEFINE_OBJECT(AsyncStreamFilter, AsyncStream)
 
 	AsyncStreamFilter::AsyncStreamFilter()
+	 : m_outputRead(&m_bufReadConverted), m_outputWrite(&m_bufWriteConverted)
 	{
 		m_flagOpened = sl_true;
 
@@ -1849,8 +1956,21 @@ namespace slib
 				return sl_false;
 			}
 			if (m_requestsRead.push(request)) {
-				if (m_flagReadingEnded) {
-					return sl_false;
+				if (m_flagReadingEnded || m_flagReadingError) {
+					// the data converted before the end of the source stream can still remain
+					if (m_bufReadConverted.getSize() > 0) {
+						if (_completeReadRequests() && m_flagReadingError) {
+							_closeAllReadRequests();
+						}
+						return sl_true;
+					}
+					if (m_flagReadingEnded) {
+						return sl_false;
+					}
+				}
+				if (m_flagReading) {
+					// completed by the pending read on the source stream
+					return sl_true;
 				}
 				return _read();
 			}
@@ -1862,9 +1982,11 @@ namespace slib
 	{
 		if (size > 0) {
 			MutexLocker lock(&m_lockReading);
-			Memory memConv = filterRead(data, size, userObject);
-			if (memConv.isNotNull()) {
-				m_bufReadConverted.add(memConv);
+			if (!(convertRead(data, size, userObject, m_outputRead))) {
+				m_flagReadingError = sl_true;
+			}
+			if (!(m_outputRead.flush())) {
+				m_flagReadingError = sl_true;
 			}
 		}
 	}
@@ -1910,9 +2032,12 @@ namespace slib
 		do {
 			Function<void(AsyncStreamResult*)> callback = SLIB_FUNCTION_WEAKREF(AsyncStreamFilter, onReadStream, this);
 			if (m_bufReadConverted.getSize() > 0) {
-				if (!(stream->read(sl_null, 0, callback))) {
-					break;
+				// the requests are completed with the converted data in the callback, without reading the source
+				if (stream->read(sl_null, 0, callback)) {
+					m_flagReading = sl_true;
+					return sl_true;
 				}
+				break;
 			}
 			Memory mem = m_memReading;
 			if (mem.isNull()) {
@@ -1946,26 +2071,8 @@ namespace slib
 			m_flagReadingError = sl_true;
 		}
 		if (m_bufReadConverted.getSize() > 0) {
-			for (;;) {
-				Ref<AsyncStreamRequest> req;
-				if (!(m_requestsRead.pop(&req))) {
-					return;
-				}
-				if (req.isNotNull()) {
-					sl_uint32 m = 0;
-					if (req->data && req->size) {
-						sl_size _m = m_bufReadConverted.pop(req->data, req->size);
-						m = (sl_uint32)(_m);
-						if (m_bufReadConverted.getSize() == 0) {
-							req->runCallback(this, m, m_flagReadingError);
-							break;
-						} else {
-							req->runCallback(this, m, sl_false);
-						}
-					} else {
-						req->runCallback(this, req->size, sl_false);
-					}
-				}
+			if (!(_completeReadRequests())) {
+				return;
 			}
 		}
 		if (m_flagReadingError) {
@@ -1980,11 +2087,12 @@ namespace slib
 	class _priv_AsyncStreamFilter_WriteRequest : public AsyncStreamRequest
 	{
 	public:
-		Memory memConverted;
+		// holds the last part of the converted data
+		MemoryData dataConverted;
 		
 	public:
-		_priv_AsyncStreamFilter_WriteRequest(const Memory& _memConv, const void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback)
-		 : AsyncStreamRequest(data, size, userObject, callback, sl_false), memConverted(_memConv)
+		_priv_AsyncStreamFilter_WriteRequest(const void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback)
+		 : AsyncStreamRequest(data, size, userObject, callback, sl_false)
 		{
 		}
 		
@@ -2004,15 +2112,54 @@ namespace slib
 			return sl_false;
 		}
 		if (data && size) {
-			Memory memConv = filterWrite(data, size, userObject);
-			Ref<_priv_AsyncStreamFilter_WriteRequest> req = new _priv_AsyncStreamFilter_WriteRequest(memConv, data, size, userObject, callback);
-			if (req.isNotNull()) {
-				return stream->write(memConv.getData(), (sl_uint32)(memConv.getSize()), SLIB_FUNCTION_WEAKREF(AsyncStreamFilter, onWriteStream, this), req.get());
+			if (!(convertWrite(data, size, userObject, m_outputWrite))) {
+				m_flagWritingError = sl_true;
+				m_outputWrite.flush();
+				m_bufWriteConverted.clear();
+				return sl_false;
 			}
+			return _writeConvertedData(data, size, callback, userObject);
 		} else {
 			return stream->write(data, size, callback, userObject);
 		}
-		return sl_false;
+	}
+
+	sl_bool AsyncStreamFilter::_writeConvertedData(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		Ref<AsyncStream> stream = m_stream;
+		if (stream.isNull()) {
+			return sl_false;
+		}
+		if (!(m_outputWrite.flush())) {
+			m_flagWritingError = sl_true;
+		}
+		if (m_flagWritingError) {
+			m_bufWriteConverted.clear();
+			return sl_false;
+		}
+		Ref<_priv_AsyncStreamFilter_WriteRequest> req = new _priv_AsyncStreamFilter_WriteRequest(data, size, userObject, callback);
+		if (req.isNull()) {
+			m_bufWriteConverted.clear();
+			return sl_false;
+		}
+		Function<void(AsyncStreamResult*)> callbackWrite = SLIB_FUNCTION_WEAKREF(AsyncStreamFilter, onWriteStream, this);
+		for (;;) {
+			MemoryData part;
+			if (!(m_bufWriteConverted.pop_NoLock(part))) {
+				// no output (buffered in the filter): the request is completed in order with other writes
+				return stream->write(sl_null, 0, callbackWrite, req.get());
+			}
+			if (!(m_bufWriteConverted.getSize())) {
+				req->dataConverted = part;
+				return stream->write(part.data, (sl_uint32)(part.size), callbackWrite, req.get());
+			}
+			// the source keeps the reference to the part until it is written
+			if (!(stream->write(part.data, (sl_uint32)(part.size), sl_null, part.refer.get()))) {
+				m_flagWritingError = sl_true;
+				m_bufWriteConverted.clear();
+				return sl_false;
+			}
+		}
 	}
 
 	void AsyncStreamFilter::onWriteStream(AsyncStreamResult* result)
@@ -2045,6 +2192,16 @@ namespace slib
 		return Memory::createStatic(data, size, userObject);
 	}
 
+	sl_bool AsyncStreamFilter::convertRead(void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		return output.add(filterRead(data, size, userObject));
+	}
+
+	sl_bool AsyncStreamFilter::convertWrite(const void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		return output.add(filterWrite(data, size, userObject));
+	}
+
 	sl_bool AsyncStreamFilter::isReadingError()
 	{
 		return m_flagReadingError;
@@ -2085,6 +2242,31 @@ namespace slib
 		m_flagWritingEnded = sl_true;
 	}
 
+	sl_bool AsyncStreamFilter::_completeReadRequests()
+	{
+		for (;;) {
+			Ref<AsyncStreamRequest> req;
+			if (!(m_requestsRead.pop(&req))) {
+				return sl_false;
+			}
+			if (req.isNotNull()) {
+				sl_uint32 m = 0;
+				if (req->data && req->size) {
+					sl_size _m = m_bufReadConverted.pop(req->data, req->size);
+					m = (sl_uint32)(_m);
+					if (m_bufReadConverted.getSize() == 0) {
+						req->runCallback(this, m, m_flagReadingError);
+						return sl_true;
+					} else {
+						req->runCallback(this, m, sl_false);
+					}
+				} else {
+					req->runCallback(this, req->size, sl_false);
+				}
+			}
+		}
+	}
+
 	void AsyncStreamFilter::_closeAllReadRequests()
 	{
 		Ref<AsyncStreamRequest> req;
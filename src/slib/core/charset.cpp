@@ -20,50 +20,781 @@
  *   THE SOFTWARE.
  */
 
+
 #include "slib/core/charset.h"
 #include "slib/core/base.h"
+#include "slib/core/cpu.h"
+#include "slib/core/macro.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#elif defined(SLIB_CPU_SUPPORT_SIMD_NEON)
+#	include <arm_neon.h>
+#endif
+
+/*
+	The converters process the runs of ASCII (or surrogate-free) characters by block,
+	and the remaining characters by the scalar decoders.
+	Scalar decoders are lenient: malformed sequences are skipped.
+	Use `isValidUtf8()`, `isValidUtf16()` or the strict converters on untrusted input.
+*/
+
+#define _PRIV_UTF8_ERROR_TOO_SHORT (1 << 0)
+#define _PRIV_UTF8_ERROR_TOO_LONG (1 << 1)
+#define _PRIV_UTF8_ERROR_OVERLONG_3 (1 << 2)
+#define _PRIV_UTF8_ERROR_TOO_LARGE (1 << 3)
+#define _PRIV_UTF8_ERROR_SURROGATE (1 << 4)
+#define _PRIV_UTF8_ERROR_OVERLONG_2 (1 << 5)
+#define _PRIV_UTF8_ERROR_TOO_LARGE_1000 (1 << 6)
+#define _PRIV_UTF8_ERROR_OVERLONG_4 (1 << 6)
+#define _PRIV_UTF8_ERROR_TWO_CONTS (1 << 7)
+#define _PRIV_UTF8_ERROR_CARRY (_PRIV_UTF8_ERROR_TOO_SHORT | _PRIV_UTF8_ERROR_TOO_LONG | _PRIV_UTF8_ERROR_TWO_CONTS)
+
+/*
+	Lookup tables of the block validator (Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte").
+	Each byte pair (prev, cur) is classified by the high nibble of prev, the low nibble of prev and the high nibble of cur,
+	and the intersection of three lookups is non-zero only for the invalid pairs.
+*/
+
+#define _PRIV_UTF8_TABLE_BYTE1_HIGH \
+	_PRIV_UTF8_ERROR_TOO_LONG, _PRIV_UTF8_ERROR_TOO_LONG, _PRIV_UTF8_ERROR_TOO_LONG, _PRIV_UTF8_ERROR_TOO_LONG, \
+	_PRIV_UTF8_ERROR_TOO_LONG, _PRIV_UTF8_ERROR_TOO_LONG, _PRIV_UTF8_ERROR_TOO_LONG, _PRIV_UTF8_ERROR_TOO_LONG, \
+	_PRIV_UTF8_ERROR_TWO_CONTS, _PRIV_UTF8_ERROR_TWO_CONTS, _PRIV_UTF8_ERROR_TWO_CONTS, _PRIV_UTF8_ERROR_TWO_CONTS, \
+	_PRIV_UTF8_ERROR_TOO_SHORT | _PRIV_UTF8_ERROR_OVERLONG_2, \
+	_PRIV_UTF8_ERROR_TOO_SHORT, \
+	_PRIV_UTF8_ERROR_TOO_SHORT | _PRIV_UTF8_ERROR_OVERLONG_3 | _PRIV_UTF8_ERROR_SURROGATE, \
+	_PRIV_UTF8_ERROR_TOO_SHORT | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000 | _PRIV_UTF8_ERROR_OVERLONG_4
+
+#define _PRIV_UTF8_TABLE_BYTE1_LOW \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_OVERLONG_3 | _PRIV_UTF8_ERROR_OVERLONG_2 | _PRIV_UTF8_ERROR_OVERLONG_4, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_OVERLONG_2, \
+	_PRIV_UTF8_ERROR_CARRY, \
+	_PRIV_UTF8_ERROR_CARRY, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000 | _PRIV_UTF8_ERROR_SURROGATE, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000, \
+	_PRIV_UTF8_ERROR_CARRY | _PRIV_UTF8_ERROR_TOO_LARGE | _PRIV_UTF8_ERROR_TOO_LARGE_1000
+
+#define _PRIV_UTF8_TABLE_BYTE2_HIGH \
+	_PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, \
+	_PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, \
+	_PRIV_UTF8_ERROR_TOO_LONG | _PRIV_UTF8_ERROR_OVERLONG_2 | _PRIV_UTF8_ERROR_TWO_CONTS | _PRIV_UTF8_ERROR_OVERLONG_3 | _PRIV_UTF8_ERROR_TOO_LARGE_1000 | _PRIV_UTF8_ERROR_OVERLONG_4, \
+	_PRIV_UTF8_ERROR_TOO_LONG | _PRIV_UTF8_ERROR_OVERLONG_2 | _PRIV_UTF8_ERROR_TWO_CONTS | _PRIV_UTF8_ERROR_OVERLONG_3 | _PRIV_UTF8_ERROR_TOO_LARGE, \
+	_PRIV_UTF8_ERROR_TOO_LONG | _PRIV_UTF8_ERROR_OVERLONG_2 | _PRIV_UTF8_ERROR_TWO_CONTS | _PRIV_UTF8_ERROR_SURROGATE | _PRIV_UTF8_ERROR_TOO_LARGE, \
+	_PRIV_UTF8_ERROR_TOO_LONG | _PRIV_UTF8_ERROR_OVERLONG_2 | _PRIV_UTF8_ERROR_TWO_CONTS | _PRIV_UTF8_ERROR_SURROGATE | _PRIV_UTF8_ERROR_TOO_LARGE, \
+	_PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT, _PRIV_UTF8_ERROR_TOO_SHORT
 
 namespace slib
 {
 	
+	/*
+		Block converters
+
+		Each function converts the leading blocks while they consist of the characters which are converted one-to-one
+		(ASCII for UTF-8 targets or sources, non-surrogate BMP characters between UTF-16 and UTF-32),
+		and returns the number of converted characters (multiple of block size).
+		`dst` can be null for counting.
+	*/
+	
+	static sl_size _priv_Charsets_utf8ToUtf16_block_generic(const sl_char8* src, sl_size len, sl_char16* dst) noexcept
+	{
+		sl_size i = 0;
+		for (; i + 8 <= len; i += 8) {
+			sl_uint64 v;
+			Base::copyMemory(&v, src + i, 8);
+			if (v & SLIB_UINT64(0x8080808080808080)) {
+				break;
+			}
+			if (dst) {
+				for (sl_size k = 0; k < 8; k++) {
+					dst[i + k] = (sl_char16)(src[i + k]);
+				}
+			}
+		}
+		return i;
+	}
+	
+	static sl_size _priv_Charsets_utf8ToUtf32_block_generic(const sl_char8* src, sl_size len, sl_char32* dst) noexcept
+	{
+		sl_size i = 0;
+		for (; i + 8 <= len; i += 8) {
+			sl_uint64 v;
+			Base::copyMemory(&v, src + i, 8);
+			if (v & SLIB_UINT64(0x8080808080808080)) {
+				break;
+			}
+			if (dst) {
+				for (sl_size k = 0; k < 8; k++) {
+					dst[i + k] = (sl_char32)(src[i + k]);
+				}
+			}
+		}
+		return i;
+	}
+	
+	static sl_size _priv_Charsets_utf16ToUtf8_block_generic(const sl_char16* src, sl_size len, sl_char8* dst) noexcept
+	{
+		sl_size i = 0;
+		for (; i + 4 <= len; i += 4) {
+			if ((src[i] | src[i + 1] | src[i + 2] | src[i + 3]) & 0xFF80) {
+				break;
+			}
+			if (dst) {
+				dst[i] = (sl_char8)(src[i]);
+				dst[i + 1] = (sl_char8)(src[i + 1]);
+				dst[i + 2] = (sl_char8)(src[i + 2]);
+				dst[i + 3] = (sl_char8)(src[i + 3]);
+			}
+		}
+		return i;
+	}
+	
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	
+	SLIB_CPU_TARGET("sse2")
+	static sl_size _priv_Charsets_utf8ToUtf16_block_sse2(const sl_char8* src, sl_size len, sl_char16* dst) noexcept
+	{
+		sl_size i = 0;
+		__m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= len; i += 16) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+			if (_mm_movemask_epi8(v)) {
+				break;
+			}
+			if (dst) {
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(v, zero));
+				_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+			}
+		}
+		return i;
+	}
+	
+	SLIB_CPU_TARGET("avx2")
+	static sl_size _priv_Charsets_utf8ToUtf16_block_avx2(const sl_char8* src, sl_size len, sl_char16* dst) noexcept
+	{
+		sl_size i = 0;
+		for (; i + 32 <= len; i += 32) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+			if (_mm256_movemask_epi8(v)) {
+				break;
+			}
+			if (dst) {
+				_mm256_storeu_si256((__m256i*)(dst + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+				_mm256_storeu_si256((__m256i*)(dst + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+			}
+		}
+		return i;
+	}
+	
+	SLIB_CPU_TARGET("sse2")
+	static sl_size _priv_Charsets_utf8ToUtf32_block_sse2(const sl_char8* src, sl_size len, sl_char32* dst) noexcept
+	{
+		sl_size i = 0;
+		__m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= len; i += 16) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+			if (_mm_movemask_epi8(v)) {
+				break;
+			}
+			if (dst) {
+				__m128i l = _mm_unpacklo_epi8(v, zero);
+				__m128i h = _mm_unpackhi_epi8(v, zero);
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(l, zero));
+				_mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(l, zero));
+				_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(h, zero));
+				_mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(h, zero));
+			}
+		}
+		return i;
+	}
+	
+	SLIB_CPU_TARGET("sse2")
+	static sl_size _priv_Charsets_utf16ToUtf8_block_sse2(const sl_char16* src, sl_size len, sl_char8* dst) noexcept
+	{
+		sl_size i = 0;
+		__m128i mask = _mm_set1_epi16((short)0xFF80);
+		__m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= len; i += 16) {
+			__m128i v1 = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i v2 = _mm_loadu_si128((const __m128i*)(src + i + 8));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(v1, v2), mask), zero)) != 0xFFFF) {
+				break;
+			}
+			if (dst) {
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(v1, v2));
+			}
+		}
+		return i;
+	}
+	
+	SLIB_CPU_TARGET("avx2")
+	static sl_size _priv_Charsets_utf16ToUtf8_block_avx2(const sl_char16* src, sl_size len, sl_char8* dst) noexcept
+	{
+		sl_size i = 0;
+		__m256i mask = _mm256_set1_epi16((short)0xFF80);
+		for (; i + 32 <= len; i += 32) {
+			__m256i v1 = _mm256_loadu_si256((const __m256i*)(src + i));
+			__m256i v2 = _mm256_loadu_si256((const __m256i*)(src + i + 16));
+			if (!(_mm256_testz_si256(_mm256_or_si256(v1, v2), mask))) {
+				break;
+			}
+			if (dst) {
+				_mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute4x64_epi64(_mm256_packus_epi16(v1, v2), 0xD8));
+			}
+		}
+		return i;
+	}
+	
+	SLIB_CPU_TARGET("sse2")
+	static sl_size _priv_Charsets_utf32ToUtf8_block_sse2(const sl_char32* src, sl_size len, sl_char8* dst) noexcept
+	{
+		sl_size i = 0;
+		__m128i mask = _mm_set1_epi32((int)0xFFFFFF80);
+		__m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= len; i += 16) {
+			__m128i v1 = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i v2 = _mm_loadu_si128((const __m128i*)(src + i + 4));
+			__m128i v3 = _mm_loadu_si128((const __m128i*)(src + i + 8));
+			__m128i v4 = _mm_loadu_si128((const __m128i*)(src + i + 12));
+			__m128i t = _mm_and_si128(_mm_or_si128(_mm_or_si128(v1, v2), _mm_or_si128(v3, v4)), mask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(t, zero)) != 0xFFFF) {
+				break;
+			}
+			if (dst) {
+				// all values are less than 0x80, so the signed saturation is safe
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(_mm_packs_epi32(v1, v2), _mm_packs_epi32(v3, v4)));
+			}
+		}
+		return i;
+	}
+	
+	SLIB_CPU_TARGET("sse2")
+	static sl_size _priv_Charsets_utf16ToUtf32_block_sse2(const sl_char16* src, sl_size len, sl_char32* dst) noexcept
+	{
+		sl_size i = 0;
+		__m128i maskSurrogate = _mm_set1_epi16((short)0xF800);
+		__m128i surrogate = _mm_set1_epi16((short)0xD800);
+		__m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= len; i += 16) {
+			__m128i v1 = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i v2 = _mm_loadu_si128((const __m128i*)(src + i + 8));
+			__m128i t1 = _mm_cmpeq_epi16(_mm_and_si128(v1, maskSurrogate), surrogate);
+			__m128i t2 = _mm_cmpeq_epi16(_mm_and_si128(v2, maskSurrogate), surrogate);
+			if (_mm_movemask_epi8(_mm_or_si128(t1, t2))) {
+				break;
+			}
+			if (dst) {
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(v1, zero));
+				_mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(v1, zero));
+				_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(v2, zero));
+				_mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(v2, zero));
+			}
+		}
+		return i;
+	}
+	
+	SLIB_CPU_TARGET("sse2")
+	static sl_size _priv_Charsets_utf32ToUtf16_block_sse2(const sl_char32* src, sl_size len, sl_char16* dst) noexcept
+	{
+		sl_size i = 0;
+		__m128i maskHigh = _mm_set1_epi32((int)0xFFFF0000);
+		__m128i maskSurrogate = _mm_set1_epi32(0xF800);
+		__m128i surrogate = _mm_set1_epi32(0xD800);
+		__m128i zero = _mm_setzero_si128();
+		for (; i + 8 <= len; i += 8) {
+			__m128i v1 = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i v2 = _mm_loadu_si128((const __m128i*)(src + i + 4));
+			__m128i tHigh = _mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(v1, v2), maskHigh), zero);
+			__m128i t1 = _mm_cmpeq_epi32(_mm_and_si128(v1, maskSurrogate), surrogate);
+			__m128i t2 = _mm_cmpeq_epi32(_mm_and_si128(v2, maskSurrogate), surrogate);
+			if (_mm_movemask_epi8(_mm_andnot_si128(_mm_or_si128(t1, t2), tHigh)) != 0xFFFF) {
+				break;
+			}
+			if (dst) {
+				// sign-extend the low halves to use the signed saturation
+				v1 = _mm_srai_epi32(_mm_slli_epi32(v1, 16), 16);
+				v2 = _mm_srai_epi32(_mm_slli_epi32(v2, 16), 16);
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(v1, v2));
+			}
+		}
+		return i;
+	}
+	
+	static sl_bool _priv_Charsets_isAVX2() noexcept
+	{
+		static sl_bool flag = Cpu::isAVX2Supported();
+		return flag;
+	}
+	
+	static sl_bool _priv_Charsets_isSSE2() noexcept
+	{
+#if defined(SLIB_ARCH_IS_X64)
+		return sl_true;
+#else
+		static sl_bool flag = Cpu::isSSE2Supported();
+		return flag;
+#endif
+	}
+	
+	static sl_bool _priv_Charsets_isSSSE3() noexcept
+	{
+		static sl_bool flag = Cpu::isSSSE3Supported();
+		return flag;
+	}
+	
+#elif defined(SLIB_CPU_SUPPORT_SIMD_NEON)
+	
+	static sl_size _priv_Charsets_utf8ToUtf16_block_neon(const sl_char8* src, sl_size len, sl_char16* dst) noexcept
+	{
+		sl_size i = 0;
+		for (; i + 16 <= len; i += 16) {
+			uint8x16_t v = vld1q_u8((const uint8_t*)(src + i));
+			if (vmaxvq_u8(v) >= 0x80) {
+				break;
+			}
+			if (dst) {
+				vst1q_u16((uint16_t*)(dst + i), vmovl_u8(vget_low_u8(v)));
+				vst1q_u16((uint16_t*)(dst + i + 8), vmovl_high_u8(v));
+			}
+		}
+		return i;
+	}
+	
+	static sl_size _priv_Charsets_utf16ToUtf8_block_neon(const sl_char16* src, sl_size len, sl_char8* dst) noexcept
+	{
+		sl_size i = 0;
+		for (; i + 16 <= len; i += 16) {
+			uint16x8_t v1 = vld1q_u16((const uint16_t*)(src + i));
+			uint16x8_t v2 = vld1q_u16((const uint16_t*)(src + i + 8));
+			if (vmaxvq_u16(vorrq_u16(v1, v2)) >= 0x80) {
+				break;
+			}
+			if (dst) {
+				vst1q_u8((uint8_t*)(dst + i), vcombine_u8(vmovn_u16(v1), vmovn_u16(v2)));
+			}
+		}
+		return i;
+	}
+	
+#endif
+	
+	static sl_size _priv_Charsets_utf8ToUtf16_block(const sl_char8* src, sl_size len, sl_char16* dst) noexcept
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_Charsets_isAVX2()) {
+			return _priv_Charsets_utf8ToUtf16_block_avx2(src, len, dst);
+		}
+		if (_priv_Charsets_isSSE2()) {
+			return _priv_Charsets_utf8ToUtf16_block_sse2(src, len, dst);
+		}
+#elif defined(SLIB_CPU_SUPPORT_SIMD_NEON)
+		return _priv_Charsets_utf8ToUtf16_block_neon(src, len, dst);
+#endif
+		return _priv_Charsets_utf8ToUtf16_block_generic(src, len, dst);
+	}
+	
+	static sl_size _priv_Charsets_utf8ToUtf32_block(const sl_char8* src, sl_size len, sl_char32* dst) noexcept
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_Charsets_isSSE2()) {
+			return _priv_Charsets_utf8ToUtf32_block_sse2(src, len, dst);
+		}
+#endif
+		return _priv_Charsets_utf8ToUtf32_block_generic(src, len, dst);
+	}
+	
+	static sl_size _priv_Charsets_utf16ToUtf8_block(const sl_char16* src, sl_size len, sl_char8* dst) noexcept
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_Charsets_isAVX2()) {
+			return _priv_Charsets_utf16ToUtf8_block_avx2(src, len, dst);
+		}
+		if (_priv_Charsets_isSSE2()) {
+			return _priv_Charsets_utf16ToUtf8_block_sse2(src, len, dst);
+		}
+#elif defined(SLIB_CPU_SUPPORT_SIMD_NEON)
+		return _priv_Charsets_utf16ToUtf8_block_neon(src, len, dst);
+#endif
+		return _priv_Charsets_utf16ToUtf8_block_generic(src, len, dst);
+	}
+	
+	static sl_size _priv_Charsets_utf32ToUtf8_block(const sl_char32* src, sl_size len, sl_char8* dst) noexcept
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_Charsets_isSSE2()) {
+			return _priv_Charsets_utf32ToUtf8_block_sse2(src, len, dst);
+		}
+#endif
+		return 0;
+	}
+	
+	static sl_size _priv_Charsets_utf16ToUtf32_block(const sl_char16* src, sl_size len, sl_char32* dst) noexcept
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_Charsets_isSSE2()) {
+			return _priv_Charsets_utf16ToUtf32_block_sse2(src, len, dst);
+		}
+#endif
+		return 0;
+	}
+	
+	static sl_size _priv_Charsets_utf32ToUtf16_block(const sl_char32* src, sl_size len, sl_char16* dst) noexcept
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_Charsets_isSSE2()) {
+			return _priv_Charsets_utf32ToUtf16_block_sse2(src, len, dst);
+		}
+#endif
+		return 0;
+	}
+	
+	
+	/*
+		Validators
+	*/
+	
+	static sl_bool _priv_Charsets_isValidUtf8_scalar(const sl_uint8* s, sl_size len) noexcept
+	{
+		sl_size i = 0;
+		while (i < len) {
+			if (i + 8 <= len) {
+				sl_uint64 v;
+				Base::copyMemory(&v, s + i, 8);
+				if (!(v & SLIB_UINT64(0x8080808080808080))) {
+					i += 8;
+					continue;
+				}
+			}
+			sl_uint32 ch = s[i];
+			if (ch < 0x80) {
+				i++;
+			} else if (ch < 0xC2) {
+				// continuation or overlong
+				return sl_false;
+			} else if (ch < 0xE0) {
+				if (i + 1 >= len || (s[i + 1] & 0xC0) != 0x80) {
+					return sl_false;
+				}
+				i += 2;
+			} else if (ch < 0xF0) {
+				if (i + 2 >= len) {
+					return sl_false;
+				}
+				sl_uint32 ch1 = s[i + 1];
+				if ((ch1 & 0xC0) != 0x80 || (s[i + 2] & 0xC0) != 0x80) {
+					return sl_false;
+				}
+				if (ch == 0xE0 && ch1 < 0xA0) {
+					// overlong
+					return sl_false;
+				}
+				if (ch == 0xED && ch1 >= 0xA0) {
+					// surrogate
+					return sl_false;
+				}
+				i += 3;
+			} else if (ch < 0xF5) {
+				if (i + 3 >= len) {
+					return sl_false;
+				}
+				sl_uint32 ch1 = s[i + 1];
+				if ((ch1 & 0xC0) != 0x80 || (s[i + 2] & 0xC0) != 0x80 || (s[i + 3] & 0xC0) != 0x80) {
+					return sl_false;
+				}
+				if (ch == 0xF0 && ch1 < 0x90) {
+					// overlong
+					return sl_false;
+				}
+				if (ch == 0xF4 && ch1 >= 0x90) {
+					// larger than 0x10FFFF
+					return sl_false;
+				}
+				i += 4;
+			} else {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+	
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	
+	SLIB_CPU_TARGET("ssse3")
+	static sl_bool _priv_Charsets_isValidUtf8_ssse3(const sl_uint8* s, sl_size len) noexcept
+	{
+		const __m128i tableByte1High = _mm_setr_epi8(_PRIV_UTF8_TABLE_BYTE1_HIGH);
+		const __m128i tableByte1Low = _mm_setr_epi8(_PRIV_UTF8_TABLE_BYTE1_LOW);
+		const __m128i tableByte2High = _mm_setr_epi8(_PRIV_UTF8_TABLE_BYTE2_HIGH);
+		const __m128i maskLow = _mm_set1_epi8(0x0F);
+		const __m128i maskHigh = _mm_set1_epi8((char)0x80);
+		const __m128i limitThird = _mm_set1_epi8((char)(0xE0 - 1));
+		const __m128i limitFourth = _mm_set1_epi8((char)(0xF0 - 1));
+		const __m128i limitIncomplete = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+		const __m128i zero = _mm_setzero_si128();
+		__m128i prev = zero;
+		__m128i prevIncomplete = zero;
+		__m128i error = zero;
+		sl_uint8 tail[16];
+		sl_size i = 0;
+		for (;;) {
+			__m128i input;
+			if (i + 16 <= len) {
+				input = _mm_loadu_si128((const __m128i*)(s + i));
+			} else if (i < len) {
+				Base::zeroMemory(tail, 16);
+				Base::copyMemory(tail, s + i, len - i);
+				input = _mm_loadu_si128((const __m128i*)tail);
+			} else {
+				break;
+			}
+			if (_mm_movemask_epi8(input)) {
+				__m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+				__m128i byte1High = _mm_shuffle_epi8(tableByte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), maskLow));
+				__m128i byte1Low = _mm_shuffle_epi8(tableByte1Low, _mm_and_si128(prev1, maskLow));
+				__m128i byte2High = _mm_shuffle_epi8(tableByte2High, _mm_and_si128(_mm_srli_epi16(input, 4), maskLow));
+				__m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+				__m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+				__m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+				__m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, limitThird), _mm_subs_epu8(prev3, limitFourth));
+				must23 = _mm_and_si128(_mm_cmpgt_epi8(must23, zero), maskHigh);
+				error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+				prevIncomplete = _mm_subs_epu8(input, limitIncomplete);
+			} else {
+				error = _mm_or_si128(error, prevIncomplete);
+				prevIncomplete = zero;
+			}
+			prev = input;
+			i += 16;
+		}
+		error = _mm_or_si128(error, prevIncomplete);
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) == 0xFFFF;
+	}
+	
+	SLIB_CPU_TARGET("avx2")
+	static sl_bool _priv_Charsets_isValidUtf8_avx2(const sl_uint8* s, sl_size len) noexcept
+	{
+		const __m256i tableByte1High = _mm256_setr_epi8(_PRIV_UTF8_TABLE_BYTE1_HIGH, _PRIV_UTF8_TABLE_BYTE1_HIGH);
+		const __m256i tableByte1Low = _mm256_setr_epi8(_PRIV_UTF8_TABLE_BYTE1_LOW, _PRIV_UTF8_TABLE_BYTE1_LOW);
+		const __m256i tableByte2High = _mm256_setr_epi8(_PRIV_UTF8_TABLE_BYTE2_HIGH, _PRIV_UTF8_TABLE_BYTE2_HIGH);
+		const __m256i maskLow = _mm256_set1_epi8(0x0F);
+		const __m256i maskHigh = _mm256_set1_epi8((char)0x80);
+		const __m256i limitThird = _mm256_set1_epi8((char)(0xE0 - 1));
+		const __m256i limitFourth = _mm256_set1_epi8((char)(0xF0 - 1));
+		const __m256i limitIncomplete = _mm256_setr_epi8(
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i prev = zero;
+		__m256i prevIncomplete = zero;
+		__m256i error = zero;
+		sl_uint8 tail[32];
+		sl_size i = 0;
+		for (;;) {
+			__m256i input;
+			if (i + 32 <= len) {
+				input = _mm256_loadu_si256((const __m256i*)(s + i));
+			} else if (i < len) {
+				Base::zeroMemory(tail, 32);
+				Base::copyMemory(tail, s + i, len - i);
+				input = _mm256_loadu_si256((const __m256i*)tail);
+			} else {
+				break;
+			}
+			if (_mm256_movemask_epi8(input)) {
+				__m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+				__m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+				__m256i byte1High = _mm256_shuffle_epi8(tableByte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), maskLow));
+				__m256i byte1Low = _mm256_shuffle_epi8(tableByte1Low, _mm256_and_si256(prev1, maskLow));
+				__m256i byte2High = _mm256_shuffle_epi8(tableByte2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), maskLow));
+				__m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+				__m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+				__m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+				__m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, limitThird), _mm256_subs_epu8(prev3, limitFourth));
+				must23 = _mm256_and_si256(_mm256_cmpgt_epi8(must23, zero), maskHigh);
+				error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+				prevIncomplete = _mm256_subs_epu8(input, limitIncomplete);
+			} else {
+				error = _mm256_or_si256(error, prevIncomplete);
+				prevIncomplete = zero;
+			}
+			prev = input;
+			i += 32;
+		}
+		error = _mm256_or_si256(error, prevIncomplete);
+		return _mm256_testz_si256(error, error) != 0;
+	}
+	
+#elif defined(SLIB_CPU_SUPPORT_SIMD_NEON)
+	
+	static sl_bool _priv_Charsets_isValidUtf8_neon(const sl_uint8* s, sl_size len) noexcept
+	{
+		static const sl_uint8 _tableByte1High[16] = { _PRIV_UTF8_TABLE_BYTE1_HIGH };
+		static const sl_uint8 _tableByte1Low[16] = { _PRIV_UTF8_TABLE_BYTE1_LOW };
+		static const sl_uint8 _tableByte2High[16] = { _PRIV_UTF8_TABLE_BYTE2_HIGH };
+		static const sl_uint8 _limitIncomplete[16] = { 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1 };
+		const uint8x16_t tableByte1High = vld1q_u8(_tableByte1High);
+		const uint8x16_t tableByte1Low = vld1q_u8(_tableByte1Low);
+		const uint8x16_t tableByte2High = vld1q_u8(_tableByte2High);
+		const uint8x16_t limitIncomplete = vld1q_u8(_limitIncomplete);
+		const uint8x16_t maskLow = vdupq_n_u8(0x0F);
+		const uint8x16_t maskHigh = vdupq_n_u8(0x80);
+		const uint8x16_t limitThird = vdupq_n_u8(0xE0 - 1);
+		const uint8x16_t limitFourth = vdupq_n_u8(0xF0 - 1);
+		const uint8x16_t zero = vdupq_n_u8(0);
+		uint8x16_t prev = zero;
+		uint8x16_t prevIncomplete = zero;
+		uint8x16_t error = zero;
+		sl_uint8 tail[16];
+		sl_size i = 0;
+		for (;;) {
+			uint8x16_t input;
+			if (i + 16 <= len) {
+				input = vld1q_u8(s + i);
+			} else if (i < len) {
+				Base::zeroMemory(tail, 16);
+				Base::copyMemory(tail, s + i, len - i);
+				input = vld1q_u8(tail);
+			} else {
+				break;
+			}
+			if (vmaxvq_u8(input) >= 0x80) {
+				uint8x16_t prev1 = vextq_u8(prev, input, 15);
+				uint8x16_t byte1High = vqtbl1q_u8(tableByte1High, vshrq_n_u8(prev1, 4));
+				uint8x16_t byte1Low = vqtbl1q_u8(tableByte1Low, vandq_u8(prev1, maskLow));
+				uint8x16_t byte2High = vqtbl1q_u8(tableByte2High, vshrq_n_u8(input, 4));
+				uint8x16_t special = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+				uint8x16_t prev2 = vextq_u8(prev, input, 14);
+				uint8x16_t prev3 = vextq_u8(prev, input, 13);
+				uint8x16_t must23 = vorrq_u8(vqsubq_u8(prev2, limitThird), vqsubq_u8(prev3, limitFourth));
+				must23 = vandq_u8(vcgtq_u8(must23, zero), maskHigh);
+				error = vorrq_u8(error, veorq_u8(must23, special));
+				prevIncomplete = vqsubq_u8(input, limitIncomplete);
+			} else {
+				error = vorrq_u8(error, prevIncomplete);
+				prevIncomplete = zero;
+			}
+			prev = input;
+			i += 16;
+		}
+		error = vorrq_u8(error, prevIncomplete);
+		return vmaxvq_u8(error) == 0;
+	}
+	
+#endif
+	
+	
+	/*
+		Converters
+	*/
+	
 	sl_size Charsets::utf8ToUtf16(const sl_char8* utf8, sl_reg lenUtf8, sl_char16* utf16, sl_reg lenUtf16Buffer)
 	{
 		if (lenUtf8 < 0) {
 			lenUtf8 = Base::getStringLength(utf8, -1) + 1;
 		}
-		sl_reg n = 0;
-		for (sl_reg i = 0; i < lenUtf8 && (lenUtf16Buffer < 0 || n < lenUtf16Buffer); i++) {
-			sl_uint32 ch = (sl_uint32)((sl_uint8)utf8[i]);
-			if (ch < 0x80) {
-				if (utf16) {
-					utf16[n++] = (sl_char16)ch;
-				} else {
-					n++;
+		sl_size len = (sl_size)lenUtf8;
+		sl_size limit = lenUtf16Buffer < 0 ? SLIB_SIZE_MAX : (sl_size)lenUtf16Buffer;
+		sl_size i = 0;
+		sl_size n = 0;
+		while (i < len && n < limit) {
+			sl_size end = len;
+			if (len - i >= 16) {
+				sl_size m = limit - n;
+				if (m > len - i) {
+					m = len - i;
 				}
-			} else if (ch < 0xC0) {
-				// Corrupted data element
-			} else if (ch < 0xE0) {
-				if (i + 1 < lenUtf8) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[++i]);
-					if ((ch1 & 0xC0) == 0x80) {
-						if (utf16) {
-							utf16[n++] = (sl_char16)(((ch & 0x1F) << 6) | (ch1 & 0x3F));
-						} else {
+				m = _priv_Charsets_utf8ToUtf16_block(utf8 + i, m, utf16 ? utf16 + n : sl_null);
+				i += m;
+				n += m;
+				// decode by scalar for a while before retrying the block converter
+				end = i + 64;
+				if (end > len) {
+					end = len;
+				}
+			}
+			while (i < end) {
+				sl_uint32 ch = (sl_uint32)((sl_uint8)utf8[i]);
+				if (ch < 0x80) {
+					if (n >= limit) {
+						return n;
+					}
+					if (utf16) {
+						utf16[n] = (sl_char16)ch;
+					}
+					n++;
+					i++;
+				} else if (ch < 0xC0) {
+					// Corrupted data element
+					i++;
+				} else if (ch < 0xE0) {
+					if (i + 1 < len) {
+						sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[i + 1]);
+						if ((ch1 & 0xC0) == 0x80) {
+							if (n >= limit) {
+								return n;
+							}
+							if (utf16) {
+								utf16[n] = (sl_char16)(((ch & 0x1F) << 6) | (ch1 & 0x3F));
+							}
 							n++;
 						}
 					}
-				}
-			} else if (ch < 0xF0) {
-				if (i + 2 < lenUtf8) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch2 = (sl_uint32)((sl_uint8)utf8[++i]);
-					if (((ch1 & 0xC0) == 0x80) && ((ch2 & 0xC0) == 0x80)) {
-						if (utf16) {
-							utf16[n++] = (sl_char16)(((ch & 0x0F) << 12) | ((ch1 & 0x3F) << 6) | (ch2 & 0x3F));
-						} else {
+					i += 2;
+				} else if (ch < 0xF0) {
+					if (i + 2 < len) {
+						sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[i + 1]);
+						sl_uint32 ch2 = (sl_uint32)((sl_uint8)utf8[i + 2]);
+						if (((ch1 & 0xC0) == 0x80) && ((ch2 & 0xC0) == 0x80)) {
+							if (n >= limit) {
+								return n;
+							}
+							if (utf16) {
+								utf16[n] = (sl_char16)(((ch & 0x0F) << 12) | ((ch1 & 0x3F) << 6) | (ch2 & 0x3F));
+							}
 							n++;
 						}
 					}
+					i += 3;
+				} else if (ch < 0xF8) {
+					if (i + 3 < len) {
+						sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[i + 1]);
+						sl_uint32 ch2 = (sl_uint32)((sl_uint8)utf8[i + 2]);
+						sl_uint32 ch3 = (sl_uint32)((sl_uint8)utf8[i + 3]);
+						if (((ch1 & 0xC0) == 0x80) && ((ch2 & 0xC0) == 0x80) && ((ch3 & 0xC0) == 0x80)) {
+							sl_uint32 code = ((ch & 0x07) << 18) | ((ch1 & 0x3F) << 12) | ((ch2 & 0x3F) << 6) | (ch3 & 0x3F);
+							if (code < 0x10000) {
+								if (n >= limit) {
+									return n;
+								}
+								if (utf16) {
+									utf16[n] = (sl_char16)code;
+								}
+								n++;
+							} else if (code < 0x110000) {
+								if (n + 1 >= limit) {
+									return n;
+								}
+								if (utf16) {
+									code -= 0x10000;
+									utf16[n] = (sl_char16)(0xD800 + (code >> 10));
+									utf16[n + 1] = (sl_char16)(0xDC00 + (code & 0x3FF));
+								}
+								n += 2;
+							}
+						}
+					}
+					i += 4;
+				} else {
+					// Not representable in UTF-16
+					i++;
 				}
 			}
 		}
@@ -75,81 +806,79 @@ namespace slib
 		if (lenUtf8 < 0) {
 			lenUtf8 = Base::getStringLength(utf8, -1) + 1;
 		}
-		sl_reg n = 0;
-		for (sl_reg i = 0; i < lenUtf8 && (lenUtf32Buffer < 0 || n < lenUtf32Buffer); i++) {
-			sl_uint32 ch = (sl_uint32)((sl_uint8)utf8[i]);
-			if (ch < 0x80) {
-				if (utf32) {
-					utf32[n++] = (sl_char32)ch;
-				} else {
-					n++;
+		sl_size len = (sl_size)lenUtf8;
+		sl_size limit = lenUtf32Buffer < 0 ? SLIB_SIZE_MAX : (sl_size)lenUtf32Buffer;
+		sl_size i = 0;
+		sl_size n = 0;
+		while (i < len && n < limit) {
+			sl_size end = len;
+			if (len - i >= 16) {
+				sl_size m = limit - n;
+				if (m > len - i) {
+					m = len - i;
 				}
-			} else if (ch < 0xC0) {
-				// Corrupted data element
-			} else if (ch < 0xE0) {
-				if (i + 1 < lenUtf8) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[++i]);
-					if ((ch1 & 0xC0) == 0x80) {
-						if (utf32) {
-							utf32[n++] = (sl_char32)(((ch & 0x1F) << 6) | (ch1 & 0x3F));
-						} else {
-							n++;
-						}
-					}
+				m = _priv_Charsets_utf8ToUtf32_block(utf8 + i, m, utf32 ? utf32 + n : sl_null);
+				i += m;
+				n += m;
+				end = i + 64;
+				if (end > len) {
+					end = len;
 				}
-			} else if (ch < 0xF0) {
-				if (i + 2 < lenUtf8) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch2 = (sl_uint32)((sl_uint8)utf8[++i]);
-					if (((ch1 & 0xC0) == 0x80) && ((ch2 & 0xC0) == 0x80)) {
-						if (utf32) {
-							utf32[n++] = (sl_char32)(((ch & 0x0F) << 12) | ((ch1 & 0x3F) << 6) | (ch2 & 0x3F));
-						} else {
-							n++;
-						}
-					}
+			}
+			while (i < end) {
+				if (n >= limit) {
+					return n;
 				}
-			} else if (ch < 0xF8) {
-				if (i + 3 < lenUtf8) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch2 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch3 = (sl_uint32)((sl_uint8)utf8[++i]);
-					if (((ch1 & 0xC0) == 0x80) && ((ch2 & 0xC0) == 0x80) && ((ch3 & 0xC0) == 0x80)) {
-						if (utf32) {
-							utf32[n++] = (sl_char32)(((ch & 0x07) << 18) | ((ch1 & 0x3F) << 12) | ((ch2 & 0x3F) << 6) | (ch3 & 0x3F));
-						} else {
-							n++;
-						}
+				sl_uint32 ch = (sl_uint32)((sl_uint8)utf8[i]);
+				if (ch < 0x80) {
+					if (utf32) {
+						utf32[n] = (sl_char32)ch;
 					}
-				}
-			} else if (ch < 0xFC) {
-				if (i + 4 < lenUtf8) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch2 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch3 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch4 = (sl_uint32)((sl_uint8)utf8[++i]);
-					if (((ch1 & 0xC0) == 0x80) && ((ch2 & 0xC0) == 0x80) && ((ch3 & 0xC0) == 0x80) && ((ch4 & 0xC0) == 0x80)) {
-						if (utf32) {
-							utf32[n++] = (sl_char32)(((ch & 0x03) << 24) | ((ch1 & 0x3F) << 18) | ((ch2 & 0x3F) << 12) | ((ch3 & 0x3F) << 6) | (ch4 & 0x3F));
-						} else {
-							n++;
-						}
+					n++;
+					i++;
+				} else if (ch < 0xC0) {
+					// Corrupted data element
+					i++;
+				} else {
+					sl_size nTrails;
+					sl_uint32 code;
+					if (ch < 0xE0) {
+						nTrails = 1;
+						code = ch & 0x1F;
+					} else if (ch < 0xF0) {
+						nTrails = 2;
+						code = ch & 0x0F;
+					} else if (ch < 0xF8) {
+						nTrails = 3;
+						code = ch & 0x07;
+					} else if (ch < 0xFC) {
+						nTrails = 4;
+						code = ch & 0x03;
+					} else if (ch < 0xFE) {
+						nTrails = 5;
+						code = ch & 0x01;
+					} else {
+						i++;
+						continue;
 					}
-				}
-			} else if (ch < 0xFE) {
-				if (i + 5 < lenUtf8) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch2 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch3 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch4 = (sl_uint32)((sl_uint8)utf8[++i]);
-					sl_uint32 ch5 = (sl_uint32)((sl_uint8)utf8[++i]);
-					if (((ch1 & 0xC0) == 0x80) && ((ch2 & 0xC0) == 0x80) && ((ch3 & 0xC0) == 0x80) && ((ch4 & 0xC0) == 0x80) && ((ch5 & 0xC0) == 0x80)) {
-						if (utf32) {
-							utf32[n++] = (sl_char32)(((ch & 0x01) << 30) | ((ch1 & 0x3F) << 24) | ((ch2 & 0x3F) << 18) | ((ch3 & 0x3F) << 12) | ((ch4 & 0x3F) << 6) | (ch5 & 0x3F));
-						} else {
+					if (i + nTrails < len) {
+						sl_bool flagValid = sl_true;
+						for (sl_size k = 1; k <= nTrails; k++) {
+							sl_uint32 chTrail = (sl_uint32)((sl_uint8)utf8[i + k]);
+							if ((chTrail & 0xC0) != 0x80) {
+								flagValid = sl_false;
+								break;
+							}
+							code = (code << 6) | (chTrail & 0x3F);
+						}
+						if (flagValid) {
+							if (utf32) {
+								utf32[n] = (sl_char32)code;
+							}
 							n++;
 						}
 					}
+					i += nTrails + 1;
 				}
 			}
 		}
@@ -161,34 +890,75 @@ namespace slib
 		if (lenUtf16 < 0) {
 			lenUtf16 = Base::getStringLength2(utf16, -1) + 1;
 		}
-		sl_reg n = 0;
-		for (sl_reg i = 0; i < lenUtf16 && (lenUtf8Buffer < 0 || n < lenUtf8Buffer); i++) {
-			sl_uint32 ch = (sl_uint32)(utf16[i]);
-			if (ch < 0x80) {
-				if (utf8) {
-					utf8[n++] = (sl_char8)(ch);
-				} else {
-					n++;
+		sl_size len = (sl_size)lenUtf16;
+		sl_size limit = lenUtf8Buffer < 0 ? SLIB_SIZE_MAX : (sl_size)lenUtf8Buffer;
+		sl_size i = 0;
+		sl_size n = 0;
+		while (i < len && n < limit) {
+			sl_size end = len;
+			if (len - i >= 16) {
+				sl_size m = limit - n;
+				if (m > len - i) {
+					m = len - i;
+				}
+				m = _priv_Charsets_utf16ToUtf8_block(utf16 + i, m, utf8 ? utf8 + n : sl_null);
+				i += m;
+				n += m;
+				end = i + 64;
+				if (end > len) {
+					end = len;
 				}
-			} else if (ch < 0x800) {
-				if (lenUtf8Buffer < 0 || n + 1 < lenUtf8Buffer) {
+			}
+			while (i < end) {
+				sl_uint32 ch = (sl_uint32)((sl_uint16)utf16[i]);
+				if (ch < 0x80) {
+					if (n >= limit) {
+						return n;
+					}
 					if (utf8) {
-						utf8[n++] = (sl_char8)((ch >> 6) | 0xC0);
-						utf8[n++] = (sl_char8)((ch & 0x3F) | 0x80);
-					} else {
-						n += 2;
+						utf8[n] = (sl_char8)(ch);
+					}
+					n++;
+				} else if (ch < 0x800) {
+					if (n + 1 >= limit) {
+						return n;
 					}
-				}
-			} else {
-				if (lenUtf8Buffer < 0 || n + 2 < lenUtf8Buffer) {
 					if (utf8) {
-						utf8[n++] = (sl_char8)((ch >> 12) | 0xE0);
-						utf8[n++] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)((ch & 0x3F) | 0x80);
-					} else {
-						n += 3;
+						utf8[n] = (sl_char8)((ch >> 6) | 0xC0);
+						utf8[n + 1] = (sl_char8)((ch & 0x3F) | 0x80);
+					}
+					n += 2;
+				} else {
+					if (ch >= 0xD800 && ch < 0xDC00 && i + 1 < len) {
+						sl_uint32 ch1 = (sl_uint32)((sl_uint16)utf16[i + 1]);
+						if (ch1 >= 0xDC00 && ch1 < 0xE000) {
+							if (n + 3 >= limit) {
+								return n;
+							}
+							if (utf8) {
+								sl_uint32 code = 0x10000 + (((ch - 0xD800) << 10) | (ch1 - 0xDC00));
+								utf8[n] = (sl_char8)((code >> 18) | 0xF0);
+								utf8[n + 1] = (sl_char8)(((code >> 12) & 0x3F) | 0x80);
+								utf8[n + 2] = (sl_char8)(((code >> 6) & 0x3F) | 0x80);
+								utf8[n + 3] = (sl_char8)((code & 0x3F) | 0x80);
+							}
+							n += 4;
+							i += 2;
+							continue;
+						}
 					}
+					// BMP characters and unpaired surrogates
+					if (n + 2 >= limit) {
+						return n;
+					}
+					if (utf8) {
+						utf8[n] = (sl_char8)((ch >> 12) | 0xE0);
+						utf8[n + 1] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
+						utf8[n + 2] = (sl_char8)((ch & 0x3F) | 0x80);
+					}
+					n += 3;
 				}
+				i++;
 			}
 		}
 		return n;
@@ -199,69 +969,66 @@ namespace slib
 		if (lenUtf32 < 0) {
 			lenUtf32 = Base::getStringLength4(utf32, -1) + 1;
 		}
-		sl_reg n = 0;
-		for (sl_reg i = 0; i < lenUtf32 && (lenUtf8Buffer < 0 || n < lenUtf8Buffer); i++) {
-			sl_uint32 ch = (sl_uint32)(utf32[i]);
-			if (ch < 0x80) {
-				if (utf8) {
-					utf8[n++] = (sl_char8)(ch);
-				} else {
-					n++;
+		sl_size len = (sl_size)lenUtf32;
+		sl_size limit = lenUtf8Buffer < 0 ? SLIB_SIZE_MAX : (sl_size)lenUtf8Buffer;
+		sl_size i = 0;
+		sl_size n = 0;
+		while (i < len && n < limit) {
+			sl_size end = len;
+			if (len - i >= 16) {
+				sl_size m = limit - n;
+				if (m > len - i) {
+					m = len - i;
 				}
-			} else if (ch < 0x800) {
-				if (lenUtf8Buffer < 0 || n + 1 < lenUtf8Buffer) {
-					if (utf8) {
-						utf8[n++] = (sl_char8)((ch >> 6) | 0xC0);
-						utf8[n++] = (sl_char8)((ch & 0x3F) | 0x80);
-					} else {
-						n += 2;
-					}
+				m = _priv_Charsets_utf32ToUtf8_block(utf32 + i, m, utf8 ? utf8 + n : sl_null);
+				i += m;
+				n += m;
+				end = i + 64;
+				if (end > len) {
+					end = len;
 				}
-			} else if (ch < 0x10000) {
-				if (lenUtf8Buffer < 0 || n + 2 < lenUtf8Buffer) {
-					if (utf8) {
-						utf8[n++] = (sl_char8)((ch >> 12) | 0xE0);
-						utf8[n++] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)((ch & 0x3F) | 0x80);
-					} else {
-						n += 3;
+			}
+			for (; i < end; i++) {
+				sl_uint32 ch = (sl_uint32)(utf32[i]);
+				if (ch < 0x80) {
+					if (n >= limit) {
+						return n;
 					}
-				}
-			} else if (ch < 0x200000) {
-				if (lenUtf8Buffer < 0 || n + 3 < lenUtf8Buffer) {
 					if (utf8) {
-						utf8[n++] = (sl_char8)((ch >> 18) | 0xF0);
-						utf8[n++] = (sl_char8)(((ch >> 12) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)((ch & 0x3F) | 0x80);
-					} else {
-						n += 4;
+						utf8[n] = (sl_char8)(ch);
 					}
-				}
-			} else if (ch < 0x4000000) {
-				if (lenUtf8Buffer < 0 || n + 4 < lenUtf8Buffer) {
-					if (utf8) {
-						utf8[n++] = (sl_char8)((ch >> 24) | 0xF8);
-						utf8[n++] = (sl_char8)(((ch >> 18) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)(((ch >> 12) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)((ch & 0x3F) | 0x80);
+					n++;
+				} else {
+					sl_size nTrails;
+					sl_uint32 lead;
+					if (ch < 0x800) {
+						nTrails = 1;
+						lead = 0xC0;
+					} else if (ch < 0x10000) {
+						nTrails = 2;
+						lead = 0xE0;
+					} else if (ch < 0x200000) {
+						nTrails = 3;
+						lead = 0xF0;
+					} else if (ch < 0x4000000) {
+						nTrails = 4;
+						lead = 0xF8;
+					} else if (ch < 0x80000000) {
+						nTrails = 5;
+						lead = 0xFC;
 					} else {
-						n += 5;
+						continue;
+					}
+					if (n + nTrails >= limit) {
+						return n;
 					}
-				}
-			} else if (ch < 0x80000000) {
-				if (lenUtf8Buffer < 0 || n + 5 < lenUtf8Buffer) {
 					if (utf8) {
-						utf8[n++] = (sl_char8)((ch >> 30) | 0xFC);
-						utf8[n++] = (sl_char8)(((ch >> 24) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)(((ch >> 18) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)(((ch >> 12) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
-						utf8[n++] = (sl_char8)((ch & 0x3F) | 0x80);
-					} else {
-						n += 6;
+						utf8[n] = (sl_char8)((ch >> (6 * nTrails)) | lead);
+						for (sl_size k = 1; k <= nTrails; k++) {
+							utf8[n + k] = (sl_char8)(((ch >> (6 * (nTrails - k))) & 0x3F) | 0x80);
+						}
 					}
+					n += nTrails + 1;
 				}
 			}
 		}
@@ -273,25 +1040,50 @@ namespace slib
 		if (lenUtf16 < 0) {
 			lenUtf16 = Base::getStringLength2(utf16, -1) + 1;
 		}
-		sl_reg n = 0;
-		for (sl_reg i = 0; i < lenUtf16 && (lenUtf32Buffer < 0 || n < lenUtf32Buffer); i++) {
-			sl_uint32 ch = (sl_uint32)((sl_uint16)utf16[i]);
-			if (ch < 0xD800 || ch >= 0xE000) {
-				if (utf32) {
-					utf32[n++] = (sl_char32)ch;
-				} else {
-					n++;
+		sl_size len = (sl_size)lenUtf16;
+		sl_size limit = lenUtf32Buffer < 0 ? SLIB_SIZE_MAX : (sl_size)lenUtf32Buffer;
+		sl_size i = 0;
+		sl_size n = 0;
+		while (i < len && n < limit) {
+			sl_size end = len;
+			if (len - i >= 16) {
+				sl_size m = limit - n;
+				if (m > len - i) {
+					m = len - i;
 				}
-			} else {
-				if (i + 1 < lenUtf16) {
-					sl_uint32 ch1 = (sl_uint32)((sl_uint8)utf16[++i]);
-					if (ch < 0xDC00 && ch1 >= 0xDC00 && ch1 < 0xE000) {
-						if (utf32) {
-							utf32[n++] = (sl_char32)(((ch - 0xD800) << 10) | (ch1 - 0xDC00));
-						} else {
+				m = _priv_Charsets_utf16ToUtf32_block(utf16 + i, m, utf32 ? utf32 + n : sl_null);
+				i += m;
+				n += m;
+				end = i + 64;
+				if (end > len) {
+					end = len;
+				}
+			}
+			while (i < end) {
+				if (n >= limit) {
+					return n;
+				}
+				sl_uint32 ch = (sl_uint32)((sl_uint16)utf16[i]);
+				if (ch < 0xD800 || ch >= 0xE000) {
+					if (utf32) {
+						utf32[n] = (sl_char32)ch;
+					}
+					n++;
+					i++;
+				} else {
+					if (ch < 0xDC00 && i + 1 < len) {
+						sl_uint32 ch1 = (sl_uint32)((sl_uint16)utf16[i + 1]);
+						if (ch1 >= 0xDC00 && ch1 < 0xE000) {
+							if (utf32) {
+								utf32[n] = (sl_char32)(0x10000 + (((ch - 0xD800) << 10) | (ch1 - 0xDC00)));
+							}
 							n++;
+							i += 2;
+							continue;
 						}
 					}
+					// Unpaired surrogate
+					i++;
 				}
 			}
 		}
@@ -303,26 +1095,47 @@ namespace slib
 		if (lenUtf32 < 0) {
 			lenUtf32 = Base::getStringLength4(utf32, -1) + 1;
 		}
-		sl_reg n = 0;
-		for (sl_reg i = 0; i < lenUtf32 && (lenUtf16Buffer < 0 || n < lenUtf16Buffer); i++) {
-			sl_uint32 ch = (sl_uint32)(utf32[i]);
-			if (ch >= 0x10000) {
-				if (ch < 0x110000) {
-					if (lenUtf16Buffer < 0 || n + 1 < lenUtf16Buffer) {
+		sl_size len = (sl_size)lenUtf32;
+		sl_size limit = lenUtf16Buffer < 0 ? SLIB_SIZE_MAX : (sl_size)lenUtf16Buffer;
+		sl_size i = 0;
+		sl_size n = 0;
+		while (i < len && n < limit) {
+			sl_size end = len;
+			if (len - i >= 16) {
+				sl_size m = limit - n;
+				if (m > len - i) {
+					m = len - i;
+				}
+				m = _priv_Charsets_utf32ToUtf16_block(utf32 + i, m, utf16 ? utf16 + n : sl_null);
+				i += m;
+				n += m;
+				end = i + 64;
+				if (end > len) {
+					end = len;
+				}
+			}
+			for (; i < end; i++) {
+				sl_uint32 ch = (sl_uint32)(utf32[i]);
+				if (ch >= 0x10000) {
+					if (ch < 0x110000) {
+						if (n + 1 >= limit) {
+							return n;
+						}
 						if (utf16) {
 							ch -= 0x10000;
-							utf16[n++] = (sl_char16)(0xD800 + (ch >> 10));
-							utf16[n++] = (sl_char16)(0xDC00 + (ch & 0x3FF));
-						} else {
-							n += 2;
+							utf16[n] = (sl_char16)(0xD800 + (ch >> 10));
+							utf16[n + 1] = (sl_char16)(0xDC00 + (ch & 0x3FF));
 						}
+						n += 2;
 					}
-				}
-			} else {
-				if (ch < 0xD800 || ch >= 0xE000) {
-					if (utf16) {
-						utf16[n++] = (sl_char16)(ch);
-					} else {
+				} else {
+					if (ch < 0xD800 || ch >= 0xE000) {
+						if (n >= limit) {
+							return n;
+						}
+						if (utf16) {
+							utf16[n] = (sl_char16)(ch);
+						}
 						n++;
 					}
 				}
@@ -330,5 +1143,86 @@ namespace slib
 		}
 		return n;
 	}
+	
+	sl_bool Charsets::isValidUtf8(const sl_char8* utf8, sl_size len)
+	{
+		if (!len) {
+			return sl_true;
+		}
+		const sl_uint8* s = (const sl_uint8*)utf8;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (len >= 32 && _priv_Charsets_isAVX2()) {
+			return _priv_Charsets_isValidUtf8_avx2(s, len);
+		}
+		if (len >= 16 && _priv_Charsets_isSSSE3()) {
+			return _priv_Charsets_isValidUtf8_ssse3(s, len);
+		}
+#elif defined(SLIB_CPU_SUPPORT_SIMD_NEON)
+		if (len >= 16) {
+			return _priv_Charsets_isValidUtf8_neon(s, len);
+		}
+#endif
+		return _priv_Charsets_isValidUtf8_scalar(s, len);
+	}
+	
+	sl_bool Charsets::isValidUtf16(const sl_char16* utf16, sl_size len)
+	{
+		sl_size i = 0;
+		while (i < len) {
+			if (len - i >= 16) {
+				i += _priv_Charsets_utf16ToUtf32_block(utf16 + i, len - i, sl_null);
+				if (i >= len) {
+					break;
+				}
+			}
+			sl_uint32 ch = (sl_uint16)(utf16[i]);
+			if (ch >= 0xD800 && ch < 0xE000) {
+				if (ch >= 0xDC00 || i + 1 >= len) {
+					return sl_false;
+				}
+				sl_uint32 ch1 = (sl_uint16)(utf16[i + 1]);
+				if (ch1 < 0xDC00 || ch1 >= 0xE000) {
+					return sl_false;
+				}
+				i += 2;
+			} else {
+				i++;
+			}
+		}
+		return sl_true;
+	}
+	
+	sl_reg Charsets::utf8ToUtf16Strict(const sl_char8* utf8, sl_reg lenUtf8, sl_char16* utf16, sl_reg lenUtf16Buffer)
+	{
+		if (lenUtf8 < 0) {
+			lenUtf8 = Base::getStringLength(utf8, -1) + 1;
+		}
+		if (!(isValidUtf8(utf8, lenUtf8))) {
+			return -1;
+		}
+		return utf8ToUtf16(utf8, lenUtf8, utf16, lenUtf16Buffer);
+	}
+	
+	sl_reg Charsets::utf8ToUtf32Strict(const sl_char8* utf8, sl_reg lenUtf8, sl_char32* utf32, sl_reg lenUtf32Buffer)
+	{
+		if (lenUtf8 < 0) {
+			lenUtf8 = Base::getStringLength(utf8, -1) + 1;
+		}
+		if (!(isValidUtf8(utf8, lenUtf8))) {
+			return -1;
+		}
+		return utf8ToUtf32(utf8, lenUtf8, utf32, lenUtf32Buffer);
+	}
+	
+	sl_reg Charsets::utf16ToUtf8Strict(const sl_char16* utf16, sl_reg lenUtf16, sl_char8* utf8, sl_reg lenUtf8Buffer)
+	{
+		if (lenUtf16 < 0) {
+			lenUtf16 = Base::getStringLength2(utf16, -1) + 1;
+		}
+		if (!(isValidUtf16(utf16, lenUtf16))) {
+			return -1;
+		}
+		return utf16ToUtf8(utf16, lenUtf16, utf8, lenUtf8Buffer);
+	}
 
 }
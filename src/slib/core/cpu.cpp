@@ -0,0 +1,293 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(SLIB_ARCH_IS_ARM)
+#	if defined(SLIB_PLATFORM_IS_ANDROID)
+#		include <cpu-features.h>
+#	elif defined(SLIB_PLATFORM_IS_APPLE)
+#		include <sys/sysctl.h>
+#	elif defined(SLIB_PLATFORM_IS_LINUX)
+#		include <sys/auxv.h>
+#	endif
+#endif
+
+namespace slib
+{
+	
+	class _priv_Cpu_Features
+	{
+	public:
+		sl_bool flagSSE2;
+		sl_bool flagSSSE3;
+		sl_bool flagSSE41;
+		sl_bool flagSSE42;
+		sl_bool flagAVX2;
+		sl_bool flagAVX512;
+		sl_bool flagAESNI;
+		sl_bool flagPCLMULQDQ;
+		sl_bool flagVAES;
+		sl_bool flagSHANI;
+		
+		sl_bool flagNEON;
+		sl_bool flagARMv8AES;
+		sl_bool flagARMv8PMULL;
+		sl_bool flagARMv8SHA1;
+		sl_bool flagARMv8SHA2;
+		sl_bool flagARMv8CRC32;
+		
+	public:
+		_priv_Cpu_Features() noexcept
+		{
+			flagSSE2 = sl_false;
+			flagSSSE3 = sl_false;
+			flagSSE41 = sl_false;
+			flagSSE42 = sl_false;
+			flagAVX2 = sl_false;
+			flagAVX512 = sl_false;
+			flagAESNI = sl_false;
+			flagPCLMULQDQ = sl_false;
+			flagVAES = sl_false;
+			flagSHANI = sl_false;
+			flagNEON = sl_false;
+			flagARMv8AES = sl_false;
+			flagARMv8PMULL = sl_false;
+			flagARMv8SHA1 = sl_false;
+			flagARMv8SHA2 = sl_false;
+			flagARMv8CRC32 = sl_false;
+			
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+			sl_uint32 info[4];
+			getCpuId(0, 0, info);
+			sl_uint32 nIds = info[0];
+			if (nIds < 1) {
+				return;
+			}
+			getCpuId(1, 0, info);
+			sl_uint32 ecx1 = info[2];
+			sl_uint32 edx1 = info[3];
+			flagSSE2 = (edx1 >> 26) & 1;
+			flagSSSE3 = (ecx1 >> 9) & 1;
+			flagSSE41 = (ecx1 >> 19) & 1;
+			flagSSE42 = (ecx1 >> 20) & 1;
+			flagAESNI = (ecx1 >> 25) & 1;
+			flagPCLMULQDQ = (ecx1 >> 1) & 1;
+			sl_bool flagAVX = sl_false;
+			sl_bool flagAVX512State = sl_false;
+			if (((ecx1 >> 27) & 1) && ((ecx1 >> 28) & 1)) {
+				// OSXSAVE & AVX
+				sl_uint64 xcr0 = getXCR0();
+				flagAVX = (xcr0 & 6) == 6;
+				flagAVX512State = (xcr0 & 0xE6) == 0xE6;
+			}
+			if (nIds >= 7) {
+				getCpuId(7, 0, info);
+				sl_uint32 ebx7 = info[1];
+				sl_uint32 ecx7 = info[2];
+				flagSHANI = (ebx7 >> 29) & 1;
+				if (flagAVX) {
+					flagAVX2 = (ebx7 >> 5) & 1;
+					flagVAES = flagAVX2 && ((ecx7 >> 9) & 1) && ((ecx7 >> 10) & 1);
+				}
+				if (flagAVX512State && flagAVX2) {
+					// F, BW, VL
+					flagAVX512 = ((ebx7 >> 16) & 1) && ((ebx7 >> 30) & 1) && ((ebx7 >> 31) & 1);
+				}
+			}
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(SLIB_ARCH_IS_ARM)
+#	if defined(SLIB_ARCH_IS_ARM64)
+			flagNEON = sl_true;
+#	endif
+#	if defined(SLIB_PLATFORM_IS_ANDROID)
+			uint64_t features = android_getCpuFeatures();
+#		if defined(SLIB_ARCH_IS_ARM64)
+			flagARMv8AES = (features & ANDROID_CPU_ARM64_FEATURE_AES) != 0;
+			flagARMv8PMULL = (features & ANDROID_CPU_ARM64_FEATURE_PMULL) != 0;
+			flagARMv8SHA1 = (features & ANDROID_CPU_ARM64_FEATURE_SHA1) != 0;
+			flagARMv8SHA2 = (features & ANDROID_CPU_ARM64_FEATURE_SHA2) != 0;
+			flagARMv8CRC32 = (features & ANDROID_CPU_ARM64_FEATURE_CRC32) != 0;
+#		else
+			flagNEON = (features & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+			flagARMv8AES = (features & ANDROID_CPU_ARM_FEATURE_AES) != 0;
+			flagARMv8PMULL = (features & ANDROID_CPU_ARM_FEATURE_PMULL) != 0;
+			flagARMv8SHA1 = (features & ANDROID_CPU_ARM_FEATURE_SHA1) != 0;
+			flagARMv8SHA2 = (features & ANDROID_CPU_ARM_FEATURE_SHA2) != 0;
+			flagARMv8CRC32 = (features & ANDROID_CPU_ARM_FEATURE_CRC32) != 0;
+#		endif
+#	elif defined(SLIB_PLATFORM_IS_APPLE)
+#		if defined(SLIB_ARCH_IS_ARM64)
+			// every 64-bit Apple CPU supports crypto extensions
+			flagARMv8AES = sl_true;
+			flagARMv8PMULL = sl_true;
+			flagARMv8SHA1 = sl_true;
+			flagARMv8SHA2 = sl_true;
+			int value = 0;
+			size_t size = sizeof(value);
+			if (!(sysctlbyname("hw.optional.armv8_crc32", &value, &size, 0, 0))) {
+				flagARMv8CRC32 = value != 0;
+			}
+#		else
+			flagNEON = sl_true;
+#		endif
+#	elif defined(SLIB_PLATFORM_IS_LINUX)
+#		if defined(SLIB_ARCH_IS_ARM64)
+			unsigned long hwcap = getauxval(AT_HWCAP);
+			flagNEON = (hwcap & (1 << 1)) != 0; // HWCAP_ASIMD
+			flagARMv8AES = (hwcap & (1 << 3)) != 0;
+			flagARMv8PMULL = (hwcap & (1 << 4)) != 0;
+			flagARMv8SHA1 = (hwcap & (1 << 5)) != 0;
+			flagARMv8SHA2 = (hwcap & (1 << 6)) != 0;
+			flagARMv8CRC32 = (hwcap & (1 << 7)) != 0;
+#		else
+			unsigned long hwcap = getauxval(AT_HWCAP);
+			unsigned long hwcap2 = getauxval(AT_HWCAP2);
+			flagNEON = (hwcap & (1 << 12)) != 0; // HWCAP_NEON
+			flagARMv8AES = (hwcap2 & (1 << 0)) != 0;
+			flagARMv8PMULL = (hwcap2 & (1 << 1)) != 0;
+			flagARMv8SHA1 = (hwcap2 & (1 << 2)) != 0;
+			flagARMv8SHA2 = (hwcap2 & (1 << 3)) != 0;
+			flagARMv8CRC32 = (hwcap2 & (1 << 4)) != 0;
+#		endif
+#	endif
+#endif
+		}
+		
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		static void getCpuId(sl_uint32 leaf, sl_uint32 subleaf, sl_uint32 info[4]) noexcept
+		{
+#	if defined(SLIB_COMPILER_IS_VC)
+			__cpuidex((int*)info, (int)leaf, (int)subleaf);
+#	else
+			__cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+#	endif
+		}
+		
+		static sl_uint64 getXCR0() noexcept
+		{
+#	if defined(SLIB_COMPILER_IS_VC)
+			return (sl_uint64)(_xgetbv(0));
+#	else
+			sl_uint32 eax, edx;
+			__asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return ((sl_uint64)edx << 32) | eax;
+#	endif
+		}
+#endif
+		
+	public:
+		static const _priv_Cpu_Features& get() noexcept
+		{
+			static _priv_Cpu_Features features;
+			return features;
+		}
+		
+	};
+	
+	sl_bool Cpu::isSSE2Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagSSE2;
+	}
+	
+	sl_bool Cpu::isSSSE3Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagSSSE3;
+	}
+	
+	sl_bool Cpu::isSSE41Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagSSE41;
+	}
+	
+	sl_bool Cpu::isSSE42Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagSSE42;
+	}
+	
+	sl_bool Cpu::isAVX2Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagAVX2;
+	}
+	
+	sl_bool Cpu::isAVX512Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagAVX512;
+	}
+	
+	sl_bool Cpu::isAESNISupported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagAESNI;
+	}
+	
+	sl_bool Cpu::isPCLMULQDQSupported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagPCLMULQDQ;
+	}
+	
+	sl_bool Cpu::isVAESSupported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagVAES;
+	}
+	
+	sl_bool Cpu::isSHANISupported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagSHANI;
+	}
+	
+	sl_bool Cpu::isNEONSupported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagNEON;
+	}
+	
+	sl_bool Cpu::isARMv8AESSupported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagARMv8AES;
+	}
+	
+	sl_bool Cpu::isARMv8PMULLSupported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagARMv8PMULL;
+	}
+	
+	sl_bool Cpu::isARMv8SHA1Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagARMv8SHA1;
+	}
+	
+	sl_bool Cpu::isARMv8SHA2Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagARMv8SHA2;
+	}
+	
+	sl_bool Cpu::isARMv8CRC32Supported() noexcept
+	{
+		return _priv_Cpu_Features::get().flagARMv8CRC32;
+	}
+
+}
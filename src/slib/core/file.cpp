@@ -233,15 +233,23 @@ namespace slib
 	}
 
 
+	static StringView _priv_File_getFileName(const String& pathName)
+	{
+		StringView path(pathName);
+		sl_reg indexSlash = path.lastIndexOf('/');
+		sl_reg indexBackSlash = path.lastIndexOf('\\');
+		return path.substring(SLIB_MAX(indexSlash, indexBackSlash) + 1);
+	}
+
 	String File::getFileExtension(const String& pathName)
 	{
-		String fileName = getFileName(pathName);
+		StringView fileName = _priv_File_getFileName(pathName);
 		if (fileName.isEmpty()) {
 			return sl_null;
 		}
 		sl_reg index = fileName.lastIndexOf('.');
 		if (index > 0) {
-			return fileName.substring(index + 1);
+			return String(fileName.substring(index + 1));
 		} else {
 			return sl_null;
 		}
@@ -249,16 +257,18 @@ namespace slib
 
 	String File::getFileNameOnly(const String& pathName)
 	{
-		String fileName = getFileName(pathName);
+		StringView fileName = _priv_File_getFileName(pathName);
 		if (fileName.isEmpty()) {
 			return sl_null;
 		}
 		sl_reg index = fileName.lastIndexOf('.');
 		if (index > 0) {
-			return fileName.substring(0, index);
-		} else {
-			return fileName;
+			fileName = fileName.left(index);
+		}
+		if (fileName.getLength() == pathName.getLength()) {
+			return pathName;
 		}
+		return String(fileName);
 	}
 
 	String File::normalizeDirectoryPath(const String& _str)
@@ -26,6 +26,7 @@
 
 #include "slib/core/list.h"
 #include "slib/core/map.h"
+#include "slib/core/string_pool.h"
 
 #include "slib/core/file.h"
 #include "slib/core/log.h"
@@ -37,6 +38,7 @@ namespace slib
 	{
 		flagLogError = sl_true;
 		flagSupportComments = sl_true;
+		flagInternKeys = sl_false;
 		
 		flagError = sl_false;
 		errorLine = 0;
@@ -312,6 +314,7 @@ namespace slib
 		const CT* buf = sl_null;
 		sl_size len = 0;
 		sl_bool flagSupportComments = sl_false;
+		StringPool* keyPool = sl_null;
 		
 		sl_size pos = 0;
 		
@@ -328,6 +331,8 @@ namespace slib
 	public:
 		void escapeSpaceAndComments();
 		
+		String internKey(const CT* key, sl_size len);
+		
 		Json parseJson();
 
 		static Json parseJson(const CT* buf, sl_size len, JsonParseParam& param);
@@ -356,6 +361,28 @@ namespace slib
 		strFalse = _false;
 	}
 
+	template <>
+	String _priv_Json_Parser<String, sl_char8>::internKey(const sl_char8* key, sl_size len)
+	{
+		StringView view(key, len);
+		String ret = keyPool->get(view);
+		if (ret.isNotNull()) {
+			return ret;
+		}
+		return String(view);
+	}
+
+	template <>
+	String _priv_Json_Parser<String16, sl_char16>::internKey(const sl_char16* key, sl_size len)
+	{
+		String str(key, len);
+		String ret = keyPool->get(str);
+		if (ret.isNotNull()) {
+			return ret;
+		}
+		return str;
+	}
+
 	template <class ST, class CT>
 	void _priv_Json_Parser<ST, CT>::escapeSpaceAndComments()
 	{
@@ -513,20 +540,41 @@ namespace slib
 					errorMessage = "Object: Missing character } ";
 					return sl_null;
 				}
-				ST key;
+				String key;
 				ch = buf[pos];
 				if (ch == '}') {
 					pos++;
 					return map;
 				} else if (ch == '"' || ch == '\'') {
-					sl_size m = 0;
-					sl_bool f = sl_false;
-					key = ParseUtil::parseBackslashEscapes(buf + pos, len - pos, &m, &f);
-					pos += m;
-					if (f) {
-						flagError = sl_true;
-						errorMessage = "Object Item Name: Missing terminating character \" or ' ";
-						return sl_null;
+					if (keyPool) {
+						// keys without escapes are interned directly from the source
+						sl_size s = pos + 1;
+						sl_size e = s;
+						while (e < len && buf[e] != ch && buf[e] != '\\') {
+							e++;
+						}
+						if (e < len && buf[e] == ch) {
+							key = internKey(buf + s, e - s);
+							pos = e + 1;
+						}
+					}
+					if (key.isNull()) {
+						sl_size m = 0;
+						sl_bool f = sl_false;
+						ST str = ParseUtil::parseBackslashEscapes(buf + pos, len - pos, &m, &f);
+						pos += m;
+						if (f) {
+							flagError = sl_true;
+							errorMessage = "Object Item Name: Missing terminating character \" or ' ";
+							return sl_null;
+						}
+						key = str;
+						if (keyPool) {
+							String interned = keyPool->get(key);
+							if (interned.isNotNull()) {
+								key = Move(interned);
+							}
+						}
 					}
 				} else {
 					sl_size s = pos;
@@ -543,7 +591,11 @@ namespace slib
 						errorMessage = "Object: Missing character : ";
 						return sl_null;
 					}
-					key = ST(buf + s, pos - s);
+					if (keyPool) {
+						key = internKey(buf + s, pos - s);
+					} else {
+						key = ST(buf + s, pos - s);
+					}
 				}
 				escapeSpaceAndComments();
 				if (pos == len) {
@@ -631,6 +683,9 @@ namespace slib
 		parser.buf = buf;
 		parser.len = len;
 		parser.flagSupportComments = param.flagSupportComments;
+		if (param.flagInternKeys) {
+			parser.keyPool = StringPool::getDefault();
+		}
 		
 		parser.pos = 0;
 		parser.flagError = sl_false;
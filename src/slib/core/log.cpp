@@ -26,6 +26,7 @@
 #include "slib/core/console.h"
 #include "slib/core/variant.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/string_format.h"
 
 #if defined(SLIB_PLATFORM_IS_ANDROID)
 #include <android/log.h>
@@ -55,7 +56,7 @@ namespace slib
 
 	static String _priv_Log_getLineString(const String& tag, const String& content)
 	{
-		return String::format("%s [%s] %s", Time::now(), tag, content);
+		return SLIB_FORMAT("%s [%s] %s", Time::now(), tag, content);
 	}
 
 	FileLogger::FileLogger()
@@ -33,6 +33,10 @@
 #include "float.h"
 #endif
 
+#if defined(SLIB_COMPILER_IS_VC)
+#include <intrin.h>
+#endif
+
 namespace slib
 {
 
@@ -495,55 +499,58 @@ namespace slib
 
 	sl_uint32 Math::getMostSignificantBits(sl_uint32 n) noexcept
 	{
-		sl_uint32 ret = 0;
-		while (n) {
-			ret++;
-			n >>= 1;
-		}
-		return ret;
+		return getMostSignificantBits32(n);
 	}
 	
 	sl_uint32 Math::getMostSignificantBits32(sl_uint32 n) noexcept
 	{
+		if (!n) {
+			return 0;
+		}
+#if defined(SLIB_COMPILER_IS_VC)
+		unsigned long index;
+		_BitScanReverse(&index, n);
+		return (sl_uint32)index + 1;
+#elif defined(SLIB_COMPILER_IS_GCC)
+		return 32 - (sl_uint32)(__builtin_clz(n));
+#else
 		sl_uint32 ret = 0;
 		while (n) {
 			ret++;
 			n >>= 1;
 		}
 		return ret;
+#endif
 	}
 
 	sl_uint32 Math::getMostSignificantBits(sl_uint64 n) noexcept
 	{
-		sl_uint32 ret = 0;
-		while (n) {
-			ret++;
-			n >>= 1;
-		}
-		return ret;
+		return getMostSignificantBits64(n);
 	}
 	
 	sl_uint32 Math::getMostSignificantBits64(sl_uint64 n) noexcept
 	{
-		sl_uint32 ret = 0;
-		while (n) {
-			ret++;
-			n >>= 1;
+		if (!n) {
+			return 0;
 		}
-		return ret;
+#if defined(SLIB_COMPILER_IS_VC) && defined(SLIB_ARCH_IS_64BIT)
+		unsigned long index;
+		_BitScanReverse64(&index, n);
+		return (sl_uint32)index + 1;
+#elif defined(SLIB_COMPILER_IS_GCC)
+		return 64 - (sl_uint32)(__builtin_clzll(n));
+#else
+		sl_uint32 high = (sl_uint32)(n >> 32);
+		if (high) {
+			return getMostSignificantBits32(high) + 32;
+		}
+		return getMostSignificantBits32((sl_uint32)n);
+#endif
 	}
 
 	sl_uint32 Math::getLeastSignificantBits(sl_uint32 n) noexcept
 	{
-		if (n == 0) {
-			return 0;
-		}
-		sl_uint32 ret = 0;
-		while ((n & 1) == 0) {
-			ret++;
-			n >>= 1;
-		}
-		return ret;
+		return getLeastSignificantBits32(n);
 	}
 	
 	sl_uint32 Math::getLeastSignificantBits32(sl_uint32 n) noexcept
@@ -551,25 +558,25 @@ namespace slib
 		if (n == 0) {
 			return 0;
 		}
+#if defined(SLIB_COMPILER_IS_VC)
+		unsigned long index;
+		_BitScanForward(&index, n);
+		return (sl_uint32)index;
+#elif defined(SLIB_COMPILER_IS_GCC)
+		return (sl_uint32)(__builtin_ctz(n));
+#else
 		sl_uint32 ret = 0;
 		while ((n & 1) == 0) {
 			ret++;
 			n >>= 1;
 		}
 		return ret;
+#endif
 	}
 
 	sl_uint32 Math::getLeastSignificantBits(sl_uint64 n) noexcept
 	{
-		if (n == 0) {
-			return 0;
-		}
-		sl_uint32 ret = 0;
-		while ((n & 1) == 0) {
-			ret++;
-			n >>= 1;
-		}
-		return ret;
+		return getLeastSignificantBits64(n);
 	}
 	
 	sl_uint32 Math::getLeastSignificantBits64(sl_uint64 n) noexcept
@@ -577,12 +584,19 @@ namespace slib
 		if (n == 0) {
 			return 0;
 		}
-		sl_uint32 ret = 0;
-		while ((n & 1) == 0) {
-			ret++;
-			n >>= 1;
+#if defined(SLIB_COMPILER_IS_VC) && defined(SLIB_ARCH_IS_64BIT)
+		unsigned long index;
+		_BitScanForward64(&index, n);
+		return (sl_uint32)index;
+#elif defined(SLIB_COMPILER_IS_GCC)
+		return (sl_uint32)(__builtin_ctzll(n));
+#else
+		sl_uint32 low = (sl_uint32)n;
+		if (low) {
+			return getLeastSignificantBits32(low);
 		}
-		return ret;
+		return getLeastSignificantBits32((sl_uint32)(n >> 32)) + 32;
+#endif
 	}
 	
 }
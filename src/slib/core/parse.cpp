@@ -297,6 +297,7 @@ namespace slib
 									i++;
 									sl_uint16 t = 0;
 									for (int k = 0; k < 4; k++) {
+										ch = sz[i];
 										sl_uint16 h = SLIB_CHAR_HEX_TO_INT(ch);
 										if (h < 16) {
 											t = (t << 4) | h;
@@ -20,28 +20,1744 @@
  *   THE SOFTWARE.
  */
 
+
 #include "slib/core/regex.h"
 
+#include "slib/core/hash_map.h"
+#include "slib/core/spin_lock.h"
 #include "slib/core/safe_static.h"
 
 #include <regex>
 
+#define PRIV_REGEX_MAX_PROGRAM_SIZE 100000
+#define PRIV_REGEX_MAX_REPEAT 1000
+#define PRIV_REGEX_MAX_DEPTH 256
+#define PRIV_REGEX_MAX_EMPTY_CHECK_DEPTH 4
+#define PRIV_REGEX_MAX_DFA_STATES 1024
+#define PRIV_REGEX_MAX_CACHE 256
+#define PRIV_REGEX_INFINITE 0xFFFFFFFF
+
 namespace slib
 {
+
+	class _priv_RegEx_ByteSet
+	{
+	public:
+		sl_uint32 bits[8];
+		
+	public:
+		void clear() noexcept
+		{
+			for (sl_uint32 i = 0; i < 8; i++) {
+				bits[i] = 0;
+			}
+		}
+		
+		sl_bool contains(sl_uint8 ch) const noexcept
+		{
+			return (bits[ch >> 5] & (1 << (ch & 31))) != 0;
+		}
+		
+		void add(sl_uint8 ch) noexcept
+		{
+			bits[ch >> 5] |= (1 << (ch & 31));
+		}
+		
+		void addRange(sl_uint32 from, sl_uint32 to) noexcept
+		{
+			for (sl_uint32 ch = from; ch <= to; ch++) {
+				add((sl_uint8)ch);
+			}
+		}
+		
+		void addSet(const _priv_RegEx_ByteSet& other) noexcept
+		{
+			for (sl_uint32 i = 0; i < 8; i++) {
+				bits[i] |= other.bits[i];
+			}
+		}
+		
+		void invert() noexcept
+		{
+			for (sl_uint32 i = 0; i < 8; i++) {
+				bits[i] = ~(bits[i]);
+			}
+		}
+		
+		void addOtherCases() noexcept
+		{
+			for (sl_uint32 ch = 'A'; ch <= 'Z'; ch++) {
+				if (contains((sl_uint8)ch)) {
+					add((sl_uint8)(ch + 32));
+				} else if (contains((sl_uint8)(ch + 32))) {
+					add((sl_uint8)ch);
+				}
+			}
+		}
+		
+	};
+	
+	enum class _priv_RegEx_Op
+	{
+		Byte, // x: byte
+		ByteSet, // x: index of the set
+		Split, // x: preferred, y: alternative
+		Jump, // x: target
+		Save, // x: slot
+		ClearSlots, // x: first slot, y: end slot
+		BeginIteration, // x: bit of the empty check
+		CheckIteration, // x: bit of the empty check
+		AssertBegin,
+		AssertEnd,
+		AssertWordBoundary,
+		AssertNotWordBoundary,
+		Match
+	};
+	
+	class _priv_RegEx_Inst
+	{
+	public:
+		_priv_RegEx_Op op;
+		sl_uint32 x;
+		sl_uint32 y;
+	};
+	
+	enum class _priv_RegEx_NodeType
+	{
+		Empty,
+		Byte,
+		ByteSet,
+		Concat,
+		Alternate,
+		Repeat,
+		Group,
+		Assert
+	};
+	
+	class _priv_RegEx_Node
+	{
+	public:
+		_priv_RegEx_NodeType type;
+		// Byte: byte, ByteSet: index of the set, Group: capture index (0 for non-capturing), Assert: opcode
+		sl_uint32 value;
+		sl_uint32 min;
+		sl_uint32 max;
+		sl_bool flagGreedy;
+		List<sl_uint32> children;
+	};
+	
+	SLIB_INLINE static sl_bool _priv_RegEx_isWordChar(sl_uint8 ch) noexcept
+	{
+		return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+	}
+	
+	SLIB_INLINE static sl_int32 _priv_RegEx_getHexValue(sl_char8 ch) noexcept
+	{
+		if (ch >= '0' && ch <= '9') {
+			return ch - '0';
+		}
+		if (ch >= 'a' && ch <= 'f') {
+			return ch - 'a' + 10;
+		}
+		if (ch >= 'A' && ch <= 'F') {
+			return ch - 'A' + 10;
+		}
+		return -1;
+	}
+	
+	class _priv_RegEx_Parser
+	{
+	public:
+		const sl_char8* data;
+		sl_size len;
+		sl_size pos;
+		sl_bool flagIcase;
+		sl_bool flagNosubs;
+		
+		// the pattern is valid but not supported by the native engine
+		sl_bool flagUnsupported;
+		sl_uint32 nGroups;
+		sl_uint32 depth;
+		
+		List<_priv_RegEx_Node> nodes;
+		List<_priv_RegEx_ByteSet> sets;
+		
+	public:
+		_priv_RegEx_Parser(const sl_char8* _data, sl_size _len, int flags) noexcept
+		{
+			data = _data;
+			len = _len;
+			pos = 0;
+			flagIcase = (flags & RegExFlags::Icase) != 0;
+			flagNosubs = (flags & RegExFlags::Nosubs) != 0;
+			flagUnsupported = sl_false;
+			nGroups = 0;
+			depth = 0;
+		}
+		
+	public:
+		// returns -1 on error
+		sl_int32 parse() noexcept
+		{
+			sl_int32 root = parseAlternate();
+			if (root < 0) {
+				return -1;
+			}
+			if (pos != len) {
+				// unmatched ')'
+				return -1;
+			}
+			return root;
+		}
+		
+		_priv_RegEx_Node& getNode(sl_uint32 index) noexcept
+		{
+			return nodes.getData()[index];
+		}
+		
+		sl_bool isNullable(sl_uint32 index) noexcept
+		{
+			_priv_RegEx_Node& node = getNode(index);
+			sl_uint32* children = node.children.getData();
+			sl_uint32 nChildren = (sl_uint32)(node.children.getCount());
+			switch (node.type) {
+				case _priv_RegEx_NodeType::Byte:
+				case _priv_RegEx_NodeType::ByteSet:
+					return sl_false;
+				case _priv_RegEx_NodeType::Concat:
+					for (sl_uint32 i = 0; i < nChildren; i++) {
+						if (!(isNullable(children[i]))) {
+							return sl_false;
+						}
+					}
+					return sl_true;
+				case _priv_RegEx_NodeType::Alternate:
+					for (sl_uint32 i = 0; i < nChildren; i++) {
+						if (isNullable(children[i])) {
+							return sl_true;
+						}
+					}
+					return sl_false;
+				case _priv_RegEx_NodeType::Group:
+					return isNullable(children[0]);
+				case _priv_RegEx_NodeType::Repeat:
+					return !(node.min) || isNullable(children[0]);
+				default:
+					return sl_true;
+			}
+		}
+		
+		// gets the range of the capture indices inside the node. `first` > `last` if there is no capturing group
+		void getCaptureRange(sl_uint32 index, sl_uint32& first, sl_uint32& last) noexcept
+		{
+			_priv_RegEx_Node& node = getNode(index);
+			if (node.type == _priv_RegEx_NodeType::Group && node.value) {
+				if (node.value < first) {
+					first = node.value;
+				}
+				if (node.value > last) {
+					last = node.value;
+				}
+			}
+			ListElements<sl_uint32> children(node.children);
+			for (sl_size i = 0; i < children.count; i++) {
+				getCaptureRange(children[i], first, last);
+			}
+		}
+		
+	private:
+		sl_int32 newNode(_priv_RegEx_NodeType type, sl_uint32 value = 0) noexcept
+		{
+			_priv_RegEx_Node node;
+			node.type = type;
+			node.value = value;
+			node.min = 0;
+			node.max = 0;
+			node.flagGreedy = sl_true;
+			sl_int32 index = (sl_int32)(nodes.getCount());
+			if (nodes.add_NoLock(Move(node))) {
+				return index;
+			}
+			return -1;
+		}
+		
+		sl_bool addChild(sl_int32 parent, sl_int32 child) noexcept
+		{
+			return getNode(parent).children.add_NoLock((sl_uint32)child);
+		}
+		
+		sl_int32 newByteSetNode(_priv_RegEx_ByteSet& set) noexcept
+		{
+			if (flagIcase) {
+				set.addOtherCases();
+			}
+			sl_uint32 index = (sl_uint32)(sets.getCount());
+			if (!(sets.add_NoLock(set))) {
+				return -1;
+			}
+			return newNode(_priv_RegEx_NodeType::ByteSet, index);
+		}
+		
+		sl_int32 newByteNode(sl_uint8 ch) noexcept
+		{
+			if (flagIcase && ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'))) {
+				_priv_RegEx_ByteSet set;
+				set.clear();
+				set.add(ch);
+				return newByteSetNode(set);
+			}
+			return newNode(_priv_RegEx_NodeType::Byte, ch);
+		}
+		
+		sl_int32 newCodePointNode(sl_uint32 code) noexcept
+		{
+			if (code < 0x80) {
+				return newByteNode((sl_uint8)code);
+			}
+			sl_uint8 buf[4];
+			sl_uint32 n;
+			if (code < 0x800) {
+				buf[0] = (sl_uint8)(0xC0 | (code >> 6));
+				buf[1] = (sl_uint8)(0x80 | (code & 0x3F));
+				n = 2;
+			} else {
+				buf[0] = (sl_uint8)(0xE0 | (code >> 12));
+				buf[1] = (sl_uint8)(0x80 | ((code >> 6) & 0x3F));
+				buf[2] = (sl_uint8)(0x80 | (code & 0x3F));
+				n = 3;
+			}
+			sl_int32 node = newNode(_priv_RegEx_NodeType::Concat);
+			if (node < 0) {
+				return -1;
+			}
+			for (sl_uint32 i = 0; i < n; i++) {
+				sl_int32 child = newNode(_priv_RegEx_NodeType::Byte, buf[i]);
+				if (child < 0 || !(addChild(node, child))) {
+					return -1;
+				}
+			}
+			return node;
+		}
+		
+		sl_int32 parseAlternate() noexcept
+		{
+			if (depth >= PRIV_REGEX_MAX_DEPTH) {
+				flagUnsupported = sl_true;
+				return -1;
+			}
+			depth++;
+			sl_int32 first = parseConcat();
+			if (first < 0) {
+				return -1;
+			}
+			if (pos >= len || data[pos] != '|') {
+				depth--;
+				return first;
+			}
+			sl_int32 node = newNode(_priv_RegEx_NodeType::Alternate);
+			if (node < 0 || !(addChild(node, first))) {
+				return -1;
+			}
+			while (pos < len && data[pos] == '|') {
+				pos++;
+				sl_int32 child = parseConcat();
+				if (child < 0 || !(addChild(node, child))) {
+					return -1;
+				}
+			}
+			depth--;
+			return node;
+		}
+		
+		sl_int32 parseConcat() noexcept
+		{
+			sl_int32 node = newNode(_priv_RegEx_NodeType::Concat);
+			if (node < 0) {
+				return -1;
+			}
+			while (pos < len) {
+				sl_char8 ch = data[pos];
+				if (ch == '|' || ch == ')') {
+					break;
+				}
+				sl_int32 child = parseRepeat();
+				if (child < 0 || !(addChild(node, child))) {
+					return -1;
+				}
+			}
+			return node;
+		}
+		
+		// returns sl_false if there is no quantifier, or `{` does not start a valid one
+		sl_bool parseQuantifier(sl_uint32& min, sl_uint32& max) noexcept
+		{
+			if (pos >= len) {
+				return sl_false;
+			}
+			sl_char8 ch = data[pos];
+			if (ch == '*') {
+				min = 0;
+				max = PRIV_REGEX_INFINITE;
+				pos++;
+				return sl_true;
+			}
+			if (ch == '+') {
+				min = 1;
+				max = PRIV_REGEX_INFINITE;
+				pos++;
+				return sl_true;
+			}
+			if (ch == '?') {
+				min = 0;
+				max = 1;
+				pos++;
+				return sl_true;
+			}
+			if (ch != '{') {
+				return sl_false;
+			}
+			sl_size p = pos + 1;
+			sl_uint32 n = 0;
+			sl_size start = p;
+			while (p < len && data[p] >= '0' && data[p] <= '9') {
+				if (n <= PRIV_REGEX_MAX_REPEAT) {
+					n = n * 10 + (data[p] - '0');
+				}
+				p++;
+			}
+			if (p == start || p >= len) {
+				return sl_false;
+			}
+			min = n;
+			if (data[p] == '}') {
+				max = n;
+			} else if (data[p] == ',') {
+				p++;
+				if (p >= len) {
+					return sl_false;
+				}
+				if (data[p] == '}') {
+					max = PRIV_REGEX_INFINITE;
+				} else {
+					n = 0;
+					start = p;
+					while (p < len && data[p] >= '0' && data[p] <= '9') {
+						if (n <= PRIV_REGEX_MAX_REPEAT) {
+							n = n * 10 + (data[p] - '0');
+						}
+						p++;
+					}
+					if (p == start || p >= len || data[p] != '}') {
+						return sl_false;
+					}
+					max = n;
+				}
+			} else {
+				return sl_false;
+			}
+			pos = p + 1;
+			return sl_true;
+		}
+		
+		sl_int32 parseRepeat() noexcept
+		{
+			sl_int32 node = parseAtom();
+			if (node < 0) {
+				return -1;
+			}
+			for (;;) {
+				sl_uint32 min, max;
+				if (!(parseQuantifier(min, max))) {
+					if (pos < len && data[pos] == '{') {
+						// invalid brace
+						return -1;
+					}
+					return node;
+				}
+				if (getNode(node).type == _priv_RegEx_NodeType::Assert) {
+					return -1;
+				}
+				if (min > max) {
+					return -1;
+				}
+				if (min > PRIV_REGEX_MAX_REPEAT || (max != PRIV_REGEX_INFINITE && max > PRIV_REGEX_MAX_REPEAT)) {
+					flagUnsupported = sl_true;
+					return -1;
+				}
+				sl_bool flagGreedy = sl_true;
+				if (pos < len && data[pos] == '?') {
+					flagGreedy = sl_false;
+					pos++;
+				}
+				sl_int32 child = node;
+				node = newNode(_priv_RegEx_NodeType::Repeat);
+				if (node < 0 || !(addChild(node, child))) {
+					return -1;
+				}
+				_priv_RegEx_Node& n = getNode(node);
+				n.min = min;
+				n.max = max;
+				n.flagGreedy = flagGreedy;
+			}
+		}
+		
+		sl_int32 parseAtom() noexcept
+		{
+			sl_char8 ch = data[pos];
+			switch (ch) {
+				case '(':
+				{
+					pos++;
+					sl_uint32 index = 0;
+					if (pos + 1 < len && data[pos] == '?') {
+						if (data[pos + 1] == ':') {
+							pos += 2;
+						} else {
+							// lookarounds and named groups
+							flagUnsupported = sl_true;
+							return -1;
+						}
+					} else {
+						nGroups++;
+						if (!flagNosubs) {
+							index = nGroups;
+						}
+					}
+					sl_int32 child = parseAlternate();
+					if (child < 0) {
+						return -1;
+					}
+					if (pos >= len || data[pos] != ')') {
+						return -1;
+					}
+					pos++;
+					sl_int32 node = newNode(_priv_RegEx_NodeType::Group, index);
+					if (node < 0 || !(addChild(node, child))) {
+						return -1;
+					}
+					return node;
+				}
+				case '[':
+					return parseClass();
+				case '.':
+				{
+					pos++;
+					_priv_RegEx_ByteSet set;
+					set.clear();
+					set.add('\n');
+					set.add('\r');
+					set.invert();
+					return newByteSetNode(set);
+				}
+				case '^':
+					pos++;
+					return newNode(_priv_RegEx_NodeType::Assert, (sl_uint32)(_priv_RegEx_Op::AssertBegin));
+				case '$':
+					pos++;
+					return newNode(_priv_RegEx_NodeType::Assert, (sl_uint32)(_priv_RegEx_Op::AssertEnd));
+				case '\\':
+					return parseEscape();
+				case '*':
+				case '+':
+				case '?':
+				case ')':
+					return -1;
+				case '{':
+					return -1;
+				default:
+					pos++;
+					return newByteNode((sl_uint8)ch);
+			}
+		}
+		
+		// parses `\d`, `\w`, `\s` and the negations. returns sl_false if `ch` is not a class escape
+		static sl_bool getClassEscape(sl_char8 ch, _priv_RegEx_ByteSet& set) noexcept
+		{
+			set.clear();
+			switch (ch) {
+				case 'd':
+				case 'D':
+					set.addRange('0', '9');
+					break;
+				case 'w':
+				case 'W':
+					set.addRange('a', 'z');
+					set.addRange('A', 'Z');
+					set.addRange('0', '9');
+					set.add('_');
+					break;
+				case 's':
+				case 'S':
+					set.add(' ');
+					set.addRange('\t', '\r');
+					break;
+				default:
+					return sl_false;
+			}
+			if (ch >= 'A' && ch <= 'Z') {
+				set.invert();
+			}
+			return sl_true;
+		}
+		
+		// parses the escapes representing a character. returns -1 on error
+		sl_int32 parseCharacterEscape(sl_bool flagInClass) noexcept
+		{
+			// `pos` is just after '\\'
+			if (pos >= len) {
+				return -1;
+			}
+			sl_char8 ch = data[pos];
+			pos++;
+			switch (ch) {
+				case 'n':
+					return '\n';
+				case 'r':
+					return '\r';
+				case 't':
+					return '\t';
+				case 'f':
+					return '\f';
+				case 'v':
+					return '\v';
+				case 'b':
+					// backspace in the class
+					return 8;
+				case '0':
+					if (pos < len && data[pos] >= '0' && data[pos] <= '9') {
+						flagUnsupported = sl_true;
+						return -1;
+					}
+					return 0;
+				case 'c':
+					if (pos < len && ((data[pos] >= 'a' && data[pos] <= 'z') || (data[pos] >= 'A' && data[pos] <= 'Z'))) {
+						sl_char8 c = data[pos];
+						pos++;
+						return c % 32;
+					}
+					return -1;
+				case 'x':
+					if (pos + 2 <= len) {
+						sl_int32 h1 = _priv_RegEx_getHexValue(data[pos]);
+						sl_int32 h2 = _priv_RegEx_getHexValue(data[pos + 1]);
+						if (h1 >= 0 && h2 >= 0) {
+							pos += 2;
+							return (h1 << 4) | h2;
+						}
+					}
+					return -1;
+				case 'u':
+					if (pos + 4 <= len) {
+						sl_int32 code = 0;
+						for (sl_uint32 i = 0; i < 4; i++) {
+							sl_int32 h = _priv_RegEx_getHexValue(data[pos + i]);
+							if (h < 0) {
+								return -1;
+							}
+							code = (code << 4) | h;
+						}
+						pos += 4;
+						if (flagInClass && code >= 0x80) {
+							flagUnsupported = sl_true;
+							return -1;
+						}
+						// marks code point
+						return code | 0x10000000;
+					}
+					return -1;
+				default:
+					if (ch >= '1' && ch <= '9') {
+						// backreference
+						flagUnsupported = sl_true;
+						return -1;
+					}
+					if (_priv_RegEx_isWordChar(ch) && !flagInClass) {
+						// unknown escape
+						return -1;
+					}
+					return (sl_uint8)ch;
+			}
+		}
+		
+		sl_int32 parseEscape() noexcept
+		{
+			pos++;
+			if (pos >= len) {
+				return -1;
+			}
+			sl_char8 ch = data[pos];
+			if (ch == 'b') {
+				pos++;
+				return newNode(_priv_RegEx_NodeType::Assert, (sl_uint32)(_priv_RegEx_Op::AssertWordBoundary));
+			}
+			if (ch == 'B') {
+				pos++;
+				return newNode(_priv_RegEx_NodeType::Assert, (sl_uint32)(_priv_RegEx_Op::AssertNotWordBoundary));
+			}
+			_priv_RegEx_ByteSet set;
+			if (getClassEscape(ch, set)) {
+				pos++;
+				return newByteSetNode(set);
+			}
+			sl_int32 code = parseCharacterEscape(sl_false);
+			if (code < 0) {
+				return -1;
+			}
+			if (code & 0x10000000) {
+				return newCodePointNode(code & 0xFFFF);
+			}
+			return newByteNode((sl_uint8)code);
+		}
+		
+		sl_int32 parseClass() noexcept
+		{
+			pos++;
+			sl_bool flagNegative = sl_false;
+			if (pos < len && data[pos] == '^') {
+				flagNegative = sl_true;
+				pos++;
+			}
+			_priv_RegEx_ByteSet set;
+			set.clear();
+			for (;;) {
+				if (pos >= len) {
+					return -1;
+				}
+				sl_char8 ch = data[pos];
+				if (ch == ']') {
+					pos++;
+					break;
+				}
+				sl_int32 from;
+				if (ch == '\\') {
+					pos++;
+					if (pos >= len) {
+						return -1;
+					}
+					_priv_RegEx_ByteSet setEscape;
+					if (getClassEscape(data[pos], setEscape)) {
+						pos++;
+						set.addSet(setEscape);
+						continue;
+					}
+					from = parseCharacterEscape(sl_true);
+					if (from < 0) {
+						return -1;
+					}
+					from &= 0xFF;
+				} else {
+					from = (sl_uint8)ch;
+					pos++;
+				}
+				if (pos + 1 < len && data[pos] == '-' && data[pos + 1] != ']') {
+					pos++;
+					sl_int32 to;
+					if (data[pos] == '\\') {
+						pos++;
+						if (pos >= len) {
+							return -1;
+						}
+						_priv_RegEx_ByteSet setEscape;
+						if (getClassEscape(data[pos], setEscape)) {
+							// ranges with class escapes
+							return -1;
+						}
+						to = parseCharacterEscape(sl_true);
+						if (to < 0) {
+							return -1;
+						}
+						to &= 0xFF;
+					} else {
+						to = (sl_uint8)(data[pos]);
+						pos++;
+					}
+					if (from > to) {
+						return -1;
+					}
+					set.addRange(from, to);
+				} else {
+					set.add((sl_uint8)from);
+				}
+			}
+			if (flagIcase) {
+				set.addOtherCases();
+			}
+			if (flagNegative) {
+				set.invert();
+			}
+			sl_uint32 index = (sl_uint32)(sets.getCount());
+			if (!(sets.add_NoLock(set))) {
+				return -1;
+			}
+			return newNode(_priv_RegEx_NodeType::ByteSet, index);
+		}
+		
+	};
+	
+	class _priv_RegEx_DfaState
+	{
+	public:
+		sl_int32 next[256];
+		sl_bool flagMatch;
+		sl_bool flagMatchAtEnd;
+		sl_bool flagDead;
+	};
+	
+	class _priv_RegEx_Dfa
+	{
+	public:
+		SpinLock lock;
+		List<_priv_RegEx_DfaState> states;
+		// sorted program counters of the states. the first element is the begin flag
+		List< List<sl_uint32> > stateThreads;
+		CHashMap<String, sl_uint32> map;
+		sl_int32 stateStart;
+		sl_int32 stateIdle;
+		sl_bool flagFull;
+		
+	public:
+		_priv_RegEx_Dfa() noexcept
+		{
+			stateStart = -1;
+			stateIdle = -1;
+			flagFull = sl_false;
+		}
+		
+	};
+	
+	class _priv_RegEx_SparseSet
+	{
+	public:
+		sl_uint32* dense;
+		sl_uint32* sparse;
+		sl_uint32 count;
+		
+	public:
+		SLIB_INLINE sl_bool contains(sl_uint32 value) const noexcept
+		{
+			sl_uint32 s = sparse[value];
+			return s < count && dense[s] == value;
+		}
+		
+		SLIB_INLINE void insert(sl_uint32 value) noexcept
+		{
+			sparse[value] = count;
+			dense[count] = value;
+			count++;
+		}
+		
+	};
+	
+	class _priv_RegEx_StackEntry
+	{
+	public:
+		sl_uint32 pc;
+		sl_uint32 mask;
+		sl_int32 slot;
+		sl_reg value;
+	};
+	
+	class _priv_RegEx_Program
+	{
+	public:
+		List<_priv_RegEx_Inst> insts;
+		List<_priv_RegEx_ByteSet> sets;
+		sl_uint32 nGroups;
+		sl_bool flagAnchorBegin;
+		sl_bool flagUseDfa;
+		String prefix;
+		// maximum nesting depth of the iterations checked for the empty match
+		sl_uint32 nEmptyCheckDepth;
+		sl_uint32 nClearedSlots;
+		_priv_RegEx_Dfa dfaMatch;
+		_priv_RegEx_Dfa dfaSearch;
+		
+	public:
+		_priv_RegEx_Program() noexcept
+		{
+			nGroups = 0;
+			flagAnchorBegin = sl_false;
+			flagUseDfa = sl_true;
+			nEmptyCheckDepth = 0;
+			nClearedSlots = 0;
+			m_depthEmptyCheck = 0;
+		}
+		
+	public:
+		static _priv_RegEx_Program* create(const String& pattern, int flags, sl_bool& flagUnsupported) noexcept
+		{
+			flagUnsupported = sl_false;
+			_priv_RegEx_Parser parser(pattern.getData(), pattern.getLength(), flags);
+			sl_int32 root = parser.parse();
+			if (root < 0) {
+				flagUnsupported = parser.flagUnsupported;
+				return sl_null;
+			}
+			_priv_RegEx_Program* program = new _priv_RegEx_Program;
+			if (!program) {
+				return sl_null;
+			}
+			program->sets = parser.sets;
+			if (!(parser.flagNosubs)) {
+				program->nGroups = parser.nGroups;
+			}
+			if (program->compileProgram(parser, root)) {
+				return program;
+			}
+			flagUnsupported = sl_true;
+			delete program;
+			return sl_null;
+		}
+		
+	private:
+		sl_uint32 m_depthEmptyCheck;
+		
+	private:
+		sl_bool emit(_priv_RegEx_Op op, sl_uint32 x = 0, sl_uint32 y = 0) noexcept
+		{
+			if (insts.getCount() >= PRIV_REGEX_MAX_PROGRAM_SIZE) {
+				return sl_false;
+			}
+			_priv_RegEx_Inst inst;
+			inst.op = op;
+			inst.x = x;
+			inst.y = y;
+			return insts.add_NoLock(inst);
+		}
+		
+		SLIB_INLINE sl_uint32 getPc() noexcept
+		{
+			return (sl_uint32)(insts.getCount());
+		}
+		
+		SLIB_INLINE _priv_RegEx_Inst& getInst(sl_uint32 pc) noexcept
+		{
+			return insts.getData()[pc];
+		}
+		
+		sl_bool compileNode(_priv_RegEx_Parser& parser, sl_uint32 index) noexcept
+		{
+			_priv_RegEx_Node& node = parser.getNode(index);
+			sl_uint32* children = node.children.getData();
+			sl_uint32 nChildren = (sl_uint32)(node.children.getCount());
+			switch (node.type) {
+				case _priv_RegEx_NodeType::Empty:
+					return sl_true;
+				case _priv_RegEx_NodeType::Byte:
+					return emit(_priv_RegEx_Op::Byte, node.value);
+				case _priv_RegEx_NodeType::ByteSet:
+					return emit(_priv_RegEx_Op::ByteSet, node.value);
+				case _priv_RegEx_NodeType::Assert:
+					if (node.value == (sl_uint32)(_priv_RegEx_Op::AssertWordBoundary) || node.value == (sl_uint32)(_priv_RegEx_Op::AssertNotWordBoundary)) {
+						flagUseDfa = sl_false;
+					}
+					return emit((_priv_RegEx_Op)(node.value));
+				case _priv_RegEx_NodeType::Concat:
+					for (sl_uint32 i = 0; i < nChildren; i++) {
+						if (!(compileNode(parser, children[i]))) {
+							return sl_false;
+						}
+					}
+					return sl_true;
+				case _priv_RegEx_NodeType::Alternate:
+				{
+					List<sl_uint32> jumps;
+					for (sl_uint32 i = 0; i < nChildren; i++) {
+						if (i + 1 < nChildren) {
+							sl_uint32 pcSplit = getPc();
+							if (!(emit(_priv_RegEx_Op::Split, pcSplit + 1))) {
+								return sl_false;
+							}
+							if (!(compileNode(parser, children[i]))) {
+								return sl_false;
+							}
+							if (!(jumps.add_NoLock(getPc()))) {
+								return sl_false;
+							}
+							if (!(emit(_priv_RegEx_Op::Jump))) {
+								return sl_false;
+							}
+							getInst(pcSplit).y = getPc();
+						} else {
+							if (!(compileNode(parser, children[i]))) {
+								return sl_false;
+							}
+						}
+					}
+					sl_uint32 pcEnd = getPc();
+					ListElements<sl_uint32> items(jumps);
+					for (sl_size i = 0; i < items.count; i++) {
+						getInst(items[i]).x = pcEnd;
+					}
+					return sl_true;
+				}
+				case _priv_RegEx_NodeType::Group:
+					if (node.value) {
+						if (!(emit(_priv_RegEx_Op::Save, node.value << 1))) {
+							return sl_false;
+						}
+					}
+					if (!(compileNode(parser, children[0]))) {
+						return sl_false;
+					}
+					if (node.value) {
+						return emit(_priv_RegEx_Op::Save, (node.value << 1) | 1);
+					}
+					return sl_true;
+				case _priv_RegEx_NodeType::Repeat:
+				{
+					sl_uint32 child = children[0];
+					sl_uint32 min = node.min;
+					sl_uint32 max = node.max;
+					sl_bool flagGreedy = node.flagGreedy;
+					// ECMAScript clears the captures inside the atom at the start of each iteration
+					sl_uint32 firstGroup = parser.nGroups + 1;
+					sl_uint32 lastGroup = 0;
+					if (max > 1) {
+						parser.getCaptureRange(child, firstGroup, lastGroup);
+					}
+					sl_bool flagClear = firstGroup <= lastGroup;
+					// and fails the iterations exceeding the minimum count when they match the empty string
+					sl_bool flagCheck = max > min && parser.isNullable(child);
+					sl_uint32 pcLast = 0;
+					for (sl_uint32 i = 0; i < min; i++) {
+						pcLast = getPc();
+						if (!(compileIteration(parser, child, flagClear && i, firstGroup, lastGroup, sl_false))) {
+							return sl_false;
+						}
+					}
+					if (max == PRIV_REGEX_INFINITE) {
+						if (min && !flagClear && !flagCheck) {
+							sl_uint32 pcNext = getPc() + 1;
+							if (flagGreedy) {
+								return emit(_priv_RegEx_Op::Split, pcLast, pcNext);
+							} else {
+								return emit(_priv_RegEx_Op::Split, pcNext, pcLast);
+							}
+						} else {
+							sl_uint32 pcSplit = getPc();
+							if (!(emit(_priv_RegEx_Op::Split))) {
+								return sl_false;
+							}
+							if (!(compileIteration(parser, child, flagClear, firstGroup, lastGroup, flagCheck))) {
+								return sl_false;
+							}
+							if (!(emit(_priv_RegEx_Op::Jump, pcSplit))) {
+								return sl_false;
+							}
+							_priv_RegEx_Inst& inst = getInst(pcSplit);
+							if (flagGreedy) {
+								inst.x = pcSplit + 1;
+								inst.y = getPc();
+							} else {
+								inst.x = getPc();
+								inst.y = pcSplit + 1;
+							}
+							return sl_true;
+						}
+					} else {
+						List<sl_uint32> splits;
+						for (sl_uint32 i = min; i < max; i++) {
+							if (!(splits.add_NoLock(getPc()))) {
+								return sl_false;
+							}
+							if (!(emit(_priv_RegEx_Op::Split))) {
+								return sl_false;
+							}
+							if (!(compileIteration(parser, child, flagClear && i, firstGroup, lastGroup, flagCheck))) {
+								return sl_false;
+							}
+						}
+						sl_uint32 pcEnd = getPc();
+						ListElements<sl_uint32> items(splits);
+						for (sl_size i = 0; i < items.count; i++) {
+							_priv_RegEx_Inst& inst = getInst(items[i]);
+							if (flagGreedy) {
+								inst.x = items[i] + 1;
+								inst.y = pcEnd;
+							} else {
+								inst.x = pcEnd;
+								inst.y = items[i] + 1;
+							}
+						}
+						return sl_true;
+					}
+				}
+			}
+			return sl_false;
+		}
+		
+		sl_bool compileIteration(_priv_RegEx_Parser& parser, sl_uint32 child, sl_bool flagClear, sl_uint32 firstGroup, sl_uint32 lastGroup, sl_bool flagCheck) noexcept
+		{
+			if (flagClear) {
+				sl_uint32 n = (lastGroup - firstGroup + 1) << 1;
+				if (!(emit(_priv_RegEx_Op::ClearSlots, firstGroup << 1, (lastGroup + 1) << 1))) {
+					return sl_false;
+				}
+				nClearedSlots += n;
+			}
+			if (!flagCheck) {
+				return compileNode(parser, child);
+			}
+			sl_uint32 bit = m_depthEmptyCheck;
+			if (bit >= PRIV_REGEX_MAX_EMPTY_CHECK_DEPTH) {
+				return sl_false;
+			}
+			m_depthEmptyCheck++;
+			if (m_depthEmptyCheck > nEmptyCheckDepth) {
+				nEmptyCheckDepth = m_depthEmptyCheck;
+			}
+			if (!(emit(_priv_RegEx_Op::BeginIteration, bit))) {
+				return sl_false;
+			}
+			if (!(compileNode(parser, child))) {
+				return sl_false;
+			}
+			m_depthEmptyCheck--;
+			return emit(_priv_RegEx_Op::CheckIteration, bit);
+		}
+		
+		sl_bool compileProgram(_priv_RegEx_Parser& parser, sl_uint32 root) noexcept
+		{
+			if (!(emit(_priv_RegEx_Op::Save, 0))) {
+				return sl_false;
+			}
+			if (!(compileNode(parser, root))) {
+				return sl_false;
+			}
+			if (!(emit(_priv_RegEx_Op::Save, 1))) {
+				return sl_false;
+			}
+			if (!(emit(_priv_RegEx_Op::Match))) {
+				return sl_false;
+			}
+			// literal prefix and anchor
+			_priv_RegEx_Inst* p = insts.getData();
+			sl_uint32 n = getPc();
+			sl_uint32 pc = 1;
+			if (p[pc].op == _priv_RegEx_Op::AssertBegin) {
+				flagAnchorBegin = sl_true;
+			}
+			sl_uint32 start = pc;
+			while (pc < n && p[pc].op == _priv_RegEx_Op::Byte) {
+				pc++;
+			}
+			if (pc > start) {
+				String s = String::allocate(pc - start);
+				if (s.isNull()) {
+					return sl_false;
+				}
+				sl_char8* buf = s.getData();
+				for (sl_uint32 i = start; i < pc; i++) {
+					buf[i - start] = (sl_char8)(p[i].x);
+				}
+				prefix = s;
+			}
+			return sl_true;
+		}
+		
+	public:
+		SLIB_INLINE static sl_bool isWordBoundary(const sl_uint8* s, sl_size len, sl_size pos, int flags) noexcept
+		{
+			if (pos == 0 && (flags & RegExMatchFlags::NotBow)) {
+				return sl_false;
+			}
+			if (pos == len && (flags & RegExMatchFlags::NotEow)) {
+				return sl_false;
+			}
+			sl_bool a = pos > 0 && _priv_RegEx_isWordChar(s[pos - 1]);
+			sl_bool b = pos < len && _priv_RegEx_isWordChar(s[pos]);
+			return a != b;
+		}
+		
+		// returns the position of the next candidate, or -1 if there is no candidate
+		sl_reg findPrefix(const sl_uint8* s, sl_size len, sl_size pos) noexcept
+		{
+			sl_size lenPrefix = prefix.getLength();
+			const sl_uint8* bufPrefix = (const sl_uint8*)(prefix.getData());
+			while (pos + lenPrefix <= len) {
+				const sl_uint8* p = Base::findMemory(s + pos, bufPrefix[0], len - lenPrefix + 1 - pos);
+				if (!p) {
+					return -1;
+				}
+				pos = p - s;
+				if (Base::equalsMemory(p + 1, bufPrefix + 1, lenPrefix - 1)) {
+					return pos;
+				}
+				pos++;
+			}
+			return -1;
+		}
+		
+		/*
+			The threads are identified by the program counter and the mask of the iterations which
+			started at the current position (shifted by `nEmptyCheckDepth`), because the iterations
+			fail on the empty match.
+		*/
+		void addThread(_priv_RegEx_SparseSet& q, sl_reg* qcaps, sl_uint32 nSlots, _priv_RegEx_StackEntry* stack, sl_uint32 pc0, sl_reg* caps, const sl_uint8* s, sl_size len, sl_size pos, int flags) noexcept
+		{
+			_priv_RegEx_Inst* p = insts.getData();
+			sl_uint32 shift = nEmptyCheckDepth;
+			sl_uint32 n = 0;
+			stack[n].pc = pc0;
+			stack[n].mask = 0;
+			stack[n].slot = -1;
+			n++;
+			while (n) {
+				n--;
+				_priv_RegEx_StackEntry& e = stack[n];
+				if (e.slot >= 0) {
+					caps[e.slot] = e.value;
+					continue;
+				}
+				sl_uint32 pc = e.pc;
+				sl_uint32 mask = e.mask;
+				sl_uint32 id = (pc << shift) | mask;
+				if (q.contains(id)) {
+					continue;
+				}
+				q.insert(id);
+				_priv_RegEx_Inst& inst = p[pc];
+				switch (inst.op) {
+					case _priv_RegEx_Op::Jump:
+						stack[n].pc = inst.x;
+						stack[n].mask = mask;
+						stack[n].slot = -1;
+						n++;
+						break;
+					case _priv_RegEx_Op::Split:
+						stack[n].pc = inst.y;
+						stack[n].mask = mask;
+						stack[n].slot = -1;
+						n++;
+						stack[n].pc = inst.x;
+						stack[n].mask = mask;
+						stack[n].slot = -1;
+						n++;
+						break;
+					case _priv_RegEx_Op::Save:
+						if (inst.x < nSlots) {
+							stack[n].slot = (sl_int32)(inst.x);
+							stack[n].value = caps[inst.x];
+							n++;
+							caps[inst.x] = (sl_reg)pos;
+						}
+						stack[n].pc = pc + 1;
+						stack[n].mask = mask;
+						stack[n].slot = -1;
+						n++;
+						break;
+					case _priv_RegEx_Op::ClearSlots:
+						for (sl_uint32 i = inst.x; i < inst.y && i < nSlots; i++) {
+							if (caps[i] >= 0) {
+								stack[n].slot = (sl_int32)i;
+								stack[n].value = caps[i];
+								n++;
+								caps[i] = -1;
+							}
+						}
+						stack[n].pc = pc + 1;
+						stack[n].mask = mask;
+						stack[n].slot = -1;
+						n++;
+						break;
+					case _priv_RegEx_Op::BeginIteration:
+						stack[n].pc = pc + 1;
+						stack[n].mask = mask | (1 << inst.x);
+						stack[n].slot = -1;
+						n++;
+						break;
+					case _priv_RegEx_Op::CheckIteration:
+						if (!(mask & (1 << inst.x))) {
+							stack[n].pc = pc + 1;
+							stack[n].mask = mask;
+							stack[n].slot = -1;
+							n++;
+						}
+						break;
+					case _priv_RegEx_Op::AssertBegin:
+						if (pos == 0 && !(flags & RegExMatchFlags::NotBol)) {
+							stack[n].pc = pc + 1;
+							stack[n].mask = mask;
+							stack[n].slot = -1;
+							n++;
+						}
+						break;
+					case _priv_RegEx_Op::AssertEnd:
+						if (pos == len && !(flags & RegExMatchFlags::NotEol)) {
+							stack[n].pc = pc + 1;
+							stack[n].mask = mask;
+							stack[n].slot = -1;
+							n++;
+						}
+						break;
+					case _priv_RegEx_Op::AssertWordBoundary:
+					case _priv_RegEx_Op::AssertNotWordBoundary:
+						if (isWordBoundary(s, len, pos, flags) == (inst.op == _priv_RegEx_Op::AssertWordBoundary)) {
+							stack[n].pc = pc + 1;
+							stack[n].mask = mask;
+							stack[n].slot = -1;
+							n++;
+						}
+						break;
+					default:
+						Base::copyMemory(qcaps + id * nSlots, caps, nSlots * sizeof(sl_reg));
+						break;
+				}
+			}
+		}
+		
+		// Thompson NFA simulation tracking the captures (Pike VM)
+		sl_bool runNfa(const sl_uint8* s, sl_size len, sl_bool flagSearch, int flags, sl_reg* outCaps, sl_uint32 nSlots) noexcept
+		{
+			sl_uint32 shift = nEmptyCheckDepth;
+			sl_size nThreads = (sl_size)(insts.getCount()) << shift;
+			sl_size sizeSet = nThreads * sizeof(sl_uint32);
+			sl_size sizeCaps = nThreads * nSlots * sizeof(sl_reg);
+			sl_size sizeStack = (3 * nThreads + ((sl_size)nClearedSlots << shift) + 4) * sizeof(_priv_RegEx_StackEntry);
+			sl_size sizeTotal = sizeSet * 4 + sizeCaps * 2 + sizeStack + nSlots * sizeof(sl_reg);
+			sl_uint8* mem = (sl_uint8*)(Base::createZeroMemory(sizeTotal));
+			if (!mem) {
+				return sl_false;
+			}
+			_priv_RegEx_SparseSet q1, q2;
+			sl_uint8* m = mem;
+			q1.dense = (sl_uint32*)m; m += sizeSet;
+			q1.sparse = (sl_uint32*)m; m += sizeSet;
+			q2.dense = (sl_uint32*)m; m += sizeSet;
+			q2.sparse = (sl_uint32*)m; m += sizeSet;
+			sl_reg* caps1 = (sl_reg*)m; m += sizeCaps;
+			sl_reg* caps2 = (sl_reg*)m; m += sizeCaps;
+			_priv_RegEx_StackEntry* stack = (_priv_RegEx_StackEntry*)m; m += sizeStack;
+			sl_reg* caps = (sl_reg*)m;
+			q1.count = 0;
+			q2.count = 0;
+			
+			_priv_RegEx_SparseSet* clist = &q1;
+			_priv_RegEx_SparseSet* nlist = &q2;
+			sl_reg* ccaps = caps1;
+			sl_reg* ncaps = caps2;
+			
+			_priv_RegEx_Inst* p = insts.getData();
+			_priv_RegEx_ByteSet* bytesets = sets.getData();
+			
+			sl_bool flagAnchored = !flagSearch || (flags & RegExMatchFlags::Continuous) || flagAnchorBegin;
+			sl_bool flagMatched = sl_false;
+			sl_size pos = 0;
+			for (;;) {
+				if (!flagMatched && (pos == 0 || !flagAnchored)) {
+					if (!(clist->count) && prefix.isNotEmpty()) {
+						sl_reg posNext = findPrefix(s, len, pos);
+						if (posNext < 0) {
+							break;
+						}
+						if (flagAnchored && (sl_size)posNext != pos) {
+							break;
+						}
+						pos = (sl_size)posNext;
+					}
+					for (sl_uint32 i = 0; i < nSlots; i++) {
+						caps[i] = -1;
+					}
+					addThread(*clist, ccaps, nSlots, stack, 0, caps, s, len, pos, flags);
+				}
+				if (!(clist->count)) {
+					break;
+				}
+				nlist->count = 0;
+				for (sl_uint32 i = 0; i < clist->count; i++) {
+					sl_uint32 id = clist->dense[i];
+					sl_uint32 pc = id >> shift;
+					_priv_RegEx_Inst& inst = p[pc];
+					sl_reg* tcaps = ccaps + id * nSlots;
+					if (inst.op == _priv_RegEx_Op::Match) {
+						if (!flagSearch && pos != len) {
+							continue;
+						}
+						if ((flags & RegExMatchFlags::NotNull) && tcaps[0] == (sl_reg)pos) {
+							continue;
+						}
+						Base::copyMemory(outCaps, tcaps, nSlots * sizeof(sl_reg));
+						flagMatched = sl_true;
+						// cut off the lower priority threads
+						break;
+					}
+					if (pos < len) {
+						sl_uint8 ch = s[pos];
+						if (inst.op == _priv_RegEx_Op::Byte) {
+							if (ch == inst.x) {
+								addThread(*nlist, ncaps, nSlots, stack, pc + 1, tcaps, s, len, pos + 1, flags);
+							}
+						} else if (inst.op == _priv_RegEx_Op::ByteSet) {
+							if (bytesets[inst.x].contains(ch)) {
+								addThread(*nlist, ncaps, nSlots, stack, pc + 1, tcaps, s, len, pos + 1, flags);
+							}
+						}
+					}
+				}
+				_priv_RegEx_SparseSet* t = clist;
+				clist = nlist;
+				nlist = t;
+				sl_reg* tc = ccaps;
+				ccaps = ncaps;
+				ncaps = tc;
+				if (pos >= len) {
+					break;
+				}
+				pos++;
+			}
+			Base::freeMemory(mem);
+			return flagMatched;
+		}
+		
+		// epsilon closure for DFA. `threads` receives sorted program counters (and the begin flag at first)
+		void getClosure(_priv_RegEx_SparseSet& q, sl_uint32* stack, const sl_uint32* pcs, sl_uint32 nPcs, sl_bool flagBegin, sl_bool flagEnd, sl_bool& outMatch) noexcept
+		{
+			_priv_RegEx_Inst* p = insts.getData();
+			q.count = 0;
+			outMatch = sl_false;
+			sl_uint32 n = 0;
+			for (sl_uint32 i = nPcs; i > 0; i--) {
+				stack[n++] = pcs[i - 1];
+			}
+			while (n) {
+				n--;
+				sl_uint32 pc = stack[n];
+				if (q.contains(pc)) {
+					continue;
+				}
+				q.insert(pc);
+				_priv_RegEx_Inst& inst = p[pc];
+				switch (inst.op) {
+					case _priv_RegEx_Op::Jump:
+						stack[n++] = inst.x;
+						break;
+					case _priv_RegEx_Op::Split:
+						stack[n++] = inst.y;
+						stack[n++] = inst.x;
+						break;
+					case _priv_RegEx_Op::Save:
+					case _priv_RegEx_Op::ClearSlots:
+					case _priv_RegEx_Op::BeginIteration:
+					case _priv_RegEx_Op::CheckIteration:
+						// the empty checks don't change the set of the matching strings
+						stack[n++] = pc + 1;
+						break;
+					case _priv_RegEx_Op::AssertBegin:
+						if (flagBegin) {
+							stack[n++] = pc + 1;
+						}
+						break;
+					case _priv_RegEx_Op::AssertEnd:
+						if (flagEnd) {
+							stack[n++] = pc + 1;
+						}
+						break;
+					case _priv_RegEx_Op::Match:
+						outMatch = sl_true;
+						break;
+					default:
+						break;
+				}
+			}
+		}
+		
+		// returns the index of the state, or -1 if the cache is full
+		sl_int32 getDfaState(_priv_RegEx_Dfa& dfa, _priv_RegEx_SparseSet& q, sl_uint32* stack, sl_uint32* pcs, sl_uint32 nPcs, sl_bool flagBegin) noexcept
+		{
+			_priv_RegEx_Inst* p = insts.getData();
+			sl_bool flagMatch;
+			getClosure(q, stack, pcs, nPcs, flagBegin, sl_false, flagMatch);
+			// keep the threads waiting for bytes, matches and end assertions
+			sl_uint32 n = 1;
+			pcs[0] = flagBegin ? 1 : 0;
+			for (sl_uint32 i = 0; i < q.count; i++) {
+				sl_uint32 pc = q.dense[i];
+				_priv_RegEx_Op op = p[pc].op;
+				if (op == _priv_RegEx_Op::Byte || op == _priv_RegEx_Op::ByteSet || op == _priv_RegEx_Op::Match || op == _priv_RegEx_Op::AssertEnd) {
+					pcs[n++] = pc;
+				}
+			}
+			// sort
+			for (sl_uint32 i = 2; i < n; i++) {
+				sl_uint32 v = pcs[i];
+				sl_uint32 k = i;
+				while (k > 1 && pcs[k - 1] > v) {
+					pcs[k] = pcs[k - 1];
+					k--;
+				}
+				pcs[k] = v;
+			}
+			String key((sl_char8*)pcs, n * sizeof(sl_uint32));
+			sl_uint32 index;
+			if (dfa.map.get_NoLock(key, &index)) {
+				return (sl_int32)index;
+			}
+			if (dfa.states.getCount() >= PRIV_REGEX_MAX_DFA_STATES) {
+				dfa.flagFull = sl_true;
+				return -1;
+			}
+			_priv_RegEx_DfaState state;
+			for (sl_uint32 i = 0; i < 256; i++) {
+				state.next[i] = -1;
+			}
+			state.flagMatch = flagMatch;
+			state.flagDead = n == 1;
+			state.flagMatchAtEnd = flagMatch;
+			if (!flagMatch) {
+				// threads waiting for the end assertions
+				List<sl_uint32> pcsEnd;
+				for (sl_uint32 i = 1; i < n; i++) {
+					if (p[pcs[i]].op == _priv_RegEx_Op::AssertEnd) {
+						if (!(pcsEnd.add_NoLock(pcs[i]))) {
+							return -1;
+						}
+					}
+				}
+				if (pcsEnd.isNotNull()) {
+					sl_bool flagMatchAtEnd;
+					getClosure(q, stack, pcsEnd.getData(), (sl_uint32)(pcsEnd.getCount()), flagBegin, sl_true, flagMatchAtEnd);
+					state.flagMatchAtEnd = flagMatchAtEnd;
+				}
+			}
+			List<sl_uint32> threads;
+			if (!(threads.addElements_NoLock(pcs, n))) {
+				return -1;
+			}
+			index = (sl_uint32)(dfa.states.getCount());
+			if (!(dfa.states.add_NoLock(state))) {
+				return -1;
+			}
+			if (!(dfa.stateThreads.add_NoLock(Move(threads)))) {
+				return -1;
+			}
+			dfa.map.put_NoLock(key, index);
+			return (sl_int32)index;
+		}
+		
+		sl_int32 getDfaNextState(_priv_RegEx_Dfa& dfa, sl_bool flagSearch, _priv_RegEx_SparseSet& q, sl_uint32* stack, sl_uint32* pcs, sl_uint32 state, sl_uint8 ch) noexcept
+		{
+			_priv_RegEx_Inst* p = insts.getData();
+			_priv_RegEx_ByteSet* bytesets = sets.getData();
+			List<sl_uint32>& threads = dfa.stateThreads.getData()[state];
+			sl_uint32* t = threads.getData();
+			sl_uint32 nThreads = (sl_uint32)(threads.getCount());
+			sl_uint32 n = 0;
+			for (sl_uint32 i = 1; i < nThreads; i++) {
+				_priv_RegEx_Inst& inst = p[t[i]];
+				if (inst.op == _priv_RegEx_Op::Byte) {
+					if (ch == inst.x) {
+						pcs[n++] = t[i] + 1;
+					}
+				} else if (inst.op == _priv_RegEx_Op::ByteSet) {
+					if (bytesets[inst.x].contains(ch)) {
+						pcs[n++] = t[i] + 1;
+					}
+				}
+			}
+			if (flagSearch) {
+				pcs[n++] = 0;
+			}
+			return getDfaState(dfa, q, stack, pcs, n, sl_false);
+		}
+		
+		// returns 1 on match, 0 on mismatch, -1 if DFA is not available
+		sl_int32 runDfa(const sl_uint8* s, sl_size len, sl_bool flagSearch) noexcept
+		{
+			_priv_RegEx_Dfa& dfa = flagSearch ? dfaSearch : dfaMatch;
+			if (!(dfa.lock.tryLock())) {
+				return -1;
+			}
+			sl_int32 ret = -1;
+			sl_uint32 nInsts = (sl_uint32)(insts.getCount());
+			sl_size sizeSet = nInsts * sizeof(sl_uint32);
+			sl_uint8* mem = sl_null;
+			_priv_RegEx_SparseSet q;
+			sl_uint32* stack = sl_null;
+			sl_uint32* pcs = sl_null;
+			do {
+				if (dfa.flagFull) {
+					break;
+				}
+				mem = (sl_uint8*)(Base::createZeroMemory(sizeSet * 6 + 32));
+				if (!mem) {
+					break;
+				}
+				q.dense = (sl_uint32*)mem;
+				q.sparse = (sl_uint32*)(mem + sizeSet);
+				q.count = 0;
+				stack = (sl_uint32*)(mem + sizeSet * 2);
+				pcs = (sl_uint32*)(mem + sizeSet * 5 + 16);
+				if (dfa.stateStart < 0) {
+					pcs[0] = 0;
+					dfa.stateStart = getDfaState(dfa, q, stack, pcs, 1, sl_true);
+					if (dfa.stateStart < 0) {
+						break;
+					}
+					if (flagSearch) {
+						pcs[0] = 0;
+						dfa.stateIdle = getDfaState(dfa, q, stack, pcs, 1, sl_false);
+						if (dfa.stateIdle < 0) {
+							break;
+						}
+					}
+				}
+				sl_int32 state = dfa.stateStart;
+				sl_size pos = 0;
+				sl_bool flagPrefix = flagSearch && prefix.isNotEmpty();
+				for (; pos < len; pos++) {
+					_priv_RegEx_DfaState& st = dfa.states.getData()[state];
+					if (flagSearch) {
+						if (st.flagMatch) {
+							ret = 1;
+							break;
+						}
+						if (flagPrefix && state == dfa.stateIdle) {
+							sl_reg posNext = findPrefix(s, len, pos);
+							if (posNext < 0) {
+								ret = 0;
+								break;
+							}
+							pos = (sl_size)posNext;
+						}
+					} else {
+						if (st.flagDead) {
+							ret = 0;
+							break;
+						}
+					}
+					sl_uint8 ch = s[pos];
+					sl_int32 next = st.next[ch];
+					if (next < 0) {
+						next = getDfaNextState(dfa, flagSearch, q, stack, pcs, (sl_uint32)state, ch);
+						if (next < 0) {
+							break;
+						}
+						dfa.states.getData()[state].next[ch] = next;
+					}
+					state = next;
+				}
+				if (pos >= len) {
+					ret = dfa.states.getData()[state].flagMatchAtEnd ? 1 : 0;
+				}
+			} while (0);
+			if (mem) {
+				Base::freeMemory(mem);
+			}
+			dfa.lock.unlock();
+			return ret;
+		}
+		
+		sl_bool execute(const sl_char8* data, sl_size len, sl_bool flagSearch, int flags, sl_reg* outCaps, sl_uint32 nSlots) noexcept
+		{
+			const sl_uint8* s = (const sl_uint8*)data;
+			if (!flagSearch) {
+				sl_size lenPrefix = prefix.getLength();
+				if (lenPrefix) {
+					if (len < lenPrefix || !(Base::equalsMemory(s, prefix.getData(), lenPrefix))) {
+						return sl_false;
+					}
+				}
+			}
+			if (!outCaps && flagUseDfa && !flags) {
+				sl_int32 ret = runDfa(s, len, flagSearch);
+				if (ret >= 0) {
+					return ret > 0;
+				}
+			}
+			if (outCaps) {
+				return runNfa(s, len, flagSearch, flags, outCaps, nSlots);
+			} else {
+				sl_reg caps[2];
+				return runNfa(s, len, flagSearch, flags, caps, 2);
+			}
+		}
+		
+	};
+	
+	
+	RegExMatchResult::RegExMatchResult() noexcept
+	{
+		m_subject = sl_null;
+	}
+	
+	RegExMatchResult::~RegExMatchResult() noexcept
+	{
+	}
+	
+	sl_uint32 RegExMatchResult::getGroupCount() const noexcept
+	{
+		return (sl_uint32)(m_positions.getCount() >> 1);
+	}
+	
+	sl_bool RegExMatchResult::isMatched(sl_uint32 index) const noexcept
+	{
+		return getStart(index) >= 0;
+	}
+	
+	sl_reg RegExMatchResult::getStart(sl_uint32 index) const noexcept
+	{
+		sl_size i = (sl_size)index << 1;
+		if (i < m_positions.getCount()) {
+			return m_positions.getData()[i];
+		}
+		return -1;
+	}
+	
+	sl_reg RegExMatchResult::getEnd(sl_uint32 index) const noexcept
+	{
+		sl_size i = ((sl_size)index << 1) | 1;
+		if (i < m_positions.getCount()) {
+			return m_positions.getData()[i];
+		}
+		return -1;
+	}
+	
+	StringView RegExMatchResult::getGroup(sl_uint32 index) const noexcept
+	{
+		sl_reg start = getStart(index);
+		sl_reg end = getEnd(index);
+		if (start >= 0 && end >= start) {
+			return StringView(m_subject + start, end - start);
+		}
+		return sl_null;
+	}
+	
+	String RegExMatchResult::getGroupString(sl_uint32 index) const noexcept
+	{
+		return String(getGroup(index));
+	}
+	
+	
+	class _priv_RegEx_Cache
+	{
+	public:
+		CHashMap< String, Ref<CRegEx> > map;
+	};
+	
+	SLIB_SAFE_STATIC_GETTER(_priv_RegEx_Cache, _priv_RegEx_getCache)
+	
 	SLIB_DEFINE_OBJECT(CRegEx, Object)
 	
 	CRegEx::CRegEx() noexcept
 	{
+		m_program = sl_null;
+		m_obj = sl_null;
 	}
 	
 	CRegEx::~CRegEx() noexcept
 	{
-		delete ((std::regex*)m_obj);
+		if (m_program) {
+			delete m_program;
+		}
+		if (m_obj) {
+			delete ((std::regex*)m_obj);
+		}
 	}
 	
-	Ref<CRegEx> CRegEx::_create(const String& pattern, int _flags) noexcept
+	static std::regex* _priv_RegEx_createStd(const String& pattern, int _flags) noexcept
 	{
-		std::regex* obj = (std::regex*)(Base::createMemory(sizeof(std::regex)));
+		std::regex* obj = new std::regex;
 		if (obj) {
 			int flags = 0;
 			if (_flags & RegExFlags::Icase) {
@@ -76,24 +1792,65 @@ namespace slib
 			}
 			try {
 				if (flags) {
-					new (obj) std::regex((char*)(pattern.getData()), (std::size_t)(pattern.getLength()), (std::regex_constants::syntax_option_type)flags);
+					obj->assign((char*)(pattern.getData()), (std::size_t)(pattern.getLength()), (std::regex_constants::syntax_option_type)flags);
 				} else {
-					new (obj) std::regex((char*)(pattern.getData()), (std::size_t)(pattern.getLength()));
+					obj->assign((char*)(pattern.getData()), (std::size_t)(pattern.getLength()));
 				}
+				return obj;
 			} catch (std::regex_error&) {
-				Base::freeMemory(obj);
-				return sl_null;
-			}
-			Ref<CRegEx> ret = new CRegEx;
-			if (ret.isNotNull()) {
-				ret->m_obj = obj;
-				return ret;
 			}
 			delete obj;
 		}
 		return sl_null;
 	}
 	
+	Ref<CRegEx> CRegEx::_create(const String& pattern, int flags) noexcept
+	{
+		_priv_RegEx_Cache* cache = _priv_RegEx_getCache();
+		String key;
+		if (cache) {
+			key = String::fromInt32(flags) + ":" + pattern;
+			Ref<CRegEx> ret;
+			if (cache->map.get(key, &ret)) {
+				return ret;
+			}
+		}
+		_priv_RegEx_Program* program = sl_null;
+		std::regex* obj = sl_null;
+		if (!(flags & (RegExFlags::Basic | RegExFlags::Extended | RegExFlags::Awk | RegExFlags::Grep | RegExFlags::Egrep))) {
+			sl_bool flagUnsupported = sl_false;
+			program = _priv_RegEx_Program::create(pattern, flags, flagUnsupported);
+			if (!program && !flagUnsupported) {
+				return sl_null;
+			}
+		}
+		if (!program) {
+			obj = _priv_RegEx_createStd(pattern, flags);
+			if (!obj) {
+				return sl_null;
+			}
+		}
+		Ref<CRegEx> ret = new CRegEx;
+		if (ret.isNull()) {
+			if (program) {
+				delete program;
+			}
+			if (obj) {
+				delete obj;
+			}
+			return sl_null;
+		}
+		ret->m_program = program;
+		ret->m_obj = obj;
+		if (cache) {
+			if (cache->map.getCount() >= PRIV_REGEX_MAX_CACHE) {
+				cache->map.removeAll();
+			}
+			cache->map.put(key, ret);
+		}
+		return ret;
+	}
+	
 	Ref<CRegEx> CRegEx::create(const String& pattern) noexcept
 	{
 		return _create(pattern, 0);
@@ -104,7 +1861,7 @@ namespace slib
 		return _create(pattern, flags);
 	}
 	
-	sl_bool CRegEx::match(const String& str, const RegExMatchFlags& _flags) noexcept
+	static std::regex_constants::match_flag_type _priv_RegEx_getStdMatchFlags(const RegExMatchFlags& _flags) noexcept
 	{
 		int flags = 0;
 		int v = _flags.value;
@@ -143,12 +1900,106 @@ namespace slib
 				flags |= std::regex_constants::format_first_only;
 			}
 		}
+		return (std::regex_constants::match_flag_type)flags;
+	}
+	
+	sl_bool CRegEx::_matchStd(const StringView& str, RegExMatchResult* outResult, sl_bool flagSearch, const RegExMatchFlags& flags) noexcept
+	{
 		std::regex* obj = (std::regex*)m_obj;
 		const char* start = (char*)(str.getData());
 		const char* end = start + str.getLength();
-		return std::regex_match(start, end, *obj, (std::regex_constants::match_flag_type)flags);
+		std::regex_constants::match_flag_type f = _priv_RegEx_getStdMatchFlags(flags);
+		if (!outResult) {
+			if (flagSearch) {
+				return std::regex_search(start, end, *obj, f);
+			} else {
+				return std::regex_match(start, end, *obj, f);
+			}
+		}
+		std::cmatch m;
+		sl_bool bRet;
+		if (flagSearch) {
+			bRet = std::regex_search(start, end, m, *obj, f);
+		} else {
+			bRet = std::regex_match(start, end, m, *obj, f);
+		}
+		if (!bRet) {
+			return sl_false;
+		}
+		List<sl_reg> positions;
+		for (std::size_t i = 0; i < m.size(); i++) {
+			if (m[i].matched) {
+				positions.add_NoLock((sl_reg)(m[i].first - start));
+				positions.add_NoLock((sl_reg)(m[i].second - start));
+			} else {
+				positions.add_NoLock(-1);
+				positions.add_NoLock(-1);
+			}
+		}
+		outResult->m_subject = str.getData();
+		outResult->m_positions = Move(positions);
+		return sl_true;
+	}
+	
+	sl_bool CRegEx::match(const StringView& str, const RegExMatchFlags& flags) noexcept
+	{
+		return match(str, sl_null, flags);
 	}
 	
+	sl_bool CRegEx::match(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags) noexcept
+	{
+		if (!m_program) {
+			return _matchStd(str, outResult, sl_false, flags);
+		}
+		if (!outResult) {
+			return m_program->execute(str.getData(), str.getLength(), sl_false, flags.value, sl_null, 0);
+		}
+		List<sl_reg> positions;
+		sl_uint32 nSlots = (m_program->nGroups + 1) << 1;
+		if (!(positions.setCount_NoLock(nSlots))) {
+			return sl_false;
+		}
+		if (m_program->execute(str.getData(), str.getLength(), sl_false, flags.value, positions.getData(), nSlots)) {
+			outResult->m_subject = str.getData();
+			outResult->m_positions = Move(positions);
+			return sl_true;
+		}
+		return sl_false;
+	}
+	
+	sl_bool CRegEx::search(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags) noexcept
+	{
+		if (!m_program) {
+			return _matchStd(str, outResult, sl_true, flags);
+		}
+		if (!outResult) {
+			return m_program->execute(str.getData(), str.getLength(), sl_true, flags.value, sl_null, 0);
+		}
+		List<sl_reg> positions;
+		sl_uint32 nSlots = (m_program->nGroups + 1) << 1;
+		if (!(positions.setCount_NoLock(nSlots))) {
+			return sl_false;
+		}
+		if (m_program->execute(str.getData(), str.getLength(), sl_true, flags.value, positions.getData(), nSlots)) {
+			outResult->m_subject = str.getData();
+			outResult->m_positions = Move(positions);
+			return sl_true;
+		}
+		return sl_false;
+	}
+	
+	sl_uint32 CRegEx::getGroupCount() noexcept
+	{
+		if (m_program) {
+			return m_program->nGroups;
+		}
+		if (m_obj) {
+			return (sl_uint32)(((std::regex*)m_obj)->mark_count());
+		}
+		return 0;
+	}
+	
+	
 	RegEx::RegEx(const String& pattern) noexcept
 	 : ref(CRegEx::create(pattern))
 	{
@@ -159,7 +2010,7 @@ namespace slib
 	{
 	}
 	
-	sl_bool RegEx::match(const String& str, const RegExMatchFlags& flags) noexcept
+	sl_bool RegEx::match(const StringView& str, const RegExMatchFlags& flags) noexcept
 	{
 		if (ref.isNotNull()) {
 			return ref->match(str, flags);
@@ -167,6 +2018,22 @@ namespace slib
 		return sl_false;
 	}
 	
+	sl_bool RegEx::match(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags) noexcept
+	{
+		if (ref.isNotNull()) {
+			return ref->match(str, outResult, flags);
+		}
+		return sl_false;
+	}
+	
+	sl_bool RegEx::search(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags) noexcept
+	{
+		if (ref.isNotNull()) {
+			return ref->search(str, outResult, flags);
+		}
+		return sl_false;
+	}
+	
 	Atomic<RegEx>::Atomic(const String& pattern) noexcept
 	 : ref(CRegEx::create(pattern, 0))
 	{
@@ -177,7 +2044,7 @@ namespace slib
 	{
 	}
 	
-	sl_bool Atomic<RegEx>::match(const String& str, const RegExMatchFlags& flags) noexcept
+	sl_bool Atomic<RegEx>::match(const StringView& str, const RegExMatchFlags& flags) noexcept
 	{
 		Ref<CRegEx> ref(this->ref);
 		if (ref.isNotNull()) {
@@ -185,9 +2052,27 @@ namespace slib
 		}
 		return sl_false;
 	}
+	
+	sl_bool Atomic<RegEx>::match(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags) noexcept
+	{
+		Ref<CRegEx> ref(this->ref);
+		if (ref.isNotNull()) {
+			return ref->match(str, outResult, flags);
+		}
+		return sl_false;
+	}
+	
+	sl_bool Atomic<RegEx>::search(const StringView& str, RegExMatchResult* outResult, const RegExMatchFlags& flags) noexcept
+	{
+		Ref<CRegEx> ref(this->ref);
+		if (ref.isNotNull()) {
+			return ref->search(str, outResult, flags);
+		}
+		return sl_false;
+	}
 
 	
-	sl_bool RegEx::matchEmail(const String& str) noexcept
+	sl_bool RegEx::matchEmail(const StringView& str) noexcept
 	{
 		SLIB_SAFE_STATIC(RegEx, regex, "^[a-zA-Z0-9.!#$%&’*+/=?^_`{|}~-]+@[a-zA-Z0-9-]+(?:\\.[a-zA-Z0-9-]+)*$");
 		if (SLIB_SAFE_STATIC_CHECK_FREED(regex)) {
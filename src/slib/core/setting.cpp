@@ -61,7 +61,12 @@ namespace slib
 		sl_reg indexStart = 0;
 		ObjectLocker lock(&m_mapValues);
 		for (sl_size i = 0; i <= len; i++) {
-			sl_char16 ch = buf[i];
+			sl_char8 ch;
+			if (i < len) {
+				ch = buf[i];
+			} else {
+				ch = 0;
+			}
 			if (ch == '=') {
 				if (indexAssign < 0 && indexComment < 0) {
 					indexAssign = i;
@@ -72,14 +77,14 @@ namespace slib
 				}
 			} else if (ch == '\r' || ch == '\n' || ch == 0) {
 				if (indexAssign > 0) {
-					String key = String(buf + indexStart, indexAssign - indexStart).trim();
-					String value;
+					StringView key = StringView(buf + indexStart, indexAssign - indexStart).trim();
+					StringView value;
 					if (indexComment < 0) {
-						value = String(buf + indexAssign + 1, i - indexAssign - 1).trim();
+						value = StringView(buf + indexAssign + 1, i - indexAssign - 1).trim();
 					} else {
-						value = String(buf + indexAssign + 1, indexComment - indexAssign - 1).trim();
+						value = StringView(buf + indexAssign + 1, indexComment - indexAssign - 1).trim();
 					}
-					m_mapValues.put_NoLock(key, value);
+					m_mapValues.put_NoLock(String(key), String(value));
 				}
 				indexAssign = -1;
 				indexComment = -1;
@@ -100,7 +105,7 @@ namespace slib
 	}
 
 
-	sl_bool SettingUtil::parseUint32Range(const String& str, sl_uint32* _from, sl_uint32* _to)
+	sl_bool SettingUtil::parseUint32Range(const StringView& str, sl_uint32* _from, sl_uint32* _to)
 	{
 		sl_uint32 from;
 		sl_uint32 to;
@@ -24,6 +24,7 @@
 
 #include "slib/core/string.h"
 #include "slib/core/string_buffer.h"
+#include "slib/core/string_format.h"
 
 #include "slib/core/base.h"
 #include "slib/core/mio.h"
@@ -33,6 +34,9 @@
 #include "slib/core/json.h"
 #include "slib/core/cast.h"
 #include "slib/core/math.h"
+#include "slib/core/charset.h"
+
+#include "string_float.h"
 
 namespace slib
 {
@@ -1259,6 +1263,16 @@ namespace slib
 		m_container = _priv_String16_create(strUtf8, length);
 	}
 
+	String::String(const StringView& str) noexcept
+	{
+		m_container = _priv_String_create(str.getData(), str.getLength());
+	}
+
+	String16::String16(const StringView16& str) noexcept
+	{
+		m_container = _priv_String16_create(str.getData(), str.getLength());
+	}
+
 	
 	String::String(const wchar_t* strUnicode) noexcept
 	{
@@ -6539,6 +6553,16 @@ namespace slib
 	}
 
 
+	SLIB_INLINE static void _priv_String_parseFloat_getValue(const _priv_DecimalToFloat& decimal, float* _out) noexcept
+	{
+		*_out = decimal.toFloat();
+	}
+
+	SLIB_INLINE static void _priv_String_parseFloat_getValue(const _priv_DecimalToFloat& decimal, double* _out) noexcept
+	{
+		*_out = decimal.toDouble();
+	}
+
 	template <class FT, class CT>
 	SLIB_INLINE static sl_reg _priv_String_parseFloat(const CT* sz, sl_size i, sl_size n, FT* _out) noexcept
 	{
@@ -6560,22 +6584,12 @@ namespace slib
 			}
 		}
 		
-		FT v = 0;
-		sl_uint32 vi = 0;
-		sl_bool flagMulInt = sl_true;
-
+		_priv_DecimalToFloat decimal;
+		
 		for (; i < n; i++) {
 			sl_uint32 c = (sl_uint32)sz[i];
 			if (SLIB_CHAR_IS_DIGIT(c)) {
-				if (flagMulInt) {
-					vi = vi * 10 + (c - '0');
-					if (vi >= 214748364) {
-						v = (FT)vi;
-						flagMulInt = sl_false;
-					}
-				} else {
-					v = v * 10 + (c - '0');
-				}
+				decimal.addIntegralDigit(c - '0');
 				bEmpty = sl_false;
 			} else {
 				break;
@@ -6584,20 +6598,15 @@ namespace slib
 		if (bEmpty) {
 			return SLIB_PARSE_ERROR; // integral number is required
 		}
-		if (flagMulInt) {
-			v = (FT)vi;
-		}
 		
 		if (i < n) {
 			if (sz[i] == '.') {
 				i++;
 				bEmpty = sl_true;
-				FT weight = (FT)(0.1);
 				for (; i < n; i++) {
 					sl_uint32 c = (sl_uint32)sz[i];
 					if (SLIB_CHAR_IS_DIGIT(c)) {
-						v = v + (c - '0') * weight;
-						weight /= 10;
+						decimal.addFractionDigit(c - '0');
 						bEmpty = sl_false;
 					} else {
 						break;
@@ -6612,7 +6621,7 @@ namespace slib
 					i++;
 					bEmpty = sl_true;
 					sl_bool bMinuxExp = sl_false;
-					FT exp = 0;
+					sl_int32 exp = 0;
 					if (i < n && (sz[i] == '+' || sz[i] == '-')) {
 						if (sz[i] == '-') {
 							bMinuxExp = sl_true;
@@ -6622,7 +6631,9 @@ namespace slib
 					for (; i < n; i++) {
 						sl_uint32 c = (sl_uint32)sz[i];
 						if (SLIB_CHAR_IS_DIGIT(c)) {
-							exp = exp * 10 + (c - '0');
+							if (exp < 100000) {
+								exp = exp * 10 + (c - '0');
+							}
 							bEmpty = sl_false;
 						} else {
 							break; // invalid character
@@ -6634,15 +6645,15 @@ namespace slib
 					if (bMinuxExp) {
 						exp = -exp;
 					}
-					v *= Math::pow((FT)(10.0), exp);
+					decimal.addExponent(exp);
 				}
 			}
 		}
-		if (bMinus) {
-			v = -v;
-		}
 		if (_out) {
-			*_out = v;
+			_priv_String_parseFloat_getValue(decimal, _out);
+			if (bMinus) {
+				*_out = -(*_out);
+			}
 		}
 		return i;
 	}
@@ -7014,17 +7025,12 @@ namespace slib
 
 
 
-	template <class IT, class UT, class ST, class CT>
-	SLIB_INLINE static ST _priv_String_fromInt(IT _value, sl_uint32 radix, sl_uint32 minWidth, sl_bool flagUpperCase, CT chGroup = sl_false, sl_bool flagSignPositive = sl_false, sl_bool flagLeadingSpacePositive = sl_false, sl_bool flagEncloseNagtive = sl_false) noexcept
+	// writes the digits at the end of `buf` (MAX_NUMBER_STR_LEN characters), and returns the start position
+	template <class IT, class UT, class CT>
+	SLIB_INLINE static sl_uint32 _priv_String_writeInt(CT* buf, IT _value, sl_uint32 radix, sl_uint32 minWidth, sl_bool flagUpperCase, CT chGroup, sl_bool flagSignPositive, sl_bool flagLeadingSpacePositive, sl_bool flagEncloseNagtive) noexcept
 	{
-		if (radix < 2 || radix > 64) {
-			return sl_null;
-		}
-		
 		const char* pattern = flagUpperCase && radix <= 36 ? _string_conv_radix_pattern_upper : _string_conv_radix_pattern_lower;
 		
-		CT buf[MAX_NUMBER_STR_LEN];
-		
 		sl_uint32 pos = MAX_NUMBER_STR_LEN;
 		
 		if (minWidth < 1) {
@@ -7096,19 +7102,25 @@ namespace slib
 				}
 			}
 		}
-		return ST(buf + pos, MAX_NUMBER_STR_LEN - pos);
+		return pos;
 	}
 
-	template <class IT, class ST, class CT>
-	SLIB_INLINE static ST _priv_String_fromUint(IT value, sl_uint32 radix, sl_uint32 minWidth, sl_bool flagUpperCase, CT chGroup = 0, sl_bool flagSignPositive = sl_false, sl_bool flagLeadingSpacePositive = sl_false) noexcept
+	template <class IT, class UT, class ST, class CT>
+	SLIB_INLINE static ST _priv_String_fromInt(IT value, sl_uint32 radix, sl_uint32 minWidth, sl_bool flagUpperCase, CT chGroup = sl_false, sl_bool flagSignPositive = sl_false, sl_bool flagLeadingSpacePositive = sl_false, sl_bool flagEncloseNagtive = sl_false) noexcept
 	{
 		if (radix < 2 || radix > 64) {
 			return sl_null;
 		}
-		
-		const char* pattern = flagUpperCase && radix <= 36 ? _string_conv_radix_pattern_upper : _string_conv_radix_pattern_lower;
-		
 		CT buf[MAX_NUMBER_STR_LEN];
+		sl_uint32 pos = _priv_String_writeInt<IT, UT, CT>(buf, value, radix, minWidth, flagUpperCase, chGroup, flagSignPositive, flagLeadingSpacePositive, flagEncloseNagtive);
+		return ST(buf + pos, MAX_NUMBER_STR_LEN - pos);
+	}
+
+	// writes the digits at the end of `buf` (MAX_NUMBER_STR_LEN characters), and returns the start position
+	template <class IT, class CT>
+	SLIB_INLINE static sl_uint32 _priv_String_writeUint(CT* buf, IT value, sl_uint32 radix, sl_uint32 minWidth, sl_bool flagUpperCase, CT chGroup, sl_bool flagSignPositive, sl_bool flagLeadingSpacePositive) noexcept
+	{
+		const char* pattern = flagUpperCase && radix <= 36 ? _string_conv_radix_pattern_upper : _string_conv_radix_pattern_lower;
 		
 		sl_uint32 pos = MAX_NUMBER_STR_LEN;
 		
@@ -7156,6 +7168,17 @@ namespace slib
 			}
 		}
 		
+		return pos;
+	}
+
+	template <class IT, class ST, class CT>
+	SLIB_INLINE static ST _priv_String_fromUint(IT value, sl_uint32 radix, sl_uint32 minWidth, sl_bool flagUpperCase, CT chGroup = 0, sl_bool flagSignPositive = sl_false, sl_bool flagLeadingSpacePositive = sl_false) noexcept
+	{
+		if (radix < 2 || radix > 64) {
+			return sl_null;
+		}
+		CT buf[MAX_NUMBER_STR_LEN];
+		sl_uint32 pos = _priv_String_writeUint<IT, CT>(buf, value, radix, minWidth, flagUpperCase, chGroup, flagSignPositive, flagLeadingSpacePositive);
 		return ST(buf + pos, MAX_NUMBER_STR_LEN - pos);
 	}
 
@@ -7235,6 +7258,131 @@ namespace slib
 #endif
 	}
 
+	// shortest representation which is parsed back to the same value
+	template <class FT, class CT>
+	static sl_size _priv_String_writeFloat_shortest(CT* buf, FT value, sl_int32 minWidthIntegral, CT chConv, sl_bool flagSignPositive, sl_bool flagLeadingSpacePositive, sl_bool flagEncloseNagtive) noexcept
+	{
+		CT* str = buf;
+		
+		sl_bool flagMinus;
+		if (value < 0) {
+			flagMinus = sl_true;
+			value = -value;
+			if (flagEncloseNagtive) {
+				*(str++) = '(';
+			}
+			*(str++) = '-';
+		} else {
+			flagMinus = sl_false;
+			if (flagLeadingSpacePositive) {
+				*(str++) = ' ';
+			}
+			if (flagSignPositive) {
+				*(str++) = '+';
+			}
+		}
+		
+		sl_uint64 m;
+		sl_int32 exponent;
+		_priv_FloatToDecimal::convert(value, m, exponent);
+		
+		// digits are written from the end of the buffer
+		CT bufDigits[24];
+		CT* digits = bufDigits + sizeof(bufDigits) / sizeof(CT);
+		sl_int32 nDigits = 0;
+		{
+			while (m >= 10 && !(m % 10)) {
+				m /= 10;
+				exponent++;
+			}
+			do {
+				*(--digits) = (CT)('0' + (sl_uint32)(m % 10));
+				nDigits++;
+				m /= 10;
+			} while (m);
+		}
+		
+		// exponent of the leading digit
+		sl_int32 e = exponent + nDigits - 1;
+		if (e >= 15 || e < -15) {
+			*(str++) = digits[0];
+			*(str++) = '.';
+			if (nDigits > 1) {
+				for (sl_int32 k = 1; k < nDigits; k++) {
+					*(str++) = digits[k];
+				}
+			} else {
+				*(str++) = '0';
+			}
+			*(str++) = chConv == 'G' ? 'E' : 'e';
+			if (e > 0) {
+				*(str++) = '+';
+			} else {
+				*(str++) = '-';
+				e = -e;
+			}
+			CT t[8];
+			sl_int32 n = 0;
+			do {
+				t[n++] = (CT)('0' + (e % 10));
+				e /= 10;
+			} while (e);
+			while (n > 0) {
+				*(str++) = t[--n];
+			}
+		} else {
+			sl_int32 nIntegral = e + 1;
+			if (nIntegral < 1) {
+				nIntegral = 1;
+			}
+			for (sl_int32 k = nIntegral; k < minWidthIntegral; k++) {
+				*(str++) = '0';
+			}
+			if (e < 0) {
+				*(str++) = '0';
+				*(str++) = '.';
+				for (sl_int32 k = -1; k > e; k--) {
+					*(str++) = '0';
+				}
+				for (sl_int32 i = 0; i < nDigits; i++) {
+					*(str++) = digits[i];
+				}
+			} else {
+				for (sl_int32 i = 0; i <= e; i++) {
+					if (i < nDigits) {
+						*(str++) = digits[i];
+					} else {
+						*(str++) = '0';
+					}
+				}
+				*(str++) = '.';
+				if (nDigits > e + 1) {
+					for (sl_int32 i = e + 1; i < nDigits; i++) {
+						*(str++) = digits[i];
+					}
+				} else {
+					*(str++) = '0';
+				}
+			}
+		}
+		
+		if (flagMinus) {
+			if (flagEncloseNagtive) {
+				*(str++) = ')';
+			}
+		}
+		
+		return str - buf;
+	}
+
+	template <class FT, class ST, class CT>
+	static ST _priv_String_fromFloat_shortest(FT value, sl_int32 minWidthIntegral, CT chConv, sl_bool flagSignPositive, sl_bool flagLeadingSpacePositive, sl_bool flagEncloseNagtive) noexcept
+	{
+		CT buf[MAX_NUMBER_STR_LEN];
+		sl_size len = _priv_String_writeFloat_shortest(buf, value, minWidthIntegral, chConv, flagSignPositive, flagLeadingSpacePositive, flagEncloseNagtive);
+		return ST(buf, len);
+	}
+
 	template <class FT, class ST, class CT>
 	SLIB_INLINE static ST _priv_String_fromFloat(FT value, sl_int32 precision, sl_bool flagZeroPadding, sl_int32 minWidthIntegral, CT chConv = 'g', CT chGroup = 0, sl_bool flagSignPositive = sl_false, sl_bool flagLeadingSpacePositive = sl_false, sl_bool flagEncloseNagtive = sl_false) noexcept
 	{
@@ -7289,6 +7437,10 @@ namespace slib
 			return ST(buf, pos);
 		}
 		
+		if (precision < 0 && (chConv == 'g' || chConv == 'G') && !chGroup) {
+			return _priv_String_fromFloat_shortest<FT, ST, CT>(value, minWidthIntegral, chConv, flagSignPositive, flagLeadingSpacePositive, flagEncloseNagtive);
+		}
+		
 		CT* str = buf;
 		CT* str_last = buf + MAX_NUMBER_STR_LEN - MAX_PRECISION;
 		
@@ -7435,6 +7587,23 @@ namespace slib
 		return _priv_String_fromFloat<double, String, sl_char8>(value, precision, flagZeroPadding, minWidthIntegral);
 	}
 
+	sl_size String::fromDouble(double value, sl_char8* output) noexcept
+	{
+		if (Math::isNaN(value)) {
+			Base::copyMemory(output, "NaN", 3);
+			return 3;
+		}
+		if (Math::isInfinite(value)) {
+			Base::copyMemory(output, "Infinity", 8);
+			return 8;
+		}
+		if (value == 0) {
+			Base::copyMemory(output, "0.0", 3);
+			return 3;
+		}
+		return _priv_String_writeFloat_shortest<double, sl_char8>(output, value, 1, 'g', sl_false, sl_false, sl_false);
+	}
+
 	String String::fromFloat(float value, sl_int32 precision, sl_bool flagZeroPadding, sl_uint32 minWidthIntegral) noexcept
 	{
 		return _priv_String_fromFloat<float, String, sl_char8>(value, precision, flagZeroPadding, minWidthIntegral);
@@ -7572,13 +7741,14 @@ https://docs.oracle.com/javase/7/docs/api/java/util/Formatter.html
 					do {
 						ch = format[pos];
 						if (ch == '%') {
-							CT t = '%';
+							// `addStatic` keeps the pointer, so the characters must outlive the buffer
+							static const CT t = '%';
 							sb.addStatic(&t, 1);
 							pos++;
 							posText = pos;
 							break;
 						} else if (ch == 'n') {
-							CT t[2] = {'\r', '\n'};
+							static const CT t[2] = {'\r', '\n'};
 							sb.addStatic(t, 2);
 							pos++;
 							posText = pos;
@@ -8080,6 +8250,244 @@ https://docs.oracle.com/javase/7/docs/api/java/util/Formatter.html
 	}
 
 
+	StringFormatWriter::StringFormatWriter() noexcept
+	{
+		m_data = m_buf;
+		m_length = 0;
+		m_capacity = sizeof(m_buf);
+	}
+
+	StringFormatWriter::~StringFormatWriter() noexcept
+	{
+		if (m_data != m_buf) {
+			Base::freeMemory(m_data);
+		}
+	}
+
+	sl_bool StringFormatWriter::_reserve(sl_size size) noexcept
+	{
+		if (size <= m_capacity) {
+			return sl_true;
+		}
+		sl_size capacity = m_capacity << 1;
+		if (capacity < size) {
+			capacity = size;
+		}
+		sl_char8* data;
+		if (m_data == m_buf) {
+			data = (sl_char8*)(Base::createMemory(capacity));
+			if (!data) {
+				return sl_false;
+			}
+			Base::copyMemory(data, m_buf, m_length);
+		} else {
+			data = (sl_char8*)(Base::reallocMemory(m_data, capacity));
+			if (!data) {
+				return sl_false;
+			}
+		}
+		m_data = data;
+		m_capacity = capacity;
+		return sl_true;
+	}
+
+	void StringFormatWriter::_writeSlow(const sl_char8* str, sl_size len) noexcept
+	{
+		if (_reserve(m_length + len)) {
+			Base::copyMemory(m_data + m_length, str, len);
+			m_length += len;
+		}
+	}
+
+	void StringFormatWriter::writeRepeat(sl_char8 ch, sl_size count) noexcept
+	{
+		if (_reserve(m_length + count)) {
+			Base::resetMemory(m_data + m_length, (sl_uint8)ch, count);
+			m_length += count;
+		}
+	}
+
+	void StringFormatWriter::writeAligned(const sl_char8* str, sl_size len, const StringFormatSpec& spec) noexcept
+	{
+		if (len < spec.minWidth) {
+			if (spec.hasFlag(StringFormatFlags::AlignLeft)) {
+				write(str, len);
+				writeRepeat(' ', spec.minWidth - len);
+			} else {
+				writeRepeat(' ', spec.minWidth - len);
+				write(str, len);
+			}
+		} else {
+			write(str, len);
+		}
+	}
+
+	void StringFormatWriter::writeString(const StringView& str, const StringFormatSpec& spec) noexcept
+	{
+		writeAligned(str.getData(), str.getLength(), spec);
+	}
+
+
+	static void _priv_StringFormat_writeChar(StringFormatWriter& writer, sl_char32 ch, const StringFormatSpec& spec) noexcept
+	{
+		sl_char8 buf[8];
+		sl_size len = Charsets::utf32ToUtf8(&ch, 1, buf, sizeof(buf));
+		writer.writeAligned(buf, len, spec);
+	}
+
+	static sl_uint32 _priv_StringFormat_getRadix(const StringFormatSpec& spec) noexcept
+	{
+		switch (spec.conversion) {
+			case 'x':
+			case 'X':
+				return 16;
+			case 'o':
+				return 8;
+		}
+		return 10;
+	}
+
+	template <class IT, class UT>
+	static void _priv_StringFormat_writeInt(StringFormatWriter& writer, IT value, const StringFormatSpec& spec) noexcept
+	{
+		if (spec.conversion == 'c') {
+			_priv_StringFormat_writeChar(writer, (sl_char32)value, spec);
+			return;
+		}
+		sl_char8 buf[MAX_NUMBER_STR_LEN];
+		sl_uint32 pos = _priv_String_writeInt<IT, UT, sl_char8>(buf, value, _priv_StringFormat_getRadix(spec), spec.hasFlag(StringFormatFlags::ZeroPadded) ? spec.minWidth : 0, spec.conversion == 'X', spec.hasFlag(StringFormatFlags::GroupingDigits) ? ',' : 0, spec.hasFlag(StringFormatFlags::SignPositive), spec.hasFlag(StringFormatFlags::LeadingSpacePositive), spec.hasFlag(StringFormatFlags::EncloseNegative));
+		writer.writeAligned(buf + pos, MAX_NUMBER_STR_LEN - pos, spec);
+	}
+
+	template <class IT>
+	static void _priv_StringFormat_writeUint(StringFormatWriter& writer, IT value, const StringFormatSpec& spec) noexcept
+	{
+		if (spec.conversion == 'c') {
+			_priv_StringFormat_writeChar(writer, (sl_char32)value, spec);
+			return;
+		}
+		sl_char8 buf[MAX_NUMBER_STR_LEN];
+		sl_uint32 pos = _priv_String_writeUint<IT, sl_char8>(buf, value, _priv_StringFormat_getRadix(spec), spec.hasFlag(StringFormatFlags::ZeroPadded) ? spec.minWidth : 0, spec.conversion == 'X', spec.hasFlag(StringFormatFlags::GroupingDigits) ? ',' : 0, spec.hasFlag(StringFormatFlags::SignPositive), spec.hasFlag(StringFormatFlags::LeadingSpacePositive));
+		writer.writeAligned(buf + pos, MAX_NUMBER_STR_LEN - pos, spec);
+	}
+
+	template <class FT>
+	static void _priv_StringFormat_writeFloat(StringFormatWriter& writer, FT value, const StringFormatSpec& spec) noexcept
+	{
+		String str = _priv_String_fromFloat<FT, String, sl_char8>(value, spec.flagUsePrecision ? (sl_int32)(spec.precision) : -1, spec.hasFlag(StringFormatFlags::ZeroPadded), 1, spec.conversion, spec.hasFlag(StringFormatFlags::GroupingDigits) ? ',' : 0, spec.hasFlag(StringFormatFlags::SignPositive), spec.hasFlag(StringFormatFlags::LeadingSpacePositive), spec.hasFlag(StringFormatFlags::EncloseNegative));
+		writer.writeAligned(str.getData(), str.getLength(), spec);
+	}
+
+	static void _priv_StringFormat_writeTimeField(StringFormatWriter& writer, sl_int32 value, sl_uint32 minDigits, const StringFormatSpec& spec) noexcept
+	{
+		sl_uint32 minWidth = 0;
+		if (spec.hasFlag(StringFormatFlags::ZeroPadded)) {
+			minWidth = spec.minWidth;
+			if (minWidth < minDigits) {
+				minWidth = minDigits;
+			}
+		}
+		sl_char8 buf[MAX_NUMBER_STR_LEN];
+		sl_uint32 pos = _priv_String_writeInt<sl_int32, sl_uint32, sl_char8>(buf, value, 10, minWidth, sl_false, 0, sl_false, sl_false, sl_false);
+		StringFormatSpec specField(spec);
+		if (specField.minWidth < minWidth) {
+			specField.minWidth = minWidth;
+		}
+		writer.writeAligned(buf + pos, MAX_NUMBER_STR_LEN - pos, specField);
+	}
+
+	void StringFormatWriter::writeInt32(sl_int32 value, const StringFormatSpec& spec) noexcept
+	{
+		_priv_StringFormat_writeInt<sl_int32, sl_uint32>(*this, value, spec);
+	}
+
+	void StringFormatWriter::writeUint32(sl_uint32 value, const StringFormatSpec& spec) noexcept
+	{
+		_priv_StringFormat_writeUint<sl_uint32>(*this, value, spec);
+	}
+
+	void StringFormatWriter::writeInt64(sl_int64 value, const StringFormatSpec& spec) noexcept
+	{
+		_priv_StringFormat_writeInt<sl_int64, sl_uint64>(*this, value, spec);
+	}
+
+	void StringFormatWriter::writeUint64(sl_uint64 value, const StringFormatSpec& spec) noexcept
+	{
+		_priv_StringFormat_writeUint<sl_uint64>(*this, value, spec);
+	}
+
+	void StringFormatWriter::writeFloat(float value, const StringFormatSpec& spec) noexcept
+	{
+		_priv_StringFormat_writeFloat<float>(*this, value, spec);
+	}
+
+	void StringFormatWriter::writeDouble(double value, const StringFormatSpec& spec) noexcept
+	{
+		_priv_StringFormat_writeFloat<double>(*this, value, spec);
+	}
+
+	void StringFormatWriter::writeBoolean(sl_bool value, const StringFormatSpec& spec) noexcept
+	{
+		if (spec.conversion == 'd') {
+			writeInt32(value ? 1 : 0, spec);
+		} else {
+			if (value) {
+				writeAligned("true", 4, spec);
+			} else {
+				writeAligned("false", 5, spec);
+			}
+		}
+	}
+
+	void StringFormatWriter::writeTime(const Time& time, const StringFormatSpec& spec) noexcept
+	{
+		const TimeZone& zone = spec.flagUtc ? TimeZone::UTC() : TimeZone::Local;
+		switch (spec.conversion) {
+			case 'y':
+				_priv_StringFormat_writeTimeField(*this, time.getYear(zone), 4, spec);
+				break;
+			case 'm':
+				_priv_StringFormat_writeTimeField(*this, time.getMonth(zone), 2, spec);
+				break;
+			case 'd':
+				_priv_StringFormat_writeTimeField(*this, time.getDay(zone), 2, spec);
+				break;
+			case 'H':
+				_priv_StringFormat_writeTimeField(*this, time.getHour(zone), 2, spec);
+				break;
+			case 'M':
+				_priv_StringFormat_writeTimeField(*this, time.getMinute(zone), 2, spec);
+				break;
+			case 'S':
+				_priv_StringFormat_writeTimeField(*this, time.getSecond(zone), 2, spec);
+				break;
+			case 'l':
+				_priv_StringFormat_writeTimeField(*this, time.getMillisecond(), 0, spec);
+				break;
+			case 'w':
+				writeString(time.getWeekday(sl_true, zone), spec);
+				break;
+			case 'W':
+				writeString(time.getWeekday(sl_false, zone), spec);
+				break;
+			case 'D':
+				writeString(time.getDateString(zone), spec);
+				break;
+			case 'T':
+				writeString(time.getTimeString(zone), spec);
+				break;
+			default:
+				writeString(time.toString(zone), spec);
+				break;
+		}
+	}
+
+	String StringFormatWriter::toString() const noexcept
+	{
+		return String(m_data, m_length);
+	}
+
+
 	int Compare<String>::operator()(const String& a, const String& b) const noexcept
 	{
 		return a.compare(b);
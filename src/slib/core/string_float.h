@@ -0,0 +1,100 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CORE_STRING_FLOAT
+#define CHECKHEADER_SLIB_CORE_STRING_FLOAT
+
+#include "slib/core/definition.h"
+
+#define SLIB_FLOAT_DECIMAL_MAX_DIGITS 768
+
+namespace slib
+{
+	
+	class _priv_FloatToDecimal
+	{
+	public:
+		// finds the shortest `digits` * 10^`exponent` which is rounded back to `value` (positive, finite)
+		static void convert(double value, sl_uint64& digits, sl_int32& exponent) noexcept;
+		
+		static void convert(float value, sl_uint64& digits, sl_int32& exponent) noexcept;
+		
+	};
+	
+	class _priv_DecimalToFloat
+	{
+	public:
+		sl_uint64 mantissa; // first 19 significant digits
+		sl_uint32 nDigits; // count of significant digits
+		sl_int32 exponent; // value = (all significant digits) * 10^exponent
+		sl_bool flagTruncatedNonZero; // non-zero digits are dropped after SLIB_FLOAT_DECIMAL_MAX_DIGITS
+		sl_uint8 digits[SLIB_FLOAT_DECIMAL_MAX_DIGITS]; // digits after the first 19 significant digits are stored from index 19
+		
+	public:
+		SLIB_INLINE _priv_DecimalToFloat() noexcept: mantissa(0), nDigits(0), exponent(0), flagTruncatedNonZero(sl_false) {}
+		
+	public:
+		SLIB_INLINE void addIntegralDigit(sl_uint32 digit) noexcept
+		{
+			_addDigit(digit);
+		}
+		
+		SLIB_INLINE void addFractionDigit(sl_uint32 digit) noexcept
+		{
+			exponent--;
+			_addDigit(digit);
+		}
+		
+		SLIB_INLINE void addExponent(sl_int32 e) noexcept
+		{
+			exponent += e;
+		}
+		
+		double toDouble() const noexcept;
+		
+		float toFloat() const noexcept;
+		
+	private:
+		SLIB_INLINE void _addDigit(sl_uint32 digit) noexcept
+		{
+			if (nDigits < 19) {
+				if (nDigits || digit) {
+					mantissa = mantissa * 10 + digit;
+					nDigits++;
+				}
+			} else if (nDigits < SLIB_FLOAT_DECIMAL_MAX_DIGITS) {
+				digits[nDigits] = (sl_uint8)digit;
+				nDigits++;
+			} else {
+				if (digit) {
+					flagTruncatedNonZero = sl_true;
+				}
+				exponent++;
+			}
+		}
+		
+	};
+	
+}
+
+#endif
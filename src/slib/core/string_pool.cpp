@@ -0,0 +1,185 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/core/string_pool.h"
+
+#include "slib/core/safe_static.h"
+
+namespace slib
+{
+
+	StringPool::StringPool() noexcept
+	{
+	}
+
+	StringPool::~StringPool() noexcept
+	{
+	}
+
+	StringPool* StringPool::getDefault() noexcept
+	{
+		SLIB_SAFE_STATIC(StringPool, pool)
+		if (SLIB_SAFE_STATIC_CHECK_FREED(pool)) {
+			return sl_null;
+		}
+		return &pool;
+	}
+
+	String StringPool::add(const StringView& str) noexcept
+	{
+		if (str.isNull()) {
+			return sl_null;
+		}
+		sl_size len = str.getLength();
+		if (!len) {
+			return String::getEmpty();
+		}
+		sl_size hash = str.getHashCode();
+		sl_size index = hash % SLIB_STRING_POOL_SHARD_COUNT;
+		CHashMap<String, sl_bool>& map = m_maps[index];
+		SpinLocker lock(m_locks + index);
+		HashMapNode<String, sl_bool>* node = map.find_NoLock(str);
+		if (node) {
+			return node->key;
+		}
+		String s(str.getData(), len);
+		if (s.isNull()) {
+			return sl_null;
+		}
+		s.setHashCode(hash);
+		if (map.add_NoLock(s, sl_true)) {
+			return s;
+		}
+		return sl_null;
+	}
+
+	String StringPool::add(const String& str) noexcept
+	{
+		if (str.isNull()) {
+			return sl_null;
+		}
+		sl_size len = str.getLength();
+		if (!len) {
+			return String::getEmpty();
+		}
+		sl_size hash = str.getHashCode();
+		sl_size index = hash % SLIB_STRING_POOL_SHARD_COUNT;
+		CHashMap<String, sl_bool>& map = m_maps[index];
+		SpinLocker lock(m_locks + index);
+		HashMapNode<String, sl_bool>* node = map.find_NoLock(str);
+		if (node) {
+			return node->key;
+		}
+		if (map.add_NoLock(str, sl_true)) {
+			return str;
+		}
+		return sl_null;
+	}
+
+	String StringPool::get(const StringView& str) const noexcept
+	{
+		if (str.isNull()) {
+			return sl_null;
+		}
+		if (str.isEmpty()) {
+			return String::getEmpty();
+		}
+		sl_size index = str.getHashCode() % SLIB_STRING_POOL_SHARD_COUNT;
+		SpinLocker lock(m_locks + index);
+		HashMapNode<String, sl_bool>* node = m_maps[index].find_NoLock(str);
+		if (node) {
+			return node->key;
+		}
+		return sl_null;
+	}
+
+	sl_bool StringPool::contains(const StringView& str) const noexcept
+	{
+		return get(str).isNotNull();
+	}
+
+	sl_size StringPool::getCount() const noexcept
+	{
+		sl_size n = 0;
+		for (sl_size i = 0; i < SLIB_STRING_POOL_SHARD_COUNT; i++) {
+			SpinLocker lock(m_locks + i);
+			n += m_maps[i].getCount();
+		}
+		return n;
+	}
+
+	void StringPool::clear() noexcept
+	{
+		for (sl_size i = 0; i < SLIB_STRING_POOL_SHARD_COUNT; i++) {
+			SpinLocker lock(m_locks + i);
+			m_maps[i].removeAll_NoLock();
+		}
+	}
+
+
+	AtomString::AtomString(const StringView& str) noexcept
+	{
+		StringPool* pool = StringPool::getDefault();
+		if (pool) {
+			m_str = pool->add(str);
+		} else {
+			m_str = String(str);
+		}
+	}
+
+	AtomString::AtomString(const String& str) noexcept
+	{
+		StringPool* pool = StringPool::getDefault();
+		if (pool) {
+			m_str = pool->add(str);
+		} else {
+			m_str = str;
+		}
+	}
+
+	AtomString::AtomString(const sl_char8* str) noexcept: AtomString(StringView(str))
+	{
+	}
+
+	AtomString AtomString::lookup(const StringView& str) noexcept
+	{
+		AtomString ret;
+		StringPool* pool = StringPool::getDefault();
+		if (pool) {
+			ret.m_str = pool->get(str);
+		}
+		return ret;
+	}
+
+	sl_size AtomString::getHashCode() const noexcept
+	{
+		return m_str.getHashCode();
+	}
+
+
+	int Compare<AtomString>::operator()(const AtomString& a, const AtomString& b) const noexcept
+	{
+		return a.toString().compare(b.toString());
+	}
+
+}
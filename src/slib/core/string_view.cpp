@@ -0,0 +1,810 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#define SLIB_SUPPORT_STD_TYPES
+
+#include "slib/core/string.h"
+
+#include "slib/core/base.h"
+
+namespace slib
+{
+
+	class _priv_StringView_Func8
+	{
+	public:
+		SLIB_INLINE static sl_size getLength(const sl_char8* sz) noexcept
+		{
+			return Base::getStringLength(sz);
+		}
+		
+		SLIB_INLINE static const sl_char8* findMemory(const sl_char8* mem, sl_char8 pattern, sl_size count) noexcept
+		{
+			return (const sl_char8*)(Base::findMemory(mem, pattern, count));
+		}
+		
+		SLIB_INLINE static const sl_char8* findMemoryReverse(const sl_char8* mem, sl_char8 pattern, sl_size count) noexcept
+		{
+			return (const sl_char8*)(Base::findMemoryReverse(mem, pattern, count));
+		}
+		
+		SLIB_INLINE static sl_int32 compareMemory(const sl_char8* mem1, const sl_char8* mem2, sl_size count) noexcept
+		{
+			return Base::compareMemory((sl_uint8*)mem1, (sl_uint8*)mem2, count);
+		}
+	};
+	
+	class _priv_StringView_Func16
+	{
+	public:
+		SLIB_INLINE static sl_size getLength(const sl_char16* sz) noexcept
+		{
+			return Base::getStringLength2(sz);
+		}
+		
+		SLIB_INLINE static const sl_char16* findMemory(const sl_char16* mem, sl_char16 pattern, sl_size count) noexcept
+		{
+			return (const sl_char16*)(Base::findMemory2((sl_uint16*)mem, pattern, count));
+		}
+		
+		SLIB_INLINE static const sl_char16* findMemoryReverse(const sl_char16* mem, sl_char16 pattern, sl_size count) noexcept
+		{
+			return (const sl_char16*)(Base::findMemoryReverse2((sl_uint16*)mem, pattern, count));
+		}
+		
+		SLIB_INLINE static sl_int32 compareMemory(const sl_char16* mem1, const sl_char16* mem2, sl_size count) noexcept
+		{
+			return Base::compareMemory2((sl_uint16*)mem1, (sl_uint16*)mem2, count);
+		}
+	};
+	
+	template <class CT, class TT>
+	class _priv_StringView
+	{
+	public:
+		static sl_size getHashCode(const CT* sz, sl_size len) noexcept
+		{
+			if (len == 0) {
+				return 0;
+			}
+			sl_size hash = 0;
+			for (sl_size i = 0; i < len; i++) {
+				sl_uint32 ch = sz[i];
+				hash = hash * 31 + ch;
+			}
+			return Rehash(hash);
+		}
+		
+		static sl_size getHashCodeIgnoreCase(const CT* sz, sl_size len) noexcept
+		{
+			if (len == 0) {
+				return 0;
+			}
+			sl_size hash = 0;
+			for (sl_size i = 0; i < len; i++) {
+				sl_uint32 ch = sz[i];
+				ch = SLIB_CHAR_LOWER_TO_UPPER(ch);
+				hash = hash * 31 + ch;
+			}
+			return Rehash(hash);
+		}
+		
+		static sl_bool equals(const CT* s1, sl_size len1, const CT* s2, sl_size len2) noexcept
+		{
+			if (len1 != len2) {
+				return sl_false;
+			}
+			if (s1 == s2 || len1 == 0) {
+				return sl_true;
+			}
+			return TT::compareMemory(s1, s2, len1) == 0;
+		}
+		
+		static sl_int32 compare(const CT* s1, sl_size len1, const CT* s2, sl_size len2) noexcept
+		{
+			sl_size len = SLIB_MIN(len1, len2);
+			if (len > 0 && s1 != s2) {
+				sl_int32 r = TT::compareMemory(s1, s2, len);
+				if (r) {
+					return r;
+				}
+			}
+			if (len1 < len2) {
+				return -1;
+			}
+			if (len1 > len2) {
+				return 1;
+			}
+			return 0;
+		}
+		
+		static sl_int32 compareIgnoreCase(const CT* s1, sl_size len1, const CT* s2, sl_size len2) noexcept
+		{
+			sl_size len = SLIB_MIN(len1, len2);
+			for (sl_size i = 0; i < len; i++) {
+				sl_uint32 c1 = s1[i];
+				sl_uint32 c2 = s2[i];
+				c1 = SLIB_CHAR_LOWER_TO_UPPER(c1);
+				c2 = SLIB_CHAR_LOWER_TO_UPPER(c2);
+				if (c1 < c2) {
+					return -1;
+				}
+				if (c1 > c2) {
+					return 1;
+				}
+			}
+			if (len1 < len2) {
+				return -1;
+			}
+			if (len1 > len2) {
+				return 1;
+			}
+			return 0;
+		}
+		
+		static sl_reg indexOf(const CT* sz, sl_size count, CT ch, sl_reg _start) noexcept
+		{
+			if (count == 0) {
+				return -1;
+			}
+			sl_size start;
+			if (_start < 0) {
+				start = 0;
+			} else {
+				start = _start;
+				if (start >= count) {
+					return -1;
+				}
+			}
+			const CT* pt = TT::findMemory(sz + start, ch, count - start);
+			if (pt) {
+				return (sl_reg)(pt - sz);
+			}
+			return -1;
+		}
+		
+		static sl_reg indexOf(const CT* buf, sl_size count, const CT* bufPat, sl_size countPat, sl_reg _start) noexcept
+		{
+			if (countPat == 0) {
+				return 0;
+			}
+			if (countPat == 1) {
+				return indexOf(buf, count, bufPat[0], _start);
+			}
+			if (count < countPat) {
+				return -1;
+			}
+			sl_size start;
+			if (_start < 0) {
+				start = 0;
+			} else {
+				start = _start;
+				if (start > count - countPat) {
+					return -1;
+				}
+			}
+			while (start <= count - countPat) {
+				const CT* pt = TT::findMemory(buf + start, bufPat[0], count - start - countPat + 1);
+				if (pt == sl_null) {
+					return -1;
+				}
+				if (TT::compareMemory(pt + 1, bufPat + 1, countPat - 1) == 0) {
+					return (sl_reg)(pt - buf);
+				} else {
+					start = (sl_size)(pt - buf + 1);
+				}
+			}
+			return -1;
+		}
+		
+		static sl_reg lastIndexOf(const CT* sz, sl_size count, CT ch, sl_reg _start) noexcept
+		{
+			if (count == 0) {
+				return -1;
+			}
+			sl_size start;
+			if (_start < 0) {
+				start = count - 1;
+			} else {
+				start = _start;
+				if (start >= count) {
+					start = count - 1;
+				}
+			}
+			const CT* pt = TT::findMemoryReverse(sz, ch, start + 1);
+			if (pt) {
+				return (sl_reg)(pt - sz);
+			}
+			return -1;
+		}
+		
+		static sl_reg lastIndexOf(const CT* buf, sl_size count, const CT* bufPat, sl_size countPat, sl_reg _start) noexcept
+		{
+			if (countPat == 0) {
+				return 0;
+			}
+			if (countPat == 1) {
+				return lastIndexOf(buf, count, bufPat[0], _start);
+			}
+			if (count < countPat) {
+				return -1;
+			}
+			sl_size s;
+			sl_size n = count - countPat + 1;
+			if (_start < 0) {
+				s = n;
+			} else {
+				s = _start;
+				if (s > n) {
+					s = n;
+				}
+			}
+			while (s > 0) {
+				const CT* pt = TT::findMemoryReverse(buf, bufPat[0], s);
+				if (pt == sl_null) {
+					return -1;
+				}
+				if (TT::compareMemory(pt + 1, bufPat + 1, countPat - 1) == 0) {
+					return (sl_reg)(pt - buf);
+				} else {
+					s = (sl_size)(pt - buf);
+				}
+			}
+			return -1;
+		}
+		
+		template <class VIEW>
+		static VIEW substring(const CT* sz, sl_size _count, sl_reg start, sl_reg end) noexcept
+		{
+			sl_reg count = (sl_reg)_count;
+			if (start < 0) {
+				start = 0;
+			}
+			if (end < 0 || end > count) {
+				end = count;
+			}
+			if (start >= end) {
+				return VIEW(sz + count, 0);
+			}
+			return VIEW(sz + start, end - start);
+		}
+		
+		template <class VIEW>
+		static VIEW trimLeft(const CT* sz, sl_size n) noexcept
+		{
+			sl_size i = 0;
+			for (; i < n; i++) {
+				CT c = sz[i];
+				if (!(SLIB_CHAR_IS_WHITE_SPACE(c))) {
+					break;
+				}
+			}
+			return VIEW(sz + i, n - i);
+		}
+		
+		template <class VIEW>
+		static VIEW trimRight(const CT* sz, sl_size n) noexcept
+		{
+			while (n > 0) {
+				CT c = sz[n - 1];
+				if (!(SLIB_CHAR_IS_WHITE_SPACE(c))) {
+					break;
+				}
+				n--;
+			}
+			return VIEW(sz, n);
+		}
+		
+		template <class VIEW>
+		static VIEW trim(const CT* sz, sl_size n) noexcept
+		{
+			VIEW v = trimLeft<VIEW>(sz, n);
+			return trimRight<VIEW>(v.getData(), v.getLength());
+		}
+		
+		template <class VIEW>
+		static List<VIEW> split(const VIEW& view, const CT* pattern, sl_size countPattern) noexcept
+		{
+			if (countPattern == 0) {
+				return sl_null;
+			}
+			const CT* sz = view.getData();
+			sl_size count = view.getLength();
+			CList<VIEW>* ret = CList<VIEW>::create();
+			if (ret) {
+				sl_size start = 0;
+				while (1) {
+					sl_reg index = indexOf(sz, count, pattern, countPattern, start);
+					if (index < 0) {
+						ret->add_NoLock(VIEW(sz + start, count - start));
+						break;
+					}
+					ret->add_NoLock(VIEW(sz + start, index - start));
+					start = index + countPattern;
+				}
+			}
+			return ret;
+		}
+		
+	};
+	
+	typedef _priv_StringView<sl_char8, _priv_StringView_Func8> _priv_StringView8;
+	typedef _priv_StringView<sl_char16, _priv_StringView_Func16> _priv_StringView16;
+	
+	
+	StringView::StringView(const sl_char8* sz) noexcept
+	{
+		m_data = sz;
+		if (sz) {
+			m_length = Base::getStringLength(sz);
+		} else {
+			m_length = 0;
+		}
+	}
+	
+	StringView::StringView(const String& str) noexcept
+	{
+		if (str.isNotNull()) {
+			m_data = str.getData();
+			m_length = str.getLength();
+		} else {
+			m_data = sl_null;
+			m_length = 0;
+		}
+	}
+	
+	StringView::StringView(const std::string& str) noexcept
+	{
+		m_data = str.c_str();
+		m_length = str.length();
+	}
+	
+	sl_char8 StringView::getAt(sl_reg index) const noexcept
+	{
+		if (index >= 0 && index < (sl_reg)m_length) {
+			return m_data[index];
+		}
+		return 0;
+	}
+	
+	String StringView::toString() const noexcept
+	{
+		return String(*this);
+	}
+	
+	sl_size StringView::getHashCode() const noexcept
+	{
+		return _priv_StringView8::getHashCode(m_data, m_length);
+	}
+	
+	sl_size StringView::getHashCodeIgnoreCase() const noexcept
+	{
+		return _priv_StringView8::getHashCodeIgnoreCase(m_data, m_length);
+	}
+	
+	sl_bool StringView::equals(const StringView& other) const noexcept
+	{
+		return _priv_StringView8::equals(m_data, m_length, other.m_data, other.m_length);
+	}
+	
+	sl_int32 StringView::compare(const StringView& other) const noexcept
+	{
+		return _priv_StringView8::compare(m_data, m_length, other.m_data, other.m_length);
+	}
+	
+	sl_bool StringView::equalsIgnoreCase(const StringView& other) const noexcept
+	{
+		if (m_length != other.m_length) {
+			return sl_false;
+		}
+		return _priv_StringView8::compareIgnoreCase(m_data, m_length, other.m_data, other.m_length) == 0;
+	}
+	
+	sl_int32 StringView::compareIgnoreCase(const StringView& other) const noexcept
+	{
+		return _priv_StringView8::compareIgnoreCase(m_data, m_length, other.m_data, other.m_length);
+	}
+	
+	StringView StringView::substring(sl_reg start, sl_reg end) const noexcept
+	{
+		return _priv_StringView8::substring<StringView>(m_data, m_length, start, end);
+	}
+	
+	StringView StringView::left(sl_reg len) const noexcept
+	{
+		return _priv_StringView8::substring<StringView>(m_data, m_length, 0, len < 0 ? 0 : len);
+	}
+	
+	StringView StringView::right(sl_reg len) const noexcept
+	{
+		if (len < 0) {
+			len = 0;
+		}
+		return _priv_StringView8::substring<StringView>(m_data, m_length, (sl_reg)m_length - len, -1);
+	}
+	
+	StringView StringView::mid(sl_reg start, sl_reg len) const noexcept
+	{
+		if (len < 0) {
+			len = 0;
+		}
+		return _priv_StringView8::substring<StringView>(m_data, m_length, start, start + len);
+	}
+	
+	sl_reg StringView::indexOf(sl_char8 ch, sl_reg start) const noexcept
+	{
+		return _priv_StringView8::indexOf(m_data, m_length, ch, start);
+	}
+	
+	sl_reg StringView::indexOf(const StringView& str, sl_reg start) const noexcept
+	{
+		return _priv_StringView8::indexOf(m_data, m_length, str.m_data, str.m_length, start);
+	}
+	
+	sl_reg StringView::lastIndexOf(sl_char8 ch, sl_reg start) const noexcept
+	{
+		return _priv_StringView8::lastIndexOf(m_data, m_length, ch, start);
+	}
+	
+	sl_reg StringView::lastIndexOf(const StringView& str, sl_reg start) const noexcept
+	{
+		return _priv_StringView8::lastIndexOf(m_data, m_length, str.m_data, str.m_length, start);
+	}
+	
+	sl_bool StringView::startsWith(sl_char8 ch) const noexcept
+	{
+		return m_length > 0 && m_data[0] == ch;
+	}
+	
+	sl_bool StringView::startsWith(const StringView& str) const noexcept
+	{
+		if (str.m_length > m_length) {
+			return sl_false;
+		}
+		return _priv_StringView8::equals(m_data, str.m_length, str.m_data, str.m_length);
+	}
+	
+	sl_bool StringView::endsWith(sl_char8 ch) const noexcept
+	{
+		return m_length > 0 && m_data[m_length - 1] == ch;
+	}
+	
+	sl_bool StringView::endsWith(const StringView& str) const noexcept
+	{
+		if (str.m_length > m_length) {
+			return sl_false;
+		}
+		return _priv_StringView8::equals(m_data + (m_length - str.m_length), str.m_length, str.m_data, str.m_length);
+	}
+	
+	sl_bool StringView::contains(sl_char8 ch) const noexcept
+	{
+		return indexOf(ch) >= 0;
+	}
+	
+	sl_bool StringView::contains(const StringView& str) const noexcept
+	{
+		return indexOf(str) >= 0;
+	}
+	
+	StringView StringView::trim() const noexcept
+	{
+		return _priv_StringView8::trim<StringView>(m_data, m_length);
+	}
+	
+	StringView StringView::trimLeft() const noexcept
+	{
+		return _priv_StringView8::trimLeft<StringView>(m_data, m_length);
+	}
+	
+	StringView StringView::trimRight() const noexcept
+	{
+		return _priv_StringView8::trimRight<StringView>(m_data, m_length);
+	}
+	
+	List<StringView> StringView::split(const StringView& pattern) const noexcept
+	{
+		return _priv_StringView8::split<StringView>(*this, pattern.m_data, pattern.m_length);
+	}
+
+#define PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_INT(CLASS, STRING, NAME, TYPE) \
+	sl_bool CLASS::NAME(sl_int32 radix, TYPE* _out) const noexcept \
+	{ \
+		if (m_length == 0) { \
+			return sl_false; \
+		} \
+		return STRING::NAME(radix, _out, m_data, 0, m_length) == (sl_reg)m_length; \
+	} \
+	TYPE CLASS::NAME(sl_int32 radix, TYPE def) const noexcept \
+	{ \
+		TYPE _out = def; \
+		NAME(radix, &_out); \
+		return _out; \
+	}
+
+#define PRIV_SLIB_DEFINE_STRING_VIEW_PARSE(CLASS, STRING, NAME, TYPE) \
+	sl_bool CLASS::NAME(TYPE* _out) const noexcept \
+	{ \
+		if (m_length == 0) { \
+			return sl_false; \
+		} \
+		return STRING::NAME(_out, m_data, 0, m_length) == (sl_reg)m_length; \
+	} \
+	TYPE CLASS::NAME(TYPE def) const noexcept \
+	{ \
+		TYPE _out = def; \
+		NAME(&_out); \
+		return _out; \
+	}
+
+#ifdef SLIB_ARCH_IS_64BIT
+#	define PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_REG(CLASS) \
+	sl_bool CLASS::parseInt(sl_int32 radix, sl_reg* _out) const noexcept { return parseInt64(radix, _out); } \
+	sl_bool CLASS::parseSize(sl_int32 radix, sl_size* _out) const noexcept { return parseUint64(radix, _out); }
+#else
+#	define PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_REG(CLASS) \
+	sl_bool CLASS::parseInt(sl_int32 radix, sl_reg* _out) const noexcept { return parseInt32(radix, _out); } \
+	sl_bool CLASS::parseSize(sl_int32 radix, sl_size* _out) const noexcept { return parseUint32(radix, _out); }
+#endif
+
+#define PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_ALL(CLASS, STRING) \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_INT(CLASS, STRING, parseInt32, sl_int32) \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_INT(CLASS, STRING, parseUint32, sl_uint32) \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_INT(CLASS, STRING, parseInt64, sl_int64) \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_INT(CLASS, STRING, parseUint64, sl_uint64) \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_REG(CLASS) \
+	sl_reg CLASS::parseInt(sl_int32 radix, sl_reg def) const noexcept \
+	{ \
+		sl_reg _out = def; \
+		parseInt(radix, &_out); \
+		return _out; \
+	} \
+	sl_size CLASS::parseSize(sl_int32 radix, sl_size def) const noexcept \
+	{ \
+		sl_size _out = def; \
+		parseSize(radix, &_out); \
+		return _out; \
+	} \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE(CLASS, STRING, parseFloat, float) \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE(CLASS, STRING, parseDouble, double) \
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE(CLASS, STRING, parseBoolean, sl_bool) \
+	sl_bool CLASS::parseHexString(void* _out) const noexcept \
+	{ \
+		if (m_length == 0) { \
+			return sl_false; \
+		} \
+		return STRING::parseHexString(_out, m_data, 0, m_length) == (sl_reg)m_length; \
+	}
+
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_ALL(StringView, String)
+	
+	
+	StringView16::StringView16(const sl_char16* sz) noexcept
+	{
+		m_data = sz;
+		if (sz) {
+			m_length = Base::getStringLength2(sz);
+		} else {
+			m_length = 0;
+		}
+	}
+	
+	StringView16::StringView16(const String16& str) noexcept
+	{
+		if (str.isNotNull()) {
+			m_data = str.getData();
+			m_length = str.getLength();
+		} else {
+			m_data = sl_null;
+			m_length = 0;
+		}
+	}
+	
+	StringView16::StringView16(const std::u16string& str) noexcept
+	{
+		m_data = (const sl_char16*)(str.c_str());
+		m_length = str.length();
+	}
+	
+	sl_char16 StringView16::getAt(sl_reg index) const noexcept
+	{
+		if (index >= 0 && index < (sl_reg)m_length) {
+			return m_data[index];
+		}
+		return 0;
+	}
+	
+	String16 StringView16::toString() const noexcept
+	{
+		return String16(*this);
+	}
+	
+	sl_size StringView16::getHashCode() const noexcept
+	{
+		return _priv_StringView16::getHashCode(m_data, m_length);
+	}
+	
+	sl_size StringView16::getHashCodeIgnoreCase() const noexcept
+	{
+		return _priv_StringView16::getHashCodeIgnoreCase(m_data, m_length);
+	}
+	
+	sl_bool StringView16::equals(const StringView16& other) const noexcept
+	{
+		return _priv_StringView16::equals(m_data, m_length, other.m_data, other.m_length);
+	}
+	
+	sl_int32 StringView16::compare(const StringView16& other) const noexcept
+	{
+		return _priv_StringView16::compare(m_data, m_length, other.m_data, other.m_length);
+	}
+	
+	sl_bool StringView16::equalsIgnoreCase(const StringView16& other) const noexcept
+	{
+		if (m_length != other.m_length) {
+			return sl_false;
+		}
+		return _priv_StringView16::compareIgnoreCase(m_data, m_length, other.m_data, other.m_length) == 0;
+	}
+	
+	sl_int32 StringView16::compareIgnoreCase(const StringView16& other) const noexcept
+	{
+		return _priv_StringView16::compareIgnoreCase(m_data, m_length, other.m_data, other.m_length);
+	}
+	
+	StringView16 StringView16::substring(sl_reg start, sl_reg end) const noexcept
+	{
+		return _priv_StringView16::substring<StringView16>(m_data, m_length, start, end);
+	}
+	
+	StringView16 StringView16::left(sl_reg len) const noexcept
+	{
+		return _priv_StringView16::substring<StringView16>(m_data, m_length, 0, len < 0 ? 0 : len);
+	}
+	
+	StringView16 StringView16::right(sl_reg len) const noexcept
+	{
+		if (len < 0) {
+			len = 0;
+		}
+		return _priv_StringView16::substring<StringView16>(m_data, m_length, (sl_reg)m_length - len, -1);
+	}
+	
+	StringView16 StringView16::mid(sl_reg start, sl_reg len) const noexcept
+	{
+		if (len < 0) {
+			len = 0;
+		}
+		return _priv_StringView16::substring<StringView16>(m_data, m_length, start, start + len);
+	}
+	
+	sl_reg StringView16::indexOf(sl_char16 ch, sl_reg start) const noexcept
+	{
+		return _priv_StringView16::indexOf(m_data, m_length, ch, start);
+	}
+	
+	sl_reg StringView16::indexOf(const StringView16& str, sl_reg start) const noexcept
+	{
+		return _priv_StringView16::indexOf(m_data, m_length, str.m_data, str.m_length, start);
+	}
+	
+	sl_reg StringView16::lastIndexOf(sl_char16 ch, sl_reg start) const noexcept
+	{
+		return _priv_StringView16::lastIndexOf(m_data, m_length, ch, start);
+	}
+	
+	sl_reg StringView16::lastIndexOf(const StringView16& str, sl_reg start) const noexcept
+	{
+		return _priv_StringView16::lastIndexOf(m_data, m_length, str.m_data, str.m_length, start);
+	}
+	
+	sl_bool StringView16::startsWith(sl_char16 ch) const noexcept
+	{
+		return m_length > 0 && m_data[0] == ch;
+	}
+	
+	sl_bool StringView16::startsWith(const StringView16& str) const noexcept
+	{
+		if (str.m_length > m_length) {
+			return sl_false;
+		}
+		return _priv_StringView16::equals(m_data, str.m_length, str.m_data, str.m_length);
+	}
+	
+	sl_bool StringView16::endsWith(sl_char16 ch) const noexcept
+	{
+		return m_length > 0 && m_data[m_length - 1] == ch;
+	}
+	
+	sl_bool StringView16::endsWith(const StringView16& str) const noexcept
+	{
+		if (str.m_length > m_length) {
+			return sl_false;
+		}
+		return _priv_StringView16::equals(m_data + (m_length - str.m_length), str.m_length, str.m_data, str.m_length);
+	}
+	
+	sl_bool StringView16::contains(sl_char16 ch) const noexcept
+	{
+		return indexOf(ch) >= 0;
+	}
+	
+	sl_bool StringView16::contains(const StringView16& str) const noexcept
+	{
+		return indexOf(str) >= 0;
+	}
+	
+	StringView16 StringView16::trim() const noexcept
+	{
+		return _priv_StringView16::trim<StringView16>(m_data, m_length);
+	}
+	
+	StringView16 StringView16::trimLeft() const noexcept
+	{
+		return _priv_StringView16::trimLeft<StringView16>(m_data, m_length);
+	}
+	
+	StringView16 StringView16::trimRight() const noexcept
+	{
+		return _priv_StringView16::trimRight<StringView16>(m_data, m_length);
+	}
+	
+	List<StringView16> StringView16::split(const StringView16& pattern) const noexcept
+	{
+		return _priv_StringView16::split<StringView16>(*this, pattern.m_data, pattern.m_length);
+	}
+	
+	PRIV_SLIB_DEFINE_STRING_VIEW_PARSE_ALL(StringView16, String16)
+	
+	
+	int Compare<StringView>::operator()(const StringView& a, const StringView& b) const noexcept
+	{
+		return a.compare(b);
+	}
+	
+	int Compare<StringView16>::operator()(const StringView16& a, const StringView16& b) const noexcept
+	{
+		return a.compare(b);
+	}
+	
+	sl_bool Equals<StringView>::operator()(const StringView& a, const StringView& b) const noexcept
+	{
+		return a.equals(b);
+	}
+	
+	sl_bool Equals<StringView16>::operator()(const StringView16& a, const StringView16& b) const noexcept
+	{
+		return a.equals(b);
+	}
+	
+	sl_size Hash<StringView>::operator()(const StringView& a) const noexcept
+	{
+		return a.getHashCode();
+	}
+	
+	sl_size Hash<StringView16>::operator()(const StringView16& a) const noexcept
+	{
+		return a.getHashCode();
+	}
+
+}
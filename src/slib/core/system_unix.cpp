@@ -128,6 +128,16 @@ namespace slib
 		}
 	}
 
+	sl_uint64 System::getTickCount64()
+	{
+		struct timespec ts;
+		if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+			return (sl_uint64)(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+		} else {
+			return 0;
+		}
+	}
+
 	sl_uint32 System::getProcessId()
 	{
 		return getpid();
@@ -147,6 +157,15 @@ namespace slib
 #endif
 	}
 
+	sl_uint32 System::getProcessorsCount()
+	{
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		if (n > 0) {
+			return (sl_uint32)n;
+		}
+		return 1;
+	}
+
 #if !defined(SLIB_PLATFORM_IS_MOBILE)
 	sl_bool System::createProcess(const String& pathExecutable, const String* cmds, sl_uint32 nCmds)
 	{
@@ -129,6 +129,10 @@ namespace slib
 				task();
 			} else {
 				ObjectLocker lock(this);
+				// a task may have been added after the `pop()` above (`addTask()` pushes under this lock)
+				if (m_tasks.isNotEmpty()) {
+					continue;
+				}
 				sl_size nThreads = m_threadWorkers.getCount();
 				if (nThreads > getMinimumThreadsCount()) {
 					m_threadWorkers.remove_NoLock(thread);
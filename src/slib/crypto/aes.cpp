@@ -23,7 +23,14 @@
 #include "slib/crypto/aes.h"
 
 #include "slib/crypto/sha2.h"
+#include "slib/crypto/hmac.h"
 #include "slib/core/mio.h"
+#include "slib/core/cpu.h"
+#include "slib/core/math.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#endif
 
 /*
 	AES - Advanced Encryption Standard
@@ -365,6 +372,12 @@ static const sl_uint32 _priv_AES_RT3[256] = { RT };
 			W += 4;
 		}
 		Base::copyMemory(W, WE, 32);
+		
+		sl_uint32 nKeys = (nRounds + 1) << 2;
+		for (i = 0; i < nKeys; i++) {
+			MIO::writeUint32BE(m_roundKeyEncBytes + (i << 2), m_roundKeyEnc[i]);
+			MIO::writeUint32BE(m_roundKeyDecBytes + (i << 2), m_roundKeyDec[i]);
+		}
 		return sl_true;
 	}
 
@@ -439,6 +452,358 @@ Roundn (Last):
 		d3 = S1[3];
 	}
 	
+	class _priv_AES_Counter
+	{
+	public:
+		sl_uint64 high;
+		sl_uint64 low;
+		sl_bool flagInc32;
+		
+	public:
+		SLIB_INLINE void load(const void* counter)
+		{
+			high = MIO::readUint64BE(counter);
+			low = MIO::readUint64BE((const sl_uint8*)counter + 8);
+		}
+		
+		SLIB_INLINE void store(void* counter)
+		{
+			MIO::writeUint64BE(counter, high);
+			MIO::writeUint64BE((sl_uint8*)counter + 8, low);
+		}
+		
+		// returns sl_true if the low 32 bits don't wrap within `n` blocks, so that the counters can be generated by 32-bit lane additions
+		SLIB_INLINE sl_bool isLinear(sl_uint32 n)
+		{
+			return flagInc32 || (sl_uint32)low <= 0xFFFFFFFF - n;
+		}
+		
+		SLIB_INLINE void add(sl_uint32 n)
+		{
+			if (flagInc32) {
+				low = (low & SLIB_UINT64(0xFFFFFFFF00000000)) | (sl_uint32)(low + n);
+			} else {
+				low += n;
+				if (low < n) {
+					high++;
+				}
+			}
+		}
+		
+		SLIB_INLINE void increase()
+		{
+			if (flagInc32) {
+				low = (low & SLIB_UINT64(0xFFFFFFFF00000000)) | (sl_uint32)(low + 1);
+			} else {
+				low++;
+				if (!low) {
+					high++;
+				}
+			}
+		}
+		
+	};
+	
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	
+	static sl_bool _priv_AES_isAESNI()
+	{
+		static sl_bool flag = Cpu::isAESNISupported() && Cpu::isSSSE3Supported();
+		return flag;
+	}
+	
+	static sl_bool _priv_AES_isVAES()
+	{
+		static sl_bool flag = _priv_AES_isAESNI() && Cpu::isVAESSupported();
+		return flag;
+	}
+	
+	static sl_bool _priv_AES_isVAES512()
+	{
+		static sl_bool flag = _priv_AES_isVAES() && Cpu::isAVX512Supported();
+		return flag;
+	}
+	
+	SLIB_CPU_TARGET("aes,ssse3")
+	static void _priv_AES_encryptBlock_aesni(const sl_uint8* keys, sl_uint32 nRounds, const void* src, void* dst)
+	{
+		__m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src), _mm_loadu_si128((const __m128i*)keys));
+		for (sl_uint32 i = 1; i < nRounds; i++) {
+			b = _mm_aesenc_si128(b, _mm_loadu_si128((const __m128i*)(keys + (i << 4))));
+		}
+		b = _mm_aesenclast_si128(b, _mm_loadu_si128((const __m128i*)(keys + (nRounds << 4))));
+		_mm_storeu_si128((__m128i*)dst, b);
+	}
+	
+	SLIB_CPU_TARGET("aes,ssse3")
+	static void _priv_AES_decryptBlock_aesni(const sl_uint8* keys, sl_uint32 nRounds, const void* src, void* dst)
+	{
+		__m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src), _mm_loadu_si128((const __m128i*)keys));
+		for (sl_uint32 i = 1; i < nRounds; i++) {
+			b = _mm_aesdec_si128(b, _mm_loadu_si128((const __m128i*)(keys + (i << 4))));
+		}
+		b = _mm_aesdeclast_si128(b, _mm_loadu_si128((const __m128i*)(keys + (nRounds << 4))));
+		_mm_storeu_si128((__m128i*)dst, b);
+	}
+	
+	SLIB_CPU_TARGET("sse2")
+	SLIB_INLINE static __m128i _priv_AES_getCounterBlock(_priv_AES_Counter& counter)
+	{
+		__m128i ret = _mm_set_epi64x((sl_int64)(Endian::swap64(counter.low)), (sl_int64)(Endian::swap64(counter.high)));
+		counter.increase();
+		return ret;
+	}
+	
+#define PRIV_AES_OP8(OP, K) \
+	b0 = OP(b0, K); b1 = OP(b1, K); b2 = OP(b2, K); b3 = OP(b3, K); \
+	b4 = OP(b4, K); b5 = OP(b5, K); b6 = OP(b6, K); b7 = OP(b7, K);
+	
+	// 8 blocks are interleaved to hide the latency of AESENC
+	SLIB_CPU_TARGET("aes,ssse3")
+	static void _priv_AES_encryptCTR_aesni(const sl_uint8* keys, sl_uint32 nRounds, _priv_AES_Counter& counter, const sl_uint8* input, sl_uint8* output, sl_size nBlocks)
+	{
+		__m128i K[15];
+		for (sl_uint32 i = 0; i <= nRounds; i++) {
+			K[i] = _mm_loadu_si128((const __m128i*)(keys + (i << 4)));
+		}
+		// swaps the bytes in each 64-bit lane
+		__m128i S = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+		__m128i I = _mm_set_epi32(0, 1, 0, 0);
+		while (nBlocks >= 8) {
+			__m128i b0, b1, b2, b3, b4, b5, b6, b7;
+			if (counter.isLinear(8)) {
+				__m128i c = _mm_set_epi64x((sl_int64)(counter.low), (sl_int64)(counter.high));
+				b0 = _mm_shuffle_epi8(c, S); c = _mm_add_epi32(c, I);
+				b1 = _mm_shuffle_epi8(c, S); c = _mm_add_epi32(c, I);
+				b2 = _mm_shuffle_epi8(c, S); c = _mm_add_epi32(c, I);
+				b3 = _mm_shuffle_epi8(c, S); c = _mm_add_epi32(c, I);
+				b4 = _mm_shuffle_epi8(c, S); c = _mm_add_epi32(c, I);
+				b5 = _mm_shuffle_epi8(c, S); c = _mm_add_epi32(c, I);
+				b6 = _mm_shuffle_epi8(c, S); c = _mm_add_epi32(c, I);
+				b7 = _mm_shuffle_epi8(c, S);
+				counter.add(8);
+			} else {
+				b0 = _priv_AES_getCounterBlock(counter);
+				b1 = _priv_AES_getCounterBlock(counter);
+				b2 = _priv_AES_getCounterBlock(counter);
+				b3 = _priv_AES_getCounterBlock(counter);
+				b4 = _priv_AES_getCounterBlock(counter);
+				b5 = _priv_AES_getCounterBlock(counter);
+				b6 = _priv_AES_getCounterBlock(counter);
+				b7 = _priv_AES_getCounterBlock(counter);
+			}
+			PRIV_AES_OP8(_mm_xor_si128, K[0])
+			for (sl_uint32 i = 1; i < nRounds; i++) {
+				__m128i k = K[i];
+				PRIV_AES_OP8(_mm_aesenc_si128, k)
+			}
+			PRIV_AES_OP8(_mm_aesenclast_si128, K[nRounds])
+			const __m128i* src = (const __m128i*)input;
+			__m128i* dst = (__m128i*)output;
+			_mm_storeu_si128(dst, _mm_xor_si128(b0, _mm_loadu_si128(src)));
+			_mm_storeu_si128(dst + 1, _mm_xor_si128(b1, _mm_loadu_si128(src + 1)));
+			_mm_storeu_si128(dst + 2, _mm_xor_si128(b2, _mm_loadu_si128(src + 2)));
+			_mm_storeu_si128(dst + 3, _mm_xor_si128(b3, _mm_loadu_si128(src + 3)));
+			_mm_storeu_si128(dst + 4, _mm_xor_si128(b4, _mm_loadu_si128(src + 4)));
+			_mm_storeu_si128(dst + 5, _mm_xor_si128(b5, _mm_loadu_si128(src + 5)));
+			_mm_storeu_si128(dst + 6, _mm_xor_si128(b6, _mm_loadu_si128(src + 6)));
+			_mm_storeu_si128(dst + 7, _mm_xor_si128(b7, _mm_loadu_si128(src + 7)));
+			input += 128;
+			output += 128;
+			nBlocks -= 8;
+		}
+		while (nBlocks) {
+			__m128i b = _mm_xor_si128(_priv_AES_getCounterBlock(counter), K[0]);
+			for (sl_uint32 i = 1; i < nRounds; i++) {
+				b = _mm_aesenc_si128(b, K[i]);
+			}
+			b = _mm_aesenclast_si128(b, K[nRounds]);
+			_mm_storeu_si128((__m128i*)output, _mm_xor_si128(b, _mm_loadu_si128((const __m128i*)input)));
+			input += 16;
+			output += 16;
+			nBlocks--;
+		}
+	}
+	
+	// VAES on 256-bit registers: 16 blocks per iteration
+	SLIB_CPU_TARGET("avx2,vaes")
+	static void _priv_AES_encryptCTR_vaes(const sl_uint8* keys, sl_uint32 nRounds, _priv_AES_Counter& counter, const sl_uint8* input, sl_uint8* output, sl_size nBlocks)
+	{
+		__m256i K[15];
+		for (sl_uint32 i = 0; i <= nRounds; i++) {
+			K[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(keys + (i << 4))));
+		}
+		__m256i S = _mm256_broadcastsi128_si256(_mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+		__m256i I = _mm256_set_epi32(0, 2, 0, 0, 0, 2, 0, 0);
+		while (nBlocks >= 16) {
+			if (!(counter.isLinear(16))) {
+				_priv_AES_encryptCTR_aesni(keys, nRounds, counter, input, output, 16);
+				input += 256;
+				output += 256;
+				nBlocks -= 16;
+				continue;
+			}
+			__m256i c = _mm256_add_epi32(_mm256_broadcastsi128_si256(_mm_set_epi64x((sl_int64)(counter.low), (sl_int64)(counter.high))), _mm256_set_epi32(0, 1, 0, 0, 0, 0, 0, 0));
+			__m256i b0 = _mm256_shuffle_epi8(c, S); c = _mm256_add_epi32(c, I);
+			__m256i b1 = _mm256_shuffle_epi8(c, S); c = _mm256_add_epi32(c, I);
+			__m256i b2 = _mm256_shuffle_epi8(c, S); c = _mm256_add_epi32(c, I);
+			__m256i b3 = _mm256_shuffle_epi8(c, S); c = _mm256_add_epi32(c, I);
+			__m256i b4 = _mm256_shuffle_epi8(c, S); c = _mm256_add_epi32(c, I);
+			__m256i b5 = _mm256_shuffle_epi8(c, S); c = _mm256_add_epi32(c, I);
+			__m256i b6 = _mm256_shuffle_epi8(c, S); c = _mm256_add_epi32(c, I);
+			__m256i b7 = _mm256_shuffle_epi8(c, S);
+			counter.add(16);
+			PRIV_AES_OP8(_mm256_xor_si256, K[0])
+			for (sl_uint32 i = 1; i < nRounds; i++) {
+				__m256i k = K[i];
+				PRIV_AES_OP8(_mm256_aesenc_epi128, k)
+			}
+			PRIV_AES_OP8(_mm256_aesenclast_epi128, K[nRounds])
+			const __m256i* src = (const __m256i*)input;
+			__m256i* dst = (__m256i*)output;
+			_mm256_storeu_si256(dst, _mm256_xor_si256(b0, _mm256_loadu_si256(src)));
+			_mm256_storeu_si256(dst + 1, _mm256_xor_si256(b1, _mm256_loadu_si256(src + 1)));
+			_mm256_storeu_si256(dst + 2, _mm256_xor_si256(b2, _mm256_loadu_si256(src + 2)));
+			_mm256_storeu_si256(dst + 3, _mm256_xor_si256(b3, _mm256_loadu_si256(src + 3)));
+			_mm256_storeu_si256(dst + 4, _mm256_xor_si256(b4, _mm256_loadu_si256(src + 4)));
+			_mm256_storeu_si256(dst + 5, _mm256_xor_si256(b5, _mm256_loadu_si256(src + 5)));
+			_mm256_storeu_si256(dst + 6, _mm256_xor_si256(b6, _mm256_loadu_si256(src + 6)));
+			_mm256_storeu_si256(dst + 7, _mm256_xor_si256(b7, _mm256_loadu_si256(src + 7)));
+			input += 256;
+			output += 256;
+			nBlocks -= 16;
+		}
+		_mm256_zeroupper();
+		if (nBlocks) {
+			_priv_AES_encryptCTR_aesni(keys, nRounds, counter, input, output, nBlocks);
+		}
+	}
+	
+	// VAES on 512-bit registers: 32 blocks per iteration
+	SLIB_CPU_TARGET("avx512f,avx512bw,vaes")
+	static void _priv_AES_encryptCTR_vaes512(const sl_uint8* keys, sl_uint32 nRounds, _priv_AES_Counter& counter, const sl_uint8* input, sl_uint8* output, sl_size nBlocks)
+	{
+		__m512i K[15];
+		for (sl_uint32 i = 0; i <= nRounds; i++) {
+			K[i] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)(keys + (i << 4))));
+		}
+		__m512i S = _mm512_broadcast_i32x4(_mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+		__m512i I = _mm512_set_epi32(0, 4, 0, 0, 0, 4, 0, 0, 0, 4, 0, 0, 0, 4, 0, 0);
+		while (nBlocks >= 32) {
+			if (!(counter.isLinear(32))) {
+				_priv_AES_encryptCTR_aesni(keys, nRounds, counter, input, output, 32);
+				input += 512;
+				output += 512;
+				nBlocks -= 32;
+				continue;
+			}
+			__m512i c = _mm512_add_epi32(_mm512_broadcast_i32x4(_mm_set_epi64x((sl_int64)(counter.low), (sl_int64)(counter.high))), _mm512_set_epi32(0, 3, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0));
+			__m512i b0 = _mm512_shuffle_epi8(c, S); c = _mm512_add_epi32(c, I);
+			__m512i b1 = _mm512_shuffle_epi8(c, S); c = _mm512_add_epi32(c, I);
+			__m512i b2 = _mm512_shuffle_epi8(c, S); c = _mm512_add_epi32(c, I);
+			__m512i b3 = _mm512_shuffle_epi8(c, S); c = _mm512_add_epi32(c, I);
+			__m512i b4 = _mm512_shuffle_epi8(c, S); c = _mm512_add_epi32(c, I);
+			__m512i b5 = _mm512_shuffle_epi8(c, S); c = _mm512_add_epi32(c, I);
+			__m512i b6 = _mm512_shuffle_epi8(c, S); c = _mm512_add_epi32(c, I);
+			__m512i b7 = _mm512_shuffle_epi8(c, S);
+			counter.add(32);
+			PRIV_AES_OP8(_mm512_xor_si512, K[0])
+			for (sl_uint32 i = 1; i < nRounds; i++) {
+				__m512i k = K[i];
+				PRIV_AES_OP8(_mm512_aesenc_epi128, k)
+			}
+			PRIV_AES_OP8(_mm512_aesenclast_epi128, K[nRounds])
+			const sl_uint8* src = input;
+			sl_uint8* dst = output;
+			_mm512_storeu_si512(dst, _mm512_xor_si512(b0, _mm512_loadu_si512(src)));
+			_mm512_storeu_si512(dst + 64, _mm512_xor_si512(b1, _mm512_loadu_si512(src + 64)));
+			_mm512_storeu_si512(dst + 128, _mm512_xor_si512(b2, _mm512_loadu_si512(src + 128)));
+			_mm512_storeu_si512(dst + 192, _mm512_xor_si512(b3, _mm512_loadu_si512(src + 192)));
+			_mm512_storeu_si512(dst + 256, _mm512_xor_si512(b4, _mm512_loadu_si512(src + 256)));
+			_mm512_storeu_si512(dst + 320, _mm512_xor_si512(b5, _mm512_loadu_si512(src + 320)));
+			_mm512_storeu_si512(dst + 384, _mm512_xor_si512(b6, _mm512_loadu_si512(src + 384)));
+			_mm512_storeu_si512(dst + 448, _mm512_xor_si512(b7, _mm512_loadu_si512(src + 448)));
+			input += 512;
+			output += 512;
+			nBlocks -= 32;
+		}
+		_mm256_zeroupper();
+		if (nBlocks) {
+			_priv_AES_encryptCTR_aesni(keys, nRounds, counter, input, output, nBlocks);
+		}
+	}
+	
+#undef PRIV_AES_OP8
+	
+#endif
+	
+	static void _priv_AES_encryptCTR(const sl_uint32* roundKey, const sl_uint8* roundKeyBytes, sl_uint32 nRounds, _priv_AES_Counter& counter, const sl_uint8* input, sl_uint8* output, sl_size nBlocks)
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_AES_isAESNI()) {
+			if (nBlocks >= 32 && _priv_AES_isVAES512()) {
+				_priv_AES_encryptCTR_vaes512(roundKeyBytes, nRounds, counter, input, output, nBlocks);
+			} else if (nBlocks >= 16 && _priv_AES_isVAES()) {
+				_priv_AES_encryptCTR_vaes(roundKeyBytes, nRounds, counter, input, output, nBlocks);
+			} else {
+				_priv_AES_encryptCTR_aesni(roundKeyBytes, nRounds, counter, input, output, nBlocks);
+			}
+			return;
+		}
+#endif
+		for (sl_size i = 0; i < nBlocks; i++) {
+			sl_uint32 d0 = (sl_uint32)(counter.high >> 32);
+			sl_uint32 d1 = (sl_uint32)(counter.high);
+			sl_uint32 d2 = (sl_uint32)(counter.low >> 32);
+			sl_uint32 d3 = (sl_uint32)(counter.low);
+			_priv_AES_encipher(roundKey, nRounds, d0, d1, d2, d3);
+			MIO::writeUint32BE(output, d0 ^ MIO::readUint32BE(input));
+			MIO::writeUint32BE(output + 4, d1 ^ MIO::readUint32BE(input + 4));
+			MIO::writeUint32BE(output + 8, d2 ^ MIO::readUint32BE(input + 8));
+			MIO::writeUint32BE(output + 12, d3 ^ MIO::readUint32BE(input + 12));
+			counter.increase();
+			input += 16;
+			output += 16;
+		}
+	}
+	
+	sl_bool AES::isHardwareAccelerated()
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		return _priv_AES_isAESNI();
+#else
+		return sl_false;
+#endif
+	}
+	
+	sl_size AES::encryptBlocks_CTR(void* _counter, const void* input, void* output, sl_size size) const
+	{
+		sl_size nBlocks = size >> 4;
+		if (!nBlocks) {
+			return 0;
+		}
+		_priv_AES_Counter counter;
+		counter.load(_counter);
+		counter.flagInc32 = sl_false;
+		_priv_AES_encryptCTR(m_roundKeyEnc, m_roundKeyEncBytes, m_nCountRounds, counter, (const sl_uint8*)input, (sl_uint8*)output, nBlocks);
+		counter.store(_counter);
+		return nBlocks << 4;
+	}
+	
+	sl_size AES::encryptBlocks_GCTR(void* _counter, const void* input, void* output, sl_size size) const
+	{
+		sl_size nBlocks = size >> 4;
+		if (!nBlocks) {
+			return 0;
+		}
+		_priv_AES_Counter counter;
+		counter.load(_counter);
+		counter.flagInc32 = sl_true;
+		_priv_AES_encryptCTR(m_roundKeyEnc, m_roundKeyEncBytes, m_nCountRounds, counter, (const sl_uint8*)input, (sl_uint8*)output, nBlocks);
+		counter.store(_counter);
+		return nBlocks << 4;
+	}
+	
 	void AES::encrypt(sl_uint32& d0, sl_uint32& d1, sl_uint32& d2, sl_uint32& d3) const
 	{
 		_priv_AES_encipher(m_roundKeyEnc, m_nCountRounds, d0, d1, d2, d3);
@@ -446,6 +811,12 @@ Roundn (Last):
 	
 	void AES::encryptBlock(const void* _src, void *_dst) const
 	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_AES_isAESNI()) {
+			_priv_AES_encryptBlock_aesni(m_roundKeyEncBytes, m_nCountRounds, _src, _dst);
+			return;
+		}
+#endif
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
 
@@ -542,6 +913,12 @@ Roundn (Last):
 	
 	void AES::decryptBlock(const void* _src, void *_dst) const
 	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_AES_isAESNI()) {
+			_priv_AES_decryptBlock_aesni(m_roundKeyDecBytes, m_nCountRounds, _src, _dst);
+			return;
+		}
+#endif
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
 		
@@ -586,4 +963,263 @@ Roundn (Last):
 		setCipher(&m_cipher);
 	}
 
+
+#define PRIV_AES_GCM_STREAM_SALT_SIZE 16
+#define PRIV_AES_GCM_STREAM_FINAL_FLAG 0x80000000
+#define PRIV_AES_GCM_STREAM_PBKDF2_ITERATIONS 100000
+
+	AES_GCM_StreamFilter::AES_GCM_StreamFilter()
+	{
+		Base::zeroMemory(m_key, sizeof(m_key));
+		m_lenKey = 0;
+		m_flagServer = sl_false;
+
+		m_counterRead = 0;
+		m_sizeHeaderRead = 0;
+		m_sizeFrameRead = 0;
+		m_flagFinalFrameRead = sl_false;
+		m_flagFinishedRead = sl_false;
+		m_posFrameRead = 0;
+
+		m_counterWrite = 0;
+		m_flagWrittenSalt = sl_false;
+	}
+
+	AES_GCM_StreamFilter::~AES_GCM_StreamFilter()
+	{
+		Base::zeroMemory(m_key, sizeof(m_key));
+	}
+
+	Ref<AES_GCM_StreamFilter> AES_GCM_StreamFilter::create(const Ref<AsyncStream>& source, const void* key, sl_uint32 lenKey, sl_bool flagServer)
+	{
+		if (lenKey != 16 && lenKey != 24 && lenKey != 32) {
+			return sl_null;
+		}
+		Ref<AES_GCM_StreamFilter> ret = new AES_GCM_StreamFilter;
+		if (ret.isNotNull()) {
+			ret->m_bufFrameRead = Memory::create(SLIB_AES_GCM_STREAM_FILTER_FRAME_SIZE_MAX + 16);
+			if (ret->m_bufFrameRead.isNull()) {
+				return sl_null;
+			}
+			Base::copyMemory(ret->m_key, key, lenKey);
+			ret->m_lenKey = lenKey;
+			ret->m_flagServer = flagServer;
+			ret->setSourceStream(source);
+		}
+		return ret;
+	}
+
+	Ref<AES_GCM_StreamFilter> AES_GCM_StreamFilter::create(const Ref<AsyncStream>& source, const String& password, sl_bool flagServer)
+	{
+		SLIB_STATIC_STRING(salt, "SLIB AES-GCM stream password")
+		sl_uint8 key[32];
+		PBKDF2_HMAC<SHA256>::execute(password.getData(), password.getLength(), salt.getData(), salt.getLength(), PRIV_AES_GCM_STREAM_PBKDF2_ITERATIONS, key, 32);
+		Ref<AES_GCM_StreamFilter> ret = create(source, key, 32, flagServer);
+		Base::zeroMemory(key, sizeof(key));
+		return ret;
+	}
+
+	sl_bool AES_GCM_StreamFilter::finishWriting(const Function<void(AsyncStreamResult*)>& callback)
+	{
+		MutexLocker lock(&m_lockWriting);
+		if (m_flagWritingError || m_flagWritingEnded) {
+			return sl_false;
+		}
+		if (!(_writeFrame(sl_null, 0, sl_true, m_outputWrite))) {
+			setWritingError();
+			m_outputWrite.flush();
+			m_bufWriteConverted.clear();
+			return sl_false;
+		}
+		sl_bool bRet = _writeConvertedData(sl_null, 0, callback, sl_null);
+		setWritingEnded();
+		return bRet;
+	}
+
+	sl_bool AES_GCM_StreamFilter::isReadingFinished()
+	{
+		return m_flagFinishedRead;
+	}
+
+	// the key of a direction: HKDF-SHA256(IKM = shared key, salt = salt of the direction, info = role of the writer)
+	static void _priv_AES_GCM_StreamFilter_setKey(AES_GCM& gcm, const sl_uint8* key, sl_uint32 lenKey, const sl_uint8* salt, sl_bool flagServerWriting)
+	{
+		SLIB_STATIC_STRING(infoClient, "SLIB AES-GCM stream client")
+		SLIB_STATIC_STRING(infoServer, "SLIB AES-GCM stream server")
+		const String& info = flagServerWriting ? infoServer : infoClient;
+		sl_uint8 keyDirection[32];
+		HKDF<SHA256>::execute(salt, PRIV_AES_GCM_STREAM_SALT_SIZE, key, lenKey, info.getData(), info.getLength(), keyDirection, lenKey);
+		gcm.setKey(keyDirection, lenKey);
+		Base::zeroMemory(keyDirection, sizeof(keyDirection));
+	}
+
+	static void _priv_AES_GCM_StreamFilter_getNonce(sl_uint8* nonce, sl_uint64 counter)
+	{
+		MIO::writeUint32BE(nonce, 0);
+		MIO::writeUint64BE(nonce + 4, counter);
+	}
+
+	sl_bool AES_GCM_StreamFilter::_decryptFrame(const sl_uint8* frame, AsyncStreamFilterOutput& output)
+	{
+		sl_uint32 size = m_sizeFrameRead;
+		sl_uint8 nonce[12];
+		_priv_AES_GCM_StreamFilter_getNonce(nonce, m_counterRead);
+		const sl_uint8* header = m_headerRead + PRIV_AES_GCM_STREAM_SALT_SIZE;
+		if (size) {
+			sl_uint32 sizeOutput;
+			void* out = output.getBuffer(sizeOutput, size);
+			if (!out) {
+				return sl_false;
+			}
+			if (!(m_gcmRead.decrypt(nonce, 12, header, 4, frame, out, size, frame + size, 16))) {
+				return sl_false;
+			}
+			output.commit(size);
+		} else {
+			if (!(m_gcmRead.decrypt(nonce, 12, header, 4, sl_null, sl_null, 0, frame, 16))) {
+				return sl_false;
+			}
+		}
+		m_counterRead++;
+		m_sizeHeaderRead = PRIV_AES_GCM_STREAM_SALT_SIZE;
+		m_sizeFrameRead = 0;
+		m_posFrameRead = 0;
+		if (m_flagFinalFrameRead) {
+			m_flagFinishedRead = sl_true;
+			setReadingEnded();
+		}
+		return sl_true;
+	}
+
+	sl_bool AES_GCM_StreamFilter::convertRead(void* _data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		while (size) {
+			if (m_flagFinishedRead) {
+				// no data is allowed after the final frame
+				return sl_false;
+			}
+			if (m_sizeHeaderRead < PRIV_AES_GCM_STREAM_SALT_SIZE + 4) {
+				// salt (only at the start) and the header of the frame
+				sl_uint32 n = PRIV_AES_GCM_STREAM_SALT_SIZE + 4 - m_sizeHeaderRead;
+				if (n > size) {
+					n = size;
+				}
+				Base::copyMemory(m_headerRead + m_sizeHeaderRead, data, n);
+				m_sizeHeaderRead += n;
+				data += n;
+				size -= n;
+				if (m_sizeHeaderRead < PRIV_AES_GCM_STREAM_SALT_SIZE + 4) {
+					continue;
+				}
+				if (!m_counterRead) {
+					_priv_AES_GCM_StreamFilter_setKey(m_gcmRead, m_key, m_lenKey, m_headerRead, !m_flagServer);
+				}
+				sl_uint32 header = MIO::readUint32BE(m_headerRead + PRIV_AES_GCM_STREAM_SALT_SIZE);
+				m_flagFinalFrameRead = (header & PRIV_AES_GCM_STREAM_FINAL_FLAG) != 0;
+				m_sizeFrameRead = header & ~PRIV_AES_GCM_STREAM_FINAL_FLAG;
+				if (m_sizeFrameRead > SLIB_AES_GCM_STREAM_FILTER_FRAME_SIZE_MAX) {
+					return sl_false;
+				}
+				if (!m_sizeFrameRead && !m_flagFinalFrameRead) {
+					return sl_false;
+				}
+				m_posFrameRead = 0;
+				continue;
+			}
+			sl_uint32 sizeFrame = m_sizeFrameRead + 16;
+			if (!m_posFrameRead && size >= sizeFrame) {
+				// whole frame in the input
+				if (!(_decryptFrame(data, output))) {
+					return sl_false;
+				}
+				data += sizeFrame;
+				size -= sizeFrame;
+				continue;
+			}
+			sl_uint32 n = sizeFrame - m_posFrameRead;
+			if (n > size) {
+				n = size;
+			}
+			sl_uint8* frame = (sl_uint8*)(m_bufFrameRead.getData());
+			Base::copyMemory(frame + m_posFrameRead, data, n);
+			m_posFrameRead += n;
+			data += n;
+			size -= n;
+			if (m_posFrameRead == sizeFrame) {
+				if (!(_decryptFrame(frame, output))) {
+					return sl_false;
+				}
+			}
+		}
+		return sl_true;
+	}
+
+	void AES_GCM_StreamFilter::onReadStream(AsyncStreamResult* result)
+	{
+		MutexLocker lock(&m_lockReading);
+		AsyncStreamFilter::onReadStream(result);
+		if (m_flagFinishedRead && !(m_bufReadConverted.getSize())) {
+			// no more data after the final frame
+			_closeAllReadRequests();
+		}
+	}
+
+	sl_bool AES_GCM_StreamFilter::_writeSalt(AsyncStreamFilterOutput& output)
+	{
+		if (m_flagWrittenSalt) {
+			return sl_true;
+		}
+		sl_uint8 salt[PRIV_AES_GCM_STREAM_SALT_SIZE];
+		Math::randomMemory(salt, sizeof(salt));
+		if (!(output.write(salt, sizeof(salt)))) {
+			return sl_false;
+		}
+		_priv_AES_GCM_StreamFilter_setKey(m_gcmWrite, m_key, m_lenKey, salt, m_flagServer);
+		m_flagWrittenSalt = sl_true;
+		return sl_true;
+	}
+
+	sl_bool AES_GCM_StreamFilter::_writeFrame(const sl_uint8* data, sl_uint32 size, sl_bool flagFinal, AsyncStreamFilterOutput& output)
+	{
+		if (!(_writeSalt(output))) {
+			return sl_false;
+		}
+		do {
+			sl_uint32 n = size;
+			if (n > SLIB_AES_GCM_STREAM_FILTER_FRAME_SIZE_MAX) {
+				n = SLIB_AES_GCM_STREAM_FILTER_FRAME_SIZE_MAX;
+			}
+			sl_uint32 sizeOutput;
+			sl_uint8* out = (sl_uint8*)(output.getBuffer(sizeOutput, n ? 21 : 20));
+			if (!out) {
+				return sl_false;
+			}
+			// fills the free space of the current buffer
+			if (n > sizeOutput - 20) {
+				n = sizeOutput - 20;
+			}
+			sl_uint32 header = n;
+			if (flagFinal && n == size) {
+				header |= PRIV_AES_GCM_STREAM_FINAL_FLAG;
+			}
+			MIO::writeUint32BE(out, header);
+			sl_uint8 nonce[12];
+			_priv_AES_GCM_StreamFilter_getNonce(nonce, m_counterWrite);
+			if (!(m_gcmWrite.encrypt(nonce, 12, out, 4, data, out + 4, n, out + 4 + n, 16))) {
+				return sl_false;
+			}
+			output.commit(n + 20);
+			m_counterWrite++;
+			data += n;
+			size -= n;
+		} while (size);
+		return sl_true;
+	}
+
+	sl_bool AES_GCM_StreamFilter::convertWrite(const void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		return _writeFrame((const sl_uint8*)data, size, sl_false, output);
+	}
+
 }
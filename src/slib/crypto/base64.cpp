@@ -20,185 +20,735 @@
  *   THE SOFTWARE.
  */
 
+
 #include "slib/crypto/base64.h"
 
+#include "slib/core/mio.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#endif
+
 #define BASE64_CHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
 #define BASE64_CHARS_URL "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
 
 namespace slib
 {
-	
-	SLIB_INLINE String _priv_Base64_encode(const char* patterns, const void* buf, sl_size size, char padding)
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	static sl_bool _priv_Base64_isSSSE3()
 	{
-		if (size == 0) {
-			return sl_null;
+		static sl_bool flag = Cpu::isSSSE3Supported();
+		return flag;
+	}
+
+	static sl_bool _priv_Base64_isAVX2()
+	{
+		static sl_bool flag = Cpu::isAVX2Supported();
+		return flag;
+	}
+
+	/*
+		Lookup-based codecs (W. Mula, D. Lemire: "Faster Base64 Encoding and Decoding Using AVX2 Instructions")
+
+		Encoding: every 3 input bytes are spread into 4 bytes holding 6-bit indices (in each 32-bit lane),
+		then each index is translated to ASCII by adding an offset selected by `pshufb` over its range.
+	*/
+
+	// offsets for the ranges: [0, 25] 'A', [26, 51] 'a', [52, 61] '0', 62, 63
+#define PRIV_BASE64_ENCODE_OFFSETS(C62, C63) \
+	'A', 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, (C62) - 62, (C63) - 63, 0, 0
+
+	SLIB_CPU_TARGET("ssse3")
+	static __m128i _priv_Base64_encodeBlock_ssse3(__m128i in, __m128i offsets)
+	{
+		in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+		__m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		__m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+		__m128i indices = _mm_or_si128(t0, t1);
+		__m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+		range = _mm_sub_epi8(range, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+		return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+	}
+
+	SLIB_CPU_TARGET("ssse3")
+	static sl_size _priv_Base64_encode_ssse3(const sl_uint8* input, sl_size size, sl_char8* output, sl_bool flagUrl)
+	{
+		__m128i offsets;
+		if (flagUrl) {
+			offsets = _mm_setr_epi8(PRIV_BASE64_ENCODE_OFFSETS('-', '_'));
+		} else {
+			offsets = _mm_setr_epi8(PRIV_BASE64_ENCODE_OFFSETS('+', '/'));
 		}
-		const sl_uint8* input = (const sl_uint8*)buf;
-		sl_uint32 last = (sl_uint32)(size % 3);
-		sl_size countBlock = (size / 3) + (last ? 1 : 0);
-		String ret = String::allocate(countBlock << 2);
-		if (ret.isEmpty()) {
-			return ret;
+		sl_size n = 0;
+		// loads 16 bytes, and encodes 12 bytes of them
+		while (n + 16 <= size) {
+			__m128i in = _mm_loadu_si128((const __m128i*)(input + n));
+			_mm_storeu_si128((__m128i*)output, _priv_Base64_encodeBlock_ssse3(in, offsets));
+			n += 12;
+			output += 16;
 		}
-		sl_char8* output = ret.getData();
-		sl_uint32 n = 0;
-		for (sl_size iBlock = 0; iBlock < countBlock; iBlock++) {
-			sl_uint8 n0 = input[0];
-			sl_uint8 n1 = (n + 1 < size) ? input[1] : 0;
-			sl_uint8 n2 = (n + 2 < size) ? input[2] : 0;
-			output[0] = patterns[(n0 & 0xFC) >> 2];
-			output[1] = patterns[((n0 & 0x03) << 4) + ((n1 & 0xF0) >> 4)];
-			output[2] = patterns[((n1 & 0x0F) << 2) + ((n2 & 0xC0) >> 6)];
-			output[3] = patterns[n2 & 0x3F];
-			input += 3;
-			n += 3;
-			output += 4;
+		return n;
+	}
+
+	SLIB_CPU_TARGET("avx2")
+	static sl_size _priv_Base64_encode_avx2(const sl_uint8* input, sl_size size, sl_char8* output, sl_bool flagUrl)
+	{
+		__m256i offsets;
+		if (flagUrl) {
+			offsets = _mm256_setr_epi8(PRIV_BASE64_ENCODE_OFFSETS('-', '_'), PRIV_BASE64_ENCODE_OFFSETS('-', '_'));
+		} else {
+			offsets = _mm256_setr_epi8(PRIV_BASE64_ENCODE_OFFSETS('+', '/'), PRIV_BASE64_ENCODE_OFFSETS('+', '/'));
+		}
+		__m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+		__m256i mask0 = _mm256_set1_epi32(0x0fc0fc00);
+		__m256i mul0 = _mm256_set1_epi32(0x04000040);
+		__m256i mask1 = _mm256_set1_epi32(0x003f03f0);
+		__m256i mul1 = _mm256_set1_epi32(0x01000010);
+		__m256i c51 = _mm256_set1_epi8(51);
+		__m256i c25 = _mm256_set1_epi8(25);
+		sl_size n = 0;
+		// 12 bytes from each 128-bit lane
+		while (n + 28 <= size) {
+			__m256i in = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(input + n)));
+			in = _mm256_inserti128_si256(in, _mm_loadu_si128((const __m128i*)(input + n + 12)), 1);
+			in = _mm256_shuffle_epi8(in, shuffle);
+			__m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, mask0), mul0);
+			__m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, mask1), mul1);
+			__m256i indices = _mm256_or_si256(t0, t1);
+			__m256i range = _mm256_subs_epu8(indices, c51);
+			range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(indices, c25));
+			_mm256_storeu_si256((__m256i*)output, _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range)));
+			n += 24;
+			output += 32;
 		}
-		if (padding) {
-			if (last == 1) {
-				*(output - 2) = padding;
+		return n;
+	}
+
+	/*
+		Decoding: the characters are validated and translated to 6-bit values by looking up the tables indexed by
+		their nibbles, and then packed by multiply-add instructions.
+		Blocks having URL-safe characters are retried after replacing '-' and '_' with '+' and '/'.
+		Returns the number of characters decoded; stops at the block having other characters (white spaces, padding, ...).
+	*/
+
+#define PRIV_BASE64_DECODE_LUT_LO 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+#define PRIV_BASE64_DECODE_LUT_HI 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+#define PRIV_BASE64_DECODE_LUT_ROLL 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+
+	SLIB_CPU_TARGET("ssse3")
+	static sl_bool _priv_Base64_translate_ssse3(__m128i& c)
+	{
+		__m128i mask2F = _mm_set1_epi8(0x2F);
+		__m128i hi = _mm_and_si128(_mm_srli_epi32(c, 4), mask2F);
+		__m128i lo = _mm_and_si128(c, mask2F);
+		lo = _mm_shuffle_epi8(_mm_setr_epi8(PRIV_BASE64_DECODE_LUT_LO), lo);
+		__m128i check = _mm_and_si128(lo, _mm_shuffle_epi8(_mm_setr_epi8(PRIV_BASE64_DECODE_LUT_HI), hi));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(check, _mm_setzero_si128())) != 0xFFFF) {
+			return sl_false;
+		}
+		__m128i roll = _mm_shuffle_epi8(_mm_setr_epi8(PRIV_BASE64_DECODE_LUT_ROLL), _mm_add_epi8(_mm_cmpeq_epi8(c, mask2F), hi));
+		c = _mm_add_epi8(c, roll);
+		return sl_true;
+	}
+
+	SLIB_CPU_TARGET("ssse3")
+	static sl_size _priv_Base64_decode_ssse3(const sl_char8* input, sl_size len, sl_uint8* output)
+	{
+		sl_size n = 0;
+		while (n + 16 <= len) {
+			__m128i c = _mm_loadu_si128((const __m128i*)(input + n));
+			if (!(_priv_Base64_translate_ssse3(c))) {
+				c = _mm_add_epi8(c, _mm_and_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('-')), _mm_set1_epi8('+' - '-')));
+				c = _mm_add_epi8(c, _mm_and_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('_')), _mm_set1_epi8('/' - '_')));
+				if (!(_priv_Base64_translate_ssse3(c))) {
+					break;
+				}
 			}
-			if (last >= 1) {
-				*(output - 1) = padding;
+			c = _mm_maddubs_epi16(c, _mm_set1_epi32(0x01400140));
+			c = _mm_madd_epi16(c, _mm_set1_epi32(0x00011000));
+			c = _mm_shuffle_epi8(c, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+			_mm_storel_epi64((__m128i*)output, c);
+			MIO::writeUint32LE(output + 8, (sl_uint32)(_mm_cvtsi128_si32(_mm_srli_si128(c, 8))));
+			n += 16;
+			output += 12;
+		}
+		return n;
+	}
+
+	SLIB_CPU_TARGET("avx2")
+	static sl_bool _priv_Base64_translate_avx2(__m256i& c)
+	{
+		__m256i mask2F = _mm256_set1_epi8(0x2F);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi32(c, 4), mask2F);
+		__m256i lo = _mm256_and_si256(c, mask2F);
+		lo = _mm256_shuffle_epi8(_mm256_setr_epi8(PRIV_BASE64_DECODE_LUT_LO, PRIV_BASE64_DECODE_LUT_LO), lo);
+		if (!(_mm256_testz_si256(lo, _mm256_shuffle_epi8(_mm256_setr_epi8(PRIV_BASE64_DECODE_LUT_HI, PRIV_BASE64_DECODE_LUT_HI), hi)))) {
+			return sl_false;
+		}
+		__m256i roll = _mm256_shuffle_epi8(_mm256_setr_epi8(PRIV_BASE64_DECODE_LUT_ROLL, PRIV_BASE64_DECODE_LUT_ROLL), _mm256_add_epi8(_mm256_cmpeq_epi8(c, mask2F), hi));
+		c = _mm256_add_epi8(c, roll);
+		return sl_true;
+	}
+
+	SLIB_CPU_TARGET("avx2")
+	static sl_size _priv_Base64_decode_avx2(const sl_char8* input, sl_size len, sl_uint8* output)
+	{
+		__m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		__m256i permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+		sl_size n = 0;
+		while (n + 32 <= len) {
+			__m256i c = _mm256_loadu_si256((const __m256i*)(input + n));
+			if (!(_priv_Base64_translate_avx2(c))) {
+				c = _mm256_add_epi8(c, _mm256_and_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('-')), _mm256_set1_epi8('+' - '-')));
+				c = _mm256_add_epi8(c, _mm256_and_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')), _mm256_set1_epi8('/' - '_')));
+				if (!(_priv_Base64_translate_avx2(c))) {
+					break;
+				}
 			}
-		} else {
-			if (last == 1) {
-				ret.setLength((countBlock << 2) - 2);
-			} else if (last > 1) {
-				ret.setLength((countBlock << 2) - 1);
+			c = _mm256_maddubs_epi16(c, _mm256_set1_epi32(0x01400140));
+			c = _mm256_madd_epi16(c, _mm256_set1_epi32(0x00011000));
+			c = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(c, shuffle), permute);
+			_mm_storeu_si128((__m128i*)output, _mm256_castsi256_si128(c));
+			_mm_storel_epi64((__m128i*)(output + 16), _mm256_extracti128_si256(c, 1));
+			n += 32;
+			output += 24;
+		}
+		return n;
+	}
+#endif
+
+	// encodes the whole blocks, and returns the number of the encoded bytes
+	static sl_size _priv_Base64_encodeBlocks(const sl_uint8* input, sl_size size, sl_char8* output, sl_bool flagUrl)
+	{
+		const char* patterns = flagUrl ? BASE64_CHARS_URL : BASE64_CHARS;
+		sl_size n = 0;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_Base64_isAVX2()) {
+			n = _priv_Base64_encode_avx2(input, size, output, flagUrl);
+			output += (n / 3) << 2;
+		}
+		if (_priv_Base64_isSSSE3()) {
+			sl_size m = _priv_Base64_encode_ssse3(input + n, size - n, output, flagUrl);
+			n += m;
+			output += (m / 3) << 2;
+		}
+#endif
+		for (; n + 3 <= size; n += 3) {
+			sl_uint32 v = ((sl_uint32)(input[n]) << 16) | ((sl_uint32)(input[n + 1]) << 8) | input[n + 2];
+			output[0] = patterns[v >> 18];
+			output[1] = patterns[(v >> 12) & 0x3F];
+			output[2] = patterns[(v >> 6) & 0x3F];
+			output[3] = patterns[v & 0x3F];
+			output += 4;
+		}
+		return n;
+	}
+
+	// encodes the last partial block (1 or 2 bytes)
+	static sl_size _priv_Base64_encodeLast(const sl_uint8* input, sl_size size, sl_char8* output, sl_bool flagUrl, sl_char8 padding)
+	{
+		const char* patterns = flagUrl ? BASE64_CHARS_URL : BASE64_CHARS;
+		if (size == 1) {
+			output[0] = patterns[input[0] >> 2];
+			output[1] = patterns[(input[0] & 0x03) << 4];
+			if (padding) {
+				output[2] = padding;
+				output[3] = padding;
+				return 4;
+			}
+			return 2;
+		} else if (size == 2) {
+			output[0] = patterns[input[0] >> 2];
+			output[1] = patterns[((input[0] & 0x03) << 4) | (input[1] >> 4)];
+			output[2] = patterns[(input[1] & 0x0F) << 2];
+			if (padding) {
+				output[3] = padding;
+				return 4;
 			}
+			return 3;
+		}
+		return 0;
+	}
+
+	static sl_size _priv_Base64_encode(const void* buf, sl_size size, sl_char8* output, sl_bool flagUrl, sl_char8 padding)
+	{
+		const sl_uint8* input = (const sl_uint8*)buf;
+		sl_size n = _priv_Base64_encodeBlocks(input, size, output, flagUrl);
+		sl_size len = (n / 3) << 2;
+		return len + _priv_Base64_encodeLast(input + n, size - n, output + len, flagUrl, padding);
+	}
+
+	static String _priv_Base64_encode(const void* buf, sl_size size, sl_bool flagUrl, sl_char8 padding)
+	{
+		if (size == 0) {
+			return sl_null;
+		}
+		String ret = String::allocate(Base64::getEncodedLength(size, padding));
+		if (ret.isEmpty()) {
+			return ret;
 		}
+		_priv_Base64_encode(buf, size, ret.getData(), flagUrl, padding);
 		return ret;
 	}
 
 	String Base64::encode(const void* buf, sl_size size, sl_char8 padding)
 	{
-		return _priv_Base64_encode(BASE64_CHARS, buf, size, padding);
+		return _priv_Base64_encode(buf, size, sl_false, padding);
 	}
 
 	String Base64::encodeUrl(const void* buf, sl_size size, sl_char8 padding)
 	{
-		return _priv_Base64_encode(BASE64_CHARS_URL, buf, size, padding);
+		return _priv_Base64_encode(buf, size, sl_true, padding);
 	}
 
 	String Base64::encode(const Memory &mem, sl_char8 padding)
 	{
-		return _priv_Base64_encode(BASE64_CHARS, mem.getData(), mem.getSize(), padding);
+		return _priv_Base64_encode(mem.getData(), mem.getSize(), sl_false, padding);
 	}
 
 	String Base64::encodeUrl(const Memory &mem, sl_char8 padding)
 	{
-		return _priv_Base64_encode(BASE64_CHARS_URL, mem.getData(), mem.getSize(), padding);
+		return _priv_Base64_encode(mem.getData(), mem.getSize(), sl_true, padding);
 	}
 
 	String Base64::encode(const String& str, sl_char8 padding)
 	{
-		return _priv_Base64_encode(BASE64_CHARS, str.getData(), str.getLength(), padding);
+		return _priv_Base64_encode(str.getData(), str.getLength(), sl_false, padding);
 	}
 
 	String Base64::encodeUrl(const String& str, sl_char8 padding)
 	{
-		return _priv_Base64_encode(BASE64_CHARS_URL, str.getData(), str.getLength(), padding);
+		return _priv_Base64_encode(str.getData(), str.getLength(), sl_true, padding);
 	}
-	
-	SLIB_INLINE sl_uint32 _priv_Base64_index(sl_char8 c)
+
+	sl_size Base64::encodeTo(const void* buf, sl_size size, sl_char8* output, sl_char8 padding)
 	{
-		if (c >= 'A' && c <= 'Z') {
-			return c - 'A';
-		}
-		if (c >= 'a' && c <= 'z') {
-			return 26 + (c - 'a');
-		}
-		if (c >= '0' && c <= '9') {
-			return 52 + (c - '0');
-		}
-		if (c == '+') {
-			return 62;
-		}
-		if (c == '/') {
-			return 63;
-		}
-		if (c == '-') {
-			return 62;
-		}
-		if (c == '_') {
-			return 63;
-		}
-		return 64;
+		return _priv_Base64_encode(buf, size, output, sl_false, padding);
 	}
 
-	sl_size Base64::decode(const String& str, void* buf, sl_size size, sl_char8 padding)
+	sl_size Base64::encodeUrlTo(const void* buf, sl_size size, sl_char8* output, sl_char8 padding)
 	{
-		sl_uint8* output = (sl_uint8*)buf;
-		sl_size len = str.getLength();
-		const sl_char8* input = str.getData();
-		// trim right (CR, LF)
-		while (len > 0) {
-			sl_char16 ch = input[len - 1];
-			if (SLIB_CHAR_IS_WHITE_SPACE(ch)) {
-				len--;
+		return _priv_Base64_encode(buf, size, output, sl_true, padding);
+	}
+
+	sl_size Base64::getEncodedLength(sl_size size, sl_char8 padding)
+	{
+		sl_size len = (size / 3) << 2;
+		sl_uint32 last = (sl_uint32)(size % 3);
+		if (last) {
+			if (padding) {
+				len += 4;
 			} else {
-				break;
+				len += last + 1;
 			}
 		}
-		sl_uint32 data[4];
-		sl_size indexInput = 0;
-		sl_size indexOutput = 0;
-		sl_uint32 posInBlock = 0;
-		while (indexInput < len) {
-			sl_char8 ch = input[indexInput];
-			if (SLIB_CHAR_IS_WHITE_SPACE(ch) || ch == padding) {
-				indexInput++;
+		return len;
+	}
+
+	sl_size Base64::getDecodedSize(sl_size len)
+	{
+		sl_size size = (len >> 2) * 3;
+		if ((len & 3) == 2) {
+			size++;
+		} else if ((len & 3) == 3) {
+			size += 2;
+		}
+		return size;
+	}
+	
+	// 6-bit values of the standard and URL-safe alphabets, 64: invalid, 65: white space
+	static const sl_uint8 _priv_Base64_decodeTable[256] = {
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 65, 65, 64, 64, 65, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		65, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 62, 64, 62, 64, 63,
+		52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 64, 64, 64, 64, 64, 64,
+		64, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+		15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 64, 64, 64, 64, 63,
+		64, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+		41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+		64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64
+	};
+
+	/*
+		Decodes the characters continuing from the state (`posInBlock`, `bits`) of the previous call.
+		White spaces and padding characters are skipped. Returns sl_false when an invalid character is found.
+	*/
+	static sl_bool _priv_Base64_decode(const sl_char8* input, sl_size len, sl_uint8* output, sl_size& sizeOutput, sl_char8 padding, sl_uint32& posInBlock, sl_uint32& bits)
+	{
+		sl_uint8* start = output;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		// the vector decoders don't know `padding`, so they are used only when it is not one of the alphabets
+		sl_bool flagSIMD = _priv_Base64_decodeTable[(sl_uint8)padding] >= 64;
+		sl_bool flagAVX2 = flagSIMD && _priv_Base64_isAVX2();
+		sl_bool flagSSSE3 = flagSIMD && _priv_Base64_isSSSE3();
+		// the characters before this index are processed one by one, after a vector decoder stops
+		sl_size iNextSIMD = 0;
+#endif
+		sl_size i = 0;
+		while (i < len) {
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+			if (!posInBlock && i >= iNextSIMD) {
+				if (flagAVX2 && i + 32 <= len) {
+					sl_size n = _priv_Base64_decode_avx2(input + i, len - i, output);
+					i += n;
+					output += (n >> 2) * 3;
+				}
+				if (flagSSSE3 && i + 16 <= len) {
+					sl_size n = _priv_Base64_decode_ssse3(input + i, len - i, output);
+					i += n;
+					output += (n >> 2) * 3;
+				}
+				if (i >= len) {
+					break;
+				}
+				iNextSIMD = i + 16;
+			}
+#endif
+			sl_char8 ch = input[i++];
+			if (ch == padding) {
 				continue;
 			}
-			sl_uint32 sig = _priv_Base64_index(ch);
+			sl_uint32 sig = _priv_Base64_decodeTable[(sl_uint8)ch];
 			if (sig >= 64) {
-				return 0;
+				if (sig == 65) {
+					continue;
+				}
+				sizeOutput = output - start;
+				return sl_false;
 			}
-			data[posInBlock] = sig;
+			bits = (bits << 6) | sig;
 			switch (posInBlock) {
 				case 0:
-					++posInBlock;
+					posInBlock = 1;
 					break;
 				case 1:
-					output[indexOutput] = (sl_uint8)((data[0] << 2) + ((data[1] & 0x30) >> 4));
-					++indexOutput;
-					++posInBlock;
+					*(output++) = (sl_uint8)(bits >> 4);
+					posInBlock = 2;
 					break;
 				case 2:
-					output[indexOutput] = (sl_uint8)(((data[1] & 0xf) << 4) + ((data[2] & 0x3c) >> 2));
-					++indexOutput;
-					++posInBlock;
+					*(output++) = (sl_uint8)(bits >> 2);
+					posInBlock = 3;
 					break;
 				case 3:
-					output[indexOutput] = (sl_uint8)(((data[2] & 0x3) << 6) + data[3]);
-					++indexOutput;
+					*(output++) = (sl_uint8)bits;
+					bits = 0;
 					posInBlock = 0;
 					break;
 			}
-			indexInput++;
 		}
-		return indexOutput;
+		sizeOutput = output - start;
+		return sl_true;
+	}
+
+	sl_size Base64::decode(const sl_char8* base64, sl_size len, void* output, sl_char8 padding)
+	{
+		sl_size size = 0;
+		sl_uint32 posInBlock = 0;
+		sl_uint32 bits = 0;
+		if (_priv_Base64_decode(base64, len, (sl_uint8*)output, size, padding, posInBlock, bits)) {
+			return size;
+		}
+		return 0;
+	}
+
+	sl_size Base64::decode(const String& str, void* buf, sl_size size, sl_char8 padding)
+	{
+		return decode(str.getData(), str.getLength(), buf, padding);
 	}
 
 	Memory Base64::decode(const String& base64, sl_char8 padding)
 	{
 		sl_size len = base64.getLength();
-		sl_size size = (len >> 2) * 3;
-		if ((len & 3) == 2) {
-			size++;
-		} else if ((len & 3) == 3) {
-			size += 2;
-		}
-		Memory mem = Memory::create(size);
+		Memory mem = Memory::create(getDecodedSize(len));
 		if (mem.isNull()) {
 			return sl_null;
 		}
-		sl_size sizeOutput = decode(base64, mem.getData(), size, padding);
+		sl_size sizeOutput = decode(base64.getData(), len, mem.getData(), padding);
 		if (sizeOutput > 0) {
 			return mem.sub(0, sizeOutput);
 		}
 		return sl_null;
 	}
 
+
+	Base64Encoder::Base64Encoder(sl_bool flagUrl, sl_char8 padding)
+	{
+		m_flagUrl = flagUrl;
+		m_padding = padding;
+		m_sizeRemain = 0;
+	}
+
+	Base64Encoder::~Base64Encoder()
+	{
+	}
+
+	void Base64Encoder::reset()
+	{
+		m_sizeRemain = 0;
+	}
+
+	sl_size Base64Encoder::update(const void* _data, sl_size size, sl_char8* output)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		sl_size len = 0;
+		if (m_sizeRemain) {
+			sl_uint8 block[3];
+			block[0] = m_remain[0];
+			block[1] = m_remain[1];
+			while (m_sizeRemain < 3 && size) {
+				block[m_sizeRemain++] = *(data++);
+				size--;
+			}
+			if (m_sizeRemain < 3) {
+				m_remain[0] = block[0];
+				m_remain[1] = block[1];
+				return 0;
+			}
+			_priv_Base64_encodeBlocks(block, 3, output, m_flagUrl);
+			len = 4;
+			m_sizeRemain = 0;
+		}
+		sl_size n = _priv_Base64_encodeBlocks(data, size, output + len, m_flagUrl);
+		len += (n / 3) << 2;
+		m_sizeRemain = (sl_uint32)(size - n);
+		for (sl_uint32 i = 0; i < m_sizeRemain; i++) {
+			m_remain[i] = data[n + i];
+		}
+		return len;
+	}
+
+	String Base64Encoder::update(const void* data, sl_size size)
+	{
+		sl_size len = ((m_sizeRemain + size) / 3) << 2;
+		if (!len) {
+			update(data, size, sl_null);
+			return sl_null;
+		}
+		String ret = String::allocate(len);
+		if (ret.isNotEmpty()) {
+			update(data, size, ret.getData());
+		}
+		return ret;
+	}
+
+	sl_size Base64Encoder::finish(sl_char8* output)
+	{
+		sl_size len = _priv_Base64_encodeLast(m_remain, m_sizeRemain, output, m_flagUrl, m_padding);
+		m_sizeRemain = 0;
+		return len;
+	}
+
+	String Base64Encoder::finish()
+	{
+		sl_char8 output[4];
+		sl_size len = finish(output);
+		return String(output, len);
+	}
+
+
+	Base64Decoder::Base64Decoder(sl_char8 padding)
+	{
+		m_padding = padding;
+		m_posInBlock = 0;
+		m_bits = 0;
+		m_flagError = sl_false;
+	}
+
+	Base64Decoder::~Base64Decoder()
+	{
+	}
+
+	void Base64Decoder::reset()
+	{
+		m_posInBlock = 0;
+		m_bits = 0;
+		m_flagError = sl_false;
+	}
+
+	sl_size Base64Decoder::update(const sl_char8* base64, sl_size len, void* output)
+	{
+		if (m_flagError) {
+			return 0;
+		}
+		sl_size size = 0;
+		if (_priv_Base64_decode(base64, len, (sl_uint8*)output, size, m_padding, m_posInBlock, m_bits)) {
+			return size;
+		}
+		m_flagError = sl_true;
+		return 0;
+	}
+
+	Memory Base64Decoder::update(const sl_char8* base64, sl_size len)
+	{
+		if (m_flagError || !len) {
+			return sl_null;
+		}
+		Memory mem = Memory::create(Base64::getDecodedSize(len) + 2);
+		if (mem.isNull()) {
+			return sl_null;
+		}
+		sl_size size = update(base64, len, mem.getData());
+		if (size) {
+			return mem.sub(0, size);
+		}
+		return sl_null;
+	}
+
+	sl_bool Base64Decoder::isError()
+	{
+		return m_flagError;
+	}
+
+
+	Base64StreamFilter::Base64StreamFilter()
+	{
+		m_flagEncoder = sl_true;
+	}
+
+	Base64StreamFilter::~Base64StreamFilter()
+	{
+	}
+
+	Ref<Base64StreamFilter> Base64StreamFilter::createEncoder(const Ref<AsyncStream>& source, sl_bool flagUrl, sl_char8 padding)
+	{
+		Ref<Base64StreamFilter> ret = new Base64StreamFilter;
+		if (ret.isNotNull()) {
+			ret->m_flagEncoder = sl_true;
+			ret->m_encoderRead = Base64Encoder(flagUrl, padding);
+			ret->m_encoderWrite = Base64Encoder(flagUrl, padding);
+			ret->setSourceStream(source);
+		}
+		return ret;
+	}
+
+	Ref<Base64StreamFilter> Base64StreamFilter::createDecoder(const Ref<AsyncStream>& source, sl_char8 padding)
+	{
+		Ref<Base64StreamFilter> ret = new Base64StreamFilter;
+		if (ret.isNotNull()) {
+			ret->m_flagEncoder = sl_false;
+			ret->m_decoderRead = Base64Decoder(padding);
+			ret->m_decoderWrite = Base64Decoder(padding);
+			ret->setSourceStream(source);
+		}
+		return ret;
+	}
+
+	sl_bool Base64StreamFilter::isEncoder()
+	{
+		return m_flagEncoder;
+	}
+
+	sl_bool Base64StreamFilter::finishWriting(const Function<void(AsyncStreamResult*)>& callback)
+	{
+		MutexLocker lock(&m_lockWriting);
+		if (m_flagEncoder) {
+			if (!(_finishEncoding(m_encoderWrite, m_outputWrite))) {
+				return sl_false;
+			}
+		}
+		return _writeConvertedData(sl_null, 0, callback, sl_null);
+	}
+
+	sl_bool Base64StreamFilter::_encode(Base64Encoder& encoder, const void* _data, sl_uint32 size, AsyncStreamFilterOutput& output)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		while (size) {
+			sl_uint32 sizeOutput;
+			sl_char8* out = (sl_char8*)(output.getBuffer(sizeOutput, 8));
+			if (!out) {
+				return sl_false;
+			}
+			// the output of `n` bytes (with 2 remaining bytes at most) fits in `sizeOutput`
+			sl_uint32 n = (sizeOutput / 4 - 1) * 3;
+			if (n > size) {
+				n = size;
+			}
+			output.commit((sl_uint32)(encoder.update(data, n, out)));
+			data += n;
+			size -= n;
+		}
+		return sl_true;
+	}
+
+	sl_bool Base64StreamFilter::_finishEncoding(Base64Encoder& encoder, AsyncStreamFilterOutput& output)
+	{
+		sl_uint32 sizeOutput;
+		sl_char8* out = (sl_char8*)(output.getBuffer(sizeOutput, 4));
+		if (!out) {
+			return sl_false;
+		}
+		output.commit((sl_uint32)(encoder.finish(out)));
+		return sl_true;
+	}
+
+	sl_bool Base64StreamFilter::_decode(Base64Decoder& decoder, const void* _data, sl_uint32 size, AsyncStreamFilterOutput& output)
+	{
+		const sl_char8* data = (const sl_char8*)_data;
+		while (size) {
+			sl_uint32 sizeOutput;
+			void* out = output.getBuffer(sizeOutput, 8);
+			if (!out) {
+				return sl_false;
+			}
+			// `getDecodedSize(n) + 2` fits in `sizeOutput`
+			sl_uint32 n = (sizeOutput - 2) / 3 * 4;
+			if (n > size) {
+				n = size;
+			}
+			output.commit((sl_uint32)(decoder.update(data, n, out)));
+			if (decoder.isError()) {
+				return sl_false;
+			}
+			data += n;
+			size -= n;
+		}
+		return sl_true;
+	}
+
+	sl_bool Base64StreamFilter::convertRead(void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		if (m_flagEncoder) {
+			return _encode(m_encoderRead, data, size, output);
+		} else {
+			return _decode(m_decoderRead, data, size, output);
+		}
+	}
+
+	sl_bool Base64StreamFilter::convertWrite(const void* data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		if (m_flagEncoder) {
+			return _encode(m_encoderWrite, data, size, output);
+		} else {
+			return _decode(m_decoderWrite, data, size, output);
+		}
+	}
+
+	void Base64StreamFilter::onReadStream(AsyncStreamResult* result)
+	{
+		if (result->flagError && m_flagEncoder) {
+			// the source is ended: the last partial block should be delivered with the remaining data
+			MutexLocker lock(&m_lockReading);
+			AsyncStreamResult r = *result;
+			if (r.size > 0) {
+				addReadData(r.data, r.size, r.userObject);
+				r.size = 0;
+			}
+			if (!(_finishEncoding(m_encoderRead, m_outputRead) && m_outputRead.flush())) {
+				setReadingError();
+			}
+			AsyncStreamFilter::onReadStream(&r);
+			return;
+		}
+		AsyncStreamFilter::onReadStream(result);
+	}
+
 }
@@ -304,6 +304,18 @@ namespace slib
 		Counter Mode (CTR)
 ***************************************/
 
+	// whole blocks can be processed by the cipher-specific implementation (pipelined)
+	template <class BlockCipher>
+	static sl_size _priv_BlockCipher_CTR_encryptBlocks(const BlockCipher* crypto, void* counter, const sl_uint8* input, sl_uint8* output, sl_size size)
+	{
+		return 0;
+	}
+
+	static sl_size _priv_BlockCipher_CTR_encryptBlocks(const AES* crypto, void* counter, const sl_uint8* input, sl_uint8* output, sl_size size)
+	{
+		return crypto->encryptBlocks_CTR(counter, input, output, size);
+	}
+
 	template <class BlockCipher>
 	sl_size BlockCipher_CTR<BlockCipher>::encrypt(const BlockCipher* crypto, const void* _input, sl_size _size, void* _output, void* _counter, sl_uint32 offset)
 	{
@@ -341,6 +353,12 @@ namespace slib
 				return size;
 			}
 		}
+		n = _priv_BlockCipher_CTR_encryptBlocks(crypto, counter, input, output, size);
+		if (n) {
+			size -= n;
+			input += n;
+			output += n;
+		}
 		while (size > 0) {
 			crypto->encryptBlock(counter, mask);
 			n = SLIB_MIN(sizeBlock, size);
@@ -0,0 +1,752 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/crypto/checksum.h"
+
+#include "slib/core/mio.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#endif
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_NEON) && defined(__ARM_FEATURE_CRC32)
+#	include <arm_acle.h>
+#	define PRIV_CHECKSUM_SUPPORT_ARMV8_CRC32
+#endif
+
+#define PRIV_ADLER32_BASE 65521
+#define PRIV_ADLER32_NMAX 5552
+
+#define PRIV_XXH32_PRIME1 0x9E3779B1U
+#define PRIV_XXH32_PRIME2 0x85EBCA77U
+#define PRIV_XXH32_PRIME3 0xC2B2AE3DU
+#define PRIV_XXH32_PRIME4 0x27D4EB2FU
+#define PRIV_XXH32_PRIME5 0x165667B1U
+
+#define PRIV_XXH64_PRIME1 SLIB_UINT64(0x9E3779B185EBCA87)
+#define PRIV_XXH64_PRIME2 SLIB_UINT64(0xC2B2AE3D27D4EB4F)
+#define PRIV_XXH64_PRIME3 SLIB_UINT64(0x165667B19E3779F9)
+#define PRIV_XXH64_PRIME4 SLIB_UINT64(0x85EBCA77C2B2AE63)
+#define PRIV_XXH64_PRIME5 SLIB_UINT64(0x27D4EB2F165667C5)
+
+namespace slib
+{
+
+	class _priv_CRC32_Table
+	{
+	public:
+		sl_uint32 T[8][256];
+
+	public:
+		_priv_CRC32_Table(sl_uint32 poly)
+		{
+			sl_uint32 i, k;
+			for (i = 0; i < 256; i++) {
+				sl_uint32 c = i;
+				for (k = 0; k < 8; k++) {
+					if (c & 1) {
+						c = (c >> 1) ^ poly;
+					} else {
+						c >>= 1;
+					}
+				}
+				T[0][i] = c;
+			}
+			for (i = 0; i < 256; i++) {
+				for (k = 1; k < 8; k++) {
+					T[k][i] = (T[k - 1][i] >> 8) ^ T[0][T[k - 1][i] & 0xff];
+				}
+			}
+		}
+
+	public:
+		// `crc` is not inverted
+		sl_uint32 update(sl_uint32 crc, const sl_uint8* data, sl_size size) const
+		{
+			while (size >= 8) {
+				sl_uint32 a = crc ^ MIO::readUint32LE(data);
+				sl_uint32 b = MIO::readUint32LE(data + 4);
+				crc = T[7][a & 0xff] ^ T[6][(a >> 8) & 0xff] ^ T[5][(a >> 16) & 0xff] ^ T[4][a >> 24] ^
+					T[3][b & 0xff] ^ T[2][(b >> 8) & 0xff] ^ T[1][(b >> 16) & 0xff] ^ T[0][b >> 24];
+				data += 8;
+				size -= 8;
+			}
+			while (size) {
+				crc = T[0][(crc ^ *data) & 0xff] ^ (crc >> 8);
+				data++;
+				size--;
+			}
+			return crc;
+		}
+
+	};
+
+	static const _priv_CRC32_Table& _priv_CRC32_getTable()
+	{
+		static _priv_CRC32_Table table(0xEDB88320);
+		return table;
+	}
+
+	static const _priv_CRC32_Table& _priv_CRC32C_getTable()
+	{
+		static _priv_CRC32_Table table(0x82F63B78);
+		return table;
+	}
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	static sl_bool _priv_CRC32_isPCLMUL()
+	{
+		static sl_bool flag = Cpu::isPCLMULQDQSupported() && Cpu::isSSE41Supported();
+		return flag;
+	}
+
+	static sl_bool _priv_CRC32C_isSSE42()
+	{
+		static sl_bool flag = Cpu::isSSE42Supported();
+		return flag;
+	}
+
+	static sl_bool _priv_Adler32_isSSSE3()
+	{
+		static sl_bool flag = Cpu::isSSSE3Supported();
+		return flag;
+	}
+
+	static sl_bool _priv_Adler32_isAVX2()
+	{
+		static sl_bool flag = Cpu::isAVX2Supported();
+		return flag;
+	}
+
+	/*
+		Folds 64-byte blocks with carry-less multiplication ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction", Intel)
+		`size` should be a multiple of 16 and not less than 64. `crc` is not inverted
+	*/
+	SLIB_CPU_TARGET("pclmul,sse4.1")
+	static sl_uint32 _priv_CRC32_pclmul(sl_uint32 crc, const sl_uint8* data, sl_size size)
+	{
+		const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+		const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+		const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+		const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+		const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+		__m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+		x1 = _mm_loadu_si128((const __m128i*)data);
+		x2 = _mm_loadu_si128((const __m128i*)(data + 16));
+		x3 = _mm_loadu_si128((const __m128i*)(data + 32));
+		x4 = _mm_loadu_si128((const __m128i*)(data + 48));
+		x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+		data += 64;
+		size -= 64;
+
+		// fold by 4
+		while (size >= 64) {
+			x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+			x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+			x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+			x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)data));
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data + 16)));
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data + 32)));
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data + 48)));
+			data += 64;
+			size -= 64;
+		}
+
+		// fold into 128 bits
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+		// fold by 1
+		while (size >= 16) {
+			x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)data)), x5);
+			data += 16;
+			size -= 16;
+		}
+
+		// fold 128 bits to 64 bits
+		x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+		x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+		x2 = _mm_srli_si128(x1, 4);
+		x1 = _mm_and_si128(x1, mask32);
+		x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		// Barrett reduction to 32 bits
+		x2 = _mm_and_si128(x1, mask32);
+		x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+		x2 = _mm_and_si128(x2, mask32);
+		x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+		return (sl_uint32)(_mm_extract_epi32(x1, 1));
+	}
+
+	// `crc` is not inverted
+	SLIB_CPU_TARGET("sse4.2")
+	static sl_uint32 _priv_CRC32C_sse42(sl_uint32 crc, const sl_uint8* data, sl_size size)
+	{
+#if defined(SLIB_ARCH_IS_X64)
+		sl_uint64 crc64 = crc;
+		while (size >= 8) {
+			crc64 = _mm_crc32_u64(crc64, MIO::readUint64LE(data));
+			data += 8;
+			size -= 8;
+		}
+		crc = (sl_uint32)crc64;
+#endif
+		while (size >= 4) {
+			crc = _mm_crc32_u32(crc, MIO::readUint32LE(data));
+			data += 4;
+			size -= 4;
+		}
+		while (size) {
+			crc = _mm_crc32_u8(crc, *data);
+			data++;
+			size--;
+		}
+		return crc;
+	}
+
+	// only full 32-byte blocks are processed
+	SLIB_CPU_TARGET("ssse3")
+	static sl_uint32 _priv_Adler32_ssse3(sl_uint32 adler, const sl_uint8* data, sl_size nBlocks)
+	{
+		sl_uint32 s1 = adler & 0xffff;
+		sl_uint32 s2 = adler >> 16;
+		const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+		const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ones = _mm_set1_epi16(1);
+		while (nBlocks) {
+			sl_uint32 n = PRIV_ADLER32_NMAX / 32;
+			if (n > nBlocks) {
+				n = (sl_uint32)nBlocks;
+			}
+			nBlocks -= n;
+			// s2 += 32 * s1 for each block, and the byte sums of preceding blocks are accumulated in `ps`
+			__m128i ps = _mm_cvtsi32_si128((int)(s1 * n));
+			__m128i v2 = _mm_cvtsi32_si128((int)s2);
+			__m128i v1 = zero;
+			do {
+				__m128i b1 = _mm_loadu_si128((const __m128i*)data);
+				__m128i b2 = _mm_loadu_si128((const __m128i*)(data + 16));
+				ps = _mm_add_epi32(ps, v1);
+				v1 = _mm_add_epi32(v1, _mm_sad_epu8(b1, zero));
+				v2 = _mm_add_epi32(v2, _mm_madd_epi16(_mm_maddubs_epi16(b1, tap1), ones));
+				v1 = _mm_add_epi32(v1, _mm_sad_epu8(b2, zero));
+				v2 = _mm_add_epi32(v2, _mm_madd_epi16(_mm_maddubs_epi16(b2, tap2), ones));
+				data += 32;
+			} while (--n);
+			v2 = _mm_add_epi32(v2, _mm_slli_epi32(ps, 5));
+			v1 = _mm_add_epi32(v1, _mm_shuffle_epi32(v1, _MM_SHUFFLE(1, 0, 3, 2)));
+			v2 = _mm_add_epi32(v2, _mm_shuffle_epi32(v2, _MM_SHUFFLE(2, 3, 0, 1)));
+			v2 = _mm_add_epi32(v2, _mm_shuffle_epi32(v2, _MM_SHUFFLE(1, 0, 3, 2)));
+			s1 = (s1 + (sl_uint32)(_mm_cvtsi128_si32(v1))) % PRIV_ADLER32_BASE;
+			s2 = ((sl_uint32)(_mm_cvtsi128_si32(v2))) % PRIV_ADLER32_BASE;
+		}
+		return (s2 << 16) | s1;
+	}
+
+	// only full 64-byte blocks are processed
+	SLIB_CPU_TARGET("avx2")
+	static sl_uint32 _priv_Adler32_avx2(sl_uint32 adler, const sl_uint8* data, sl_size nBlocks)
+	{
+		sl_uint32 s1 = adler & 0xffff;
+		sl_uint32 s2 = adler >> 16;
+		const __m256i tap1 = _mm256_setr_epi8(
+			64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49,
+			48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33);
+		const __m256i tap2 = _mm256_setr_epi8(
+			32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+			16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i ones = _mm256_set1_epi16(1);
+		while (nBlocks) {
+			sl_uint32 n = PRIV_ADLER32_NMAX / 64;
+			if (n > nBlocks) {
+				n = (sl_uint32)nBlocks;
+			}
+			nBlocks -= n;
+			__m256i ps = _mm256_setr_epi32((int)(s1 * n), 0, 0, 0, 0, 0, 0, 0);
+			__m256i v2 = _mm256_setr_epi32((int)s2, 0, 0, 0, 0, 0, 0, 0);
+			__m256i v1 = zero;
+			do {
+				__m256i b1 = _mm256_loadu_si256((const __m256i*)data);
+				__m256i b2 = _mm256_loadu_si256((const __m256i*)(data + 32));
+				ps = _mm256_add_epi32(ps, v1);
+				v1 = _mm256_add_epi32(v1, _mm256_sad_epu8(b1, zero));
+				v2 = _mm256_add_epi32(v2, _mm256_madd_epi16(_mm256_maddubs_epi16(b1, tap1), ones));
+				v1 = _mm256_add_epi32(v1, _mm256_sad_epu8(b2, zero));
+				v2 = _mm256_add_epi32(v2, _mm256_madd_epi16(_mm256_maddubs_epi16(b2, tap2), ones));
+				data += 64;
+			} while (--n);
+			v2 = _mm256_add_epi32(v2, _mm256_slli_epi32(ps, 6));
+			__m128i h1 = _mm_add_epi32(_mm256_castsi256_si128(v1), _mm256_extracti128_si256(v1, 1));
+			__m128i h2 = _mm_add_epi32(_mm256_castsi256_si128(v2), _mm256_extracti128_si256(v2, 1));
+			h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(1, 0, 3, 2)));
+			h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(2, 3, 0, 1)));
+			h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(1, 0, 3, 2)));
+			s1 = (s1 + (sl_uint32)(_mm_cvtsi128_si32(h1))) % PRIV_ADLER32_BASE;
+			s2 = ((sl_uint32)(_mm_cvtsi128_si32(h2))) % PRIV_ADLER32_BASE;
+		}
+		return (s2 << 16) | s1;
+	}
+#endif
+
+#if defined(PRIV_CHECKSUM_SUPPORT_ARMV8_CRC32)
+	static sl_bool _priv_CRC32_isARMv8()
+	{
+		static sl_bool flag = Cpu::isARMv8CRC32Supported();
+		return flag;
+	}
+
+	// `crc` is not inverted
+	static sl_uint32 _priv_CRC32_armv8(sl_uint32 crc, const sl_uint8* data, sl_size size)
+	{
+		while (size >= 8) {
+			crc = __crc32d(crc, MIO::readUint64LE(data));
+			data += 8;
+			size -= 8;
+		}
+		while (size) {
+			crc = __crc32b(crc, *data);
+			data++;
+			size--;
+		}
+		return crc;
+	}
+
+	// `crc` is not inverted
+	static sl_uint32 _priv_CRC32C_armv8(sl_uint32 crc, const sl_uint8* data, sl_size size)
+	{
+		while (size >= 8) {
+			crc = __crc32cd(crc, MIO::readUint64LE(data));
+			data += 8;
+			size -= 8;
+		}
+		while (size) {
+			crc = __crc32cb(crc, *data);
+			data++;
+			size--;
+		}
+		return crc;
+	}
+#endif
+
+	static sl_uint32 _priv_Adler32_generic(sl_uint32 adler, const sl_uint8* data, sl_size size)
+	{
+		sl_uint32 s1 = adler & 0xffff;
+		sl_uint32 s2 = adler >> 16;
+		while (size) {
+			sl_size n = size;
+			if (n > PRIV_ADLER32_NMAX) {
+				n = PRIV_ADLER32_NMAX;
+			}
+			size -= n;
+			while (n) {
+				s1 += *data;
+				s2 += s1;
+				data++;
+				n--;
+			}
+			s1 %= PRIV_ADLER32_BASE;
+			s2 %= PRIV_ADLER32_BASE;
+		}
+		return (s2 << 16) | s1;
+	}
+
+
+	sl_uint32 CRC32::extend(sl_uint32 crc, const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		crc = ~crc;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (size >= 64 && _priv_CRC32_isPCLMUL()) {
+			sl_size n = size & ~((sl_size)15);
+			crc = _priv_CRC32_pclmul(crc, data, n);
+			data += n;
+			size -= n;
+		}
+#elif defined(PRIV_CHECKSUM_SUPPORT_ARMV8_CRC32)
+		if (_priv_CRC32_isARMv8()) {
+			return ~(_priv_CRC32_armv8(crc, data, size));
+		}
+#endif
+		return ~(_priv_CRC32_getTable().update(crc, data, size));
+	}
+
+	sl_uint32 CRC32::get(const void* data, sl_size size)
+	{
+		return extend(0, data, size);
+	}
+
+	sl_uint32 CRC32::extend(sl_uint32 crc, const Memory& mem)
+	{
+		return extend(crc, mem.getData(), mem.getSize());
+	}
+
+	sl_uint32 CRC32::get(const Memory& mem)
+	{
+		return extend(0, mem.getData(), mem.getSize());
+	}
+
+
+	sl_uint32 CRC32C::extend(sl_uint32 crc, const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		crc = ~crc;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_CRC32C_isSSE42()) {
+			return ~(_priv_CRC32C_sse42(crc, data, size));
+		}
+#elif defined(PRIV_CHECKSUM_SUPPORT_ARMV8_CRC32)
+		if (_priv_CRC32_isARMv8()) {
+			return ~(_priv_CRC32C_armv8(crc, data, size));
+		}
+#endif
+		return ~(_priv_CRC32C_getTable().update(crc, data, size));
+	}
+
+	sl_uint32 CRC32C::get(const void* data, sl_size size)
+	{
+		return extend(0, data, size);
+	}
+
+	sl_uint32 CRC32C::extend(sl_uint32 crc, const Memory& mem)
+	{
+		return extend(crc, mem.getData(), mem.getSize());
+	}
+
+	sl_uint32 CRC32C::get(const Memory& mem)
+	{
+		return extend(0, mem.getData(), mem.getSize());
+	}
+
+
+	sl_uint32 Adler32::extend(sl_uint32 adler, const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (size >= 64 && _priv_Adler32_isAVX2()) {
+			sl_size nBlocks = size >> 6;
+			adler = _priv_Adler32_avx2(adler, data, nBlocks);
+			nBlocks <<= 6;
+			data += nBlocks;
+			size -= nBlocks;
+		}
+		if (size >= 32 && _priv_Adler32_isSSSE3()) {
+			sl_size nBlocks = size >> 5;
+			adler = _priv_Adler32_ssse3(adler, data, nBlocks);
+			nBlocks <<= 5;
+			data += nBlocks;
+			size -= nBlocks;
+		}
+#endif
+		return _priv_Adler32_generic(adler, data, size);
+	}
+
+	sl_uint32 Adler32::get(const void* data, sl_size size)
+	{
+		return extend(1, data, size);
+	}
+
+	sl_uint32 Adler32::extend(sl_uint32 adler, const Memory& mem)
+	{
+		return extend(adler, mem.getData(), mem.getSize());
+	}
+
+	sl_uint32 Adler32::get(const Memory& mem)
+	{
+		return extend(1, mem.getData(), mem.getSize());
+	}
+
+
+	
+	SLIB_INLINE static sl_uint32 _priv_XXH32_rotl(sl_uint32 x, int r)
+	{
+		return (x << r) | (x >> (32 - r));
+	}
+
+	SLIB_INLINE static sl_uint32 _priv_XXH32_round(sl_uint32 acc, sl_uint32 input)
+	{
+		acc += input * PRIV_XXH32_PRIME2;
+		acc = _priv_XXH32_rotl(acc, 13);
+		return acc * PRIV_XXH32_PRIME1;
+	}
+
+	// returns the number of consumed bytes (multiple of 16)
+	static sl_size _priv_XXH32_process(sl_uint32* v, const sl_uint8* data, sl_size size)
+	{
+		sl_uint32 v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+		const sl_uint8* p = data;
+		const sl_uint8* end = data + (size & ~((sl_size)15));
+		while (p < end) {
+			v1 = _priv_XXH32_round(v1, MIO::readUint32LE(p));
+			v2 = _priv_XXH32_round(v2, MIO::readUint32LE(p + 4));
+			v3 = _priv_XXH32_round(v3, MIO::readUint32LE(p + 8));
+			v4 = _priv_XXH32_round(v4, MIO::readUint32LE(p + 12));
+			p += 16;
+		}
+		v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+		return p - data;
+	}
+
+	static sl_uint32 _priv_XXH32_finalize(sl_uint32 h, const sl_uint8* p, sl_size size)
+	{
+		while (size >= 4) {
+			h += MIO::readUint32LE(p) * PRIV_XXH32_PRIME3;
+			h = _priv_XXH32_rotl(h, 17) * PRIV_XXH32_PRIME4;
+			p += 4;
+			size -= 4;
+		}
+		while (size) {
+			h += (*p) * PRIV_XXH32_PRIME5;
+			h = _priv_XXH32_rotl(h, 11) * PRIV_XXH32_PRIME1;
+			p++;
+			size--;
+		}
+		h ^= h >> 15;
+		h *= PRIV_XXH32_PRIME2;
+		h ^= h >> 13;
+		h *= PRIV_XXH32_PRIME3;
+		h ^= h >> 16;
+		return h;
+	}
+
+	XXHash32::XXHash32()
+	{
+		start(0);
+	}
+
+	void XXHash32::start(sl_uint32 seed)
+	{
+		m_v[0] = seed + PRIV_XXH32_PRIME1 + PRIV_XXH32_PRIME2;
+		m_v[1] = seed + PRIV_XXH32_PRIME2;
+		m_v[2] = seed;
+		m_v[3] = seed - PRIV_XXH32_PRIME1;
+		m_sizeTotal = 0;
+		m_sizeBuf = 0;
+	}
+
+	void XXHash32::update(const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		m_sizeTotal += size;
+		if (m_sizeBuf) {
+			sl_uint32 n = 16 - m_sizeBuf;
+			if (n > size) {
+				n = (sl_uint32)size;
+			}
+			Base::copyMemory(m_buf + m_sizeBuf, data, n);
+			m_sizeBuf += n;
+			data += n;
+			size -= n;
+			if (m_sizeBuf < 16) {
+				return;
+			}
+			_priv_XXH32_process(m_v, m_buf, 16);
+			m_sizeBuf = 0;
+		}
+		sl_size n = _priv_XXH32_process(m_v, data, size);
+		data += n;
+		size -= n;
+		if (size) {
+			Base::copyMemory(m_buf, data, size);
+			m_sizeBuf = (sl_uint32)size;
+		}
+	}
+
+	sl_uint32 XXHash32::finish()
+	{
+		sl_uint32 h;
+		if (m_sizeTotal >= 16) {
+			h = _priv_XXH32_rotl(m_v[0], 1) + _priv_XXH32_rotl(m_v[1], 7) + _priv_XXH32_rotl(m_v[2], 12) + _priv_XXH32_rotl(m_v[3], 18);
+		} else {
+			h = m_v[2] + PRIV_XXH32_PRIME5;
+		}
+		h += (sl_uint32)m_sizeTotal;
+		return _priv_XXH32_finalize(h, m_buf, m_sizeBuf);
+	}
+
+	sl_uint32 XXHash32::get(const void* data, sl_size size, sl_uint32 seed)
+	{
+		XXHash32 hash;
+		hash.start(seed);
+		hash.update(data, size);
+		return hash.finish();
+	}
+
+	sl_uint32 XXHash32::get(const Memory& mem, sl_uint32 seed)
+	{
+		return get(mem.getData(), mem.getSize(), seed);
+	}
+	
+	SLIB_INLINE static sl_uint64 _priv_XXH64_rotl(sl_uint64 x, int r)
+	{
+		return (x << r) | (x >> (64 - r));
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_XXH64_round(sl_uint64 acc, sl_uint64 input)
+	{
+		acc += input * PRIV_XXH64_PRIME2;
+		acc = _priv_XXH64_rotl(acc, 31);
+		return acc * PRIV_XXH64_PRIME1;
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_XXH64_mergeRound(sl_uint64 acc, sl_uint64 v)
+	{
+		acc ^= _priv_XXH64_round(0, v);
+		return acc * PRIV_XXH64_PRIME1 + PRIV_XXH64_PRIME4;
+	}
+
+	// returns the number of consumed bytes (multiple of 32)
+	static sl_size _priv_XXH64_process(sl_uint64* v, const sl_uint8* data, sl_size size)
+	{
+		sl_uint64 v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+		const sl_uint8* p = data;
+		const sl_uint8* end = data + (size & ~((sl_size)31));
+		while (p < end) {
+			v1 = _priv_XXH64_round(v1, MIO::readUint64LE(p));
+			v2 = _priv_XXH64_round(v2, MIO::readUint64LE(p + 8));
+			v3 = _priv_XXH64_round(v3, MIO::readUint64LE(p + 16));
+			v4 = _priv_XXH64_round(v4, MIO::readUint64LE(p + 24));
+			p += 32;
+		}
+		v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+		return p - data;
+	}
+
+	XXHash64::XXHash64()
+	{
+		start(0);
+	}
+
+	void XXHash64::start(sl_uint64 seed)
+	{
+		m_v[0] = seed + PRIV_XXH64_PRIME1 + PRIV_XXH64_PRIME2;
+		m_v[1] = seed + PRIV_XXH64_PRIME2;
+		m_v[2] = seed;
+		m_v[3] = seed - PRIV_XXH64_PRIME1;
+		m_sizeTotal = 0;
+		m_sizeBuf = 0;
+	}
+
+	void XXHash64::update(const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		m_sizeTotal += size;
+		if (m_sizeBuf) {
+			sl_uint32 n = 32 - m_sizeBuf;
+			if (n > size) {
+				n = (sl_uint32)size;
+			}
+			Base::copyMemory(m_buf + m_sizeBuf, data, n);
+			m_sizeBuf += n;
+			data += n;
+			size -= n;
+			if (m_sizeBuf < 32) {
+				return;
+			}
+			_priv_XXH64_process(m_v, m_buf, 32);
+			m_sizeBuf = 0;
+		}
+		sl_size n = _priv_XXH64_process(m_v, data, size);
+		data += n;
+		size -= n;
+		if (size) {
+			Base::copyMemory(m_buf, data, size);
+			m_sizeBuf = (sl_uint32)size;
+		}
+	}
+
+	sl_uint64 XXHash64::finish()
+	{
+		sl_uint64 h;
+		if (m_sizeTotal >= 32) {
+			h = _priv_XXH64_rotl(m_v[0], 1) + _priv_XXH64_rotl(m_v[1], 7) + _priv_XXH64_rotl(m_v[2], 12) + _priv_XXH64_rotl(m_v[3], 18);
+			h = _priv_XXH64_mergeRound(h, m_v[0]);
+			h = _priv_XXH64_mergeRound(h, m_v[1]);
+			h = _priv_XXH64_mergeRound(h, m_v[2]);
+			h = _priv_XXH64_mergeRound(h, m_v[3]);
+		} else {
+			h = m_v[2] + PRIV_XXH64_PRIME5;
+		}
+		h += m_sizeTotal;
+		const sl_uint8* p = m_buf;
+		sl_uint32 size = m_sizeBuf;
+		while (size >= 8) {
+			h ^= _priv_XXH64_round(0, MIO::readUint64LE(p));
+			h = _priv_XXH64_rotl(h, 27) * PRIV_XXH64_PRIME1 + PRIV_XXH64_PRIME4;
+			p += 8;
+			size -= 8;
+		}
+		if (size >= 4) {
+			h ^= (sl_uint64)(MIO::readUint32LE(p)) * PRIV_XXH64_PRIME1;
+			h = _priv_XXH64_rotl(h, 23) * PRIV_XXH64_PRIME2 + PRIV_XXH64_PRIME3;
+			p += 4;
+			size -= 4;
+		}
+		while (size) {
+			h ^= (*p) * PRIV_XXH64_PRIME5;
+			h = _priv_XXH64_rotl(h, 11) * PRIV_XXH64_PRIME1;
+			p++;
+			size--;
+		}
+		h ^= h >> 33;
+		h *= PRIV_XXH64_PRIME2;
+		h ^= h >> 29;
+		h *= PRIV_XXH64_PRIME3;
+		h ^= h >> 32;
+		return h;
+	}
+
+	sl_uint64 XXHash64::get(const void* data, sl_size size, sl_uint64 seed)
+	{
+		XXHash64 hash;
+		hash.start(seed);
+		hash.update(data, size);
+		return hash.finish();
+	}
+
+	sl_uint64 XXHash64::get(const Memory& mem, sl_uint64 seed)
+	{
+		return get(mem.getData(), mem.getSize(), seed);
+	}
+
+}
@@ -0,0 +1,543 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/crypto/compress.h"
+
+#include "slib/crypto/zlib.h"
+#include "slib/crypto/lz4.h"
+#include "slib/crypto/zstd.h"
+
+namespace slib
+{
+
+	Compressor::Compressor()
+	{
+	}
+
+	Compressor::~Compressor()
+	{
+	}
+
+	sl_int32 Compressor::flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
+	{
+		sizeOutputUsed = 0;
+		return -1;
+	}
+
+	Ref<Compressor> Compressor::create(CompressionMethod method, sl_int32 level)
+	{
+		switch (method) {
+			case CompressionMethod::Zlib:
+			case CompressionMethod::Deflate:
+			case CompressionMethod::Gzip:
+				{
+					if (level < 0) {
+						level = 6;
+					}
+					Ref<ZlibCompress> ret = new ZlibCompress;
+					if (ret.isNotNull()) {
+						sl_bool flagStarted;
+						if (method == CompressionMethod::Zlib) {
+							flagStarted = ret->start(level);
+						} else if (method == CompressionMethod::Deflate) {
+							flagStarted = ret->startRaw(level);
+						} else {
+							flagStarted = ret->startGzip(level);
+						}
+						if (flagStarted) {
+							return ret;
+						}
+					}
+					break;
+				}
+			case CompressionMethod::LZ4:
+				{
+					if (level < 0) {
+						level = 1;
+					}
+					Ref<LZ4Compress> ret = new LZ4Compress;
+					if (ret.isNotNull()) {
+						if (ret->start(level)) {
+							return ret;
+						}
+					}
+					break;
+				}
+			case CompressionMethod::Zstd:
+				{
+					if (level < 0) {
+						level = 3;
+					}
+					Ref<ZstdCompress> ret = new ZstdCompress;
+					if (ret.isNotNull()) {
+						if (ret->start(level)) {
+							return ret;
+						}
+					}
+					break;
+				}
+			default:
+				break;
+		}
+		return sl_null;
+	}
+
+	Memory Compressor::compress(const void* _data, sl_size size, sl_bool flagFinish)
+	{
+		Memory ret;
+		sl_uint8* data = (sl_uint8*)_data;
+		sl_uint32 sizeChunk;
+		if (size > 16384) {
+			sizeChunk = 262144;
+		} else {
+			sizeChunk = 4096;
+		}
+		Memory memChunk = Memory::create(sizeChunk);
+		if (memChunk.isNull()) {
+			return ret;
+		}
+		sl_uint8* chunk = (sl_uint8*)(memChunk.getData());
+
+		MemoryBuffer buffer;
+		while (1) {
+			sl_uint32 sizeInput = (sl_uint32)(SLIB_MIN(size, sizeChunk));
+			sl_uint32 sizeInputPassed = 0, sizeOutputUsed = 0;
+			sl_int32 iRet = compress(data, sizeInput, sizeInputPassed, chunk, sizeChunk, sizeOutputUsed, flagFinish && sizeInput < sizeChunk);
+			if (iRet < 0) {
+				return ret;
+			}
+			if (sizeOutputUsed > 0) {
+				buffer.add(Memory::create(chunk, sizeOutputUsed));
+			}
+			data += sizeInputPassed;
+			size -= sizeInputPassed;
+			if (iRet == 0) {
+				break;
+			}
+			if (size == 0 && sizeOutputUsed == 0) {
+				break;
+			}
+		}
+		ret = buffer.merge();
+		return ret;
+	}
+
+
+	Decompressor::Decompressor()
+	{
+	}
+
+	Decompressor::~Decompressor()
+	{
+	}
+
+	Ref<Decompressor> Decompressor::create(CompressionMethod method)
+	{
+		switch (method) {
+			case CompressionMethod::Zlib:
+			case CompressionMethod::Gzip:
+			case CompressionMethod::Deflate:
+				{
+					Ref<ZlibDecompress> ret = new ZlibDecompress;
+					if (ret.isNotNull()) {
+						sl_bool flagStarted;
+						if (method == CompressionMethod::Deflate) {
+							flagStarted = ret->startRaw();
+						} else {
+							flagStarted = ret->start();
+						}
+						if (flagStarted) {
+							return ret;
+						}
+					}
+					break;
+				}
+			case CompressionMethod::LZ4:
+				{
+					Ref<LZ4Decompress> ret = new LZ4Decompress;
+					if (ret.isNotNull()) {
+						if (ret->start()) {
+							return ret;
+						}
+					}
+					break;
+				}
+			case CompressionMethod::Zstd:
+				{
+					Ref<ZstdDecompress> ret = new ZstdDecompress;
+					if (ret.isNotNull()) {
+						if (ret->start()) {
+							return ret;
+						}
+					}
+					break;
+				}
+			default:
+				break;
+		}
+		return sl_null;
+	}
+
+	Memory Decompressor::decompress(const void* _data, sl_size size)
+	{
+		Memory ret;
+		sl_uint8* data = (sl_uint8*)_data;
+		sl_uint32 sizeChunk;
+		if (size > 16384) {
+			sizeChunk = 262144;
+		} else {
+			sizeChunk = 4096;
+		}
+		Memory memChunk = Memory::create(sizeChunk);
+		if (memChunk.isNull()) {
+			return ret;
+		}
+		sl_uint8* chunk = (sl_uint8*)(memChunk.getData());
+
+		MemoryBuffer buffer;
+		while (1) {
+			sl_uint32 sizeInput = (sl_uint32)(SLIB_MIN(size, sizeChunk));
+			sl_uint32 sizeInputPassed = 0, sizeOutputUsed = 0;
+			sl_int32 iRet = decompress(data, sizeInput, sizeInputPassed, chunk, sizeChunk, sizeOutputUsed);
+			if (iRet < 0) {
+				return ret;
+			}
+			if (sizeOutputUsed > 0) {
+				buffer.add(Memory::create(chunk, sizeOutputUsed));
+			}
+			data += sizeInputPassed;
+			size -= sizeInputPassed;
+			if (iRet == 0) {
+				break;
+			}
+			if (size == 0 && sizeOutputUsed == 0) {
+				break;
+			}
+		}
+		ret = buffer.merge();
+		return ret;
+	}
+
+
+
+	Memory Compression::compress(CompressionMethod method, const void* data, sl_size size, sl_int32 level)
+	{
+		switch (method) {
+			case CompressionMethod::Zlib:
+				return Zlib::compress(data, size, level < 0 ? 6 : level);
+			case CompressionMethod::Deflate:
+				return Zlib::compressRaw(data, size, level < 0 ? 6 : level);
+			case CompressionMethod::Gzip:
+				return Zlib::compressGzip(data, size, level < 0 ? 6 : level);
+			case CompressionMethod::LZ4:
+				return LZ4::compress(data, size, level < 0 ? 1 : level);
+			case CompressionMethod::Zstd:
+				return Zstd::compress(data, size, level < 0 ? 3 : level);
+			default:
+				break;
+		}
+		return sl_null;
+	}
+
+	Memory Compression::compress(CompressionMethod method, const Memory& data, sl_int32 level)
+	{
+		return compress(method, data.getData(), data.getSize(), level);
+	}
+
+	Memory Compression::decompress(CompressionMethod method, const void* data, sl_size size)
+	{
+		switch (method) {
+			case CompressionMethod::Zlib:
+			case CompressionMethod::Gzip:
+				return Zlib::decompress(data, size);
+			case CompressionMethod::Deflate:
+				return Zlib::decompressRaw(data, size);
+			case CompressionMethod::LZ4:
+				return LZ4::decompress(data, size);
+			case CompressionMethod::Zstd:
+				return Zstd::decompress(data, size);
+			default:
+				break;
+		}
+		return sl_null;
+	}
+
+	Memory Compression::decompress(CompressionMethod method, const Memory& data)
+	{
+		return decompress(method, data.getData(), data.getSize());
+	}
+
+	SLIB_STATIC_STRING(_g_compression_encoding_deflate, "deflate")
+	SLIB_STATIC_STRING(_g_compression_encoding_gzip, "gzip")
+	SLIB_STATIC_STRING(_g_compression_encoding_zstd, "zstd")
+
+	String Compression::getContentEncoding(CompressionMethod method)
+	{
+		switch (method) {
+			case CompressionMethod::Zlib:
+				return _g_compression_encoding_deflate;
+			case CompressionMethod::Gzip:
+				return _g_compression_encoding_gzip;
+			case CompressionMethod::Zstd:
+				return _g_compression_encoding_zstd;
+			default:
+				break;
+		}
+		return sl_null;
+	}
+
+	CompressionMethod Compression::getMethodFromContentEncoding(const String& _encoding)
+	{
+		String encoding = _encoding.trim().toLower();
+		if (encoding == _g_compression_encoding_gzip || encoding == "x-gzip") {
+			return CompressionMethod::Gzip;
+		}
+		if (encoding == _g_compression_encoding_deflate) {
+			return CompressionMethod::Zlib;
+		}
+		if (encoding == _g_compression_encoding_zstd) {
+			return CompressionMethod::Zstd;
+		}
+		return CompressionMethod::None;
+	}
+
+	CompressionMethod Compression::selectContentEncoding(const String& acceptEncoding)
+	{
+		const CompressionMethod methods[] = { CompressionMethod::Zstd, CompressionMethod::Gzip, CompressionMethod::Zlib };
+		float q[3] = { -1, -1, -1 };
+		float qWildcard = -1;
+		ListElements<String> items(acceptEncoding.split(","));
+		for (sl_size i = 0; i < items.count; i++) {
+			String item = items[i];
+			float value = 1;
+			sl_reg pos = item.indexOf(';');
+			if (pos >= 0) {
+				String param = item.substring(pos + 1).trim();
+				item = item.substring(0, pos);
+				if (param.startsWith("q=") || param.startsWith("Q=")) {
+					if (!(param.substring(2).trim().parseFloat(&value))) {
+						value = 0;
+					}
+				}
+			}
+			item = item.trim();
+			if (item == "*") {
+				qWildcard = value;
+			} else {
+				CompressionMethod method = getMethodFromContentEncoding(item);
+				for (sl_uint32 k = 0; k < 3; k++) {
+					if (methods[k] == method) {
+						q[k] = value;
+					}
+				}
+			}
+		}
+		CompressionMethod ret = CompressionMethod::None;
+		float qMax = 0;
+		for (sl_uint32 k = 0; k < 3; k++) {
+			float value = q[k] < 0 ? qWildcard : q[k];
+			if (value > qMax) {
+				qMax = value;
+				ret = methods[k];
+			}
+		}
+		return ret;
+	}
+
+
+	CompressionStreamFilter::CompressionStreamFilter()
+	{
+		m_method = CompressionMethod::None;
+		m_level = -1;
+		m_flagFlushEachWrite = sl_true;
+	}
+
+	CompressionStreamFilter::~CompressionStreamFilter()
+	{
+	}
+
+	Ref<CompressionStreamFilter> CompressionStreamFilter::create(const Ref<AsyncStream>& source, CompressionMethod method, sl_int32 level)
+	{
+		Ref<Compressor> compressor = Compressor::create(method, level);
+		if (compressor.isNull()) {
+			return sl_null;
+		}
+		Ref<Decompressor> decompressor = Decompressor::create(method);
+		if (decompressor.isNull()) {
+			return sl_null;
+		}
+		Ref<CompressionStreamFilter> ret = new CompressionStreamFilter;
+		if (ret.isNotNull()) {
+			ret->m_method = method;
+			ret->m_level = level;
+			ret->m_compressor = Move(compressor);
+			ret->m_decompressor = Move(decompressor);
+			ret->setSourceStream(source);
+		}
+		return ret;
+	}
+
+	CompressionMethod CompressionStreamFilter::getMethod()
+	{
+		return m_method;
+	}
+
+	sl_bool CompressionStreamFilter::isFlushingEachWrite()
+	{
+		return m_flagFlushEachWrite;
+	}
+
+	void CompressionStreamFilter::setFlushingEachWrite(sl_bool flag)
+	{
+		m_flagFlushEachWrite = flag;
+	}
+
+	sl_bool CompressionStreamFilter::flushWriting(const Function<void(AsyncStreamResult*)>& callback)
+	{
+		MutexLocker lock(&m_lockWriting);
+		if (!(_flush(m_outputWrite))) {
+			setWritingError();
+		}
+		return _writeConvertedData(sl_null, 0, callback, sl_null);
+	}
+
+	sl_bool CompressionStreamFilter::finishWriting(const Function<void(AsyncStreamResult*)>& callback)
+	{
+		MutexLocker lock(&m_lockWriting);
+		Compressor* compressor = m_compressor.get();
+		if (!(compressor->isStarted())) {
+			return sl_false;
+		}
+		for (;;) {
+			sl_uint32 sizeOutput;
+			void* output = m_outputWrite.getBuffer(sizeOutput);
+			if (!output) {
+				setWritingError();
+				break;
+			}
+			sl_uint32 sizeInputPassed, sizeOutputUsed;
+			sl_int32 iRet = compressor->compress(sl_null, 0, sizeInputPassed, output, sizeOutput, sizeOutputUsed, sl_true);
+			if (iRet < 0) {
+				setWritingError();
+				break;
+			}
+			m_outputWrite.commit(sizeOutputUsed);
+			if (!iRet) {
+				break;
+			}
+		}
+		return _writeConvertedData(sl_null, 0, callback, sl_null);
+	}
+
+	sl_bool CompressionStreamFilter::convertRead(void* _data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		for (;;) {
+			Decompressor* decompressor = m_decompressor.get();
+			if (!(decompressor->isStarted())) {
+				if (!size) {
+					return sl_true;
+				}
+				// next stream is concatenated
+				m_decompressor = Decompressor::create(m_method);
+				decompressor = m_decompressor.get();
+				if (!decompressor) {
+					return sl_false;
+				}
+			}
+			sl_uint32 sizeOutput;
+			void* out = output.getBuffer(sizeOutput);
+			if (!out) {
+				return sl_false;
+			}
+			sl_uint32 sizeInputPassed, sizeOutputUsed;
+			sl_int32 iRet = decompressor->decompress(data, size, sizeInputPassed, out, sizeOutput, sizeOutputUsed);
+			if (iRet < 0) {
+				return sl_false;
+			}
+			output.commit(sizeOutputUsed);
+			data += sizeInputPassed;
+			size -= sizeInputPassed;
+			if (!iRet) {
+				decompressor->abort();
+				continue;
+			}
+			if (sizeOutputUsed < sizeOutput) {
+				// all the available output is written
+				if (!size) {
+					return sl_true;
+				}
+				if (!sizeInputPassed && !sizeOutputUsed) {
+					return sl_false;
+				}
+			}
+		}
+	}
+
+	sl_bool CompressionStreamFilter::convertWrite(const void* _data, sl_uint32 size, Referable* userObject, AsyncStreamFilterOutput& output)
+	{
+		Compressor* compressor = m_compressor.get();
+		const sl_uint8* data = (const sl_uint8*)_data;
+		while (size) {
+			sl_uint32 sizeOutput;
+			void* out = output.getBuffer(sizeOutput);
+			if (!out) {
+				return sl_false;
+			}
+			sl_uint32 sizeInputPassed, sizeOutputUsed;
+			sl_int32 iRet = compressor->compress(data, size, sizeInputPassed, out, sizeOutput, sizeOutputUsed, sl_false);
+			if (iRet <= 0) {
+				// error, or the stream is already finished
+				return sl_false;
+			}
+			output.commit(sizeOutputUsed);
+			data += sizeInputPassed;
+			size -= sizeInputPassed;
+		}
+		if (m_flagFlushEachWrite) {
+			return _flush(output);
+		}
+		return sl_true;
+	}
+
+	sl_bool CompressionStreamFilter::_flush(AsyncStreamFilterOutput& output)
+	{
+		Compressor* compressor = m_compressor.get();
+		for (;;) {
+			sl_uint32 sizeOutput;
+			void* out = output.getBuffer(sizeOutput);
+			if (!out) {
+				return sl_false;
+			}
+			sl_uint32 sizeOutputUsed;
+			sl_int32 iRet = compressor->flush(out, sizeOutput, sizeOutputUsed);
+			if (iRet < 0) {
+				return sl_false;
+			}
+			output.commit(sizeOutputUsed);
+			if (!iRet) {
+				return sl_true;
+			}
+		}
+	}
+
+}
@@ -0,0 +1,1155 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/crypto/lz4.h"
+
+#include "slib/core/mio.h"
+#include "slib/core/math.h"
+#include "slib/core/scoped.h"
+
+#define PRIV_LZ4_MAGIC 0x184D2204
+#define PRIV_LZ4_SKIPPABLE_MAGIC 0x184D2A50
+#define PRIV_LZ4_MIN_MATCH 4
+#define PRIV_LZ4_LAST_LITERALS 5
+#define PRIV_LZ4_MF_LIMIT 12
+#define PRIV_LZ4_MAX_DISTANCE 65535
+#define PRIV_LZ4_HASH_LOG 14
+#define PRIV_LZ4_HC_HASH_LOG 15
+#define PRIV_LZ4_HC_CHAIN_SIZE 0x10000
+#define PRIV_LZ4_SKIP_TRIGGER 6
+#define PRIV_LZ4_HISTORY_SIZE 0x10000
+
+#define PRIV_LZ4_FLAG_VERSION 0x40
+#define PRIV_LZ4_FLAG_BLOCK_INDEPENDENCE 0x20
+#define PRIV_LZ4_FLAG_BLOCK_CHECKSUM 0x10
+#define PRIV_LZ4_FLAG_CONTENT_SIZE 0x08
+#define PRIV_LZ4_FLAG_CONTENT_CHECKSUM 0x04
+#define PRIV_LZ4_FLAG_DICT_ID 0x01
+#define PRIV_LZ4_BLOCK_UNCOMPRESSED 0x80000000
+
+namespace slib
+{
+
+	SLIB_INLINE static sl_uint32 _priv_LZ4_hash(sl_uint32 v, sl_uint32 bits)
+	{
+		return (v * 2654435761U) >> (32 - bits);
+	}
+
+	SLIB_INLINE static void _priv_LZ4_copy8(void* dst, const void* src)
+	{
+		MIO::writeUint64LE(dst, MIO::readUint64LE(src));
+	}
+
+	SLIB_INLINE static sl_size _priv_LZ4_count(const sl_uint8* p, const sl_uint8* match, const sl_uint8* limit)
+	{
+		const sl_uint8* start = p;
+		while (p + 8 <= limit) {
+			sl_uint64 diff = MIO::readUint64LE(p) ^ MIO::readUint64LE(match);
+			if (diff) {
+				return (p - start) + (Math::getLeastSignificantBits64(diff) >> 3);
+			}
+			p += 8;
+			match += 8;
+		}
+		while (p < limit && *p == *match) {
+			p++;
+			match++;
+		}
+		return p - start;
+	}
+
+	SLIB_INLINE static void _priv_LZ4_writeLength(sl_uint8*& op, sl_size n)
+	{
+		while (n >= 255) {
+			*(op++) = 255;
+			n -= 255;
+		}
+		*(op++) = (sl_uint8)n;
+	}
+
+	// literals are followed by at least 8 readable bytes (the match)
+	static sl_bool _priv_LZ4_writeSequence(sl_uint8*& op, sl_uint8* oend, const sl_uint8* literals, sl_size nLiterals, sl_size offset, sl_size lenMatch)
+	{
+		if ((sl_size)(oend - op) < nLiterals + (nLiterals + lenMatch) / 255 + 13) {
+			return sl_false;
+		}
+		sl_uint8* token = op++;
+		if (nLiterals >= 15) {
+			*token = 15 << 4;
+			_priv_LZ4_writeLength(op, nLiterals - 15);
+		} else {
+			*token = (sl_uint8)(nLiterals << 4);
+		}
+		for (sl_size i = 0; i < nLiterals; i += 8) {
+			_priv_LZ4_copy8(op + i, literals + i);
+		}
+		op += nLiterals;
+		MIO::writeUint16LE(op, (sl_uint16)offset);
+		op += 2;
+		lenMatch -= PRIV_LZ4_MIN_MATCH;
+		if (lenMatch >= 15) {
+			*token |= 15;
+			_priv_LZ4_writeLength(op, lenMatch - 15);
+		} else {
+			*token |= (sl_uint8)lenMatch;
+		}
+		return sl_true;
+	}
+
+	static sl_bool _priv_LZ4_writeLastLiterals(sl_uint8*& op, sl_uint8* oend, const sl_uint8* literals, sl_size nLiterals)
+	{
+		if ((sl_size)(oend - op) < 1 + nLiterals + (nLiterals + 240) / 255) {
+			return sl_false;
+		}
+		if (nLiterals >= 15) {
+			*(op++) = 15 << 4;
+			_priv_LZ4_writeLength(op, nLiterals - 15);
+		} else {
+			*(op++) = (sl_uint8)(nLiterals << 4);
+		}
+		Base::copyMemory(op, literals, nLiterals);
+		op += nLiterals;
+		return sl_true;
+	}
+
+	/*
+		Single probe hash table. Entries are `base + position`, so the table can be reused
+		for next blocks by advancing `base` instead of clearing it.
+	*/
+	static sl_size _priv_LZ4_compressFast(const sl_uint8* src, sl_size size, sl_uint8* dst, sl_size sizeDst, sl_uint32* table, sl_uint32 hashLog, sl_uint32 base)
+	{
+		sl_uint8* op = dst;
+		sl_uint8* oend = dst + sizeDst;
+		const sl_uint8* ip = src;
+		const sl_uint8* anchor = src;
+		const sl_uint8* iend = src + size;
+		if (size > PRIV_LZ4_MF_LIMIT) {
+			const sl_uint8* mflimit = iend - PRIV_LZ4_MF_LIMIT;
+			const sl_uint8* matchlimit = iend - PRIV_LZ4_LAST_LITERALS;
+			table[_priv_LZ4_hash(MIO::readUint32LE(ip), hashLog)] = base;
+			ip++;
+			for (;;) {
+				const sl_uint8* match;
+				sl_uint32 nSearch = 1 << PRIV_LZ4_SKIP_TRIGGER;
+				for (;;) {
+					if (ip > mflimit) {
+						goto last_literals;
+					}
+					sl_uint32 seq = MIO::readUint32LE(ip);
+					sl_uint32 h = _priv_LZ4_hash(seq, hashLog);
+					sl_uint32 ref = table[h];
+					sl_uint32 pos = (sl_uint32)(ip - src);
+					table[h] = base + pos;
+					if (ref >= base) {
+						ref -= base;
+						if (pos - ref <= PRIV_LZ4_MAX_DISTANCE) {
+							match = src + ref;
+							if (MIO::readUint32LE(match) == seq) {
+								break;
+							}
+						}
+					}
+					ip += nSearch >> PRIV_LZ4_SKIP_TRIGGER;
+					nSearch++;
+				}
+				while (ip > anchor && match > src && ip[-1] == match[-1]) {
+					ip--;
+					match--;
+				}
+				sl_size len = PRIV_LZ4_MIN_MATCH + _priv_LZ4_count(ip + PRIV_LZ4_MIN_MATCH, match + PRIV_LZ4_MIN_MATCH, matchlimit);
+				if (!(_priv_LZ4_writeSequence(op, oend, anchor, ip - anchor, ip - match, len))) {
+					return 0;
+				}
+				ip += len;
+				anchor = ip;
+				if (ip > mflimit) {
+					break;
+				}
+				table[_priv_LZ4_hash(MIO::readUint32LE(ip - 2), hashLog)] = base + (sl_uint32)(ip - 2 - src);
+			}
+		}
+	last_literals:
+		if (!(_priv_LZ4_writeLastLiterals(op, oend, anchor, iend - anchor))) {
+			return 0;
+		}
+		return op - dst;
+	}
+
+	/*
+		Hash chain search: `head` entries are `base + position + 1`,
+		`chain` keeps the distance to the previous position with same hash.
+	*/
+	static sl_size _priv_LZ4_compressChain(const sl_uint8* src, sl_size size, sl_uint8* dst, sl_size sizeDst, sl_uint32* head, sl_uint16* chain, sl_uint32 base, sl_uint32 depth)
+	{
+		sl_uint8* op = dst;
+		sl_uint8* oend = dst + sizeDst;
+		const sl_uint8* ip = src;
+		const sl_uint8* anchor = src;
+		const sl_uint8* iend = src + size;
+		if (size > PRIV_LZ4_MF_LIMIT) {
+			const sl_uint8* mflimit = iend - PRIV_LZ4_MF_LIMIT;
+			const sl_uint8* matchlimit = iend - PRIV_LZ4_LAST_LITERALS;
+			sl_uint32 posInsert = 0;
+			while (ip <= mflimit) {
+				sl_uint32 pos = (sl_uint32)(ip - src);
+				while (posInsert <= pos) {
+					sl_uint32 h = _priv_LZ4_hash(MIO::readUint32LE(src + posInsert), PRIV_LZ4_HC_HASH_LOG);
+					sl_uint32 prev = head[h];
+					sl_uint32 delta = PRIV_LZ4_MAX_DISTANCE;
+					if (prev > base && posInsert - (prev - base - 1) < PRIV_LZ4_MAX_DISTANCE) {
+						delta = posInsert - (prev - base - 1);
+					}
+					chain[posInsert & (PRIV_LZ4_HC_CHAIN_SIZE - 1)] = (sl_uint16)delta;
+					head[h] = base + posInsert + 1;
+					posInsert++;
+				}
+				// the first candidate is the position itself, follow its chain
+				sl_size lenBest = 0;
+				const sl_uint8* matchBest = sl_null;
+				sl_uint32 cand = pos;
+				sl_size lenLimit = matchlimit - ip;
+				for (sl_uint32 i = 0; i < depth; i++) {
+					sl_uint32 delta = chain[cand & (PRIV_LZ4_HC_CHAIN_SIZE - 1)];
+					if (delta >= PRIV_LZ4_MAX_DISTANCE || delta > cand) {
+						break;
+					}
+					cand -= delta;
+					if (pos - cand > PRIV_LZ4_MAX_DISTANCE) {
+						break;
+					}
+					const sl_uint8* match = src + cand;
+					if (match[lenBest] == ip[lenBest] && MIO::readUint32LE(match) == MIO::readUint32LE(ip)) {
+						sl_size len = PRIV_LZ4_MIN_MATCH + _priv_LZ4_count(ip + PRIV_LZ4_MIN_MATCH, match + PRIV_LZ4_MIN_MATCH, matchlimit);
+						if (len > lenBest) {
+							lenBest = len;
+							matchBest = match;
+							if (len >= lenLimit) {
+								break;
+							}
+						}
+					}
+				}
+				if (lenBest < PRIV_LZ4_MIN_MATCH) {
+					ip++;
+					continue;
+				}
+				while (ip > anchor && matchBest > src && ip[-1] == matchBest[-1]) {
+					ip--;
+					matchBest--;
+					lenBest++;
+				}
+				if (!(_priv_LZ4_writeSequence(op, oend, anchor, ip - anchor, ip - matchBest, lenBest))) {
+					return 0;
+				}
+				ip += lenBest;
+				anchor = ip;
+			}
+		}
+		if (!(_priv_LZ4_writeLastLiterals(op, oend, anchor, iend - anchor))) {
+			return 0;
+		}
+		return op - dst;
+	}
+
+	// `low`: lowest address which the matches can refer (start of the history)
+	static sl_reg _priv_LZ4_decompressBlock(const sl_uint8* src, sl_size sizeSrc, sl_uint8* dst, sl_size sizeDst, const sl_uint8* low)
+	{
+		const sl_uint8* ip = src;
+		const sl_uint8* iend = src + sizeSrc;
+		sl_uint8* op = dst;
+		sl_uint8* oend = dst + sizeDst;
+		for (;;) {
+			if (ip >= iend) {
+				return -1;
+			}
+			sl_uint32 token = *(ip++);
+			sl_size len = token >> 4;
+			if (len == 15) {
+				sl_uint32 b;
+				do {
+					if (ip >= iend) {
+						return -1;
+					}
+					b = *(ip++);
+					len += b;
+				} while (b == 255);
+			}
+			sl_size nInput = iend - ip;
+			sl_size nOutput = oend - op;
+			if (nInput < len || nOutput < len) {
+				return -1;
+			}
+			if (nInput >= len + 8 && nOutput >= len + 8) {
+				for (sl_size i = 0; i < len; i += 8) {
+					_priv_LZ4_copy8(op + i, ip + i);
+				}
+			} else {
+				Base::copyMemory(op, ip, len);
+			}
+			ip += len;
+			op += len;
+			if (ip == iend) {
+				break;
+			}
+			if (iend - ip < 2) {
+				return -1;
+			}
+			sl_size offset = MIO::readUint16LE(ip);
+			ip += 2;
+			if (!offset || offset > (sl_size)(op - low)) {
+				return -1;
+			}
+			const sl_uint8* match = op - offset;
+			len = token & 15;
+			if (len == 15) {
+				sl_uint32 b;
+				do {
+					if (ip >= iend) {
+						return -1;
+					}
+					b = *(ip++);
+					len += b;
+				} while (b == 255);
+			}
+			len += PRIV_LZ4_MIN_MATCH;
+			nOutput = oend - op;
+			if (nOutput < len) {
+				return -1;
+			}
+			if (offset >= 8 && nOutput >= len + 8) {
+				for (sl_size i = 0; i < len; i += 8) {
+					_priv_LZ4_copy8(op + i, match + i);
+				}
+			} else {
+				for (sl_size i = 0; i < len; i++) {
+					op[i] = match[i];
+				}
+			}
+			op += len;
+		}
+		return op - dst;
+	}
+
+	static sl_uint32 _priv_LZ4_getHashLog(sl_size size)
+	{
+		sl_uint32 bits = Math::getMostSignificantBits((sl_uint32)(SLIB_MIN(size, (sl_size)0x10000)));
+		if (bits < 10) {
+			return 10;
+		}
+		if (bits > PRIV_LZ4_HASH_LOG) {
+			return PRIV_LZ4_HASH_LOG;
+		}
+		return bits;
+	}
+
+	static sl_uint32 _priv_LZ4_getChainDepth(sl_int32 level)
+	{
+		if (level > 12) {
+			level = 12;
+		}
+		return 1 << (level - 2);
+	}
+
+	struct _priv_LZ4_FrameInfo
+	{
+		sl_uint8 flags;
+		sl_uint32 sizeBlockMax;
+		sl_uint64 sizeContent;
+		sl_uint32 sizeHeader;
+	};
+
+	/*
+		`p` points the frame descriptor (after magic number).
+		returns the size of descriptor, 0 when more bytes are needed (`sizeHeader` is set when `size` >= 2), -1 on error
+	*/
+	static sl_reg _priv_LZ4_readFrameDescriptor(const sl_uint8* p, sl_size size, _priv_LZ4_FrameInfo& info)
+	{
+		if (size < 2) {
+			return 0;
+		}
+		sl_uint8 flags = p[0];
+		sl_uint8 bd = p[1];
+		if ((flags & 0xC0) != PRIV_LZ4_FLAG_VERSION || (flags & 0x02) || (bd & 0x8F)) {
+			return -1;
+		}
+		sl_uint32 idBlock = (bd >> 4) & 7;
+		if (idBlock < 4) {
+			return -1;
+		}
+		info.flags = flags;
+		info.sizeBlockMax = 1 << (2 * idBlock + 8);
+		info.sizeHeader = 3;
+		if (flags & PRIV_LZ4_FLAG_CONTENT_SIZE) {
+			info.sizeHeader += 8;
+		}
+		if (flags & PRIV_LZ4_FLAG_DICT_ID) {
+			info.sizeHeader += 4;
+		}
+		if (size < info.sizeHeader) {
+			return 0;
+		}
+		if ((sl_uint8)(XXHash32::get(p, info.sizeHeader - 1) >> 8) != p[info.sizeHeader - 1]) {
+			return -1;
+		}
+		if (flags & PRIV_LZ4_FLAG_DICT_ID) {
+			// external dictionaries are not supported
+			return -1;
+		}
+		if (flags & PRIV_LZ4_FLAG_CONTENT_SIZE) {
+			info.sizeContent = MIO::readUint64LE(p + 2);
+		} else {
+			info.sizeContent = 0;
+		}
+		return info.sizeHeader;
+	}
+
+
+	LZ4Compress::LZ4Compress()
+	{
+		m_flagStarted = sl_false;
+		m_flagEnded = sl_false;
+		m_level = 1;
+		m_flagContentChecksum = sl_true;
+		m_sizeBlock = 0;
+		m_sizeInput = 0;
+		m_posOutput = 0;
+		m_sizeOutput = 0;
+		m_base = 0;
+	}
+
+	LZ4Compress::~LZ4Compress()
+	{
+		abort();
+	}
+
+	sl_bool LZ4Compress::isStarted()
+	{
+		return m_flagStarted;
+	}
+
+	sl_bool LZ4Compress::start(sl_int32 level, sl_uint32 blockSize, sl_bool flagContentChecksum)
+	{
+		return _start(level, blockSize, flagContentChecksum, 0);
+	}
+
+	sl_bool LZ4Compress::_start(sl_int32 level, sl_uint32 blockSize, sl_bool flagContentChecksum, sl_uint64 sizeContent)
+	{
+		if (m_flagStarted) {
+			abort();
+		}
+		if (level < 1) {
+			level = 1;
+		}
+		sl_uint32 idBlock = 4;
+		while (idBlock < 7 && blockSize > ((sl_uint32)1 << (2 * idBlock + 8))) {
+			idBlock++;
+		}
+		sl_uint32 sizeBlock = 1 << (2 * idBlock + 8);
+		if (m_bufInput.getSize() != sizeBlock) {
+			m_bufInput = Memory::create(sizeBlock);
+			if (m_bufInput.isNull()) {
+				return sl_false;
+			}
+			m_bufOutput = Memory::create(sizeBlock + 32);
+			if (m_bufOutput.isNull()) {
+				return sl_false;
+			}
+		}
+		sl_size sizeTable;
+		if (level < 3) {
+			sizeTable = sizeof(sl_uint32) << PRIV_LZ4_HASH_LOG;
+		} else {
+			sizeTable = (sizeof(sl_uint32) << PRIV_LZ4_HC_HASH_LOG) + sizeof(sl_uint16) * PRIV_LZ4_HC_CHAIN_SIZE;
+		}
+		if (m_table.getSize() != sizeTable) {
+			m_table = Memory::create(sizeTable);
+			if (m_table.isNull()) {
+				return sl_false;
+			}
+		}
+		Base::zeroMemory(m_table.getData(), sizeTable);
+		m_base = 0;
+		m_level = level;
+		m_sizeBlock = sizeBlock;
+		m_flagContentChecksum = flagContentChecksum;
+		m_sizeInput = 0;
+		m_hash.start(0);
+
+		sl_uint8* header = (sl_uint8*)(m_bufOutput.getData());
+		MIO::writeUint32LE(header, PRIV_LZ4_MAGIC);
+		sl_uint8 flags = PRIV_LZ4_FLAG_VERSION | PRIV_LZ4_FLAG_BLOCK_INDEPENDENCE;
+		if (flagContentChecksum) {
+			flags |= PRIV_LZ4_FLAG_CONTENT_CHECKSUM;
+		}
+		if (sizeContent) {
+			flags |= PRIV_LZ4_FLAG_CONTENT_SIZE;
+		}
+		header[4] = flags;
+		header[5] = (sl_uint8)(idBlock << 4);
+		sl_uint32 n = 6;
+		if (sizeContent) {
+			MIO::writeUint64LE(header + 6, sizeContent);
+			n += 8;
+		}
+		header[n] = (sl_uint8)(XXHash32::get(header + 4, n - 4) >> 8);
+		m_posOutput = 0;
+		m_sizeOutput = n + 1;
+		m_flagEnded = sl_false;
+		m_flagStarted = sl_true;
+		return sl_true;
+	}
+
+	void LZ4Compress::_writeBlock(const void* data, sl_uint32 size)
+	{
+		sl_uint8* out = (sl_uint8*)(m_bufOutput.getData());
+		sl_size n = 0;
+		if (size > 1) {
+			if (m_base > 0x7FFFFFFF) {
+				Base::zeroMemory(m_table.getData(), m_table.getSize());
+				m_base = 0;
+			}
+			sl_uint32* table = (sl_uint32*)(m_table.getData());
+			if (m_level < 3) {
+				n = _priv_LZ4_compressFast((const sl_uint8*)data, size, out + 4, size - 1, table, PRIV_LZ4_HASH_LOG, m_base);
+			} else {
+				n = _priv_LZ4_compressChain((const sl_uint8*)data, size, out + 4, size - 1, table, (sl_uint16*)(table + ((sl_size)1 << PRIV_LZ4_HC_HASH_LOG)), m_base, _priv_LZ4_getChainDepth(m_level));
+			}
+			// skip the positions of this block and maximum distance
+			m_base += size + PRIV_LZ4_MAX_DISTANCE + 1;
+		}
+		if (n) {
+			MIO::writeUint32LE(out, (sl_uint32)n);
+		} else {
+			MIO::writeUint32LE(out, size | PRIV_LZ4_BLOCK_UNCOMPRESSED);
+			Base::copyMemory(out + 4, data, size);
+			n = size;
+		}
+		if (m_flagContentChecksum) {
+			m_hash.update(data, size);
+		}
+		m_posOutput = 0;
+		m_sizeOutput = (sl_uint32)(n + 4);
+	}
+
+	sl_int32 LZ4Compress::compress(
+		const void* _input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+		void* _output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed,
+		sl_bool flagFinish)
+	{
+		sizeInputPassed = 0;
+		sizeOutputUsed = 0;
+		if (!m_flagStarted) {
+			return -1;
+		}
+		const sl_uint8* input = (const sl_uint8*)_input;
+		sl_uint8* output = (sl_uint8*)_output;
+		for (;;) {
+			if (m_posOutput < m_sizeOutput) {
+				sl_uint32 n = m_sizeOutput - m_posOutput;
+				sl_uint32 m = sizeOutputAvailable - sizeOutputUsed;
+				if (n > m) {
+					n = m;
+				}
+				Base::copyMemory(output + sizeOutputUsed, (sl_uint8*)(m_bufOutput.getData()) + m_posOutput, n);
+				m_posOutput += n;
+				sizeOutputUsed += n;
+				if (m_posOutput < m_sizeOutput) {
+					return 1;
+				}
+			}
+			if (m_flagEnded) {
+				abort();
+				return 0;
+			}
+			sl_uint32 nInput = sizeInputAvailable - sizeInputPassed;
+			if (nInput) {
+				if (!m_sizeInput && nInput >= m_sizeBlock) {
+					// compress directly from the input
+					_writeBlock(input + sizeInputPassed, m_sizeBlock);
+					sizeInputPassed += m_sizeBlock;
+				} else {
+					sl_uint32 n = m_sizeBlock - m_sizeInput;
+					if (n > nInput) {
+						n = nInput;
+					}
+					Base::copyMemory((sl_uint8*)(m_bufInput.getData()) + m_sizeInput, input + sizeInputPassed, n);
+					m_sizeInput += n;
+					sizeInputPassed += n;
+					if (m_sizeInput == m_sizeBlock) {
+						_writeBlock(m_bufInput.getData(), m_sizeBlock);
+						m_sizeInput = 0;
+					}
+				}
+				continue;
+			}
+			if (flagFinish) {
+				if (m_sizeInput) {
+					_writeBlock(m_bufInput.getData(), m_sizeInput);
+					m_sizeInput = 0;
+				} else {
+					m_posOutput = 0;
+					m_sizeOutput = 0;
+				}
+				sl_uint8* end = (sl_uint8*)(m_bufOutput.getData()) + m_sizeOutput;
+				MIO::writeUint32LE(end, 0);
+				m_sizeOutput += 4;
+				if (m_flagContentChecksum) {
+					MIO::writeUint32LE(end + 4, m_hash.finish());
+					m_sizeOutput += 4;
+				}
+				m_flagEnded = sl_true;
+				continue;
+			}
+			return 1;
+		}
+	}
+
+	Memory LZ4Compress::compress(const void* data, sl_size size, sl_bool flagFinish)
+	{
+		return Compressor::compress(data, size, flagFinish);
+	}
+
+	sl_int32 LZ4Compress::flush(void* _output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
+	{
+		sizeOutputUsed = 0;
+		if (!m_flagStarted || m_flagEnded) {
+			return -1;
+		}
+		sl_uint8* output = (sl_uint8*)_output;
+		for (;;) {
+			if (m_posOutput < m_sizeOutput) {
+				sl_uint32 n = m_sizeOutput - m_posOutput;
+				sl_uint32 m = sizeOutputAvailable - sizeOutputUsed;
+				if (n > m) {
+					n = m;
+				}
+				Base::copyMemory(output + sizeOutputUsed, (sl_uint8*)(m_bufOutput.getData()) + m_posOutput, n);
+				m_posOutput += n;
+				sizeOutputUsed += n;
+				if (m_posOutput < m_sizeOutput) {
+					return 1;
+				}
+			}
+			if (!m_sizeInput) {
+				return 0;
+			}
+			// the partial block is written as a smaller block
+			_writeBlock(m_bufInput.getData(), m_sizeInput);
+			m_sizeInput = 0;
+		}
+	}
+
+	void LZ4Compress::abort()
+	{
+		m_flagStarted = sl_false;
+	}
+
+
+#define PRIV_LZ4_STATE_MAGIC 0
+#define PRIV_LZ4_STATE_DESCRIPTOR 1
+#define PRIV_LZ4_STATE_BLOCK_SIZE 2
+#define PRIV_LZ4_STATE_BLOCK_DATA 3
+#define PRIV_LZ4_STATE_CONTENT_CHECKSUM 4
+#define PRIV_LZ4_STATE_SKIPPABLE_SIZE 5
+#define PRIV_LZ4_STATE_SKIPPABLE_DATA 6
+#define PRIV_LZ4_STATE_END 7
+
+	LZ4Decompress::LZ4Decompress()
+	{
+		m_flagStarted = sl_false;
+		m_state = PRIV_LZ4_STATE_MAGIC;
+		m_sizeNeeded = 4;
+		m_flags = 0;
+		m_sizeBlockMax = 0;
+		m_sizeBlock = 0;
+		m_sizeInput = 0;
+		m_sizeHistory = 0;
+		m_posOutput = 0;
+		m_sizeOutput = 0;
+	}
+
+	LZ4Decompress::~LZ4Decompress()
+	{
+		abort();
+	}
+
+	sl_bool LZ4Decompress::isStarted()
+	{
+		return m_flagStarted;
+	}
+
+	sl_bool LZ4Decompress::start()
+	{
+		if (m_bufInput.isNull()) {
+			m_bufInput = Memory::create(64);
+			if (m_bufInput.isNull()) {
+				return sl_false;
+			}
+		}
+		m_state = PRIV_LZ4_STATE_MAGIC;
+		m_sizeNeeded = 4;
+		m_sizeInput = 0;
+		m_sizeHistory = 0;
+		m_posOutput = 0;
+		m_sizeOutput = 0;
+		m_flagStarted = sl_true;
+		return sl_true;
+	}
+
+	sl_bool LZ4Decompress::_processInput(const sl_uint8* data, sl_uint32 size)
+	{
+		switch (m_state) {
+			case PRIV_LZ4_STATE_MAGIC:
+				{
+					sl_uint32 magic = MIO::readUint32LE(data);
+					if (magic == PRIV_LZ4_MAGIC) {
+						m_state = PRIV_LZ4_STATE_DESCRIPTOR;
+						m_sizeNeeded = 2;
+						return sl_true;
+					}
+					if ((magic & 0xFFFFFFF0) == PRIV_LZ4_SKIPPABLE_MAGIC) {
+						m_state = PRIV_LZ4_STATE_SKIPPABLE_SIZE;
+						m_sizeNeeded = 4;
+						return sl_true;
+					}
+					return sl_false;
+				}
+			case PRIV_LZ4_STATE_DESCRIPTOR:
+				{
+					// the partial descriptor is kept at the front of input buffer
+					_priv_LZ4_FrameInfo info;
+					sl_reg n = _priv_LZ4_readFrameDescriptor(data, size, info);
+					if (n < 0) {
+						return sl_false;
+					}
+					if (!n) {
+						m_sizeNeeded = info.sizeHeader;
+						if (data != m_bufInput.getData()) {
+							Base::copyMemory(m_bufInput.getData(), data, size);
+						}
+						m_sizeInput = size;
+						return sl_true;
+					}
+					m_flags = info.flags;
+					m_sizeBlockMax = info.sizeBlockMax;
+					sl_uint32 sizeWindow = m_sizeBlockMax;
+					if (!(m_flags & PRIV_LZ4_FLAG_BLOCK_INDEPENDENCE)) {
+						sizeWindow += PRIV_LZ4_HISTORY_SIZE;
+					}
+					if (m_window.getSize() < sizeWindow) {
+						m_window = Memory::create(sizeWindow);
+						if (m_window.isNull()) {
+							return sl_false;
+						}
+					}
+					m_sizeHistory = 0;
+					m_posOutput = 0;
+					m_sizeOutput = 0;
+					m_hash.start(0);
+					m_state = PRIV_LZ4_STATE_BLOCK_SIZE;
+					m_sizeNeeded = 4;
+					return sl_true;
+				}
+			case PRIV_LZ4_STATE_BLOCK_SIZE:
+				{
+					sl_uint32 n = MIO::readUint32LE(data);
+					if (!n) {
+						if (m_flags & PRIV_LZ4_FLAG_CONTENT_CHECKSUM) {
+							m_state = PRIV_LZ4_STATE_CONTENT_CHECKSUM;
+							m_sizeNeeded = 4;
+						} else {
+							m_state = PRIV_LZ4_STATE_END;
+						}
+						return sl_true;
+					}
+					if ((n & ~PRIV_LZ4_BLOCK_UNCOMPRESSED) > m_sizeBlockMax) {
+						return sl_false;
+					}
+					m_sizeBlock = n;
+					m_sizeNeeded = n & ~PRIV_LZ4_BLOCK_UNCOMPRESSED;
+					if (m_flags & PRIV_LZ4_FLAG_BLOCK_CHECKSUM) {
+						m_sizeNeeded += 4;
+					}
+					m_state = PRIV_LZ4_STATE_BLOCK_DATA;
+					return sl_true;
+				}
+			case PRIV_LZ4_STATE_BLOCK_DATA:
+				{
+					sl_uint32 sizeBlock = m_sizeBlock & ~PRIV_LZ4_BLOCK_UNCOMPRESSED;
+					if (m_flags & PRIV_LZ4_FLAG_BLOCK_CHECKSUM) {
+						if (XXHash32::get(data, sizeBlock) != MIO::readUint32LE(data + sizeBlock)) {
+							return sl_false;
+						}
+					}
+					sl_uint8* window = (sl_uint8*)(m_window.getData());
+					if (m_flags & PRIV_LZ4_FLAG_BLOCK_INDEPENDENCE) {
+						m_sizeHistory = 0;
+					} else {
+						sl_uint32 n = SLIB_MIN(m_sizeOutput, PRIV_LZ4_HISTORY_SIZE);
+						if (n && n < m_sizeOutput) {
+							Base::moveMemory(window, window + m_sizeOutput - n, n);
+						}
+						m_sizeHistory = n;
+					}
+					sl_uint8* dst = window + m_sizeHistory;
+					sl_reg n;
+					if (m_sizeBlock & PRIV_LZ4_BLOCK_UNCOMPRESSED) {
+						Base::copyMemory(dst, data, sizeBlock);
+						n = sizeBlock;
+					} else {
+						n = _priv_LZ4_decompressBlock(data, sizeBlock, dst, m_sizeBlockMax, window);
+						if (n < 0) {
+							return sl_false;
+						}
+					}
+					if (m_flags & PRIV_LZ4_FLAG_CONTENT_CHECKSUM) {
+						m_hash.update(dst, n);
+					}
+					m_posOutput = m_sizeHistory;
+					m_sizeOutput = m_sizeHistory + (sl_uint32)n;
+					m_state = PRIV_LZ4_STATE_BLOCK_SIZE;
+					m_sizeNeeded = 4;
+					return sl_true;
+				}
+			case PRIV_LZ4_STATE_CONTENT_CHECKSUM:
+				{
+					if (m_hash.finish() != MIO::readUint32LE(data)) {
+						return sl_false;
+					}
+					m_state = PRIV_LZ4_STATE_END;
+					return sl_true;
+				}
+			case PRIV_LZ4_STATE_SKIPPABLE_SIZE:
+				{
+					m_sizeNeeded = MIO::readUint32LE(data);
+					if (m_sizeNeeded) {
+						m_state = PRIV_LZ4_STATE_SKIPPABLE_DATA;
+					} else {
+						m_state = PRIV_LZ4_STATE_MAGIC;
+						m_sizeNeeded = 4;
+					}
+					return sl_true;
+				}
+		}
+		return sl_false;
+	}
+
+	sl_int32 LZ4Decompress::decompress(
+		const void* _input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+		void* _output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
+	{
+		sizeInputPassed = 0;
+		sizeOutputUsed = 0;
+		if (!m_flagStarted) {
+			return -1;
+		}
+		const sl_uint8* input = (const sl_uint8*)_input;
+		sl_uint8* output = (sl_uint8*)_output;
+		for (;;) {
+			if (m_posOutput < m_sizeOutput) {
+				sl_uint32 n = m_sizeOutput - m_posOutput;
+				sl_uint32 m = sizeOutputAvailable - sizeOutputUsed;
+				if (n > m) {
+					n = m;
+				}
+				Base::copyMemory(output + sizeOutputUsed, (sl_uint8*)(m_window.getData()) + m_posOutput, n);
+				m_posOutput += n;
+				sizeOutputUsed += n;
+				if (m_posOutput < m_sizeOutput) {
+					return 1;
+				}
+			}
+			if (m_state == PRIV_LZ4_STATE_END) {
+				abort();
+				return 0;
+			}
+			sl_uint32 nInput = sizeInputAvailable - sizeInputPassed;
+			if (!nInput) {
+				return 1;
+			}
+			if (m_state == PRIV_LZ4_STATE_SKIPPABLE_DATA) {
+				sl_uint32 n = SLIB_MIN(nInput, m_sizeNeeded);
+				sizeInputPassed += n;
+				m_sizeNeeded -= n;
+				if (!m_sizeNeeded) {
+					m_state = PRIV_LZ4_STATE_MAGIC;
+					m_sizeNeeded = 4;
+				}
+				continue;
+			}
+			const sl_uint8* data;
+			sl_uint32 size = m_sizeNeeded;
+			if (!m_sizeInput && nInput >= size) {
+				data = input + sizeInputPassed;
+				sizeInputPassed += size;
+			} else {
+				if (m_bufInput.getSize() < size) {
+					Memory mem = Memory::create(SLIB_MAX(size, m_sizeBlockMax + 4));
+					if (mem.isNull()) {
+						abort();
+						return -1;
+					}
+					Base::copyMemory(mem.getData(), m_bufInput.getData(), m_sizeInput);
+					m_bufInput = mem;
+				}
+				sl_uint32 n = size - m_sizeInput;
+				if (n > nInput) {
+					n = nInput;
+				}
+				Base::copyMemory((sl_uint8*)(m_bufInput.getData()) + m_sizeInput, input + sizeInputPassed, n);
+				m_sizeInput += n;
+				sizeInputPassed += n;
+				if (m_sizeInput < size) {
+					return 1;
+				}
+				data = (sl_uint8*)(m_bufInput.getData());
+				m_sizeInput = 0;
+			}
+			if (!(_processInput(data, size))) {
+				abort();
+				return -1;
+			}
+		}
+	}
+
+	Memory LZ4Decompress::decompress(const void* data, sl_size size)
+	{
+		return Decompressor::decompress(data, size);
+	}
+
+	void LZ4Decompress::abort()
+	{
+		m_flagStarted = sl_false;
+	}
+
+
+	sl_size LZ4::getCompressBound(sl_size size)
+	{
+		return size + size / 255 + 16;
+	}
+
+	sl_size LZ4::compressBlock(const void* input, sl_size size, void* output, sl_size sizeOutput, sl_int32 level)
+	{
+		if (size > 0x7E000000) {
+			return 0;
+		}
+		if (level < 3) {
+			sl_uint32 hashLog = _priv_LZ4_getHashLog(size);
+			SLIB_SCOPED_BUFFER(sl_uint32, 4096, table, (sl_size)1 << hashLog)
+			if (!table) {
+				return 0;
+			}
+			Base::zeroMemory(table, sizeof(sl_uint32) << hashLog);
+			return _priv_LZ4_compressFast((const sl_uint8*)input, size, (sl_uint8*)output, sizeOutput, table, hashLog, 0);
+		} else {
+			sl_size sizeTable = (sizeof(sl_uint32) << PRIV_LZ4_HC_HASH_LOG) + sizeof(sl_uint16) * PRIV_LZ4_HC_CHAIN_SIZE;
+			Memory mem = Memory::create(sizeTable);
+			if (mem.isNull()) {
+				return 0;
+			}
+			sl_uint32* head = (sl_uint32*)(mem.getData());
+			Base::zeroMemory(head, sizeTable);
+			return _priv_LZ4_compressChain((const sl_uint8*)input, size, (sl_uint8*)output, sizeOutput, head, (sl_uint16*)(head + ((sl_size)1 << PRIV_LZ4_HC_HASH_LOG)), 0, _priv_LZ4_getChainDepth(level));
+		}
+	}
+
+	sl_reg LZ4::decompressBlock(const void* input, sl_size size, void* output, sl_size sizeOutput)
+	{
+		return _priv_LZ4_decompressBlock((const sl_uint8*)input, size, (sl_uint8*)output, sizeOutput, (sl_uint8*)output);
+	}
+
+	Memory LZ4::compress(const void* data, sl_size size, sl_int32 level)
+	{
+		sl_uint32 sizeBlock;
+		if (size > 0x100000) {
+			sizeBlock = 0x400000;
+		} else if (size > 0x40000) {
+			sizeBlock = 0x100000;
+		} else if (size > 0x10000) {
+			sizeBlock = 0x40000;
+		} else {
+			sizeBlock = 0x10000;
+		}
+		LZ4Compress lz4;
+		if (!(lz4._start(level, sizeBlock, sl_true, size))) {
+			return sl_null;
+		}
+		sl_size sizeOutput = 27 + size + (size / sizeBlock + 1) * 4;
+		Memory mem = Memory::create(sizeOutput);
+		if (mem.isNull()) {
+			return sl_null;
+		}
+		const sl_uint8* input = (const sl_uint8*)data;
+		sl_uint8* output = (sl_uint8*)(mem.getData());
+		sl_size sizeWritten = 0;
+		for (;;) {
+			sl_uint32 nInput = (sl_uint32)(SLIB_MIN(size, (sl_size)0x40000000));
+			sl_uint32 nOutput = (sl_uint32)(SLIB_MIN(sizeOutput - sizeWritten, (sl_size)0x40000000));
+			sl_uint32 nInputPassed, nOutputUsed;
+			sl_int32 iRet = lz4.compress(input, nInput, nInputPassed, output + sizeWritten, nOutput, nOutputUsed, nInput == size);
+			if (iRet < 0) {
+				return sl_null;
+			}
+			input += nInputPassed;
+			size -= nInputPassed;
+			sizeWritten += nOutputUsed;
+			if (!iRet) {
+				break;
+			}
+			if (!nInputPassed && !nOutputUsed) {
+				return sl_null;
+			}
+		}
+		return mem.sub(0, sizeWritten);
+	}
+
+	Memory LZ4::compress(const Memory& data, sl_int32 level)
+	{
+		return compress(data.getData(), data.getSize(), level);
+	}
+
+	Memory LZ4::decompress(const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		const sl_uint8* end = data + size;
+		Memory mem;
+		sl_uint8* output = sl_null;
+		sl_size sizeOutput = 0;
+		sl_size capacity = 0;
+		while (data < end) {
+			if (end - data < 4) {
+				return sl_null;
+			}
+			sl_uint32 magic = MIO::readUint32LE(data);
+			data += 4;
+			if ((magic & 0xFFFFFFF0) == PRIV_LZ4_SKIPPABLE_MAGIC) {
+				if (end - data < 4) {
+					return sl_null;
+				}
+				sl_uint32 n = MIO::readUint32LE(data);
+				data += 4;
+				if ((sl_size)(end - data) < n) {
+					return sl_null;
+				}
+				data += n;
+				continue;
+			}
+			if (magic != PRIV_LZ4_MAGIC) {
+				return sl_null;
+			}
+			_priv_LZ4_FrameInfo info;
+			sl_reg n = _priv_LZ4_readFrameDescriptor(data, end - data, info);
+			if (n <= 0) {
+				return sl_null;
+			}
+			data += n;
+			sl_size posFrame = sizeOutput;
+			if (info.sizeContent && sizeOutput + info.sizeContent > capacity) {
+				if (info.sizeContent > (sl_uint64)(SLIB_SIZE_MAX >> 1)) {
+					return sl_null;
+				}
+				capacity = sizeOutput + (sl_size)(info.sizeContent);
+			}
+			XXHash32 hash;
+			for (;;) {
+				if (end - data < 4) {
+					return sl_null;
+				}
+				sl_uint32 sizeBlock = MIO::readUint32LE(data);
+				data += 4;
+				if (!sizeBlock) {
+					break;
+				}
+				sl_uint32 sizeData = sizeBlock & ~PRIV_LZ4_BLOCK_UNCOMPRESSED;
+				if (sizeData > info.sizeBlockMax || (sl_size)(end - data) < sizeData) {
+					return sl_null;
+				}
+				if (info.flags & PRIV_LZ4_FLAG_BLOCK_CHECKSUM) {
+					if ((sl_size)(end - data) < sizeData + 4) {
+						return sl_null;
+					}
+					if (XXHash32::get(data, sizeData) != MIO::readUint32LE(data + sizeData)) {
+						return sl_null;
+					}
+				}
+				if (mem.isNull() || sizeOutput + info.sizeBlockMax > capacity) {
+					sl_size c = SLIB_MAX(capacity, sizeOutput + info.sizeBlockMax);
+					if (mem.isNotNull()) {
+						c = SLIB_MAX(c, capacity * 2);
+					}
+					Memory memNew = Memory::create(c);
+					if (memNew.isNull()) {
+						return sl_null;
+					}
+					if (sizeOutput) {
+						Base::copyMemory(memNew.getData(), output, sizeOutput);
+					}
+					mem = memNew;
+					output = (sl_uint8*)(mem.getData());
+					capacity = c;
+				}
+				sl_uint8* dst = output + sizeOutput;
+				sl_reg m;
+				if (sizeBlock & PRIV_LZ4_BLOCK_UNCOMPRESSED) {
+					Base::copyMemory(dst, data, sizeData);
+					m = sizeData;
+				} else {
+					const sl_uint8* low = (info.flags & PRIV_LZ4_FLAG_BLOCK_INDEPENDENCE) ? dst : output + posFrame;
+					m = _priv_LZ4_decompressBlock(data, sizeData, dst, info.sizeBlockMax, low);
+					if (m < 0) {
+						return sl_null;
+					}
+				}
+				if (info.flags & PRIV_LZ4_FLAG_CONTENT_CHECKSUM) {
+					hash.update(dst, m);
+				}
+				sizeOutput += m;
+				data += sizeData;
+				if (info.flags & PRIV_LZ4_FLAG_BLOCK_CHECKSUM) {
+					data += 4;
+				}
+			}
+			if (info.flags & PRIV_LZ4_FLAG_CONTENT_CHECKSUM) {
+				if (end - data < 4) {
+					return sl_null;
+				}
+				if (hash.finish() != MIO::readUint32LE(data)) {
+					return sl_null;
+				}
+				data += 4;
+			}
+			if (info.sizeContent && info.sizeContent != sizeOutput - posFrame) {
+				return sl_null;
+			}
+		}
+		if (sizeOutput == capacity) {
+			return mem;
+		}
+		return mem.sub(0, sizeOutput);
+	}
+
+	Memory LZ4::decompress(const Memory& data)
+	{
+		return decompress(data.getData(), data.getSize());
+	}
+
+}
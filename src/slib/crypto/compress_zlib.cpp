@@ -22,11 +22,19 @@
 
 #include "slib/crypto/zlib.h"
 
+#include "slib/crypto/checksum.h"
+#include "slib/core/event.h"
+#include "slib/core/system.h"
+#include "slib/core/mio.h"
+
 #include "zlib/zlib.h"
 
 #define STREAM ((z_stream*)(this->m_stream))
 #define GZIP_HEADER ((gz_header*)(this->m_gzipHeader))
 
+#define PRIV_PARALLEL_DICTIONARY_SIZE 0x8000
+#define PRIV_PARALLEL_WAIT_SLICE 10
+
 namespace slib
 {
 
@@ -38,6 +46,357 @@ namespace slib
 	{
 	}
 
+	ZlibParallelParam::ZlibParallelParam()
+	{
+		threadsCount = 0;
+		blockSize = 0x20000;
+		maxPendingBlocks = 0;
+	}
+
+	ZlibParallelParam::~ZlibParallelParam()
+	{
+	}
+
+
+	class _priv_ZlibParallelBlock : public Referable
+	{
+	public:
+		Memory input;
+		sl_uint32 sizeInput;
+		Memory dictionary;
+		sl_int32 level;
+		sl_bool flagLast;
+
+		Memory output;
+		sl_uint32 crc;
+		sl_bool flagError;
+		Ref<Event> event;
+		sl_int32 flagClaimed;
+
+	public:
+		// runs only once, on a worker or on the caller, whichever claims the block first
+		void run()
+		{
+			if (!(Base::interlockedCompareExchange32(&flagClaimed, 1, 0))) {
+				return;
+			}
+			flagError = sl_true;
+			z_stream stream;
+			Base::zeroMemory(&stream, sizeof(stream));
+			if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+				sl_bool flagSuccess = sl_true;
+				if (dictionary.isNotNull()) {
+					flagSuccess = deflateSetDictionary(&stream, (Bytef*)(dictionary.getData()), (uInt)(dictionary.getSize())) == Z_OK;
+				}
+				if (flagSuccess) {
+					// room for the sync flush marker which is not counted by deflateBound()
+					sl_uint32 sizeOutput = (sl_uint32)(deflateBound(&stream, sizeInput)) + 64;
+					Memory mem = Memory::create(sizeOutput);
+					if (mem.isNotNull()) {
+						stream.next_in = (Bytef*)(input.getData());
+						stream.avail_in = sizeInput;
+						stream.next_out = (Bytef*)(mem.getData());
+						stream.avail_out = sizeOutput;
+						// Non-last blocks end on a byte boundary (empty stored block), so that they can be concatenated
+						int iRet = deflate(&stream, flagLast ? Z_FINISH : Z_SYNC_FLUSH);
+						if (flagLast) {
+							flagSuccess = iRet == Z_STREAM_END;
+						} else {
+							flagSuccess = iRet == Z_OK && !(stream.avail_in) && stream.avail_out;
+						}
+						if (flagSuccess) {
+							output = mem.sub(0, sizeOutput - stream.avail_out);
+							crc = CRC32::get(input.getData(), sizeInput);
+							flagError = sl_false;
+						}
+					}
+				}
+				deflateEnd(&stream);
+			}
+			input.setNull();
+			dictionary.setNull();
+			event->set();
+		}
+
+		// the waits are bounded: the block runs on the caller if no worker of the pool has taken it yet
+		sl_bool join()
+		{
+			for (;;) {
+				if (event->wait(PRIV_PARALLEL_WAIT_SLICE)) {
+					return sl_true;
+				}
+				run();
+				if (Thread::isStoppingCurrent()) {
+					return sl_false;
+				}
+			}
+		}
+
+		void cancel()
+		{
+			if (Base::interlockedCompareExchange32(&flagClaimed, 1, 0)) {
+				flagError = sl_true;
+				input.setNull();
+				dictionary.setNull();
+				event->set();
+			} else {
+				// `Event::wait()` returns at once on a stopping thread, but the worker still refers to the input
+				while (!(event->wait(PRIV_PARALLEL_WAIT_SLICE))) {
+					System::yield();
+				}
+			}
+		}
+
+	};
+
+	class _priv_ZlibParallelCompress : public Referable
+	{
+	public:
+		Ref<ThreadPool> m_pool;
+		sl_bool m_flagOwnPool;
+		sl_int32 m_level;
+		sl_uint32 m_sizeBlock;
+		sl_uint32 m_nMaxPendingBlocks;
+
+		Memory m_bufInput;
+		sl_uint32 m_sizeInput;
+		Memory m_dictionary;
+		LinkedQueue< Ref<_priv_ZlibParallelBlock> > m_blocks;
+
+		sl_uint32 m_crc;
+		sl_uint64 m_sizeTotal;
+		MemoryQueue m_output;
+		sl_bool m_flagFinishing;
+		sl_bool m_flagFinished;
+		sl_bool m_flagError;
+
+	public:
+		_priv_ZlibParallelCompress()
+		{
+			m_flagOwnPool = sl_false;
+			m_level = Z_DEFAULT_COMPRESSION;
+			m_sizeBlock = 0;
+			m_nMaxPendingBlocks = 0;
+			m_sizeInput = 0;
+			m_crc = 0;
+			m_sizeTotal = 0;
+			m_flagFinishing = sl_false;
+			m_flagFinished = sl_false;
+			m_flagError = sl_false;
+		}
+
+		~_priv_ZlibParallelCompress()
+		{
+			close();
+		}
+
+	public:
+		sl_bool start(const GzipParam& param, const ZlibParallelParam& parallel, sl_int32 level)
+		{
+			if (level < 0) {
+				level = 6;
+			}
+			if (level > 9) {
+				return sl_false;
+			}
+			m_level = level;
+			m_sizeBlock = parallel.blockSize;
+			if (m_sizeBlock < PRIV_PARALLEL_DICTIONARY_SIZE) {
+				m_sizeBlock = PRIV_PARALLEL_DICTIONARY_SIZE;
+			}
+			sl_uint32 nThreads = parallel.threadsCount;
+			if (!nThreads) {
+				nThreads = System::getProcessorsCount();
+			}
+			m_pool = parallel.threadPool;
+			if (m_pool.isNull()) {
+				m_pool = ThreadPool::create(0, nThreads);
+				if (m_pool.isNull()) {
+					return sl_false;
+				}
+				m_flagOwnPool = sl_true;
+			}
+			m_nMaxPendingBlocks = parallel.maxPendingBlocks;
+			if (!m_nMaxPendingBlocks) {
+				m_nMaxPendingBlocks = nThreads * 2;
+			}
+			// gzip header (RFC 1952)
+			sl_uint8 header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 255 };
+			if (param.fileName.isNotEmpty()) {
+				header[3] |= 8;
+			}
+			if (param.comment.isNotEmpty()) {
+				header[3] |= 16;
+			}
+			header[8] = level == 9 ? 2 : (level < 2 ? 4 : 0);
+			m_output.add(Memory::create(header, 10));
+			if (param.fileName.isNotEmpty()) {
+				m_output.add(Memory::create(param.fileName.getData(), param.fileName.getLength() + 1));
+			}
+			if (param.comment.isNotEmpty()) {
+				m_output.add(Memory::create(param.comment.getData(), param.comment.getLength() + 1));
+			}
+			return sl_true;
+		}
+
+		void close()
+		{
+			// pending blocks may refer to the caller's input
+			Ref<_priv_ZlibParallelBlock> block;
+			while (m_blocks.popFront(&block)) {
+				block->cancel();
+			}
+			if (m_flagOwnPool) {
+				m_pool->release();
+				m_flagOwnPool = sl_false;
+			}
+			m_pool.setNull();
+		}
+
+		// `flagStatic`: `data` stays valid until the stream is finished, so full blocks are not copied
+		sl_bool put(const void* _data, sl_size size, sl_bool flagFinish, sl_bool flagStatic)
+		{
+			if (m_flagError) {
+				return sl_false;
+			}
+			if (m_flagFinishing) {
+				if (size) {
+					return sl_false;
+				}
+				return collect(sl_true);
+			}
+			const sl_uint8* data = (const sl_uint8*)_data;
+			while (size) {
+				if (flagStatic && !m_sizeInput && size >= m_sizeBlock) {
+					if (!(addBlock(Memory::createStatic(data, m_sizeBlock), sl_false))) {
+						return sl_false;
+					}
+					data += m_sizeBlock;
+					size -= m_sizeBlock;
+					continue;
+				}
+				if (m_bufInput.isNull()) {
+					m_bufInput = Memory::create(m_sizeBlock);
+					if (m_bufInput.isNull()) {
+						m_flagError = sl_true;
+						return sl_false;
+					}
+					m_sizeInput = 0;
+				}
+				sl_uint32 n = m_sizeBlock - m_sizeInput;
+				if (n > size) {
+					n = (sl_uint32)size;
+				}
+				Base::copyMemory((sl_uint8*)(m_bufInput.getData()) + m_sizeInput, data, n);
+				m_sizeInput += n;
+				data += n;
+				size -= n;
+				if (m_sizeInput == m_sizeBlock) {
+					Memory mem = m_bufInput;
+					m_bufInput.setNull();
+					m_sizeInput = 0;
+					if (!(addBlock(mem, sl_false))) {
+						return sl_false;
+					}
+				}
+			}
+			if (flagFinish) {
+				Memory mem = m_bufInput.sub(0, m_sizeInput);
+				m_bufInput.setNull();
+				m_sizeInput = 0;
+				m_flagFinishing = sl_true;
+				if (!(addBlock(mem, sl_true))) {
+					return sl_false;
+				}
+			}
+			return collect(m_flagFinishing);
+		}
+
+		sl_bool addBlock(const Memory& input, sl_bool flagLast)
+		{
+			while (m_blocks.getCount() >= m_nMaxPendingBlocks) {
+				if (!(collectFront(sl_true))) {
+					return sl_false;
+				}
+			}
+			Ref<_priv_ZlibParallelBlock> block = new _priv_ZlibParallelBlock;
+			if (block.isNull()) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+			block->event = Event::create(sl_false);
+			if (block->event.isNull()) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+			sl_size size = input.getSize();
+			block->input = input;
+			block->sizeInput = (sl_uint32)size;
+			block->dictionary = m_dictionary;
+			block->level = m_level;
+			block->flagLast = flagLast;
+			block->crc = 0;
+			block->flagError = sl_false;
+			block->flagClaimed = 0;
+			if (size >= PRIV_PARALLEL_DICTIONARY_SIZE) {
+				m_dictionary = input.sub(size - PRIV_PARALLEL_DICTIONARY_SIZE);
+			} else {
+				m_dictionary.setNull();
+			}
+			m_blocks.pushBack(block);
+			if (!(m_pool->addTask(SLIB_FUNCTION_REF(_priv_ZlibParallelBlock, run, block.get())))) {
+				block->run();
+			}
+			return sl_true;
+		}
+
+		// appends the output of the front block if it is completed (or `flagWait` is set)
+		sl_bool collectFront(sl_bool flagWait)
+		{
+			Ref<_priv_ZlibParallelBlock> block;
+			if (!(m_blocks.getFrontValue(&block))) {
+				return sl_false;
+			}
+			if (flagWait) {
+				if (!(block->join())) {
+					return sl_false;
+				}
+			} else {
+				if (!(block->event->wait(0))) {
+					return sl_false;
+				}
+			}
+			m_blocks.popFront();
+			if (block->flagError) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+			sl_uint32 size = block->sizeInput;
+			m_crc = (sl_uint32)(crc32_combine(m_crc, block->crc, (z_off_t)size));
+			m_sizeTotal += size;
+			m_output.add(block->output);
+			if (block->flagLast) {
+				sl_uint8 trailer[8];
+				MIO::writeUint32LE(trailer, m_crc);
+				MIO::writeUint32LE(trailer + 4, (sl_uint32)m_sizeTotal);
+				m_output.add(Memory::create(trailer, 8));
+				m_flagFinished = sl_true;
+			}
+			return sl_true;
+		}
+
+		sl_bool collect(sl_bool flagWait)
+		{
+			while (m_blocks.isNotEmpty()) {
+				if (!(collectFront(flagWait))) {
+					break;
+				}
+			}
+			return !m_flagError;
+		}
+
+	};
+
 
 	ZlibCompress::ZlibCompress()
 	{
@@ -117,6 +476,35 @@ namespace slib
 		return startGzip(param, level);
 	}
 
+	sl_bool ZlibCompress::startParallelGzip(const GzipParam& param, const ZlibParallelParam& parallel, sl_int32 level)
+	{
+		if (m_flagStarted) {
+			abort();
+		}
+		Ref<_priv_ZlibParallelCompress> compress = new _priv_ZlibParallelCompress;
+		if (compress.isNotNull()) {
+			if (compress->start(param, parallel, level)) {
+				m_parallel = compress;
+				m_flagStarted = sl_true;
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_bool ZlibCompress::startParallelGzip(const ZlibParallelParam& parallel, sl_int32 level)
+	{
+		GzipParam param;
+		return startParallelGzip(param, parallel, level);
+	}
+
+	sl_bool ZlibCompress::startParallelGzip(sl_int32 level)
+	{
+		GzipParam param;
+		ZlibParallelParam parallel;
+		return startParallelGzip(param, parallel, level);
+	}
+
 	sl_int32 ZlibCompress::compress(
 		const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed
 		, void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed
@@ -125,9 +513,23 @@ namespace slib
 		if (!m_flagStarted) {
 			return Z_STREAM_ERROR;
 		}
-		z_stream* stream = STREAM;
 		sizeInputPassed = 0;
 		sizeOutputUsed = 0;
+		if (m_parallel.isNotNull()) {
+			_priv_ZlibParallelCompress* parallel = m_parallel.get();
+			if (!(parallel->put(input, sizeInputAvailable, flagFinish, sl_false))) {
+				abort();
+				return Z_STREAM_ERROR;
+			}
+			sizeInputPassed = sizeInputAvailable;
+			sizeOutputUsed = (sl_uint32)(parallel->m_output.pop(output, sizeOutputAvailable));
+			if (parallel->m_flagFinished && !(parallel->m_output.getSize())) {
+				abort();
+				return 0;
+			}
+			return 1;
+		}
+		z_stream* stream = STREAM;
 		stream->next_in = (Bytef*)input;
 		stream->avail_in = sizeInputAvailable;
 		stream->next_out = (Bytef*)output;
@@ -146,50 +548,68 @@ namespace slib
 		return 1;
 	}
 
-	Memory ZlibCompress::compress(const void* _data, sl_size size, sl_bool flagFinish)
+	sl_int32 ZlibCompress::flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
 	{
-		Memory ret;
-		sl_uint8* data = (sl_uint8*)_data;
-		sl_uint32 sizeChunk;
-		if (size > 16384) {
-			sizeChunk = 262144;
-		} else {
-			sizeChunk = 4096;
+		sizeOutputUsed = 0;
+		if (!m_flagStarted || m_parallel.isNotNull()) {
+			return Z_STREAM_ERROR;
+		}
+		z_stream* stream = STREAM;
+		stream->next_in = sl_null;
+		stream->avail_in = 0;
+		stream->next_out = (Bytef*)output;
+		stream->avail_out = sizeOutputAvailable;
+		int iRet = deflate(stream, Z_SYNC_FLUSH);
+		if (iRet == Z_BUF_ERROR) {
+			// no pending output
+			return 0;
+		}
+		if (iRet < 0) {
+			abort();
+			return iRet;
 		}
-		Memory memChunk = Memory::create(sizeChunk);
-		if (memChunk.isNull()) {
-			return ret;
+		sizeOutputUsed = sizeOutputAvailable - stream->avail_out;
+		if (stream->avail_out) {
+			return 0;
 		}
-		sl_uint8* chunk = (sl_uint8*)(memChunk.getData());
+		return 1;
+	}
 
-		MemoryBuffer buffer;
-		while (1) {
-			sl_uint32 sizeInput = (sl_uint32)(SLIB_MIN(size, sizeChunk));
-			sl_uint32 sizeInputPassed = 0, sizeOutputUsed = 0;
-			sl_int32 iRet = compress(data, sizeInput, sizeInputPassed, chunk, sizeChunk, sizeOutputUsed, flagFinish && sizeInput < sizeChunk);
-			if (iRet < 0) {
-				return ret;
-			}
-			if (sizeOutputUsed > 0) {
-				buffer.add(Memory::create(chunk, sizeOutputUsed));
-			}
-			data += sizeInputPassed;
-			size -= sizeInputPassed;
-			if (iRet == 0) {
-				break;
-			}
-			if (size == 0 && sizeOutputUsed == 0) {
-				break;
-			}
+	Memory ZlibCompress::compress(const void* data, sl_size size, sl_bool flagFinish)
+	{
+		if (m_parallel.isNotNull()) {
+			return _compressParallel(data, size, flagFinish, sl_false);
+		}
+		return Compressor::compress(data, size, flagFinish);
+	}
+
+	Memory ZlibCompress::_compressParallel(const void* data, sl_size size, sl_bool flagFinish, sl_bool flagStatic)
+	{
+		if (!m_flagStarted) {
+			return sl_null;
+		}
+		_priv_ZlibParallelCompress* parallel = m_parallel.get();
+		if (!(parallel->put(data, size, flagFinish, flagStatic))) {
+			abort();
+			return sl_null;
+		}
+		Memory ret = parallel->m_output.merge();
+		parallel->m_output.clear();
+		if (parallel->m_flagFinished) {
+			abort();
 		}
-		ret = buffer.merge();
 		return ret;
 	}
 
 	void ZlibCompress::abort()
 	{
 		if (m_flagStarted) {
-			deflateEnd(STREAM);
+			if (m_parallel.isNotNull()) {
+				m_parallel->close();
+				m_parallel.setNull();
+			} else {
+				deflateEnd(STREAM);
+			}
 			m_flagStarted = sl_false;
 		}
 	}
@@ -268,44 +688,9 @@ namespace slib
 		return 1;
 	}
 
-	Memory ZlibDecompress::decompress(const void* _data, sl_size size)
+	Memory ZlibDecompress::decompress(const void* data, sl_size size)
 	{
-		Memory ret;
-		sl_uint8* data = (sl_uint8*)_data;
-		sl_uint32 sizeChunk;
-		if (size > 16384) {
-			sizeChunk = 262144;
-		} else {
-			sizeChunk = 4096;
-		}
-		Memory memChunk = Memory::create(sizeChunk);
-		if (memChunk.isNull()) {
-			return ret;
-		}
-		sl_uint8* chunk = (sl_uint8*)(memChunk.getData());
-
-		MemoryBuffer buffer;
-		while (1) {
-			sl_uint32 sizeInput = (sl_uint32)(SLIB_MIN(size, sizeChunk));
-			sl_uint32 sizeInputPassed = 0, sizeOutputUsed = 0;
-			sl_int32 iRet = decompress(data, sizeInput, sizeInputPassed, chunk, sizeChunk, sizeOutputUsed);
-			if (iRet < 0) {
-				return ret;
-			}
-			if (sizeOutputUsed > 0) {
-				buffer.add(Memory::create(chunk, sizeOutputUsed));
-			}
-			data += sizeInputPassed;
-			size -= sizeInputPassed;
-			if (iRet == 0) {
-				break;
-			}
-			if (size == 0 && sizeOutputUsed == 0) {
-				break;
-			}
-		}
-		ret = buffer.merge();
-		return ret;
+		return Decompressor::decompress(data, size);
 	}
 
 	void ZlibDecompress::abort()
@@ -316,19 +701,9 @@ namespace slib
 		}
 	}
 
-	sl_uint32 Zlib::adler32(sl_uint32 adler, const void* _data, sl_size size)
+	sl_uint32 Zlib::adler32(sl_uint32 adler, const void* data, sl_size size)
 	{
-		const char* data = (const char*)_data;
-		while (size > 0) {
-			sl_uint32 n = 0x10000000;
-			if (size < n) {
-				n = (sl_uint32)size;
-			}
-			adler = (sl_uint32)(::adler32(adler, (Bytef*)data, n));
-			size -= n;
-			data += n;
-		}
-		return adler;
+		return Adler32::extend(adler, data, size);
 	}
 
 	sl_uint32 Zlib::adler32(const void* data, sl_size size)
@@ -346,19 +721,9 @@ namespace slib
 		return adler32(1, mem.getData(), mem.getSize());
 	}
 
-	sl_uint32 Zlib::crc32(sl_uint32 crc, const void* _data, sl_size size)
+	sl_uint32 Zlib::crc32(sl_uint32 crc, const void* data, sl_size size)
 	{
-		const char* data = (const char*)_data;
-		while (size > 0) {
-			sl_uint32 n = 0x10000000;
-			if (size < n) {
-				n = (sl_uint32)size;
-			}
-			crc = (sl_uint32)(::crc32(crc, (Bytef*)data, n));
-			size -= n;
-			data += n;
-		}
-		return crc;
+		return CRC32::extend(crc, data, size);
 	}
 
 	sl_uint32 Zlib::crc32(const void* data, sl_size size)
@@ -410,6 +775,22 @@ namespace slib
 		return compressGzip(param, data, size, level);
 	}
 
+	Memory Zlib::compressGzipParallel(const GzipParam& param, const ZlibParallelParam& parallel, const void* data, sl_size size, sl_int32 level)
+	{
+		ZlibCompress zlib;
+		if (zlib.startParallelGzip(param, parallel, level)) {
+			return zlib._compressParallel(data, size, sl_true, sl_true);
+		}
+		return sl_null;
+	}
+
+	Memory Zlib::compressGzipParallel(const void* data, sl_size size, sl_int32 level)
+	{
+		GzipParam param;
+		ZlibParallelParam parallel;
+		return compressGzipParallel(param, parallel, data, size, level);
+	}
+
 	Memory Zlib::decompress(const void* data, sl_size size)
 	{
 		ZlibDecompress zlib;
@@ -0,0 +1,3746 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/crypto/zstd.h"
+
+#include "slib/core/mio.h"
+#include "slib/core/math.h"
+#include "slib/core/scoped.h"
+
+#define PRIV_ZSTD_MAGIC 0xFD2FB528
+#define PRIV_ZSTD_SKIPPABLE_MAGIC 0x184D2A50
+#define PRIV_ZSTD_DICTIONARY_MAGIC 0xEC30A437
+#define PRIV_ZSTD_BLOCK_SIZE_MAX 0x20000
+#define PRIV_ZSTD_WINDOW_LOG_MIN 10
+#define PRIV_ZSTD_WINDOW_LOG_MAX 27
+#define PRIV_ZSTD_FRAME_HEADER_SIZE_MAX 14
+#define PRIV_ZSTD_WILDCOPY_LENGTH 32
+
+#define PRIV_ZSTD_BLOCK_RAW 0
+#define PRIV_ZSTD_BLOCK_RLE 1
+#define PRIV_ZSTD_BLOCK_COMPRESSED 2
+
+#define PRIV_ZSTD_LITERALS_RAW 0
+#define PRIV_ZSTD_LITERALS_RLE 1
+#define PRIV_ZSTD_LITERALS_COMPRESSED 2
+#define PRIV_ZSTD_LITERALS_TREELESS 3
+
+#define PRIV_ZSTD_MODE_PREDEFINED 0
+#define PRIV_ZSTD_MODE_RLE 1
+#define PRIV_ZSTD_MODE_COMPRESSED 2
+#define PRIV_ZSTD_MODE_REPEAT 3
+
+#define PRIV_ZSTD_HUF_LOG_MAX 11
+#define PRIV_ZSTD_HUF_WEIGHTS_LOG_MAX 6
+#define PRIV_ZSTD_FSE_LOG_MAX 9
+#define PRIV_ZSTD_LL_MAX 35
+#define PRIV_ZSTD_ML_MAX 52
+#define PRIV_ZSTD_OF_MAX 31
+#define PRIV_ZSTD_LL_LOG 9
+#define PRIV_ZSTD_ML_LOG 9
+#define PRIV_ZSTD_OF_LOG 8
+#define PRIV_ZSTD_LL_DEFAULT_LOG 6
+#define PRIV_ZSTD_ML_DEFAULT_LOG 6
+#define PRIV_ZSTD_OF_DEFAULT_LOG 5
+#define PRIV_ZSTD_OF_DEFAULT_MAX 28
+
+#define PRIV_ZSTD_BITS_UNFINISHED 0
+#define PRIV_ZSTD_BITS_END_OF_BUFFER 1
+#define PRIV_ZSTD_BITS_COMPLETED 2
+#define PRIV_ZSTD_BITS_OVERFLOW 3
+
+namespace slib
+{
+
+	static const sl_uint32 _priv_Zstd_LL_base[PRIV_ZSTD_LL_MAX + 1] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 0x80, 0x100, 0x200, 0x400, 0x800, 0x1000,
+		0x2000, 0x4000, 0x8000, 0x10000
+	};
+
+	static const sl_uint8 _priv_Zstd_LL_bits[PRIV_ZSTD_LL_MAX + 1] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+		13, 14, 15, 16
+	};
+
+	static const sl_int16 _priv_Zstd_LL_default[PRIV_ZSTD_LL_MAX + 1] = {
+		4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+		2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+		-1, -1, -1, -1
+	};
+
+	static const sl_uint32 _priv_Zstd_ML_base[PRIV_ZSTD_ML_MAX + 1] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+		19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+		35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 0x83, 0x103, 0x203, 0x403, 0x803,
+		0x1003, 0x2003, 0x4003, 0x8003, 0x10003
+	};
+
+	static const sl_uint8 _priv_Zstd_ML_bits[PRIV_ZSTD_ML_MAX + 1] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+		12, 13, 14, 15, 16
+	};
+
+	static const sl_int16 _priv_Zstd_ML_default[PRIV_ZSTD_ML_MAX + 1] = {
+		1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+		-1, -1, -1, -1, -1
+	};
+
+	static const sl_uint32 _priv_Zstd_OF_base[PRIV_ZSTD_OF_MAX + 1] = {
+		0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80,
+		0x100, 0x200, 0x400, 0x800, 0x1000, 0x2000, 0x4000, 0x8000,
+		0x10000, 0x20000, 0x40000, 0x80000, 0x100000, 0x200000, 0x400000, 0x800000,
+		0x1000000, 0x2000000, 0x4000000, 0x8000000, 0x10000000, 0x20000000, 0x40000000, 0x80000000
+	};
+
+	static const sl_uint8 _priv_Zstd_OF_bits[PRIV_ZSTD_OF_MAX + 1] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+	};
+
+	static const sl_int16 _priv_Zstd_OF_default[PRIV_ZSTD_OF_DEFAULT_MAX + 1] = {
+		1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+	};
+
+	SLIB_INLINE static sl_uint32 _priv_Zstd_highbit(sl_uint32 n)
+	{
+		return Math::getMostSignificantBits(n) - 1;
+	}
+
+	SLIB_INLINE static void _priv_Zstd_copy16(void* dst, const void* src)
+	{
+		MIO::writeUint64LE(dst, MIO::readUint64LE(src));
+		MIO::writeUint64LE((sl_uint8*)dst + 8, MIO::readUint64LE((const sl_uint8*)src + 8));
+	}
+
+	// copies by 16 bytes, may write up to 16 bytes after `dst + size`
+	SLIB_INLINE static void _priv_Zstd_wildCopy(sl_uint8* dst, const sl_uint8* src, sl_size size)
+	{
+		sl_uint8* end = dst + size;
+		do {
+			_priv_Zstd_copy16(dst, src);
+			dst += 16;
+			src += 16;
+		} while (dst < end);
+	}
+
+	SLIB_INLINE static sl_size _priv_Zstd_count(const sl_uint8* p, const sl_uint8* match, const sl_uint8* limit)
+	{
+		const sl_uint8* start = p;
+		while (p + 8 <= limit) {
+			sl_uint64 diff = MIO::readUint64LE(p) ^ MIO::readUint64LE(match);
+			if (diff) {
+				return (p - start) + (Math::getLeastSignificantBits64(diff) >> 3);
+			}
+			p += 8;
+			match += 8;
+		}
+		while (p < limit && *p == *match) {
+			p++;
+			match++;
+		}
+		return p - start;
+	}
+
+	// reads the bit-stream backward, from the last written bit (FSE and Huffman streams)
+	class _priv_ZstdBitReader
+	{
+	public:
+		sl_uint64 container;
+		sl_uint32 consumed;
+		const sl_uint8* ptr;
+		const sl_uint8* start;
+
+	public:
+		sl_bool init(const sl_uint8* src, sl_size size)
+		{
+			if (!size) {
+				return sl_false;
+			}
+			sl_uint8 last = src[size - 1];
+			if (!last) {
+				return sl_false;
+			}
+			start = src;
+			if (size >= 8) {
+				ptr = src + size - 8;
+				container = MIO::readUint64LE(ptr);
+				consumed = 8 - _priv_Zstd_highbit(last);
+			} else {
+				ptr = src;
+				container = 0;
+				for (sl_size i = 0; i < size; i++) {
+					container |= (sl_uint64)(src[i]) << (i << 3);
+				}
+				consumed = 8 - _priv_Zstd_highbit(last) + (sl_uint32)(8 - size) * 8;
+			}
+			return sl_true;
+		}
+
+		// `n` <= 56
+		SLIB_INLINE sl_uint32 look(sl_uint32 n)
+		{
+			return (sl_uint32)(((container << (consumed & 63)) >> 1) >> ((63 - n) & 63));
+		}
+
+		SLIB_INLINE void skip(sl_uint32 n)
+		{
+			consumed += n;
+		}
+
+		SLIB_INLINE sl_uint32 read(sl_uint32 n)
+		{
+			sl_uint32 v = look(n);
+			consumed += n;
+			return v;
+		}
+
+		SLIB_INLINE sl_uint32 reload()
+		{
+			if (consumed > 64) {
+				return PRIV_ZSTD_BITS_OVERFLOW;
+			}
+			if (ptr >= start + 8) {
+				ptr -= consumed >> 3;
+				consumed &= 7;
+				container = MIO::readUint64LE(ptr);
+				return PRIV_ZSTD_BITS_UNFINISHED;
+			}
+			if (ptr == start) {
+				if (consumed < 64) {
+					return PRIV_ZSTD_BITS_END_OF_BUFFER;
+				}
+				return PRIV_ZSTD_BITS_COMPLETED;
+			}
+			sl_uint32 n = consumed >> 3;
+			sl_uint32 ret = PRIV_ZSTD_BITS_UNFINISHED;
+			if (ptr - n < start) {
+				n = (sl_uint32)(ptr - start);
+				ret = PRIV_ZSTD_BITS_END_OF_BUFFER;
+			}
+			ptr -= n;
+			consumed -= n << 3;
+			container = MIO::readUint64LE(ptr);
+			return ret;
+		}
+
+		SLIB_INLINE sl_bool isFinished()
+		{
+			return ptr == start && consumed == 64;
+		}
+
+	};
+
+	// writes the bit-stream to be read backward by `_priv_ZstdBitReader`
+	class _priv_ZstdBitWriter
+	{
+	public:
+		sl_uint64 container;
+		sl_uint32 nBits;
+		sl_uint8* start;
+		sl_uint8* ptr;
+		sl_uint8* end;
+
+	public:
+		sl_bool init(sl_uint8* dst, sl_size size)
+		{
+			if (size <= 8) {
+				return sl_false;
+			}
+			container = 0;
+			nBits = 0;
+			start = dst;
+			ptr = dst;
+			end = dst + size - 8;
+			return sl_true;
+		}
+
+		// `n` <= 32, at most 56 bits between flushes
+		SLIB_INLINE void add(sl_uint32 value, sl_uint32 n)
+		{
+			container |= ((sl_uint64)value & (((sl_uint64)1 << n) - 1)) << nBits;
+			nBits += n;
+		}
+
+		SLIB_INLINE void flush()
+		{
+			sl_uint32 n = nBits >> 3;
+			MIO::writeUint64LE(ptr, container);
+			ptr += n;
+			if (ptr > end) {
+				ptr = end;
+			}
+			nBits &= 7;
+			if (n) {
+				container >>= n << 3;
+			}
+		}
+
+		// returns 0 on overflow
+		sl_size close()
+		{
+			add(1, 1);
+			flush();
+			if (ptr >= end) {
+				return 0;
+			}
+			return (ptr - start) + (nBits > 0);
+		}
+
+	};
+
+	// FSE decoding table. For sequences, the entry carries the baseline and the number of additional bits of the code
+	struct _priv_ZstdFseEntry
+	{
+		sl_uint16 nextState;
+		sl_uint8 nbAdditionalBits;
+		sl_uint8 nbBits;
+		sl_uint32 baseValue;
+	};
+
+	struct _priv_ZstdFseTable
+	{
+		sl_uint32 tableLog;
+		_priv_ZstdFseEntry entries[1 << PRIV_ZSTD_FSE_LOG_MAX];
+	};
+
+	struct _priv_ZstdHufTable
+	{
+		sl_uint32 tableLog;
+		// symbol | (nbBits << 8)
+		sl_uint16 entries[1 << PRIV_ZSTD_HUF_LOG_MAX];
+	};
+
+	// tables loaded from the dictionary
+	struct _priv_ZstdEntropy
+	{
+		_priv_ZstdHufTable huf;
+		_priv_ZstdFseTable tableLL;
+		_priv_ZstdFseTable tableOF;
+		_priv_ZstdFseTable tableML;
+	};
+
+	class _priv_ZstdBitPeeker
+	{
+	public:
+		const sl_uint8* data;
+		sl_size size;
+		sl_size pos;
+
+	public:
+		_priv_ZstdBitPeeker(const sl_uint8* _data, sl_size _size): data(_data), size(_size), pos(0) {}
+
+	public:
+		// reads 32 bits at current position, zero padded after the end
+		sl_uint32 peek()
+		{
+			sl_size k = pos >> 3;
+			sl_uint64 v = 0;
+			for (sl_uint32 i = 0; i < 5; i++) {
+				if (k + i < size) {
+					v |= (sl_uint64)(data[k + i]) << (i << 3);
+				}
+			}
+			return (sl_uint32)(v >> (pos & 7));
+		}
+
+	};
+
+	// returns the size of the table description, 0 on error. `maxSymbol` is updated to the last described symbol
+	static sl_size _priv_Zstd_readNCount(sl_int16* norm, sl_uint32& maxSymbol, sl_uint32& tableLog, sl_uint32 maxTableLog, const sl_uint8* src, sl_size size)
+	{
+		if (!size) {
+			return 0;
+		}
+		_priv_ZstdBitPeeker bits(src, size);
+		tableLog = (bits.peek() & 15) + 5;
+		if (tableLog > maxTableLog) {
+			return 0;
+		}
+		bits.pos = 4;
+		sl_int32 remaining = (1 << tableLog) + 1;
+		sl_int32 threshold = 1 << tableLog;
+		sl_uint32 nbBits = tableLog + 1;
+		sl_uint32 symbol = 0;
+		sl_bool flagPreviousZero = sl_false;
+		while (remaining > 1 && symbol <= maxSymbol) {
+			if (flagPreviousZero) {
+				sl_uint32 n = symbol;
+				while ((bits.peek() & 0xFFFF) == 0xFFFF) {
+					n += 24;
+					bits.pos += 16;
+					if (bits.pos > (size << 3)) {
+						return 0;
+					}
+				}
+				while ((bits.peek() & 3) == 3) {
+					n += 3;
+					bits.pos += 2;
+				}
+				n += bits.peek() & 3;
+				bits.pos += 2;
+				if (n > maxSymbol) {
+					return 0;
+				}
+				while (symbol < n) {
+					norm[symbol++] = 0;
+				}
+			}
+			sl_uint32 v = bits.peek();
+			sl_int32 max = (2 * threshold - 1) - remaining;
+			sl_int32 count;
+			if ((sl_int32)(v & (threshold - 1)) < max) {
+				count = (sl_int32)(v & (threshold - 1));
+				bits.pos += nbBits - 1;
+			} else {
+				count = (sl_int32)(v & (2 * threshold - 1));
+				if (count >= threshold) {
+					count -= max;
+				}
+				bits.pos += nbBits;
+			}
+			count--;
+			remaining -= count < 0 ? -count : count;
+			norm[symbol++] = (sl_int16)count;
+			flagPreviousZero = !count;
+			while (remaining < threshold) {
+				nbBits--;
+				threshold >>= 1;
+			}
+			if (bits.pos > (size << 3)) {
+				return 0;
+			}
+		}
+		if (remaining != 1 || !symbol) {
+			return 0;
+		}
+		maxSymbol = symbol - 1;
+		return (bits.pos + 7) >> 3;
+	}
+
+	static sl_bool _priv_Zstd_buildFseTable(_priv_ZstdFseTable& table, const sl_int16* norm, sl_uint32 maxSymbol, sl_uint32 tableLog, const sl_uint32* baseValues, const sl_uint8* nbAdditionalBits)
+	{
+		sl_uint32 tableSize = 1 << tableLog;
+		sl_uint32 highThreshold = tableSize - 1;
+		sl_uint16 symbolNext[PRIV_ZSTD_ML_MAX + 1];
+		sl_uint8 symbols[1 << PRIV_ZSTD_FSE_LOG_MAX];
+		sl_uint32 s;
+		for (s = 0; s <= maxSymbol; s++) {
+			if (norm[s] == -1) {
+				symbols[highThreshold--] = (sl_uint8)s;
+				symbolNext[s] = 1;
+			} else {
+				symbolNext[s] = (sl_uint16)(norm[s]);
+			}
+		}
+		sl_uint32 mask = tableSize - 1;
+		sl_uint32 step = (tableSize >> 1) + (tableSize >> 3) + 3;
+		sl_uint32 pos = 0;
+		for (s = 0; s <= maxSymbol; s++) {
+			for (sl_int32 i = 0; i < norm[s]; i++) {
+				symbols[pos] = (sl_uint8)s;
+				do {
+					pos = (pos + step) & mask;
+				} while (pos > highThreshold);
+			}
+		}
+		if (pos) {
+			return sl_false;
+		}
+		for (sl_uint32 u = 0; u < tableSize; u++) {
+			s = symbols[u];
+			sl_uint32 next = symbolNext[s]++;
+			sl_uint32 nbBits = tableLog - _priv_Zstd_highbit(next);
+			_priv_ZstdFseEntry& entry = table.entries[u];
+			entry.nbBits = (sl_uint8)nbBits;
+			entry.nextState = (sl_uint16)((next << nbBits) - tableSize);
+			if (baseValues) {
+				entry.baseValue = baseValues[s];
+				entry.nbAdditionalBits = nbAdditionalBits[s];
+			} else {
+				entry.baseValue = s;
+				entry.nbAdditionalBits = 0;
+			}
+		}
+		table.tableLog = tableLog;
+		return sl_true;
+	}
+
+	static void _priv_Zstd_buildFseTableRLE(_priv_ZstdFseTable& table, sl_uint32 symbol, const sl_uint32* baseValues, const sl_uint8* nbAdditionalBits)
+	{
+		_priv_ZstdFseEntry& entry = table.entries[0];
+		entry.nextState = 0;
+		entry.nbBits = 0;
+		if (baseValues) {
+			entry.baseValue = baseValues[symbol];
+			entry.nbAdditionalBits = nbAdditionalBits[symbol];
+		} else {
+			entry.baseValue = symbol;
+			entry.nbAdditionalBits = 0;
+		}
+		table.tableLog = 0;
+	}
+
+	// returns the number of decoded weights, 0 on error
+	static sl_uint32 _priv_Zstd_decompressHufWeights(sl_uint8* weights, sl_uint32 maxWeights, const sl_uint8* src, sl_size size)
+	{
+		sl_int16 norm[PRIV_ZSTD_HUF_LOG_MAX + 2];
+		sl_uint32 maxSymbol = PRIV_ZSTD_HUF_LOG_MAX + 1;
+		sl_uint32 tableLog;
+		sl_size n = _priv_Zstd_readNCount(norm, maxSymbol, tableLog, PRIV_ZSTD_HUF_WEIGHTS_LOG_MAX, src, size);
+		if (!n || n >= size) {
+			return 0;
+		}
+		_priv_ZstdFseTable table;
+		if (!(_priv_Zstd_buildFseTable(table, norm, maxSymbol, tableLog, sl_null, sl_null))) {
+			return 0;
+		}
+		_priv_ZstdBitReader bits;
+		if (!(bits.init(src + n, size - n))) {
+			return 0;
+		}
+		sl_uint32 state1 = bits.read(tableLog);
+		sl_uint32 state2 = bits.read(tableLog);
+		bits.reload();
+		sl_uint32 k = 0;
+		for (;;) {
+			if (k + 2 > maxWeights) {
+				return 0;
+			}
+			_priv_ZstdFseEntry* e = table.entries + state1;
+			weights[k++] = (sl_uint8)(e->baseValue);
+			state1 = e->nextState + bits.read(e->nbBits);
+			if (bits.reload() == PRIV_ZSTD_BITS_OVERFLOW) {
+				weights[k++] = (sl_uint8)(table.entries[state2].baseValue);
+				break;
+			}
+			if (k + 2 > maxWeights) {
+				return 0;
+			}
+			e = table.entries + state2;
+			weights[k++] = (sl_uint8)(e->baseValue);
+			state2 = e->nextState + bits.read(e->nbBits);
+			if (bits.reload() == PRIV_ZSTD_BITS_OVERFLOW) {
+				weights[k++] = (sl_uint8)(table.entries[state1].baseValue);
+				break;
+			}
+		}
+		return k;
+	}
+
+	// returns the size of the tree description, 0 on error
+	static sl_size _priv_Zstd_readHufTable(_priv_ZstdHufTable& table, const sl_uint8* src, sl_size size)
+	{
+		if (!size) {
+			return 0;
+		}
+		sl_uint8 weights[256];
+		sl_uint32 nWeights;
+		sl_size sizeHeader;
+		sl_uint32 header = src[0];
+		if (header >= 128) {
+			nWeights = header - 127;
+			sizeHeader = 1 + ((nWeights + 1) >> 1);
+			if (sizeHeader > size) {
+				return 0;
+			}
+			for (sl_uint32 i = 0; i < nWeights; i++) {
+				sl_uint8 b = src[1 + (i >> 1)];
+				weights[i] = (i & 1) ? (b & 15) : (b >> 4);
+			}
+		} else {
+			sizeHeader = 1 + header;
+			if (sizeHeader > size) {
+				return 0;
+			}
+			nWeights = _priv_Zstd_decompressHufWeights(weights, 255, src + 1, header);
+			if (!nWeights) {
+				return 0;
+			}
+		}
+		sl_uint32 counts[PRIV_ZSTD_HUF_LOG_MAX + 2] = {0};
+		sl_uint32 total = 0;
+		sl_uint32 i;
+		for (i = 0; i < nWeights; i++) {
+			sl_uint32 w = weights[i];
+			if (w > PRIV_ZSTD_HUF_LOG_MAX) {
+				return 0;
+			}
+			counts[w]++;
+			if (w) {
+				total += 1 << (w - 1);
+			}
+		}
+		if (!total) {
+			return 0;
+		}
+		sl_uint32 tableLog = _priv_Zstd_highbit(total) + 1;
+		if (tableLog > PRIV_ZSTD_HUF_LOG_MAX) {
+			return 0;
+		}
+		// the last weight completes the sum to the power of 2
+		sl_uint32 rest = (1 << tableLog) - total;
+		if (rest & (rest - 1)) {
+			return 0;
+		}
+		sl_uint32 lastWeight = _priv_Zstd_highbit(rest) + 1;
+		weights[nWeights] = (sl_uint8)lastWeight;
+		counts[lastWeight]++;
+		sl_uint32 nSymbols = nWeights + 1;
+		sl_uint32 rankStart[PRIV_ZSTD_HUF_LOG_MAX + 2];
+		sl_uint32 next = 0;
+		for (i = 1; i <= tableLog; i++) {
+			rankStart[i] = next;
+			next += counts[i] << (i - 1);
+		}
+		for (i = 0; i < nSymbols; i++) {
+			sl_uint32 w = weights[i];
+			if (w) {
+				sl_uint32 len = 1 << (w - 1);
+				sl_uint16 entry = (sl_uint16)(i | ((tableLog + 1 - w) << 8));
+				sl_uint16* p = table.entries + rankStart[w];
+				for (sl_uint32 k = 0; k < len; k++) {
+					p[k] = entry;
+				}
+				rankStart[w] += len;
+			}
+		}
+		table.tableLog = tableLog;
+		return sizeHeader;
+	}
+
+	SLIB_INLINE static sl_uint8 _priv_Zstd_decodeHufSymbol(const sl_uint16* table, sl_uint32 tableLog, _priv_ZstdBitReader& bits)
+	{
+		sl_uint16 e = table[bits.look(tableLog)];
+		bits.skip(e >> 8);
+		return (sl_uint8)e;
+	}
+
+	static sl_bool _priv_Zstd_decodeHufStreamTail(sl_uint8* dst, sl_uint8* end, const _priv_ZstdHufTable& table, _priv_ZstdBitReader& bits)
+	{
+		const sl_uint16* entries = table.entries;
+		sl_uint32 tableLog = table.tableLog;
+		while (dst + 4 <= end) {
+			if (bits.reload() != PRIV_ZSTD_BITS_UNFINISHED) {
+				break;
+			}
+			dst[0] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits);
+			dst[1] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits);
+			dst[2] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits);
+			dst[3] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits);
+			dst += 4;
+		}
+		while (dst < end) {
+			bits.reload();
+			*(dst++) = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits);
+		}
+		bits.reload();
+		return bits.isFinished();
+	}
+
+	static sl_bool _priv_Zstd_decodeHufStreams(sl_uint8* dst, sl_size sizeRegenerated, const sl_uint8* src, sl_size size, const _priv_ZstdHufTable& table, sl_bool flag4Streams)
+	{
+		_priv_ZstdBitReader bits;
+		if (!flag4Streams) {
+			if (!(bits.init(src, size))) {
+				return sl_false;
+			}
+			return _priv_Zstd_decodeHufStreamTail(dst, dst + sizeRegenerated, table, bits);
+		}
+		if (size < 10) {
+			return sl_false;
+		}
+		sl_size size1 = MIO::readUint16LE(src);
+		sl_size size2 = MIO::readUint16LE(src + 2);
+		sl_size size3 = MIO::readUint16LE(src + 4);
+		if (6 + size1 + size2 + size3 >= size) {
+			return sl_false;
+		}
+		sl_size size4 = size - 6 - size1 - size2 - size3;
+		sl_size sizeSegment = (sizeRegenerated + 3) >> 2;
+		if (sizeSegment * 3 > sizeRegenerated) {
+			return sl_false;
+		}
+		const sl_uint8* src1 = src + 6;
+		const sl_uint8* src2 = src1 + size1;
+		const sl_uint8* src3 = src2 + size2;
+		const sl_uint8* src4 = src3 + size3;
+		_priv_ZstdBitReader bits1, bits2, bits3, bits4;
+		if (!(bits1.init(src1, size1) && bits2.init(src2, size2) && bits3.init(src3, size3) && bits4.init(src4, size4))) {
+			return sl_false;
+		}
+		sl_uint8* dst1 = dst;
+		sl_uint8* dst2 = dst1 + sizeSegment;
+		sl_uint8* dst3 = dst2 + sizeSegment;
+		sl_uint8* dst4 = dst3 + sizeSegment;
+		sl_uint8* end = dst + sizeRegenerated;
+		const sl_uint16* entries = table.entries;
+		sl_uint32 tableLog = table.tableLog;
+		// interleaved decoding while all streams have 8 bytes ahead
+		while (dst4 + 4 <= end) {
+			if ((bits1.reload() | bits2.reload() | bits3.reload() | bits4.reload()) != PRIV_ZSTD_BITS_UNFINISHED) {
+				break;
+			}
+			for (sl_uint32 i = 0; i < 4; i++) {
+				dst1[i] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits1);
+				dst2[i] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits2);
+				dst3[i] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits3);
+				dst4[i] = _priv_Zstd_decodeHufSymbol(entries, tableLog, bits4);
+			}
+			dst1 += 4;
+			dst2 += 4;
+			dst3 += 4;
+			dst4 += 4;
+		}
+		sl_uint8* end1 = dst + sizeSegment;
+		if (dst1 > end1) {
+			return sl_false;
+		}
+		return _priv_Zstd_decodeHufStreamTail(dst1, end1, table, bits1) &&
+			_priv_Zstd_decodeHufStreamTail(dst2, end1 + sizeSegment, table, bits2) &&
+			_priv_Zstd_decodeHufStreamTail(dst3, end1 + 2 * sizeSegment, table, bits3) &&
+			_priv_Zstd_decodeHufStreamTail(dst4, end, table, bits4);
+	}
+
+	struct _priv_ZstdFseEncodeSymbol
+	{
+		sl_int32 deltaFindState;
+		sl_uint32 deltaNbBits;
+	};
+
+	struct _priv_ZstdFseEncodeTable
+	{
+		sl_uint32 tableLog;
+		sl_uint16 stateTable[1 << PRIV_ZSTD_FSE_LOG_MAX];
+		_priv_ZstdFseEncodeSymbol symbols[PRIV_ZSTD_ML_MAX + 1];
+	};
+
+	static void _priv_Zstd_buildFseEncodeTable(_priv_ZstdFseEncodeTable& table, const sl_int16* norm, sl_uint32 maxSymbol, sl_uint32 tableLog)
+	{
+		sl_uint32 tableSize = 1 << tableLog;
+		sl_uint32 highThreshold = tableSize - 1;
+		sl_uint32 cumul[PRIV_ZSTD_ML_MAX + 2];
+		sl_uint8 symbols[1 << PRIV_ZSTD_FSE_LOG_MAX];
+		sl_uint32 s;
+		cumul[0] = 0;
+		for (s = 1; s <= maxSymbol + 1; s++) {
+			if (norm[s - 1] == -1) {
+				cumul[s] = cumul[s - 1] + 1;
+				symbols[highThreshold--] = (sl_uint8)(s - 1);
+			} else {
+				cumul[s] = cumul[s - 1] + norm[s - 1];
+			}
+		}
+		sl_uint32 mask = tableSize - 1;
+		sl_uint32 step = (tableSize >> 1) + (tableSize >> 3) + 3;
+		sl_uint32 pos = 0;
+		for (s = 0; s <= maxSymbol; s++) {
+			for (sl_int32 i = 0; i < norm[s]; i++) {
+				symbols[pos] = (sl_uint8)s;
+				do {
+					pos = (pos + step) & mask;
+				} while (pos > highThreshold);
+			}
+		}
+		for (sl_uint32 u = 0; u < tableSize; u++) {
+			s = symbols[u];
+			table.stateTable[cumul[s]++] = (sl_uint16)(tableSize + u);
+		}
+		sl_int32 total = 0;
+		for (s = 0; s <= maxSymbol; s++) {
+			_priv_ZstdFseEncodeSymbol& symbol = table.symbols[s];
+			sl_int32 n = norm[s];
+			if (!n) {
+				symbol.deltaFindState = 0;
+				symbol.deltaNbBits = ((tableLog + 1) << 16) - tableSize;
+			} else if (n == -1 || n == 1) {
+				symbol.deltaNbBits = (tableLog << 16) - tableSize;
+				symbol.deltaFindState = total - 1;
+				total++;
+			} else {
+				sl_uint32 maxBitsOut = tableLog - _priv_Zstd_highbit(n - 1);
+				sl_uint32 minStatePlus = (sl_uint32)n << maxBitsOut;
+				symbol.deltaNbBits = (maxBitsOut << 16) - minStatePlus;
+				symbol.deltaFindState = total - n;
+				total += n;
+			}
+		}
+		table.tableLog = tableLog;
+	}
+
+	static void _priv_Zstd_buildFseEncodeTableRLE(_priv_ZstdFseEncodeTable& table, sl_uint32 symbol)
+	{
+		table.tableLog = 0;
+		table.stateTable[0] = 0;
+		table.stateTable[1] = 0;
+		table.symbols[symbol].deltaFindState = 0;
+		table.symbols[symbol].deltaNbBits = 0;
+	}
+
+	SLIB_INLINE static void _priv_Zstd_initFseState(sl_uint32& state, const _priv_ZstdFseEncodeTable& table, sl_uint32 symbol)
+	{
+		const _priv_ZstdFseEncodeSymbol& tt = table.symbols[symbol];
+		sl_uint32 nbBitsOut = (tt.deltaNbBits + (1 << 15)) >> 16;
+		sl_uint32 value = (nbBitsOut << 16) - tt.deltaNbBits;
+		state = table.stateTable[(sl_int32)(value >> nbBitsOut) + tt.deltaFindState];
+	}
+
+	SLIB_INLINE static void _priv_Zstd_encodeFseSymbol(_priv_ZstdBitWriter& writer, sl_uint32& state, const _priv_ZstdFseEncodeTable& table, sl_uint32 symbol)
+	{
+		const _priv_ZstdFseEncodeSymbol& tt = table.symbols[symbol];
+		sl_uint32 nbBitsOut = (state + tt.deltaNbBits) >> 16;
+		writer.add(state, nbBitsOut);
+		state = table.stateTable[(sl_int32)(state >> nbBitsOut) + tt.deltaFindState];
+	}
+
+	static sl_uint32 _priv_Zstd_getOptimalTableLog(sl_uint32 maxTableLog, sl_size size, sl_uint32 maxSymbol)
+	{
+		sl_int32 maxBitsSource = (sl_int32)(Math::getMostSignificantBits((sl_uint64)(size - 1))) - 3;
+		sl_int32 minBitsSource = (sl_int32)(Math::getMostSignificantBits((sl_uint64)size));
+		sl_int32 minBitsSymbol = (sl_int32)_priv_Zstd_highbit(maxSymbol) + 2;
+		sl_int32 minBits = SLIB_MIN(minBitsSource, minBitsSymbol);
+		sl_int32 tableLog = (sl_int32)maxTableLog;
+		if (maxBitsSource < tableLog) {
+			tableLog = maxBitsSource;
+		}
+		if (minBits > tableLog) {
+			tableLog = minBits;
+		}
+		if (tableLog < 5) {
+			tableLog = 5;
+		}
+		if (tableLog > (sl_int32)maxTableLog) {
+			tableLog = (sl_int32)maxTableLog;
+		}
+		return (sl_uint32)tableLog;
+	}
+
+	// every present symbol gets at least one state
+	static void _priv_Zstd_normalizeCounts(sl_int16* norm, const sl_uint32* counts, sl_uint32 maxSymbol, sl_size total, sl_uint32 tableLog)
+	{
+		sl_int32 tableSize = 1 << tableLog;
+		sl_int32 sum = 0;
+		sl_uint32 largest = 0;
+		sl_uint32 countLargest = 0;
+		sl_uint32 s;
+		for (s = 0; s <= maxSymbol; s++) {
+			sl_uint32 c = counts[s];
+			if (c) {
+				sl_int32 n = (sl_int32)(((sl_uint64)c * tableSize + (total >> 1)) / total);
+				if (n < 1) {
+					n = 1;
+				}
+				norm[s] = (sl_int16)n;
+				sum += n;
+				if (c > countLargest) {
+					countLargest = c;
+					largest = s;
+				}
+			} else {
+				norm[s] = 0;
+			}
+		}
+		sl_int32 diff = tableSize - sum;
+		if (diff >= 0 || norm[largest] + diff > (norm[largest] >> 1)) {
+			norm[largest] = (sl_int16)(norm[largest] + diff);
+			return;
+		}
+		while (diff < 0) {
+			sl_uint32 k = 0;
+			for (s = 1; s <= maxSymbol; s++) {
+				if (norm[s] > norm[k]) {
+					k = s;
+				}
+			}
+			norm[k]--;
+			diff++;
+		}
+	}
+
+	// returns the size of table description
+	static sl_size _priv_Zstd_writeNCount(sl_uint8* dst, const sl_int16* norm, sl_uint32 maxSymbol, sl_uint32 tableLog)
+	{
+		sl_uint8* out = dst;
+		sl_uint32 bitStream = tableLog - 5;
+		sl_int32 bitCount = 4;
+		sl_int32 remaining = (1 << tableLog) + 1;
+		sl_int32 threshold = 1 << tableLog;
+		sl_int32 nbBits = tableLog + 1;
+		sl_uint32 symbol = 0;
+		sl_bool flagPreviousZero = sl_false;
+		while (symbol <= maxSymbol && remaining > 1) {
+			if (flagPreviousZero) {
+				sl_uint32 start = symbol;
+				while (symbol <= maxSymbol && !norm[symbol]) {
+					symbol++;
+				}
+				while (symbol >= start + 24) {
+					start += 24;
+					bitStream += (sl_uint32)0xFFFF << bitCount;
+					out[0] = (sl_uint8)bitStream;
+					out[1] = (sl_uint8)(bitStream >> 8);
+					out += 2;
+					bitStream >>= 16;
+				}
+				while (symbol >= start + 3) {
+					start += 3;
+					bitStream += (sl_uint32)3 << bitCount;
+					bitCount += 2;
+				}
+				bitStream += (symbol - start) << bitCount;
+				bitCount += 2;
+				if (bitCount > 16) {
+					out[0] = (sl_uint8)bitStream;
+					out[1] = (sl_uint8)(bitStream >> 8);
+					out += 2;
+					bitStream >>= 16;
+					bitCount -= 16;
+				}
+			}
+			sl_int32 count = norm[symbol++];
+			sl_int32 max = (2 * threshold - 1) - remaining;
+			remaining -= count < 0 ? -count : count;
+			count++;
+			if (count >= threshold) {
+				count += max;
+			}
+			bitStream += (sl_uint32)count << bitCount;
+			bitCount += nbBits;
+			bitCount -= (count < max);
+			flagPreviousZero = (count == 1);
+			while (remaining < threshold) {
+				nbBits--;
+				threshold >>= 1;
+			}
+			if (bitCount > 16) {
+				out[0] = (sl_uint8)bitStream;
+				out[1] = (sl_uint8)(bitStream >> 8);
+				out += 2;
+				bitStream >>= 16;
+				bitCount -= 16;
+			}
+		}
+		out[0] = (sl_uint8)bitStream;
+		out[1] = (sl_uint8)(bitStream >> 8);
+		out += (bitCount + 7) >> 3;
+		return out - dst;
+	}
+
+	// returns 0 when the weights can't be compressed
+	static sl_size _priv_Zstd_compressHufWeights(sl_uint8* dst, sl_size size, const sl_uint8* weights, sl_uint32 nWeights)
+	{
+		if (nWeights <= 2 || size < 64) {
+			return 0;
+		}
+		sl_uint32 counts[PRIV_ZSTD_HUF_LOG_MAX + 1] = {0};
+		sl_uint32 maxWeight = 0;
+		sl_uint32 i;
+		for (i = 0; i < nWeights; i++) {
+			sl_uint32 w = weights[i];
+			counts[w]++;
+			if (w > maxWeight) {
+				maxWeight = w;
+			}
+		}
+		for (i = 0; i <= maxWeight; i++) {
+			if (counts[i] == nWeights) {
+				return 0;
+			}
+		}
+		sl_uint32 tableLog = _priv_Zstd_getOptimalTableLog(PRIV_ZSTD_HUF_WEIGHTS_LOG_MAX, nWeights, maxWeight);
+		sl_int16 norm[PRIV_ZSTD_HUF_LOG_MAX + 1];
+		_priv_Zstd_normalizeCounts(norm, counts, maxWeight, nWeights, tableLog);
+		sl_size n = _priv_Zstd_writeNCount(dst, norm, maxWeight, tableLog);
+		_priv_ZstdFseEncodeTable table;
+		_priv_Zstd_buildFseEncodeTable(table, norm, maxWeight, tableLog);
+		_priv_ZstdBitWriter writer;
+		if (!(writer.init(dst + n, size - n))) {
+			return 0;
+		}
+		// two interleaved states: even indices by the first, odd by the second
+		sl_uint32 state1, state2;
+		if (nWeights & 1) {
+			_priv_Zstd_initFseState(state1, table, weights[nWeights - 1]);
+			_priv_Zstd_initFseState(state2, table, weights[nWeights - 2]);
+		} else {
+			_priv_Zstd_initFseState(state2, table, weights[nWeights - 1]);
+			_priv_Zstd_initFseState(state1, table, weights[nWeights - 2]);
+		}
+		i = nWeights - 2;
+		while (i) {
+			i--;
+			if (i & 1) {
+				_priv_Zstd_encodeFseSymbol(writer, state2, table, weights[i]);
+			} else {
+				_priv_Zstd_encodeFseSymbol(writer, state1, table, weights[i]);
+			}
+			writer.flush();
+		}
+		writer.add(state2, tableLog);
+		writer.add(state1, tableLog);
+		sl_size m = writer.close();
+		if (!m) {
+			return 0;
+		}
+		return n + m;
+	}
+
+	struct _priv_ZstdHufEncodeTable
+	{
+		sl_uint32 maxBits;
+		sl_uint32 maxSymbol;
+		sl_uint16 codes[256];
+		sl_uint8 nbBits[256];
+	};
+
+	// code lengths are limited to 11 bits. returns false for less than 2 symbols
+	static sl_bool _priv_Zstd_buildHufEncodeTable(_priv_ZstdHufEncodeTable& table, const sl_uint32* counts, sl_uint32 maxSymbol)
+	{
+		sl_uint16 leaves[256];
+		sl_uint32 n = 0;
+		sl_uint32 i;
+		for (i = 0; i <= maxSymbol; i++) {
+			if (counts[i]) {
+				// insertion sort by ascending count
+				sl_uint32 k = n;
+				while (k && counts[leaves[k - 1]] > counts[i]) {
+					leaves[k] = leaves[k - 1];
+					k--;
+				}
+				leaves[k] = (sl_uint16)i;
+				n++;
+			}
+		}
+		if (n < 2) {
+			return sl_false;
+		}
+		sl_uint32 weights[512];
+		sl_uint16 parents[512];
+		for (i = 0; i < n; i++) {
+			weights[i] = counts[leaves[i]];
+		}
+		sl_uint32 iLeaf = 0;
+		sl_uint32 iNode = n;
+		sl_uint32 nNodes = n;
+		while (nNodes < 2 * n - 1) {
+			sl_uint32 a, b;
+			if (iLeaf < n && (iNode >= nNodes || weights[iLeaf] <= weights[iNode])) {
+				a = iLeaf++;
+			} else {
+				a = iNode++;
+			}
+			if (iLeaf < n && (iNode >= nNodes || weights[iLeaf] <= weights[iNode])) {
+				b = iLeaf++;
+			} else {
+				b = iNode++;
+			}
+			weights[nNodes] = weights[a] + weights[b];
+			parents[a] = (sl_uint16)nNodes;
+			parents[b] = (sl_uint16)nNodes;
+			nNodes++;
+		}
+		sl_uint8 depths[512];
+		depths[nNodes - 1] = 0;
+		i = nNodes - 1;
+		while (i) {
+			i--;
+			depths[i] = depths[parents[i]] + 1;
+		}
+		sl_uint32 maxBits = 0;
+		for (i = 0; i < n; i++) {
+			if (depths[i] > maxBits) {
+				maxBits = depths[i];
+			}
+		}
+		if (maxBits > PRIV_ZSTD_HUF_LOG_MAX) {
+			// Kraft sum in units of 2^-11
+			sl_int32 target = 1 << PRIV_ZSTD_HUF_LOG_MAX;
+			sl_int32 kraft = 0;
+			for (i = 0; i < n; i++) {
+				if (depths[i] > PRIV_ZSTD_HUF_LOG_MAX) {
+					depths[i] = PRIV_ZSTD_HUF_LOG_MAX;
+				}
+				kraft += 1 << (PRIV_ZSTD_HUF_LOG_MAX - depths[i]);
+			}
+			// lengthen the codes of rare symbols
+			while (kraft > target) {
+				i = 0;
+				while (depths[i] >= PRIV_ZSTD_HUF_LOG_MAX) {
+					i++;
+				}
+				kraft -= 1 << (PRIV_ZSTD_HUF_LOG_MAX - 1 - depths[i]);
+				depths[i]++;
+			}
+			// shorten the codes of frequent symbols to complete the code
+			while (kraft < target) {
+				sl_bool flagFound = sl_false;
+				i = n;
+				while (i) {
+					i--;
+					sl_int32 inc = 1 << (PRIV_ZSTD_HUF_LOG_MAX - depths[i]);
+					if (depths[i] > 1 && kraft + inc <= target) {
+						kraft += inc;
+						depths[i]--;
+						flagFound = sl_true;
+						break;
+					}
+				}
+				if (!flagFound) {
+					return sl_false;
+				}
+			}
+			maxBits = 0;
+			for (i = 0; i < n; i++) {
+				if (depths[i] > maxBits) {
+					maxBits = depths[i];
+				}
+			}
+		}
+		Base::zeroMemory(table.nbBits, sizeof(table.nbBits));
+		sl_uint16 nPerRank[PRIV_ZSTD_HUF_LOG_MAX + 2] = {0};
+		sl_uint16 valuePerRank[PRIV_ZSTD_HUF_LOG_MAX + 2];
+		for (i = 0; i < n; i++) {
+			table.nbBits[leaves[i]] = depths[i];
+			nPerRank[depths[i]]++;
+		}
+		sl_uint16 v = 0;
+		for (i = maxBits; i > 0; i--) {
+			valuePerRank[i] = v;
+			v = (sl_uint16)((v + nPerRank[i]) >> 1);
+		}
+		sl_uint32 last = 0;
+		for (i = 0; i <= maxSymbol; i++) {
+			sl_uint32 nb = table.nbBits[i];
+			if (nb) {
+				table.codes[i] = valuePerRank[nb]++;
+				last = i;
+			}
+		}
+		table.maxBits = maxBits;
+		table.maxSymbol = last;
+		return sl_true;
+	}
+
+	// returns the size of tree description, 0 on error
+	static sl_size _priv_Zstd_writeHufTable(sl_uint8* dst, sl_size size, const _priv_ZstdHufEncodeTable& table)
+	{
+		sl_uint8 weights[256];
+		sl_uint32 nWeights = table.maxSymbol;
+		sl_uint32 i;
+		for (i = 0; i < nWeights; i++) {
+			sl_uint32 nb = table.nbBits[i];
+			weights[i] = nb ? (sl_uint8)(table.maxBits + 1 - nb) : 0;
+		}
+		if (size < 2) {
+			return 0;
+		}
+		sl_size sizeDirect = (nWeights + 1) >> 1;
+		sl_size n = _priv_Zstd_compressHufWeights(dst + 1, size - 1, weights, nWeights);
+		if (n && n < 128 && (n < sizeDirect || nWeights > 128)) {
+			dst[0] = (sl_uint8)n;
+			return n + 1;
+		}
+		if (nWeights > 128 || sizeDirect + 1 > size) {
+			return 0;
+		}
+		dst[0] = (sl_uint8)(127 + nWeights);
+		weights[nWeights] = 0;
+		for (i = 0; i < sizeDirect; i++) {
+			dst[1 + i] = (sl_uint8)((weights[i << 1] << 4) | weights[(i << 1) + 1]);
+		}
+		return sizeDirect + 1;
+	}
+
+	static sl_size _priv_Zstd_encodeHufStream(sl_uint8* dst, sl_size size, const sl_uint8* src, sl_size n, const _priv_ZstdHufEncodeTable& table)
+	{
+		_priv_ZstdBitWriter writer;
+		if (!(writer.init(dst, size))) {
+			return 0;
+		}
+		const sl_uint16* codes = table.codes;
+		const sl_uint8* nbBits = table.nbBits;
+		// the first symbol is written at last
+		sl_size i = n;
+		while (i & 3) {
+			i--;
+			writer.add(codes[src[i]], nbBits[src[i]]);
+		}
+		writer.flush();
+		while (i) {
+			i -= 4;
+			writer.add(codes[src[i + 3]], nbBits[src[i + 3]]);
+			writer.add(codes[src[i + 2]], nbBits[src[i + 2]]);
+			writer.add(codes[src[i + 1]], nbBits[src[i + 1]]);
+			writer.add(codes[src[i]], nbBits[src[i]]);
+			writer.flush();
+		}
+		return writer.close();
+	}
+
+	static sl_size _priv_Zstd_writeLiteralsHeader(sl_uint8* dst, sl_uint32 type, sl_size n)
+	{
+		if (n < 32) {
+			dst[0] = (sl_uint8)(type | (n << 3));
+			return 1;
+		} else if (n < 4096) {
+			MIO::writeUint16LE(dst, (sl_uint16)(type | (1 << 2) | (n << 4)));
+			return 2;
+		} else {
+			sl_uint32 v = (sl_uint32)(type | (3 << 2) | (n << 4));
+			dst[0] = (sl_uint8)v;
+			dst[1] = (sl_uint8)(v >> 8);
+			dst[2] = (sl_uint8)(v >> 16);
+			return 3;
+		}
+	}
+
+	// returns the size of literals section, 0 on error
+	static sl_size _priv_Zstd_writeLiterals(sl_uint8* dst, sl_size size, const sl_uint8* src, sl_size n)
+	{
+		if (size < n + 8) {
+			return 0;
+		}
+		if (n > 63) {
+			sl_uint32 counts[256] = {0};
+			sl_size i;
+			for (i = 0; i < n; i++) {
+				counts[src[i]]++;
+			}
+			sl_uint32 maxSymbol = 255;
+			while (!counts[maxSymbol]) {
+				maxSymbol--;
+			}
+			sl_uint32 countLargest = 0;
+			for (i = 0; i <= maxSymbol; i++) {
+				if (counts[i] > countLargest) {
+					countLargest = counts[i];
+				}
+			}
+			if (countLargest == n) {
+				sl_size h = _priv_Zstd_writeLiteralsHeader(dst, PRIV_ZSTD_LITERALS_RLE, n);
+				dst[h] = src[0];
+				return h + 1;
+			}
+			_priv_ZstdHufEncodeTable table;
+			if (_priv_Zstd_buildHufEncodeTable(table, counts, maxSymbol)) {
+				sl_uint8* p = dst + 5;
+				sl_uint8* end = dst + size;
+				sl_size sizeTree = _priv_Zstd_writeHufTable(p, end - p, table);
+				if (sizeTree) {
+					sl_uint8* q = p + sizeTree;
+					sl_bool flag4Streams = n >= 256;
+					if (flag4Streams) {
+						sl_size sizeSegment = (n + 3) >> 2;
+						sl_uint8* jump = q;
+						q += 6;
+						for (sl_uint32 k = 0; k < 4; k++) {
+							sl_size len = k < 3 ? sizeSegment : n - 3 * sizeSegment;
+							sl_size m = _priv_Zstd_encodeHufStream(q, end - q, src + k * sizeSegment, len, table);
+							if (!m || m > 0xFFFF) {
+								q = sl_null;
+								break;
+							}
+							if (k < 3) {
+								MIO::writeUint16LE(jump + (k << 1), (sl_uint16)m);
+							}
+							q += m;
+						}
+					} else {
+						sl_size m = _priv_Zstd_encodeHufStream(q, end - q, src, n, table);
+						q = m ? q + m : sl_null;
+					}
+					if (q) {
+						sl_size sizeCompressed = q - p;
+						sl_size h;
+						sl_uint64 v = PRIV_ZSTD_LITERALS_COMPRESSED;
+						if (!flag4Streams) {
+							h = 3;
+							v |= (n << 4) | (sizeCompressed << 14);
+						} else if (n < 1024 && sizeCompressed < 1024) {
+							h = 3;
+							v |= (1 << 2) | (n << 4) | (sizeCompressed << 14);
+						} else if (n < 16384 && sizeCompressed < 16384) {
+							h = 4;
+							v |= (2 << 2) | (n << 4) | (sizeCompressed << 18);
+						} else {
+							h = 5;
+							v |= (3 << 2) | (n << 4) | ((sl_uint64)sizeCompressed << 22);
+						}
+						if (h + sizeCompressed + (n >> 6) + 2 < n) {
+							for (i = 0; i < h; i++) {
+								dst[i] = (sl_uint8)(v >> (i << 3));
+							}
+							Base::moveMemory(dst + h, p, sizeCompressed);
+							return h + sizeCompressed;
+						}
+					}
+				}
+			}
+		}
+		sl_size h = _priv_Zstd_writeLiteralsHeader(dst, PRIV_ZSTD_LITERALS_RAW, n);
+		Base::copyMemory(dst + h, src, n);
+		return h + n;
+	}
+
+	struct _priv_ZstdSequence
+	{
+		sl_uint32 litLength;
+		sl_uint32 matchLength;
+		// 1 ~ 3: repeat offsets, otherwise offset + 3
+		sl_uint32 offBase;
+	};
+
+	static const sl_uint8 _priv_Zstd_LL_code[64] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 16, 17, 17, 18, 18, 19, 19, 20, 20, 20, 20, 21, 21, 21, 21,
+		22, 22, 22, 22, 22, 22, 22, 22, 23, 23, 23, 23, 23, 23, 23, 23,
+		24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24
+	};
+
+	static const sl_uint8 _priv_Zstd_ML_code[128] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 32, 33, 33, 34, 34, 35, 35, 36, 36, 36, 36, 37, 37, 37, 37,
+		38, 38, 38, 38, 38, 38, 38, 38, 39, 39, 39, 39, 39, 39, 39, 39,
+		40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,
+		41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41,
+		42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
+		42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42
+	};
+
+	SLIB_INLINE static sl_uint32 _priv_Zstd_getLLCode(sl_uint32 litLength)
+	{
+		return litLength > 63 ? _priv_Zstd_highbit(litLength) + 19 : _priv_Zstd_LL_code[litLength];
+	}
+
+	SLIB_INLINE static sl_uint32 _priv_Zstd_getMLCode(sl_uint32 matchLength)
+	{
+		sl_uint32 v = matchLength - 3;
+		return v > 127 ? _priv_Zstd_highbit(v) + 36 : _priv_Zstd_ML_code[v];
+	}
+
+	// chooses the encoding mode of a symbol type and writes the table description
+	static sl_size _priv_Zstd_writeSymbolEncoding(sl_uint8* dst, sl_uint32& mode, _priv_ZstdFseEncodeTable& table, const sl_uint8* codes, sl_uint32 nSeq, sl_uint32 maxLog, const sl_int16* normDefault, sl_uint32 maxDefault, sl_uint32 logDefault)
+	{
+		sl_uint32 counts[PRIV_ZSTD_ML_MAX + 1] = {0};
+		sl_uint32 i;
+		for (i = 0; i < nSeq; i++) {
+			counts[codes[i]]++;
+		}
+		sl_uint32 maxSymbol = PRIV_ZSTD_ML_MAX;
+		while (!counts[maxSymbol]) {
+			maxSymbol--;
+		}
+		if (counts[codes[0]] == nSeq) {
+			if (nSeq > 2 || maxSymbol > maxDefault) {
+				mode = PRIV_ZSTD_MODE_RLE;
+				dst[0] = codes[0];
+				_priv_Zstd_buildFseEncodeTableRLE(table, codes[0]);
+				return 1;
+			}
+		}
+		double costDefault = -1;
+		if (maxSymbol <= maxDefault) {
+			costDefault = 0;
+			for (i = 0; i <= maxSymbol; i++) {
+				if (counts[i]) {
+					sl_int32 n = normDefault[i];
+					if (n < 1) {
+						n = 1;
+					}
+					costDefault += counts[i] * (logDefault - Math::log2((double)n));
+				}
+			}
+			if (nSeq < 16) {
+				mode = PRIV_ZSTD_MODE_PREDEFINED;
+				_priv_Zstd_buildFseEncodeTable(table, normDefault, maxDefault, logDefault);
+				return 0;
+			}
+		}
+		sl_uint32 tableLog = _priv_Zstd_getOptimalTableLog(maxLog, nSeq, maxSymbol);
+		sl_int16 norm[PRIV_ZSTD_ML_MAX + 1];
+		_priv_Zstd_normalizeCounts(norm, counts, maxSymbol, nSeq, tableLog);
+		sl_size sizeHeader = _priv_Zstd_writeNCount(dst, norm, maxSymbol, tableLog);
+		if (costDefault >= 0) {
+			double cost = (double)(sizeHeader << 3);
+			for (i = 0; i <= maxSymbol; i++) {
+				if (counts[i]) {
+					cost += counts[i] * (tableLog - Math::log2((double)(norm[i])));
+				}
+			}
+			if (costDefault <= cost) {
+				mode = PRIV_ZSTD_MODE_PREDEFINED;
+				_priv_Zstd_buildFseEncodeTable(table, normDefault, maxDefault, logDefault);
+				return 0;
+			}
+		}
+		mode = PRIV_ZSTD_MODE_COMPRESSED;
+		_priv_Zstd_buildFseEncodeTable(table, norm, maxSymbol, tableLog);
+		return sizeHeader;
+	}
+
+	// returns the size of sequences section, 0 on error. `codes` has 3 * `nSeq` bytes
+	static sl_size _priv_Zstd_writeSequences(sl_uint8* dst, sl_size size, const _priv_ZstdSequence* seqs, sl_uint32 nSeq, sl_uint8* codes)
+	{
+		if (size < 512) {
+			return 0;
+		}
+		sl_uint8* op = dst;
+		sl_uint8* end = dst + size;
+		if (nSeq < 128) {
+			*(op++) = (sl_uint8)nSeq;
+		} else if (nSeq < 0x7F00) {
+			op[0] = (sl_uint8)((nSeq >> 8) + 128);
+			op[1] = (sl_uint8)nSeq;
+			op += 2;
+		} else {
+			op[0] = 255;
+			MIO::writeUint16LE(op + 1, (sl_uint16)(nSeq - 0x7F00));
+			op += 3;
+		}
+		if (!nSeq) {
+			return op - dst;
+		}
+		sl_uint8* codesLL = codes;
+		sl_uint8* codesML = codes + nSeq;
+		sl_uint8* codesOF = codesML + nSeq;
+		sl_uint32 i;
+		for (i = 0; i < nSeq; i++) {
+			const _priv_ZstdSequence& seq = seqs[i];
+			codesLL[i] = (sl_uint8)(_priv_Zstd_getLLCode(seq.litLength));
+			codesML[i] = (sl_uint8)(_priv_Zstd_getMLCode(seq.matchLength));
+			codesOF[i] = (sl_uint8)(_priv_Zstd_highbit(seq.offBase));
+		}
+		sl_uint8* modes = op++;
+		_priv_ZstdFseEncodeTable tableLL, tableOF, tableML;
+		sl_uint32 modeLL, modeOF, modeML;
+		op += _priv_Zstd_writeSymbolEncoding(op, modeLL, tableLL, codesLL, nSeq, PRIV_ZSTD_LL_LOG, _priv_Zstd_LL_default, PRIV_ZSTD_LL_MAX, PRIV_ZSTD_LL_DEFAULT_LOG);
+		op += _priv_Zstd_writeSymbolEncoding(op, modeOF, tableOF, codesOF, nSeq, PRIV_ZSTD_OF_LOG, _priv_Zstd_OF_default, PRIV_ZSTD_OF_DEFAULT_MAX, PRIV_ZSTD_OF_DEFAULT_LOG);
+		op += _priv_Zstd_writeSymbolEncoding(op, modeML, tableML, codesML, nSeq, PRIV_ZSTD_ML_LOG, _priv_Zstd_ML_default, PRIV_ZSTD_ML_MAX, PRIV_ZSTD_ML_DEFAULT_LOG);
+		*modes = (sl_uint8)((modeLL << 6) | (modeOF << 4) | (modeML << 2));
+
+		_priv_ZstdBitWriter writer;
+		if (!(writer.init(op, end - op))) {
+			return 0;
+		}
+		// the sequences are written in reverse order
+		sl_uint32 stateLL, stateOF, stateML;
+		sl_uint32 k = nSeq - 1;
+		_priv_Zstd_initFseState(stateML, tableML, codesML[k]);
+		_priv_Zstd_initFseState(stateOF, tableOF, codesOF[k]);
+		_priv_Zstd_initFseState(stateLL, tableLL, codesLL[k]);
+		for (;;) {
+			const _priv_ZstdSequence& seq = seqs[k];
+			sl_uint32 codeLL = codesLL[k];
+			sl_uint32 codeML = codesML[k];
+			writer.add(seq.litLength - _priv_Zstd_LL_base[codeLL], _priv_Zstd_LL_bits[codeLL]);
+			writer.add(seq.matchLength - _priv_Zstd_ML_base[codeML], _priv_Zstd_ML_bits[codeML]);
+			writer.flush();
+			writer.add(seq.offBase, codesOF[k]);
+			writer.flush();
+			if (!k) {
+				break;
+			}
+			k--;
+			_priv_Zstd_encodeFseSymbol(writer, stateOF, tableOF, codesOF[k]);
+			_priv_Zstd_encodeFseSymbol(writer, stateML, tableML, codesML[k]);
+			_priv_Zstd_encodeFseSymbol(writer, stateLL, tableLL, codesLL[k]);
+			writer.flush();
+		}
+		writer.add(stateML, tableML.tableLog);
+		writer.add(stateOF, tableOF.tableLog);
+		writer.add(stateLL, tableLL.tableLog);
+		sl_size n = writer.close();
+		if (!n) {
+			return 0;
+		}
+		return op + n - dst;
+	}
+
+	struct _priv_ZstdParams
+	{
+		sl_uint32 windowLog;
+		sl_uint32 hashLog;
+		// 0 for single hash probe
+		sl_uint32 chainLog;
+		sl_uint32 searchLog;
+		sl_uint32 minMatch;
+		// 0: greedy, 1: checks next position, 2: checks next two positions
+		sl_uint32 lazy;
+	};
+
+	static void _priv_Zstd_getParams(_priv_ZstdParams& params, sl_int32 level, sl_uint64 sizeHint)
+	{
+		static const sl_uint8 table[19][6] = {
+			{ 19, 15, 0, 0, 6, 0 },
+			{ 20, 16, 0, 0, 5, 0 },
+			{ 21, 17, 16, 2, 5, 0 },
+			{ 21, 17, 16, 3, 5, 1 },
+			{ 21, 17, 17, 4, 5, 1 },
+			{ 21, 18, 18, 5, 5, 1 },
+			{ 22, 18, 18, 4, 4, 2 },
+			{ 22, 19, 19, 5, 4, 2 },
+			{ 22, 19, 19, 6, 4, 2 },
+			{ 22, 20, 20, 6, 4, 2 },
+			{ 22, 20, 20, 7, 4, 2 },
+			{ 23, 20, 21, 7, 4, 2 },
+			{ 23, 21, 22, 8, 4, 2 },
+			{ 23, 22, 22, 8, 4, 2 },
+			{ 23, 22, 23, 9, 4, 2 },
+			{ 24, 22, 23, 9, 4, 2 },
+			{ 24, 22, 24, 10, 4, 2 },
+			{ 24, 23, 24, 11, 4, 2 },
+			{ 24, 23, 24, 12, 4, 2 }
+		};
+		if (level < 1) {
+			level = 1;
+		} else if (level > 19) {
+			level = 19;
+		}
+		const sl_uint8* p = table[level - 1];
+		params.windowLog = p[0];
+		params.hashLog = p[1];
+		params.chainLog = p[2];
+		params.searchLog = p[3];
+		params.minMatch = p[4];
+		params.lazy = p[5];
+		if (sizeHint) {
+			// smaller tables for small input
+			sl_uint32 log = Math::getMostSignificantBits((sl_uint64)(sizeHint - 1));
+			if (log < PRIV_ZSTD_WINDOW_LOG_MIN) {
+				log = PRIV_ZSTD_WINDOW_LOG_MIN;
+			}
+			if (params.windowLog > log) {
+				params.windowLog = log;
+			}
+			if (params.hashLog > params.windowLog + 1) {
+				params.hashLog = params.windowLog + 1;
+			}
+			if (params.chainLog > params.windowLog) {
+				params.chainLog = params.windowLog;
+			}
+		}
+	}
+
+	template <sl_uint32 MLS>
+	SLIB_INLINE static sl_uint32 _priv_Zstd_hash(const sl_uint8* p, sl_uint32 hashLog)
+	{
+		if (MLS == 4) {
+			return (MIO::readUint32LE(p) * 2654435761U) >> (32 - hashLog);
+		} else if (MLS == 5) {
+			return (sl_uint32)(((MIO::readUint64LE(p) << 24) * 889523592379ULL) >> (64 - hashLog));
+		} else {
+			return (sl_uint32)(((MIO::readUint64LE(p) << 16) * 227718039650203ULL) >> (64 - hashLog));
+		}
+	}
+
+	struct _priv_ZstdStatistics
+	{
+		sl_uint32 literals[256];
+		sl_uint32 LL[PRIV_ZSTD_LL_MAX + 1];
+		sl_uint32 ML[PRIV_ZSTD_ML_MAX + 1];
+		sl_uint32 OF[PRIV_ZSTD_OF_MAX + 1];
+	};
+
+	class _priv_ZstdEncoder : public Referable
+	{
+	public:
+		sl_bool m_flagStarted;
+		sl_bool m_flagEnded;
+		_priv_ZstdParams m_params;
+		sl_bool m_flagChecksum;
+		XXHash64 m_hash;
+
+		Memory m_memWindow;
+		sl_uint8* m_window;
+		sl_uint32 m_sizeWindowBuffer;
+		sl_uint32 m_sizeWindow;
+		sl_uint32 m_sizeBlock;
+		// end of input data in window buffer
+		sl_uint32 m_posEnd;
+		// start of the data to be compressed
+		sl_uint32 m_posBlock;
+		// absolute index of the window buffer
+		sl_uint32 m_indexBase;
+		// lowest valid absolute index (start of dictionary content or frame)
+		sl_uint32 m_indexLow;
+		sl_uint32 m_indexNextUpdate;
+
+		Memory m_memTables;
+		sl_uint32* m_hashTable;
+		sl_uint32* m_chainTable;
+		sl_uint32 m_sizeHashTable;
+		sl_uint32 m_sizeChainTable;
+		sl_uint32 m_rep[3];
+
+		Memory m_memSequences;
+		_priv_ZstdSequence* m_sequences;
+		sl_uint32 m_nSequences;
+		sl_uint8* m_literals;
+		sl_uint8* m_literalsEnd;
+		sl_uint8* m_codes;
+
+		Memory m_memOutput;
+		sl_uint8* m_output;
+		sl_uint32 m_posOutput;
+		sl_uint32 m_sizeOutput;
+
+		_priv_ZstdStatistics* m_statistics;
+
+	public:
+		_priv_ZstdEncoder()
+		{
+			m_flagStarted = sl_false;
+			m_flagEnded = sl_false;
+			m_sizeWindowBuffer = 0;
+			m_sizeHashTable = 0;
+			m_sizeChainTable = 0;
+			m_sizeBlock = 0;
+			m_indexBase = 0;
+			m_posEnd = 0;
+			m_statistics = sl_null;
+		}
+
+	public:
+		sl_bool start(const Ref<ZstdDictionary>& dictionary, sl_int32 level, sl_bool flagChecksum, sl_uint64 sizeContent)
+		{
+			m_flagStarted = sl_false;
+			const sl_uint8* contentDictionary = sl_null;
+			sl_size sizeDictionary = 0;
+			if (dictionary.isNotNull()) {
+				contentDictionary = dictionary->getContent();
+				sizeDictionary = dictionary->getContentSize();
+			}
+			sl_bool flagKnownSize = sizeContent != SLIB_UINT64_MAX;
+			_priv_Zstd_getParams(m_params, level, flagKnownSize ? sizeContent + sizeDictionary + 1 : 0);
+			m_sizeWindow = 1 << m_params.windowLog;
+			m_sizeBlock = SLIB_MIN(m_sizeWindow, PRIV_ZSTD_BLOCK_SIZE_MAX);
+			if (sizeDictionary > m_sizeWindow) {
+				contentDictionary += sizeDictionary - m_sizeWindow;
+				sizeDictionary = m_sizeWindow;
+			}
+			sl_uint32 sizeWindowBuffer = 2 * m_sizeWindow + m_sizeBlock;
+			if (m_sizeWindowBuffer != sizeWindowBuffer) {
+				m_memWindow = Memory::create(sizeWindowBuffer + PRIV_ZSTD_WILDCOPY_LENGTH);
+				if (m_memWindow.isNull()) {
+					m_sizeWindowBuffer = 0;
+					return sl_false;
+				}
+				m_window = (sl_uint8*)(m_memWindow.getData());
+				Base::zeroMemory(m_window + sizeWindowBuffer, PRIV_ZSTD_WILDCOPY_LENGTH);
+				m_sizeWindowBuffer = sizeWindowBuffer;
+				m_memSequences = Memory::create(sizeof(_priv_ZstdSequence) * (m_sizeBlock / 3 + 1) + 3 * (m_sizeBlock / 3 + 1) + m_sizeBlock + PRIV_ZSTD_WILDCOPY_LENGTH);
+				m_memOutput = Memory::create(m_sizeBlock + 1024);
+				if (m_memSequences.isNull() || m_memOutput.isNull()) {
+					m_sizeWindowBuffer = 0;
+					return sl_false;
+				}
+				m_sequences = (_priv_ZstdSequence*)(m_memSequences.getData());
+				m_codes = (sl_uint8*)(m_sequences + (m_sizeBlock / 3 + 1));
+				m_literals = m_codes + 3 * (m_sizeBlock / 3 + 1);
+				m_output = (sl_uint8*)(m_memOutput.getData());
+			}
+			sl_uint32 sizeHashTable = 1 << m_params.hashLog;
+			sl_uint32 sizeChainTable = m_params.chainLog ? 1 << m_params.chainLog : 0;
+			if (m_sizeHashTable != sizeHashTable || m_sizeChainTable != sizeChainTable || m_indexBase + m_posEnd > 0xC0000000) {
+				m_memTables = Memory::create(sizeof(sl_uint32) * (sizeHashTable + sizeChainTable));
+				if (m_memTables.isNull()) {
+					m_sizeHashTable = 0;
+					return sl_false;
+				}
+				m_hashTable = (sl_uint32*)(m_memTables.getData());
+				m_chainTable = m_hashTable + sizeHashTable;
+				Base::zeroMemory(m_hashTable, sizeof(sl_uint32) * (sizeHashTable + sizeChainTable));
+				m_sizeHashTable = sizeHashTable;
+				m_sizeChainTable = sizeChainTable;
+				m_indexBase = 1;
+			} else {
+				// previous entries are below the new lowest index
+				m_indexBase += m_posEnd + 1;
+			}
+			m_indexLow = m_indexBase;
+			m_indexNextUpdate = m_indexBase;
+			m_posEnd = 0;
+			if (sizeDictionary) {
+				Base::copyMemory(m_window, contentDictionary, sizeDictionary);
+				m_posEnd = (sl_uint32)sizeDictionary;
+				_loadDictionary();
+				m_rep[0] = dictionary->m_rep[0];
+				m_rep[1] = dictionary->m_rep[1];
+				m_rep[2] = dictionary->m_rep[2];
+			} else {
+				m_rep[0] = 1;
+				m_rep[1] = 4;
+				m_rep[2] = 8;
+			}
+			m_posBlock = m_posEnd;
+			m_flagChecksum = flagChecksum;
+			m_hash.start(0);
+
+			// frame header
+			sl_uint8* p = m_output;
+			MIO::writeUint32LE(p, PRIV_ZSTD_MAGIC);
+			p += 4;
+			sl_uint8* descriptor = p++;
+			sl_uint32 flags = flagChecksum ? 4 : 0;
+			sl_bool flagSingleSegment = flagKnownSize && sizeContent <= m_sizeWindow;
+			if (flagSingleSegment) {
+				flags |= 0x20;
+			} else {
+				*(p++) = (sl_uint8)((m_params.windowLog - PRIV_ZSTD_WINDOW_LOG_MIN) << 3);
+			}
+			sl_uint32 idDictionary = dictionary.isNotNull() ? dictionary->getId() : 0;
+			if (idDictionary) {
+				if (idDictionary < 256) {
+					flags |= 1;
+					*(p++) = (sl_uint8)idDictionary;
+				} else if (idDictionary < 65536) {
+					flags |= 2;
+					MIO::writeUint16LE(p, (sl_uint16)idDictionary);
+					p += 2;
+				} else {
+					flags |= 3;
+					MIO::writeUint32LE(p, idDictionary);
+					p += 4;
+				}
+			}
+			if (flagKnownSize) {
+				if (flagSingleSegment && sizeContent < 256) {
+					*(p++) = (sl_uint8)sizeContent;
+				} else if (sizeContent >= 256 && sizeContent < 65536 + 256) {
+					flags |= 0x40;
+					MIO::writeUint16LE(p, (sl_uint16)(sizeContent - 256));
+					p += 2;
+				} else if (sizeContent <= 0xFFFFFFFF) {
+					flags |= 0x80;
+					MIO::writeUint32LE(p, (sl_uint32)sizeContent);
+					p += 4;
+				} else {
+					flags |= 0xC0;
+					MIO::writeUint64LE(p, sizeContent);
+					p += 8;
+				}
+			}
+			*descriptor = (sl_uint8)flags;
+			m_posOutput = 0;
+			m_sizeOutput = (sl_uint32)(p - m_output);
+			m_flagEnded = sl_false;
+			m_flagStarted = sl_true;
+			return sl_true;
+		}
+
+		// returns the size of accepted input
+		sl_uint32 putInput(const sl_uint8* data, sl_size size)
+		{
+			sl_uint32 room = m_sizeBlock - (m_posEnd - m_posBlock);
+			if (m_posEnd + room > m_sizeWindowBuffer) {
+				_slideWindow();
+			}
+			sl_uint32 n = room;
+			if (n > size) {
+				n = (sl_uint32)size;
+			}
+			Base::copyMemory(m_window + m_posEnd, data, n);
+			m_posEnd += n;
+			return n;
+		}
+
+		sl_bool isBlockFull()
+		{
+			return m_posEnd - m_posBlock >= m_sizeBlock;
+		}
+
+		sl_bool hasBlockInput()
+		{
+			return m_posEnd > m_posBlock;
+		}
+
+		// compresses the input in the window buffer as a block, the output is written after pending output
+		void writeBlock(sl_bool flagLast)
+		{
+			if (m_posOutput == m_sizeOutput) {
+				m_posOutput = 0;
+				m_sizeOutput = 0;
+			}
+			sl_uint32 posStart = m_posBlock;
+			sl_uint32 posEnd = m_posEnd;
+			sl_uint32 size = posEnd - posStart;
+			const sl_uint8* src = m_window + posStart;
+			if (m_flagChecksum) {
+				m_hash.update(src, size);
+			}
+			sl_uint8* out = m_output + m_sizeOutput;
+			sl_size n = 0;
+			if (size > 16) {
+				sl_uint32 rep[3] = { m_rep[0], m_rep[1], m_rep[2] };
+				m_nSequences = 0;
+				m_literalsEnd = m_literals;
+				if (m_params.chainLog) {
+					switch (m_params.minMatch) {
+						case 4:
+							_compressLazy<4>(posStart, posEnd);
+							break;
+						default:
+							_compressLazy<5>(posStart, posEnd);
+							break;
+					}
+				} else {
+					switch (m_params.minMatch) {
+						case 5:
+							_compressFast<5>(posStart, posEnd);
+							break;
+						default:
+							_compressFast<6>(posStart, posEnd);
+							break;
+					}
+				}
+				if (m_statistics) {
+					_collectStatistics();
+				}
+				n = _writeCompressedBlock(out + 3, m_sizeBlock + 1024 - 32 - m_sizeOutput);
+				if (!n || n >= size) {
+					// sequences are not used by the decoder
+					m_rep[0] = rep[0];
+					m_rep[1] = rep[1];
+					m_rep[2] = rep[2];
+					n = 0;
+				}
+			}
+			sl_uint32 header;
+			if (n) {
+				header = (sl_uint32)((n << 3) | (PRIV_ZSTD_BLOCK_COMPRESSED << 1));
+			} else {
+				header = (size << 3) | (PRIV_ZSTD_BLOCK_RAW << 1);
+				Base::copyMemory(out + 3, src, size);
+				n = size;
+			}
+			if (flagLast) {
+				header |= 1;
+			}
+			out[0] = (sl_uint8)header;
+			out[1] = (sl_uint8)(header >> 8);
+			out[2] = (sl_uint8)(header >> 16);
+			m_sizeOutput += (sl_uint32)(n + 3);
+			m_posBlock = posEnd;
+			if (flagLast) {
+				if (m_flagChecksum) {
+					MIO::writeUint32LE(m_output + m_sizeOutput, (sl_uint32)(m_hash.finish()));
+					m_sizeOutput += 4;
+				}
+				m_flagEnded = sl_true;
+			}
+		}
+
+	private:
+		void _slideWindow()
+		{
+			if (m_posBlock <= m_sizeWindow) {
+				return;
+			}
+			sl_uint32 shift = m_posBlock - m_sizeWindow;
+			Base::moveMemory(m_window, m_window + shift, m_posEnd - shift);
+			m_posEnd -= shift;
+			m_posBlock -= shift;
+			m_indexBase += shift;
+			if (m_indexLow < m_indexBase) {
+				m_indexLow = m_indexBase;
+			}
+			if (m_indexNextUpdate < m_indexBase) {
+				m_indexNextUpdate = m_indexBase;
+			}
+			if (m_indexBase > 0xC0000000) {
+				// rebase the indices before overflow
+				sl_uint32 delta = m_indexBase - 1;
+				sl_uint32 n = m_sizeHashTable + m_sizeChainTable;
+				for (sl_uint32 i = 0; i < n; i++) {
+					sl_uint32 v = m_hashTable[i];
+					m_hashTable[i] = v > delta ? v - delta : 0;
+				}
+				m_indexBase -= delta;
+				m_indexLow -= delta;
+				m_indexNextUpdate -= delta;
+			}
+		}
+
+		void _loadDictionary()
+		{
+			if (m_posEnd < 8) {
+				return;
+			}
+			sl_uint32 n = m_posEnd - 8;
+			sl_uint32 hashLog = m_params.hashLog;
+			if (m_params.chainLog) {
+				_insertChain(m_indexBase + n);
+			} else {
+				for (sl_uint32 i = 0; i < n; i++) {
+					sl_uint32 h = m_params.minMatch == 5 ? _priv_Zstd_hash<5>(m_window + i, hashLog) : _priv_Zstd_hash<6>(m_window + i, hashLog);
+					m_hashTable[h] = m_indexBase + i;
+				}
+			}
+		}
+
+		SLIB_INLINE void _storeSequence(const sl_uint8* literals, sl_size litLength, sl_uint32 offBase, sl_size matchLength)
+		{
+			if (litLength) {
+				_priv_Zstd_wildCopy(m_literalsEnd, literals, litLength);
+				m_literalsEnd += litLength;
+			}
+			_priv_ZstdSequence& seq = m_sequences[m_nSequences++];
+			seq.litLength = (sl_uint32)litLength;
+			seq.offBase = offBase;
+			seq.matchLength = (sl_uint32)matchLength;
+		}
+
+		SLIB_INLINE void _storeLastLiterals(const sl_uint8* literals, sl_size size)
+		{
+			Base::copyMemory(m_literalsEnd, literals, size);
+			m_literalsEnd += size;
+		}
+
+		template <sl_uint32 MLS>
+		void _compressFast(sl_uint32 posStart, sl_uint32 posEnd)
+		{
+			const sl_uint8* base = m_window;
+			sl_uint32 indexBase = m_indexBase;
+			sl_uint32 indexLow = m_indexLow;
+			sl_uint32 sizeWindow = m_sizeWindow;
+			sl_uint32* hashTable = m_hashTable;
+			sl_uint32 hashLog = m_params.hashLog;
+			const sl_uint8* ip = base + posStart;
+			const sl_uint8* anchor = ip;
+			const sl_uint8* iend = base + posEnd;
+			const sl_uint8* ilimit = iend - 8;
+			const sl_uint8* lowest = base + (indexLow - indexBase);
+			sl_uint32 rep0 = m_rep[0];
+			sl_uint32 rep1 = m_rep[1];
+			sl_uint32 rep2 = m_rep[2];
+			while (ip < ilimit) {
+				sl_uint32 curr = (sl_uint32)(ip - base) + indexBase;
+				sl_uint32 maxOffset = SLIB_MIN(curr - indexLow, sizeWindow);
+				sl_uint32 h = _priv_Zstd_hash<MLS>(ip, hashLog);
+				sl_uint32 matchIndex = hashTable[h];
+				hashTable[h] = curr;
+				sl_size len;
+				if (rep0 - 1 < maxOffset && MIO::readUint32LE(ip + 1) == MIO::readUint32LE(ip + 1 - rep0)) {
+					len = _priv_Zstd_count(ip + 5, ip + 5 - rep0, iend) + 4;
+					ip++;
+					_storeSequence(anchor, ip - anchor, 1, len);
+				} else {
+					const sl_uint8* match = base + (matchIndex - indexBase);
+					if (curr - matchIndex > maxOffset || MIO::readUint32LE(match) != MIO::readUint32LE(ip)) {
+						ip += ((ip - anchor) >> 8) + 1;
+						continue;
+					}
+					len = _priv_Zstd_count(ip + 4, match + 4, iend) + 4;
+					while (ip > anchor && match > lowest && ip[-1] == match[-1]) {
+						ip--;
+						match--;
+						len++;
+					}
+					rep2 = rep1;
+					rep1 = rep0;
+					rep0 = (sl_uint32)(ip - match);
+					_storeSequence(anchor, ip - anchor, rep0 + 3, len);
+				}
+				ip += len;
+				anchor = ip;
+				if (ip <= ilimit) {
+					hashTable[_priv_Zstd_hash<MLS>(base + (curr + 2 - indexBase), hashLog)] = curr + 2;
+					hashTable[_priv_Zstd_hash<MLS>(ip - 2, hashLog)] = (sl_uint32)(ip - 2 - base) + indexBase;
+					// repeat offset 2 immediately after the match
+					for (;;) {
+						if (ip > ilimit) {
+							break;
+						}
+						curr = (sl_uint32)(ip - base) + indexBase;
+						if (rep1 - 1 >= SLIB_MIN(curr - indexLow, sizeWindow) || MIO::readUint32LE(ip) != MIO::readUint32LE(ip - rep1)) {
+							break;
+						}
+						len = _priv_Zstd_count(ip + 4, ip + 4 - rep1, iend) + 4;
+						sl_uint32 t = rep0;
+						rep0 = rep1;
+						rep1 = t;
+						hashTable[_priv_Zstd_hash<MLS>(ip, hashLog)] = curr;
+						_storeSequence(anchor, 0, 1, len);
+						ip += len;
+						anchor = ip;
+					}
+				}
+			}
+			_storeLastLiterals(anchor, iend - anchor);
+			m_rep[0] = rep0;
+			m_rep[1] = rep1;
+			m_rep[2] = rep2;
+		}
+
+		template <sl_uint32 MLS>
+		SLIB_INLINE void _insertChain(sl_uint32 target)
+		{
+			const sl_uint8* base = m_window;
+			sl_uint32 indexBase = m_indexBase;
+			sl_uint32* hashTable = m_hashTable;
+			sl_uint32* chainTable = m_chainTable;
+			sl_uint32 hashLog = m_params.hashLog;
+			sl_uint32 chainMask = m_sizeChainTable - 1;
+			for (sl_uint32 index = m_indexNextUpdate; index < target; index++) {
+				sl_uint32 h = _priv_Zstd_hash<MLS>(base + (index - indexBase), hashLog);
+				chainTable[index & chainMask] = hashTable[h];
+				hashTable[h] = index;
+			}
+			if (target > m_indexNextUpdate) {
+				m_indexNextUpdate = target;
+			}
+		}
+
+		void _insertChain(sl_uint32 target)
+		{
+			if (m_params.minMatch == 4) {
+				_insertChain<4>(target);
+			} else {
+				_insertChain<5>(target);
+			}
+		}
+
+		template <sl_uint32 MLS>
+		SLIB_INLINE sl_size _findBestMatch(const sl_uint8* ip, const sl_uint8* iend, sl_uint32& offset)
+		{
+			const sl_uint8* base = m_window;
+			sl_uint32 indexBase = m_indexBase;
+			sl_uint32 curr = (sl_uint32)(ip - base) + indexBase;
+			_insertChain<MLS>(curr + 1);
+			sl_uint32 lowLimit = curr - SLIB_MIN(curr - m_indexLow, m_sizeWindow);
+			sl_uint32 minChain = curr > m_sizeChainTable ? curr - m_sizeChainTable : 0;
+			sl_uint32 chainMask = m_sizeChainTable - 1;
+			sl_uint32* chainTable = m_chainTable;
+			sl_uint32 matchIndex = chainTable[curr & chainMask];
+			sl_uint32 nAttempts = 1 << m_params.searchLog;
+			sl_size best = 3;
+			sl_uint32 first = MIO::readUint32LE(ip);
+			while (matchIndex >= lowLimit && nAttempts) {
+				nAttempts--;
+				const sl_uint8* match = base + (matchIndex - indexBase);
+				if (match[best] == ip[best] && MIO::readUint32LE(match) == first) {
+					sl_size len = _priv_Zstd_count(ip + 4, match + 4, iend) + 4;
+					if (len > best) {
+						best = len;
+						offset = curr - matchIndex;
+						if (ip + len == iend) {
+							break;
+						}
+					}
+				}
+				if (matchIndex <= minChain) {
+					break;
+				}
+				matchIndex = chainTable[matchIndex & chainMask];
+			}
+			return best > 3 ? best : 0;
+		}
+
+		template <sl_uint32 MLS>
+		void _compressLazy(sl_uint32 posStart, sl_uint32 posEnd)
+		{
+			const sl_uint8* base = m_window;
+			sl_uint32 indexBase = m_indexBase;
+			sl_uint32 indexLow = m_indexLow;
+			sl_uint32 sizeWindow = m_sizeWindow;
+			sl_uint32 lazy = m_params.lazy;
+			const sl_uint8* ip = base + posStart;
+			const sl_uint8* anchor = ip;
+			const sl_uint8* iend = base + posEnd;
+			const sl_uint8* ilimit = iend - 8;
+			const sl_uint8* lowest = base + (indexLow - indexBase);
+			sl_uint32 rep0 = m_rep[0];
+			sl_uint32 rep1 = m_rep[1];
+			sl_uint32 rep2 = m_rep[2];
+			while (ip < ilimit) {
+				sl_size matchLength = 0;
+				sl_uint32 offBase = 0;
+				const sl_uint8* start = ip + 1;
+				sl_uint32 curr = (sl_uint32)(ip - base) + indexBase;
+				if (rep0 - 1 < SLIB_MIN(curr + 1 - indexLow, sizeWindow) && MIO::readUint32LE(ip + 1) == MIO::readUint32LE(ip + 1 - rep0)) {
+					matchLength = _priv_Zstd_count(ip + 5, ip + 5 - rep0, iend) + 4;
+					offBase = 1;
+				}
+				if (!(offBase && !lazy)) {
+					sl_uint32 offset = 0;
+					sl_size len = _findBestMatch<MLS>(ip, iend, offset);
+					if (len > matchLength) {
+						matchLength = len;
+						offBase = offset + 3;
+						start = ip;
+					}
+					if (!matchLength) {
+						ip += ((ip - anchor) >> 8) + 1;
+						continue;
+					}
+					// lazy evaluation of the next positions
+					sl_uint32 step = 0;
+					while (step < lazy && ip < ilimit) {
+						ip++;
+						step++;
+						curr++;
+						sl_int32 bonusRep = step == 1 ? 1 : 0;
+						sl_int32 bonusSearch = step == 1 ? 4 : 7;
+						if (offBase != 1 && rep0 - 1 < SLIB_MIN(curr - indexLow, sizeWindow) && MIO::readUint32LE(ip) == MIO::readUint32LE(ip - rep0)) {
+							sl_size lenRep = _priv_Zstd_count(ip + 4, ip + 4 - rep0, iend) + 4;
+							sl_int32 gain2 = (sl_int32)(lenRep * 3);
+							sl_int32 gain1 = (sl_int32)(matchLength * 3) - (sl_int32)_priv_Zstd_highbit(offBase) + bonusRep;
+							if (gain2 > gain1) {
+								matchLength = lenRep;
+								offBase = 1;
+								start = ip;
+							}
+						}
+						len = _findBestMatch<MLS>(ip, iend, offset);
+						if (len) {
+							sl_int32 gain2 = (sl_int32)(len * 4) - (sl_int32)_priv_Zstd_highbit(offset + 3);
+							sl_int32 gain1 = (sl_int32)(matchLength * 4) - (sl_int32)_priv_Zstd_highbit(offBase) + bonusSearch;
+							if (gain2 > gain1) {
+								matchLength = len;
+								offBase = offset + 3;
+								start = ip;
+								step = 0;
+							}
+						}
+					}
+				}
+				if (offBase > 3) {
+					const sl_uint8* match = start - (offBase - 3);
+					while (start > anchor && match > lowest && start[-1] == match[-1]) {
+						start--;
+						match--;
+						matchLength++;
+					}
+					rep2 = rep1;
+					rep1 = rep0;
+					rep0 = offBase - 3;
+				}
+				_storeSequence(anchor, start - anchor, offBase, matchLength);
+				ip = start + matchLength;
+				anchor = ip;
+				// repeat offset 2 immediately after the match
+				for (;;) {
+					if (ip > ilimit) {
+						break;
+					}
+					curr = (sl_uint32)(ip - base) + indexBase;
+					if (rep1 - 1 >= SLIB_MIN(curr - indexLow, sizeWindow) || MIO::readUint32LE(ip) != MIO::readUint32LE(ip - rep1)) {
+						break;
+					}
+					sl_size len = _priv_Zstd_count(ip + 4, ip + 4 - rep1, iend) + 4;
+					sl_uint32 t = rep0;
+					rep0 = rep1;
+					rep1 = t;
+					_storeSequence(anchor, 0, 1, len);
+					ip += len;
+					anchor = ip;
+				}
+			}
+			_storeLastLiterals(anchor, iend - anchor);
+			m_rep[0] = rep0;
+			m_rep[1] = rep1;
+			m_rep[2] = rep2;
+		}
+
+		void _collectStatistics()
+		{
+			_priv_ZstdStatistics* s = m_statistics;
+			for (sl_uint8* p = m_literals; p < m_literalsEnd; p++) {
+				s->literals[*p]++;
+			}
+			for (sl_uint32 i = 0; i < m_nSequences; i++) {
+				_priv_ZstdSequence& seq = m_sequences[i];
+				s->LL[_priv_Zstd_getLLCode(seq.litLength)]++;
+				s->ML[_priv_Zstd_getMLCode(seq.matchLength)]++;
+				s->OF[_priv_Zstd_highbit(seq.offBase)]++;
+			}
+		}
+
+		sl_size _writeCompressedBlock(sl_uint8* dst, sl_size size)
+		{
+			sl_size nLiterals = m_literalsEnd - m_literals;
+			sl_size n = _priv_Zstd_writeLiterals(dst, size, m_literals, nLiterals);
+			if (!n) {
+				return 0;
+			}
+			sl_size m = _priv_Zstd_writeSequences(dst + n, size - n, m_sequences, m_nSequences, m_codes);
+			if (!m) {
+				return 0;
+			}
+			return n + m;
+		}
+
+	};
+
+	// copies the match which may overlap the destination. Writes up to 16 bytes after the end
+	SLIB_INLINE static void _priv_Zstd_copyMatch(sl_uint8* op, sl_size offset, sl_size length)
+	{
+		const sl_uint8* match = op - offset;
+		if (offset >= 16) {
+			_priv_Zstd_wildCopy(op, match, length);
+			return;
+		}
+		sl_uint8* end = op + length;
+		if (offset < 8) {
+			// extends the pattern until the distance is 8 or more
+			sl_size period = offset;
+			while (period < 8) {
+				period += offset;
+			}
+			for (sl_size i = 0; i < period; i++) {
+				op[i] = match[i];
+			}
+			op += period;
+			if (op >= end) {
+				return;
+			}
+			match = op - period;
+		}
+		do {
+			Base::copyMemory(op, match, 8);
+			op += 8;
+			match += 8;
+		} while (op < end);
+	}
+
+	static sl_uint32 _priv_Zstd_getFrameHeaderSize(sl_uint8 descriptor)
+	{
+		static const sl_uint8 sizesDictionaryId[4] = { 0, 1, 2, 4 };
+		static const sl_uint8 sizesContentSize[4] = { 0, 2, 4, 8 };
+		sl_uint32 flagSingleSegment = (descriptor >> 5) & 1;
+		sl_uint32 fcs = descriptor >> 6;
+		return 1 + !flagSingleSegment + sizesDictionaryId[descriptor & 3] + sizesContentSize[fcs] + (!fcs && flagSingleSegment);
+	}
+
+#define PRIV_ZSTD_STATE_MAGIC 0
+#define PRIV_ZSTD_STATE_FRAME_DESCRIPTOR 1
+#define PRIV_ZSTD_STATE_FRAME_HEADER 2
+#define PRIV_ZSTD_STATE_BLOCK_HEADER 3
+#define PRIV_ZSTD_STATE_BLOCK_DATA 4
+#define PRIV_ZSTD_STATE_CONTENT_CHECKSUM 5
+#define PRIV_ZSTD_STATE_SKIPPABLE_SIZE 6
+#define PRIV_ZSTD_STATE_SKIPPABLE_DATA 7
+#define PRIV_ZSTD_STATE_END 8
+
+	class _priv_ZstdDecoder : public Referable
+	{
+	public:
+		Ref<ZstdDictionary> m_dictionary;
+		// one-shot decoding: the output of a frame is not discarded
+		sl_bool m_flagKeepAll;
+		sl_size m_sizeRemainingInput;
+
+		// streaming state
+		sl_uint32 m_state;
+		sl_uint32 m_sizeNeeded;
+		Memory m_bufInput;
+		sl_uint32 m_sizeInput;
+		sl_uint32 m_blockType;
+		sl_uint32 m_sizeBlock;
+		sl_bool m_flagLastBlock;
+
+		// frame
+		sl_uint64 m_sizeContent;
+		sl_uint64 m_sizeDecoded;
+		sl_uint64 m_sizeWindow;
+		sl_uint32 m_sizeBlockMax;
+		sl_bool m_flagChecksum;
+		XXHash64 m_hash;
+
+		// output window, starting with the dictionary content
+		Memory m_memOutput;
+		sl_uint8* m_output;
+		sl_size m_sizeOutputBuffer;
+		sl_size m_posFrame;
+		sl_size m_posOutput;
+		sl_size m_posFlushed;
+
+		// entropy
+		_priv_ZstdHufTable m_huf;
+		_priv_ZstdFseTable m_tableLL;
+		_priv_ZstdFseTable m_tableOF;
+		_priv_ZstdFseTable m_tableML;
+		_priv_ZstdFseTable m_tableDefaultLL;
+		_priv_ZstdFseTable m_tableDefaultOF;
+		_priv_ZstdFseTable m_tableDefaultML;
+		const _priv_ZstdHufTable* m_pHuf;
+		const _priv_ZstdFseTable* m_pLL;
+		const _priv_ZstdFseTable* m_pOF;
+		const _priv_ZstdFseTable* m_pML;
+		sl_uint32 m_rep[3];
+
+		Memory m_memLiterals;
+		sl_uint8* m_literals;
+
+	public:
+		_priv_ZstdDecoder()
+		{
+			m_flagKeepAll = sl_false;
+			m_sizeRemainingInput = SLIB_SIZE_MAX;
+			m_state = PRIV_ZSTD_STATE_MAGIC;
+			m_sizeNeeded = 4;
+			m_sizeInput = 0;
+			m_sizeOutputBuffer = 0;
+			m_output = sl_null;
+			m_posFrame = 0;
+			m_posOutput = 0;
+			m_posFlushed = 0;
+			m_literals = sl_null;
+			_priv_Zstd_buildFseTable(m_tableDefaultLL, _priv_Zstd_LL_default, PRIV_ZSTD_LL_MAX, PRIV_ZSTD_LL_DEFAULT_LOG, _priv_Zstd_LL_base, _priv_Zstd_LL_bits);
+			_priv_Zstd_buildFseTable(m_tableDefaultOF, _priv_Zstd_OF_default, PRIV_ZSTD_OF_DEFAULT_MAX, PRIV_ZSTD_OF_DEFAULT_LOG, _priv_Zstd_OF_base, _priv_Zstd_OF_bits);
+			_priv_Zstd_buildFseTable(m_tableDefaultML, _priv_Zstd_ML_default, PRIV_ZSTD_ML_MAX, PRIV_ZSTD_ML_DEFAULT_LOG, _priv_Zstd_ML_base, _priv_Zstd_ML_bits);
+		}
+
+	public:
+		void reset()
+		{
+			m_state = PRIV_ZSTD_STATE_MAGIC;
+			m_sizeNeeded = 4;
+			m_sizeInput = 0;
+			m_posFrame = 0;
+			m_posOutput = 0;
+			m_posFlushed = 0;
+		}
+
+		// `header` starts from the frame header descriptor
+		sl_bool beginFrame(const sl_uint8* header, sl_uint32 size)
+		{
+			sl_uint32 descriptor = header[0];
+			if (descriptor & 8) {
+				// reserved bit
+				return sl_false;
+			}
+			sl_bool flagSingleSegment = (descriptor >> 5) & 1;
+			sl_uint32 fcs = descriptor >> 6;
+			const sl_uint8* p = header + 1;
+			if (!flagSingleSegment) {
+				sl_uint32 wd = *(p++);
+				sl_uint32 windowLog = PRIV_ZSTD_WINDOW_LOG_MIN + (wd >> 3);
+				sl_uint64 windowBase = (sl_uint64)1 << windowLog;
+				m_sizeWindow = windowBase + (windowBase >> 3) * (wd & 7);
+			}
+			sl_uint32 idDictionary = 0;
+			switch (descriptor & 3) {
+				case 1:
+					idDictionary = *p;
+					p++;
+					break;
+				case 2:
+					idDictionary = MIO::readUint16LE(p);
+					p += 2;
+					break;
+				case 3:
+					idDictionary = MIO::readUint32LE(p);
+					p += 4;
+					break;
+			}
+			switch (fcs) {
+				case 0:
+					if (flagSingleSegment) {
+						m_sizeContent = *p;
+					} else {
+						m_sizeContent = SLIB_UINT64_MAX;
+					}
+					break;
+				case 1:
+					m_sizeContent = MIO::readUint16LE(p) + 256;
+					break;
+				case 2:
+					m_sizeContent = MIO::readUint32LE(p);
+					break;
+				default:
+					m_sizeContent = MIO::readUint64LE(p);
+					break;
+			}
+			if (flagSingleSegment) {
+				m_sizeWindow = m_sizeContent;
+			}
+			if (!m_flagKeepAll && m_sizeWindow > ((sl_uint64)1 << PRIV_ZSTD_WINDOW_LOG_MAX)) {
+				return sl_false;
+			}
+			m_sizeBlockMax = (sl_uint32)(SLIB_MIN(m_sizeWindow, PRIV_ZSTD_BLOCK_SIZE_MAX));
+			if (m_sizeContent != SLIB_UINT64_MAX && m_flagKeepAll) {
+				// each block (3 bytes header at least) regenerates up to maximum block size
+				if (m_sizeContent > (sl_uint64)(m_sizeRemainingInput / 3 + 1) * m_sizeBlockMax) {
+					return sl_false;
+				}
+			}
+			m_flagChecksum = (descriptor >> 2) & 1;
+			m_sizeDecoded = 0;
+			m_hash.start(0);
+
+			const sl_uint8* contentDictionary = sl_null;
+			sl_size sizeDictionary = 0;
+			m_pHuf = sl_null;
+			m_pLL = sl_null;
+			m_pOF = sl_null;
+			m_pML = sl_null;
+			m_rep[0] = 1;
+			m_rep[1] = 4;
+			m_rep[2] = 8;
+			ZstdDictionary* dictionary = m_dictionary.get();
+			if (idDictionary) {
+				if (!dictionary || dictionary->m_id != idDictionary) {
+					return sl_false;
+				}
+			}
+			if (dictionary) {
+				contentDictionary = dictionary->m_content;
+				sizeDictionary = dictionary->m_sizeContent;
+				if (dictionary->m_entropy.isNotNull()) {
+					_priv_ZstdEntropy* entropy = (_priv_ZstdEntropy*)(dictionary->m_entropy.getData());
+					m_pHuf = &(entropy->huf);
+					m_pLL = &(entropy->tableLL);
+					m_pOF = &(entropy->tableOF);
+					m_pML = &(entropy->tableML);
+					m_rep[0] = dictionary->m_rep[0];
+					m_rep[1] = dictionary->m_rep[1];
+					m_rep[2] = dictionary->m_rep[2];
+				}
+			}
+
+			// output buffer
+			sl_uint64 sizeFrame = m_sizeWindow << 1;
+			if (m_sizeContent < sizeFrame || m_flagKeepAll) {
+				sizeFrame = m_sizeContent;
+			}
+			sl_size sizeExtra = m_sizeBlockMax + 2 * PRIV_ZSTD_WILDCOPY_LENGTH;
+			sl_uint64 sizeBuffer;
+			if (sizeFrame == SLIB_UINT64_MAX) {
+				sizeBuffer = sizeDictionary + SLIB_MAX(m_sizeBlockMax, 0x10000) + sizeExtra;
+			} else {
+				sizeBuffer = sizeDictionary + sizeFrame + sizeExtra;
+			}
+			if (sizeBuffer > SLIB_SIZE_MAX) {
+				return sl_false;
+			}
+			if (m_flagKeepAll || m_sizeOutputBuffer < sizeBuffer) {
+				if (!(_allocateOutput((sl_size)sizeBuffer))) {
+					return sl_false;
+				}
+			}
+			if (sizeDictionary) {
+				Base::copyMemory(m_output, contentDictionary, sizeDictionary);
+			}
+			m_posFrame = sizeDictionary;
+			m_posOutput = sizeDictionary;
+			m_posFlushed = sizeDictionary;
+			if (m_memLiterals.isNull()) {
+				m_memLiterals = Memory::create(PRIV_ZSTD_BLOCK_SIZE_MAX + PRIV_ZSTD_WILDCOPY_LENGTH);
+				if (m_memLiterals.isNull()) {
+					return sl_false;
+				}
+				m_literals = (sl_uint8*)(m_memLiterals.getData());
+			}
+			return sl_true;
+		}
+
+		sl_bool decodeBlock(sl_uint32 type, const sl_uint8* src, sl_uint32 size)
+		{
+			if (!(_reserveOutput())) {
+				return sl_false;
+			}
+			sl_uint8* dst = m_output + m_posOutput;
+			sl_size n;
+			switch (type) {
+				case PRIV_ZSTD_BLOCK_RAW:
+					if (size > m_sizeBlockMax) {
+						return sl_false;
+					}
+					Base::copyMemory(dst, src, size);
+					n = size;
+					break;
+				case PRIV_ZSTD_BLOCK_RLE:
+					// `size` is the regenerated size
+					if (size > m_sizeBlockMax) {
+						return sl_false;
+					}
+					Base::resetMemory(dst, *src, size);
+					n = size;
+					break;
+				case PRIV_ZSTD_BLOCK_COMPRESSED:
+					if (size > m_sizeBlockMax) {
+						return sl_false;
+					}
+					n = _decodeCompressedBlock(src, size);
+					if (n == SLIB_SIZE_MAX) {
+						return sl_false;
+					}
+					break;
+				default:
+					return sl_false;
+			}
+			m_sizeDecoded += n;
+			if (m_sizeDecoded > m_sizeContent) {
+				return sl_false;
+			}
+			if (m_flagChecksum) {
+				m_hash.update(dst, n);
+			}
+			m_posOutput += n;
+			return sl_true;
+		}
+
+		sl_bool endFrame(const sl_uint8* checksum)
+		{
+			if (m_sizeContent != SLIB_UINT64_MAX && m_sizeDecoded != m_sizeContent) {
+				return sl_false;
+			}
+			if (m_flagChecksum) {
+				if ((sl_uint32)(m_hash.finish()) != MIO::readUint32LE(checksum)) {
+					return sl_false;
+				}
+			}
+			return sl_true;
+		}
+
+		// decodes all concatenated frames
+		Memory decodeFrames(const sl_uint8* src, sl_size size)
+		{
+			m_flagKeepAll = sl_true;
+			MemoryBuffer buf;
+			Memory output;
+			sl_uint32 nFrames = 0;
+			while (size) {
+				if (size < 8) {
+					return sl_null;
+				}
+				sl_uint32 magic = MIO::readUint32LE(src);
+				if ((magic & 0xFFFFFFF0) == PRIV_ZSTD_SKIPPABLE_MAGIC) {
+					sl_uint32 n = MIO::readUint32LE(src + 4);
+					if (n > size - 8) {
+						return sl_null;
+					}
+					src += 8 + n;
+					size -= 8 + n;
+					continue;
+				}
+				if (magic != PRIV_ZSTD_MAGIC) {
+					return sl_null;
+				}
+				sl_uint32 sizeHeader = _priv_Zstd_getFrameHeaderSize(src[4]);
+				if (4 + sizeHeader + 3 > size) {
+					return sl_null;
+				}
+				m_sizeRemainingInput = size - 4 - sizeHeader;
+				if (!(beginFrame(src + 4, sizeHeader))) {
+					return sl_null;
+				}
+				src += 4 + sizeHeader;
+				size -= 4 + sizeHeader;
+				for (;;) {
+					if (size < 3) {
+						return sl_null;
+					}
+					sl_uint32 header = src[0] | ((sl_uint32)(src[1]) << 8) | ((sl_uint32)(src[2]) << 16);
+					sl_uint32 type = (header >> 1) & 3;
+					sl_uint32 sizeBlock = header >> 3;
+					sl_uint32 sizeData = type == PRIV_ZSTD_BLOCK_RLE ? 1 : sizeBlock;
+					if (sizeData > size - 3) {
+						return sl_null;
+					}
+					if (!(decodeBlock(type, src + 3, sizeBlock))) {
+						return sl_null;
+					}
+					src += 3 + sizeData;
+					size -= 3 + sizeData;
+					if (header & 1) {
+						break;
+					}
+				}
+				if (m_flagChecksum) {
+					if (size < 4) {
+						return sl_null;
+					}
+				}
+				if (!(endFrame(src))) {
+					return sl_null;
+				}
+				if (m_flagChecksum) {
+					src += 4;
+					size -= 4;
+				}
+				if (nFrames) {
+					if (nFrames == 1) {
+						buf.add(output);
+					}
+					buf.add(m_memOutput.sub(m_posFrame, m_posOutput - m_posFrame));
+				} else {
+					output = m_memOutput.sub(m_posFrame, m_posOutput - m_posFrame);
+				}
+				nFrames++;
+			}
+			if (nFrames > 1) {
+				return buf.merge();
+			}
+			return output;
+		}
+
+		// processes the input required by current state
+		sl_bool processInput(const sl_uint8* data, sl_uint32 size)
+		{
+			switch (m_state) {
+				case PRIV_ZSTD_STATE_MAGIC:
+					{
+						sl_uint32 magic = MIO::readUint32LE(data);
+						if (magic == PRIV_ZSTD_MAGIC) {
+							m_state = PRIV_ZSTD_STATE_FRAME_DESCRIPTOR;
+							m_sizeNeeded = 1;
+							return sl_true;
+						}
+						if ((magic & 0xFFFFFFF0) == PRIV_ZSTD_SKIPPABLE_MAGIC) {
+							m_state = PRIV_ZSTD_STATE_SKIPPABLE_SIZE;
+							m_sizeNeeded = 4;
+							return sl_true;
+						}
+						return sl_false;
+					}
+				case PRIV_ZSTD_STATE_FRAME_DESCRIPTOR:
+					{
+						// the descriptor is kept at the front of input buffer
+						if (data != m_bufInput.getData()) {
+							*((sl_uint8*)(m_bufInput.getData())) = *data;
+						}
+						m_sizeInput = 1;
+						m_sizeNeeded = _priv_Zstd_getFrameHeaderSize(*data);
+						m_state = PRIV_ZSTD_STATE_FRAME_HEADER;
+						return sl_true;
+					}
+				case PRIV_ZSTD_STATE_FRAME_HEADER:
+					{
+						if (!(beginFrame(data, size))) {
+							return sl_false;
+						}
+						m_state = PRIV_ZSTD_STATE_BLOCK_HEADER;
+						m_sizeNeeded = 3;
+						return sl_true;
+					}
+				case PRIV_ZSTD_STATE_BLOCK_HEADER:
+					{
+						sl_uint32 header = data[0] | ((sl_uint32)(data[1]) << 8) | ((sl_uint32)(data[2]) << 16);
+						m_flagLastBlock = header & 1;
+						m_blockType = (header >> 1) & 3;
+						m_sizeNeeded = header >> 3;
+						if (m_sizeNeeded > m_sizeBlockMax) {
+							return sl_false;
+						}
+						if (m_blockType == PRIV_ZSTD_BLOCK_RLE) {
+							m_sizeNeeded = 1;
+						} else if (!m_sizeNeeded) {
+							return _endBlock();
+						}
+						m_sizeBlock = header >> 3;
+						m_state = PRIV_ZSTD_STATE_BLOCK_DATA;
+						return sl_true;
+					}
+				case PRIV_ZSTD_STATE_BLOCK_DATA:
+					{
+						if (!(decodeBlock(m_blockType, data, m_sizeBlock))) {
+							return sl_false;
+						}
+						return _endBlock();
+					}
+				case PRIV_ZSTD_STATE_CONTENT_CHECKSUM:
+					{
+						if (!(endFrame(data))) {
+							return sl_false;
+						}
+						m_state = PRIV_ZSTD_STATE_END;
+						return sl_true;
+					}
+				case PRIV_ZSTD_STATE_SKIPPABLE_SIZE:
+					{
+						m_sizeNeeded = MIO::readUint32LE(data);
+						if (m_sizeNeeded) {
+							m_state = PRIV_ZSTD_STATE_SKIPPABLE_DATA;
+						} else {
+							m_state = PRIV_ZSTD_STATE_MAGIC;
+							m_sizeNeeded = 4;
+						}
+						return sl_true;
+					}
+			}
+			return sl_false;
+		}
+
+	private:
+		sl_bool _endBlock()
+		{
+			if (m_flagLastBlock) {
+				if (m_flagChecksum) {
+					m_state = PRIV_ZSTD_STATE_CONTENT_CHECKSUM;
+					m_sizeNeeded = 4;
+					return sl_true;
+				}
+				if (!(endFrame(sl_null))) {
+					return sl_false;
+				}
+				m_state = PRIV_ZSTD_STATE_END;
+			} else {
+				m_state = PRIV_ZSTD_STATE_BLOCK_HEADER;
+				m_sizeNeeded = 3;
+			}
+			return sl_true;
+		}
+
+		sl_bool _allocateOutput(sl_size size)
+		{
+			Memory mem = Memory::create(size);
+			if (mem.isNull()) {
+				return sl_false;
+			}
+			m_memOutput = mem;
+			m_output = (sl_uint8*)(mem.getData());
+			m_sizeOutputBuffer = size;
+			return sl_true;
+		}
+
+		// makes the room for a block
+		sl_bool _reserveOutput()
+		{
+			sl_size sizeRequired = m_sizeBlockMax + 2 * PRIV_ZSTD_WILDCOPY_LENGTH;
+			if (m_posOutput + sizeRequired <= m_sizeOutputBuffer) {
+				return sl_true;
+			}
+			if (!m_flagKeepAll) {
+				// keeps the history of the window size
+				sl_size sizeKeep = m_posOutput;
+				if (sizeKeep > m_sizeWindow) {
+					sizeKeep = (sl_size)m_sizeWindow;
+				}
+				sl_size shift = m_posOutput - sizeKeep;
+				if (shift) {
+					Base::moveMemory(m_output, m_output + shift, sizeKeep);
+					m_posOutput = sizeKeep;
+					m_posFlushed = sizeKeep;
+					m_posFrame = m_posFrame > shift ? m_posFrame - shift : 0;
+					if (m_posOutput + sizeRequired <= m_sizeOutputBuffer) {
+						return sl_true;
+					}
+				}
+			}
+			sl_size sizeNew = m_sizeOutputBuffer << 1;
+			if (sizeNew < m_posOutput + sizeRequired) {
+				sizeNew = m_posOutput + sizeRequired;
+			}
+			Memory mem = Memory::create(sizeNew);
+			if (mem.isNull()) {
+				return sl_false;
+			}
+			Base::copyMemory(mem.getData(), m_output, m_posOutput);
+			m_memOutput = mem;
+			m_output = (sl_uint8*)(mem.getData());
+			m_sizeOutputBuffer = sizeNew;
+			return sl_true;
+		}
+
+		// returns the size of literals section, 0 on error
+		sl_size _decodeLiterals(const sl_uint8* src, sl_size size, sl_size& nLiterals)
+		{
+			sl_uint32 type = src[0] & 3;
+			sl_uint32 sizeFormat = (src[0] >> 2) & 3;
+			if (type == PRIV_ZSTD_LITERALS_RAW || type == PRIV_ZSTD_LITERALS_RLE) {
+				sl_size sizeHeader;
+				switch (sizeFormat) {
+					case 1:
+						sizeHeader = 2;
+						if (size < 2) {
+							return 0;
+						}
+						nLiterals = MIO::readUint16LE(src) >> 4;
+						break;
+					case 3:
+						sizeHeader = 3;
+						if (size < 3) {
+							return 0;
+						}
+						nLiterals = (src[0] | ((sl_uint32)(src[1]) << 8) | ((sl_uint32)(src[2]) << 16)) >> 4;
+						break;
+					default:
+						sizeHeader = 1;
+						nLiterals = src[0] >> 3;
+						break;
+				}
+				if (nLiterals > m_sizeBlockMax) {
+					return 0;
+				}
+				if (type == PRIV_ZSTD_LITERALS_RAW) {
+					if (sizeHeader + nLiterals > size) {
+						return 0;
+					}
+					Base::copyMemory(m_literals, src + sizeHeader, nLiterals);
+					return sizeHeader + nLiterals;
+				} else {
+					if (sizeHeader + 1 > size) {
+						return 0;
+					}
+					Base::resetMemory(m_literals, src[sizeHeader], nLiterals);
+					return sizeHeader + 1;
+				}
+			}
+			if (size < 5) {
+				return 0;
+			}
+			sl_size sizeHeader;
+			sl_size sizeCompressed;
+			sl_bool flag4Streams = sizeFormat != 0;
+			switch (sizeFormat) {
+				case 2:
+					{
+						sl_uint32 h = MIO::readUint32LE(src);
+						sizeHeader = 4;
+						nLiterals = (h >> 4) & 0x3FFF;
+						sizeCompressed = h >> 18;
+						break;
+					}
+				case 3:
+					{
+						sl_uint64 h = MIO::readUint32LE(src) | ((sl_uint64)(src[4]) << 32);
+						sizeHeader = 5;
+						nLiterals = (sl_size)((h >> 4) & 0x3FFFF);
+						sizeCompressed = (sl_size)(h >> 22);
+						break;
+					}
+				default:
+					{
+						sl_uint32 h = src[0] | ((sl_uint32)(src[1]) << 8) | ((sl_uint32)(src[2]) << 16);
+						sizeHeader = 3;
+						nLiterals = (h >> 4) & 0x3FF;
+						sizeCompressed = h >> 14;
+						break;
+					}
+			}
+			if (nLiterals > m_sizeBlockMax || sizeHeader + sizeCompressed > size) {
+				return 0;
+			}
+			const sl_uint8* p = src + sizeHeader;
+			sl_size n = sizeCompressed;
+			if (type == PRIV_ZSTD_LITERALS_COMPRESSED) {
+				sl_size sizeTable = _priv_Zstd_readHufTable(m_huf, p, n);
+				if (!sizeTable) {
+					return 0;
+				}
+				m_pHuf = &m_huf;
+				p += sizeTable;
+				n -= sizeTable;
+			} else {
+				if (!m_pHuf) {
+					return 0;
+				}
+			}
+			if (!(_priv_Zstd_decodeHufStreams(m_literals, nLiterals, p, n, *m_pHuf, flag4Streams))) {
+				return 0;
+			}
+			return sizeHeader + sizeCompressed;
+		}
+
+		// returns the size of table description, SLIB_SIZE_MAX on error
+		static sl_size _readSequenceTable(
+			sl_uint32 mode, _priv_ZstdFseTable& table, const _priv_ZstdFseTable*& pTable, const _priv_ZstdFseTable& tableDefault,
+			sl_uint32 maxSymbol, sl_uint32 maxLog, const sl_uint32* baseValues, const sl_uint8* nbAdditionalBits,
+			const sl_uint8* src, sl_size size)
+		{
+			switch (mode) {
+				case PRIV_ZSTD_MODE_PREDEFINED:
+					pTable = &tableDefault;
+					return 0;
+				case PRIV_ZSTD_MODE_RLE:
+					if (!size || *src > maxSymbol) {
+						return SLIB_SIZE_MAX;
+					}
+					_priv_Zstd_buildFseTableRLE(table, *src, baseValues, nbAdditionalBits);
+					pTable = &table;
+					return 1;
+				case PRIV_ZSTD_MODE_COMPRESSED:
+					{
+						sl_int16 norm[PRIV_ZSTD_ML_MAX + 1];
+						sl_uint32 tableLog;
+						sl_size n = _priv_Zstd_readNCount(norm, maxSymbol, tableLog, maxLog, src, size);
+						if (!n || n > size) {
+							return SLIB_SIZE_MAX;
+						}
+						if (!(_priv_Zstd_buildFseTable(table, norm, maxSymbol, tableLog, baseValues, nbAdditionalBits))) {
+							return SLIB_SIZE_MAX;
+						}
+						pTable = &table;
+						return n;
+					}
+				default:
+					if (!pTable) {
+						return SLIB_SIZE_MAX;
+					}
+					return 0;
+			}
+		}
+
+		// returns the regenerated size, SLIB_SIZE_MAX on error
+		sl_size _decodeCompressedBlock(const sl_uint8* src, sl_size size)
+		{
+			if (!size) {
+				return SLIB_SIZE_MAX;
+			}
+			sl_size nLiterals = 0;
+			sl_size n = _decodeLiterals(src, size, nLiterals);
+			if (!n || n >= size) {
+				return SLIB_SIZE_MAX;
+			}
+			const sl_uint8* p = src + n;
+			const sl_uint8* end = src + size;
+			sl_uint32 nSeq = *(p++);
+			if (nSeq >= 128) {
+				if (nSeq == 255) {
+					if (p + 2 > end) {
+						return SLIB_SIZE_MAX;
+					}
+					nSeq = MIO::readUint16LE(p) + 0x7F00;
+					p += 2;
+				} else {
+					if (p >= end) {
+						return SLIB_SIZE_MAX;
+					}
+					nSeq = ((nSeq - 128) << 8) + *(p++);
+				}
+			}
+			sl_uint8* op = m_output + m_posOutput;
+			if (!nSeq) {
+				Base::copyMemory(op, m_literals, nLiterals);
+				return nLiterals;
+			}
+			if (p >= end) {
+				return SLIB_SIZE_MAX;
+			}
+			sl_uint32 modes = *(p++);
+			if (modes & 3) {
+				return SLIB_SIZE_MAX;
+			}
+			n = _readSequenceTable(modes >> 6, m_tableLL, m_pLL, m_tableDefaultLL, PRIV_ZSTD_LL_MAX, PRIV_ZSTD_LL_LOG, _priv_Zstd_LL_base, _priv_Zstd_LL_bits, p, end - p);
+			if (n == SLIB_SIZE_MAX) {
+				return SLIB_SIZE_MAX;
+			}
+			p += n;
+			n = _readSequenceTable((modes >> 4) & 3, m_tableOF, m_pOF, m_tableDefaultOF, PRIV_ZSTD_OF_MAX, PRIV_ZSTD_OF_LOG, _priv_Zstd_OF_base, _priv_Zstd_OF_bits, p, end - p);
+			if (n == SLIB_SIZE_MAX) {
+				return SLIB_SIZE_MAX;
+			}
+			p += n;
+			n = _readSequenceTable((modes >> 2) & 3, m_tableML, m_pML, m_tableDefaultML, PRIV_ZSTD_ML_MAX, PRIV_ZSTD_ML_LOG, _priv_Zstd_ML_base, _priv_Zstd_ML_bits, p, end - p);
+			if (n == SLIB_SIZE_MAX) {
+				return SLIB_SIZE_MAX;
+			}
+			p += n;
+			return _executeSequences(nSeq, nLiterals, p, end - p);
+		}
+
+		sl_size _executeSequences(sl_uint32 nSeq, sl_size nLiterals, const sl_uint8* src, sl_size size)
+		{
+			_priv_ZstdBitReader bits;
+			if (!(bits.init(src, size))) {
+				return SLIB_SIZE_MAX;
+			}
+			const _priv_ZstdFseEntry* tableLL = m_pLL->entries;
+			const _priv_ZstdFseEntry* tableOF = m_pOF->entries;
+			const _priv_ZstdFseEntry* tableML = m_pML->entries;
+			sl_uint32 stateLL = bits.read(m_pLL->tableLog);
+			sl_uint32 stateOF = bits.read(m_pOF->tableLog);
+			sl_uint32 stateML = bits.read(m_pML->tableLog);
+			bits.reload();
+			sl_uint8* ostart = m_output + m_posOutput;
+			sl_uint8* op = ostart;
+			sl_uint8* oend = op + m_sizeBlockMax;
+			const sl_uint8* lowest = m_output;
+			const sl_uint8* lit = m_literals;
+			const sl_uint8* litEnd = lit + nLiterals;
+			sl_uint32 rep0 = m_rep[0];
+			sl_uint32 rep1 = m_rep[1];
+			sl_uint32 rep2 = m_rep[2];
+			for (;;) {
+				const _priv_ZstdFseEntry& eLL = tableLL[stateLL];
+				const _priv_ZstdFseEntry& eOF = tableOF[stateOF];
+				const _priv_ZstdFseEntry& eML = tableML[stateML];
+				sl_uint32 offBase = eOF.baseValue + bits.read(eOF.nbAdditionalBits);
+				// 57 bits are available after reloading: the states need 26 bits at most
+				if (eOF.nbAdditionalBits + eML.nbAdditionalBits + eLL.nbAdditionalBits > 31) {
+					bits.reload();
+				}
+				sl_size matchLength = eML.baseValue + bits.read(eML.nbAdditionalBits);
+				sl_size litLength = eLL.baseValue + bits.read(eLL.nbAdditionalBits);
+				sl_size offset;
+				if (offBase > 3) {
+					offset = offBase - 3;
+					rep2 = rep1;
+					rep1 = rep0;
+					rep0 = (sl_uint32)offset;
+				} else {
+					sl_uint32 index = offBase - 1 + !litLength;
+					if (!index) {
+						offset = rep0;
+					} else {
+						if (index == 1) {
+							offset = rep1;
+						} else {
+							if (index == 2) {
+								offset = rep2;
+							} else {
+								offset = rep0 - 1;
+							}
+							rep2 = rep1;
+						}
+						rep1 = rep0;
+						rep0 = (sl_uint32)offset;
+					}
+				}
+				if (litLength > (sl_size)(litEnd - lit) || matchLength > (sl_size)(oend - op) || litLength > (sl_size)(oend - op) - matchLength) {
+					return SLIB_SIZE_MAX;
+				}
+				_priv_Zstd_wildCopy(op, lit, litLength);
+				op += litLength;
+				lit += litLength;
+				if (!offset || offset > (sl_size)(op - lowest)) {
+					return SLIB_SIZE_MAX;
+				}
+				_priv_Zstd_copyMatch(op, offset, matchLength);
+				op += matchLength;
+				if (!(--nSeq)) {
+					break;
+				}
+				stateLL = eLL.nextState + bits.read(eLL.nbBits);
+				stateML = eML.nextState + bits.read(eML.nbBits);
+				stateOF = eOF.nextState + bits.read(eOF.nbBits);
+				bits.reload();
+			}
+			bits.reload();
+			if (!(bits.isFinished())) {
+				return SLIB_SIZE_MAX;
+			}
+			sl_size nLast = litEnd - lit;
+			if (nLast > (sl_size)(oend - op)) {
+				return SLIB_SIZE_MAX;
+			}
+			Base::copyMemory(op, lit, nLast);
+			op += nLast;
+			m_rep[0] = rep0;
+			m_rep[1] = rep1;
+			m_rep[2] = rep2;
+			return op - ostart;
+		}
+
+	};
+
+
+	ZstdDictionary::ZstdDictionary()
+	{
+		m_id = 0;
+		m_content = sl_null;
+		m_sizeContent = 0;
+		m_rep[0] = 1;
+		m_rep[1] = 4;
+		m_rep[2] = 8;
+	}
+
+	ZstdDictionary::~ZstdDictionary()
+	{
+	}
+
+	Ref<ZstdDictionary> ZstdDictionary::create(const void* data, sl_size size)
+	{
+		return create(Memory::create(data, size));
+	}
+
+	Ref<ZstdDictionary> ZstdDictionary::create(const Memory& mem)
+	{
+		const sl_uint8* data = (const sl_uint8*)(mem.getData());
+		sl_size size = mem.getSize();
+		if (!size) {
+			return sl_null;
+		}
+		Ref<ZstdDictionary> ret = new ZstdDictionary;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->m_data = mem;
+		if (size < 8 || MIO::readUint32LE(data) != PRIV_ZSTD_DICTIONARY_MAGIC) {
+			// raw content
+			ret->m_content = data;
+			ret->m_sizeContent = size;
+			return ret;
+		}
+		ret->m_id = MIO::readUint32LE(data + 4);
+		Memory memEntropy = Memory::create(sizeof(_priv_ZstdEntropy));
+		if (memEntropy.isNull()) {
+			return sl_null;
+		}
+		_priv_ZstdEntropy* entropy = (_priv_ZstdEntropy*)(memEntropy.getData());
+		const sl_uint8* p = data + 8;
+		const sl_uint8* end = data + size;
+		sl_size n = _priv_Zstd_readHufTable(entropy->huf, p, end - p);
+		if (!n) {
+			return sl_null;
+		}
+		p += n;
+		sl_int16 norm[PRIV_ZSTD_ML_MAX + 1];
+		sl_uint32 maxSymbol = PRIV_ZSTD_OF_MAX;
+		sl_uint32 tableLog;
+		n = _priv_Zstd_readNCount(norm, maxSymbol, tableLog, PRIV_ZSTD_OF_LOG, p, end - p);
+		if (!n || !(_priv_Zstd_buildFseTable(entropy->tableOF, norm, maxSymbol, tableLog, _priv_Zstd_OF_base, _priv_Zstd_OF_bits))) {
+			return sl_null;
+		}
+		p += n;
+		maxSymbol = PRIV_ZSTD_ML_MAX;
+		n = _priv_Zstd_readNCount(norm, maxSymbol, tableLog, PRIV_ZSTD_ML_LOG, p, end - p);
+		if (!n || !(_priv_Zstd_buildFseTable(entropy->tableML, norm, maxSymbol, tableLog, _priv_Zstd_ML_base, _priv_Zstd_ML_bits))) {
+			return sl_null;
+		}
+		p += n;
+		maxSymbol = PRIV_ZSTD_LL_MAX;
+		n = _priv_Zstd_readNCount(norm, maxSymbol, tableLog, PRIV_ZSTD_LL_LOG, p, end - p);
+		if (!n || !(_priv_Zstd_buildFseTable(entropy->tableLL, norm, maxSymbol, tableLog, _priv_Zstd_LL_base, _priv_Zstd_LL_bits))) {
+			return sl_null;
+		}
+		p += n;
+		if (p + 12 > end) {
+			return sl_null;
+		}
+		sl_size sizeContent = end - p - 12;
+		for (sl_uint32 i = 0; i < 3; i++) {
+			sl_uint32 rep = MIO::readUint32LE(p + (i << 2));
+			if (!rep || rep > sizeContent) {
+				return sl_null;
+			}
+			ret->m_rep[i] = rep;
+		}
+		ret->m_content = p + 12;
+		ret->m_sizeContent = sizeContent;
+		ret->m_entropy = memEntropy;
+		return ret;
+	}
+
+	sl_uint32 ZstdDictionary::getId()
+	{
+		return m_id;
+	}
+
+	Memory ZstdDictionary::getData()
+	{
+		return m_data;
+	}
+
+	const sl_uint8* ZstdDictionary::getContent()
+	{
+		return m_content;
+	}
+
+	sl_size ZstdDictionary::getContentSize()
+	{
+		return m_sizeContent;
+	}
+
+
+	ZstdCompress::ZstdCompress()
+	{
+	}
+
+	ZstdCompress::~ZstdCompress()
+	{
+		abort();
+	}
+
+	sl_bool ZstdCompress::isStarted()
+	{
+		_priv_ZstdEncoder* encoder = m_encoder.get();
+		if (encoder) {
+			return encoder->m_flagStarted;
+		}
+		return sl_false;
+	}
+
+	sl_bool ZstdCompress::start(sl_int32 level, sl_bool flagContentChecksum)
+	{
+		return _start(sl_null, level, flagContentChecksum, SLIB_UINT64_MAX);
+	}
+
+	sl_bool ZstdCompress::start(const Ref<ZstdDictionary>& dictionary, sl_int32 level, sl_bool flagContentChecksum)
+	{
+		return _start(dictionary, level, flagContentChecksum, SLIB_UINT64_MAX);
+	}
+
+	sl_bool ZstdCompress::_start(const Ref<ZstdDictionary>& dictionary, sl_int32 level, sl_bool flagContentChecksum, sl_uint64 sizeContent)
+	{
+		if (m_encoder.isNull()) {
+			m_encoder = new _priv_ZstdEncoder;
+			if (m_encoder.isNull()) {
+				return sl_false;
+			}
+		}
+		return m_encoder->start(dictionary, level, flagContentChecksum, sizeContent);
+	}
+
+	sl_int32 ZstdCompress::compress(
+		const void* _input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+		void* _output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed,
+		sl_bool flagFinish)
+	{
+		sizeInputPassed = 0;
+		sizeOutputUsed = 0;
+		_priv_ZstdEncoder* encoder = m_encoder.get();
+		if (!encoder || !(encoder->m_flagStarted)) {
+			return -1;
+		}
+		const sl_uint8* input = (const sl_uint8*)_input;
+		sl_uint8* output = (sl_uint8*)_output;
+		for (;;) {
+			if (encoder->m_posOutput < encoder->m_sizeOutput) {
+				sl_uint32 n = encoder->m_sizeOutput - encoder->m_posOutput;
+				sl_uint32 m = sizeOutputAvailable - sizeOutputUsed;
+				if (n > m) {
+					n = m;
+				}
+				Base::copyMemory(output + sizeOutputUsed, encoder->m_output + encoder->m_posOutput, n);
+				encoder->m_posOutput += n;
+				sizeOutputUsed += n;
+				if (encoder->m_posOutput < encoder->m_sizeOutput) {
+					return 1;
+				}
+			}
+			if (encoder->m_flagEnded) {
+				encoder->m_flagStarted = sl_false;
+				return 0;
+			}
+			sl_uint32 nInput = sizeInputAvailable - sizeInputPassed;
+			if (nInput) {
+				if (encoder->isBlockFull()) {
+					encoder->writeBlock(sl_false);
+				} else {
+					sizeInputPassed += encoder->putInput(input + sizeInputPassed, nInput);
+				}
+				continue;
+			}
+			if (flagFinish) {
+				encoder->writeBlock(sl_true);
+				continue;
+			}
+			return 1;
+		}
+	}
+
+	sl_int32 ZstdCompress::flush(void* _output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
+	{
+		sizeOutputUsed = 0;
+		_priv_ZstdEncoder* encoder = m_encoder.get();
+		if (!encoder || !(encoder->m_flagStarted) || encoder->m_flagEnded) {
+			return -1;
+		}
+		sl_uint8* output = (sl_uint8*)_output;
+		for (;;) {
+			if (encoder->m_posOutput < encoder->m_sizeOutput) {
+				sl_uint32 n = encoder->m_sizeOutput - encoder->m_posOutput;
+				sl_uint32 m = sizeOutputAvailable - sizeOutputUsed;
+				if (n > m) {
+					n = m;
+				}
+				Base::copyMemory(output + sizeOutputUsed, encoder->m_output + encoder->m_posOutput, n);
+				encoder->m_posOutput += n;
+				sizeOutputUsed += n;
+				if (encoder->m_posOutput < encoder->m_sizeOutput) {
+					return 1;
+				}
+			}
+			if (!(encoder->hasBlockInput())) {
+				return 0;
+			}
+			// the partial block is written as a non-last block
+			encoder->writeBlock(sl_false);
+		}
+	}
+
+	Memory ZstdCompress::compress(const void* _data, sl_size size, sl_bool flagFinish)
+	{
+		_priv_ZstdEncoder* encoder = m_encoder.get();
+		if (!encoder || !(encoder->m_flagStarted)) {
+			return sl_null;
+		}
+		const sl_uint8* data = (const sl_uint8*)_data;
+		MemoryBuffer buf;
+		for (;;) {
+			if (encoder->m_posOutput < encoder->m_sizeOutput) {
+				if (!(buf.add(Memory::create(encoder->m_output + encoder->m_posOutput, encoder->m_sizeOutput - encoder->m_posOutput)))) {
+					return sl_null;
+				}
+				encoder->m_posOutput = encoder->m_sizeOutput;
+			}
+			if (encoder->m_flagEnded) {
+				encoder->m_flagStarted = sl_false;
+				break;
+			}
+			if (size) {
+				if (encoder->isBlockFull()) {
+					encoder->writeBlock(sl_false);
+				} else {
+					sl_uint32 n = encoder->putInput(data, size);
+					data += n;
+					size -= n;
+				}
+				continue;
+			}
+			if (flagFinish) {
+				encoder->writeBlock(sl_true);
+				continue;
+			}
+			break;
+		}
+		return buf.merge();
+	}
+
+	void ZstdCompress::abort()
+	{
+		_priv_ZstdEncoder* encoder = m_encoder.get();
+		if (encoder) {
+			encoder->m_flagStarted = sl_false;
+		}
+	}
+
+
+	ZstdDecompress::ZstdDecompress()
+	{
+		m_flagStarted = sl_false;
+	}
+
+	ZstdDecompress::~ZstdDecompress()
+	{
+		abort();
+	}
+
+	sl_bool ZstdDecompress::isStarted()
+	{
+		return m_flagStarted;
+	}
+
+	sl_bool ZstdDecompress::start()
+	{
+		return start(sl_null);
+	}
+
+	sl_bool ZstdDecompress::start(const Ref<ZstdDictionary>& dictionary)
+	{
+		if (m_decoder.isNull()) {
+			m_decoder = new _priv_ZstdDecoder;
+			if (m_decoder.isNull()) {
+				return sl_false;
+			}
+		}
+		_priv_ZstdDecoder* decoder = m_decoder.get();
+		if (decoder->m_bufInput.isNull()) {
+			decoder->m_bufInput = Memory::create(64);
+			if (decoder->m_bufInput.isNull()) {
+				return sl_false;
+			}
+		}
+		decoder->m_dictionary = dictionary;
+		decoder->reset();
+		m_flagStarted = sl_true;
+		return sl_true;
+	}
+
+	sl_int32 ZstdDecompress::decompress(
+		const void* _input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
+		void* _output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
+	{
+		sizeInputPassed = 0;
+		sizeOutputUsed = 0;
+		if (!m_flagStarted) {
+			return -1;
+		}
+		_priv_ZstdDecoder* decoder = m_decoder.get();
+		const sl_uint8* input = (const sl_uint8*)_input;
+		sl_uint8* output = (sl_uint8*)_output;
+		for (;;) {
+			if (decoder->m_posFlushed < decoder->m_posOutput) {
+				sl_size n = decoder->m_posOutput - decoder->m_posFlushed;
+				sl_uint32 m = sizeOutputAvailable - sizeOutputUsed;
+				if (n > m) {
+					n = m;
+				}
+				Base::copyMemory(output + sizeOutputUsed, decoder->m_output + decoder->m_posFlushed, n);
+				decoder->m_posFlushed += n;
+				sizeOutputUsed += (sl_uint32)n;
+				if (decoder->m_posFlushed < decoder->m_posOutput) {
+					return 1;
+				}
+			}
+			if (decoder->m_state == PRIV_ZSTD_STATE_END) {
+				abort();
+				return 0;
+			}
+			sl_uint32 nInput = sizeInputAvailable - sizeInputPassed;
+			if (!nInput) {
+				return 1;
+			}
+			if (decoder->m_state == PRIV_ZSTD_STATE_SKIPPABLE_DATA) {
+				sl_uint32 n = SLIB_MIN(nInput, decoder->m_sizeNeeded);
+				sizeInputPassed += n;
+				decoder->m_sizeNeeded -= n;
+				if (!(decoder->m_sizeNeeded)) {
+					decoder->m_state = PRIV_ZSTD_STATE_MAGIC;
+					decoder->m_sizeNeeded = 4;
+				}
+				continue;
+			}
+			const sl_uint8* data;
+			sl_uint32 size = decoder->m_sizeNeeded;
+			if (!(decoder->m_sizeInput) && nInput >= size) {
+				data = input + sizeInputPassed;
+				sizeInputPassed += size;
+			} else {
+				if (decoder->m_bufInput.getSize() < size) {
+					Memory mem = Memory::create(SLIB_MAX(size, PRIV_ZSTD_BLOCK_SIZE_MAX));
+					if (mem.isNull()) {
+						abort();
+						return -1;
+					}
+					Base::copyMemory(mem.getData(), decoder->m_bufInput.getData(), decoder->m_sizeInput);
+					decoder->m_bufInput = mem;
+				}
+				sl_uint32 n = size - decoder->m_sizeInput;
+				if (n > nInput) {
+					n = nInput;
+				}
+				Base::copyMemory((sl_uint8*)(decoder->m_bufInput.getData()) + decoder->m_sizeInput, input + sizeInputPassed, n);
+				decoder->m_sizeInput += n;
+				sizeInputPassed += n;
+				if (decoder->m_sizeInput < size) {
+					return 1;
+				}
+				data = (sl_uint8*)(decoder->m_bufInput.getData());
+				decoder->m_sizeInput = 0;
+			}
+			if (!(decoder->processInput(data, size))) {
+				abort();
+				return -1;
+			}
+		}
+	}
+
+	void ZstdDecompress::abort()
+	{
+		m_flagStarted = sl_false;
+	}
+
+
+	Memory Zstd::compress(const void* data, sl_size size, sl_int32 level)
+	{
+		return compress(sl_null, data, size, level);
+	}
+
+	Memory Zstd::compress(const Memory& data, sl_int32 level)
+	{
+		return compress(sl_null, data.getData(), data.getSize(), level);
+	}
+
+	Memory Zstd::compress(const Ref<ZstdDictionary>& dictionary, const void* data, sl_size size, sl_int32 level)
+	{
+		ZstdCompress compressor;
+		if (!(compressor._start(dictionary, level, sl_true, size))) {
+			return sl_null;
+		}
+		return compressor.compress(data, size, sl_true);
+	}
+
+	Memory Zstd::compress(const Ref<ZstdDictionary>& dictionary, const Memory& data, sl_int32 level)
+	{
+		return compress(dictionary, data.getData(), data.getSize(), level);
+	}
+
+	Memory Zstd::decompress(const void* data, sl_size size)
+	{
+		return decompress(sl_null, data, size);
+	}
+
+	Memory Zstd::decompress(const Memory& data)
+	{
+		return decompress(sl_null, data.getData(), data.getSize());
+	}
+
+	Memory Zstd::decompress(const Ref<ZstdDictionary>& dictionary, const void* data, sl_size size)
+	{
+		Ref<_priv_ZstdDecoder> decoder = new _priv_ZstdDecoder;
+		if (decoder.isNull()) {
+			return sl_null;
+		}
+		decoder->m_dictionary = dictionary;
+		return decoder->decodeFrames((const sl_uint8*)data, size);
+	}
+
+	Memory Zstd::decompress(const Ref<ZstdDictionary>& dictionary, const Memory& data)
+	{
+		return decompress(dictionary, data.getData(), data.getSize());
+	}
+
+#define PRIV_ZSTD_TRAIN_DMER 8
+#define PRIV_ZSTD_TRAIN_HASH_LOG 20
+
+	SLIB_INLINE static sl_uint32 _priv_Zstd_hashDmer(const sl_uint8* p)
+	{
+		return (sl_uint32)((MIO::readUint64LE(p) * 0xCF1BBCDCB7A56463ULL) >> (64 - PRIV_ZSTD_TRAIN_HASH_LOG));
+	}
+
+	// selects the segment of `k` bytes having the most frequent d-mers (COVER algorithm)
+	static sl_uint32 _priv_Zstd_selectSegment(const sl_uint8* data, sl_size begin, sl_size end, sl_uint32 k, sl_uint32* freqs, sl_uint16* segmentFreqs, sl_size& posBest, sl_size& sizeBest)
+	{
+		sl_uint32 d = PRIV_ZSTD_TRAIN_DMER;
+		sl_uint64 score = 0;
+		sl_uint64 scoreBest = 0;
+		sl_size posSegment = begin;
+		posBest = begin;
+		sizeBest = 0;
+		for (sl_size pos = begin; pos + d <= end; pos++) {
+			sl_uint32 h = _priv_Zstd_hashDmer(data + pos);
+			if (!(segmentFreqs[h]++)) {
+				score += freqs[h];
+			}
+			if (pos + 1 - posSegment > k - d + 1) {
+				sl_uint32 hOut = _priv_Zstd_hashDmer(data + posSegment);
+				if (!(--segmentFreqs[hOut])) {
+					score -= freqs[hOut];
+				}
+				posSegment++;
+			}
+			if (score > scoreBest) {
+				scoreBest = score;
+				posBest = posSegment;
+				sizeBest = pos + d - posSegment;
+			}
+		}
+		// clears the active segment counters
+		for (sl_size pos = posSegment; pos + d <= end && pos < posSegment + k; pos++) {
+			segmentFreqs[_priv_Zstd_hashDmer(data + pos)] = 0;
+		}
+		if (!scoreBest) {
+			return 0;
+		}
+		// trims the d-mers having zero frequency at both ends
+		while (sizeBest > d && !freqs[_priv_Zstd_hashDmer(data + posBest)]) {
+			posBest++;
+			sizeBest--;
+		}
+		while (sizeBest > d && !freqs[_priv_Zstd_hashDmer(data + posBest + sizeBest - d)]) {
+			sizeBest--;
+		}
+		// the selected d-mers are not counted again
+		for (sl_size pos = posBest; pos + d <= posBest + sizeBest; pos++) {
+			freqs[_priv_Zstd_hashDmer(data + pos)] = 0;
+		}
+		return 1;
+	}
+
+	static sl_size _priv_Zstd_writeStatistics(sl_uint8* dst, const sl_uint32* counts, sl_uint32 maxSymbol, sl_uint32 tableLog)
+	{
+		sl_size total = 0;
+		for (sl_uint32 i = 0; i <= maxSymbol; i++) {
+			total += counts[i];
+		}
+		sl_int16 norm[PRIV_ZSTD_ML_MAX + 1];
+		_priv_Zstd_normalizeCounts(norm, counts, maxSymbol, total, tableLog);
+		return _priv_Zstd_writeNCount(dst, norm, maxSymbol, tableLog);
+	}
+
+	Memory Zstd::trainDictionary(const Memory* samples, sl_size nSamples, sl_size sizeDictionary, sl_uint32 dictionaryId)
+	{
+		sl_uint32 d = PRIV_ZSTD_TRAIN_DMER;
+		if (sizeDictionary < 1024) {
+			return sl_null;
+		}
+		sl_size sizeTotal = 0;
+		sl_size i;
+		for (i = 0; i < nSamples; i++) {
+			sizeTotal += samples[i].getSize();
+		}
+		if (sizeTotal < 4 * d) {
+			return sl_null;
+		}
+		Memory memAll = Memory::create(sizeTotal + 8);
+		if (memAll.isNull()) {
+			return sl_null;
+		}
+		sl_uint8* all = (sl_uint8*)(memAll.getData());
+		{
+			sl_size pos = 0;
+			for (i = 0; i < nSamples; i++) {
+				sl_size n = samples[i].getSize();
+				Base::copyMemory(all + pos, samples[i].getData(), n);
+				pos += n;
+			}
+			Base::zeroMemory(all + pos, 8);
+		}
+
+		// d-mer frequencies
+		sl_size sizeHashTable = (sl_size)1 << PRIV_ZSTD_TRAIN_HASH_LOG;
+		Memory memFreqs = Memory::create(sizeHashTable * (sizeof(sl_uint32) + sizeof(sl_uint16)));
+		if (memFreqs.isNull()) {
+			return sl_null;
+		}
+		sl_uint32* freqs = (sl_uint32*)(memFreqs.getData());
+		sl_uint16* segmentFreqs = (sl_uint16*)(freqs + sizeHashTable);
+		Base::zeroMemory(freqs, sizeHashTable * (sizeof(sl_uint32) + sizeof(sl_uint16)));
+		{
+			sl_size pos = 0;
+			for (i = 0; i < nSamples; i++) {
+				sl_size n = samples[i].getSize();
+				for (sl_size k = 0; k + d <= n; k++) {
+					freqs[_priv_Zstd_hashDmer(all + pos + k)]++;
+				}
+				pos += n;
+			}
+		}
+
+		// content: selected segments are placed from the end, so that the best ones have the smallest offsets
+		sl_size sizeContentMax = sizeDictionary - 512;
+		if (sizeContentMax > sizeTotal) {
+			sizeContentMax = sizeTotal;
+		}
+		Memory memContent = Memory::create(sizeContentMax);
+		if (memContent.isNull()) {
+			return sl_null;
+		}
+		sl_uint8* content = (sl_uint8*)(memContent.getData());
+		sl_uint32 k = (sl_uint32)(sizeTotal / nSamples / 2);
+		if (k < 64) {
+			k = 64;
+		} else if (k > 1024) {
+			k = 1024;
+		}
+		sl_size nEpochs = sizeContentMax / k / 4;
+		if (nEpochs < 1) {
+			nEpochs = 1;
+		}
+		sl_size sizeEpoch = sizeTotal / nEpochs;
+		if (sizeEpoch < 10 * (sl_size)k) {
+			sizeEpoch = SLIB_MIN(10 * (sl_size)k, sizeTotal);
+			nEpochs = sizeTotal / sizeEpoch;
+		}
+		sl_size posContent = sizeContentMax;
+		sl_size nFailures = 0;
+		for (sl_size epoch = 0; posContent && nFailures < nEpochs; epoch = (epoch + 1) % nEpochs) {
+			sl_size begin = epoch * sizeEpoch;
+			sl_size end = begin + sizeEpoch;
+			sl_size posBest, sizeBest;
+			if (!(_priv_Zstd_selectSegment(all, begin, end, k, freqs, segmentFreqs, posBest, sizeBest))) {
+				nFailures++;
+				continue;
+			}
+			nFailures = 0;
+			if (sizeBest > posContent) {
+				posBest += sizeBest - posContent;
+				sizeBest = posContent;
+			}
+			posContent -= sizeBest;
+			Base::copyMemory(content + posContent, all + posBest, sizeBest);
+		}
+		memFreqs.setNull();
+		sl_size sizeContent = sizeContentMax - posContent;
+		if (sizeContent < 8) {
+			return sl_null;
+		}
+		memContent = memContent.sub(posContent, sizeContent);
+
+		// entropy statistics of the samples compressed with the content
+		_priv_ZstdStatistics stats;
+		for (i = 0; i < 256; i++) {
+			stats.literals[i] = 1;
+		}
+		for (i = 0; i <= PRIV_ZSTD_LL_MAX; i++) {
+			stats.LL[i] = 1;
+		}
+		for (i = 0; i <= PRIV_ZSTD_ML_MAX; i++) {
+			stats.ML[i] = 1;
+		}
+		for (i = 0; i <= PRIV_ZSTD_OF_MAX; i++) {
+			stats.OF[i] = 1;
+		}
+		{
+			Ref<ZstdDictionary> dictionaryContent = ZstdDictionary::create(memContent);
+			if (dictionaryContent.isNull()) {
+				return sl_null;
+			}
+			ZstdCompress compressor;
+			for (i = 0; i < nSamples; i++) {
+				sl_size n = samples[i].getSize();
+				if (!(compressor._start(dictionaryContent, 3, sl_false, n))) {
+					return sl_null;
+				}
+				compressor.m_encoder->m_statistics = &stats;
+				compressor.compress(samples[i].getData(), n, sl_true);
+			}
+		}
+
+		sl_uint8 header[1024];
+		sl_uint8* p = header;
+		MIO::writeUint32LE(p, PRIV_ZSTD_DICTIONARY_MAGIC);
+		if (!dictionaryId) {
+			dictionaryId = 32768 + (Math::randomInt() % (0x80000000 - 32768));
+		}
+		MIO::writeUint32LE(p + 4, dictionaryId);
+		p += 8;
+		_priv_ZstdHufEncodeTable huf;
+		if (!(_priv_Zstd_buildHufEncodeTable(huf, stats.literals, 255))) {
+			return sl_null;
+		}
+		sl_size n = _priv_Zstd_writeHufTable(p, 256, huf);
+		if (!n) {
+			return sl_null;
+		}
+		p += n;
+		p += _priv_Zstd_writeStatistics(p, stats.OF, PRIV_ZSTD_OF_MAX, PRIV_ZSTD_OF_LOG);
+		p += _priv_Zstd_writeStatistics(p, stats.ML, PRIV_ZSTD_ML_MAX, PRIV_ZSTD_ML_LOG);
+		p += _priv_Zstd_writeStatistics(p, stats.LL, PRIV_ZSTD_LL_MAX, PRIV_ZSTD_LL_LOG);
+		for (i = 0; i < 3; i++) {
+			static const sl_uint32 reps[3] = { 1, 4, 8 };
+			MIO::writeUint32LE(p, reps[i]);
+			p += 4;
+		}
+		sl_size sizeHeader = p - header;
+		if (sizeHeader + sizeContent > sizeDictionary) {
+			sl_size m = sizeHeader + sizeContent - sizeDictionary;
+			memContent = memContent.sub(m);
+			sizeContent -= m;
+		}
+		Memory ret = Memory::create(sizeHeader + sizeContent);
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		Base::copyMemory(ret.getData(), header, sizeHeader);
+		Base::copyMemory((sl_uint8*)(ret.getData()) + sizeHeader, memContent.getData(), sizeContent);
+		return ret;
+	}
+
+	Memory Zstd::trainDictionary(const List<Memory>& samples, sl_size sizeDictionary, sl_uint32 dictionaryId)
+	{
+		ListLocker<Memory> list(samples);
+		return trainDictionary(list.data, list.count, sizeDictionary, dictionaryId);
+	}
+
+}
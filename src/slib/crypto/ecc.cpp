@@ -0,0 +1,1083 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/crypto/ecc.h"
+
+#include "slib/crypto/sha2.h"
+#include "slib/crypto/hmac.h"
+#include "slib/core/math.h"
+#include "slib/core/mio.h"
+#include "slib/core/base.h"
+
+namespace slib
+{
+
+/*
+	256-bit modular arithmetic
+
+	Elements are stored as 4 x 64-bit words (little-endian word order) in Montgomery form (a * R mod m, R = 2^256),
+	always fully reduced (< m). Every operation runs in constant time regardless of the values.
+*/
+
+	struct _priv_ECC_Modulus
+	{
+		sl_uint64 m[4];
+		sl_uint64 R[4]; // R mod m, one in Montgomery form
+		sl_uint64 R2[4]; // R^2 mod m
+		sl_uint64 R3[4]; // R^3 mod m
+		sl_uint64 MI; // -m^-1 mod 2^64
+	};
+
+	// p = 2^255 - 19
+	static const _priv_ECC_Modulus _priv_Ed25519_p = {
+		{ SLIB_UINT64(0xFFFFFFFFFFFFFFED), SLIB_UINT64(0xFFFFFFFFFFFFFFFF), SLIB_UINT64(0xFFFFFFFFFFFFFFFF), SLIB_UINT64(0x7FFFFFFFFFFFFFFF) },
+		{ SLIB_UINT64(0x0000000000000026), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x0000000000000000) },
+		{ SLIB_UINT64(0x00000000000005A4), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x0000000000000000) },
+		{ SLIB_UINT64(0x000000000000D658), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x0000000000000000) },
+		SLIB_UINT64(0x86BCA1AF286BCA1B)
+	};
+
+	// L = 2^252 + 27742317777372353535851937790883648493 (order of the base point)
+	static const _priv_ECC_Modulus _priv_Ed25519_L = {
+		{ SLIB_UINT64(0x5812631A5CF5D3ED), SLIB_UINT64(0x14DEF9DEA2F79CD6), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x1000000000000000) },
+		{ SLIB_UINT64(0xD6EC31748D98951D), SLIB_UINT64(0xC6EF5BF4737DCF70), SLIB_UINT64(0xFFFFFFFFFFFFFFFE), SLIB_UINT64(0x0FFFFFFFFFFFFFFF) },
+		{ SLIB_UINT64(0xA40611E3449C0F01), SLIB_UINT64(0xD00E1BA768859347), SLIB_UINT64(0xCEEC73D217F5BE65), SLIB_UINT64(0x0399411B7C309A3D) },
+		{ SLIB_UINT64(0x2A9E49687B83A2DB), SLIB_UINT64(0x278324E6AEF7F3EC), SLIB_UINT64(0x8065DC6C04EC5B65), SLIB_UINT64(0x0E530B773599CEC7) },
+		SLIB_UINT64(0xD2B51DA312547E1B)
+	};
+
+	// p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+	static const _priv_ECC_Modulus _priv_P256_p = {
+		{ SLIB_UINT64(0xFFFFFFFFFFFFFFFF), SLIB_UINT64(0x00000000FFFFFFFF), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0xFFFFFFFF00000001) },
+		{ SLIB_UINT64(0x0000000000000001), SLIB_UINT64(0xFFFFFFFF00000000), SLIB_UINT64(0xFFFFFFFFFFFFFFFF), SLIB_UINT64(0x00000000FFFFFFFE) },
+		{ SLIB_UINT64(0x0000000000000003), SLIB_UINT64(0xFFFFFFFBFFFFFFFF), SLIB_UINT64(0xFFFFFFFFFFFFFFFE), SLIB_UINT64(0x00000004FFFFFFFD) },
+		{ SLIB_UINT64(0xFFFFFFFD0000000A), SLIB_UINT64(0xFFFFFFEDFFFFFFF7), SLIB_UINT64(0x00000005FFFFFFFC), SLIB_UINT64(0x0000001800000001) },
+		SLIB_UINT64(0x0000000000000001)
+	};
+
+	// n: order of the base point
+	static const _priv_ECC_Modulus _priv_P256_n = {
+		{ SLIB_UINT64(0xF3B9CAC2FC632551), SLIB_UINT64(0xBCE6FAADA7179E84), SLIB_UINT64(0xFFFFFFFFFFFFFFFF), SLIB_UINT64(0xFFFFFFFF00000000) },
+		{ SLIB_UINT64(0x0C46353D039CDAAF), SLIB_UINT64(0x4319055258E8617B), SLIB_UINT64(0x0000000000000000), SLIB_UINT64(0x00000000FFFFFFFF) },
+		{ SLIB_UINT64(0x83244C95BE79EEA2), SLIB_UINT64(0x4699799C49BD6FA6), SLIB_UINT64(0x2845B2392B6BEC59), SLIB_UINT64(0x66E12D94F3D95620) },
+		{ SLIB_UINT64(0xAC8EBEC90B65A624), SLIB_UINT64(0x111F28AE0C0555C9), SLIB_UINT64(0x2543B9246BA5E93F), SLIB_UINT64(0x503A54E76407BE65) },
+		SLIB_UINT64(0xCCD1C8AAEE00BC4F)
+	};
+
+	// (high, low) = a * b + c + d
+	SLIB_INLINE static void _priv_ECC_mulAdd(sl_uint64 a, sl_uint64 b, sl_uint64 c, sl_uint64 d, sl_uint64& high, sl_uint64& low) noexcept
+	{
+		sl_uint64 h, l;
+		Math::mul64(a, b, h, l);
+		l += c;
+		h += l < c ? 1 : 0;
+		l += d;
+		h += l < d ? 1 : 0;
+		high = h;
+		low = l;
+	}
+
+	// c = a - b, returns borrow
+	SLIB_INLINE static sl_uint64 _priv_ECC_subWords(sl_uint64* c, const sl_uint64* a, const sl_uint64* b) noexcept
+	{
+		sl_uint64 borrow = 0;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint64 x = a[i];
+			sl_uint64 y = b[i];
+			sl_uint64 o = x < borrow ? 1 : 0;
+			x -= borrow;
+			borrow = o + (x < y ? 1 : 0);
+			c[i] = x - y;
+		}
+		return borrow;
+	}
+
+	// r = mask ? a : r
+	SLIB_INLINE static void _priv_ECC_cmov(sl_uint64* r, const sl_uint64* a, sl_uint64 mask) noexcept
+	{
+		for (sl_uint32 i = 0; i < 4; i++) {
+			r[i] ^= (r[i] ^ a[i]) & mask;
+		}
+	}
+
+	SLIB_INLINE static void _priv_ECC_copy(sl_uint64* r, const sl_uint64* a) noexcept
+	{
+		for (sl_uint32 i = 0; i < 4; i++) {
+			r[i] = a[i];
+		}
+	}
+
+	SLIB_INLINE static void _priv_ECC_setZero(sl_uint64* r) noexcept
+	{
+		for (sl_uint32 i = 0; i < 4; i++) {
+			r[i] = 0;
+		}
+	}
+
+	// all ones if a == 0
+	SLIB_INLINE static sl_uint64 _priv_ECC_zeroMask(const sl_uint64* a) noexcept
+	{
+		sl_uint64 x = a[0] | a[1] | a[2] | a[3];
+		return ((x | (0 - x)) >> 63) - 1;
+	}
+
+	SLIB_INLINE static sl_bool _priv_ECC_equals(const sl_uint64* a, const sl_uint64* b) noexcept
+	{
+		return ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) == 0;
+	}
+
+	// r = a + b mod m
+	static void _priv_ECC_add(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, const _priv_ECC_Modulus& M) noexcept
+	{
+		sl_uint64 t[4], u[4];
+		sl_uint64 carry = 0;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint64 s = a[i] + carry;
+			carry = s < carry ? 1 : 0;
+			s += b[i];
+			carry += s < b[i] ? 1 : 0;
+			t[i] = s;
+		}
+		sl_uint64 borrow = _priv_ECC_subWords(u, t, M.m);
+		// t >= m
+		sl_uint64 mask = 0 - (carry | (borrow ^ 1));
+		_priv_ECC_cmov(t, u, mask);
+		_priv_ECC_copy(r, t);
+	}
+
+	// r = a - b mod m
+	static void _priv_ECC_sub(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, const _priv_ECC_Modulus& M) noexcept
+	{
+		sl_uint64 t[4], u[4];
+		sl_uint64 borrow = _priv_ECC_subWords(t, a, b);
+		sl_uint64 carry = 0;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint64 s = t[i] + carry;
+			carry = s < carry ? 1 : 0;
+			s += M.m[i];
+			carry += s < M.m[i] ? 1 : 0;
+			u[i] = s;
+		}
+		_priv_ECC_cmov(t, u, 0 - borrow);
+		_priv_ECC_copy(r, t);
+	}
+
+	// r = -a mod m
+	static void _priv_ECC_neg(sl_uint64* r, const sl_uint64* a, const _priv_ECC_Modulus& M) noexcept
+	{
+		sl_uint64 zero[4] = {0};
+		_priv_ECC_sub(r, zero, a, M);
+	}
+
+	// r = a * b * R^-1 mod m (CIOS), requires a * b < m * R
+	static void _priv_ECC_mul(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, const _priv_ECC_Modulus& M) noexcept
+	{
+		sl_uint64 t[6] = {0};
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint64 ai = a[i];
+			sl_uint64 c = 0;
+			sl_uint32 j;
+			for (j = 0; j < 4; j++) {
+				_priv_ECC_mulAdd(ai, b[j], t[j], c, c, t[j]);
+			}
+			sl_uint64 s = t[4] + c;
+			t[5] = s < c ? 1 : 0;
+			t[4] = s;
+			sl_uint64 u = t[0] * M.MI;
+			sl_uint64 low;
+			_priv_ECC_mulAdd(u, M.m[0], t[0], 0, c, low);
+			for (j = 1; j < 4; j++) {
+				_priv_ECC_mulAdd(u, M.m[j], t[j], c, c, t[j - 1]);
+			}
+			s = t[4] + c;
+			c = s < c ? 1 : 0;
+			t[3] = s;
+			t[4] = t[5] + c;
+		}
+		sl_uint64 v[4];
+		sl_uint64 borrow = _priv_ECC_subWords(v, t, M.m);
+		_priv_ECC_cmov(t, v, 0 - (t[4] | (borrow ^ 1)));
+		_priv_ECC_copy(r, t);
+	}
+
+	// r = a^e (Montgomery form), `e` is public
+	static void _priv_ECC_pow(sl_uint64* r, const sl_uint64* a, const sl_uint64* e, const _priv_ECC_Modulus& M) noexcept
+	{
+		sl_uint64 t[4];
+		_priv_ECC_copy(t, M.R);
+		for (sl_uint32 i = 256; i > 0; i--) {
+			_priv_ECC_mul(t, t, t, M);
+			if ((e[(i - 1) >> 6] >> ((i - 1) & 63)) & 1) {
+				_priv_ECC_mul(t, t, a, M);
+			}
+		}
+		_priv_ECC_copy(r, t);
+	}
+
+	// r = a^-1 = a^(m-2) (Montgomery form, m is prime)
+	static void _priv_ECC_invert(sl_uint64* r, const sl_uint64* a, const _priv_ECC_Modulus& M) noexcept
+	{
+		sl_uint64 e[4];
+		_priv_ECC_copy(e, M.m);
+		e[0] -= 2;
+		_priv_ECC_pow(r, a, e, M);
+	}
+
+	// r = a * R mod m, (a < 2^256)
+	SLIB_INLINE static void _priv_ECC_toMontgomery(sl_uint64* r, const sl_uint64* a, const _priv_ECC_Modulus& M) noexcept
+	{
+		_priv_ECC_mul(r, a, M.R2, M);
+	}
+
+	SLIB_INLINE static void _priv_ECC_fromMontgomery(sl_uint64* r, const sl_uint64* a, const _priv_ECC_Modulus& M) noexcept
+	{
+		sl_uint64 one[4] = {1, 0, 0, 0};
+		_priv_ECC_mul(r, a, one, M);
+	}
+
+	SLIB_INLINE static void _priv_ECC_loadLE(sl_uint64* w, const sl_uint8* b) noexcept
+	{
+		for (sl_uint32 i = 0; i < 4; i++) {
+			w[i] = MIO::readUint64LE(b + (i << 3));
+		}
+	}
+
+	SLIB_INLINE static void _priv_ECC_storeLE(sl_uint8* b, const sl_uint64* w) noexcept
+	{
+		for (sl_uint32 i = 0; i < 4; i++) {
+			MIO::writeUint64LE(b + (i << 3), w[i]);
+		}
+	}
+
+	SLIB_INLINE static void _priv_ECC_loadBE(sl_uint64* w, const sl_uint8* b) noexcept
+	{
+		for (sl_uint32 i = 0; i < 4; i++) {
+			w[i] = MIO::readUint64BE(b + 24 - (i << 3));
+		}
+	}
+
+	SLIB_INLINE static void _priv_ECC_storeBE(sl_uint8* b, const sl_uint64* w) noexcept
+	{
+		for (sl_uint32 i = 0; i < 4; i++) {
+			MIO::writeUint64BE(b + 24 - (i << 3), w[i]);
+		}
+	}
+
+	// Signed radix-16 digits (-7 <= e[i] <= 8) of the scalar (little-endian 32 bytes): scalar = sum(e[i] * 16^i), i = 0 ~ 64
+	// e[64] is zero for the scalars less than 2^255
+	static void _priv_ECC_recodeScalar(sl_int8* e, const sl_uint8* s) noexcept
+	{
+		sl_uint32 i;
+		for (i = 0; i < 32; i++) {
+			e[i << 1] = (sl_int8)(s[i] & 15);
+			e[(i << 1) + 1] = (sl_int8)(s[i] >> 4);
+		}
+		sl_int32 carry = 0;
+		for (i = 0; i < 64; i++) {
+			sl_int32 v = e[i] + carry;
+			carry = (v + 7) >> 4;
+			e[i] = (sl_int8)(v - (carry << 4));
+		}
+		e[64] = (sl_int8)carry;
+	}
+
+	// all ones if a == b
+	SLIB_INLINE static sl_uint64 _priv_ECC_equalMask(sl_uint32 a, sl_uint32 b) noexcept
+	{
+		sl_uint64 x = a ^ b;
+		return 0 - ((x - 1) >> 63);
+	}
+
+	// returns the digit's sign mask, and its absolute value in `abs`
+	SLIB_INLINE static sl_uint64 _priv_ECC_splitDigit(sl_int8 digit, sl_uint32& abs) noexcept
+	{
+		sl_uint32 m = 0 - (sl_uint32)((sl_uint8)digit >> 7);
+		abs = (((sl_uint32)(sl_int32)digit) ^ m) - m;
+		return 0 - (sl_uint64)(m & 1);
+	}
+
+
+/*
+	Ed25519 (RFC 8032)
+
+	Twisted Edwards curve -x^2 + y^2 = 1 + d x^2 y^2, extended coordinates (X:Y:Z:T), x = X/Z, y = Y/Z, xy = T/Z
+*/
+
+	// constants in Montgomery form
+	static const sl_uint64 _priv_Ed25519_d[4] = { SLIB_UINT64(0x80ED8BFEDF47E9FA), SLIB_UINT64(0x10A18777AFC62973), SLIB_UINT64(0xE5939207BC188690), SLIB_UINT64(0x2C822B5A729FC526) };
+	static const sl_uint64 _priv_Ed25519_d2[4] = { SLIB_UINT64(0x01DB17FDBE8FD3F4), SLIB_UINT64(0x21430EEF5F8C52E7), SLIB_UINT64(0xCB27240F78310D20), SLIB_UINT64(0x590456B4E53F8A4D) };
+	static const sl_uint64 _priv_Ed25519_sqrtm1[4] = { SLIB_UINT64(0x3B5807D4FE2BDB04), SLIB_UINT64(0x03F590FDB51BE9ED), SLIB_UINT64(0x6D6E16BF336202D1), SLIB_UINT64(0x75776B0BD6C71BA8) };
+	static const sl_uint64 _priv_Ed25519_Bx[4] = { SLIB_UINT64(0xE2CABC553F9DA287), SLIB_UINT64(0x9CA598562396E489), SLIB_UINT64(0x9879936BADE4B5B7), SLIB_UINT64(0x759E23707E6077D0) };
+	static const sl_uint64 _priv_Ed25519_By[4] = { SLIB_UINT64(0x333333333333334A), SLIB_UINT64(0x3333333333333333), SLIB_UINT64(0x3333333333333333), SLIB_UINT64(0x3333333333333333) };
+	static const sl_uint64 _priv_Ed25519_Bt[4] = { SLIB_UINT64(0x4F0896AA994AE86C), SLIB_UINT64(0xE3B7AD11B612506E), SLIB_UINT64(0x46C7A922F183C492), SLIB_UINT64(0x5E181C59FEB3930D) };
+	// (p - 5) / 8
+	static const sl_uint64 _priv_Ed25519_p58[4] = { SLIB_UINT64(0xFFFFFFFFFFFFFFFD), SLIB_UINT64(0xFFFFFFFFFFFFFFFF), SLIB_UINT64(0xFFFFFFFFFFFFFFFF), SLIB_UINT64(0x0FFFFFFFFFFFFFFF) };
+
+	struct _priv_Ed25519_Point
+	{
+		sl_uint64 X[4];
+		sl_uint64 Y[4];
+		sl_uint64 Z[4];
+		sl_uint64 T[4];
+	};
+
+	// (Y+X, Y-X, Z, 2dT)
+	struct _priv_Ed25519_Cached
+	{
+		sl_uint64 YplusX[4];
+		sl_uint64 YminusX[4];
+		sl_uint64 Z[4];
+		sl_uint64 T2d[4];
+	};
+
+#define PRIV_ED25519_P _priv_Ed25519_p
+
+	static void _priv_Ed25519_setIdentity(_priv_Ed25519_Point& p) noexcept
+	{
+		_priv_ECC_setZero(p.X);
+		_priv_ECC_copy(p.Y, PRIV_ED25519_P.R);
+		_priv_ECC_copy(p.Z, PRIV_ED25519_P.R);
+		_priv_ECC_setZero(p.T);
+	}
+
+	static void _priv_Ed25519_toCached(_priv_Ed25519_Cached& c, const _priv_Ed25519_Point& p) noexcept
+	{
+		_priv_ECC_add(c.YplusX, p.Y, p.X, PRIV_ED25519_P);
+		_priv_ECC_sub(c.YminusX, p.Y, p.X, PRIV_ED25519_P);
+		_priv_ECC_copy(c.Z, p.Z);
+		_priv_ECC_mul(c.T2d, p.T, _priv_Ed25519_d2, PRIV_ED25519_P);
+	}
+
+	// r = p + q (add-2008-hwcd-3, complete)
+	static void _priv_Ed25519_add(_priv_Ed25519_Point& r, const _priv_Ed25519_Point& p, const _priv_Ed25519_Cached& q) noexcept
+	{
+		sl_uint64 A[4], B[4], C[4], D[4], E[4], F[4], G[4], H[4];
+		_priv_ECC_sub(A, p.Y, p.X, PRIV_ED25519_P);
+		_priv_ECC_mul(A, A, q.YminusX, PRIV_ED25519_P);
+		_priv_ECC_add(B, p.Y, p.X, PRIV_ED25519_P);
+		_priv_ECC_mul(B, B, q.YplusX, PRIV_ED25519_P);
+		_priv_ECC_mul(C, p.T, q.T2d, PRIV_ED25519_P);
+		_priv_ECC_mul(D, p.Z, q.Z, PRIV_ED25519_P);
+		_priv_ECC_add(D, D, D, PRIV_ED25519_P);
+		_priv_ECC_sub(E, B, A, PRIV_ED25519_P);
+		_priv_ECC_sub(F, D, C, PRIV_ED25519_P);
+		_priv_ECC_add(G, D, C, PRIV_ED25519_P);
+		_priv_ECC_add(H, B, A, PRIV_ED25519_P);
+		_priv_ECC_mul(r.X, E, F, PRIV_ED25519_P);
+		_priv_ECC_mul(r.Y, G, H, PRIV_ED25519_P);
+		_priv_ECC_mul(r.T, E, H, PRIV_ED25519_P);
+		_priv_ECC_mul(r.Z, F, G, PRIV_ED25519_P);
+	}
+
+	// r = 2p (dbl-2008-hwcd, a = -1)
+	static void _priv_Ed25519_double(_priv_Ed25519_Point& r, const _priv_Ed25519_Point& p) noexcept
+	{
+		sl_uint64 A[4], B[4], C[4], E[4], F[4], G[4], H[4];
+		_priv_ECC_mul(A, p.X, p.X, PRIV_ED25519_P);
+		_priv_ECC_mul(B, p.Y, p.Y, PRIV_ED25519_P);
+		_priv_ECC_mul(C, p.Z, p.Z, PRIV_ED25519_P);
+		_priv_ECC_add(C, C, C, PRIV_ED25519_P);
+		// H = -(A + B)
+		_priv_ECC_add(H, A, B, PRIV_ED25519_P);
+		_priv_ECC_add(E, p.X, p.Y, PRIV_ED25519_P);
+		_priv_ECC_mul(E, E, E, PRIV_ED25519_P);
+		_priv_ECC_sub(E, E, H, PRIV_ED25519_P);
+		_priv_ECC_neg(H, H, PRIV_ED25519_P);
+		// G = B - A
+		_priv_ECC_sub(G, B, A, PRIV_ED25519_P);
+		_priv_ECC_sub(F, G, C, PRIV_ED25519_P);
+		_priv_ECC_mul(r.X, E, F, PRIV_ED25519_P);
+		_priv_ECC_mul(r.Y, G, H, PRIV_ED25519_P);
+		_priv_ECC_mul(r.T, E, H, PRIV_ED25519_P);
+		_priv_ECC_mul(r.Z, F, G, PRIV_ED25519_P);
+	}
+
+	static void _priv_Ed25519_encode(sl_uint8* out, const _priv_Ed25519_Point& p) noexcept
+	{
+		sl_uint64 zi[4], x[4], y[4];
+		_priv_ECC_invert(zi, p.Z, PRIV_ED25519_P);
+		_priv_ECC_mul(x, p.X, zi, PRIV_ED25519_P);
+		_priv_ECC_mul(y, p.Y, zi, PRIV_ED25519_P);
+		_priv_ECC_fromMontgomery(x, x, PRIV_ED25519_P);
+		_priv_ECC_fromMontgomery(y, y, PRIV_ED25519_P);
+		_priv_ECC_storeLE(out, y);
+		out[31] |= (sl_uint8)((x[0] & 1) << 7);
+	}
+
+	// not constant-time (public key)
+	static sl_bool _priv_Ed25519_decode(_priv_Ed25519_Point& p, const sl_uint8* in) noexcept
+	{
+		sl_uint64 y[4];
+		_priv_ECC_loadLE(y, in);
+		y[3] &= SLIB_UINT64(0x7FFFFFFFFFFFFFFF);
+		sl_uint32 sign = in[31] >> 7;
+		sl_uint64 t[4];
+		if (!(_priv_ECC_subWords(t, y, PRIV_ED25519_P.m))) {
+			// non-canonical
+			return sl_false;
+		}
+		_priv_ECC_toMontgomery(p.Y, y, PRIV_ED25519_P);
+		_priv_ECC_copy(p.Z, PRIV_ED25519_P.R);
+		// u = y^2 - 1, v = d y^2 + 1
+		sl_uint64 u[4], v[4], v3[4], x[4];
+		_priv_ECC_mul(u, p.Y, p.Y, PRIV_ED25519_P);
+		_priv_ECC_mul(v, u, _priv_Ed25519_d, PRIV_ED25519_P);
+		_priv_ECC_sub(u, u, PRIV_ED25519_P.R, PRIV_ED25519_P);
+		_priv_ECC_add(v, v, PRIV_ED25519_P.R, PRIV_ED25519_P);
+		// x = u v^3 (u v^7)^((p-5)/8)
+		_priv_ECC_mul(v3, v, v, PRIV_ED25519_P);
+		_priv_ECC_mul(v3, v3, v, PRIV_ED25519_P);
+		_priv_ECC_mul(x, v3, v3, PRIV_ED25519_P);
+		_priv_ECC_mul(x, x, v, PRIV_ED25519_P);
+		_priv_ECC_mul(x, x, u, PRIV_ED25519_P);
+		_priv_ECC_pow(x, x, _priv_Ed25519_p58, PRIV_ED25519_P);
+		_priv_ECC_mul(x, x, v3, PRIV_ED25519_P);
+		_priv_ECC_mul(x, x, u, PRIV_ED25519_P);
+		// check v x^2 = +-u
+		sl_uint64 vxx[4];
+		_priv_ECC_mul(vxx, x, x, PRIV_ED25519_P);
+		_priv_ECC_mul(vxx, vxx, v, PRIV_ED25519_P);
+		if (!(_priv_ECC_equals(vxx, u))) {
+			_priv_ECC_neg(u, u, PRIV_ED25519_P);
+			if (!(_priv_ECC_equals(vxx, u))) {
+				return sl_false;
+			}
+			_priv_ECC_mul(x, x, _priv_Ed25519_sqrtm1, PRIV_ED25519_P);
+		}
+		_priv_ECC_fromMontgomery(t, x, PRIV_ED25519_P);
+		if ((t[0] & 1) != sign) {
+			if (_priv_ECC_zeroMask(t)) {
+				return sl_false;
+			}
+			_priv_ECC_neg(x, x, PRIV_ED25519_P);
+		}
+		_priv_ECC_copy(p.X, x);
+		_priv_ECC_mul(p.T, p.X, p.Y, PRIV_ED25519_P);
+		return sl_true;
+	}
+
+	// table[j][i] = (i + 1) * 16^j * B
+	class _priv_Ed25519_BaseTable
+	{
+	public:
+		_priv_Ed25519_Cached table[64][8];
+
+	public:
+		_priv_Ed25519_BaseTable()
+		{
+			_priv_Ed25519_Point P;
+			_priv_ECC_copy(P.X, _priv_Ed25519_Bx);
+			_priv_ECC_copy(P.Y, _priv_Ed25519_By);
+			_priv_ECC_copy(P.Z, PRIV_ED25519_P.R);
+			_priv_ECC_copy(P.T, _priv_Ed25519_Bt);
+			for (sl_uint32 j = 0; j < 64; j++) {
+				_priv_Ed25519_Point Q = P;
+				_priv_Ed25519_toCached(table[j][0], P);
+				for (sl_uint32 i = 1; i < 8; i++) {
+					_priv_Ed25519_add(Q, Q, table[j][0]);
+					_priv_Ed25519_toCached(table[j][i], Q);
+				}
+				for (sl_uint32 k = 0; k < 4; k++) {
+					_priv_Ed25519_double(P, P);
+				}
+			}
+		}
+
+	};
+
+	static const _priv_Ed25519_BaseTable& _priv_Ed25519_getBaseTable()
+	{
+		static _priv_Ed25519_BaseTable table;
+		return table;
+	}
+
+	// t = digit * row[0] (constant-time)
+	static void _priv_Ed25519_select(_priv_Ed25519_Cached& t, const _priv_Ed25519_Cached* row, sl_int8 digit) noexcept
+	{
+		sl_uint32 abs;
+		sl_uint64 maskNegative = _priv_ECC_splitDigit(digit, abs);
+		_priv_ECC_copy(t.YplusX, PRIV_ED25519_P.R);
+		_priv_ECC_copy(t.YminusX, PRIV_ED25519_P.R);
+		_priv_ECC_copy(t.Z, PRIV_ED25519_P.R);
+		_priv_ECC_setZero(t.T2d);
+		for (sl_uint32 i = 0; i < 8; i++) {
+			sl_uint64 mask = _priv_ECC_equalMask(abs, i + 1);
+			_priv_ECC_cmov(t.YplusX, row[i].YplusX, mask);
+			_priv_ECC_cmov(t.YminusX, row[i].YminusX, mask);
+			_priv_ECC_cmov(t.Z, row[i].Z, mask);
+			_priv_ECC_cmov(t.T2d, row[i].T2d, mask);
+		}
+		// -(x, y) = (-x, y)
+		sl_uint64 n[4];
+		_priv_ECC_copy(n, t.YplusX);
+		_priv_ECC_cmov(t.YplusX, t.YminusX, maskNegative);
+		_priv_ECC_cmov(t.YminusX, n, maskNegative);
+		_priv_ECC_neg(n, t.T2d, PRIV_ED25519_P);
+		_priv_ECC_cmov(t.T2d, n, maskNegative);
+	}
+
+	// r = [s]B, `s`: little-endian scalar < 2^255 (constant-time)
+	static void _priv_Ed25519_mulBase(_priv_Ed25519_Point& r, const sl_uint8* s) noexcept
+	{
+		const _priv_Ed25519_BaseTable& table = _priv_Ed25519_getBaseTable();
+		sl_int8 e[65];
+		_priv_ECC_recodeScalar(e, s);
+		_priv_Ed25519_setIdentity(r);
+		_priv_Ed25519_Cached t;
+		for (sl_uint32 j = 0; j < 64; j++) {
+			_priv_Ed25519_select(t, table.table[j], e[j]);
+			_priv_Ed25519_add(r, r, t);
+		}
+	}
+
+	// r = [s]P (not constant-time)
+	static void _priv_Ed25519_mul(_priv_Ed25519_Point& r, const sl_uint8* s, const _priv_Ed25519_Point& P) noexcept
+	{
+		_priv_Ed25519_Cached table[16];
+		_priv_Ed25519_Point Q = P;
+		_priv_Ed25519_toCached(table[1], P);
+		for (sl_uint32 i = 2; i < 16; i++) {
+			_priv_Ed25519_add(Q, Q, table[1]);
+			_priv_Ed25519_toCached(table[i], Q);
+		}
+		_priv_Ed25519_setIdentity(r);
+		for (sl_uint32 i = 64; i > 0; i--) {
+			for (sl_uint32 k = 0; k < 4; k++) {
+				_priv_Ed25519_double(r, r);
+			}
+			sl_uint32 digit = (s[(i - 1) >> 1] >> (((i - 1) & 1) << 2)) & 15;
+			if (digit) {
+				_priv_Ed25519_add(r, r, table[digit]);
+			}
+		}
+	}
+
+	// r = x mod L (Montgomery form), `x`: little-endian 64 bytes
+	static void _priv_Ed25519_reduceScalar(sl_uint64* r, const sl_uint8* x) noexcept
+	{
+		sl_uint64 a[4], b[4];
+		_priv_ECC_loadLE(a, x);
+		_priv_ECC_loadLE(b, x + 32);
+		// (a + b * R) * R = a * R^2 * R^-1 + b * R^3 * R^-1
+		_priv_ECC_mul(a, a, _priv_Ed25519_L.R2, _priv_Ed25519_L);
+		_priv_ECC_mul(b, b, _priv_Ed25519_L.R3, _priv_Ed25519_L);
+		_priv_ECC_add(r, a, b, _priv_Ed25519_L);
+	}
+
+	static void _priv_Ed25519_expandKey(sl_uint8* h, const void* privateKey) noexcept
+	{
+		SHA512::hash(privateKey, 32, h);
+		h[0] &= 248;
+		h[31] &= 127;
+		h[31] |= 64;
+	}
+
+	void Ed25519::generatePrivateKey(void* privateKey) noexcept
+	{
+		Math::randomMemory(privateKey, PrivateKeySize);
+	}
+
+	void Ed25519::getPublicKey(const void* privateKey, void* publicKey) noexcept
+	{
+		sl_uint8 h[64];
+		_priv_Ed25519_expandKey(h, privateKey);
+		_priv_Ed25519_Point A;
+		_priv_Ed25519_mulBase(A, h);
+		_priv_Ed25519_encode((sl_uint8*)publicKey, A);
+		Base::zeroMemory(h, sizeof(h));
+	}
+
+	void Ed25519::sign(const void* privateKey, const void* _publicKey, const void* message, sl_size size, void* _signature) noexcept
+	{
+		sl_uint8* signature = (sl_uint8*)_signature;
+		sl_uint8 h[64];
+		_priv_Ed25519_expandKey(h, privateKey);
+		sl_uint8 publicKey[32];
+		if (_publicKey) {
+			Base::copyMemory(publicKey, _publicKey, 32);
+		} else {
+			_priv_Ed25519_Point A;
+			_priv_Ed25519_mulBase(A, h);
+			_priv_Ed25519_encode(publicKey, A);
+		}
+
+		SHA512 hash;
+		sl_uint8 digest[64];
+
+		// r = H(prefix || M) mod L, R = [r]B
+		hash.start();
+		hash.update(h + 32, 32);
+		hash.update(message, size);
+		hash.finish(digest);
+		sl_uint64 r[4];
+		_priv_Ed25519_reduceScalar(r, digest);
+		sl_uint64 t[4];
+		_priv_ECC_fromMontgomery(t, r, _priv_Ed25519_L);
+		sl_uint8 scalar[32];
+		_priv_ECC_storeLE(scalar, t);
+		_priv_Ed25519_Point R;
+		_priv_Ed25519_mulBase(R, scalar);
+		_priv_Ed25519_encode(signature, R);
+
+		// k = H(R || A || M) mod L, S = r + k * a mod L
+		hash.start();
+		hash.update(signature, 32);
+		hash.update(publicKey, 32);
+		hash.update(message, size);
+		hash.finish(digest);
+		sl_uint64 k[4], a[4];
+		_priv_Ed25519_reduceScalar(k, digest);
+		_priv_ECC_loadLE(a, h);
+		_priv_ECC_toMontgomery(a, a, _priv_Ed25519_L);
+		_priv_ECC_mul(k, k, a, _priv_Ed25519_L);
+		_priv_ECC_add(k, k, r, _priv_Ed25519_L);
+		_priv_ECC_fromMontgomery(k, k, _priv_Ed25519_L);
+		_priv_ECC_storeLE(signature + 32, k);
+
+		Base::zeroMemory(h, sizeof(h));
+		Base::zeroMemory(scalar, sizeof(scalar));
+		Base::zeroMemory(r, sizeof(r));
+		Base::zeroMemory(a, sizeof(a));
+	}
+
+	sl_bool Ed25519::verify(const void* publicKey, const void* message, sl_size size, const void* _signature) noexcept
+	{
+		const sl_uint8* signature = (const sl_uint8*)_signature;
+		// S < L
+		sl_uint64 S[4], t[4];
+		_priv_ECC_loadLE(S, signature + 32);
+		if (!(_priv_ECC_subWords(t, S, _priv_Ed25519_L.m))) {
+			return sl_false;
+		}
+		_priv_Ed25519_Point A;
+		if (!(_priv_Ed25519_decode(A, (const sl_uint8*)publicKey))) {
+			return sl_false;
+		}
+		// -A
+		_priv_ECC_neg(A.X, A.X, PRIV_ED25519_P);
+		_priv_ECC_neg(A.T, A.T, PRIV_ED25519_P);
+
+		sl_uint8 digest[64];
+		SHA512 hash;
+		hash.start();
+		hash.update(signature, 32);
+		hash.update(publicKey, 32);
+		hash.update(message, size);
+		hash.finish(digest);
+		sl_uint64 k[4];
+		_priv_Ed25519_reduceScalar(k, digest);
+		_priv_ECC_fromMontgomery(k, k, _priv_Ed25519_L);
+		sl_uint8 scalar[32];
+		_priv_ECC_storeLE(scalar, k);
+
+		// R' = [S]B - [k]A
+		_priv_Ed25519_Point P, Q;
+		_priv_Ed25519_mul(P, scalar, A);
+		_priv_Ed25519_mulBase(Q, signature + 32);
+		_priv_Ed25519_Cached c;
+		_priv_Ed25519_toCached(c, Q);
+		_priv_Ed25519_add(P, P, c);
+		sl_uint8 R[32];
+		_priv_Ed25519_encode(R, P);
+		return Base::equalsMemory(R, signature, 32);
+	}
+
+
+/*
+	ECDSA over P-256
+
+	Short Weierstrass curve y^2 = x^3 - 3x + b, homogeneous projective coordinates (X:Y:Z), x = X/Z, y = Y/Z, identity = (0:1:0)
+*/
+
+	// constants in Montgomery form
+	static const sl_uint64 _priv_P256_b[4] = { SLIB_UINT64(0xD89CDF6229C4BDDF), SLIB_UINT64(0xACF005CD78843090), SLIB_UINT64(0xE5A220ABF7212ED6), SLIB_UINT64(0xDC30061D04874834) };
+	static const sl_uint64 _priv_P256_Gx[4] = { SLIB_UINT64(0x79E730D418A9143C), SLIB_UINT64(0x75BA95FC5FEDB601), SLIB_UINT64(0x79FB732B77622510), SLIB_UINT64(0x18905F76A53755C6) };
+	static const sl_uint64 _priv_P256_Gy[4] = { SLIB_UINT64(0xDDF25357CE95560A), SLIB_UINT64(0x8B4AB8E4BA19E45C), SLIB_UINT64(0xD2E88688DD21F325), SLIB_UINT64(0x8571FF1825885D85) };
+
+	struct _priv_P256_Point
+	{
+		sl_uint64 X[4];
+		sl_uint64 Y[4];
+		sl_uint64 Z[4];
+	};
+
+#define PRIV_P256_P _priv_P256_p
+
+	static void _priv_P256_setIdentity(_priv_P256_Point& p) noexcept
+	{
+		_priv_ECC_setZero(p.X);
+		_priv_ECC_copy(p.Y, PRIV_P256_P.R);
+		_priv_ECC_setZero(p.Z);
+	}
+
+	// r = p + q (Renes-Costello-Batina 2016, Algorithm 4: complete addition for a = -3, also valid for doubling)
+	static void _priv_P256_add(_priv_P256_Point& r, const _priv_P256_Point& p, const _priv_P256_Point& q) noexcept
+	{
+		const _priv_ECC_Modulus& M = PRIV_P256_P;
+		sl_uint64 t0[4], t1[4], t2[4], t3[4], t4[4], X3[4], Y3[4], Z3[4];
+		_priv_ECC_mul(t0, p.X, q.X, M);
+		_priv_ECC_mul(t1, p.Y, q.Y, M);
+		_priv_ECC_mul(t2, p.Z, q.Z, M);
+		_priv_ECC_add(t3, p.X, p.Y, M);
+		_priv_ECC_add(t4, q.X, q.Y, M);
+		_priv_ECC_mul(t3, t3, t4, M);
+		_priv_ECC_add(t4, t0, t1, M);
+		_priv_ECC_sub(t3, t3, t4, M);
+		_priv_ECC_add(t4, p.Y, p.Z, M);
+		_priv_ECC_add(X3, q.Y, q.Z, M);
+		_priv_ECC_mul(t4, t4, X3, M);
+		_priv_ECC_add(X3, t1, t2, M);
+		_priv_ECC_sub(t4, t4, X3, M);
+		_priv_ECC_add(X3, p.X, p.Z, M);
+		_priv_ECC_add(Y3, q.X, q.Z, M);
+		_priv_ECC_mul(X3, X3, Y3, M);
+		_priv_ECC_add(Y3, t0, t2, M);
+		_priv_ECC_sub(Y3, X3, Y3, M);
+		_priv_ECC_mul(Z3, _priv_P256_b, t2, M);
+		_priv_ECC_sub(X3, Y3, Z3, M);
+		_priv_ECC_add(Z3, X3, X3, M);
+		_priv_ECC_add(X3, X3, Z3, M);
+		_priv_ECC_sub(Z3, t1, X3, M);
+		_priv_ECC_add(X3, t1, X3, M);
+		_priv_ECC_mul(Y3, _priv_P256_b, Y3, M);
+		_priv_ECC_add(t1, t2, t2, M);
+		_priv_ECC_add(t2, t1, t2, M);
+		_priv_ECC_sub(Y3, Y3, t2, M);
+		_priv_ECC_sub(Y3, Y3, t0, M);
+		_priv_ECC_add(t1, Y3, Y3, M);
+		_priv_ECC_add(Y3, t1, Y3, M);
+		_priv_ECC_add(t1, t0, t0, M);
+		_priv_ECC_add(t0, t1, t0, M);
+		_priv_ECC_sub(t0, t0, t2, M);
+		_priv_ECC_mul(t1, t4, Y3, M);
+		_priv_ECC_mul(t2, t0, Y3, M);
+		_priv_ECC_mul(Y3, X3, Z3, M);
+		_priv_ECC_add(Y3, Y3, t2, M);
+		_priv_ECC_mul(X3, t3, X3, M);
+		_priv_ECC_sub(X3, X3, t1, M);
+		_priv_ECC_mul(Z3, t4, Z3, M);
+		_priv_ECC_mul(t1, t3, t0, M);
+		_priv_ECC_add(Z3, Z3, t1, M);
+		_priv_ECC_copy(r.X, X3);
+		_priv_ECC_copy(r.Y, Y3);
+		_priv_ECC_copy(r.Z, Z3);
+	}
+
+	// returns false for the identity, `x` and `y` are not in Montgomery form
+	static sl_bool _priv_P256_toAffine(sl_uint64* x, sl_uint64* y, const _priv_P256_Point& p) noexcept
+	{
+		if (_priv_ECC_zeroMask(p.Z)) {
+			return sl_false;
+		}
+		sl_uint64 zi[4];
+		_priv_ECC_invert(zi, p.Z, PRIV_P256_P);
+		_priv_ECC_mul(x, p.X, zi, PRIV_P256_P);
+		_priv_ECC_fromMontgomery(x, x, PRIV_P256_P);
+		if (y) {
+			_priv_ECC_mul(y, p.Y, zi, PRIV_P256_P);
+			_priv_ECC_fromMontgomery(y, y, PRIV_P256_P);
+		}
+		return sl_true;
+	}
+
+	// table[j][i] = (i + 1) * 16^j * G
+	class _priv_P256_BaseTable
+	{
+	public:
+		_priv_P256_Point table[65][8];
+
+	public:
+		_priv_P256_BaseTable()
+		{
+			_priv_P256_Point P;
+			_priv_ECC_copy(P.X, _priv_P256_Gx);
+			_priv_ECC_copy(P.Y, _priv_P256_Gy);
+			_priv_ECC_copy(P.Z, PRIV_P256_P.R);
+			for (sl_uint32 j = 0; j < 65; j++) {
+				table[j][0] = P;
+				for (sl_uint32 i = 1; i < 8; i++) {
+					_priv_P256_add(table[j][i], table[j][i - 1], P);
+				}
+				for (sl_uint32 k = 0; k < 4; k++) {
+					_priv_P256_add(P, P, P);
+				}
+			}
+		}
+
+	};
+
+	static const _priv_P256_BaseTable& _priv_P256_getBaseTable()
+	{
+		static _priv_P256_BaseTable table;
+		return table;
+	}
+
+	// t = digit * row[0] (constant-time)
+	static void _priv_P256_select(_priv_P256_Point& t, const _priv_P256_Point* row, sl_int8 digit) noexcept
+	{
+		sl_uint32 abs;
+		sl_uint64 maskNegative = _priv_ECC_splitDigit(digit, abs);
+		_priv_P256_setIdentity(t);
+		for (sl_uint32 i = 0; i < 8; i++) {
+			sl_uint64 mask = _priv_ECC_equalMask(abs, i + 1);
+			_priv_ECC_cmov(t.X, row[i].X, mask);
+			_priv_ECC_cmov(t.Y, row[i].Y, mask);
+			_priv_ECC_cmov(t.Z, row[i].Z, mask);
+		}
+		sl_uint64 n[4];
+		_priv_ECC_neg(n, t.Y, PRIV_P256_P);
+		_priv_ECC_cmov(t.Y, n, maskNegative);
+	}
+
+	// r = [s]G, `s`: little-endian scalar (constant-time)
+	static void _priv_P256_mulBase(_priv_P256_Point& r, const sl_uint8* s) noexcept
+	{
+		const _priv_P256_BaseTable& table = _priv_P256_getBaseTable();
+		sl_int8 e[65];
+		_priv_ECC_recodeScalar(e, s);
+		_priv_P256_setIdentity(r);
+		_priv_P256_Point t;
+		for (sl_uint32 j = 0; j < 65; j++) {
+			_priv_P256_select(t, table.table[j], e[j]);
+			_priv_P256_add(r, r, t);
+		}
+	}
+
+	// r = [s]P, `s`: little-endian scalar (not constant-time)
+	static void _priv_P256_mul(_priv_P256_Point& r, const sl_uint8* s, const _priv_P256_Point& P) noexcept
+	{
+		_priv_P256_Point table[16];
+		table[1] = P;
+		for (sl_uint32 i = 2; i < 16; i++) {
+			_priv_P256_add(table[i], table[i - 1], P);
+		}
+		_priv_P256_setIdentity(r);
+		for (sl_uint32 i = 64; i > 0; i--) {
+			for (sl_uint32 k = 0; k < 4; k++) {
+				_priv_P256_add(r, r, r);
+			}
+			sl_uint32 digit = (s[(i - 1) >> 1] >> (((i - 1) & 1) << 2)) & 15;
+			if (digit) {
+				_priv_P256_add(r, r, table[digit]);
+			}
+		}
+	}
+
+	// 1 <= a < n
+	static sl_bool _priv_P256_isValidScalar(const sl_uint64* a) noexcept
+	{
+		sl_uint64 t[4];
+		return !(_priv_ECC_zeroMask(a)) && _priv_ECC_subWords(t, a, _priv_P256_n.m) != 0;
+	}
+
+	void ECDSA_P256::generatePrivateKey(void* privateKey) noexcept
+	{
+		sl_uint64 d[4];
+		do {
+			Math::randomMemory(privateKey, PrivateKeySize);
+			_priv_ECC_loadBE(d, (const sl_uint8*)privateKey);
+		} while (!(_priv_P256_isValidScalar(d)));
+		Base::zeroMemory(d, sizeof(d));
+	}
+
+	sl_bool ECDSA_P256::getPublicKey(const void* privateKey, void* _publicKey) noexcept
+	{
+		sl_uint8* publicKey = (sl_uint8*)_publicKey;
+		sl_uint64 d[4];
+		_priv_ECC_loadBE(d, (const sl_uint8*)privateKey);
+		if (!(_priv_P256_isValidScalar(d))) {
+			return sl_false;
+		}
+		sl_uint8 scalar[32];
+		_priv_ECC_storeLE(scalar, d);
+		_priv_P256_Point Q;
+		_priv_P256_mulBase(Q, scalar);
+		Base::zeroMemory(scalar, sizeof(scalar));
+		Base::zeroMemory(d, sizeof(d));
+		sl_uint64 x[4], y[4];
+		if (!(_priv_P256_toAffine(x, y, Q))) {
+			return sl_false;
+		}
+		_priv_ECC_storeBE(publicKey, x);
+		_priv_ECC_storeBE(publicKey + 32, y);
+		return sl_true;
+	}
+
+	sl_bool ECDSA_P256::sign(const void* privateKey, const void* hash, void* _signature) noexcept
+	{
+		sl_uint8* signature = (sl_uint8*)_signature;
+		const _priv_ECC_Modulus& N = _priv_P256_n;
+		sl_uint64 d[4];
+		_priv_ECC_loadBE(d, (const sl_uint8*)privateKey);
+		if (!(_priv_P256_isValidScalar(d))) {
+			return sl_false;
+		}
+		sl_uint64 e[4];
+		_priv_ECC_loadBE(e, (const sl_uint8*)hash);
+		// Montgomery forms mod n
+		_priv_ECC_toMontgomery(d, d, N);
+		_priv_ECC_toMontgomery(e, e, N);
+
+		// RFC 6979: K = HMAC_K(V || 0x00 || int2octets(x) || bits2octets(h1)), ...
+		sl_uint8 K[32], V[33 + 64];
+		Base::resetMemory(K, 0, 32);
+		Base::resetMemory(V, 1, 32);
+		sl_uint64 t[4];
+		_priv_ECC_fromMontgomery(t, d, N);
+		_priv_ECC_storeBE(V + 33, t);
+		_priv_ECC_fromMontgomery(t, e, N);
+		_priv_ECC_storeBE(V + 65, t);
+		V[32] = 0;
+		HMAC<SHA256>::execute(K, 32, V, 97, K);
+		HMAC<SHA256>::execute(K, 32, V, 32, V);
+		V[32] = 1;
+		HMAC<SHA256>::execute(K, 32, V, 97, K);
+		HMAC<SHA256>::execute(K, 32, V, 32, V);
+
+		sl_bool flagSuccess = sl_false;
+		for (;;) {
+			HMAC<SHA256>::execute(K, 32, V, 32, V);
+			sl_uint64 k[4];
+			_priv_ECC_loadBE(k, V);
+			if (_priv_P256_isValidScalar(k)) {
+				sl_uint8 scalar[32];
+				_priv_ECC_storeLE(scalar, k);
+				_priv_P256_Point R;
+				_priv_P256_mulBase(R, scalar);
+				Base::zeroMemory(scalar, sizeof(scalar));
+				sl_uint64 r[4];
+				if (_priv_P256_toAffine(r, sl_null, R)) {
+					// r = x mod n
+					_priv_ECC_toMontgomery(r, r, N);
+					if (!(_priv_ECC_zeroMask(r))) {
+						// s = k^-1 (e + r d) mod n
+						sl_uint64 s[4];
+						_priv_ECC_mul(s, r, d, N);
+						_priv_ECC_add(s, s, e, N);
+						_priv_ECC_toMontgomery(k, k, N);
+						_priv_ECC_invert(k, k, N);
+						_priv_ECC_mul(s, s, k, N);
+						if (!(_priv_ECC_zeroMask(s))) {
+							_priv_ECC_fromMontgomery(r, r, N);
+							_priv_ECC_fromMontgomery(s, s, N);
+							_priv_ECC_storeBE(signature, r);
+							_priv_ECC_storeBE(signature + 32, s);
+							flagSuccess = sl_true;
+						}
+					}
+				}
+			}
+			Base::zeroMemory(k, sizeof(k));
+			if (flagSuccess) {
+				break;
+			}
+			V[32] = 0;
+			HMAC<SHA256>::execute(K, 32, V, 33, K);
+			HMAC<SHA256>::execute(K, 32, V, 32, V);
+		}
+		Base::zeroMemory(K, sizeof(K));
+		Base::zeroMemory(V, sizeof(V));
+		Base::zeroMemory(d, sizeof(d));
+		return sl_true;
+	}
+
+	sl_bool ECDSA_P256::verify(const void* _publicKey, const void* hash, const void* _signature) noexcept
+	{
+		const sl_uint8* publicKey = (const sl_uint8*)_publicKey;
+		const sl_uint8* signature = (const sl_uint8*)_signature;
+		const _priv_ECC_Modulus& N = _priv_P256_n;
+		sl_uint64 r[4], s[4], t[4];
+		_priv_ECC_loadBE(r, signature);
+		_priv_ECC_loadBE(s, signature + 32);
+		if (!(_priv_P256_isValidScalar(r)) || !(_priv_P256_isValidScalar(s))) {
+			return sl_false;
+		}
+
+		// Q must be on the curve: y^2 = x^3 - 3x + b
+		_priv_P256_Point Q;
+		_priv_ECC_loadBE(Q.X, publicKey);
+		_priv_ECC_loadBE(Q.Y, publicKey + 32);
+		if (!(_priv_ECC_subWords(t, Q.X, PRIV_P256_P.m)) || !(_priv_ECC_subWords(t, Q.Y, PRIV_P256_P.m))) {
+			return sl_false;
+		}
+		_priv_ECC_toMontgomery(Q.X, Q.X, PRIV_P256_P);
+		_priv_ECC_toMontgomery(Q.Y, Q.Y, PRIV_P256_P);
+		_priv_ECC_copy(Q.Z, PRIV_P256_P.R);
+		{
+			sl_uint64 y2[4], x3[4];
+			_priv_ECC_mul(y2, Q.Y, Q.Y, PRIV_P256_P);
+			_priv_ECC_mul(x3, Q.X, Q.X, PRIV_P256_P);
+			_priv_ECC_mul(x3, x3, Q.X, PRIV_P256_P);
+			_priv_ECC_sub(x3, x3, Q.X, PRIV_P256_P);
+			_priv_ECC_sub(x3, x3, Q.X, PRIV_P256_P);
+			_priv_ECC_sub(x3, x3, Q.X, PRIV_P256_P);
+			_priv_ECC_add(x3, x3, _priv_P256_b, PRIV_P256_P);
+			if (!(_priv_ECC_equals(y2, x3))) {
+				return sl_false;
+			}
+		}
+
+		// w = s^-1, u1 = e w, u2 = r w
+		sl_uint64 e[4], w[4], u1[4], u2[4];
+		_priv_ECC_loadBE(e, (const sl_uint8*)hash);
+		_priv_ECC_toMontgomery(e, e, N);
+		_priv_ECC_toMontgomery(w, s, N);
+		_priv_ECC_invert(w, w, N);
+		_priv_ECC_mul(u1, e, w, N);
+		_priv_ECC_fromMontgomery(u1, u1, N);
+		_priv_ECC_toMontgomery(u2, r, N);
+		_priv_ECC_mul(u2, u2, w, N);
+		_priv_ECC_fromMontgomery(u2, u2, N);
+
+		sl_uint8 scalar[32];
+		_priv_P256_Point P1, P2;
+		_priv_ECC_storeLE(scalar, u1);
+		_priv_P256_mulBase(P1, scalar);
+		_priv_ECC_storeLE(scalar, u2);
+		_priv_P256_mul(P2, scalar, Q);
+		_priv_P256_add(P1, P1, P2);
+		sl_uint64 x[4];
+		if (!(_priv_P256_toAffine(x, sl_null, P1))) {
+			return sl_false;
+		}
+		// x mod n (p < 2n)
+		if (!(_priv_ECC_subWords(t, x, N.m))) {
+			_priv_ECC_copy(x, t);
+		}
+		return _priv_ECC_equals(x, r);
+	}
+
+	sl_bool ECDSA_P256::signMessage(const void* privateKey, const void* message, sl_size size, void* signature) noexcept
+	{
+		sl_uint8 hash[32];
+		SHA256::hash(message, size, hash);
+		return sign(privateKey, hash, signature);
+	}
+
+	sl_bool ECDSA_P256::verifyMessage(const void* publicKey, const void* message, sl_size size, const void* signature) noexcept
+	{
+		sl_uint8 hash[32];
+		SHA256::hash(message, size, hash);
+		return verify(publicKey, hash, signature);
+	}
+
+}
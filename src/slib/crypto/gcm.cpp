@@ -24,9 +24,153 @@
 
 #include "slib/crypto/aes.h"
 
+#include "slib/core/mio.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#endif
+
+// whole blocks are encrypted and hashed in chunks, to keep the data in the cache between two passes
+#define PRIV_GCM_CHUNK_SIZE 4096
+
 namespace slib
 {
 
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+
+	static sl_bool _priv_GCM_isCLMUL()
+	{
+		static sl_bool flag = Cpu::isPCLMULQDQSupported() && Cpu::isSSSE3Supported();
+		return flag;
+	}
+
+	SLIB_CPU_TARGET("ssse3")
+	SLIB_INLINE static __m128i _priv_GCM_reflect(__m128i v)
+	{
+		return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	}
+
+	// accumulates 256-bit carry-less product
+	SLIB_CPU_TARGET("pclmul,sse2")
+	SLIB_INLINE static void _priv_GCM_clmul(__m128i a, __m128i b, __m128i& lo, __m128i& mid, __m128i& hi)
+	{
+		lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));
+		hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));
+		mid = _mm_xor_si128(mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01)));
+	}
+
+	/*
+		Reduces 256-bit product modulo x^128 + x^7 + x^2 + x + 1.
+		Operands are bit-reflected, so the product is shifted left by 1 bit before the reduction.
+		(Intel Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode)
+	*/
+	SLIB_CPU_TARGET("sse2")
+	SLIB_INLINE static __m128i _priv_GCM_reduce(__m128i lo, __m128i mid, __m128i hi)
+	{
+		lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+		hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+		__m128i t1 = _mm_srli_epi32(lo, 31);
+		__m128i t2 = _mm_srli_epi32(hi, 31);
+		lo = _mm_slli_epi32(lo, 1);
+		hi = _mm_slli_epi32(hi, 1);
+		__m128i t3 = _mm_srli_si128(t1, 12);
+		t2 = _mm_slli_si128(t2, 4);
+		t1 = _mm_slli_si128(t1, 4);
+		lo = _mm_or_si128(lo, t1);
+		hi = _mm_or_si128(hi, t2);
+		hi = _mm_or_si128(hi, t3);
+
+		t1 = _mm_slli_epi32(lo, 31);
+		t2 = _mm_slli_epi32(lo, 30);
+		t3 = _mm_slli_epi32(lo, 25);
+		t1 = _mm_xor_si128(t1, _mm_xor_si128(t2, t3));
+		t2 = _mm_srli_si128(t1, 4);
+		t1 = _mm_slli_si128(t1, 12);
+		lo = _mm_xor_si128(lo, t1);
+
+		t3 = _mm_srli_epi32(lo, 1);
+		__m128i t4 = _mm_srli_epi32(lo, 2);
+		__m128i t5 = _mm_srli_epi32(lo, 7);
+		t3 = _mm_xor_si128(t3, _mm_xor_si128(t4, _mm_xor_si128(t5, t2)));
+		lo = _mm_xor_si128(lo, t3);
+		return _mm_xor_si128(hi, lo);
+	}
+
+	SLIB_CPU_TARGET("pclmul,sse2")
+	SLIB_INLINE static __m128i _priv_GCM_multiply(__m128i a, __m128i b)
+	{
+		__m128i lo = _mm_setzero_si128();
+		__m128i mid = _mm_setzero_si128();
+		__m128i hi = _mm_setzero_si128();
+		_priv_GCM_clmul(a, b, lo, mid, hi);
+		return _priv_GCM_reduce(lo, mid, hi);
+	}
+
+	SLIB_CPU_TARGET("pclmul,ssse3")
+	static void _priv_GCM_generatePowers_clmul(const void* H, sl_uint8* HP)
+	{
+		__m128i h1 = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)H));
+		__m128i h2 = _priv_GCM_multiply(h1, h1);
+		__m128i h3 = _priv_GCM_multiply(h2, h1);
+		__m128i h4 = _priv_GCM_multiply(h3, h1);
+		_mm_storeu_si128((__m128i*)HP, h1);
+		_mm_storeu_si128((__m128i*)(HP + 16), h2);
+		_mm_storeu_si128((__m128i*)(HP + 32), h3);
+		_mm_storeu_si128((__m128i*)(HP + 48), h4);
+	}
+
+	SLIB_CPU_TARGET("pclmul,ssse3")
+	static void _priv_GCM_multiplyH_clmul(const sl_uint8* HP, const void* X, void* O)
+	{
+		__m128i x = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)X));
+		__m128i h1 = _mm_loadu_si128((const __m128i*)HP);
+		_mm_storeu_si128((__m128i*)O, _priv_GCM_reflect(_priv_GCM_multiply(x, h1)));
+	}
+
+	// 4 blocks are aggregated with H^4 ~ H^1, and reduced once
+	SLIB_CPU_TARGET("pclmul,ssse3")
+	static void _priv_GCM_multiplyData_clmul(const sl_uint8* HP, sl_uint8* X, const sl_uint8* D, sl_size lenD)
+	{
+		__m128i x = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)X));
+		__m128i h1 = _mm_loadu_si128((const __m128i*)HP);
+		__m128i h2 = _mm_loadu_si128((const __m128i*)(HP + 16));
+		__m128i h3 = _mm_loadu_si128((const __m128i*)(HP + 32));
+		__m128i h4 = _mm_loadu_si128((const __m128i*)(HP + 48));
+		while (lenD >= 64) {
+			__m128i d0 = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)D));
+			__m128i d1 = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)(D + 16)));
+			__m128i d2 = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)(D + 32)));
+			__m128i d3 = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)(D + 48)));
+			__m128i lo = _mm_setzero_si128();
+			__m128i mid = _mm_setzero_si128();
+			__m128i hi = _mm_setzero_si128();
+			_priv_GCM_clmul(_mm_xor_si128(x, d0), h4, lo, mid, hi);
+			_priv_GCM_clmul(d1, h3, lo, mid, hi);
+			_priv_GCM_clmul(d2, h2, lo, mid, hi);
+			_priv_GCM_clmul(d3, h1, lo, mid, hi);
+			x = _priv_GCM_reduce(lo, mid, hi);
+			D += 64;
+			lenD -= 64;
+		}
+		while (lenD >= 16) {
+			__m128i d = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)D));
+			x = _priv_GCM_multiply(_mm_xor_si128(x, d), h1);
+			D += 16;
+			lenD -= 16;
+		}
+		if (lenD) {
+			sl_uint8 last[16] = { 0 };
+			Base::copyMemory(last, D, lenD);
+			__m128i d = _priv_GCM_reflect(_mm_loadu_si128((const __m128i*)last));
+			x = _priv_GCM_multiply(_mm_xor_si128(x, d), h1);
+		}
+		_mm_storeu_si128((__m128i*)X, _priv_GCM_reflect(x));
+	}
+
+#endif
+
 	void GCM_Table::generateTable(const void* inH)
 	{
 		sl_uint32 i, j;
@@ -62,6 +206,15 @@ namespace slib
 			}
 			i <<= 1;
 		}
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		flagCLMUL = _priv_GCM_isCLMUL();
+		if (flagCLMUL) {
+			_priv_GCM_generatePowers_clmul(inH, HP);
+		}
+#else
+		flagCLMUL = sl_false;
+#endif
 	}
 
 	static const sl_uint64 PRIV_GCM_R[16] =
@@ -86,6 +239,12 @@ namespace slib
 
 	void GCM_Table::multiplyH(const void* inX, void* inO) const
 	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (flagCLMUL) {
+			_priv_GCM_multiplyH_clmul(HP, inX, inO);
+			return;
+		}
+#endif
 		const sl_uint8* X = (const sl_uint8*)inX;
 		sl_uint8* O = (sl_uint8*)inO;
 		Uint128 Z;
@@ -127,6 +286,12 @@ namespace slib
 
 	void GCM_Table::multiplyData(void* inX, const void* inD, sl_size lenD) const
 	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (flagCLMUL) {
+			_priv_GCM_multiplyData_clmul(HP, (sl_uint8*)inX, (const sl_uint8*)inD, lenD);
+			return;
+		}
+#endif
 		sl_uint8* X = (sl_uint8*)inX;
 		const sl_uint8* D = (const sl_uint8*)inD;
 		sl_size i, k, n;
@@ -259,6 +424,25 @@ namespace slib
 	}
 
 
+	// encrypts the whole blocks with the counter blocks, increasing the low 32 bits of `counter`
+	template <class BlockCipher>
+	static void _priv_GCM_encryptCounterBlocks(const BlockCipher* cipher, sl_uint8* counter, const sl_uint8* input, sl_uint8* output, sl_size size)
+	{
+		sl_uint8 mask[16];
+		for (sl_size i = 0; i < size; i += 16) {
+			cipher->encryptBlock(counter, mask);
+			for (sl_uint32 k = 0; k < 16; k++) {
+				output[i + k] = input[i + k] ^ mask[k];
+			}
+			MIO::writeUint32BE(counter + 12, MIO::readUint32BE(counter + 12) + 1);
+		}
+	}
+
+	static void _priv_GCM_encryptCounterBlocks(const AES* cipher, sl_uint8* counter, const sl_uint8* input, sl_uint8* output, sl_size size)
+	{
+		cipher->encryptBlocks_GCTR(counter, input, output, size);
+	}
+
 	template <class BlockCipher>
 	GCM<BlockCipher>::GCM()
 	{
@@ -329,6 +513,19 @@ namespace slib
 		const sl_uint8* P = (const sl_uint8*)src;
 		sl_uint8* C = (sl_uint8*)dst;
 		
+		while (len >= 16) {
+			n = len & ~((sl_size)15);
+			if (n > PRIV_GCM_CHUNK_SIZE) {
+				n = PRIV_GCM_CHUNK_SIZE;
+			}
+			increaseCIV();
+			_priv_GCM_encryptCounterBlocks(m_cipher, CIV, P, C, n);
+			MIO::writeUint32BE(CIV + 12, MIO::readUint32BE(CIV + 12) - 1);
+			multiplyData(GHASH_X, C, n);
+			P += n;
+			C += n;
+			len -= n;
+		}
 		for (i = 0; i < len; i += 16) {
 			increaseCIV();
 			m_cipher->encryptBlock(CIV, GCTR);
@@ -372,6 +569,19 @@ namespace slib
 		const sl_uint8* C = (const sl_uint8*)src;
 		sl_uint8* P = (sl_uint8*)dst;
 		
+		while (len >= 16) {
+			n = len & ~((sl_size)15);
+			if (n > PRIV_GCM_CHUNK_SIZE) {
+				n = PRIV_GCM_CHUNK_SIZE;
+			}
+			multiplyData(GHASH_X, C, n);
+			increaseCIV();
+			_priv_GCM_encryptCounterBlocks(m_cipher, CIV, C, P, n);
+			MIO::writeUint32BE(CIV + 12, MIO::readUint32BE(CIV + 12) - 1);
+			C += n;
+			P += n;
+			len -= n;
+		}
 		for (i = 0; i < len; i += 16) {
 			increaseCIV();
 			m_cipher->encryptBlock(CIV, GCTR);
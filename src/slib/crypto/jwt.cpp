@@ -25,6 +25,7 @@
 #include "slib/crypto/base64.h"
 #include "slib/crypto/hmac.h"
 #include "slib/crypto/sha2.h"
+#include "slib/crypto/ecc.h"
 
 #include "slib/core/string_buffer.h"
 
@@ -78,46 +79,73 @@ namespace slib
 		}
 	}
 	
-	sl_bool Jwt::decode(const Memory& secret, const String& token) noexcept
+	static sl_reg _priv_Jwt_parse(Jwt& jwt, const String& token, String& signature) noexcept
 	{
 		sl_reg pos1 = token.indexOf('.');
 		if (pos1 < 0) {
-			return sl_false;
+			return -1;
 		}
-		String s1, s2, s3;
+		String s1, s2;
 		sl_reg pos2 = token.indexOf('.', pos1 + 1);
 		if (pos2 < 0) {
-			return sl_false;
+			return -1;
 		}
 		s1 = token.substring(0, pos1);
 		s2 = token.substring(pos1 + 1, pos2);
-		s3 = token.substring(pos2 + 1);
+		signature = token.substring(pos2 + 1);
 		if (s1.isNotEmpty()) {
 			Memory mem = Base64::decode(s1);
 			if (mem.isNull()) {
-				return sl_false;
+				return -1;
 			}
 			JsonParseParam pp;
-			header = Json::parseJson(String::fromUtf8(mem), pp);
+			jwt.header = Json::parseJson(String::fromUtf8(mem), pp);
 			if (pp.flagError) {
-				return sl_false;
+				return -1;
 			}
 		}
 		if (s2.isNotEmpty()) {
 			Memory mem = Base64::decode(s2);
 			if (mem.isNull()) {
-				return sl_false;
+				return -1;
 			}
 			JsonParseParam pp;
-			payload = Json::parseJson(String::fromUtf8(mem), pp);
+			jwt.payload = Json::parseJson(String::fromUtf8(mem), pp);
 			if (pp.flagError) {
-				return sl_false;
+				return -1;
 			}
 		}
-		if (s3.isEmpty()) {
+		if (signature.isEmpty()) {
+			return -1;
+		}
+		return pos2;
+	}
+	
+	sl_bool Jwt::decode(const Memory& secret, const String& token) noexcept
+	{
+		String signature;
+		sl_reg pos = _priv_Jwt_parse(*this, token, signature);
+		if (pos < 0) {
+			return sl_false;
+		}
+		JwtAlgorithm algorithm = getAlgorithm();
+		if (algorithm != JwtAlgorithm::HS256 && algorithm != JwtAlgorithm::HS384 && algorithm != JwtAlgorithm::HS512) {
+			return sl_false;
+		}
+		return verifySignature(algorithm, secret, token.getData(), pos, signature);
+	}
+	
+	sl_bool Jwt::decode(const Memory& key, const String& token, JwtAlgorithm algorithm) noexcept
+	{
+		String signature;
+		sl_reg pos = _priv_Jwt_parse(*this, token, signature);
+		if (pos < 0) {
+			return sl_false;
+		}
+		if (getAlgorithm() != algorithm) {
 			return sl_false;
 		}
-		return s3 == generateSignature(secret, token.getData(), pos2);
+		return verifySignature(algorithm, key, token.getData(), pos, signature);
 	}
 	
 	String Jwt::generateSignature(const Memory& secret, const void* data, sl_size size) const noexcept
@@ -137,6 +165,24 @@ namespace slib
 				HMAC<SHA512>::execute(secret.getData(), secret.getSize(), data, size, signature);
 				sizeSignature = SHA512::HashSize;
 				break;
+			case JwtAlgorithm::ES256:
+				sizeSignature = 0;
+				if (secret.getSize() == ECDSA_P256::PrivateKeySize) {
+					if (ECDSA_P256::signMessage(secret.getData(), data, size, signature)) {
+						sizeSignature = ECDSA_P256::SignatureSize;
+					}
+				}
+				break;
+			case JwtAlgorithm::EdDSA:
+				sizeSignature = 0;
+				if (secret.getSize() == Ed25519::PrivateKeySize) {
+					Ed25519::sign(secret.getData(), sl_null, data, size, signature);
+					sizeSignature = Ed25519::SignatureSize;
+				} else if (secret.getSize() == Ed25519::PrivateKeySize + Ed25519::PublicKeySize) {
+					Ed25519::sign(secret.getData(), (sl_uint8*)(secret.getData()) + Ed25519::PrivateKeySize, data, size, signature);
+					sizeSignature = Ed25519::SignatureSize;
+				}
+				break;
 			default:
 				sizeSignature = 0;
 				break;
@@ -144,6 +190,71 @@ namespace slib
 		return Base64::encodeUrl(signature, sizeSignature);
 	}
 	
+	sl_bool Jwt::verifySignature(JwtAlgorithm algorithm, const Memory& key, const void* data, sl_size size, const String& signature) noexcept
+	{
+		switch (algorithm) {
+			case JwtAlgorithm::HS256:
+			case JwtAlgorithm::HS384:
+			case JwtAlgorithm::HS512:
+				{
+					sl_uint8 hash[SHA512::HashSize];
+					sl_size sizeHash;
+					if (algorithm == JwtAlgorithm::HS256) {
+						HMAC<SHA256>::execute(key.getData(), key.getSize(), data, size, hash);
+						sizeHash = SHA256::HashSize;
+					} else if (algorithm == JwtAlgorithm::HS384) {
+						HMAC<SHA384>::execute(key.getData(), key.getSize(), data, size, hash);
+						sizeHash = SHA384::HashSize;
+					} else {
+						HMAC<SHA512>::execute(key.getData(), key.getSize(), data, size, hash);
+						sizeHash = SHA512::HashSize;
+					}
+					Memory mem = Base64::decode(signature);
+					if (mem.getSize() != sizeHash) {
+						return sl_false;
+					}
+					// constant time comparison
+					const sl_uint8* s = (const sl_uint8*)(mem.getData());
+					sl_uint8 diff = 0;
+					for (sl_size i = 0; i < sizeHash; i++) {
+						diff |= hash[i] ^ s[i];
+					}
+					return !diff;
+				}
+			case JwtAlgorithm::ES256:
+				{
+					const sl_uint8* k = (const sl_uint8*)(key.getData());
+					sl_size sizeKey = key.getSize();
+					if (sizeKey == ECDSA_P256::PublicKeySize + 1 && k[0] == 4) {
+						k++;
+						sizeKey--;
+					}
+					if (sizeKey != ECDSA_P256::PublicKeySize) {
+						return sl_false;
+					}
+					Memory mem = Base64::decode(signature);
+					if (mem.getSize() != ECDSA_P256::SignatureSize) {
+						return sl_false;
+					}
+					return ECDSA_P256::verifyMessage(k, data, size, mem.getData());
+				}
+			case JwtAlgorithm::EdDSA:
+				{
+					if (key.getSize() != Ed25519::PublicKeySize) {
+						return sl_false;
+					}
+					Memory mem = Base64::decode(signature);
+					if (mem.getSize() != Ed25519::SignatureSize) {
+						return sl_false;
+					}
+					return Ed25519::verify(key.getData(), data, size, mem.getData());
+				}
+			default:
+				break;
+		}
+		return sl_false;
+	}
+	
 	SLIB_STATIC_STRING(_g_jwt_field_typ, "typ")
 	SLIB_STATIC_STRING(_g_jwt_field_cty, "cty")
 	SLIB_STATIC_STRING(_g_jwt_field_alg, "alg")
@@ -180,6 +291,7 @@ namespace slib
 	SLIB_STATIC_STRING(_g_jwt_alg_PS256, "PS256")
 	SLIB_STATIC_STRING(_g_jwt_alg_PS384, "PS384")
 	SLIB_STATIC_STRING(_g_jwt_alg_PS512, "PS512")
+	SLIB_STATIC_STRING(_g_jwt_alg_EdDSA, "EdDSA")
 	
 	JwtAlgorithm Jwt::getAlgorithm() const noexcept
 	{
@@ -196,6 +308,7 @@ namespace slib
 		if (alg.equalsIgnoreCase(_g_jwt_alg_PS256)) return JwtAlgorithm::PS256;
 		if (alg.equalsIgnoreCase(_g_jwt_alg_PS384)) return JwtAlgorithm::PS384;
 		if (alg.equalsIgnoreCase(_g_jwt_alg_PS512)) return JwtAlgorithm::PS512;
+		if (alg.equalsIgnoreCase(_g_jwt_alg_EdDSA)) return JwtAlgorithm::EdDSA;
 		return JwtAlgorithm::None;
 	}
 	
@@ -214,6 +327,7 @@ namespace slib
 			case JwtAlgorithm::PS256: header.putItem(_g_jwt_field_alg, _g_jwt_alg_PS256); break;
 			case JwtAlgorithm::PS384: header.putItem(_g_jwt_field_alg, _g_jwt_alg_PS384); break;
 			case JwtAlgorithm::PS512: header.putItem(_g_jwt_field_alg, _g_jwt_alg_PS512); break;
+			case JwtAlgorithm::EdDSA: header.putItem(_g_jwt_field_alg, _g_jwt_alg_EdDSA); break;
 			default:
 				header.removeItem(_g_jwt_field_alg);
 				break;
@@ -30,6 +30,22 @@
 namespace slib
 {
 
+	// Montgomery parameters are cached on the key, and rebuilt only when the modulus is changed
+	static Ref<MontgomeryContext> _priv_RSA_getMontgomery(AtomicRef<MontgomeryContext>& cache, const BigInt& M)
+	{
+		Ref<MontgomeryContext> context = cache;
+		if (context.isNotNull()) {
+			if (context->getModulus().compare(M) == 0) {
+				return context;
+			}
+		}
+		context = MontgomeryContext::create(M);
+		if (context.isNotNull()) {
+			cache = context;
+		}
+		return context;
+	}
+
 	RSAPublicKey::RSAPublicKey()
 	{
 	}
@@ -43,6 +59,11 @@ namespace slib
 		return (sl_uint32)(N.getMostSignificantBytes());
 	}
 
+	Ref<MontgomeryContext> RSAPublicKey::getMontgomeryN() const
+	{
+		return _priv_RSA_getMontgomery(m_montN, N);
+	}
+
 
 	RSAPrivateKey::RSAPrivateKey()
 	{
@@ -57,6 +78,21 @@ namespace slib
 		return (sl_uint32)(N.getMostSignificantBytes());
 	}
 
+	Ref<MontgomeryContext> RSAPrivateKey::getMontgomeryN() const
+	{
+		return _priv_RSA_getMontgomery(m_montN, N);
+	}
+
+	Ref<MontgomeryContext> RSAPrivateKey::getMontgomeryP() const
+	{
+		return _priv_RSA_getMontgomery(m_montP, P);
+	}
+
+	Ref<MontgomeryContext> RSAPrivateKey::getMontgomeryQ() const
+	{
+		return _priv_RSA_getMontgomery(m_montQ, Q);
+	}
+
 
 	sl_bool RSA::executePublic(const RSAPublicKey& key, const void* src, void* dst)
 	{
@@ -65,7 +101,12 @@ namespace slib
 		if (T >= key.N) {
 			return sl_false;
 		}
-		T = T.pow_montgomery(key.E, key.N);
+		Ref<MontgomeryContext> context = key.getMontgomeryN();
+		if (context.isNotNull()) {
+			T = context->pow(T, key.E);
+		} else {
+			T = BigInt::pow_montgomery(T, key.E, key.N);
+		}
 		if (T.isNotNull()) {
 			if (T.getBytesBE(dst, n)) {
 				return sl_true;
@@ -82,12 +123,25 @@ namespace slib
 			return sl_false;
 		}
 		if (key.flagUseOnlyD) {
-			T = T.pow_montgomery(key.D, key.N);
+			Ref<MontgomeryContext> context = key.getMontgomeryN();
+			if (context.isNotNull()) {
+				T = context->pow(T, key.D);
+			} else {
+				T = BigInt::pow_montgomery(T, key.D, key.N);
+			}
 		} else {
-			BigInt TP = T.pow_montgomery(key.DP, key.P);
-			BigInt TQ = T.pow_montgomery(key.DQ, key.Q);
-			T = ((TP - TQ) * key.IQ) % key.P;
-			T = TQ + T * key.Q;
+			Ref<MontgomeryContext> contextP = key.getMontgomeryP();
+			Ref<MontgomeryContext> contextQ = key.getMontgomeryQ();
+			if (contextP.isNotNull() && contextQ.isNotNull()) {
+				BigInt TP = contextP->pow(T, key.DP);
+				BigInt TQ = contextQ->pow(T, key.DQ);
+				T = TQ + contextP->mulMod(TP - TQ, key.IQ) * key.Q;
+			} else {
+				BigInt TP = BigInt::pow_montgomery(T, key.DP, key.P);
+				BigInt TQ = BigInt::pow_montgomery(T, key.DQ, key.Q);
+				T = ((TP - TQ) * key.IQ) % key.P;
+				T = TQ + T * key.Q;
+			}
 		}
 		if (T.isNotNull()) {
 			if (T.getBytesBE(dst, n)) {
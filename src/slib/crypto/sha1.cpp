@@ -24,10 +24,182 @@
 
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#endif
 
 namespace slib
 {
 
+	static void _priv_SHA1_compress_generic(sl_uint32* h, const sl_uint8* input)
+	{
+		static sl_uint32 K[4] = {
+			0x5A827999ul, 0x6ED9EBA1ul, 0x8F1BBCDCul, 0xCA62C1D6ul
+		};
+
+		sl_uint32 W[80];
+		sl_uint32 v[5];
+		sl_uint32 i;
+		for (i = 0; i < 16; i++) {
+			W[i] = MIO::readUint32BE(input + (i << 2));
+		}
+		for (i = 16; i < 80; i++) {
+			W[i] = Math::rotateLeft32(W[i - 3] ^ W[i - 8] ^ W[i - 14] ^ W[i - 16], 1);
+		}
+		for (i = 0; i < 5; i++) {
+			v[i] = h[i];
+		}
+		sl_uint32 f[4];
+		for (i = 0; i < 80; i++) {
+			sl_uint32 j = i / 20;
+			f[0] = v[3] ^ (v[1] & (v[2] ^ v[3]));
+			f[1] = v[1] ^ v[2] ^ v[3];
+			f[2] = (v[1] & v[2]) | (v[3] & (v[1] | v[2]));
+			f[3] = f[1];
+			sl_uint32 t = Math::rotateLeft32(v[0], 5) + f[j] + v[4] + K[j] + W[i];
+			v[4] = v[3];
+			v[3] = v[2];
+			v[2] = Math::rotateLeft32(v[1], 30);
+			v[1] = v[0];
+			v[0] = t;
+		}
+		for (i = 0; i < 5; i++) {
+			h[i] += v[i];
+		}
+	}
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	static sl_bool _priv_SHA1_isSHANI()
+	{
+		static sl_bool flag = Cpu::isSHANISupported() && Cpu::isSSE41Supported() && Cpu::isSSSE3Supported();
+		return flag;
+	}
+
+#define PRIV_SHA1_SHANI_ROUNDS(E_IN, E_OUT, M, F) \
+	E_IN = _mm_sha1nexte_epu32(E_IN, M); \
+	E_OUT = ABCD; \
+	ABCD = _mm_sha1rnds4_epu32(ABCD, E_IN, F);
+
+	SLIB_CPU_TARGET("sha,sse4.1,ssse3")
+	static void _priv_SHA1_compress_shani(sl_uint32* h, const sl_uint8* input, sl_size nBlocks)
+	{
+		const __m128i MASK = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+		__m128i ABCD, E0, E1, M0, M1, M2, M3;
+
+		ABCD = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0x1B);
+		E0 = _mm_set_epi32((int)(h[4]), 0, 0, 0);
+
+		for (sl_size iBlock = 0; iBlock < nBlocks; iBlock++) {
+			__m128i ABCD_SAVE = ABCD;
+			__m128i E_SAVE = E0;
+			M0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)input), MASK);
+			M1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 16)), MASK);
+			M2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 32)), MASK);
+			M3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 48)), MASK);
+
+			// rounds 0-3
+			E0 = _mm_add_epi32(E0, M0);
+			E1 = ABCD;
+			ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+			// rounds 4-19
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M1, 0)
+			M0 = _mm_sha1msg1_epu32(M0, M1);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M2, 0)
+			M1 = _mm_sha1msg1_epu32(M1, M2);
+			M0 = _mm_xor_si128(M0, M2);
+			M0 = _mm_sha1msg2_epu32(M0, M3);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M3, 0)
+			M2 = _mm_sha1msg1_epu32(M2, M3);
+			M1 = _mm_xor_si128(M1, M3);
+			M1 = _mm_sha1msg2_epu32(M1, M0);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M0, 0)
+			M3 = _mm_sha1msg1_epu32(M3, M0);
+			M2 = _mm_xor_si128(M2, M0);
+			// rounds 20-39
+			M2 = _mm_sha1msg2_epu32(M2, M1);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M1, 1)
+			M0 = _mm_sha1msg1_epu32(M0, M1);
+			M3 = _mm_xor_si128(M3, M1);
+			M3 = _mm_sha1msg2_epu32(M3, M2);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M2, 1)
+			M1 = _mm_sha1msg1_epu32(M1, M2);
+			M0 = _mm_xor_si128(M0, M2);
+			M0 = _mm_sha1msg2_epu32(M0, M3);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M3, 1)
+			M2 = _mm_sha1msg1_epu32(M2, M3);
+			M1 = _mm_xor_si128(M1, M3);
+			M1 = _mm_sha1msg2_epu32(M1, M0);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M0, 1)
+			M3 = _mm_sha1msg1_epu32(M3, M0);
+			M2 = _mm_xor_si128(M2, M0);
+			M2 = _mm_sha1msg2_epu32(M2, M1);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M1, 1)
+			M0 = _mm_sha1msg1_epu32(M0, M1);
+			M3 = _mm_xor_si128(M3, M1);
+			// rounds 40-59
+			M3 = _mm_sha1msg2_epu32(M3, M2);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M2, 2)
+			M1 = _mm_sha1msg1_epu32(M1, M2);
+			M0 = _mm_xor_si128(M0, M2);
+			M0 = _mm_sha1msg2_epu32(M0, M3);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M3, 2)
+			M2 = _mm_sha1msg1_epu32(M2, M3);
+			M1 = _mm_xor_si128(M1, M3);
+			M1 = _mm_sha1msg2_epu32(M1, M0);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M0, 2)
+			M3 = _mm_sha1msg1_epu32(M3, M0);
+			M2 = _mm_xor_si128(M2, M0);
+			M2 = _mm_sha1msg2_epu32(M2, M1);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M1, 2)
+			M0 = _mm_sha1msg1_epu32(M0, M1);
+			M3 = _mm_xor_si128(M3, M1);
+			M3 = _mm_sha1msg2_epu32(M3, M2);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M2, 2)
+			M1 = _mm_sha1msg1_epu32(M1, M2);
+			M0 = _mm_xor_si128(M0, M2);
+			// rounds 60-79
+			M0 = _mm_sha1msg2_epu32(M0, M3);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M3, 3)
+			M2 = _mm_sha1msg1_epu32(M2, M3);
+			M1 = _mm_xor_si128(M1, M3);
+			M1 = _mm_sha1msg2_epu32(M1, M0);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M0, 3)
+			M3 = _mm_sha1msg1_epu32(M3, M0);
+			M2 = _mm_xor_si128(M2, M0);
+			M2 = _mm_sha1msg2_epu32(M2, M1);
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M1, 3)
+			M3 = _mm_xor_si128(M3, M1);
+			M3 = _mm_sha1msg2_epu32(M3, M2);
+			PRIV_SHA1_SHANI_ROUNDS(E0, E1, M2, 3)
+			PRIV_SHA1_SHANI_ROUNDS(E1, E0, M3, 3)
+
+			E0 = _mm_sha1nexte_epu32(E0, E_SAVE);
+			ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+			input += 64;
+		}
+
+		_mm_storeu_si128((__m128i*)h, _mm_shuffle_epi32(ABCD, 0x1B));
+		h[4] = (sl_uint32)(_mm_extract_epi32(E0, 3));
+	}
+#endif
+
+	static void _priv_SHA1_compress(sl_uint32* h, const sl_uint8* input, sl_size nBlocks)
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_SHA1_isSHANI()) {
+			_priv_SHA1_compress_shani(h, input, nBlocks);
+			return;
+		}
+#endif
+		for (sl_size i = 0; i < nBlocks; i++) {
+			_priv_SHA1_compress_generic(h, input);
+			input += 64;
+		}
+	}
+
+
 	SHA1::SHA1()
 	{
 		rdata_len = 0;
@@ -75,10 +247,12 @@ namespace slib
 				}
 			}
 		}
-		while (sizeInput >= 64) {
-			_updateSection(input);
-			sizeInput -= 64;
-			input += 64;
+		sl_size nBlocks = sizeInput >> 6;
+		if (nBlocks) {
+			_priv_SHA1_compress(h, input, nBlocks);
+			nBlocks <<= 6;
+			sizeInput -= nBlocks;
+			input += nBlocks;
 		}
 		if (sizeInput) {
 			Base::copyMemory(rdata, input, sizeInput);
@@ -114,39 +288,7 @@ namespace slib
 
 	void SHA1::_updateSection(const sl_uint8* input)
 	{
-		static sl_uint32 K[4] = {
-			0x5A827999ul, 0x6ED9EBA1ul, 0x8F1BBCDCul, 0xCA62C1D6ul
-		};
-
-		sl_uint32 W[80];
-		sl_uint32 v[5];
-		sl_uint32 i;
-		for (i = 0; i < 16; i++) {
-			W[i] = MIO::readUint32BE(input + (i << 2));
-		}
-		for (i = 16; i < 80; i++) {
-			W[i] = Math::rotateLeft32(W[i - 3] ^ W[i - 8] ^ W[i - 14] ^ W[i - 16], 1);
-		}
-		for (i = 0; i < 5; i++) {
-			v[i] = h[i];
-		}
-		sl_uint32 f[4];
-		for (i = 0; i < 80; i++) {
-			sl_uint32 j = i / 20;
-			f[0] = v[3] ^ (v[1] & (v[2] ^ v[3]));
-			f[1] = v[1] ^ v[2] ^ v[3];
-			f[2] = (v[1] & v[2]) | (v[3] & (v[1] | v[2]));
-			f[3] = f[1];
-			sl_uint32 t = Math::rotateLeft32(v[0], 5) + f[j] + v[4] + K[j] + W[i];
-			v[4] = v[3];
-			v[3] = v[2];
-			v[2] = Math::rotateLeft32(v[1], 30);
-			v[1] = v[0];
-			v[0] = t;
-		}
-		for (i = 0; i < 5; i++) {
-			h[i] += v[i];
-		}
+		_priv_SHA1_compress(h, input, 1);
 	}
 
 }
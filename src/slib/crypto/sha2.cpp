@@ -23,10 +23,273 @@
 #include "slib/crypto/sha2.h"
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#endif
 
 namespace slib
 {
 
+	static const sl_uint32 _priv_SHA256_K[64] = {
+		0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
+		0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+		0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
+		0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+		0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
+		0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+		0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
+		0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+		0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
+		0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+		0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
+		0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+		0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
+		0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+		0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
+		0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+	};
+
+	static void _priv_SHA256_compress_generic(sl_uint32* h, const sl_uint8* input)
+	{
+		sl_uint32 W[64];
+		sl_uint32 v[8];
+		sl_uint32 i;
+		for (i = 0; i < 16; i++) {
+			W[i] = MIO::readUint32BE(input + (i << 2));
+		}
+		for (i = 16; i < 64; i++) {
+			sl_uint32 s0 = Math::rotateRight32(W[i - 15], 7) ^ Math::rotateRight32(W[i - 15], 18) ^ (W[i - 15] >> 3);
+			sl_uint32 s1 = Math::rotateRight32(W[i - 2], 17) ^ Math::rotateRight32(W[i - 2], 19) ^ (W[i - 2] >> 10);
+			W[i] = W[i - 16] + s0 + W[i - 7] + s1;
+		}
+		for (i = 0; i < 8; i++) {
+			v[i] = h[i];
+		}
+		for (i = 0; i < 64; i++) {
+			sl_uint32 S1 = Math::rotateRight32(v[4], 6) ^ Math::rotateRight32(v[4], 11) ^ Math::rotateRight32(v[4], 25);
+			sl_uint32 ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
+			sl_uint32 temp1 = v[7] + S1 + ch + _priv_SHA256_K[i] + W[i];
+			sl_uint32 S0 = Math::rotateRight32(v[0], 2) ^ Math::rotateRight32(v[0], 13) ^ Math::rotateRight32(v[0], 22);
+			sl_uint32 maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+			sl_uint32 temp2 = S0 + maj;
+			v[7] = v[6];
+			v[6] = v[5];
+			v[5] = v[4];
+			v[4] = v[3] + temp1;
+			v[3] = v[2];
+			v[2] = v[1];
+			v[1] = v[0];
+			v[0] = temp1 + temp2;
+		}
+		for (i = 0; i < 8; i++) {
+			h[i] += v[i];
+		}
+	}
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	static sl_bool _priv_SHA256_isSHANI()
+	{
+		static sl_bool flag = Cpu::isSHANISupported() && Cpu::isSSE41Supported() && Cpu::isSSSE3Supported();
+		return flag;
+	}
+
+	static sl_bool _priv_SHA256_isAVX2()
+	{
+		static sl_bool flag = Cpu::isAVX2Supported();
+		return flag;
+	}
+
+#define PRIV_SHA256_SHANI_ROUNDS(M, i) \
+	MSG = _mm_add_epi32(M, _mm_loadu_si128((const __m128i*)(_priv_SHA256_K + (i << 2)))); \
+	STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG); \
+	MSG = _mm_shuffle_epi32(MSG, 0x0E); \
+	STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+
+#define PRIV_SHA256_SHANI_MSG1(M_PREV, M) \
+	M_PREV = _mm_sha256msg1_epu32(M_PREV, M);
+
+#define PRIV_SHA256_SHANI_MSG2(M_PREV, M, M_NEXT) \
+	M_NEXT = _mm_add_epi32(M_NEXT, _mm_alignr_epi8(M, M_PREV, 4)); \
+	M_NEXT = _mm_sha256msg2_epu32(M_NEXT, M);
+
+	SLIB_CPU_TARGET("sha,sse4.1,ssse3")
+	static void _priv_SHA256_compress_shani(sl_uint32* h, const sl_uint8* input, sl_size nBlocks)
+	{
+		const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+		__m128i STATE0, STATE1, MSG, M0, M1, M2, M3;
+
+		// (A, B, C, D), (E, F, G, H) => (A, B, E, F), (C, D, G, H)
+		MSG = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0xB1);
+		STATE1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(h + 4)), 0x1B);
+		STATE0 = _mm_alignr_epi8(MSG, STATE1, 8);
+		STATE1 = _mm_blend_epi16(STATE1, MSG, 0xF0);
+
+		for (sl_size iBlock = 0; iBlock < nBlocks; iBlock++) {
+			__m128i ABEF = STATE0;
+			__m128i CDGH = STATE1;
+			M0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)input), MASK);
+			M1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 16)), MASK);
+			M2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 32)), MASK);
+			M3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 48)), MASK);
+
+			PRIV_SHA256_SHANI_ROUNDS(M0, 0)
+			PRIV_SHA256_SHANI_ROUNDS(M1, 1)
+			PRIV_SHA256_SHANI_MSG1(M0, M1)
+			PRIV_SHA256_SHANI_ROUNDS(M2, 2)
+			PRIV_SHA256_SHANI_MSG1(M1, M2)
+			PRIV_SHA256_SHANI_ROUNDS(M3, 3)
+			PRIV_SHA256_SHANI_MSG2(M2, M3, M0)
+			PRIV_SHA256_SHANI_MSG1(M2, M3)
+			PRIV_SHA256_SHANI_ROUNDS(M0, 4)
+			PRIV_SHA256_SHANI_MSG2(M3, M0, M1)
+			PRIV_SHA256_SHANI_MSG1(M3, M0)
+			PRIV_SHA256_SHANI_ROUNDS(M1, 5)
+			PRIV_SHA256_SHANI_MSG2(M0, M1, M2)
+			PRIV_SHA256_SHANI_MSG1(M0, M1)
+			PRIV_SHA256_SHANI_ROUNDS(M2, 6)
+			PRIV_SHA256_SHANI_MSG2(M1, M2, M3)
+			PRIV_SHA256_SHANI_MSG1(M1, M2)
+			PRIV_SHA256_SHANI_ROUNDS(M3, 7)
+			PRIV_SHA256_SHANI_MSG2(M2, M3, M0)
+			PRIV_SHA256_SHANI_MSG1(M2, M3)
+			PRIV_SHA256_SHANI_ROUNDS(M0, 8)
+			PRIV_SHA256_SHANI_MSG2(M3, M0, M1)
+			PRIV_SHA256_SHANI_MSG1(M3, M0)
+			PRIV_SHA256_SHANI_ROUNDS(M1, 9)
+			PRIV_SHA256_SHANI_MSG2(M0, M1, M2)
+			PRIV_SHA256_SHANI_MSG1(M0, M1)
+			PRIV_SHA256_SHANI_ROUNDS(M2, 10)
+			PRIV_SHA256_SHANI_MSG2(M1, M2, M3)
+			PRIV_SHA256_SHANI_MSG1(M1, M2)
+			PRIV_SHA256_SHANI_ROUNDS(M3, 11)
+			PRIV_SHA256_SHANI_MSG2(M2, M3, M0)
+			PRIV_SHA256_SHANI_MSG1(M2, M3)
+			PRIV_SHA256_SHANI_ROUNDS(M0, 12)
+			PRIV_SHA256_SHANI_MSG2(M3, M0, M1)
+			PRIV_SHA256_SHANI_MSG1(M3, M0)
+			PRIV_SHA256_SHANI_ROUNDS(M1, 13)
+			PRIV_SHA256_SHANI_MSG2(M0, M1, M2)
+			PRIV_SHA256_SHANI_ROUNDS(M2, 14)
+			PRIV_SHA256_SHANI_MSG2(M1, M2, M3)
+			PRIV_SHA256_SHANI_ROUNDS(M3, 15)
+
+			STATE0 = _mm_add_epi32(STATE0, ABEF);
+			STATE1 = _mm_add_epi32(STATE1, CDGH);
+			input += 64;
+		}
+
+		// (A, B, E, F), (C, D, G, H) => (A, B, C, D), (E, F, G, H)
+		MSG = _mm_shuffle_epi32(STATE0, 0x1B);
+		STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);
+		STATE0 = _mm_blend_epi16(MSG, STATE1, 0xF0);
+		STATE1 = _mm_alignr_epi8(STATE1, MSG, 8);
+		_mm_storeu_si128((__m128i*)h, STATE0);
+		_mm_storeu_si128((__m128i*)(h + 4), STATE1);
+	}
+
+	SLIB_CPU_TARGET("avx2")
+	static void _priv_SHA256_transpose_avx2(__m256i* r)
+	{
+		__m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+		__m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+		__m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+		__m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+		__m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+		__m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+		__m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+		__m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+		__m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+		__m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+		__m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+		__m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+		__m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+		__m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+		__m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+		__m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+		r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+		r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+		r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+		r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+		r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+		r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+		r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+		r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+	}
+
+#define PRIV_SHA256_AVX2_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n))
+
+	// Compresses one block for each of 8 independent messages. state[i] holds word i of all 8 lanes; lanes not set in `mask` keep their state
+	SLIB_CPU_TARGET("avx2")
+	static void _priv_SHA256_compress_avx2x8(__m256i* state, const sl_uint8* const* blocks, __m256i mask)
+	{
+		const __m256i BSWAP = _mm256_set_epi8(
+			12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+			12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+		__m256i W[16];
+		sl_uint32 i;
+		for (i = 0; i < 8; i++) {
+			W[i] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(blocks[i])), BSWAP);
+			W[i + 8] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(blocks[i] + 32)), BSWAP);
+		}
+		_priv_SHA256_transpose_avx2(W);
+		_priv_SHA256_transpose_avx2(W + 8);
+
+		__m256i a = state[0], b = state[1], c = state[2], d = state[3];
+		__m256i e = state[4], f = state[5], g = state[6], h = state[7];
+		for (i = 0; i < 64; i++) {
+			__m256i w;
+			if (i < 16) {
+				w = W[i];
+			} else {
+				__m256i w15 = W[(i - 15) & 15];
+				__m256i w2 = W[(i - 2) & 15];
+				__m256i s0 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(w15, 7), PRIV_SHA256_AVX2_ROTR(w15, 18)), _mm256_srli_epi32(w15, 3));
+				__m256i s1 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(w2, 17), PRIV_SHA256_AVX2_ROTR(w2, 19)), _mm256_srli_epi32(w2, 10));
+				w = _mm256_add_epi32(_mm256_add_epi32(W[i & 15], s0), _mm256_add_epi32(W[(i - 7) & 15], s1));
+				W[i & 15] = w;
+			}
+			__m256i S1 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(e, 6), PRIV_SHA256_AVX2_ROTR(e, 11)), PRIV_SHA256_AVX2_ROTR(e, 25));
+			__m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+			__m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, _mm256_add_epi32(w, _mm256_set1_epi32((int)(_priv_SHA256_K[i])))));
+			__m256i S0 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(a, 2), PRIV_SHA256_AVX2_ROTR(a, 13)), PRIV_SHA256_AVX2_ROTR(a, 22));
+			__m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+			h = g;
+			g = f;
+			f = e;
+			e = _mm256_add_epi32(d, temp1);
+			d = c;
+			c = b;
+			b = a;
+			a = _mm256_add_epi32(temp1, _mm256_add_epi32(S0, maj));
+		}
+		state[0] = _mm256_blendv_epi8(state[0], _mm256_add_epi32(state[0], a), mask);
+		state[1] = _mm256_blendv_epi8(state[1], _mm256_add_epi32(state[1], b), mask);
+		state[2] = _mm256_blendv_epi8(state[2], _mm256_add_epi32(state[2], c), mask);
+		state[3] = _mm256_blendv_epi8(state[3], _mm256_add_epi32(state[3], d), mask);
+		state[4] = _mm256_blendv_epi8(state[4], _mm256_add_epi32(state[4], e), mask);
+		state[5] = _mm256_blendv_epi8(state[5], _mm256_add_epi32(state[5], f), mask);
+		state[6] = _mm256_blendv_epi8(state[6], _mm256_add_epi32(state[6], g), mask);
+		state[7] = _mm256_blendv_epi8(state[7], _mm256_add_epi32(state[7], h), mask);
+	}
+#endif
+
+	static void _priv_SHA256_compress(sl_uint32* h, const sl_uint8* input, sl_size nBlocks)
+	{
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (_priv_SHA256_isSHANI()) {
+			_priv_SHA256_compress_shani(h, input, nBlocks);
+			return;
+		}
+#endif
+		for (sl_size i = 0; i < nBlocks; i++) {
+			_priv_SHA256_compress_generic(h, input);
+			input += 64;
+		}
+	}
+
+
 	_priv_SHA256Base::_priv_SHA256Base()
 	{
 		rdata_len = 0;
@@ -69,10 +332,12 @@ namespace slib
 				}
 			}
 		}
-		while (sizeInput >= 64) {
-			_updateSection(input);
-			sizeInput -= 64;
-			input += 64;
+		sl_size nBlocks = sizeInput >> 6;
+		if (nBlocks) {
+			_priv_SHA256_compress(h, input, nBlocks);
+			nBlocks <<= 6;
+			sizeInput -= nBlocks;
+			input += nBlocks;
 		}
 		if (sizeInput) {
 			Base::copyMemory(rdata, input, sizeInput);
@@ -102,61 +367,9 @@ namespace slib
 
 	void _priv_SHA256Base::_updateSection(const sl_uint8* input)
 	{
-		static sl_uint32 K[64] = {
-			0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
-			0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
-			0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
-			0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
-			0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
-			0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
-			0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
-			0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
-			0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
-			0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
-			0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
-			0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
-			0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
-			0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
-			0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
-			0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
-		};
-
-		sl_uint32 W[64];
-		sl_uint32 v[8];
-		sl_uint32 i;
-		for (i = 0; i < 16; i++) {
-			W[i] = MIO::readUint32BE(input + (i << 2));
-		}
-		for (i = 16; i < 64; i++) {
-			sl_uint32 s0 = Math::rotateRight32(W[i - 15], 7) ^ Math::rotateRight32(W[i - 15], 18) ^ (W[i - 15] >> 3);
-			sl_uint32 s1 = Math::rotateRight32(W[i - 2], 17) ^ Math::rotateRight32(W[i - 2], 19) ^ (W[i - 2] >> 10);
-			W[i] = W[i - 16] + s0 + W[i - 7] + s1;
-		}
-		for (i = 0; i < 8; i++) {
-			v[i] = h[i];
-		}
-		for (i = 0; i < 64; i++) {
-			sl_uint32 S1 = Math::rotateRight32(v[4], 6) ^ Math::rotateRight32(v[4], 11) ^ Math::rotateRight32(v[4], 25);
-			sl_uint32 ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
-			sl_uint32 temp1 = v[7] + S1 + ch + K[i] + W[i];
-			sl_uint32 S0 = Math::rotateRight32(v[0], 2) ^ Math::rotateRight32(v[0], 13) ^ Math::rotateRight32(v[0], 22);
-			sl_uint32 maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
-			sl_uint32 temp2 = S0 + maj;
-			v[7] = v[6];
-			v[6] = v[5];
-			v[5] = v[4];
-			v[4] = v[3] + temp1;
-			v[3] = v[2];
-			v[2] = v[1];
-			v[1] = v[0];
-			v[0] = temp1 + temp2;
-		}
-		for (i = 0; i < 8; i++) {
-			h[i] += v[i];
-		}
+		_priv_SHA256_compress(h, input, 1);
 	}
 
-
 	SHA224::SHA224()
 	{
 	}
@@ -220,6 +433,145 @@ namespace slib
 		}
 	}
 
+	class _priv_SHA256_BatchLane
+	{
+	public:
+		const sl_uint8* data;
+		sl_size nDataBlocks;
+		sl_size nBlocks;
+		sl_uint8 tail[128];
+
+	public:
+		void prepare(const void* input, sl_size size, sl_uint64 sizePrefix)
+		{
+			data = (const sl_uint8*)input;
+			nDataBlocks = size >> 6;
+			sl_uint32 nRemain = (sl_uint32)(size & 63);
+			sl_uint32 sizeTail = nRemain < 56 ? 64 : 128;
+			if (nRemain) {
+				Base::copyMemory(tail, data + (nDataBlocks << 6), nRemain);
+			}
+			tail[nRemain] = 0x80;
+			Base::zeroMemory(tail + nRemain + 1, sizeTail - 9 - nRemain);
+			MIO::writeUint64BE(tail + sizeTail - 8, (sizePrefix + size) << 3);
+			nBlocks = nDataBlocks + (sizeTail >> 6);
+		}
+
+		const sl_uint8* getBlock(sl_size index)
+		{
+			if (index < nDataBlocks) {
+				return data + (index << 6);
+			} else {
+				return tail + ((index - nDataBlocks) << 6);
+			}
+		}
+
+		void hash(const sl_uint32* iv, void* _output)
+		{
+			sl_uint32 h[8];
+			sl_uint32 i;
+			for (i = 0; i < 8; i++) {
+				h[i] = iv[i];
+			}
+			if (nDataBlocks) {
+				_priv_SHA256_compress(h, data, nDataBlocks);
+			}
+			_priv_SHA256_compress(h, tail, nBlocks - nDataBlocks);
+			sl_uint8* output = (sl_uint8*)_output;
+			for (i = 0; i < 8; i++) {
+				MIO::writeUint32BE(output + (i << 2), h[i]);
+			}
+		}
+
+	};
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	SLIB_CPU_TARGET("avx2")
+	static void _priv_SHA256_hashBatch_avx2(const sl_uint32* iv, sl_uint64 sizePrefix, const void* const* inputs, const sl_size* sizes, void* const* outputs, sl_size count)
+	{
+		static const sl_uint8 zeroBlock[64] = {0};
+		_priv_SHA256_BatchLane lanes[8];
+		const sl_uint8* blocks[8];
+		sl_int32 flags[8];
+		sl_uint32 S[8][8];
+		__m256i state[8];
+		sl_uint32 i, j;
+		while (count) {
+			sl_uint32 n = count < 8 ? (sl_uint32)count : 8;
+			sl_size nMaxBlocks = 0;
+			for (j = 0; j < n; j++) {
+				lanes[j].prepare(inputs[j], sizes[j], sizePrefix);
+				if (lanes[j].nBlocks > nMaxBlocks) {
+					nMaxBlocks = lanes[j].nBlocks;
+				}
+			}
+			for (i = 0; i < 8; i++) {
+				state[i] = _mm256_set1_epi32((int)(iv[i]));
+			}
+			for (sl_size k = 0; k < nMaxBlocks; k++) {
+				for (j = 0; j < 8; j++) {
+					if (j < n && k < lanes[j].nBlocks) {
+						blocks[j] = lanes[j].getBlock(k);
+						flags[j] = -1;
+					} else {
+						blocks[j] = zeroBlock;
+						flags[j] = 0;
+					}
+				}
+				_priv_SHA256_compress_avx2x8(state, blocks, _mm256_loadu_si256((const __m256i*)flags));
+			}
+			for (i = 0; i < 8; i++) {
+				_mm256_storeu_si256((__m256i*)(S[i]), state[i]);
+			}
+			for (j = 0; j < n; j++) {
+				sl_uint8* output = (sl_uint8*)(outputs[j]);
+				for (i = 0; i < 8; i++) {
+					MIO::writeUint32BE(output + (i << 2), S[i][j]);
+				}
+			}
+			inputs += n;
+			sizes += n;
+			outputs += n;
+			count -= n;
+		}
+	}
+#endif
+
+	void SHA256::hashBatch(const void* const* inputs, const sl_size* sizes, void* const* outputs, sl_size count, const void* prefix, sl_size sizePrefix)
+	{
+		if (!count) {
+			return;
+		}
+		if (sizePrefix & 63) {
+			SHA256 hash;
+			for (sl_size i = 0; i < count; i++) {
+				hash.start();
+				hash.update(prefix, sizePrefix);
+				hash.update(inputs[i], sizes[i]);
+				hash.finish(outputs[i]);
+			}
+			return;
+		}
+		sl_uint32 iv[8] = {
+			0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul,
+			0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul
+		};
+		if (sizePrefix) {
+			_priv_SHA256_compress(iv, (const sl_uint8*)prefix, sizePrefix >> 6);
+		}
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (count > 1 && !(_priv_SHA256_isSHANI()) && _priv_SHA256_isAVX2()) {
+			_priv_SHA256_hashBatch_avx2(iv, sizePrefix, inputs, sizes, outputs, count);
+			return;
+		}
+#endif
+		_priv_SHA256_BatchLane lane;
+		for (sl_size i = 0; i < count; i++) {
+			lane.prepare(inputs[i], sizes[i], sizePrefix);
+			lane.hash(iv, outputs[i]);
+		}
+	}
+
 
 	_priv_SHA512Base::_priv_SHA512Base()
 	{
@@ -280,7 +632,7 @@ namespace slib
 			return;
 		}
 		rdata[rdata_len] = (sl_uint8)0x80;
-		if (rdata_len < 120) {
+		if (rdata_len < 112) {
 			Base::zeroMemory(rdata + rdata_len + 1, 119 - rdata_len);
 			MIO::writeUint64BE(rdata + 120, sizeTotalInput << 3);
 			_updateSection(rdata);
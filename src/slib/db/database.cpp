@@ -23,20 +23,208 @@
 #include "slib/db/database.h"
 
 #include "slib/core/log.h"
+#include "slib/core/hash_map.h"
+#include "slib/core/thread.h"
+#include "slib/core/linked_list.h"
+#include "slib/network/http_service.h"
 
 namespace slib
 {
 
+	class _priv_DatabaseStatementCacheItem
+	{
+	public:
+		Ref<DatabaseStatement> statement;
+		sl_uint64 lastUsed;
+	};
+
+	class _priv_DatabaseStatementCache : public Referable
+	{
+	public:
+		CHashMap<String, _priv_DatabaseStatementCacheItem> items;
+		sl_uint64 tick;
+
+	public:
+		_priv_DatabaseStatementCache()
+		{
+			tick = 0;
+		}
+
+	public:
+		void evict(sl_uint32 sizeMax)
+		{
+			while (items.getCount() > sizeMax) {
+				String keyOldest;
+				sl_uint64 tickOldest = SLIB_UINT64_MAX;
+				for (auto& item : items) {
+					if (item.value.lastUsed < tickOldest) {
+						tickOldest = item.value.lastUsed;
+						keyOldest = item.key;
+					}
+				}
+				// the statement still used by a cursor is finalized after the cursor is closed
+				items.remove_NoLock(keyOldest);
+			}
+		}
+
+	};
+
+	class _priv_DatabaseExecutor : public Referable
+	{
+	public:
+		Mutex locker;
+		CLinkedList< Function<void()> > tasks;
+		Ref<Thread> thread;
+		sl_bool flagClosed;
+
+		sl_uint32 nQueued;
+		sl_uint32 nQueuedPeak;
+		sl_uint64 nCompleted;
+		sl_uint64 nRejected;
+
+	public:
+		_priv_DatabaseExecutor()
+		{
+			flagClosed = sl_false;
+			nQueued = 0;
+			nQueuedPeak = 0;
+			nCompleted = 0;
+			nRejected = 0;
+		}
+
+	public:
+		sl_bool add(const Function<void()>& task, sl_uint32 limit)
+		{
+			MutexLocker lock(&locker);
+			if (flagClosed) {
+				return sl_false;
+			}
+			if (limit && nQueued >= limit) {
+				nRejected++;
+				return sl_false;
+			}
+			if (!(tasks.pushBack_NoLock(task))) {
+				return sl_false;
+			}
+			if (thread.isNull()) {
+				thread = Thread::start(SLIB_FUNCTION_REF(_priv_DatabaseExecutor, run, this));
+				if (thread.isNull()) {
+					tasks.popBack_NoLock();
+					return sl_false;
+				}
+			} else {
+				thread->wakeSelfEvent();
+			}
+			nQueued++;
+			if (nQueued > nQueuedPeak) {
+				nQueuedPeak = nQueued;
+			}
+			return sl_true;
+		}
+
+		void run()
+		{
+			Ref<Thread> current = Thread::getCurrent();
+			if (current.isNull()) {
+				return;
+			}
+			while (current->isNotStopping()) {
+				Function<void()> task;
+				{
+					MutexLocker lock(&locker);
+					tasks.popFront_NoLock(&task);
+				}
+				if (task.isNotNull()) {
+					task();
+					task.setNull();
+					MutexLocker lock(&locker);
+					nQueued--;
+					nCompleted++;
+				} else {
+					current->wait();
+				}
+			}
+		}
+
+		void close()
+		{
+			Ref<Thread> _thread;
+			{
+				MutexLocker lock(&locker);
+				flagClosed = sl_true;
+				_thread = Move(thread);
+			}
+			if (_thread.isNotNull()) {
+				// the last reference of the database can be released by a task on the executor thread
+				if (_thread->isCurrentThread()) {
+					_thread->finish();
+				} else {
+					_thread->finishAndWait();
+				}
+			}
+		}
+
+	};
+
+	void _priv_Database_runExecute(Database* db, const String& sql, const VariantList& params, DatabaseAsyncResult& result)
+	{
+		result.affectedRowsCount = db->executeBy(sql, params.getData(), (sl_uint32)(params.getCount()));
+		if (result.affectedRowsCount < 0) {
+			result.flagError = sl_true;
+			result.errorMessage = db->getErrorMessage();
+		}
+	}
+
+	void _priv_Database_runQuery(Database* db, const String& sql, const VariantList& params, DatabaseAsyncResult& result)
+	{
+		Ref<DatabaseCursor> cursor = db->queryBy(sql, params.getData(), (sl_uint32)(params.getCount()));
+		if (cursor.isNull()) {
+			result.flagError = sl_true;
+			result.errorMessage = db->getErrorMessage();
+			return;
+		}
+		List< HashMap<String, Variant> > rows;
+		while (cursor->moveNext()) {
+			rows.add_NoLock(cursor->getRow());
+		}
+		result.rows = Move(rows);
+	}
+
+
+	DatabaseAsyncResult::DatabaseAsyncResult()
+	{
+		flagError = sl_false;
+		affectedRowsCount = 0;
+	}
+
+	DatabaseAsyncResult::~DatabaseAsyncResult()
+	{
+	}
+
+
 	SLIB_DEFINE_OBJECT(Database, Object)
 
 	Database::Database()
 	{
 		m_flagLogSQL = sl_false;
 		m_flagLogErrors = sl_true;
+
+		m_sizeStatementCache = SLIB_DATABASE_STATEMENT_CACHE_SIZE_DEFAULT;
+		m_nStatementCacheHits = 0;
+		m_nStatementCacheMisses = 0;
+
+		m_sizeBatch = SLIB_DATABASE_BATCH_SIZE_DEFAULT;
+
+		m_nAsyncQueueLimit = SLIB_DATABASE_ASYNC_QUEUE_LIMIT_DEFAULT;
+		// the thread of the executor is started on the first asynchronous call
+		m_executor = new _priv_DatabaseExecutor;
 	}
 
 	Database::~Database()
 	{
+		if (m_executor.isNotNull()) {
+			m_executor->close();
+		}
 	}
 	
 	sl_int64 Database::_execute(const String& sql)
@@ -51,6 +239,7 @@ namespace slib
 			_logError(sql);
 		} else {
 			_logSQL(sql);
+			_checkSchemaChange(sql);
 		}
 		return ret;
 	}
@@ -73,9 +262,13 @@ namespace slib
 	
 	sl_int64 Database::_executeBy(const String& sql, const Variant* params, sl_uint32 nParams)
 	{
-		Ref<DatabaseStatement> statement = prepareStatement(sql);
+		ObjectLocker lock(this);
+		sl_bool flagCached = sl_false;
+		Ref<DatabaseStatement> statement = _prepareCachedStatement(sql, flagCached);
 		if (statement.isNotNull()) {
-			return statement->executeBy(params, nParams);
+			sl_int64 ret = statement->executeBy(params, nParams);
+			_releaseStatement(statement.get(), flagCached);
+			return ret;
 		}
 		return -1;
 	}
@@ -87,15 +280,20 @@ namespace slib
 			_logError(sql, params, nParams);
 		} else {
 			_logSQL(sql, params, nParams);
+			_checkSchemaChange(sql);
 		}
 		return ret;
 	}
 	
 	Ref<DatabaseCursor> Database::_queryBy(const String& sql, const Variant* params, sl_uint32 nParams)
 	{
-		Ref<DatabaseStatement> statement = prepareStatement(sql);
+		ObjectLocker lock(this);
+		sl_bool flagCached = sl_false;
+		Ref<DatabaseStatement> statement = _prepareCachedStatement(sql, flagCached);
 		if (statement.isNotNull()) {
-			return statement->queryBy(params, nParams);
+			Ref<DatabaseCursor> ret = statement->queryBy(params, nParams);
+			_releaseStatement(statement.get(), flagCached);
+			return ret;
 		}
 		return sl_null;
 	}
@@ -111,6 +309,73 @@ namespace slib
 		return ret;
 	}
 
+	sl_int64 Database::executeManyBy(const String& sql, const Variant* params, sl_uint32 nParamsPerRow, sl_size nRows, List<DatabaseBatchError>* outErrors)
+	{
+		List<DatabaseBatchError> errors;
+		sl_int64 ret = -1;
+		{
+			ObjectLocker lock(this);
+			sl_bool flagCached = sl_false;
+			Ref<DatabaseStatement> statement = _prepareCachedStatement(sql, flagCached);
+			if (statement.isNull()) {
+				_logError(sql);
+				return -1;
+			}
+			ret = statement->executeManyBy(params, nParamsPerRow, nRows, &errors);
+			_releaseStatement(statement.get(), flagCached);
+		}
+		if (errors.isNotEmpty()) {
+			if (m_flagLogErrors) {
+				sl_size nFailed = 0;
+				ListElements<DatabaseBatchError> items(errors);
+				for (sl_size i = 0; i < items.count; i++) {
+					nFailed += items[i].count;
+				}
+				DatabaseBatchError& error = items[0];
+				LogError((char*)(getObjectType()), "Batch Error: %d of %d rows failed, Row %d: %s SQL: %s", nFailed, nRows, error.row, error.message, sql);
+			}
+		} else if (ret >= 0) {
+			if (m_flagLogSQL) {
+				Log((char*)(getObjectType()), "SQL: %s Rows=%d", sql, nRows);
+			}
+		}
+		if (outErrors) {
+			*outErrors = Move(errors);
+		}
+		return ret;
+	}
+
+	sl_int64 Database::executeMany(const String& sql, const List<VariantList>& rows, List<DatabaseBatchError>* outErrors)
+	{
+		sl_uint32 nParamsPerRow = 0;
+		sl_size nRows = 0;
+		Array<Variant> params = DatabaseStatement::_flattenRows(rows, nParamsPerRow, nRows, outErrors);
+		if (params.isNull()) {
+			return nRows ? -1 : 0;
+		}
+		return executeManyBy(sql, params.getData(), nParamsPerRow, nRows, outErrors);
+	}
+
+	sl_uint32 Database::getBatchSize()
+	{
+		return m_sizeBatch;
+	}
+
+	void Database::setBatchSize(sl_uint32 size)
+	{
+		m_sizeBatch = size;
+	}
+
+	sl_bool Database::_beginBatch()
+	{
+		return sl_false;
+	}
+
+	sl_bool Database::_endBatch()
+	{
+		return sl_true;
+	}
+
 	List< HashMap<String, Variant> > Database::getListForQueryResult(const String& sql)
 	{
 		Ref<DatabaseCursor> cursor = query(sql);
@@ -200,6 +465,275 @@ namespace slib
 	{
 		m_flagLogErrors = flag;
 	}
+
+	sl_uint32 Database::getStatementCacheSize()
+	{
+		return m_sizeStatementCache;
+	}
+
+	void Database::setStatementCacheSize(sl_uint32 size)
+	{
+		ObjectLocker lock(this);
+		m_sizeStatementCache = size;
+		if (m_statementCache.isNotNull()) {
+			m_statementCache->evict(size);
+		}
+	}
+
+	void Database::clearStatementCache()
+	{
+		ObjectLocker lock(this);
+		m_statementCache.setNull();
+	}
+
+	sl_uint64 Database::getStatementCacheHitCount()
+	{
+		ObjectLocker lock(this);
+		return m_nStatementCacheHits;
+	}
+
+	sl_uint64 Database::getStatementCacheMissCount()
+	{
+		ObjectLocker lock(this);
+		return m_nStatementCacheMisses;
+	}
+
+	sl_bool Database::dispatchAsync(const Function<void(Database*)>& task)
+	{
+		if (task.isNull()) {
+			return sl_false;
+		}
+		_priv_DatabaseExecutor* executor = m_executor.get();
+		if (!executor) {
+			return sl_false;
+		}
+		// queued tasks keep the database alive
+		Ref<Database> db = this;
+		return executor->add([db, task]() {
+			task(db.get());
+		}, m_nAsyncQueueLimit);
+	}
+
+	sl_bool Database::executeAsyncBy(const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		VariantList list = VariantList::create(params, nParams);
+		return dispatchAsync([sql, list, callback](Database* db) {
+			DatabaseAsyncResult result;
+			_priv_Database_runExecute(db, sql, list, result);
+			callback(result);
+		});
+	}
+
+	sl_bool Database::queryAsyncBy(const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		VariantList list = VariantList::create(params, nParams);
+		return dispatchAsync([sql, list, callback](Database* db) {
+			DatabaseAsyncResult result;
+			_priv_Database_runQuery(db, sql, list, result);
+			callback(result);
+		});
+	}
+
+	sl_bool Database::executeAsync(const String& sql, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		return executeAsyncBy(sql, sl_null, 0, callback);
+	}
+
+	sl_bool Database::queryAsync(const String& sql, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		return queryAsyncBy(sql, sl_null, 0, callback);
+	}
+
+	sl_bool Database::dispatchAsync(const Ref<HttpServiceContext>& context, const Function<void(Database*)>& task)
+	{
+		if (context.isNull() || task.isNull()) {
+			return sl_false;
+		}
+		// set before queuing, because the task can complete the response before the handler returns
+		context->setAsynchronousResponse(sl_true);
+		if (dispatchAsync([context, task](Database* db) {
+			task(db);
+			context->completeResponse();
+		})) {
+			return sl_true;
+		}
+		context->setAsynchronousResponse(sl_false);
+		return sl_false;
+	}
+
+	sl_bool Database::executeAsyncBy(const Ref<HttpServiceContext>& context, const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		VariantList list = VariantList::create(params, nParams);
+		return dispatchAsync(context, [sql, list, callback](Database* db) {
+			DatabaseAsyncResult result;
+			_priv_Database_runExecute(db, sql, list, result);
+			callback(result);
+		});
+	}
+
+	sl_bool Database::queryAsyncBy(const Ref<HttpServiceContext>& context, const String& sql, const Variant* params, sl_uint32 nParams, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		VariantList list = VariantList::create(params, nParams);
+		return dispatchAsync(context, [sql, list, callback](Database* db) {
+			DatabaseAsyncResult result;
+			_priv_Database_runQuery(db, sql, list, result);
+			callback(result);
+		});
+	}
+
+	sl_bool Database::executeAsync(const Ref<HttpServiceContext>& context, const String& sql, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		return executeAsyncBy(context, sql, sl_null, 0, callback);
+	}
+
+	sl_bool Database::queryAsync(const Ref<HttpServiceContext>& context, const String& sql, const Function<void(DatabaseAsyncResult&)>& callback)
+	{
+		return queryAsyncBy(context, sql, sl_null, 0, callback);
+	}
+
+	sl_int64 DatabaseCursor::writeJson(HttpOutputBuffer* output)
+	{
+		if (!output) {
+			return -1;
+		}
+		return _writeJson(sl_null, [output](Memory& chunk) {
+			output->write(chunk);
+		});
+	}
+
+	sl_int64 DatabaseCursor::writeCsv(HttpOutputBuffer* output, sl_bool flagHeader)
+	{
+		if (!output) {
+			return -1;
+		}
+		return _writeCsv(sl_null, [output](Memory& chunk) {
+			output->write(chunk);
+		}, flagHeader);
+	}
+
+	sl_uint32 Database::getAsyncQueueLimit()
+	{
+		return m_nAsyncQueueLimit;
+	}
+
+	void Database::setAsyncQueueLimit(sl_uint32 limit)
+	{
+		m_nAsyncQueueLimit = limit;
+	}
+
+	sl_uint32 Database::getAsyncQueueLength()
+	{
+		_priv_DatabaseExecutor* executor = m_executor.get();
+		if (executor) {
+			MutexLocker lock(&(executor->locker));
+			return executor->nQueued;
+		}
+		return 0;
+	}
+
+	sl_uint32 Database::getAsyncQueuePeakLength()
+	{
+		_priv_DatabaseExecutor* executor = m_executor.get();
+		if (executor) {
+			MutexLocker lock(&(executor->locker));
+			return executor->nQueuedPeak;
+		}
+		return 0;
+	}
+
+	sl_uint64 Database::getAsyncCompletedCount()
+	{
+		_priv_DatabaseExecutor* executor = m_executor.get();
+		if (executor) {
+			MutexLocker lock(&(executor->locker));
+			return executor->nCompleted;
+		}
+		return 0;
+	}
+
+	sl_uint64 Database::getAsyncRejectedCount()
+	{
+		_priv_DatabaseExecutor* executor = m_executor.get();
+		if (executor) {
+			MutexLocker lock(&(executor->locker));
+			return executor->nRejected;
+		}
+		return 0;
+	}
+
+	Ref<DatabaseStatement> Database::_prepareCachedStatement(const String& sql, sl_bool& flagCached)
+	{
+		flagCached = sl_false;
+		if (!m_sizeStatementCache) {
+			return prepareStatement(sql);
+		}
+		ObjectLocker lock(this);
+		_priv_DatabaseStatementCache* cache = m_statementCache.get();
+		if (!cache) {
+			cache = new _priv_DatabaseStatementCache;
+			if (!cache) {
+				return prepareStatement(sql);
+			}
+			m_statementCache = cache;
+		}
+		_priv_DatabaseStatementCacheItem* item = cache->items.getItemPointer(sql);
+		if (item) {
+			DatabaseStatement* statement = item->statement.get();
+			// referenced only by the cache: not used by a cursor
+			if (statement->getReferenceCount() == 1) {
+				m_nStatementCacheHits++;
+				item->lastUsed = ++(cache->tick);
+				statement->m_db = this;
+				flagCached = sl_true;
+				return statement;
+			}
+			m_nStatementCacheMisses++;
+			return prepareStatement(sql);
+		}
+		m_nStatementCacheMisses++;
+		Ref<DatabaseStatement> statement = prepareStatement(sql);
+		if (statement.isNotNull()) {
+			_priv_DatabaseStatementCacheItem newItem;
+			newItem.statement = statement;
+			newItem.lastUsed = ++(cache->tick);
+			if (cache->items.put_NoLock(sql, Move(newItem))) {
+				cache->evict(m_sizeStatementCache);
+				flagCached = sl_true;
+			}
+		}
+		return statement;
+	}
+
+	void Database::_releaseStatement(DatabaseStatement* statement, sl_bool flagCached)
+	{
+		if (flagCached) {
+			// the cached statement doesn't keep the database, to avoid the circular reference
+			ObjectLocker lock(this);
+			statement->m_db.setNull();
+		}
+	}
+
+	void Database::_checkSchemaChange(const String& sql)
+	{
+		if (m_statementCache.isNull()) {
+			return;
+		}
+		sl_char8* s = sql.getData();
+		sl_size len = sql.getLength();
+		sl_size pos = 0;
+		while (pos < len && SLIB_CHAR_IS_WHITE_SPACE(s[pos])) {
+			pos++;
+		}
+		sl_char8 word[8];
+		sl_size n = 0;
+		while (pos < len && n < sizeof(word) && SLIB_CHAR_IS_ALPHA(s[pos])) {
+			word[n++] = SLIB_CHAR_LOWER_TO_UPPER(s[pos]);
+			pos++;
+		}
+		if ((n == 6 && (Base::equalsMemory(word, "CREATE", 6) || Base::equalsMemory(word, "RENAME", 6))) || (n == 5 && Base::equalsMemory(word, "ALTER", 5)) || (n == 4 && Base::equalsMemory(word, "DROP", 4))) {
+			clearStatementCache();
+		}
+	}
 	
 	void Database::_logSQL(const String& sql)
 	{
@@ -22,9 +22,31 @@
 
 #include "slib/db/database.h"
 
+#include "slib/core/io.h"
+#include "slib/core/math.h"
+#include "slib/core/string_buffer.h"
+#include "slib/crypto/base64.h"
+
+#define PRIV_DATABASE_EXPORT_CHUNK_SIZE 0x10000
+
 namespace slib
 {
 
+	_priv_DatabaseColumns::_priv_DatabaseColumns()
+	{
+	}
+
+	_priv_DatabaseColumns::~_priv_DatabaseColumns()
+	{
+	}
+
+	void _priv_DatabaseColumns::add(const String& name)
+	{
+		indexes.put_NoLock(name, (sl_int32)(names.getCount()));
+		names.add_NoLock(name);
+	}
+
+
 	SLIB_DEFINE_OBJECT(DatabaseCursor, Object)
 
 	DatabaseCursor::DatabaseCursor()
@@ -45,6 +67,24 @@ namespace slib
 		return getString(index);
 	}
 
+	DatabaseColumnType DatabaseCursor::getColumnType(sl_uint32 index)
+	{
+		Variant value = getValue(index);
+		if (value.isNull()) {
+			return DatabaseColumnType::Null;
+		}
+		if (value.isInteger() || value.isBoolean()) {
+			return DatabaseColumnType::Integer;
+		}
+		if (value.isFloat() || value.isDouble()) {
+			return DatabaseColumnType::Float;
+		}
+		if (value.isMemory()) {
+			return DatabaseColumnType::Blob;
+		}
+		return DatabaseColumnType::Text;
+	}
+
 	Variant DatabaseCursor::getValue(const String& name)
 	{
 		sl_int32 index = getColumnIndex(name);
@@ -63,6 +103,12 @@ namespace slib
 		return sl_null;
 	}
 
+	StringView DatabaseCursor::getStringView(sl_uint32 index)
+	{
+		m_stringView = getString(index);
+		return m_stringView;
+	}
+
 	sl_int64 DatabaseCursor::getInt64(sl_uint32 index, sl_int64 defaultValue)
 	{
 		return getString(index).parseInt64(10, defaultValue);
@@ -184,4 +230,430 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool DatabaseCursor::isNull(sl_uint32 index)
+	{
+		return getValue(index).isNull();
+	}
+
+	sl_bool DatabaseCursor::isNull(const String& name)
+	{
+		sl_int32 index = getColumnIndex(name);
+		if (index >= 0) {
+			return isNull(index);
+		}
+		return sl_true;
+	}
+
+	class _priv_DatabaseExportWriter
+	{
+	public:
+		IWriter* m_writer;
+		const Function<void(Memory&)>* m_onChunk;
+		Memory m_chunk;
+		sl_char8* m_buf;
+		sl_size m_pos;
+		sl_bool m_flagError;
+
+	public:
+		_priv_DatabaseExportWriter(IWriter* writer, const Function<void(Memory&)>& onChunk)
+		{
+			m_writer = writer;
+			m_onChunk = &onChunk;
+			m_buf = sl_null;
+			m_pos = 0;
+			m_flagError = !writer && onChunk.isNull();
+			_allocateChunk();
+		}
+
+	public:
+		void write(const void* data, sl_size size)
+		{
+			const sl_char8* p = (const sl_char8*)data;
+			while (size && !m_flagError) {
+				sl_size n = PRIV_DATABASE_EXPORT_CHUNK_SIZE - m_pos;
+				if (!n) {
+					flush();
+					continue;
+				}
+				if (n > size) {
+					n = size;
+				}
+				Base::copyMemory(m_buf + m_pos, p, n);
+				m_pos += n;
+				p += n;
+				size -= n;
+			}
+		}
+
+		void write(const String& str)
+		{
+			write(str.getData(), str.getLength());
+		}
+
+		void writeChar(sl_char8 c)
+		{
+			if (m_pos >= PRIV_DATABASE_EXPORT_CHUNK_SIZE) {
+				flush();
+			}
+			if (!m_flagError) {
+				m_buf[m_pos++] = c;
+			}
+		}
+
+		void writeDouble(double value)
+		{
+			if (PRIV_DATABASE_EXPORT_CHUNK_SIZE - m_pos < 64) {
+				flush();
+			}
+			if (!m_flagError) {
+				m_pos += String::fromDouble(value, m_buf + m_pos);
+			}
+		}
+
+		// encoded in the free space of the chunk, 3 bytes to 4 characters
+		void writeBase64(const void* data, sl_size size)
+		{
+			const sl_uint8* p = (const sl_uint8*)data;
+			while (size && !m_flagError) {
+				sl_size n = (PRIV_DATABASE_EXPORT_CHUNK_SIZE - m_pos) / 4 * 3;
+				if (!n) {
+					flush();
+					continue;
+				}
+				if (n > size) {
+					n = size;
+				}
+				m_pos += Base64::encodeTo(p, n, m_buf + m_pos);
+				p += n;
+				size -= n;
+			}
+		}
+
+		void flush()
+		{
+			if (m_flagError || !m_pos) {
+				return;
+			}
+			if (m_writer) {
+				if (m_writer->writeFully(m_buf, m_pos) != (sl_reg)m_pos) {
+					m_flagError = sl_true;
+				}
+				m_pos = 0;
+			} else {
+				// the chunk is handed over without copying, and a new one is used for the next rows
+				Memory chunk = m_chunk.sub(0, m_pos);
+				(*m_onChunk)(chunk);
+				m_pos = 0;
+				_allocateChunk();
+			}
+		}
+
+	private:
+		void _allocateChunk()
+		{
+			if (m_flagError) {
+				return;
+			}
+			m_chunk = Memory::create(PRIV_DATABASE_EXPORT_CHUNK_SIZE);
+			if (m_chunk.isNull()) {
+				m_flagError = sl_true;
+				return;
+			}
+			m_buf = (sl_char8*)(m_chunk.getData());
+		}
+
+	};
+
+	class _priv_DatabaseExportText
+	{
+	public:
+		StringBuffer buf;
+
+	public:
+		void write(const void* data, sl_size size)
+		{
+			buf.add(String((const sl_char8*)data, size));
+		}
+
+		void writeChar(sl_char8 c)
+		{
+			buf.add(String(&c, 1));
+		}
+
+	};
+
+	template <class OUTPUT>
+	static void _priv_DatabaseExport_writeInteger(OUTPUT& out, sl_uint64 value, sl_bool flagNegative)
+	{
+		sl_char8 digits[24];
+		sl_uint32 pos = 24;
+		do {
+			digits[--pos] = (sl_char8)('0' + (value % 10));
+			value /= 10;
+		} while (value);
+		if (flagNegative) {
+			digits[--pos] = '-';
+		}
+		out.write(digits + pos, 24 - pos);
+	}
+
+	template <class OUTPUT>
+	static void _priv_DatabaseExport_writeJsonString(OUTPUT& out, const sl_char8* data, sl_size len)
+	{
+		static const sl_char8* hex = "0123456789abcdef";
+		out.writeChar('"');
+		sl_size start = 0;
+		for (sl_size i = 0; i < len; i++) {
+			sl_uint8 c = (sl_uint8)(data[i]);
+			if (c >= 0x20 && c != '"' && c != '\\') {
+				continue;
+			}
+			if (i > start) {
+				out.write(data + start, i - start);
+			}
+			start = i + 1;
+			sl_char8 e[6] = {'\\', 0, 0, 0, 0, 0};
+			switch (c) {
+				case '"':
+				case '\\':
+					e[1] = (sl_char8)c;
+					break;
+				case '\n':
+					e[1] = 'n';
+					break;
+				case '\r':
+					e[1] = 'r';
+					break;
+				case '\t':
+					e[1] = 't';
+					break;
+				case '\b':
+					e[1] = 'b';
+					break;
+				case '\f':
+					e[1] = 'f';
+					break;
+				default:
+					e[1] = 'u';
+					e[2] = '0';
+					e[3] = '0';
+					e[4] = hex[c >> 4];
+					e[5] = hex[c & 15];
+					out.write(e, 6);
+					continue;
+			}
+			out.write(e, 2);
+		}
+		if (len > start) {
+			out.write(data + start, len - start);
+		}
+		out.writeChar('"');
+	}
+
+	template <class OUTPUT>
+	static void _priv_DatabaseExport_writeCsvField(OUTPUT& out, const sl_char8* data, sl_size len)
+	{
+		sl_bool flagQuote = sl_false;
+		for (sl_size i = 0; i < len; i++) {
+			sl_char8 c = data[i];
+			if (c == ',' || c == '"' || c == '\r' || c == '\n') {
+				flagQuote = sl_true;
+				break;
+			}
+		}
+		if (!flagQuote) {
+			out.write(data, len);
+			return;
+		}
+		out.writeChar('"');
+		sl_size start = 0;
+		for (sl_size i = 0; i < len; i++) {
+			if (data[i] == '"') {
+				// quotes are doubled
+				out.write(data + start, i + 1 - start);
+				start = i;
+			}
+		}
+		out.write(data + start, len - start);
+		out.writeChar('"');
+	}
+
+	static void _priv_DatabaseExport_writeInt64(_priv_DatabaseExportWriter& out, sl_int64 n)
+	{
+		if (n < 0) {
+			_priv_DatabaseExport_writeInteger(out, (sl_uint64)(-(n + 1)) + 1, sl_true);
+		} else {
+			_priv_DatabaseExport_writeInteger(out, (sl_uint64)n, sl_false);
+		}
+	}
+
+	// values are read by the typed getters of the column type, without `Variant` or `String` for numbers
+	static void _priv_DatabaseExport_writeJsonValue(_priv_DatabaseExportWriter& out, DatabaseCursor* cursor, sl_uint32 index)
+	{
+		switch (cursor->getColumnType(index)) {
+			case DatabaseColumnType::Integer:
+				_priv_DatabaseExport_writeInt64(out, cursor->getInt64(index));
+				return;
+			case DatabaseColumnType::Float:
+				{
+					double f = cursor->getDouble(index);
+					if (Math::isNaN(f) || Math::isInfinite(f)) {
+						// NaN and infinity are not valid in JSON
+						out.write("null", 4);
+					} else {
+						out.writeDouble(f);
+					}
+					return;
+				}
+			case DatabaseColumnType::Text:
+				{
+					StringView text = cursor->getStringView(index);
+					_priv_DatabaseExport_writeJsonString(out, text.getData(), text.getLength());
+					return;
+				}
+			case DatabaseColumnType::Blob:
+				{
+					Memory mem = cursor->getBlob(index);
+					out.writeChar('"');
+					out.writeBase64(mem.getData(), mem.getSize());
+					out.writeChar('"');
+					return;
+				}
+			default:
+				out.write("null", 4);
+				return;
+		}
+	}
+
+	static void _priv_DatabaseExport_writeCsvValue(_priv_DatabaseExportWriter& out, DatabaseCursor* cursor, sl_uint32 index)
+	{
+		switch (cursor->getColumnType(index)) {
+			case DatabaseColumnType::Integer:
+				_priv_DatabaseExport_writeInt64(out, cursor->getInt64(index));
+				return;
+			case DatabaseColumnType::Float:
+				out.writeDouble(cursor->getDouble(index));
+				return;
+			case DatabaseColumnType::Text:
+				{
+					StringView text = cursor->getStringView(index);
+					_priv_DatabaseExport_writeCsvField(out, text.getData(), text.getLength());
+					return;
+				}
+			case DatabaseColumnType::Blob:
+				{
+					// Base64 has no characters to be quoted
+					Memory mem = cursor->getBlob(index);
+					out.writeBase64(mem.getData(), mem.getSize());
+					return;
+				}
+			default:
+				return;
+		}
+	}
+
+	static sl_int64 _priv_DatabaseExport_writeJson(DatabaseCursor* cursor, _priv_DatabaseExportWriter& out)
+	{
+		if (out.m_flagError) {
+			return -1;
+		}
+		// `{"name":` for the first column and `,"name":` for the others, escaped once for all rows
+		sl_uint32 nColumns = cursor->getColumnsCount();
+		List<String> listPrefixes;
+		for (sl_uint32 i = 0; i < nColumns; i++) {
+			_priv_DatabaseExportText text;
+			text.writeChar(i ? ',' : '{');
+			String name = cursor->getColumnName(i);
+			_priv_DatabaseExport_writeJsonString(text, name.getData(), name.getLength());
+			text.writeChar(':');
+			listPrefixes.add_NoLock(text.buf.merge());
+		}
+		String* prefixes = listPrefixes.getData();
+		out.writeChar('[');
+		sl_int64 nRows = 0;
+		while (cursor->moveNext()) {
+			if (nRows) {
+				out.writeChar(',');
+			}
+			if (nColumns) {
+				for (sl_uint32 i = 0; i < nColumns; i++) {
+					out.write(prefixes[i]);
+					_priv_DatabaseExport_writeJsonValue(out, cursor, i);
+				}
+			} else {
+				out.writeChar('{');
+			}
+			out.writeChar('}');
+			if (out.m_flagError) {
+				return -1;
+			}
+			nRows++;
+		}
+		out.writeChar(']');
+		out.flush();
+		if (out.m_flagError) {
+			return -1;
+		}
+		return nRows;
+	}
+
+	static sl_int64 _priv_DatabaseExport_writeCsv(DatabaseCursor* cursor, _priv_DatabaseExportWriter& out, sl_bool flagHeader)
+	{
+		if (out.m_flagError) {
+			return -1;
+		}
+		sl_uint32 nColumns = cursor->getColumnsCount();
+		if (flagHeader) {
+			for (sl_uint32 i = 0; i < nColumns; i++) {
+				if (i) {
+					out.writeChar(',');
+				}
+				String name = cursor->getColumnName(i);
+				_priv_DatabaseExport_writeCsvField(out, name.getData(), name.getLength());
+			}
+			out.write("\r\n", 2);
+		}
+		sl_int64 nRows = 0;
+		while (cursor->moveNext()) {
+			for (sl_uint32 i = 0; i < nColumns; i++) {
+				if (i) {
+					out.writeChar(',');
+				}
+				_priv_DatabaseExport_writeCsvValue(out, cursor, i);
+			}
+			out.write("\r\n", 2);
+			if (out.m_flagError) {
+				return -1;
+			}
+			nRows++;
+		}
+		out.flush();
+		if (out.m_flagError) {
+			return -1;
+		}
+		return nRows;
+	}
+
+	sl_int64 DatabaseCursor::writeJson(IWriter* writer)
+	{
+		return _writeJson(writer, sl_null);
+	}
+
+	sl_int64 DatabaseCursor::writeCsv(IWriter* writer, sl_bool flagHeader)
+	{
+		return _writeCsv(writer, sl_null, flagHeader);
+	}
+
+	sl_int64 DatabaseCursor::_writeJson(IWriter* writer, const Function<void(Memory&)>& onChunk)
+	{
+		_priv_DatabaseExportWriter out(writer, onChunk);
+		return _priv_DatabaseExport_writeJson(this, out);
+	}
+
+	sl_int64 DatabaseCursor::_writeCsv(IWriter* writer, const Function<void(Memory&)>& onChunk, sl_bool flagHeader)
+	{
+		_priv_DatabaseExportWriter out(writer, onChunk);
+		return _priv_DatabaseExport_writeCsv(this, out, flagHeader);
+	}
+
 }
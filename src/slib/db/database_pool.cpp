@@ -0,0 +1,317 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/db/database_pool.h"
+
+#include "slib/core/system.h"
+
+namespace slib
+{
+
+	DatabasePoolParam::DatabasePoolParam()
+	{
+		minimumConnectionsCount = 0;
+		maximumConnectionsCount = 10;
+		idleTimeout = 300000;
+		waitTimeout = 30000;
+		validationInterval = 5000;
+		statementCacheSize = SLIB_DATABASE_STATEMENT_CACHE_SIZE_DEFAULT;
+	}
+
+	DatabasePoolParam::~DatabasePoolParam()
+	{
+	}
+
+
+	DatabaseLease::DatabaseLease()
+	{
+	}
+
+	DatabaseLease::DatabaseLease(DatabaseLease&& other)
+	{
+		m_pool = Move(other.m_pool);
+		m_db = Move(other.m_db);
+	}
+
+	DatabaseLease::~DatabaseLease()
+	{
+		release();
+	}
+
+	DatabaseLease& DatabaseLease::operator=(DatabaseLease&& other)
+	{
+		if (this != &other) {
+			release();
+			m_pool = Move(other.m_pool);
+			m_db = Move(other.m_db);
+		}
+		return *this;
+	}
+
+	void DatabaseLease::release()
+	{
+		if (m_pool.isNotNull()) {
+			m_pool->_release(m_db, sl_false);
+			m_pool.setNull();
+		}
+		m_db.setNull();
+	}
+
+	void DatabaseLease::discard()
+	{
+		if (m_pool.isNotNull()) {
+			m_pool->_release(m_db, sl_true);
+			m_pool.setNull();
+		}
+		m_db.setNull();
+	}
+
+
+	SLIB_DEFINE_OBJECT(DatabasePool, Object)
+
+	DatabasePool::DatabasePool()
+	{
+		m_nConnections = 0;
+		m_flagClosed = sl_false;
+	}
+
+	DatabasePool::~DatabasePool()
+	{
+	}
+
+	Ref<DatabasePool> DatabasePool::create(const DatabasePoolParam& param)
+	{
+		if (param.onConnect.isNull()) {
+			return sl_null;
+		}
+		Ref<Event> ev = Event::create();
+		if (ev.isNull()) {
+			return sl_null;
+		}
+		Ref<DatabasePool> ret = new DatabasePool;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			if (!(ret->m_param.maximumConnectionsCount)) {
+				ret->m_param.maximumConnectionsCount = 1;
+			}
+			if (ret->m_param.minimumConnectionsCount > ret->m_param.maximumConnectionsCount) {
+				ret->m_param.minimumConnectionsCount = ret->m_param.maximumConnectionsCount;
+			}
+			ret->m_eventRelease = Move(ev);
+			sl_int64 now = (sl_int64)(System::getTickCount64());
+			for (sl_uint32 i = 0; i < ret->m_param.minimumConnectionsCount; i++) {
+				Ref<Database> db = ret->_connect();
+				if (db.isNull()) {
+					return sl_null;
+				}
+				IdleConnection item;
+				item.db = Move(db);
+				item.timeLastUsed = now;
+				ret->m_listIdle.add_NoLock(Move(item));
+				ret->m_nConnections++;
+			}
+			return ret;
+		}
+		return sl_null;
+	}
+
+	DatabaseLease DatabasePool::acquire()
+	{
+		return acquire(m_param.waitTimeout);
+	}
+
+	DatabaseLease DatabasePool::acquire(sl_int32 timeout)
+	{
+		DatabaseLease lease;
+		sl_int64 timeEnd = 0;
+		if (timeout > 0) {
+			timeEnd = (sl_int64)(System::getTickCount64()) + timeout;
+		}
+		for (;;) {
+			Ref<Database> db;
+			sl_int64 timeLastUsed = 0;
+			sl_bool flagConnect = sl_false;
+			sl_bool flagWakeOther = sl_false;
+			sl_int64 now = (sl_int64)(System::getTickCount64());
+			CList< Ref<Database> > expired;
+			{
+				ObjectLocker lock(this);
+				if (m_flagClosed) {
+					// pass on the wake-up to the other waiters
+					m_eventRelease->set();
+					return lease;
+				}
+				_collectExpired_NoLock(now, expired);
+				IdleConnection item;
+				if (m_listIdle.popBack_NoLock(&item)) {
+					db = Move(item.db);
+					timeLastUsed = item.timeLastUsed;
+				} else if (m_nConnections < m_param.maximumConnectionsCount) {
+					m_nConnections++;
+					flagConnect = sl_true;
+				}
+				// the release event is auto-reset, so pass it on while more connections are available
+				flagWakeOther = m_listIdle.getCount() > 0 || m_nConnections < m_param.maximumConnectionsCount;
+			}
+			expired.removeAll_NoLock();
+			if (db.isNotNull()) {
+				if (flagWakeOther) {
+					m_eventRelease->set();
+				}
+				if (m_param.onValidate.isNotNull() && now - timeLastUsed >= (sl_int64)(m_param.validationInterval)) {
+					if (!(m_param.onValidate(db.get()))) {
+						_release(db, sl_true);
+						continue;
+					}
+				}
+				lease.m_pool = this;
+				lease.m_db = Move(db);
+				return lease;
+			}
+			if (flagConnect) {
+				if (flagWakeOther) {
+					m_eventRelease->set();
+				}
+				db = _connect();
+				if (db.isNull()) {
+					{
+						ObjectLocker lock(this);
+						m_nConnections--;
+					}
+					m_eventRelease->set();
+					return lease;
+				}
+				lease.m_pool = this;
+				lease.m_db = Move(db);
+				return lease;
+			}
+			if (!timeout) {
+				return lease;
+			}
+			if (timeout > 0) {
+				sl_int64 t = timeEnd - (sl_int64)(System::getTickCount64());
+				if (t <= 0) {
+					return lease;
+				}
+				m_eventRelease->wait((sl_int32)t);
+			} else {
+				m_eventRelease->wait();
+			}
+		}
+	}
+
+	sl_uint32 DatabasePool::getConnectionsCount()
+	{
+		return m_nConnections;
+	}
+
+	sl_uint32 DatabasePool::getIdleConnectionsCount()
+	{
+		return (sl_uint32)(m_listIdle.getCount());
+	}
+
+	void DatabasePool::closeExpiredConnections()
+	{
+		CList< Ref<Database> > expired;
+		{
+			ObjectLocker lock(this);
+			_collectExpired_NoLock((sl_int64)(System::getTickCount64()), expired);
+		}
+		// the connections are closed out of the lock
+		expired.removeAll_NoLock();
+	}
+
+	void DatabasePool::close()
+	{
+		CList<IdleConnection> listIdle;
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed) {
+				return;
+			}
+			m_flagClosed = sl_true;
+			m_nConnections -= (sl_uint32)(m_listIdle.getCount());
+			listIdle = Move(m_listIdle);
+		}
+		listIdle.removeAll_NoLock();
+		// wake all waiters
+		m_eventRelease->set();
+	}
+
+	sl_bool DatabasePool::isClosed()
+	{
+		return m_flagClosed;
+	}
+
+	Ref<Database> DatabasePool::_connect()
+	{
+		Ref<Database> db = m_param.onConnect();
+		if (db.isNotNull()) {
+			db->setStatementCacheSize(m_param.statementCacheSize);
+		}
+		return db;
+	}
+
+	void DatabasePool::_release(Ref<Database>& db, sl_bool flagDiscard)
+	{
+		if (db.isNull()) {
+			return;
+		}
+		CList< Ref<Database> > expired;
+		sl_int64 now = (sl_int64)(System::getTickCount64());
+		{
+			ObjectLocker lock(this);
+			if (flagDiscard || m_flagClosed) {
+				m_nConnections--;
+			} else {
+				IdleConnection item;
+				item.db = Move(db);
+				item.timeLastUsed = now;
+				m_listIdle.add_NoLock(Move(item));
+				_collectExpired_NoLock(now, expired);
+			}
+		}
+		// the connection is closed out of the lock
+		db.setNull();
+		expired.removeAll_NoLock();
+		m_eventRelease->set();
+	}
+
+	void DatabasePool::_collectExpired_NoLock(sl_int64 now, CList< Ref<Database> >& expired)
+	{
+		if (!(m_param.idleTimeout)) {
+			return;
+		}
+		// the idle list is used as a stack, so the first item is the least recently used
+		sl_int64 timeLimit = now - m_param.idleTimeout;
+		while (m_nConnections > m_param.minimumConnectionsCount) {
+			IdleConnection* item = m_listIdle.getData();
+			if (!(m_listIdle.getCount()) || item->timeLastUsed > timeLimit) {
+				break;
+			}
+			expired.add_NoLock(Move(item->db));
+			m_listIdle.popFront_NoLock();
+			m_nConnections--;
+		}
+	}
+
+}
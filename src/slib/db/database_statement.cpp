@@ -25,6 +25,17 @@
 namespace slib
 {
 
+	DatabaseBatchError::DatabaseBatchError()
+	{
+		row = 0;
+		count = 1;
+	}
+
+	DatabaseBatchError::~DatabaseBatchError()
+	{
+	}
+
+
 	SLIB_DEFINE_OBJECT(DatabaseStatement, Object)
 
 	DatabaseStatement::DatabaseStatement()
@@ -40,6 +51,114 @@ namespace slib
 		return m_db;
 	}
 
+	String DatabaseStatement::getErrorMessage()
+	{
+		Ref<Database> db = m_db;
+		if (db.isNotNull()) {
+			return db->getErrorMessage();
+		}
+		return sl_null;
+	}
+
+	sl_int64 DatabaseStatement::executeManyBy(const Variant* params, sl_uint32 nParamsPerRow, sl_size nRows, List<DatabaseBatchError>* outErrors)
+	{
+		return _executeManyByRows(params, nParamsPerRow, nRows, 0, outErrors);
+	}
+
+	sl_int64 DatabaseStatement::executeMany(const List<VariantList>& rows, List<DatabaseBatchError>* outErrors)
+	{
+		sl_uint32 nParamsPerRow = 0;
+		sl_size nRows = 0;
+		Array<Variant> params = _flattenRows(rows, nParamsPerRow, nRows, outErrors);
+		if (params.isNull()) {
+			return nRows ? -1 : 0;
+		}
+		return executeManyBy(params.getData(), nParamsPerRow, nRows, outErrors);
+	}
+
+	Array<Variant> DatabaseStatement::_flattenRows(const List<VariantList>& _rows, sl_uint32& nParamsPerRow, sl_size& nRows, List<DatabaseBatchError>* outErrors)
+	{
+		ListLocker<VariantList> rows(_rows);
+		nRows = rows.count;
+		if (!nRows) {
+			return sl_null;
+		}
+		nParamsPerRow = (sl_uint32)(rows[0].getCount());
+		Array<Variant> params = Array<Variant>::create(nRows * nParamsPerRow);
+		if (params.isNull()) {
+			return sl_null;
+		}
+		Variant* p = params.getData();
+		for (sl_size i = 0; i < nRows; i++) {
+			ListLocker<Variant> row(rows[i]);
+			if (row.count != nParamsPerRow) {
+				if (outErrors) {
+					DatabaseBatchError error;
+					error.row = i;
+					error.message = "Params count mismatch";
+					outErrors->add_NoLock(Move(error));
+				}
+				return sl_null;
+			}
+			for (sl_size k = 0; k < row.count; k++) {
+				*(p++) = row[k];
+			}
+		}
+		return params;
+	}
+
+	sl_int64 DatabaseStatement::_executeManyByRows(const Variant* params, sl_uint32 nParamsPerRow, sl_size nRows, sl_size indexRowStart, List<DatabaseBatchError>* outErrors)
+	{
+		Ref<Database> db = m_db;
+		if (db.isNull()) {
+			return -1;
+		}
+		ObjectLocker lock(db.get());
+		sl_size nBatch = db->m_sizeBatch;
+		if (!nBatch) {
+			nBatch = 1;
+		}
+		sl_int64 nTotal = 0;
+		sl_size iRow = 0;
+		while (iRow < nRows) {
+			sl_size n = nRows - iRow;
+			if (n > nBatch) {
+				n = nBatch;
+			}
+			sl_size nErrorsBefore = outErrors ? outErrors->getCount() : 0;
+			sl_bool flagTransaction = db->_beginBatch();
+			sl_int64 nAffected = 0;
+			for (sl_size k = 0; k < n; k++) {
+				sl_int64 ret = executeBy(params + (iRow + k) * nParamsPerRow, nParamsPerRow);
+				if (ret >= 0) {
+					nAffected += ret;
+				} else if (outErrors) {
+					DatabaseBatchError error;
+					error.row = indexRowStart + iRow + k;
+					error.message = getErrorMessage();
+					outErrors->add_NoLock(Move(error));
+				}
+			}
+			if (flagTransaction && !(db->_endBatch())) {
+				// the whole batch is rolled back
+				nAffected = 0;
+				if (outErrors) {
+					String message = db->getErrorMessage();
+					outErrors->setCount_NoLock(nErrorsBefore);
+					for (sl_size k = 0; k < n; k++) {
+						DatabaseBatchError error;
+						error.row = indexRowStart + iRow + k;
+						error.message = message;
+						outErrors->add_NoLock(Move(error));
+					}
+				}
+			}
+			nTotal += nAffected;
+			iRow += n;
+		}
+		return nTotal;
+	}
+
 	List< HashMap<String, Variant> > DatabaseStatement::getListForQueryResultBy(const Variant* params, sl_uint32 nParams)
 	{
 		List< HashMap<String, Variant> > ret;
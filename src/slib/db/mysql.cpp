@@ -26,11 +26,13 @@
 
 #include "libmariadb/mysql.h"
 #include "libmariadb/errmsg.h"
+#include "libmariadb/mysqld_error.h"
 
 #include "slib/core/thread.h"
 #include "slib/core/scoped.h"
 #include "slib/core/log.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/string_buffer.h"
 
 #define TAG "MySQL_Database"
 
@@ -122,6 +124,7 @@ namespace slib
 
 		~_priv_MySQL_Database()
 		{
+			clearStatementCache();
 			::mysql_close(m_mysql);
 		}
 
@@ -200,24 +203,18 @@ namespace slib
 			MYSQL_ROW m_row;
 			unsigned long* m_lengths;
 
-			CList<String> m_listColumnNames;
 			sl_uint32 m_nColumnNames;
 			String* m_columnNames;
-			CHashMap<String, sl_int32> m_mapColumnIndexes;
 
-			_priv_DatabaseCursor(MySQL_Database* db, MYSQL_RES* result)
+			_priv_DatabaseCursor(MySQL_Database* db, MYSQL_RES* result, _priv_DatabaseColumns* columns)
 			{
 				m_db = db;
 				m_result = result;
 
-				sl_uint32 cols = (sl_uint32)(::mysql_num_fields(result));
 				m_fields = ::mysql_fetch_fields(result);
-				for (sl_uint32 i = 0; i < cols; i++) {
-					m_listColumnNames.add_NoLock(m_fields[i].name);
-					m_mapColumnIndexes.put_NoLock(m_fields[i].name, i);
-				}
-				m_nColumnNames = (sl_uint32)(m_listColumnNames.getCount());
-				m_columnNames = m_listColumnNames.getData();
+				m_columns = columns;
+				m_nColumnNames = columns->getCount();
+				m_columnNames = columns->getNames();
 
 				m_row = sl_null;
 				m_lengths = sl_null;
@@ -246,7 +243,7 @@ namespace slib
 
 			sl_int32 getColumnIndex(const String& name) override
 			{
-				return m_mapColumnIndexes.getValue_NoLock(name, -1);
+				return m_columns->getIndex(name);
 			}
 
 			HashMap<String, Variant> getRow() override
@@ -301,6 +298,16 @@ namespace slib
 				return sl_null;
 			}
 
+			sl_bool isNull(sl_uint32 index) override
+			{
+				if (m_row) {
+					if (index < m_nColumnNames) {
+						return !(m_row[index]);
+					}
+				}
+				return sl_true;
+			}
+
 			sl_bool moveNext() override
 			{
 				m_row = ::mysql_fetch_row(m_result);
@@ -312,6 +319,52 @@ namespace slib
 			}
 		};
 
+		sl_bool _beginBatch() override
+		{
+			ObjectLocker lock(this);
+			if (!(m_mysql->server_status & SERVER_STATUS_IN_TRANS)) {
+				return 0 == ::mysql_query(m_mysql, "START TRANSACTION");
+			}
+			return sl_false;
+		}
+
+		sl_bool _endBatch() override
+		{
+			ObjectLocker lock(this);
+			if (0 == ::mysql_query(m_mysql, "COMMIT")) {
+				return sl_true;
+			}
+			::mysql_query(m_mysql, "ROLLBACK");
+			return sl_false;
+		}
+
+		// rolls back the transaction begun by `_beginBatch()`. returns `sl_true` only when all the changes are discarded: the transaction is still active, and no non-transactional table is changed
+		sl_bool _rollbackBatch()
+		{
+			ObjectLocker lock(this);
+			if (!(m_mysql->server_status & SERVER_STATUS_IN_TRANS)) {
+				::mysql_query(m_mysql, "ROLLBACK");
+				return sl_false;
+			}
+			if (0 == ::mysql_query(m_mysql, "ROLLBACK")) {
+				return !(::mysql_warning_count(m_mysql));
+			}
+			return sl_false;
+		}
+
+		static Ref<_priv_DatabaseColumns> _createColumns(MYSQL_RES* result)
+		{
+			Ref<_priv_DatabaseColumns> columns = new _priv_DatabaseColumns;
+			if (columns.isNotNull()) {
+				sl_uint32 cols = (sl_uint32)(::mysql_num_fields(result));
+				MYSQL_FIELD* fields = ::mysql_fetch_fields(result);
+				for (sl_uint32 i = 0; i < cols; i++) {
+					columns->add(fields[i].name);
+				}
+			}
+			return columns;
+		}
+
 		Ref<DatabaseCursor> _query(const String& sql) override
 		{
 			initThread();
@@ -319,9 +372,12 @@ namespace slib
 			if (0 == mysql_real_query(m_mysql, sql.getData(), (sl_uint32)(sql.getLength()))) {
 				MYSQL_RES* res = ::mysql_use_result(m_mysql);
 				if (res) {
-					Ref<DatabaseCursor> ret = new _priv_DatabaseCursor(this, res);
-					if (ret.isNotNull()) {
-						return ret;
+					Ref<_priv_DatabaseColumns> columns = _createColumns(res);
+					if (columns.isNotNull()) {
+						Ref<DatabaseCursor> ret = new _priv_DatabaseCursor(this, res, columns.get());
+						if (ret.isNotNull()) {
+							return ret;
+						}
 					}
 					::mysql_free_result(res);
 				}
@@ -330,6 +386,7 @@ namespace slib
 		}
 
 #define PRIV_FIELD_DESC_BUFFER_SIZE 64
+#define PRIV_MYSQL_STATEMENT_PARAMS_MAX 65535
 		struct _priv_FieldDesc
 		{
 			my_bool isNull;
@@ -386,29 +443,23 @@ namespace slib
 			MYSQL_BIND* m_bind;
 			_priv_FieldDesc* m_fds;
 
-			CList<String> m_listColumnNames;
 			sl_uint32 m_nColumnNames;
 			String* m_columnNames;
-			CHashMap<String, sl_int32> m_mapColumnIndexes;
 
-			_priv_DatabaseStatementCursor(Database* db, DatabaseStatement* statementObj, MYSQL_STMT* statement, MYSQL_RES* resultMetadata, MYSQL_BIND* bind, _priv_FieldDesc* fds)
+			_priv_DatabaseStatementCursor(Database* db, DatabaseStatement* statementObj, MYSQL_STMT* statement, MYSQL_RES* resultMetadata, MYSQL_BIND* bind, _priv_FieldDesc* fds, _priv_DatabaseColumns* columns)
 			{
 				m_db = db;
 				m_statementObj = statementObj;
 				m_statement = statement;
 
 				m_resultMetadata = resultMetadata;
-				sl_uint32 cols = (sl_uint32)(::mysql_num_fields(resultMetadata));
 				m_fields = ::mysql_fetch_fields(resultMetadata);
 				m_bind = bind;
 				m_fds = fds;
 
-				for (sl_uint32 i = 0; i < cols; i++) {
-					m_listColumnNames.add_NoLock(m_fields[i].name);
-					m_mapColumnIndexes.put_NoLock(m_fields[i].name, i);
-				}
-				m_nColumnNames = (sl_uint32)(m_listColumnNames.getCount());
-				m_columnNames = m_listColumnNames.getData();
+				m_columns = columns;
+				m_nColumnNames = columns->getCount();
+				m_columnNames = columns->getNames();
 
 				db->lock();
 			}
@@ -437,7 +488,7 @@ namespace slib
 
 			sl_int32 getColumnIndex(const String& name) override
 			{
-				return m_mapColumnIndexes.getValue_NoLock(name, -1);
+				return m_columns->getIndex(name);
 			}
 
 			HashMap<String, Variant> getRow() override
@@ -862,6 +913,14 @@ namespace slib
 				return sl_null;
 			}
 
+			sl_bool isNull(sl_uint32 index) override
+			{
+				if (index < m_nColumnNames) {
+					return m_fds[index].isNull != 0;
+				}
+				return sl_true;
+			}
+
 			sl_bool moveNext() override
 			{
 				int iRet = ::mysql_stmt_fetch(m_statement);
@@ -879,6 +938,8 @@ namespace slib
 			String m_sql;
 			MYSQL* m_mysql;
 			MYSQL_STMT* m_statement;
+			// column names are resolved once per prepared statement
+			Ref<_priv_DatabaseColumns> m_columns;
 
 		public:
 			_priv_DatabaseStatement(_priv_MySQL_Database* db, const String& sql)
@@ -927,6 +988,7 @@ namespace slib
 					::mysql_stmt_close(m_statement);
 					m_statement = sl_null;
 				}
+				m_columns.setNull();
 			}
 
 			sl_bool _bind(const Variant* params, sl_uint32 nParams)
@@ -1032,6 +1094,17 @@ namespace slib
 				return sl_false;
 			}
 
+			String getErrorMessage() override
+			{
+				if (m_statement) {
+					String error = ::mysql_stmt_error(m_statement);
+					if (error.isNotEmpty()) {
+						return error;
+					}
+				}
+				return DatabaseStatement::getErrorMessage();
+			}
+
 			sl_bool _execute(const Variant* params, sl_uint32 nParams)
 			{
 				if (!m_statement) {
@@ -1044,7 +1117,8 @@ namespace slib
 						return sl_true;
 					} else {
 						int err = ::mysql_stmt_errno(m_statement);
-						if (err == CR_SERVER_LOST || err == CR_SERVER_GONE_ERROR) {
+						// cached statements are invalidated by reconnection
+						if (err == CR_SERVER_LOST || err == CR_SERVER_GONE_ERROR || err == ER_UNKNOWN_STMT_HANDLER || err == ER_NEED_REPREPARE) {
 							if (prepare()) {
 								if (_bind(params, nParams)) {
 									if (0 == ::mysql_stmt_execute(m_statement)) {
@@ -1076,6 +1150,185 @@ namespace slib
 				return -1;
 			}
 
+			sl_int64 executeManyBy(const Variant* params, sl_uint32 nParamsPerRow, sl_size nRows, List<DatabaseBatchError>* outErrors) override
+			{
+				Ref<Database> db = m_db;
+				if (db.isNull()) {
+					return -1;
+				}
+				sl_size nBatch = db->getBatchSize();
+				if (nParamsPerRow && nBatch > PRIV_MYSQL_STATEMENT_PARAMS_MAX / nParamsPerRow) {
+					nBatch = PRIV_MYSQL_STATEMENT_PARAMS_MAX / nParamsPerRow;
+				}
+				sl_size posValues, posValuesEnd;
+				if (nRows < 2 || nBatch < 2 || !nParamsPerRow || !(_findValuesClause(m_sql, nParamsPerRow, posValues, posValuesEnd))) {
+					return DatabaseStatement::executeManyBy(params, nParamsPerRow, nRows, outErrors);
+				}
+				initThread();
+				ObjectLocker lock(db.get());
+				_priv_MySQL_Database* database = (_priv_MySQL_Database*)(db.get());
+				Ref<DatabaseStatement> statementBatch;
+				sl_size nRowsStatementBatch = 0;
+				sl_int64 nTotal = 0;
+				sl_size iRow = 0;
+				while (iRow < nRows) {
+					sl_size n = nRows - iRow;
+					if (n > nBatch) {
+						n = nBatch;
+					}
+					const Variant* paramsBatch = params + iRow * nParamsPerRow;
+					sl_int64 ret = -1;
+					sl_bool flagTransaction = sl_false;
+					String messageBatch;
+					if (n > 1) {
+						if (nRowsStatementBatch != n) {
+							statementBatch = db->prepareStatement(_expandValuesClause(m_sql, posValues, posValuesEnd, n));
+							nRowsStatementBatch = n;
+						}
+						if (statementBatch.isNotNull()) {
+							flagTransaction = database->_beginBatch();
+							ret = statementBatch->executeBy(paramsBatch, (sl_uint32)(n * nParamsPerRow));
+							if (ret < 0) {
+								messageBatch = statementBatch->getErrorMessage();
+							} else if (flagTransaction && !(database->_endBatch())) {
+								// rolled back by `_endBatch()`, but not confirmed
+								messageBatch = db->getErrorMessage();
+								flagTransaction = sl_false;
+								ret = -1;
+							}
+						}
+					}
+					if (ret >= 0) {
+						nTotal += ret;
+					} else if (n < 2 || statementBatch.isNull() || (flagTransaction && database->_rollbackBatch())) {
+						// none of the rows is applied, so the rows are retried one by one to find the failed rows
+						nTotal += _executeManyByRows(paramsBatch, nParamsPerRow, n, iRow, outErrors);
+					} else {
+						// some rows may be applied: on non-transactional tables, in the transaction of the caller, or after the connection is lost
+						if (outErrors) {
+							DatabaseBatchError error;
+							error.row = iRow;
+							error.count = n;
+							error.message = messageBatch;
+							outErrors->add_NoLock(Move(error));
+						}
+					}
+					iRow += n;
+				}
+				return nTotal;
+			}
+
+			// finds `(?, ...)` of `INSERT/REPLACE ... VALUES (?, ...)` having all the params of the statement
+			static sl_bool _findValuesClause(const String& sql, sl_uint32 nParams, sl_size& outStart, sl_size& outEnd)
+			{
+				const sl_char8* s = sql.getData();
+				sl_size len = sql.getLength();
+				sl_size pos = 0;
+				while (pos < len && SLIB_CHAR_IS_WHITE_SPACE(s[pos])) {
+					pos++;
+				}
+				if (!(_matchKeyword(s, len, pos, "INSERT") || _matchKeyword(s, len, pos, "REPLACE"))) {
+					return sl_false;
+				}
+				sl_size start = 0;
+				sl_size end = 0;
+				sl_uint32 nParamsInClause = 0;
+				sl_uint32 nParamsTotal = 0;
+				sl_uint32 depth = 0;
+				sl_char8 quote = 0;
+				for (; pos < len; pos++) {
+					sl_char8 ch = s[pos];
+					if (quote) {
+						if (ch == '\\') {
+							pos++;
+						} else if (ch == quote) {
+							quote = 0;
+						}
+						continue;
+					}
+					if (ch == '\'' || ch == '"' || ch == '`') {
+						quote = ch;
+					} else if (ch == '?') {
+						nParamsTotal++;
+						if (start && !end) {
+							nParamsInClause++;
+						}
+					} else if (ch == '(') {
+						if (!depth && !start && _isValuesKeywordBefore(s, pos)) {
+							start = pos;
+						}
+						depth++;
+					} else if (ch == ')') {
+						if (!depth) {
+							return sl_false;
+						}
+						depth--;
+						if (!depth && start && !end) {
+							end = pos + 1;
+							sl_size next = end;
+							while (next < len && SLIB_CHAR_IS_WHITE_SPACE(s[next])) {
+								next++;
+							}
+							if (next < len && s[next] == ',') {
+								// already multi-row
+								return sl_false;
+							}
+						}
+					}
+				}
+				if (!end || quote || depth) {
+					return sl_false;
+				}
+				if (nParamsInClause != nParams || nParamsTotal != nParams) {
+					return sl_false;
+				}
+				outStart = start;
+				outEnd = end;
+				return sl_true;
+			}
+
+			static sl_bool _matchKeyword(const sl_char8* s, sl_size len, sl_size pos, const char* keyword)
+			{
+				sl_size n = Base::getStringLength(keyword);
+				if (pos + n > len) {
+					return sl_false;
+				}
+				for (sl_size i = 0; i < n; i++) {
+					if (SLIB_CHAR_LOWER_TO_UPPER(s[pos + i]) != keyword[i]) {
+						return sl_false;
+					}
+				}
+				return pos + n == len || !(SLIB_CHAR_IS_ALNUM(s[pos + n]) || s[pos + n] == '_');
+			}
+
+			static sl_bool _isValuesKeywordBefore(const sl_char8* s, sl_size pos)
+			{
+				while (pos > 0 && SLIB_CHAR_IS_WHITE_SPACE(s[pos - 1])) {
+					pos--;
+				}
+				for (sl_size n = 5; n <= 6; n++) {
+					if (pos >= n && (pos == n || !(SLIB_CHAR_IS_ALNUM(s[pos - n - 1]) || s[pos - n - 1] == '_'))) {
+						if (_matchKeyword(s, pos, pos - n, n == 6 ? "VALUES" : "VALUE")) {
+							return sl_true;
+						}
+					}
+				}
+				return sl_false;
+			}
+
+			static String _expandValuesClause(const String& sql, sl_size start, sl_size end, sl_size nRows)
+			{
+				StringBuffer buf;
+				buf.add(sql.substring(0, end));
+				String clause = sql.substring(start, end);
+				for (sl_size i = 1; i < nRows; i++) {
+					buf.addStatic(",", 1);
+					buf.add(clause);
+				}
+				buf.add(sql.substring(end));
+				return buf.merge();
+			}
+
 			Ref<DatabaseCursor> queryBy(const Variant* params, sl_uint32 nParams) override
 			{
 				initThread();
@@ -1158,8 +1411,11 @@ namespace slib
 										break;
 									}
 								}
-								if (0 == ::mysql_stmt_bind_result(m_statement, bind)) {
-									ret = new _priv_DatabaseStatementCursor(m_db.get(), this, m_statement, resultMetadata, bind, fds);
+								if (m_columns.isNull() || m_columns->getCount() != nFields) {
+									m_columns = _createColumns(resultMetadata);
+								}
+								if (m_columns.isNotNull() && 0 == ::mysql_stmt_bind_result(m_statement, bind)) {
+									ret = new _priv_DatabaseStatementCursor(m_db.get(), this, m_statement, resultMetadata, bind, fds, m_columns.get());
 									if (ret.isNotNull()) {
 										return ret;
 									}
@@ -1210,6 +1466,21 @@ namespace slib
 		return connect(param, err);
 	}
 
+	Ref<DatabasePool> MySQL_Database::createPool(const MySQL_Param& _param, const DatabasePoolParam& _poolParam)
+	{
+		MySQL_Param param = _param;
+		DatabasePoolParam poolParam = _poolParam;
+		poolParam.onConnect = [param]() -> Ref<Database> {
+			return MySQL_Database::connect(param);
+		};
+		if (poolParam.onValidate.isNull()) {
+			poolParam.onValidate = [](Database* db) {
+				return ((MySQL_Database*)db)->ping();
+			};
+		}
+		return DatabasePool::create(poolParam);
+	}
+
 }
 
 #endif
@@ -0,0 +1,961 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/db/redis_client.h"
+
+#include "slib/network/os.h"
+#include "slib/core/log.h"
+#include "slib/core/safe_static.h"
+
+#include <math.h>
+
+#define TAG "AsyncRedisClient"
+
+#define PRIV_REDIS_READ_SIZE 0x10000
+#define PRIV_REDIS_NESTING_MAX 64
+// same as the default `proto-max-bulk-len` of the server
+#define PRIV_REDIS_BULK_SIZE_MAX 0x20000000
+// sizes of the writes are passed to the socket in 32 bits
+#define PRIV_REDIS_WRITE_SIZE_MAX 0x7fffffff
+
+namespace slib
+{
+
+	RedisReply::RedisReply()
+	{
+		type = RedisReplyType::Null;
+		integer = 0;
+		number = 0;
+	}
+
+	RedisReply::RedisReply(const RedisReply& other) = default;
+
+	RedisReply::RedisReply(RedisReply&& other) = default;
+
+	RedisReply::~RedisReply()
+	{
+	}
+
+	RedisReply& RedisReply::operator=(const RedisReply& other) = default;
+
+	RedisReply& RedisReply::operator=(RedisReply&& other) = default;
+
+	RedisReply RedisReply::error(const String& message)
+	{
+		RedisReply ret;
+		ret.type = RedisReplyType::Error;
+		ret.string = message;
+		return ret;
+	}
+
+	sl_bool RedisReply::isNull() const
+	{
+		return type == RedisReplyType::Null;
+	}
+
+	sl_bool RedisReply::isError() const
+	{
+		return type == RedisReplyType::Error;
+	}
+
+	String RedisReply::getString() const
+	{
+		switch (type) {
+			case RedisReplyType::Integer:
+				return String::fromInt64(integer);
+			case RedisReplyType::Double:
+				return String::fromDouble(number);
+			case RedisReplyType::Boolean:
+				return integer ? "true" : "false";
+			default:
+				return string;
+		}
+	}
+
+	sl_int64 RedisReply::getInteger(sl_int64 def) const
+	{
+		switch (type) {
+			case RedisReplyType::Integer:
+			case RedisReplyType::Boolean:
+				return integer;
+			case RedisReplyType::Double:
+				return (sl_int64)number;
+			case RedisReplyType::String:
+			case RedisReplyType::Status:
+			case RedisReplyType::BigNumber:
+				return string.parseInt64(10, def);
+			default:
+				return def;
+		}
+	}
+
+	Variant RedisReply::toVariant() const
+	{
+		switch (type) {
+			case RedisReplyType::Null:
+				return sl_null;
+			case RedisReplyType::Integer:
+				return integer;
+			case RedisReplyType::Double:
+				return number;
+			case RedisReplyType::Boolean:
+				return integer != 0;
+			case RedisReplyType::Array:
+			case RedisReplyType::Set:
+			case RedisReplyType::Push:
+				{
+					VariantList list;
+					ListElements<RedisReply> items(elements);
+					for (sl_size i = 0; i < items.count; i++) {
+						list.add_NoLock(items[i].toVariant());
+					}
+					return list;
+				}
+			case RedisReplyType::Map:
+				{
+					VariantMap map;
+					ListElements<RedisReply> items(elements);
+					for (sl_size i = 0; i + 1 < items.count; i += 2) {
+						map.add_NoLock(items[i].getString(), items[i + 1].toVariant());
+					}
+					return map;
+				}
+			default:
+				return string;
+		}
+	}
+
+
+	/*
+		Incremental parser: the elements of the incomplete aggregates are kept in the stack,
+		so the bytes of the completed items are consumed and are not parsed again when more data is received
+	*/
+	class _priv_RedisParser : public Referable
+	{
+	public:
+		struct Frame
+		{
+			sl_char8 type;
+			sl_uint64 count;
+			sl_uint64 index;
+			List<RedisReply> elements;
+		};
+		CList<Frame> stack;
+
+	public:
+		// parses from `pos`, and moves `pos` after the consumed items. returns 1 when `reply` is parsed, 0 when more data is needed, -1 on protocol error
+		sl_int32 parse(const sl_char8* data, sl_size size, sl_size& pos, RedisReply& reply)
+		{
+			for (;;) {
+				RedisReply value;
+				sl_int32 iRet = parseItem(data, size, pos, value);
+				if (iRet <= 0) {
+					return iRet;
+				}
+				if (iRet > 1) {
+					// header of an aggregate
+					continue;
+				}
+				for (;;) {
+					sl_size nFrames = stack.getCount();
+					if (!nFrames) {
+						reply = Move(value);
+						return 1;
+					}
+					Frame& frame = (stack.getData())[nFrames - 1];
+					if (frame.type != '|') {
+						if (!(frame.elements.add_NoLock(Move(value)))) {
+							return -1;
+						}
+					}
+					frame.index++;
+					if (frame.index < frame.count) {
+						break;
+					}
+					sl_char8 type = frame.type;
+					List<RedisReply> elements = Move(frame.elements);
+					stack.popBack_NoLock();
+					if (type == '|') {
+						// attributes are skipped, and the next item is the value
+						break;
+					}
+					value = RedisReply();
+					value.type = getAggregateType(type);
+					value.elements = Move(elements);
+				}
+			}
+		}
+
+		// returns 1 when `value` is parsed, 2 when the header of an aggregate is parsed, 0 when more data is needed, -1 on protocol error
+		sl_int32 parseItem(const sl_char8* data, sl_size size, sl_size& pos, RedisReply& value)
+		{
+			if (pos >= size) {
+				return 0;
+			}
+			sl_char8 type = data[pos];
+			sl_size start = pos + 1;
+			sl_size end = start;
+			for (;;) {
+				if (end + 1 >= size) {
+					return 0;
+				}
+				if (data[end] == '\r' && data[end + 1] == '\n') {
+					break;
+				}
+				end++;
+			}
+			sl_size next = end + 2;
+			switch (type) {
+				case '+':
+					value.type = RedisReplyType::Status;
+					value.string = String(data + start, end - start);
+					break;
+				case '-':
+					value.type = RedisReplyType::Error;
+					value.string = String(data + start, end - start);
+					break;
+				case ':':
+					value.type = RedisReplyType::Integer;
+					if (!(parseInteger(data, start, end, value.integer))) {
+						return -1;
+					}
+					break;
+				case '(':
+					value.type = RedisReplyType::BigNumber;
+					value.string = String(data + start, end - start);
+					break;
+				case '_':
+					value.type = RedisReplyType::Null;
+					break;
+				case '#':
+					value.type = RedisReplyType::Boolean;
+					value.integer = (end > start && data[start] == 't') ? 1 : 0;
+					break;
+				case ',':
+					{
+						value.type = RedisReplyType::Double;
+						String s(data + start, end - start);
+						if (s == "inf") {
+							value.number = HUGE_VAL;
+						} else if (s == "-inf") {
+							value.number = -HUGE_VAL;
+						} else if (!(s.parseDouble(&(value.number)))) {
+							value.number = 0;
+						}
+						break;
+					}
+				case '$':
+				case '!':
+				case '=':
+					{
+						sl_int64 len;
+						if (!(parseInteger(data, start, end, len))) {
+							return -1;
+						}
+						if (len < 0) {
+							value.type = RedisReplyType::Null;
+							break;
+						}
+						if (len > PRIV_REDIS_BULK_SIZE_MAX) {
+							return -1;
+						}
+						if (size - next < (sl_size)len + 2) {
+							return 0;
+						}
+						const sl_char8* content = data + next;
+						if (content[len] != '\r' || content[len + 1] != '\n') {
+							return -1;
+						}
+						sl_size offset = 0;
+						if (type == '=' && len >= 4) {
+							// skip the format of the verbatim string, for example "txt:"
+							offset = 4;
+						}
+						value.type = type == '!' ? RedisReplyType::Error : RedisReplyType::String;
+						value.string = String(content + offset, (sl_size)len - offset);
+						next += (sl_size)len + 2;
+						break;
+					}
+				case '*':
+				case '~':
+				case '>':
+				case '%':
+				case '|':
+					{
+						sl_int64 n;
+						if (!(parseInteger(data, start, end, n))) {
+							return -1;
+						}
+						if (n < 0) {
+							value.type = RedisReplyType::Null;
+							break;
+						}
+						if (n > PRIV_REDIS_BULK_SIZE_MAX) {
+							return -1;
+						}
+						if (type == '%' || type == '|') {
+							n *= 2;
+						}
+						pos = next;
+						if (!n) {
+							if (type == '|') {
+								return 2;
+							}
+							value.type = getAggregateType(type);
+							return 1;
+						}
+						if (stack.getCount() >= PRIV_REDIS_NESTING_MAX) {
+							return -1;
+						}
+						Frame frame;
+						frame.type = type;
+						frame.count = (sl_uint64)n;
+						frame.index = 0;
+						if (!(stack.add_NoLock(Move(frame)))) {
+							return -1;
+						}
+						return 2;
+					}
+				default:
+					return -1;
+			}
+			pos = next;
+			return 1;
+		}
+
+		static RedisReplyType getAggregateType(sl_char8 type)
+		{
+			switch (type) {
+				case '~':
+					return RedisReplyType::Set;
+				case '>':
+					return RedisReplyType::Push;
+				case '%':
+					return RedisReplyType::Map;
+				default:
+					return RedisReplyType::Array;
+			}
+		}
+
+		static sl_bool parseInteger(const sl_char8* data, sl_size start, sl_size end, sl_int64& value)
+		{
+			return start < end && String::parseInt64(10, &value, data, start, end) == (sl_reg)end;
+		}
+
+	};
+
+
+	AsyncRedisClientParam::AsyncRedisClientParam()
+	{
+		host = "127.0.0.1";
+		port = 6379;
+		databaseIndex = 0;
+		flagResp3 = sl_false;
+		flagLogError = sl_true;
+	}
+
+	AsyncRedisClientParam::~AsyncRedisClientParam()
+	{
+	}
+
+
+	SLIB_DEFINE_OBJECT(AsyncRedisClient, Object)
+
+	AsyncRedisClient::AsyncRedisClient()
+	{
+		m_flagConnected = sl_false;
+		m_flagClosed = sl_false;
+		m_nSubscriptions = 0;
+		m_sizeWrite = 0;
+		m_flagSending = sl_false;
+		m_sizeRead = 0;
+		m_posRead = 0;
+	}
+
+	AsyncRedisClient::~AsyncRedisClient()
+	{
+		close();
+	}
+
+	Ref<AsyncRedisClient> AsyncRedisClient::create(const AsyncRedisClientParam& param)
+	{
+		IPAddress ip;
+		if (!(ip.parse(param.host))) {
+			ip = Network::getIPAddressFromHostName(param.host);
+			if (ip.isNone()) {
+				if (param.flagLogError) {
+					LogError(TAG, "Failed to resolve host: %s", param.host);
+				}
+				return sl_null;
+			}
+		}
+		Ref<AsyncRedisClient> ret = new AsyncRedisClient;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->m_param = param;
+		ret->m_parser = new _priv_RedisParser;
+		if (ret->m_parser.isNull()) {
+			return sl_null;
+		}
+		if (ret->m_param.ioLoop.isNull()) {
+			ret->m_param.ioLoop = AsyncIoLoop::getDefault();
+		}
+		ret->m_callbackSend = SLIB_FUNCTION_WEAKREF(AsyncRedisClient, _onSend, ret);
+		ret->m_callbackReceive = SLIB_FUNCTION_WEAKREF(AsyncRedisClient, _onReceive, ret);
+
+		// handshake commands are written first, and sent on connection
+		WeakRef<AsyncRedisClient> weak = ret;
+		Function<void(RedisReply&)> onHandshake = [weak](RedisReply& reply) {
+			if (reply.isError()) {
+				Ref<AsyncRedisClient> client = weak;
+				if (client.isNotNull() && client->m_param.flagLogError) {
+					LogError(TAG, "Handshake error: %s", reply.string);
+				}
+			}
+		};
+		if (param.flagResp3) {
+			if (param.password.isNotEmpty()) {
+				String user = param.user.isNotEmpty() ? param.user : String("default");
+				ret->execute(onHandshake, "HELLO", 3, "AUTH", user, param.password);
+			} else {
+				ret->execute(onHandshake, "HELLO", 3);
+			}
+		} else if (param.password.isNotEmpty()) {
+			if (param.user.isNotEmpty()) {
+				ret->execute(onHandshake, "AUTH", param.user, param.password);
+			} else {
+				ret->execute(onHandshake, "AUTH", param.password);
+			}
+		}
+		if (param.databaseIndex) {
+			ret->execute(onHandshake, "SELECT", param.databaseIndex);
+		}
+
+		ObjectLocker lock(ret.get());
+		AsyncTcpSocketParam sp;
+		sp.connectAddress.ip = ip;
+		sp.connectAddress.port = param.port;
+		sp.flagIPv6 = ip.isIPv6();
+		sp.flagLogError = param.flagLogError;
+		sp.ioLoop = ret->m_param.ioLoop;
+		sp.onConnect = SLIB_FUNCTION_WEAKREF(AsyncRedisClient, _onConnect, ret);
+		Ref<AsyncTcpSocket> socket = AsyncTcpSocket::create(sp);
+		if (socket.isNull()) {
+			return sl_null;
+		}
+		ret->m_socket = Move(socket);
+		return ret;
+	}
+
+	void AsyncRedisClient::close()
+	{
+		CLinkedList<Request> requests;
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed) {
+				return;
+			}
+			m_flagClosed = sl_true;
+			m_flagConnected = sl_false;
+			if (m_socket.isNotNull()) {
+				m_socket->close();
+			}
+			requests.merge_NoLock(&m_queueRequests);
+		}
+		RedisReply reply = RedisReply::error("Connection closed");
+		Request request;
+		while (requests.popFront_NoLock(&request)) {
+			request.callback(reply);
+		}
+	}
+
+	sl_bool AsyncRedisClient::isClosed()
+	{
+		return m_flagClosed;
+	}
+
+	sl_bool AsyncRedisClient::isConnected()
+	{
+		return m_flagConnected;
+	}
+
+	Ref<AsyncIoLoop> AsyncRedisClient::getIoLoop()
+	{
+		return m_param.ioLoop;
+	}
+
+	sl_bool AsyncRedisClient::executeBy(const Variant* args, sl_uint32 nArgs, const Function<void(RedisReply&)>& callback)
+	{
+		return _execute(args, nArgs, callback, sl_false);
+	}
+
+	sl_bool AsyncRedisClient::executeTransaction(const List<VariantList>& _commands, const Function<void(RedisReply&)>& callback)
+	{
+		ListLocker<VariantList> commands(_commands);
+		ObjectLocker lock(this);
+		if (m_flagClosed) {
+			return sl_false;
+		}
+		// the commands are queued after the whole transaction is encoded
+		sl_size sizeWrite = m_sizeWrite;
+		Variant cmd = "MULTI";
+		sl_bool flagSuccess = _encodeCommand(&cmd, 1);
+		for (sl_size i = 0; flagSuccess && i < commands.count; i++) {
+			ListLocker<Variant> args(commands[i]);
+			flagSuccess = args.count && _encodeCommand(args.data, (sl_uint32)(args.count));
+		}
+		if (flagSuccess) {
+			cmd = "EXEC";
+			flagSuccess = _encodeCommand(&cmd, 1);
+		}
+		if (!flagSuccess) {
+			m_sizeWrite = sizeWrite;
+			return sl_false;
+		}
+		Request request;
+		request.flagSubscription = sl_false;
+		for (sl_size i = 0; i <= commands.count; i++) {
+			m_queueRequests.pushBack_NoLock(request);
+		}
+		request.callback = callback;
+		m_queueRequests.pushBack_NoLock(request);
+		_flush_NoLock();
+		return sl_true;
+	}
+
+	sl_bool AsyncRedisClient::get(const String& key, const Function<void(RedisReply&)>& callback)
+	{
+		return execute(callback, "GET", key);
+	}
+
+	sl_bool AsyncRedisClient::set(const String& key, const Variant& value, sl_uint64 expiry, const Function<void(RedisReply&)>& callback)
+	{
+		if (expiry) {
+			return execute(callback, "SET", key, value, "PX", expiry);
+		} else {
+			return execute(callback, "SET", key, value);
+		}
+	}
+
+	sl_bool AsyncRedisClient::del(const String& key, const Function<void(RedisReply&)>& callback)
+	{
+		return execute(callback, "DEL", key);
+	}
+
+	sl_bool AsyncRedisClient::incrby(const String& key, sl_int64 n, const Function<void(RedisReply&)>& callback)
+	{
+		return execute(callback, "INCRBY", key, n);
+	}
+
+	sl_bool AsyncRedisClient::publish(const String& channel, const Variant& message, const Function<void(RedisReply&)>& callback)
+	{
+		return execute(callback, "PUBLISH", channel, message);
+	}
+
+	sl_bool AsyncRedisClient::subscribe(const String& channel, const Function<void(RedisReply&)>& callback)
+	{
+		Variant args[] = {"SUBSCRIBE", channel};
+		return _execute(args, 2, callback, sl_true);
+	}
+
+	sl_bool AsyncRedisClient::unsubscribe(const String& channel, const Function<void(RedisReply&)>& callback)
+	{
+		Variant args[] = {"UNSUBSCRIBE", channel};
+		return _execute(args, 2, callback, sl_true);
+	}
+
+	sl_bool AsyncRedisClient::psubscribe(const String& pattern, const Function<void(RedisReply&)>& callback)
+	{
+		Variant args[] = {"PSUBSCRIBE", pattern};
+		return _execute(args, 2, callback, sl_true);
+	}
+
+	sl_bool AsyncRedisClient::punsubscribe(const String& pattern, const Function<void(RedisReply&)>& callback)
+	{
+		Variant args[] = {"PUNSUBSCRIBE", pattern};
+		return _execute(args, 2, callback, sl_true);
+	}
+
+	sl_bool AsyncRedisClient::_execute(const Variant* args, sl_uint32 nArgs, const Function<void(RedisReply&)>& callback, sl_bool flagSubscription)
+	{
+		if (!nArgs) {
+			return sl_false;
+		}
+		ObjectLocker lock(this);
+		if (m_flagClosed) {
+			return sl_false;
+		}
+		sl_size sizeWrite = m_sizeWrite;
+		if (!(_encodeCommand(args, nArgs))) {
+			m_sizeWrite = sizeWrite;
+			return sl_false;
+		}
+		Request request;
+		request.callback = callback;
+		request.flagSubscription = flagSubscription;
+		m_queueRequests.pushBack_NoLock(request);
+		_flush_NoLock();
+		return sl_true;
+	}
+
+	sl_bool AsyncRedisClient::_encodeCommand(const Variant* args, sl_uint32 nArgs)
+	{
+		String count = String::fromUint32(nArgs);
+		if (!(_writeBytes("*", 1) && _writeBytes(count.getData(), count.getLength()) && _writeBytes("\r\n", 2))) {
+			return sl_false;
+		}
+		for (sl_uint32 i = 0; i < nArgs; i++) {
+			const Variant& arg = args[i];
+			const void* data;
+			sl_size size;
+			Memory mem;
+			String str;
+			if (arg.isMemory()) {
+				mem = arg.getMemory();
+				data = mem.getData();
+				size = mem.getSize();
+			} else {
+				str = arg.getString();
+				data = str.getData();
+				size = str.getLength();
+			}
+			if (size > PRIV_REDIS_BULK_SIZE_MAX) {
+				return sl_false;
+			}
+			String len = String::fromUint64(size);
+			if (!(_reserveWrite(len.getLength() + size + 5))) {
+				return sl_false;
+			}
+			_writeBytes("$", 1);
+			_writeBytes(len.getData(), len.getLength());
+			_writeBytes("\r\n", 2);
+			_writeBytes(data, size);
+			_writeBytes("\r\n", 2);
+		}
+		return sl_true;
+	}
+
+	sl_bool AsyncRedisClient::_reserveWrite(sl_size size)
+	{
+		if (size > PRIV_REDIS_WRITE_SIZE_MAX - m_sizeWrite) {
+			return sl_false;
+		}
+		sl_size capacity = m_bufWrite.getSize();
+		if (m_sizeWrite + size <= capacity) {
+			return sl_true;
+		}
+		sl_size n = capacity ? capacity : 4096;
+		while (n < m_sizeWrite + size) {
+			n <<= 1;
+		}
+		Memory mem = Memory::create(n);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		if (m_sizeWrite) {
+			Base::copyMemory(mem.getData(), m_bufWrite.getData(), m_sizeWrite);
+		}
+		m_bufWrite = Move(mem);
+		return sl_true;
+	}
+
+	sl_bool AsyncRedisClient::_writeBytes(const void* data, sl_size size)
+	{
+		if (!(_reserveWrite(size))) {
+			return sl_false;
+		}
+		Base::copyMemory((sl_uint8*)(m_bufWrite.getData()) + m_sizeWrite, data, size);
+		m_sizeWrite += size;
+		return sl_true;
+	}
+
+	void AsyncRedisClient::_flush_NoLock()
+	{
+		if (!m_flagConnected || m_flagSending || !m_sizeWrite) {
+			return;
+		}
+		m_flagSending = sl_true;
+		// the written buffer is sent, and the buffer of the previous write is reused for the next commands
+		Memory mem = Move(m_bufWrite);
+		m_bufWrite = Move(m_bufSending);
+		m_bufSending = Move(mem);
+		sl_size size = m_sizeWrite;
+		m_sizeWrite = 0;
+		if (!(m_socket->send(m_bufSending.getData(), (sl_uint32)size, m_callbackSend))) {
+			m_flagSending = sl_false;
+			m_param.ioLoop->addTask(SLIB_FUNCTION_WEAKREF(AsyncRedisClient, _onError, this));
+		}
+	}
+
+	void AsyncRedisClient::_onConnect(AsyncTcpSocket* socket, const SocketAddress& address, sl_bool flagError)
+	{
+		if (flagError) {
+			if (m_param.flagLogError) {
+				LogError(TAG, "Failed to connect: %s", address.toString());
+			}
+			m_param.onConnect(this, sl_true);
+			_onError();
+			return;
+		}
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed) {
+				return;
+			}
+			m_flagConnected = sl_true;
+			_flush_NoLock();
+		}
+		_receive();
+		m_param.onConnect(this, sl_false);
+	}
+
+	void AsyncRedisClient::_onSend(AsyncStreamResult* result)
+	{
+		if (result->flagError) {
+			_onError();
+			return;
+		}
+		ObjectLocker lock(this);
+		m_flagSending = sl_false;
+		_flush_NoLock();
+	}
+
+	void AsyncRedisClient::_receive()
+	{
+		if (m_flagClosed) {
+			return;
+		}
+		// unparsed bytes are moved to the front, and the buffer is grown for large replies
+		if (m_posRead) {
+			sl_size n = m_sizeRead - m_posRead;
+			if (n) {
+				Base::moveMemory(m_bufRead.getData(), (sl_uint8*)(m_bufRead.getData()) + m_posRead, n);
+			}
+			m_sizeRead = n;
+			m_posRead = 0;
+		}
+		sl_size capacity = m_bufRead.getSize();
+		if (capacity - m_sizeRead < PRIV_REDIS_READ_SIZE / 2) {
+			Memory mem = Memory::create(capacity ? capacity * 2 : PRIV_REDIS_READ_SIZE);
+			if (mem.isNull()) {
+				_onError();
+				return;
+			}
+			if (m_sizeRead) {
+				Base::copyMemory(mem.getData(), m_bufRead.getData(), m_sizeRead);
+			}
+			m_bufRead = Move(mem);
+		}
+		if (!(m_socket->receive((sl_uint8*)(m_bufRead.getData()) + m_sizeRead, (sl_uint32)(m_bufRead.getSize() - m_sizeRead), m_callbackReceive))) {
+			_onError();
+		}
+	}
+
+	void AsyncRedisClient::_onReceive(AsyncStreamResult* result)
+	{
+		if (result->flagError || !(result->size)) {
+			_onError();
+			return;
+		}
+		m_sizeRead += result->size;
+		const sl_char8* data = (const sl_char8*)(m_bufRead.getData());
+		for (;;) {
+			RedisReply reply;
+			sl_int32 iRet = m_parser->parse(data, m_sizeRead, m_posRead, reply);
+			if (iRet > 0) {
+				_processReply(reply);
+				if (m_flagClosed) {
+					return;
+				}
+			} else if (iRet == 0) {
+				break;
+			} else {
+				if (m_param.flagLogError) {
+					LogError(TAG, "Protocol error");
+				}
+				_onError();
+				return;
+			}
+		}
+		_receive();
+	}
+
+	void AsyncRedisClient::_processReply(RedisReply& reply)
+	{
+		sl_bool flagPush = reply.type == RedisReplyType::Push;
+		if (flagPush || (!(m_param.flagResp3) && reply.type == RedisReplyType::Array)) {
+			sl_bool flagEmptyQueue;
+			sl_bool flagSubscriptionReply;
+			{
+				ObjectLocker lock(this);
+				Link<Request>* front = m_queueRequests.getFront();
+				flagEmptyQueue = !front;
+				flagSubscriptionReply = front && front->value.flagSubscription;
+			}
+			// RESP2 arrays are messages only while the confirmed count of subscriptions is positive
+			// and no reply of a normal command is pending, such as the commands pipelined before subscribing
+			sl_bool flagSubscribed = m_nSubscriptions > 0 && (flagEmptyQueue || flagSubscriptionReply);
+			if (flagPush || flagSubscribed || flagSubscriptionReply) {
+				ListElements<RedisReply> items(reply.elements);
+				SLIB_STATIC_STRING(strMessage, "message")
+				SLIB_STATIC_STRING(strPMessage, "pmessage")
+				SLIB_STATIC_STRING(strSMessage, "smessage")
+				SLIB_STATIC_STRING(strSubscribe, "subscribe")
+				SLIB_STATIC_STRING(strUnsubscribe, "unsubscribe")
+				SLIB_STATIC_STRING(strPSubscribe, "psubscribe")
+				SLIB_STATIC_STRING(strPUnsubscribe, "punsubscribe")
+				String kind;
+				if (items.count) {
+					kind = items[0].string;
+				}
+				if (flagPush || flagSubscribed) {
+					if (kind.equalsIgnoreCase(strMessage) || kind.equalsIgnoreCase(strSMessage)) {
+						if (items.count >= 3) {
+							m_param.onMessage(this, items[1].string, items[2]);
+						}
+						return;
+					}
+					if (kind.equalsIgnoreCase(strPMessage)) {
+						if (items.count >= 4) {
+							m_param.onMessage(this, items[2].string, items[3]);
+						}
+						return;
+					}
+				}
+				if (items.count >= 3 && (kind.equalsIgnoreCase(strSubscribe) || kind.equalsIgnoreCase(strUnsubscribe) || kind.equalsIgnoreCase(strPSubscribe) || kind.equalsIgnoreCase(strPUnsubscribe))) {
+					m_nSubscriptions = items[2].getInteger();
+				}
+				// confirmations of (un)subscription are replies of the subscription commands, and other pushes are delivered as messages
+				if (!flagSubscriptionReply) {
+					if (flagPush) {
+						m_param.onMessage(this, String::null(), reply);
+						return;
+					}
+				}
+			}
+		}
+		Request request;
+		{
+			ObjectLocker lock(this);
+			if (!(m_queueRequests.popFront_NoLock(&request))) {
+				return;
+			}
+		}
+		request.callback(reply);
+	}
+
+	void AsyncRedisClient::_onError()
+	{
+		if (m_flagClosed) {
+			return;
+		}
+		close();
+		m_param.onError(this);
+	}
+
+
+	SLIB_DEFINE_OBJECT(AsyncRedisClientPool, Object)
+
+	AsyncRedisClientPool::AsyncRedisClientPool()
+	{
+		m_indexNext = 0;
+		m_flagClosed = sl_false;
+	}
+
+	AsyncRedisClientPool::~AsyncRedisClientPool()
+	{
+		close();
+	}
+
+	Ref<AsyncRedisClientPool> AsyncRedisClientPool::create(const AsyncRedisClientParam& param, sl_uint32 nClients)
+	{
+		if (!nClients) {
+			nClients = 1;
+		}
+		Ref<AsyncRedisClientPool> ret = new AsyncRedisClientPool;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->m_param = param;
+		for (sl_uint32 i = 0; i < nClients; i++) {
+			AsyncRedisClientParam cp = param;
+			if (cp.ioLoop.isNull()) {
+				cp.ioLoop = AsyncIoLoop::create();
+				if (cp.ioLoop.isNull()) {
+					return sl_null;
+				}
+				ret->m_loops.add_NoLock(cp.ioLoop);
+			}
+			Ref<AsyncRedisClient> client = AsyncRedisClient::create(cp);
+			if (client.isNull()) {
+				ret->close();
+				return sl_null;
+			}
+			ret->m_clients.add_NoLock(Move(client));
+		}
+		return ret;
+	}
+
+	Ref<AsyncRedisClient> AsyncRedisClientPool::getClient()
+	{
+		ObjectLocker lock(this);
+		if (m_flagClosed) {
+			return sl_null;
+		}
+		sl_uint32 n = (sl_uint32)(m_clients.getCount());
+		if (!n) {
+			return sl_null;
+		}
+		sl_uint32 index = m_indexNext % n;
+		m_indexNext = index + 1;
+		Ref<AsyncRedisClient>* clients = m_clients.getData();
+		Ref<AsyncRedisClient>& client = clients[index];
+		if (client->isClosed()) {
+			AsyncRedisClientParam cp = m_param;
+			cp.ioLoop = client->getIoLoop();
+			Ref<AsyncRedisClient> clientNew = AsyncRedisClient::create(cp);
+			if (clientNew.isNotNull()) {
+				client = Move(clientNew);
+			}
+		}
+		return client;
+	}
+
+	void AsyncRedisClientPool::close()
+	{
+		ObjectLocker lock(this);
+		if (m_flagClosed) {
+			return;
+		}
+		m_flagClosed = sl_true;
+		ListElements< Ref<AsyncRedisClient> > clients(m_clients);
+		for (sl_size i = 0; i < clients.count; i++) {
+			clients[i]->close();
+		}
+		ListElements< Ref<AsyncIoLoop> > loops(m_loops);
+		for (sl_size i = 0; i < loops.count; i++) {
+			loops[i]->release();
+		}
+	}
+
+}
@@ -26,12 +26,49 @@
 
 #include "slib/core/file.h"
 #include "slib/core/log.h"
+#include "slib/core/system.h"
+#include "slib/core/thread.h"
 
 #define TAG "SQLiteDatabase"
 
 namespace slib
 {	
 
+	SQLiteParam::SQLiteParam()
+	{
+		flagCreate = sl_true;
+		flagReadonly = sl_false;
+		flagSharedCache = sl_false;
+		journalMode = SQLiteJournalMode::Default;
+		synchronousMode = SQLiteSynchronousMode::Default;
+		mmapSize = -1;
+		cacheSize = 0;
+		tempStore = SQLiteTempStore::Default;
+		busyTimeout = 0;
+		busyBackoffMax = 100;
+	}
+
+	SQLiteParam::~SQLiteParam()
+	{
+	}
+
+
+	SQLiteConfig::SQLiteConfig()
+	{
+		pageCacheSlotSize = 0;
+		pageCacheSlotsCount = 0;
+		lookasideSlotSize = 0;
+		lookasideSlotsCount = 0;
+		mmapSizeDefault = -1;
+		mmapSizeMax = -1;
+		flagMemoryStatus = sl_true;
+	}
+
+	SQLiteConfig::~SQLiteConfig()
+	{
+	}
+
+
 	SLIB_DEFINE_OBJECT(SQLiteDatabase, Database)
 
 	SQLiteDatabase::SQLiteDatabase()
@@ -47,38 +84,145 @@ namespace slib
 	public:
 		sqlite3* m_db;
 
+		sl_uint32 m_busyTimeout;
+		sl_uint32 m_busyBackoffMax;
+		sl_uint64 m_timeBusyStart;
+
 		_priv_Sqlite3Database()
 		{
 			m_db = sl_null;
+			m_busyTimeout = 0;
+			m_busyBackoffMax = 0;
+			m_timeBusyStart = 0;
 		}
 
 		~_priv_Sqlite3Database()
 		{
+			clearStatementCache();
 			::sqlite3_close(m_db);
 		}
 
-		static Ref<_priv_Sqlite3Database> connect(const String& filePath, sl_bool flagCreate, sl_bool flagReadonly)
+		static Ref<_priv_Sqlite3Database> connect(const SQLiteParam& param)
 		{
 			Ref<_priv_Sqlite3Database> ret;
 			sqlite3* db = sl_null;
 			int flags;
-			if (flagCreate) {
+			sl_bool flagReadonly = sl_false;
+			if (param.flagCreate) {
 				flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
 			} else {
+				flagReadonly = param.flagReadonly;
 				flags = flagReadonly ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
 			}
-			sl_int32 iResult = ::sqlite3_open_v2(filePath.getData(), &db, flags, sl_null);
+			if (param.flagSharedCache) {
+				flags |= SQLITE_OPEN_SHAREDCACHE;
+			}
+			sl_int32 iResult = ::sqlite3_open_v2(param.path.getData(), &db, flags, sl_null);
 			if (SQLITE_OK == iResult) {
 				ret = new _priv_Sqlite3Database();
 				if (ret.isNotNull()) {
 					ret->m_db = db;
+					ret->_applyParam(param, flagReadonly);
 					return ret;
 				}
-				::sqlite3_close(db);
 			}
+			::sqlite3_close(db);
 			return ret;
 		}
 
+		void _applyParam(const SQLiteParam& param, sl_bool flagReadonly)
+		{
+			if (param.busyTimeout) {
+				m_busyTimeout = param.busyTimeout;
+				m_busyBackoffMax = param.busyBackoffMax ? param.busyBackoffMax : 1;
+				::sqlite3_busy_handler(m_db, &_onBusy, this);
+			}
+			if (!flagReadonly) {
+				switch (param.journalMode) {
+					case SQLiteJournalMode::Delete:
+						execute("PRAGMA journal_mode=DELETE");
+						break;
+					case SQLiteJournalMode::Truncate:
+						execute("PRAGMA journal_mode=TRUNCATE");
+						break;
+					case SQLiteJournalMode::Persist:
+						execute("PRAGMA journal_mode=PERSIST");
+						break;
+					case SQLiteJournalMode::Memory:
+						execute("PRAGMA journal_mode=MEMORY");
+						break;
+					case SQLiteJournalMode::WAL:
+						execute("PRAGMA journal_mode=WAL");
+						break;
+					case SQLiteJournalMode::Off:
+						execute("PRAGMA journal_mode=OFF");
+						break;
+					default:
+						break;
+				}
+			}
+			switch (param.synchronousMode) {
+				case SQLiteSynchronousMode::Off:
+					execute("PRAGMA synchronous=OFF");
+					break;
+				case SQLiteSynchronousMode::Normal:
+					execute("PRAGMA synchronous=NORMAL");
+					break;
+				case SQLiteSynchronousMode::Full:
+					execute("PRAGMA synchronous=FULL");
+					break;
+				case SQLiteSynchronousMode::Extra:
+					execute("PRAGMA synchronous=EXTRA");
+					break;
+				default:
+					break;
+			}
+			if (param.mmapSize >= 0) {
+				execute("PRAGMA mmap_size=" + String::fromInt64(param.mmapSize));
+			}
+			if (param.cacheSize) {
+				execute("PRAGMA cache_size=" + String::fromInt32(param.cacheSize));
+			}
+			switch (param.tempStore) {
+				case SQLiteTempStore::File:
+					execute("PRAGMA temp_store=FILE");
+					break;
+				case SQLiteTempStore::Memory:
+					execute("PRAGMA temp_store=MEMORY");
+					break;
+				default:
+					break;
+			}
+			ListElements<String> pragmas(param.pragmas);
+			for (sl_size i = 0; i < pragmas.count; i++) {
+				execute(pragmas[i]);
+			}
+		}
+
+		// retries with exponential backoff until `m_busyTimeout` is elapsed
+		static int _onBusy(void* user, int count)
+		{
+			_priv_Sqlite3Database* db = (_priv_Sqlite3Database*)user;
+			sl_uint64 now = System::getTickCount64();
+			if (!count) {
+				db->m_timeBusyStart = now;
+			}
+			sl_uint64 elapsed = now - db->m_timeBusyStart;
+			if (elapsed >= db->m_busyTimeout) {
+				return 0;
+			}
+			sl_uint32 interval = db->m_busyBackoffMax;
+			if (count < 31 && ((sl_uint32)1 << count) < interval) {
+				interval = (sl_uint32)1 << count;
+			}
+			sl_uint64 remain = db->m_busyTimeout - elapsed;
+			if (interval > remain) {
+				interval = (sl_uint32)remain;
+			}
+			Thread::sleep(interval);
+			return 1;
+		}
+
 		sl_int64 _execute(const String& sql) override
 		{
 			ObjectLocker lock(this);
@@ -88,6 +232,25 @@ namespace slib
 			return -1;
 		}
 
+		sl_bool _beginBatch() override
+		{
+			ObjectLocker lock(this);
+			if (::sqlite3_get_autocommit(m_db)) {
+				return SQLITE_OK == ::sqlite3_exec(m_db, "BEGIN", 0, 0, sl_null);
+			}
+			return sl_false;
+		}
+
+		sl_bool _endBatch() override
+		{
+			ObjectLocker lock(this);
+			if (SQLITE_OK == ::sqlite3_exec(m_db, "COMMIT", 0, 0, sl_null)) {
+				return sl_true;
+			}
+			::sqlite3_exec(m_db, "ROLLBACK", 0, 0, sl_null);
+			return sl_false;
+		}
+
 		static HashMap<String, Variant> _getRow(sqlite3_stmt* stmt, String* columns, sl_uint32 nColumns)
 		{
 			HashMap<String, Variant> row;
@@ -104,26 +267,20 @@ namespace slib
 			Ref<DatabaseStatement> m_statementObj;
 			sqlite3_stmt* m_statement;
 
-			CList<String> m_listColumnNames;
 			sl_uint32 m_nColumnNames;
 			String* m_columnNames;
-			CHashMap<String, sl_int32> m_mapColumnIndexes;
+			sl_bool m_flagEnd;
 
-			_priv_DatabaseCursor(Database* db, DatabaseStatement* statementObj, sqlite3_stmt* statement)
+			_priv_DatabaseCursor(Database* db, DatabaseStatement* statementObj, sqlite3_stmt* statement, _priv_DatabaseColumns* columns)
 			{
 				m_db = db;
 				m_statementObj = statementObj;
 				m_statement = statement;
+				m_flagEnd = sl_false;
 
-				sl_int32 cols = ::sqlite3_column_count(statement);
-				for (sl_int32 i = 0; i < cols; i++) {
-					const char* buf = ::sqlite3_column_name(statement, (int)i);
-					String name(buf);
-					m_listColumnNames.add_NoLock(name);
-					m_mapColumnIndexes.put_NoLock(name, i);
-				}
-				m_nColumnNames = (sl_uint32)(m_listColumnNames.getCount());
-				m_columnNames = m_listColumnNames.getData();
+				m_columns = columns;
+				m_nColumnNames = columns->getCount();
+				m_columnNames = columns->getNames();
 
 				db->lock();
 			}
@@ -150,7 +307,7 @@ namespace slib
 
 			sl_int32 getColumnIndex(const String& name) override
 			{
-				return m_mapColumnIndexes.getValue_NoLock(name, -1);
+				return m_columns->getIndex(name);
 			}
 
 			HashMap<String, Variant> getRow() override
@@ -217,6 +374,24 @@ namespace slib
 				return sl_null;
 			}
 
+			DatabaseColumnType getColumnType(sl_uint32 index) override
+			{
+				if (index < m_nColumnNames) {
+					int type = ::sqlite3_column_type(m_statement, index);
+					switch (type) {
+					case SQLITE_INTEGER:
+						return DatabaseColumnType::Integer;
+					case SQLITE_FLOAT:
+						return DatabaseColumnType::Float;
+					case SQLITE_TEXT:
+						return DatabaseColumnType::Text;
+					case SQLITE_BLOB:
+						return DatabaseColumnType::Blob;
+					}
+				}
+				return DatabaseColumnType::Null;
+			}
+
 			String getString(sl_uint32 index) override
 			{
 				if (index < m_nColumnNames) {
@@ -233,6 +408,23 @@ namespace slib
 				return sl_null;
 			}
 
+			StringView getStringView(sl_uint32 index) override
+			{
+				if (index < m_nColumnNames) {
+					if (::sqlite3_column_type(m_statement, index) == SQLITE_TEXT) {
+						// the text is held by the statement until the next step
+						const char* buf = (const char*)(sqlite3_column_text(m_statement, index));
+						int n = sqlite3_column_bytes(m_statement, index);
+						if (buf && n > 0) {
+							return StringView(buf, n);
+						}
+						return sl_null;
+					}
+					return DatabaseCursor::getStringView(index);
+				}
+				return sl_null;
+			}
+
 			sl_int64 getInt64(sl_uint32 index, sl_int64 defaultValue) override
 			{
 				if (index < m_nColumnNames) {
@@ -342,12 +534,25 @@ namespace slib
 				return sl_null;
 			}
 
+			sl_bool isNull(sl_uint32 index) override
+			{
+				if (index < m_nColumnNames) {
+					return ::sqlite3_column_type(m_statement, index) == SQLITE_NULL;
+				}
+				return sl_true;
+			}
+
 			sl_bool moveNext() override
 			{
+				// `sqlite3_step()` restarts the finished statement, so the end is kept
+				if (m_flagEnd) {
+					return sl_false;
+				}
 				sl_int32 nRet = ::sqlite3_step(m_statement);
 				if (nRet == SQLITE_ROW) {
 					return sl_true;
 				}
+				m_flagEnd = sl_true;
 				return sl_false;
 			}
 
@@ -359,6 +564,7 @@ namespace slib
 			sqlite3* m_sqlite;
 			sqlite3_stmt* m_statement;
 			Array<Variant> m_boundParams;
+			Ref<_priv_DatabaseColumns> m_columns;
 
 			_priv_DatabaseStatement(_priv_Sqlite3Database* db, sqlite3_stmt* statement)
 			{
@@ -447,6 +653,24 @@ namespace slib
 				return sl_false;
 			}
 
+			// the column names are resolved once, and again only when SQLite re-prepared the statement with another shape
+			_priv_DatabaseColumns* _getColumns()
+			{
+				sl_uint32 cols = (sl_uint32)(::sqlite3_column_count(m_statement));
+				if (m_columns.isNotNull() && m_columns->getCount() == cols) {
+					return m_columns.get();
+				}
+				Ref<_priv_DatabaseColumns> columns = new _priv_DatabaseColumns;
+				if (columns.isNull()) {
+					return sl_null;
+				}
+				for (sl_uint32 i = 0; i < cols; i++) {
+					columns->add(::sqlite3_column_name(m_statement, (int)i));
+				}
+				m_columns = Move(columns);
+				return m_columns.get();
+			}
+
 			sl_int64 executeBy(const Variant* params, sl_uint32 nParams) override
 			{
 				ObjectLocker lock(m_db.get());
@@ -465,9 +689,12 @@ namespace slib
 				ObjectLocker lock(m_db.get());
 				Ref<DatabaseCursor> ret;
 				if (_execute(params, nParams)) {
-					ret = new _priv_DatabaseCursor(m_db.get(), this, m_statement);
-					if (ret.isNotNull()) {
-						return ret;
+					_priv_DatabaseColumns* columns = _getColumns();
+					if (columns) {
+						ret = new _priv_DatabaseCursor(m_db.get(), this, m_statement, columns);
+						if (ret.isNotNull()) {
+							return ret;
+						}
 					}
 					::sqlite3_reset(m_statement);
 					::sqlite3_clear_bindings(m_statement);
@@ -501,9 +728,150 @@ namespace slib
 		}
 	};
 	
+	Ref<SQLiteDatabase> SQLiteDatabase::connect(const SQLiteParam& param)
+	{
+		return _priv_Sqlite3Database::connect(param);
+	}
+
 	Ref<SQLiteDatabase> SQLiteDatabase::connect(const String& path, sl_bool flagCreate, sl_bool flagReadonly)
 	{
-		return _priv_Sqlite3Database::connect(path, flagCreate, flagReadonly);
+		SQLiteParam param;
+		param.path = path;
+		param.flagCreate = flagCreate;
+		param.flagReadonly = flagReadonly;
+		return _priv_Sqlite3Database::connect(param);
+	}
+
+	sl_bool SQLiteDatabase::configure(const SQLiteConfig& config)
+	{
+		if (SQLITE_OK != ::sqlite3_config(SQLITE_CONFIG_MEMSTATUS, config.flagMemoryStatus ? 1 : 0)) {
+			return sl_false;
+		}
+		if (config.pageCacheSlotSize && config.pageCacheSlotsCount) {
+			// the arena is used by SQLite for the lifetime of the process
+			void* arena = Base::createMemory((sl_size)(config.pageCacheSlotSize) * config.pageCacheSlotsCount);
+			if (!arena) {
+				return sl_false;
+			}
+			if (SQLITE_OK != ::sqlite3_config(SQLITE_CONFIG_PAGECACHE, arena, (int)(config.pageCacheSlotSize), (int)(config.pageCacheSlotsCount))) {
+				Base::freeMemory(arena);
+				return sl_false;
+			}
+		}
+		if (config.lookasideSlotSize && config.lookasideSlotsCount) {
+			if (SQLITE_OK != ::sqlite3_config(SQLITE_CONFIG_LOOKASIDE, (int)(config.lookasideSlotSize), (int)(config.lookasideSlotsCount))) {
+				return sl_false;
+			}
+		}
+		if (config.mmapSizeDefault >= 0 || config.mmapSizeMax >= 0) {
+			// negative values are replaced by the compile-time defaults
+			if (SQLITE_OK != ::sqlite3_config(SQLITE_CONFIG_MMAP_SIZE, (sqlite3_int64)(config.mmapSizeDefault), (sqlite3_int64)(config.mmapSizeMax))) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+
+	SLIB_DEFINE_OBJECT(SQLiteDatabasePool, Object)
+
+	SQLiteDatabasePool::SQLiteDatabasePool()
+	{
+	}
+
+	SQLiteDatabasePool::~SQLiteDatabasePool()
+	{
+	}
+
+	Ref<SQLiteDatabasePool> SQLiteDatabasePool::create(const String& filePath, const DatabasePoolParam& readerParam)
+	{
+		SQLiteParam param;
+		param.path = filePath;
+		return create(param, readerParam);
+	}
+
+	Ref<SQLiteDatabasePool> SQLiteDatabasePool::create(const SQLiteParam& _param, const DatabasePoolParam& readerParam)
+	{
+		SQLiteParam paramWriter = _param;
+		paramWriter.flagCreate = sl_true;
+		paramWriter.flagReadonly = sl_false;
+		paramWriter.journalMode = SQLiteJournalMode::WAL;
+		SQLiteParam paramReader = _param;
+		paramReader.flagCreate = sl_false;
+		paramReader.flagReadonly = sl_true;
+		DatabasePoolParam writerParam;
+		writerParam.minimumConnectionsCount = 1;
+		writerParam.maximumConnectionsCount = 1;
+		writerParam.idleTimeout = 0;
+		writerParam.waitTimeout = readerParam.waitTimeout;
+		writerParam.statementCacheSize = readerParam.statementCacheSize;
+		writerParam.onConnect = [paramWriter]() -> Ref<Database> {
+			return SQLiteDatabase::connect(paramWriter);
+		};
+		// the writer is connected first, to create the database file
+		Ref<DatabasePool> poolWriter = DatabasePool::create(writerParam);
+		if (poolWriter.isNull()) {
+			return sl_null;
+		}
+		DatabasePoolParam param = readerParam;
+		param.onConnect = [paramReader]() -> Ref<Database> {
+			return SQLiteDatabase::connect(paramReader);
+		};
+		param.onValidate.setNull();
+		Ref<DatabasePool> poolReaders = DatabasePool::create(param);
+		if (poolReaders.isNull()) {
+			return sl_null;
+		}
+		Ref<SQLiteDatabasePool> ret = new SQLiteDatabasePool;
+		if (ret.isNotNull()) {
+			ret->m_poolReaders = Move(poolReaders);
+			ret->m_poolWriter = Move(poolWriter);
+			return ret;
+		}
+		return sl_null;
+	}
+
+	Ref<SQLiteDatabasePool> SQLiteDatabasePool::create(const String& filePath, sl_uint32 maximumReadersCount)
+	{
+		DatabasePoolParam param;
+		param.maximumConnectionsCount = maximumReadersCount;
+		return create(filePath, param);
+	}
+
+	DatabaseLease SQLiteDatabasePool::acquireReader()
+	{
+		return m_poolReaders->acquire();
+	}
+
+	DatabaseLease SQLiteDatabasePool::acquireReader(sl_int32 timeout)
+	{
+		return m_poolReaders->acquire(timeout);
+	}
+
+	DatabaseLease SQLiteDatabasePool::acquireWriter()
+	{
+		return m_poolWriter->acquire();
+	}
+
+	DatabaseLease SQLiteDatabasePool::acquireWriter(sl_int32 timeout)
+	{
+		return m_poolWriter->acquire(timeout);
+	}
+
+	Ref<DatabasePool> SQLiteDatabasePool::getReaderPool()
+	{
+		return m_poolReaders;
+	}
+
+	Ref<DatabasePool> SQLiteDatabasePool::getWriterPool()
+	{
+		return m_poolWriter;
+	}
+
+	void SQLiteDatabasePool::close()
+	{
+		m_poolReaders->close();
+		m_poolWriter->close();
 	}
 
 }
@@ -29,6 +29,16 @@
 
 #define STACK_BUFFER_SIZE 4096
 
+#if defined(__SIZEOF_INT128__)
+#	define PRIV_BIGINT_SUPPORT_UINT128
+#elif defined(SLIB_COMPILER_IS_VC) && defined(SLIB_ARCH_IS_X64)
+#	include <intrin.h>
+#	define PRIV_BIGINT_SUPPORT_UMUL128
+#endif
+
+// count of 64-bit words from which Karatsuba multiplication is used
+#define PRIV_BIGINT_KARATSUBA_THRESHOLD 24
+
 /*
 	CBigInt
 */
@@ -348,6 +358,277 @@ namespace slib
 	}
 
 
+/*
+	Arithmetic on 64-bit words
+
+	CBigInt keeps 32-bit elements, but multiplications and Montgomery reductions
+	work on 64-bit words (`__int128`, `_umul128`), which halves the count of the inner loops.
+*/
+
+	// (high, low) = a * b + c + d
+	SLIB_INLINE static void _priv_BigInt_mulAdd(sl_uint64 a, sl_uint64 b, sl_uint64 c, sl_uint64 d, sl_uint64& high, sl_uint64& low) noexcept
+	{
+#if defined(PRIV_BIGINT_SUPPORT_UINT128)
+		unsigned __int128 t = (unsigned __int128)a * b + c + d;
+		low = (sl_uint64)t;
+		high = (sl_uint64)(t >> 64);
+#else
+		sl_uint64 h, l;
+#	if defined(PRIV_BIGINT_SUPPORT_UMUL128)
+		l = _umul128(a, b, &h);
+#	else
+		Math::mul64(a, b, h, l);
+#	endif
+		l += c;
+		h += l < c ? 1 : 0;
+		l += d;
+		h += l < d ? 1 : 0;
+		low = l;
+		high = h;
+#endif
+	}
+
+	// o (n64 words) <- a (n32 elements)
+	static void _priv_BigInt_toWords(sl_uint64* o, sl_size n64, const sl_uint32* a, sl_size n32) noexcept
+	{
+		sl_size i = 0;
+		for (; i + 1 < n32 && (i >> 1) < n64; i += 2) {
+			o[i >> 1] = ((sl_uint64)(a[i + 1]) << 32) | a[i];
+		}
+		sl_size k = i >> 1;
+		if (i < n32 && k < n64) {
+			o[k++] = a[i];
+		}
+		for (; k < n64; k++) {
+			o[k] = 0;
+		}
+	}
+
+	// o (n32 elements) <- a
+	static void _priv_BigInt_fromWords(sl_uint32* o, sl_size n32, const sl_uint64* a) noexcept
+	{
+		for (sl_size i = 0; i < n32; i++) {
+			sl_uint64 w = a[i >> 1];
+			o[i] = (sl_uint32)((i & 1) ? (w >> 32) : w);
+		}
+	}
+
+	static sl_int32 _priv_BigInt_compareWords(const sl_uint64* a, const sl_uint64* b, sl_size n) noexcept
+	{
+		for (sl_size i = n; i > 0; i--) {
+			if (a[i - 1] > b[i - 1]) {
+				return 1;
+			}
+			if (a[i - 1] < b[i - 1]) {
+				return -1;
+			}
+		}
+		return 0;
+	}
+
+	// returns carry
+	static sl_uint64 _priv_BigInt_addWords(sl_uint64* c, const sl_uint64* a, const sl_uint64* b, sl_size n) noexcept
+	{
+		sl_uint64 of = 0;
+		for (sl_size i = 0; i < n; i++) {
+			sl_uint64 sum = a[i] + of;
+			of = sum < of ? 1 : 0;
+			sl_uint64 t = b[i];
+			sum += t;
+			of += sum < t ? 1 : 0;
+			c[i] = sum;
+		}
+		return of;
+	}
+
+	// returns borrow
+	static sl_uint64 _priv_BigInt_subWords(sl_uint64* c, const sl_uint64* a, const sl_uint64* b, sl_size n) noexcept
+	{
+		sl_uint64 of = 0;
+		for (sl_size i = 0; i < n; i++) {
+			sl_uint64 k1 = a[i];
+			sl_uint64 k2 = b[i];
+			sl_uint64 o = k1 < of ? 1 : 0;
+			k1 -= of;
+			of = o + (k1 < k2 ? 1 : 0);
+			c[i] = k1 - k2;
+		}
+		return of;
+	}
+
+	// c += carry, returns carry
+	static sl_uint64 _priv_BigInt_incWords(sl_uint64* c, sl_size n, sl_uint64 carry) noexcept
+	{
+		for (sl_size i = 0; i < n && carry; i++) {
+			sl_uint64 sum = c[i] + carry;
+			carry = sum < carry ? 1 : 0;
+			c[i] = sum;
+		}
+		return carry;
+	}
+
+	// c -= borrow, returns borrow
+	static sl_uint64 _priv_BigInt_decWords(sl_uint64* c, sl_size n, sl_uint64 borrow) noexcept
+	{
+		for (sl_size i = 0; i < n && borrow; i++) {
+			sl_uint64 k = c[i];
+			c[i] = k - borrow;
+			borrow = k < borrow ? 1 : 0;
+		}
+		return borrow;
+	}
+
+	// c (na + nb words) = a * b
+	static void _priv_BigInt_mulBasic(sl_uint64* c, const sl_uint64* a, sl_size na, const sl_uint64* b, sl_size nb) noexcept
+	{
+		Base::zeroMemory(c, na << 3);
+		for (sl_size i = 0; i < nb; i++) {
+			sl_uint64 bi = b[i];
+			sl_uint64 carry = 0;
+			sl_uint64* t = c + i;
+			for (sl_size j = 0; j < na; j++) {
+				_priv_BigInt_mulAdd(a[j], bi, t[j], carry, carry, t[j]);
+			}
+			t[na] = carry;
+		}
+	}
+
+	// c (n words) = |a - b| (a: n words, b: m words, m <= n), returns sl_true when a < b
+	static sl_bool _priv_BigInt_diffWords(sl_uint64* c, const sl_uint64* a, const sl_uint64* b, sl_size n, sl_size m) noexcept
+	{
+		sl_int32 cmp = 0;
+		for (sl_size i = m; i < n; i++) {
+			if (a[i]) {
+				cmp = 1;
+				break;
+			}
+		}
+		if (!cmp) {
+			cmp = _priv_BigInt_compareWords(a, b, m);
+		}
+		if (cmp >= 0) {
+			sl_uint64 borrow = _priv_BigInt_subWords(c, a, b, m);
+			for (sl_size i = m; i < n; i++) {
+				c[i] = a[i];
+			}
+			_priv_BigInt_decWords(c + m, n - m, borrow);
+			return sl_false;
+		} else {
+			_priv_BigInt_subWords(c, b, a, m);
+			for (sl_size i = m; i < n; i++) {
+				c[i] = 0;
+			}
+			return sl_true;
+		}
+	}
+
+	/*
+		c (2n words) = a * b (n words)
+		a0*b1 + a1*b0 = (a0 - a1)*(b1 - b0) + a0*b0 + a1*b1
+		t: temporary buffer (8n + 64 words)
+	*/
+	static void _priv_BigInt_mulKaratsuba(sl_uint64* c, const sl_uint64* a, const sl_uint64* b, sl_size n, sl_uint64* t) noexcept
+	{
+		if (n < PRIV_BIGINT_KARATSUBA_THRESHOLD) {
+			_priv_BigInt_mulBasic(c, a, n, b, n);
+			return;
+		}
+		sl_size h = (n + 1) >> 1;
+		sl_size l = n - h;
+		sl_uint64* d0 = t;
+		sl_uint64* d1 = t + h;
+		sl_uint64* z1 = t + (h << 1);
+		sl_uint64* m = t + (h << 2);
+		sl_uint64* next = m + (h << 1) + 1;
+		sl_bool s0 = _priv_BigInt_diffWords(d0, a, a + h, h, l);
+		sl_bool s1 = _priv_BigInt_diffWords(d1, b, b + h, h, l);
+		_priv_BigInt_mulKaratsuba(z1, d0, d1, h, next);
+		_priv_BigInt_mulKaratsuba(c, a, b, h, next);
+		_priv_BigInt_mulKaratsuba(c + (h << 1), a + h, b + h, l, next);
+		// m = a0*b0 + a1*b1 +- |a0 - a1|*|b1 - b0|
+		Base::copyMemory(m, c, h << 4);
+		m[h << 1] = 0;
+		sl_uint64 carry = _priv_BigInt_addWords(m, m, c + (h << 1), l << 1);
+		_priv_BigInt_incWords(m + (l << 1), (h << 1) + 1 - (l << 1), carry);
+		if (s0 == s1) {
+			sl_uint64 borrow = _priv_BigInt_subWords(m, m, z1, h << 1);
+			m[h << 1] -= borrow;
+		} else {
+			carry = _priv_BigInt_addWords(m, m, z1, h << 1);
+			m[h << 1] += carry;
+		}
+		carry = _priv_BigInt_addWords(c + h, c + h, m, (h << 1) + 1);
+		_priv_BigInt_incWords(c + 3 * h + 1, (n << 1) - 3 * h - 1, carry);
+	}
+
+	// c (na + nb words) = a * b
+	static sl_bool _priv_BigInt_mulWords(sl_uint64* c, const sl_uint64* a, sl_size na, const sl_uint64* b, sl_size nb) noexcept
+	{
+		if (na < nb) {
+			Swap(a, b);
+			Swap(na, nb);
+		}
+		if (nb < PRIV_BIGINT_KARATSUBA_THRESHOLD) {
+			_priv_BigInt_mulBasic(c, a, na, b, nb);
+			return sl_true;
+		}
+		// multiplies the blocks (nb words) of `a` by `b`
+		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, t, 10 * nb + 64);
+		if (!t) {
+			return sl_false;
+		}
+		sl_uint64* r = t + 8 * nb + 64;
+		Base::zeroMemory(c, (na + nb) << 3);
+		for (sl_size i = 0; i < na; i += nb) {
+			sl_size k = Math::min(nb, na - i);
+			if (k == nb) {
+				_priv_BigInt_mulKaratsuba(r, a + i, b, nb, t);
+			} else {
+				_priv_BigInt_mulBasic(r, b, nb, a + i, k);
+			}
+			sl_uint64 carry = _priv_BigInt_addWords(c + i, c + i, r, nb + k);
+			_priv_BigInt_incWords(c + i + nb + k, na - i - k, carry);
+		}
+		return sl_true;
+	}
+
+	/*
+		Montgomery multiplication (CIOS): r = a * b * R^-1 mod m  (R = 2^(64*n), a, b < m)
+		t: temporary buffer (n + 2 words), `r` can be same as `a` or `b`
+	*/
+	static void _priv_BigInt_mulMontgomery(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, const sl_uint64* m, sl_size n, sl_uint64 mi, sl_uint64* t) noexcept
+	{
+		Base::zeroMemory(t, (n + 2) << 3);
+		for (sl_size i = 0; i < n; i++) {
+			sl_uint64 ai = a[i];
+			sl_uint64 c = 0;
+			sl_size j;
+			for (j = 0; j < n; j++) {
+				_priv_BigInt_mulAdd(ai, b[j], t[j], c, c, t[j]);
+			}
+			sl_uint64 s = t[n] + c;
+			t[n + 1] = s < c ? 1 : 0;
+			t[n] = s;
+			// t = (t + u * m) / 2^64
+			sl_uint64 u = t[0] * mi;
+			sl_uint64 low;
+			_priv_BigInt_mulAdd(u, m[0], t[0], 0, c, low);
+			for (j = 1; j < n; j++) {
+				_priv_BigInt_mulAdd(u, m[j], t[j], c, c, t[j - 1]);
+			}
+			s = t[n] + c;
+			c = s < c ? 1 : 0;
+			t[n - 1] = s;
+			t[n] = t[n + 1] + c;
+		}
+		if (t[n] || _priv_BigInt_compareWords(t, m, n) >= 0) {
+			_priv_BigInt_subWords(r, t, m, n);
+		} else {
+			Base::copyMemory(r, t, n << 3);
+		}
+	}
+
+
 	SLIB_DEFINE_ROOT_OBJECT(CBigInt)
 
 	SLIB_INLINE void CBigInt::_free() noexcept
@@ -1439,37 +1720,32 @@ namespace slib
 		} else {
 			nd = getMostSignificantElements();
 		}
-		sl_size n = na + nb;
-		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, out, n);
-		if (!out) {
+		sl_size na64 = (na + 1) >> 1;
+		sl_size nb64 = (nb + 1) >> 1;
+		sl_size n64 = na64 + nb64;
+		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, buf, n64 << 1);
+		if (!buf) {
 			return sl_false;
 		}
-		Base::zeroMemory(out, 8 * n);
-		for (sl_size ib = 0; ib < nb; ib++) {
-			for (sl_size ia = 0; ia < na; ia++) {
-				sl_uint64 c = a.elements[ia];
-				c *= b.elements[ib];
-				out[ia + ib] += (sl_uint32)c;
-				out[ia + ib + 1] += (sl_uint32)(c >> 32);
-			}
+		sl_uint64* wa = buf;
+		sl_uint64* wb = buf + na64;
+		sl_uint64* out = buf + n64;
+		_priv_BigInt_toWords(wa, na64, a.elements, na);
+		_priv_BigInt_toWords(wb, nb64, b.elements, nb);
+		if (!(_priv_BigInt_mulWords(out, wa, na64, wb, nb64))) {
+			return sl_false;
 		}
-		sl_uint32 o = 0;
-		sl_size i;
-		sl_size m = 0;
-		for (i = 0; i < n; i++) {
-			sl_uint64 c = out[i] + o;
-			sl_uint32 t = (sl_uint32)c;
-			out[i] = t;
-			if (t) {
-				m = i;
+		sl_size n = na + nb;
+		while (n > 1) {
+			sl_uint64 w = out[(n - 1) >> 1];
+			if (((n - 1) & 1) ? (w >> 32) : (sl_uint32)w) {
+				break;
 			}
-			o = (sl_uint32)(c >> 32);
+			n--;
 		}
-		if (growLength(m + 1)) {
-			for (i = 0; i <= m; i++) {
-				elements[i] = (sl_uint32)(out[i]);
-			}
-			for (; i < nd; i++) {
+		if (growLength(n)) {
+			_priv_BigInt_fromWords(elements, n, out);
+			for (sl_size i = n; i < nd; i++) {
 				elements[i] = 0;
 			}
 			return sl_true;
@@ -2014,170 +2290,313 @@ namespace slib
 		return pow(*this, E);
 	}
 
-/*
-	Montgomery multiplication: A = A * B * R^-1 mod M
-*/
-	static sl_bool _cbigint_mont_mul(CBigInt& A, const CBigInt& B, const CBigInt& M, sl_uint32 MI) noexcept
+	sl_bool CBigInt::pow_montgomery(const CBigInt& A, const CBigInt& E, const CBigInt& M) noexcept
 	{
-		sl_size nM = M.length;
-		sl_size nB = Math::min(nM, B.length);
-		
-		sl_size nOut = nM * 2 + 1;
-		SLIB_SCOPED_BUFFER(sl_uint32, STACK_BUFFER_SIZE, out, nOut);
-		if (!out) {
+		MontgomeryContext context;
+		if (!(context._initialize(M))) {
+			return sl_false;
+		}
+		return context.pow(*this, A, E);
+	}
+
+	sl_bool CBigInt::pow_montgomery(const CBigInt& E, const CBigInt& M) noexcept
+	{
+		return pow_montgomery(*this, E, M);
+	}
+
+	SLIB_DEFINE_OBJECT(MontgomeryContext, Referable)
+
+	MontgomeryContext::MontgomeryContext() noexcept
+	{
+		m_n = 0;
+		m_MI = 0;
+	}
+
+	MontgomeryContext::~MontgomeryContext() noexcept
+	{
+	}
+
+	Ref<MontgomeryContext> MontgomeryContext::create(const BigInt& M) noexcept
+	{
+		CBigInt* m = M.ref._ptr;
+		if (m) {
+			Ref<MontgomeryContext> ret = new MontgomeryContext;
+			if (ret.isNotNull()) {
+				if (ret->_initialize(*m)) {
+					return ret;
+				}
+			}
+		}
+		return sl_null;
+	}
+
+	sl_bool MontgomeryContext::_initialize(const CBigInt& M) noexcept
+	{
+		if (M.sign < 0) {
 			return sl_false;
 		}
-		Base::zeroMemory(out, nOut * 4);
-		for (sl_size i = 0; i < nM; i++) {
-			// T = (T + cB*B + cM*M) / 2^(32*nM)
-			sl_uint32 cB = i < A.length ? A.elements[i] : 0;
-			sl_uint32 cM = (out[0] + cB * B.elements[0]) * MI;
-			_cbigint_muladd_uint32(out, out, nOut, B.elements, nB, cB, 0);
-			_cbigint_muladd_uint32(out, out, nOut, M.elements, nM, cM, 0);
-			*out = cB;
-			nOut--;
-			out++;
-		}
-		if (!A.setValueFromElements(out, nM + 1)) {
+		sl_size n32 = M.getMostSignificantElements();
+		if (n32 == 0 || !(M.elements[0] & 1)) {
 			return sl_false;
 		}
-		if (A.compareAbs(M) >= 0) {
-			if (!A.subAbs(A, M)) {
-				return sl_false;
-			}
+		CBigInt* modulus = M.duplicateCompact();
+		if (!modulus) {
+			return sl_false;
 		}
+		m_modulus = modulus;
+		sl_size n = (n32 + 1) >> 1;
+		// M, R^2 mod M, R mod M  (R = 2^(64*n))
+		Memory mem = Memory::create(n * 24);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		sl_uint64* words = (sl_uint64*)(mem.getData());
+		_priv_BigInt_toWords(words, n, M.elements, n32);
+
+		// MI = -(M0^-1) mod 2^64, by Newton's method: M0 * M0 = 1 mod 8
+		sl_uint64 M0 = words[0];
+		sl_uint64 K = M0;
+		for (sl_uint32 i = 0; i < 5; i++) {
+			K *= 2 - M0 * K;
+		}
+		m_MI = 0 - K;
+
+		CBigInt R2;
+		if (!(R2.setValue((sl_uint32)1))) {
+			return sl_false;
+		}
+		if (!(R2.shiftLeft(n << 7))) {
+			return sl_false;
+		}
+		if (!(CBigInt::divAbs(R2, M, sl_null, &R2))) {
+			return sl_false;
+		}
+		_priv_BigInt_toWords(words + n, n, R2.elements, R2.getMostSignificantElements());
+
+		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, t, (n << 1) + 2);
+		if (!t) {
+			return sl_false;
+		}
+		sl_uint64* one = t + n + 2;
+		Base::zeroMemory(one, n << 3);
+		one[0] = 1;
+		_priv_BigInt_mulMontgomery(words + (n << 1), words + n, one, words, n, m_MI, t);
+
+		m_n = n;
+		m_data = mem;
 		return sl_true;
 	}
 
-/*
-	Montgomery reduction: A = A * R^-1 mod M
-*/
-	SLIB_INLINE static sl_bool _cbigint_mont_reduction(CBigInt& A, const CBigInt& M, sl_uint32 MI) noexcept
+	const BigInt& MontgomeryContext::getModulus() const noexcept
 	{
-		CBIGINT_UINT32(o, 1);
-		return _cbigint_mont_mul(A, o, M, MI);
+		return m_modulus;
 	}
 
-	sl_bool CBigInt::pow_montgomery(const CBigInt& A, const CBigInt& inE, const CBigInt& inM) noexcept
+	// converts |A| mod M to the words
+	static sl_bool _priv_MontgomeryContext_prepare(sl_uint64* o, sl_size n, const CBigInt& A, const CBigInt& M) noexcept
 	{
-		CBigInt M;
-		M.copyFrom(inM);
-		if (!M.compact()) {
-			return sl_false;
+		if (A.compareAbs(M) >= 0) {
+			CBigInt T;
+			if (!(CBigInt::divAbs(A, M, sl_null, &T))) {
+				return sl_false;
+			}
+			_priv_BigInt_toWords(o, n, T.elements, T.getMostSignificantElements());
+		} else {
+			_priv_BigInt_toWords(o, n, A.elements, A.getMostSignificantElements());
 		}
-		sl_size nM = M.getMostSignificantElements();
-		if (nM == 0) {
+		return sl_true;
+	}
+
+	// C = (flagNegative ? -x : x) mod M
+	static sl_bool _priv_MontgomeryContext_output(CBigInt& C, const sl_uint64* x, sl_size n, const CBigInt& M, sl_bool flagNegative) noexcept
+	{
+		sl_size n32 = n << 1;
+		SLIB_SCOPED_BUFFER(sl_uint32, STACK_BUFFER_SIZE, out, n32);
+		if (!out) {
 			return sl_false;
 		}
-		if (M.sign < 0) {
+		_priv_BigInt_fromWords(out, n32, x);
+		n32 = _cbigint_mse(out, n32);
+		if (!(C.setValueFromElements(out, n32))) {
 			return sl_false;
 		}
-		const CBigInt* pE;
-		CBigInt _t_E;
-		if (&inE == this) {
-			pE = &_t_E;
-			if (!_t_E.copyFrom(inE)) {
+		C.sign = 1;
+		if (flagNegative && n32) {
+			if (!(C.subAbs(M, C))) {
 				return sl_false;
 			}
-		} else {
-			pE = &inE;
 		}
-		const CBigInt& E = *pE;
-		sl_size nE = E.getMostSignificantElements();
-		if (nE == 0) {
-			if (!setValue((sl_uint32)1)) {
+		return sl_true;
+	}
+
+	sl_bool MontgomeryContext::pow(CBigInt& C, const CBigInt& A, const CBigInt& E) const noexcept
+	{
+		sl_size n = m_n;
+		if (!n) {
+			return sl_false;
+		}
+		const CBigInt& M = *(m_modulus.ref._ptr);
+		sl_size nbE = E.getMostSignificantBits();
+		if (nbE == 0) {
+			if (!(C.setValue((sl_uint32)1))) {
 				return sl_false;
 			}
-			sign = 1;
+			C.sign = 1;
 			return sl_true;
 		}
 		if (E.sign < 0) {
 			return sl_false;
 		}
-		sl_size nA = A.getMostSignificantElements();
-		if (nA == 0) {
-			setZero();
+		if (A.isZero()) {
+			C.setZero();
 			return sl_true;
 		}
+		sl_bool flagNegative = A.sign < 0 && (E.elements[0] & 1);
+
+		// sliding window: odd powers A^1, A^3, ..., A^(2^w - 1) are pre-computed
+		sl_uint32 w;
+		if (nbE > 671) {
+			w = 6;
+		} else if (nbE > 239) {
+			w = 5;
+		} else if (nbE > 79) {
+			w = 4;
+		} else if (nbE > 23) {
+			w = 3;
+		} else {
+			w = 1;
+		}
+		sl_size nTable = (sl_size)1 << (w - 1);
+		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, buf, (nTable + 2) * n + n + 2);
+		if (!buf) {
+			return sl_false;
+		}
+		sl_uint64* table = buf;
+		sl_uint64* x = buf + nTable * n;
+		sl_uint64* a2 = x + n;
+		sl_uint64* t = a2 + n;
+		const sl_uint64* words = (const sl_uint64*)(m_data.getData());
+		const sl_uint64* m = words;
+		const sl_uint64* R2 = words + n;
+		sl_uint64 mi = m_MI;
 
-		// MI = -(M0^-1) mod (2^32)
-		sl_uint32 MI;
-		// initialize montgomery
-		{
-			sl_uint32 M0 = M.elements[0];
-			sl_uint32 K = M0;
-			K += ((M0 + 2) & 4) << 1;
-			for (sl_uint32 i = 32; i >= 8; i /= 2) {
-				K *= (2 - (M0 * K));
+		if (!(_priv_MontgomeryContext_prepare(x, n, A, M))) {
+			return sl_false;
+		}
+		// to Montgomery form: A * R^2 * R^-1 = A * R
+		_priv_BigInt_mulMontgomery(table, x, R2, m, n, mi, t);
+		if (nTable > 1) {
+			_priv_BigInt_mulMontgomery(a2, table, table, m, n, mi, t);
+			for (sl_size i = 1; i < nTable; i++) {
+				_priv_BigInt_mulMontgomery(table + i * n, table + (i - 1) * n, a2, m, n, mi, t);
 			}
-			MI = 0 - K;
 		}
 
-		// pre-compute R^2 mod M
-		// R = 2^(nM*32)
-		CBigInt R2;
-		{
-			if (!R2.setValue((sl_uint32)1)) {
-				return sl_false;
+		const sl_uint32* e = E.elements;
+		sl_bool flagStarted = sl_false;
+		sl_size i = nbE;
+		while (i > 0) {
+			if (!((e[(i - 1) >> 5] >> ((i - 1) & 31)) & 1)) {
+				_priv_BigInt_mulMontgomery(x, x, x, m, n, mi, t);
+				i--;
+				continue;
 			}
-			if (!R2.shiftLeft(nM * 64)) {
-				return sl_false;
+			// window: the longest bits (up to w) ending with 1
+			sl_size l = Math::min((sl_size)w, i);
+			while (!((e[(i - l) >> 5] >> ((i - l) & 31)) & 1)) {
+				l--;
 			}
-			if (!CBigInt::divAbs(R2, M, sl_null, &R2)) {
-				return sl_false;
+			sl_size v = 0;
+			for (sl_size k = 1; k <= l; k++) {
+				v = (v << 1) | ((e[(i - k) >> 5] >> ((i - k) & 31)) & 1);
 			}
+			if (flagStarted) {
+				for (sl_size k = 0; k < l; k++) {
+					_priv_BigInt_mulMontgomery(x, x, x, m, n, mi, t);
+				}
+				_priv_BigInt_mulMontgomery(x, x, table + (v >> 1) * n, m, n, mi, t);
+			} else {
+				Base::copyMemory(x, table + (v >> 1) * n, n << 3);
+				flagStarted = sl_true;
+			}
+			i -= l;
 		}
 
-		sl_bool flagNegative = A.sign < 0;
-		// T = A * R^2 * R^-1 mod M = A * R mod M
-		CBigInt T;
-		if (!CBigInt::divAbs(A, M, sl_null, &T)) {
-			return sl_false;
+		// from Montgomery form: x * 1 * R^-1
+		Base::zeroMemory(a2, n << 3);
+		a2[0] = 1;
+		_priv_BigInt_mulMontgomery(x, x, a2, m, n, mi, t);
+		return _priv_MontgomeryContext_output(C, x, n, M, flagNegative);
+	}
+
+	BigInt MontgomeryContext::pow(const BigInt& A, const BigInt& E) const noexcept
+	{
+		CBigInt* a = A.ref._ptr;
+		CBigInt* e = E.ref._ptr;
+		if (!e || e->isZero()) {
+			return BigInt::fromInt32(1);
 		}
-		if (!_cbigint_mont_mul(T, R2, M, MI)) {
-			return sl_false;
+		if (a) {
+			CBigInt* r = new CBigInt;
+			if (r) {
+				if (pow(*r, *a, *e)) {
+					return r;
+				}
+				delete r;
+			}
+		} else {
+			return BigInt::fromInt32(0);
 		}
+		return sl_null;
+	}
 
-		// C = R^2 * R^-1 mod M = R mod M
-		if (!copyFrom(R2)) {
+	sl_bool MontgomeryContext::mulMod(CBigInt& C, const CBigInt& A, const CBigInt& B) const noexcept
+	{
+		sl_size n = m_n;
+		if (!n) {
 			return sl_false;
 		}
-		if (!_cbigint_mont_reduction(*this, M, MI)) {
-			return sl_false;
+		if (A.isZero() || B.isZero()) {
+			C.setZero();
+			return sl_true;
 		}
-
-		sl_size nbE = E.getMostSignificantBits();
-		for (sl_size ib = 0; ib < nbE; ib++) {
-			sl_size ke = ib >> 5;
-			sl_uint32 kb = (sl_uint32)(ib & 31);
-			if (((E.elements[ke]) >> kb) & 1) {
-				// C = C * T * R^-1 mod M
-				if (!_cbigint_mont_mul(*this, T, M, MI)) {
-					return sl_false;
-				}
-			}
-			// T = T * T * R^-1 mod M
-			if (!_cbigint_mont_mul(T, T, M, MI)) {
-				return sl_false;
-			}
+		const CBigInt& M = *(m_modulus.ref._ptr);
+		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, buf, 3 * n + 2);
+		if (!buf) {
+			return sl_false;
 		}
-		if (!_cbigint_mont_reduction(*this, M, MI)) {
+		sl_uint64* a = buf;
+		sl_uint64* b = a + n;
+		sl_uint64* t = b + n;
+		if (!(_priv_MontgomeryContext_prepare(a, n, A, M))) {
 			return sl_false;
 		}
-		if (flagNegative && (E.elements[0] & 1) != 0) {
-			sign = -1;
-			if (!add(M)) {
-				return sl_false;
-			}
-		} else {
-			sign = 1;
+		if (!(_priv_MontgomeryContext_prepare(b, n, B, M))) {
+			return sl_false;
 		}
-		return sl_true;
+		const sl_uint64* words = (const sl_uint64*)(m_data.getData());
+		// A * B * R^-1 * R^2 * R^-1
+		_priv_BigInt_mulMontgomery(a, a, b, words, n, m_MI, t);
+		_priv_BigInt_mulMontgomery(a, a, words + n, words, n, m_MI, t);
+		return _priv_MontgomeryContext_output(C, a, n, M, A.sign * B.sign < 0);
 	}
 
-	sl_bool CBigInt::pow_montgomery(const CBigInt& E, const CBigInt& M) noexcept
+	BigInt MontgomeryContext::mulMod(const BigInt& A, const BigInt& B) const noexcept
 	{
-		return pow_montgomery(*this, E, M);
+		CBigInt* a = A.ref._ptr;
+		CBigInt* b = B.ref._ptr;
+		if (a && b) {
+			CBigInt* r = new CBigInt;
+			if (r) {
+				if (mulMod(*r, *a, *b)) {
+					return r;
+				}
+				delete r;
+			}
+		} else {
+			return BigInt::fromInt32(0);
+		}
+		return sl_null;
 	}
 
 	sl_bool CBigInt::inverseMod(const CBigInt& A, const CBigInt& M) noexcept
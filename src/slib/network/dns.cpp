@@ -865,6 +865,7 @@ namespace slib
 			AsyncUdpSocketParam up;
 			up.onReceiveFrom = SLIB_FUNCTION_WEAKREF(DnsServer, _onReceiveFrom, ret);
 			up.packetSize = 4096;
+			up.batchSize = 32;
 			up.ioLoop = param.ioLoop;
 			up.flagAutoStart = sl_false;
 			
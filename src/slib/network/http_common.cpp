@@ -25,6 +25,7 @@
 #include "slib/network/url.h"
 #include "slib/core/safe_static.h"
 #include "slib/core/variant.h"
+#include "slib/core/string_pool.h"
 
 namespace slib
 {
@@ -173,6 +174,58 @@ namespace slib
 	DEFINE_HTTP_HEADER(SetCookie, "Set-Cookie")
 	DEFINE_HTTP_HEADER(Cookie, "Cookie")
 
+	// Interned header names, shared by the parsed header maps. Only the known names are
+	// interned, so that the table is not grown by the names coming from the peers.
+	class _priv_HttpHeaders_NamePool
+	{
+	public:
+		StringPool pool;
+		
+	public:
+		_priv_HttpHeaders_NamePool()
+		{
+			pool.add(HttpHeaders::ContentLength);
+			pool.add(HttpHeaders::ContentType);
+			pool.add(HttpHeaders::Host);
+			pool.add(HttpHeaders::AcceptEncoding);
+			pool.add(HttpHeaders::TransferEncoding);
+			pool.add(HttpHeaders::ContentEncoding);
+			pool.add(HttpHeaders::Connection);
+			pool.add(HttpHeaders::Range);
+			pool.add(HttpHeaders::ContentRange);
+			pool.add(HttpHeaders::AcceptRanges);
+			pool.add(HttpHeaders::Origin);
+			pool.add(HttpHeaders::AccessControlAllowOrigin);
+			pool.add(HttpHeaders::SetCookie);
+			pool.add(HttpHeaders::Cookie);
+			const char* names[] = {
+				"Accept", "Accept-Language", "Accept-Charset", "Authorization", "Cache-Control",
+				"Date", "ETag", "Expect", "Expires", "If-Match", "If-Modified-Since", "If-None-Match",
+				"If-Range", "Keep-Alive", "Last-Modified", "Location", "Pragma", "Referer",
+				"Server", "Upgrade", "User-Agent", "Vary", "Via", "WWW-Authenticate",
+				"X-Forwarded-For", "X-Requested-With"
+			};
+			for (sl_size i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+				pool.add(StringView(names[i]));
+			}
+		}
+		
+	};
+
+	SLIB_SAFE_STATIC_GETTER(_priv_HttpHeaders_NamePool, _priv_HttpHeaders_getNamePool)
+
+	static String _priv_HttpHeaders_getName(const sl_char8* name, sl_size len)
+	{
+		_priv_HttpHeaders_NamePool* p = _priv_HttpHeaders_getNamePool();
+		if (p) {
+			String ret = p->pool.get(StringView(name, len));
+			if (ret.isNotNull()) {
+				return ret;
+			}
+		}
+		return String::fromUtf8(name, len);
+	}
+
 	sl_reg HttpHeaders::parseHeaders(HttpHeaderMap& map, const void* _data, sl_size size)
 	{
 		const sl_char8* data = (const sl_char8*)_data;
@@ -209,7 +262,7 @@ namespace slib
 			String name;
 			String value;
 			if (indexSplit != 0) {
-				name = String::fromUtf8(data + posStart, indexSplit - posStart);
+				name = _priv_HttpHeaders_getName(data + posStart, indexSplit - posStart);
 				sl_size startValue = indexSplit + 1;
 				sl_size endValue = posCurrent;
 				while (startValue < endValue) {
@@ -224,9 +277,9 @@ namespace slib
 					}
 					endValue--;
 				}
-				value = Url::decodeUriComponentByUTF8(String::fromUtf8(data + startValue, endValue - startValue));
+				value = Url::decodeUriComponentByUTF8(StringView(data + startValue, endValue - startValue));
 			} else {
-				name = String::fromUtf8(data + posStart, posCurrent - posStart);
+				name = _priv_HttpHeaders_getName(data + posStart, posCurrent - posStart);
 			}
 			map.add_NoLock(name, value);
 			posCurrent += 2;
@@ -556,15 +609,16 @@ namespace slib
 		m_parameters.putAll_NoLock(params);
 	}
 
-	HashMap<String, String> HttpRequest::parseParameters(const String& str)
+	HashMap<String, String> HttpRequest::parseParameters(const void* data, sl_size len)
 	{
-		return parseParameters(str.getData(), str.getLength());
+		return parseParameters(StringView((const sl_char8*)data, len));
 	}
 
-	HashMap<String, String> HttpRequest::parseParameters(const void* data, sl_size len)
+	HashMap<String, String> HttpRequest::parseParameters(const StringView& str)
 	{
 		HashMap<String, String> ret;
-		sl_char8* buf = (sl_char8*)data;
+		const sl_char8* buf = str.getData();
+		sl_size len = str.getLength();
 		sl_size start = 0;
 		sl_size indexSplit = 0;
 		sl_size pos = 0;
@@ -579,13 +633,11 @@ namespace slib
 				indexSplit = pos;
 			} else if (ch == '&') {
 				if (indexSplit > start) {
-					String name = String::fromUtf8(buf + start, indexSplit - start);
+					String name(StringView(buf + start, indexSplit - start));
 					indexSplit++;
-					String value = String::fromUtf8(buf + indexSplit, pos - indexSplit);
-					value = Url::decodeUriComponentByUTF8(value);
-					ret.put_NoLock(name, value);
+					ret.put_NoLock(name, Url::decodeUriComponentByUTF8(StringView(buf + indexSplit, pos - indexSplit)));
 				} else {
-					String name = String::fromUtf8(buf + start, pos - start);
+					String name(StringView(buf + start, pos - start));
 					ret.put_NoLock(name, String::null());
 				}
 				start = pos + 1;
@@ -27,6 +27,36 @@
 namespace slib
 {
 
+	// Checksums of TCP and UDP cover the addresses in the pseudo header, and are adjusted incrementally (RFC 1624) instead of summing the whole segment again
+	static sl_uint16 _priv_NatTable_adjustChecksum(sl_uint16 checksum, const IPv4Address& addressOld, const IPv4Address& addressNew, sl_uint16 portOld, sl_uint16 portNew)
+	{
+		sl_uint32 ipOld = addressOld.getInt();
+		sl_uint32 ipNew = addressNew.getInt();
+		checksum = TCP_IP::adjustChecksum(checksum, (sl_uint16)(ipOld >> 16), (sl_uint16)(ipNew >> 16));
+		checksum = TCP_IP::adjustChecksum(checksum, (sl_uint16)ipOld, (sl_uint16)ipNew);
+		return TCP_IP::adjustChecksum(checksum, portOld, portNew);
+	}
+
+	static void _priv_NatTable_adjustChecksum(UdpDatagram* udp, const IPv4Address& addressOld, const IPv4Address& addressNew, sl_uint16 portOld, sl_uint16 portNew)
+	{
+		sl_uint16 checksum = udp->getChecksum();
+		if (!checksum) {
+			// checksum is not used
+			return;
+		}
+		checksum = _priv_NatTable_adjustChecksum(checksum, addressOld, addressNew, portOld, portNew);
+		if (!checksum) {
+			checksum = 0xFFFF;
+		}
+		udp->setChecksum(checksum);
+	}
+
+	static void _priv_NatTable_adjustChecksum(IcmpHeaderFormat* icmp, sl_uint16 identifierOld, sl_uint16 identifierNew, sl_uint16 sequenceNumberOld, sl_uint16 sequenceNumberNew)
+	{
+		sl_uint16 checksum = TCP_IP::adjustChecksum(icmp->getChecksum(), identifierOld, identifierNew);
+		icmp->setChecksum(TCP_IP::adjustChecksum(checksum, sequenceNumberOld, sequenceNumberNew));
+	}
+
 	NatTableParam::NatTableParam()
 	{
 		targetAddress.setZero();
@@ -76,11 +106,13 @@ namespace slib
 		if (protocol == NetworkInternetProtocol::TCP) {
 			TcpSegment* tcp = (TcpSegment*)(ipContent);
 			if (tcp->check(ipHeader, sizeContent)) {
+				IPv4Address addressSource = ipHeader->getSourceAddress();
+				sl_uint16 portSource = tcp->getSourcePort();
 				sl_uint16 targetPort;
-				if (m_mappingTcp.mapToExternalPort(SocketAddress(ipHeader->getSourceAddress(), tcp->getSourcePort()), targetPort)) {
+				if (m_mappingTcp.mapToExternalPort(SocketAddress(addressSource, portSource), targetPort)) {
 					tcp->setSourcePort(targetPort);
 					ipHeader->setSourceAddress(addressTarget);
-					tcp->updateChecksum(ipHeader, sizeContent);
+					tcp->setChecksum(_priv_NatTable_adjustChecksum(tcp->getChecksum(), addressSource, addressTarget, portSource, targetPort));
 					ipHeader->updateChecksum();
 					return sl_true;
 				}
@@ -88,11 +120,13 @@ namespace slib
 		} else if (protocol == NetworkInternetProtocol::UDP) {
 			UdpDatagram* udp = (UdpDatagram*)(ipContent);
 			if (udp->check(ipHeader, sizeContent)) {
+				IPv4Address addressSource = ipHeader->getSourceAddress();
+				sl_uint16 portSource = udp->getSourcePort();
 				sl_uint16 targetPort;
-				if (m_mappingUdp.mapToExternalPort(SocketAddress(ipHeader->getSourceAddress(), udp->getSourcePort()), targetPort)) {
+				if (m_mappingUdp.mapToExternalPort(SocketAddress(addressSource, portSource), targetPort)) {
 					udp->setSourcePort(targetPort);
 					ipHeader->setSourceAddress(addressTarget);
-					udp->updateChecksum(ipHeader);
+					_priv_NatTable_adjustChecksum(udp, addressSource, addressTarget, portSource, targetPort);
 					ipHeader->updateChecksum();
 					return sl_true;
 				}
@@ -109,7 +143,7 @@ namespace slib
 					icmp->setEchoIdentifier(m_param.icmpEchoIdentifier);
 					icmp->setEchoSequenceNumber(sn);
 					ipHeader->setSourceAddress(addressTarget);
-					icmp->updateChecksum(sizeContent);
+					_priv_NatTable_adjustChecksum(icmp, address.identifier, m_param.icmpEchoIdentifier, address.sequenceNumber, sn);
 					ipHeader->updateChecksum();
 					return sl_true;
 				}
@@ -132,10 +166,12 @@ namespace slib
 			TcpSegment* tcp = (TcpSegment*)(ipContent);
 			if (tcp->check(ipHeader, sizeContent)) {
 				SocketAddress addressSource;
-				if (m_mappingTcp.mapToInternalAddress(tcp->getDestinationPort(), addressSource)) {
-					ipHeader->setDestinationAddress(addressSource.ip.getIPv4());
+				sl_uint16 portTarget = tcp->getDestinationPort();
+				if (m_mappingTcp.mapToInternalAddress(portTarget, addressSource)) {
+					IPv4Address ipSource = addressSource.ip.getIPv4();
+					ipHeader->setDestinationAddress(ipSource);
 					tcp->setDestinationPort(addressSource.port);
-					tcp->updateChecksum(ipHeader, sizeContent);
+					tcp->setChecksum(_priv_NatTable_adjustChecksum(tcp->getChecksum(), addressTarget, ipSource, portTarget, addressSource.port));
 					ipHeader->updateChecksum();
 					return sl_true;
 				}
@@ -144,10 +180,12 @@ namespace slib
 			UdpDatagram* udp = (UdpDatagram*)(ipHeader->getContent());
 			if (udp->check(ipHeader, sizeContent)) {
 				SocketAddress addressSource;
-				if (m_mappingUdp.mapToInternalAddress(udp->getDestinationPort(), addressSource)) {
-					ipHeader->setDestinationAddress(addressSource.ip.getIPv4());
+				sl_uint16 portTarget = udp->getDestinationPort();
+				if (m_mappingUdp.mapToInternalAddress(portTarget, addressSource)) {
+					IPv4Address ipSource = addressSource.ip.getIPv4();
+					ipHeader->setDestinationAddress(ipSource);
 					udp->setDestinationPort(addressSource.port);
-					udp->updateChecksum(ipHeader);
+					_priv_NatTable_adjustChecksum(udp, addressTarget, ipSource, portTarget, addressSource.port);
 					ipHeader->updateChecksum();
 					return sl_true;
 				}
@@ -160,10 +198,11 @@ namespace slib
 					if (icmp->getEchoIdentifier() == m_param.icmpEchoIdentifier) {
 						IcmpEchoElement element;
 						if (m_mapIcmpEchoIncoming.get(icmp->getEchoSequenceNumber(), &element)) {
+							sl_uint16 sn = icmp->getEchoSequenceNumber();
 							ipHeader->setDestinationAddress(element.addressSource.ip);
 							icmp->setEchoIdentifier(element.addressSource.identifier);
 							icmp->setEchoSequenceNumber(element.addressSource.sequenceNumber);
-							icmp->updateChecksum(sizeContent);
+							_priv_NatTable_adjustChecksum(icmp, m_param.icmpEchoIdentifier, element.addressSource.identifier, sn, element.addressSource.sequenceNumber);
 							ipHeader->updateChecksum();
 							return sl_true;
 						}
@@ -45,6 +45,14 @@ namespace slib
 	{
 	}
 	
+	NetCaptureStatistics::NetCaptureStatistics(): countPackets(0), countDrops(0), countFreezes(0)
+	{
+	}
+	
+	NetCaptureStatistics::~NetCaptureStatistics()
+	{
+	}
+	
 	NetCaptureDeviceInfo::NetCaptureDeviceInfo(): flagLoopback(sl_false)
 	{
 	}
@@ -63,6 +71,11 @@ namespace slib
 		
 		preferedLinkDeviceType = NetworkLinkDeviceType::Ethernet;
 		
+		sizeBlock = 0x40000; // 256KB
+		sizeFrame = 2048;
+		countThreads = 1;
+		countSendFrames = 256;
+		
 		flagAutoStart = sl_true;
 	}
 	
@@ -86,19 +99,50 @@ namespace slib
 		return sl_false;
 	}
 	
+	sl_uint32 NetCapture::sendPackets(const NetCapturePacket* packets, sl_uint32 count)
+	{
+		for (sl_uint32 i = 0; i < count; i++) {
+			if (!(sendPacket(packets[i].data, packets[i].length))) {
+				return i;
+			}
+		}
+		return count;
+	}
+	
 	String NetCapture::getLastErrorMessage()
 	{
 		return sl_null;
 	}
 	
+	sl_bool NetCapture::getStatistics(NetCaptureStatistics& _out)
+	{
+		return sl_false;
+	}
+	
 	void NetCapture::_initWithParam(const NetCaptureParam& param)
 	{
 		m_onCapturePacket = param.onCapturePacket;
+		m_onCapturePackets = param.onCapturePackets;
 	}
 	
 	void NetCapture::_onCapturePacket(NetCapturePacket* packet)
 	{
-		m_onCapturePacket(this, packet);
+		if (m_onCapturePackets.isNotNull()) {
+			m_onCapturePackets(this, packet, 1);
+		} else {
+			m_onCapturePacket(this, packet);
+		}
+	}
+	
+	void NetCapture::_onCapturePackets(NetCapturePacket* packets, sl_uint32 count)
+	{
+		if (m_onCapturePackets.isNotNull()) {
+			m_onCapturePackets(this, packets, count);
+		} else {
+			for (sl_uint32 i = 0; i < count; i++) {
+				m_onCapturePacket(this, packets + i);
+			}
+		}
 	}
 	
 	
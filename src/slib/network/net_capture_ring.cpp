@@ -0,0 +1,580 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/network/capture.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+
+#include "slib/core/thread.h"
+#include "slib/core/mutex.h"
+#include "slib/core/log.h"
+#include "slib/network/os.h"
+#include "slib/network/socket.h"
+#include "slib/network/event.h"
+#include "slib/network/ethernet.h"
+
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+#define TAG "NetCapture"
+
+// packets delivered by a callback at most
+#define MAX_BATCH_COUNT 256
+
+namespace slib
+{
+
+	class _priv_NetPacketRing : public Referable
+	{
+	public:
+		Ref<Socket> socket;
+		sl_uint8* memory;
+		sl_size size;
+		sl_uint32 countUnits; // blocks in RX ring, frames in TX ring
+		sl_uint32 sizeUnit;
+		sl_uint32 index;
+		
+	public:
+		_priv_NetPacketRing()
+		{
+			memory = sl_null;
+			size = 0;
+			countUnits = 0;
+			sizeUnit = 0;
+			index = 0;
+		}
+		
+		~_priv_NetPacketRing()
+		{
+			if (memory) {
+				munmap(memory, size);
+			}
+		}
+		
+	public:
+		int getHandle()
+		{
+			return (int)(socket->getHandle());
+		}
+		
+		sl_bool setOption(int option, const void* value, sl_uint32 size)
+		{
+			return setsockopt(getHandle(), SOL_PACKET, option, value, (socklen_t)size) == 0;
+		}
+		
+		sl_bool map(sl_uint32 _countUnits, sl_uint32 _sizeUnit)
+		{
+			size = (sl_size)_countUnits * _sizeUnit;
+			void* p = mmap(sl_null, size, PROT_READ | PROT_WRITE, MAP_SHARED, getHandle(), 0);
+			if (p == MAP_FAILED) {
+				return sl_false;
+			}
+			memory = (sl_uint8*)p;
+			countUnits = _countUnits;
+			sizeUnit = _sizeUnit;
+			return sl_true;
+		}
+		
+		sl_bool bind(sl_uint32 iface, sl_uint16 protocol)
+		{
+			sockaddr_ll addr;
+			Base::zeroMemory(&addr, sizeof(addr));
+			addr.sll_family = AF_PACKET;
+			addr.sll_protocol = htons(protocol);
+			addr.sll_ifindex = (int)iface;
+			return ::bind(getHandle(), (sockaddr*)&addr, sizeof(addr)) == 0;
+		}
+		
+		static Ref<_priv_NetPacketRing> openReceive(NetworkLinkDeviceType deviceType, sl_uint32 iface, sl_uint32 sizeBlock, sl_uint32 countBlocks, sl_uint32 sizeFrame, sl_uint32 timeout)
+		{
+			Ref<Socket> socket;
+			if (deviceType == NetworkLinkDeviceType::Raw) {
+				socket = Socket::openPacketDatagram(NetworkLinkProtocol::All);
+			} else {
+				socket = Socket::openPacketRaw(NetworkLinkProtocol::All);
+			}
+			if (socket.isNull()) {
+				LogError(TAG, "Failed to create Packet socket");
+				return sl_null;
+			}
+			Ref<_priv_NetPacketRing> ring = new _priv_NetPacketRing;
+			if (ring.isNull()) {
+				return sl_null;
+			}
+			ring->socket = socket;
+			int version = TPACKET_V3;
+			if (!(ring->setOption(PACKET_VERSION, &version, sizeof(version)))) {
+				LogError(TAG, "TPACKET_V3 is not supported");
+				return sl_null;
+			}
+			tpacket_req3 req;
+			Base::zeroMemory(&req, sizeof(req));
+			req.tp_block_size = sizeBlock;
+			req.tp_block_nr = countBlocks;
+			req.tp_frame_size = sizeFrame;
+			req.tp_frame_nr = (sizeBlock / sizeFrame) * countBlocks;
+			req.tp_retire_blk_tov = timeout;
+			req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+			if (!(ring->setOption(PACKET_RX_RING, &req, sizeof(req)))) {
+				LogError(TAG, "Failed to set RX ring: block size=%d, blocks=%d, frame size=%d", sizeBlock, countBlocks, sizeFrame);
+				return sl_null;
+			}
+			if (!(ring->map(countBlocks, sizeBlock))) {
+				LogError(TAG, "Failed to map RX ring");
+				return sl_null;
+			}
+			if (!(ring->bind(iface, ETH_P_ALL))) {
+				LogError(TAG, "Failed to bind the Packet socket");
+				return sl_null;
+			}
+			return ring;
+		}
+		
+		static Ref<_priv_NetPacketRing> openSend(sl_uint32 iface, sl_uint32 sizeFrame, sl_uint32 countFrames)
+		{
+			// protocol 0: the socket does not receive packets
+			Ref<Socket> socket = Socket::openPacketRaw((NetworkLinkProtocol)0);
+			if (socket.isNull()) {
+				return sl_null;
+			}
+			Ref<_priv_NetPacketRing> ring = new _priv_NetPacketRing;
+			if (ring.isNull()) {
+				return sl_null;
+			}
+			ring->socket = socket;
+			// TX ring of TPACKET_V3 requires Linux 4.11, so uses TPACKET_V2 frames
+			int version = TPACKET_V2;
+			if (!(ring->setOption(PACKET_VERSION, &version, sizeof(version)))) {
+				return sl_null;
+			}
+			sl_uint32 sizePage = (sl_uint32)(getpagesize());
+			sl_uint32 sizeBlock = (sizeFrame + sizePage - 1) / sizePage * sizePage;
+			sl_uint32 nFramesPerBlock = sizeBlock / sizeFrame;
+			sl_uint32 countBlocks = (countFrames + nFramesPerBlock - 1) / nFramesPerBlock;
+			tpacket_req req;
+			Base::zeroMemory(&req, sizeof(req));
+			req.tp_block_size = sizeBlock;
+			req.tp_block_nr = countBlocks;
+			req.tp_frame_size = sizeFrame;
+			req.tp_frame_nr = countBlocks * nFramesPerBlock;
+			if (!(ring->setOption(PACKET_TX_RING, &req, sizeof(req)))) {
+				return sl_null;
+			}
+			// frames are contiguous because the block size is a multiple of the frame size
+			if (sizeBlock % sizeFrame) {
+				return sl_null;
+			}
+			if (!(ring->map(req.tp_frame_nr, sizeFrame))) {
+				return sl_null;
+			}
+			if (!(ring->bind(iface, 0))) {
+				return sl_null;
+			}
+			return ring;
+		}
+		
+	};
+
+	class _priv_NetPacketRingCapture : public NetCapture
+	{
+	public:
+		CList< Ref<_priv_NetPacketRing> > m_ringsReceive;
+		CList< Ref<Thread> > m_threads;
+		
+		Ref<_priv_NetPacketRing> m_ringSend;
+		Mutex m_lockSend;
+		
+		NetworkLinkDeviceType m_deviceType;
+		sl_uint32 m_ifaceIndex;
+		
+		NetCaptureStatistics m_statistics;
+		Mutex m_lockStatistics;
+		
+		sl_bool m_flagInit;
+		sl_bool m_flagRunning;
+		
+	public:
+		_priv_NetPacketRingCapture()
+		{
+			m_deviceType = NetworkLinkDeviceType::Ethernet;
+			m_ifaceIndex = 0;
+			
+			m_flagInit = sl_false;
+			m_flagRunning = sl_false;
+		}
+		
+		~_priv_NetPacketRingCapture()
+		{
+			release();
+		}
+		
+	public:
+		static Ref<_priv_NetPacketRingCapture> create(const NetCaptureParam& param)
+		{
+			sl_uint32 iface = 0;
+			String deviceName = param.deviceName;
+			if (deviceName.isNotEmpty()) {
+				iface = Network::getInterfaceIndexFromName(deviceName);
+				if (iface == 0) {
+					LogError(TAG, "Failed to find the interface index of device: %s", deviceName);
+					return sl_null;
+				}
+			}
+			NetworkLinkDeviceType deviceType = param.preferedLinkDeviceType;
+			if (deviceType != NetworkLinkDeviceType::Raw) {
+				deviceType = NetworkLinkDeviceType::Ethernet;
+			}
+			
+			sl_uint32 sizePage = (sl_uint32)(getpagesize());
+			sl_uint32 sizeBlock = (param.sizeBlock + sizePage - 1) / sizePage * sizePage;
+			if (!sizeBlock) {
+				sizeBlock = sizePage;
+			}
+			sl_uint32 sizeFrame = TPACKET_ALIGN(param.sizeFrame);
+			if (sizeFrame < TPACKET_ALIGN(TPACKET3_HDRLEN)) {
+				sizeFrame = TPACKET_ALIGN(TPACKET3_HDRLEN);
+			}
+			if (sizeFrame > sizeBlock) {
+				sizeFrame = sizeBlock;
+			}
+			sl_uint32 countBlocks = param.sizeBuffer / sizeBlock;
+			if (countBlocks < 2) {
+				countBlocks = 2;
+			}
+			sl_uint32 countThreads = param.countThreads;
+			if (countThreads < 1) {
+				countThreads = 1;
+			}
+			
+			Ref<_priv_NetPacketRingCapture> ret = new _priv_NetPacketRingCapture;
+			if (ret.isNull()) {
+				return sl_null;
+			}
+			ret->_initWithParam(param);
+			ret->m_deviceType = deviceType;
+			ret->m_ifaceIndex = iface;
+			
+			static sl_int32 idFanoutLast = 0;
+			sl_uint32 idFanout = ((sl_uint32)getpid() + (sl_uint32)(Base::interlockedIncrement32(&idFanoutLast))) & 0xFFFF;
+			
+			for (sl_uint32 i = 0; i < countThreads; i++) {
+				Ref<_priv_NetPacketRing> ring = _priv_NetPacketRing::openReceive(deviceType, iface, sizeBlock, countBlocks, sizeFrame, param.timeoutRead);
+				if (ring.isNull()) {
+					return sl_null;
+				}
+				if (!i && iface > 0 && param.flagPromiscuous) {
+					if (!(ring->socket->setPromiscuousMode(deviceName, sl_true))) {
+						Log(TAG, "Failed to set promiscuous mode to the network device: %s", deviceName);
+					}
+				}
+				if (countThreads > 1) {
+					// distributes the flows of the device to the rings
+					int fanout = (int)(idFanout | ((PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << 16));
+					if (!(ring->setOption(PACKET_FANOUT, &fanout, sizeof(fanout)))) {
+						LogError(TAG, "Failed to join PACKET_FANOUT group");
+						return sl_null;
+					}
+				}
+				Ref<Thread> thread = Thread::create(SLIB_BIND_CLASS(void(), _priv_NetPacketRingCapture, _run, ret.get(), i));
+				if (thread.isNull()) {
+					LogError(TAG, "Failed to create thread");
+					return sl_null;
+				}
+				ret->m_ringsReceive.add_NoLock(ring);
+				ret->m_threads.add_NoLock(thread);
+			}
+			
+			if (param.countSendFrames > 0 && iface > 0 && deviceType == NetworkLinkDeviceType::Ethernet) {
+				sl_uint32 sizeSendFrame = TPACKET_ALIGN(param.sizeFrame);
+				if (sizeSendFrame < TPACKET_ALIGN(TPACKET2_HDRLEN + EthernetFrame::HeaderSize)) {
+					sizeSendFrame = TPACKET_ALIGN(TPACKET2_HDRLEN + EthernetFrame::HeaderSize);
+				}
+				ret->m_ringSend = _priv_NetPacketRing::openSend(iface, sizeSendFrame, param.countSendFrames);
+				if (ret->m_ringSend.isNull()) {
+					Log(TAG, "Failed to create TX ring, packets are sent by the socket");
+				}
+			}
+			
+			ret->m_flagInit = sl_true;
+			if (param.flagAutoStart) {
+				ret->start();
+			}
+			return ret;
+		}
+		
+		void release()
+		{
+			ObjectLocker lock(this);
+			if (!m_flagInit) {
+				return;
+			}
+			m_flagInit = sl_false;
+			
+			m_flagRunning = sl_false;
+			ListElements< Ref<Thread> > threads(m_threads);
+			for (sl_size i = 0; i < threads.count; i++) {
+				threads[i]->finish();
+			}
+			for (sl_size i = 0; i < threads.count; i++) {
+				threads[i]->finishAndWait();
+			}
+			m_threads.removeAll_NoLock();
+			
+			_updateStatistics();
+			m_ringsReceive.removeAll_NoLock();
+			
+			MutexLocker lockSend(&m_lockSend);
+			m_ringSend.setNull();
+		}
+		
+		void start()
+		{
+			ObjectLocker lock(this);
+			if (!m_flagInit) {
+				return;
+			}
+			
+			if (m_flagRunning) {
+				return;
+			}
+			ListElements< Ref<Thread> > threads(m_threads);
+			for (sl_size i = 0; i < threads.count; i++) {
+				if (threads[i]->start()) {
+					m_flagRunning = sl_true;
+				}
+			}
+		}
+		
+		sl_bool isRunning()
+		{
+			return m_flagRunning;
+		}
+		
+		void _run(sl_uint32 indexRing)
+		{
+			Ref<_priv_NetPacketRing> ring = m_ringsReceive.getValueAt_NoLock(indexRing);
+			if (ring.isNull()) {
+				return;
+			}
+			Ref<Socket> socket = ring->socket;
+			socket->setNonBlockingMode(sl_true);
+			Ref<SocketEvent> event = SocketEvent::createRead(socket);
+			if (event.isNull()) {
+				return;
+			}
+			
+			NetCapturePacket packets[MAX_BATCH_COUNT];
+			
+			while (Thread::isNotStoppingCurrent()) {
+				tpacket_block_desc* block = (tpacket_block_desc*)(ring->memory + (sl_size)(ring->index) * ring->sizeUnit);
+				if (!(__atomic_load_n(&(block->hdr.bh1.block_status), __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+					event->wait(500);
+					continue;
+				}
+				
+				sl_uint32 nPackets = block->hdr.bh1.num_pkts;
+				sl_uint8* p = (sl_uint8*)block + block->hdr.bh1.offset_to_first_pkt;
+				sl_uint32 n = 0;
+				for (sl_uint32 i = 0; i < nPackets; i++) {
+					tpacket3_hdr* hdr = (tpacket3_hdr*)p;
+					NetCapturePacket& packet = packets[n];
+					packet.data = p + hdr->tp_mac;
+					packet.length = hdr->tp_snaplen;
+					sl_uint64 t = hdr->tp_sec;
+					t = t * 1000000 + hdr->tp_nsec / 1000;
+					packet.time = t;
+					n++;
+					if (n >= MAX_BATCH_COUNT) {
+						_onCapturePackets(packets, n);
+						n = 0;
+					}
+					p += hdr->tp_next_offset;
+				}
+				if (n) {
+					_onCapturePackets(packets, n);
+				}
+				
+				__atomic_store_n(&(block->hdr.bh1.block_status), TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+				ring->index = (ring->index + 1) % ring->countUnits;
+			}
+		}
+		
+		NetworkLinkDeviceType getLinkType()
+		{
+			return m_deviceType;
+		}
+		
+		sl_bool sendPacket(const void* buf, sl_uint32 size)
+		{
+			NetCapturePacket packet;
+			packet.data = (sl_uint8*)buf;
+			packet.length = size;
+			return sendPackets(&packet, 1) == 1;
+		}
+		
+		sl_uint32 sendPackets(const NetCapturePacket* packets, sl_uint32 count)
+		{
+			if (m_ifaceIndex == 0) {
+				return 0;
+			}
+			if (!m_flagInit) {
+				return 0;
+			}
+			MutexLocker lock(&m_lockSend);
+			Ref<_priv_NetPacketRing> ring = m_ringSend;
+			if (ring.isNull()) {
+				for (sl_uint32 i = 0; i < count; i++) {
+					if (!(_sendBySocket(packets[i].data, packets[i].length))) {
+						return i;
+					}
+				}
+				return count;
+			}
+			sl_uint32 offset = TPACKET2_HDRLEN - sizeof(sockaddr_ll);
+			sl_uint32 nQueued = 0;
+			sl_uint32 i = 0;
+			for (; i < count; i++) {
+				const NetCapturePacket& packet = packets[i];
+				if (offset + packet.length <= ring->sizeUnit) {
+					if (!(_putToRing(ring.get(), offset, packet.data, packet.length))) {
+						break;
+					}
+					nQueued++;
+				} else {
+					// larger than the frame: the queued frames are sent first, to keep the order
+					if (nQueued) {
+						_flushRing(ring.get());
+						nQueued = 0;
+					}
+					if (!(_sendBySocket(packet.data, packet.length))) {
+						break;
+					}
+				}
+			}
+			if (nQueued) {
+				_flushRing(ring.get());
+			}
+			return i;
+		}
+		
+		sl_bool _sendBySocket(const void* buf, sl_uint32 size)
+		{
+			Ref<_priv_NetPacketRing> ring = m_ringsReceive.getValueAt(0);
+			if (ring.isNull()) {
+				return sl_false;
+			}
+			L2PacketInfo info;
+			info.type = L2PacketType::OutGoing;
+			info.iface = m_ifaceIndex;
+			if (m_deviceType == NetworkLinkDeviceType::Ethernet) {
+				EthernetFrame* frame = (EthernetFrame*)buf;
+				if (size < EthernetFrame::HeaderSize) {
+					return sl_false;
+				}
+				info.protocol = frame->getProtocol();
+				info.setMacAddress(frame->getDestinationAddress());
+			} else {
+				info.protocol = NetworkLinkProtocol::IPv4;
+				info.clearAddress();
+			}
+			sl_uint32 ret = ring->socket->sendPacket(buf, size, info);
+			return ret == size;
+		}
+		
+		// queues the frame without a system call. the queued frames are sent by `_flushRing()`
+		static sl_bool _putToRing(_priv_NetPacketRing* ring, sl_uint32 offset, const void* buf, sl_uint32 size)
+		{
+			tpacket2_hdr* hdr = (tpacket2_hdr*)(ring->memory + (sl_size)(ring->index) * ring->sizeUnit);
+			sl_uint32 status = __atomic_load_n(&(hdr->tp_status), __ATOMIC_ACQUIRE);
+			if (status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) {
+				// ring is full: lets the kernel complete the pending frames
+				_flushRing(ring);
+				status = __atomic_load_n(&(hdr->tp_status), __ATOMIC_ACQUIRE);
+				if (status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) {
+					return sl_false;
+				}
+			}
+			Base::copyMemory((sl_uint8*)hdr + offset, buf, size);
+			hdr->tp_len = size;
+			__atomic_store_n(&(hdr->tp_status), TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+			ring->index = (ring->index + 1) % ring->countUnits;
+			return sl_true;
+		}
+		
+		static void _flushRing(_priv_NetPacketRing* ring)
+		{
+			send(ring->getHandle(), sl_null, 0, MSG_DONTWAIT);
+		}
+		
+		sl_bool getStatistics(NetCaptureStatistics& _out)
+		{
+			ObjectLocker lock(this);
+			_updateStatistics();
+			MutexLocker lockStatistics(&m_lockStatistics);
+			_out = m_statistics;
+			return sl_true;
+		}
+		
+		void _updateStatistics()
+		{
+			// PACKET_STATISTICS resets the counters of the socket on every read
+			MutexLocker lock(&m_lockStatistics);
+			ListElements< Ref<_priv_NetPacketRing> > rings(m_ringsReceive);
+			for (sl_size i = 0; i < rings.count; i++) {
+				tpacket_stats_v3 stats;
+				Base::zeroMemory(&stats, sizeof(stats));
+				socklen_t len = sizeof(stats);
+				if (getsockopt(rings[i]->getHandle(), SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0) {
+					m_statistics.countPackets += stats.tp_packets;
+					m_statistics.countDrops += stats.tp_drops;
+					m_statistics.countFreezes += stats.tp_freeze_q_cnt;
+				}
+			}
+		}
+		
+	};
+	
+	Ref<NetCapture> NetCapture::createPacketRing(const NetCaptureParam& param)
+	{
+		return _priv_NetPacketRingCapture::create(param);
+	}
+	
+}
+
+#else
+
+namespace slib
+{
+	
+	Ref<NetCapture> NetCapture::createPacketRing(const NetCaptureParam& param)
+	{
+		return sl_null;
+	}
+	
+}
+
+#endif
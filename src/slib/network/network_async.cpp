@@ -472,6 +472,8 @@ namespace slib
 	AsyncUdpSocketInstance::AsyncUdpSocketInstance()
 	{
 		m_flagRunning = sl_false;
+		m_sizeBatch = 1;
+		m_flagGro = sl_false;
 	}
 
 	AsyncUdpSocketInstance::~AsyncUdpSocketInstance()
@@ -505,13 +507,14 @@ namespace slib
 
 #define UDP_QUEUE_MAX_SIZE 1024000
 
-	sl_bool AsyncUdpSocketInstance::sendTo(const SocketAddress& addressTo, const Memory& data)
+	sl_bool AsyncUdpSocketInstance::sendTo(const SocketAddress& addressTo, const Memory& data, sl_uint32 segmentSize)
 	{
 		if (isOpened()) {
 			if (data.isNotNull()) {
 				SendRequest request;
 				request.addressTo = addressTo;
 				request.data = data;
+				request.segmentSize = segmentSize;
 				if (m_queueSendRequests.getCount() < UDP_QUEUE_MAX_SIZE) {
 					if (m_queueSendRequests.push(request)) {
 						return sl_true;
@@ -522,6 +525,34 @@ namespace slib
 		return sl_false;
 	}
 
+	void AsyncUdpSocketInstance::setBatchMode(sl_uint32 batchSize, sl_bool flagGro)
+	{
+		if (batchSize < 1) {
+			batchSize = 1;
+		}
+		m_sizeBatch = batchSize;
+		m_flagGro = flagGro;
+	}
+
+	void AsyncUdpSocketInstance::_sendSegments(Socket* socket, const SendRequest& request)
+	{
+		sl_uint8* data = (sl_uint8*)(request.data.getData());
+		sl_uint32 size = (sl_uint32)(request.data.getSize());
+		sl_uint32 segment = request.segmentSize;
+		if (!segment) {
+			segment = size;
+		}
+		sl_uint32 offset = 0;
+		do {
+			sl_uint32 n = size - offset;
+			if (n > segment) {
+				n = segment;
+			}
+			socket->sendTo(request.addressTo, data + offset, n);
+			offset += n;
+		} while (offset < size);
+	}
+
 	void AsyncUdpSocketInstance::_onReceive(const SocketAddress& address, sl_uint32 size)
 	{
 		Ref<AsyncUdpSocket> object = Ref<AsyncUdpSocket>::from(getObject());
@@ -530,6 +561,14 @@ namespace slib
 		}
 	}
 
+	void AsyncUdpSocketInstance::_onReceiveBatch(AsyncUdpDatagram* datagrams, sl_uint32 count)
+	{
+		Ref<AsyncUdpSocket> object = Ref<AsyncUdpSocket>::from(getObject());
+		if (object.isNotNull()) {
+			object->_onReceiveBatch(datagrams, count);
+		}
+	}
+
 
 	AsyncUdpSocketParam::AsyncUdpSocketParam()
 	{
@@ -538,6 +577,8 @@ namespace slib
 		flagAutoStart = sl_false;
 		flagLogError = sl_false;
 		packetSize = 65536;
+		batchSize = 1;
+		flagGro = sl_false;
 	}
 
 	AsyncUdpSocketParam::~AsyncUdpSocketParam()
@@ -596,9 +637,20 @@ namespace slib
 		if (param.flagBroadcast) {
 			socket->setOption_Broadcast(sl_true);
 		}
+		sl_bool flagGro = sl_false;
+		if (param.flagGro) {
+			flagGro = socket->setOption_UdpGro(sl_true);
+		}
 		
-		Ref<AsyncUdpSocketInstance> instance = _createInstance(socket, param.packetSize);
+		sl_uint32 packetSize = param.packetSize;
+		if (flagGro && packetSize < 65536) {
+			// coalesced datagrams are truncated by smaller buffers
+			packetSize = 65536;
+		}
+		
+		Ref<AsyncUdpSocketInstance> instance = _createInstance(socket, packetSize);
 		if (instance.isNotNull()) {
+			instance->setBatchMode(param.batchSize, flagGro);
 			Ref<AsyncIoLoop> loop = param.ioLoop;
 			if (loop.isNull()) {
 				loop = AsyncIoLoop::getDefault();
@@ -609,6 +661,7 @@ namespace slib
 			Ref<AsyncUdpSocket> ret = new AsyncUdpSocket;
 			if (ret.isNotNull()) {
 				ret->m_onReceiveFrom = param.onReceiveFrom;
+				ret->m_onReceiveBatch = param.onReceiveBatch;
 				instance->setObject(ret.get());
 				ret->setIoInstance(instance.get());
 				ret->setIoLoop(loop);
@@ -705,6 +758,25 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncUdpSocket::sendToSegments(const SocketAddress& addressTo, const Memory& mem, sl_uint32 segmentSize)
+	{
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncUdpSocketInstance> instance = _getIoInstance();
+		if (instance.isNotNull()) {
+			if (segmentSize >= mem.getSize()) {
+				segmentSize = 0;
+			}
+			if (instance->sendTo(addressTo, mem, segmentSize)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
 	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_getIoInstance()
 	{
 		return Ref<AsyncUdpSocketInstance>::from(AsyncIoObject::getIoInstance());
@@ -712,7 +784,26 @@ namespace slib
 
 	void AsyncUdpSocket::_onReceive(const SocketAddress& address, void* data, sl_uint32 sizeReceived)
 	{
-		m_onReceiveFrom(this, address, data, sizeReceived);
+		if (m_onReceiveBatch.isNotNull()) {
+			AsyncUdpDatagram datagram;
+			datagram.address = address;
+			datagram.data = data;
+			datagram.size = sizeReceived;
+			m_onReceiveBatch(this, &datagram, 1);
+		} else {
+			m_onReceiveFrom(this, address, data, sizeReceived);
+		}
+	}
+
+	void AsyncUdpSocket::_onReceiveBatch(AsyncUdpDatagram* datagrams, sl_uint32 count)
+	{
+		if (m_onReceiveBatch.isNotNull()) {
+			m_onReceiveBatch(this, datagrams, count);
+		} else {
+			for (sl_uint32 i = 0; i < count; i++) {
+				m_onReceiveFrom(this, datagrams[i].address, datagrams[i].data, datagrams[i].size);
+			}
+		}
 	}
 
 }
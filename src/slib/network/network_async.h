@@ -109,24 +109,37 @@ namespace slib
 		
 		Ref<Socket> getSocket();
 		
-		sl_bool sendTo(const SocketAddress& address, const Memory& data);
+		sl_bool sendTo(const SocketAddress& address, const Memory& data, sl_uint32 segmentSize = 0);
+
+		// called before the instance is started
+		void setBatchMode(sl_uint32 batchSize, sl_bool flagGro);
 		
 	protected:
 		void _onReceive(const SocketAddress& address, sl_uint32 size);
+
+		void _onReceiveBatch(AsyncUdpDatagram* datagrams, sl_uint32 count);
 		
 	protected:
 		AtomicRef<Socket> m_socket;
 
 		sl_bool m_flagRunning;
 		Memory m_buffer;
+		sl_uint32 m_sizeBatch;
+		sl_bool m_flagGro;
 		
 		struct SendRequest
 		{
 			SocketAddress addressTo;
 			Memory data;
+			// 0: single datagram
+			sl_uint32 segmentSize;
 		};
 		LinkedQueue<SendRequest> m_queueSendRequests;
 		
+	protected:
+		// sends the segments of the request one by one
+		static void _sendSegments(Socket* socket, const SendRequest& request);
+		
 	};
 	
 }
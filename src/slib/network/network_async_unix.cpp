@@ -26,6 +26,25 @@
 
 #include "network_async.h"
 
+#if defined(SLIB_PLATFORM_IS_LINUX) && !defined(SLIB_PLATFORM_IS_ANDROID)
+#	define PRIV_UDP_BATCH
+#	include <sys/socket.h>
+#	include <netinet/in.h>
+#	include <errno.h>
+#	ifndef SOL_UDP
+#		define SOL_UDP 17
+#	endif
+#	ifndef UDP_SEGMENT
+#		define UDP_SEGMENT 103
+#	endif
+#	ifndef UDP_GRO
+#		define UDP_GRO 104
+#	endif
+// UDP_SEGMENT accepts up to 64 segments per call
+#	define PRIV_UDP_GSO_MAX_SEGMENTS 64
+#	define PRIV_UDP_GSO_MAX_SIZE 65000
+#endif
+
 namespace slib
 {
 
@@ -85,7 +104,8 @@ namespace slib
 			Ref<AsyncStreamRequest> request = m_requestReading;
 			m_requestReading.setNull();
 			sl_size nQueue = getReadRequestsCount();
-			if (Thread::isNotStoppingCurrent()) {
+			// edge-triggered: all the queued requests are processed until the socket would block
+			while (Thread::isNotStoppingCurrent()) {
 				if (request.isNull()) {
 					if (nQueue > 0) {
 						nQueue--;
@@ -128,7 +148,8 @@ namespace slib
 			Ref<AsyncStreamRequest> request = m_requestWriting;
 			m_requestWriting.setNull();
 			sl_size nQueue = getWriteRequestsCount();
-			if (Thread::isNotStoppingCurrent()) {
+			// edge-triggered: all the queued requests are processed until the socket would block
+			while (Thread::isNotStoppingCurrent()) {
 				if (request.isNull()) {
 					if (nQueue > 0) {
 						nQueue--;
@@ -151,6 +172,7 @@ namespace slib
 							_onSend(request.get(), request->size, flagError);
 						} else {
 							m_requestWriting = request;
+							return;
 						}
 					} else if (n < 0) {
 						_onSend(request.get(), m_sizeWritten, sl_true);
@@ -312,11 +334,75 @@ namespace slib
 		return _priv_Unix_AsyncTcpServerInstance::create(socket);
 	}
 
+#if defined(PRIV_UDP_BATCH)
+	class _priv_Linux_UdpMessages
+	{
+	public:
+		sl_uint32 count;
+		mmsghdr* headers;
+		iovec* vectors;
+		sockaddr_storage* addresses;
+		sl_uint8* controls;
+		sl_uint32 sizeControl;
+		Memory memory;
+		
+	public:
+		_priv_Linux_UdpMessages()
+		{
+			count = 0;
+			sizeControl = (sl_uint32)(CMSG_SPACE(sizeof(int)));
+		}
+		
+	public:
+		sl_bool create(sl_uint32 _count)
+		{
+			sl_size sizeHeaders = sizeof(mmsghdr) * _count;
+			sl_size sizeVectors = sizeof(iovec) * _count;
+			sl_size sizeAddresses = sizeof(sockaddr_storage) * _count;
+			memory = Memory::create(sizeHeaders + sizeVectors + sizeAddresses + sizeControl * _count);
+			if (memory.isNull()) {
+				return sl_false;
+			}
+			sl_uint8* p = (sl_uint8*)(memory.getData());
+			Base::zeroMemory(p, memory.getSize());
+			headers = (mmsghdr*)p;
+			vectors = (iovec*)(p + sizeHeaders);
+			addresses = (sockaddr_storage*)(p + sizeHeaders + sizeVectors);
+			controls = p + sizeHeaders + sizeVectors + sizeAddresses;
+			for (sl_uint32 i = 0; i < _count; i++) {
+				msghdr& msg = headers[i].msg_hdr;
+				msg.msg_name = addresses + i;
+				msg.msg_iov = vectors + i;
+				msg.msg_iovlen = 1;
+				msg.msg_control = controls + sizeControl * i;
+			}
+			count = _count;
+			return sl_true;
+		}
+		
+	};
+#endif
+
 	class _priv_Unix_AsyncUdpSocketInstance : public AsyncUdpSocketInstance
 	{
+	public:
+#if defined(PRIV_UDP_BATCH)
+		_priv_Linux_UdpMessages m_messagesReceive;
+		_priv_Linux_UdpMessages m_messagesSend;
+		Memory m_bufferBatch;
+		Array<AsyncUdpDatagram> m_datagrams;
+		Array<SendRequest> m_requestsSend;
+		sl_bool m_flagGsoChecked;
+		sl_bool m_flagGsoUnsupported;
+#endif
+		
 	public:
 		_priv_Unix_AsyncUdpSocketInstance()
 		{
+#if defined(PRIV_UDP_BATCH)
+			m_flagGsoChecked = sl_false;
+			m_flagGsoUnsupported = sl_false;
+#endif
 		}
 		
 		~_priv_Unix_AsyncUdpSocketInstance()
@@ -374,16 +460,160 @@ namespace slib
 			if (!(socket->isOpened())) {
 				return;
 			}
+#if defined(PRIV_UDP_BATCH)
+			if (m_sizeBatch > 1) {
+				if (processSendBatch(socket.get())) {
+					return;
+				}
+			}
+#endif
 			while (Thread::isNotStoppingCurrent()) {
 				SendRequest request;
 				if (m_queueSendRequests.pop(&request)) {
-					socket->sendTo(request.addressTo, request.data.getData(), (sl_uint32)(request.data.getSize()));
+#if defined(PRIV_UDP_BATCH)
+					if (_sendGso(socket.get(), request)) {
+						continue;
+					}
+#endif
+					_sendSegments(socket.get(), request);
 				} else {
 					break;
 				}
 			}
 		}
 		
+#if defined(PRIV_UDP_BATCH)
+		sl_bool processSendBatch(Socket* socket)
+		{
+			sl_uint32 nBatch = m_sizeBatch;
+			if (!(m_messagesSend.count)) {
+				if (!(m_messagesSend.create(nBatch))) {
+					return sl_false;
+				}
+				m_requestsSend = Array<SendRequest>::create(nBatch);
+				if (m_requestsSend.isNull()) {
+					return sl_false;
+				}
+			}
+			int fd = (int)(socket->getHandle());
+			SendRequest* requests = m_requestsSend.getData();
+			mmsghdr* headers = m_messagesSend.headers;
+			while (Thread::isNotStoppingCurrent()) {
+				sl_uint32 nRequests = 0;
+				SendRequest requestSegments;
+				sl_bool flagSegments = sl_false;
+				while (nRequests < nBatch) {
+					SendRequest& request = requests[nRequests];
+					if (!(m_queueSendRequests.pop(&request))) {
+						break;
+					}
+					if (request.segmentSize && !(_isGsoAvailable(request))) {
+						// split after the datagrams batched before it, to keep the order
+						requestSegments = request;
+						request.data.setNull();
+						flagSegments = sl_true;
+						break;
+					}
+					_setSendMessage(headers[nRequests].msg_hdr, request);
+					nRequests++;
+				}
+				if (!nRequests && !flagSegments) {
+					break;
+				}
+				sl_uint32 nSent = 0;
+				while (nSent < nRequests) {
+					int n = sendmmsg(fd, headers + nSent, nRequests - nSent, MSG_DONTWAIT);
+					if (n > 0) {
+						if (!m_flagGsoChecked) {
+							for (int i = 0; i < n; i++) {
+								if (requests[nSent + i].segmentSize) {
+									m_flagGsoChecked = sl_true;
+									break;
+								}
+							}
+						}
+						nSent += n;
+					} else {
+						_onSendError(socket, requests[nSent]);
+						nSent++;
+					}
+				}
+				for (sl_uint32 i = 0; i < nRequests; i++) {
+					requests[i].data.setNull();
+				}
+				if (flagSegments) {
+					_sendSegments(socket, requestSegments);
+				}
+			}
+			return sl_true;
+		}
+
+		sl_bool _isGsoAvailable(SendRequest& request)
+		{
+			sl_size size = request.data.getSize();
+			return !m_flagGsoUnsupported && size <= PRIV_UDP_GSO_MAX_SIZE && size <= request.segmentSize * PRIV_UDP_GSO_MAX_SEGMENTS;
+		}
+
+		// UDP_SEGMENT is attached to the segmented requests
+		static void _setSendMessage(msghdr& msg, SendRequest& request)
+		{
+			msg.msg_namelen = request.addressTo.getSystemSocketAddress(msg.msg_name);
+			msg.msg_iov->iov_base = request.data.getData();
+			msg.msg_iov->iov_len = request.data.getSize();
+			if (request.segmentSize) {
+				msg.msg_controllen = CMSG_SPACE(sizeof(sl_uint16));
+				cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+				cmsg->cmsg_level = SOL_UDP;
+				cmsg->cmsg_type = UDP_SEGMENT;
+				cmsg->cmsg_len = CMSG_LEN(sizeof(sl_uint16));
+				*((sl_uint16*)(CMSG_DATA(cmsg))) = (sl_uint16)(request.segmentSize);
+			} else {
+				msg.msg_controllen = 0;
+			}
+			msg.msg_flags = 0;
+		}
+
+		// sends a segmented request by a single system call when batching is disabled
+		sl_bool _sendGso(Socket* socket, SendRequest& request)
+		{
+			if (!(request.segmentSize) || !(_isGsoAvailable(request))) {
+				return sl_false;
+			}
+			if (!(m_messagesSend.count)) {
+				if (!(m_messagesSend.create(1))) {
+					return sl_false;
+				}
+			}
+			msghdr& msg = m_messagesSend.headers[0].msg_hdr;
+			_setSendMessage(msg, request);
+			if (sendmsg((int)(socket->getHandle()), &msg, MSG_DONTWAIT) >= 0) {
+				m_flagGsoChecked = sl_true;
+			} else {
+				_onSendError(socket, request);
+			}
+			return sl_true;
+		}
+
+		// like a single `sendTo`, the failed datagram is dropped
+		void _onSendError(Socket* socket, SendRequest& request)
+		{
+			if (!(request.segmentSize)) {
+				return;
+			}
+			int err = errno;
+			if (err == EINVAL || err == EOPNOTSUPP || err == EIO) {
+				// GSO is disabled only when the first attempt fails, not by the errors after it has worked
+				if (!m_flagGsoChecked) {
+					m_flagGsoUnsupported = sl_true;
+					m_flagGsoChecked = sl_true;
+				}
+				_sendSegments(socket, request);
+			} else if (err != EAGAIN && err != EWOULDBLOCK && err != ENOBUFS) {
+				m_flagGsoChecked = sl_true;
+			}
+		}
+#endif
+		
 		void processReceive()
 		{
 			Ref<Socket> socket = m_socket;
@@ -393,6 +623,13 @@ namespace slib
 			if (!(socket->isOpened())) {
 				return;
 			}
+#if defined(PRIV_UDP_BATCH)
+			if (m_sizeBatch > 1 || m_flagGro) {
+				if (processReceiveBatch(socket.get())) {
+					return;
+				}
+			}
+#endif
 			void* buf = m_buffer.getData();
 			sl_uint32 sizeBuf = (sl_uint32)(m_buffer.getSize());
 			while (Thread::isNotStoppingCurrent()) {
@@ -405,6 +642,93 @@ namespace slib
 				}
 			}
 		}
+		
+#if defined(PRIV_UDP_BATCH)
+		sl_bool processReceiveBatch(Socket* socket)
+		{
+			sl_uint32 nBatch = m_sizeBatch;
+			sl_uint32 sizePacket = (sl_uint32)(m_buffer.getSize());
+			if (!(m_messagesReceive.count)) {
+				if (!(m_messagesReceive.create(nBatch))) {
+					return sl_false;
+				}
+				m_bufferBatch = Memory::create(sizePacket * nBatch);
+				if (m_bufferBatch.isNull()) {
+					return sl_false;
+				}
+				m_datagrams = Array<AsyncUdpDatagram>::create(m_flagGro ? nBatch + PRIV_UDP_GSO_MAX_SEGMENTS : nBatch);
+				if (m_datagrams.isNull()) {
+					return sl_false;
+				}
+				sl_uint8* buf = (sl_uint8*)(m_bufferBatch.getData());
+				for (sl_uint32 i = 0; i < nBatch; i++) {
+					m_messagesReceive.vectors[i].iov_base = buf + sizePacket * i;
+					m_messagesReceive.vectors[i].iov_len = sizePacket;
+				}
+			}
+			int fd = (int)(socket->getHandle());
+			mmsghdr* headers = m_messagesReceive.headers;
+			AsyncUdpDatagram* datagrams = m_datagrams.getData();
+			sl_uint32 nDatagramsMax = (sl_uint32)(m_datagrams.getCount());
+			while (Thread::isNotStoppingCurrent()) {
+				for (sl_uint32 i = 0; i < nBatch; i++) {
+					msghdr& msg = headers[i].msg_hdr;
+					msg.msg_namelen = sizeof(sockaddr_storage);
+					msg.msg_controllen = m_flagGro ? m_messagesReceive.sizeControl : 0;
+					msg.msg_flags = 0;
+				}
+				int nReceived = recvmmsg(fd, headers, nBatch, MSG_DONTWAIT, sl_null);
+				if (nReceived <= 0) {
+					break;
+				}
+				sl_uint32 nDatagrams = 0;
+				for (int i = 0; i < nReceived; i++) {
+					msghdr& msg = headers[i].msg_hdr;
+					sl_uint8* data = (sl_uint8*)(msg.msg_iov->iov_base);
+					sl_uint32 size = headers[i].msg_len;
+					sl_uint32 segment = size;
+					if (m_flagGro) {
+						for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+							if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+								int n = *((int*)(CMSG_DATA(cmsg)));
+								if (n > 0) {
+									segment = (sl_uint32)n;
+								}
+								break;
+							}
+						}
+					}
+					SocketAddress address;
+					address.setSystemSocketAddress(msg.msg_name, msg.msg_namelen);
+					sl_uint32 offset = 0;
+					do {
+						sl_uint32 n = size - offset;
+						if (n > segment) {
+							n = segment;
+						}
+						AsyncUdpDatagram& datagram = datagrams[nDatagrams];
+						datagram.address = address;
+						datagram.data = data + offset;
+						datagram.size = n;
+						nDatagrams++;
+						if (nDatagrams >= nDatagramsMax) {
+							_onReceiveBatch(datagrams, nDatagrams);
+							nDatagrams = 0;
+						}
+						offset += n;
+					} while (offset < size);
+				}
+				if (nDatagrams) {
+					_onReceiveBatch(datagrams, nDatagrams);
+				}
+				if ((sl_uint32)nReceived < nBatch) {
+					// the receive queue was drained
+					break;
+				}
+			}
+			return sl_true;
+		}
+#endif
 
 	};
 
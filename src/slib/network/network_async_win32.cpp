@@ -565,7 +565,7 @@ namespace slib
 			while (Thread::isNotStoppingCurrent()) {
 				SendRequest request;
 				if (m_queueSendRequests.pop(&request)) {
-					socket->sendTo(request.addressTo, request.data.getData(), (sl_uint32)(request.data.getSize()));
+					_sendSegments(socket.get(), request);
 				} else {
 					break;
 				}
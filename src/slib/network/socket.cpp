@@ -1061,6 +1061,16 @@ namespace slib
 #endif
 	}
 
+	sl_bool Socket::setOption_UdpGro(sl_bool flagEnable)
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// UDP_GRO (Linux 5.0) on SOL_UDP
+		return setOption(17, 104, flagEnable ? 1 : 0);
+#else
+		return sl_false;
+#endif
+	}
+
 	sl_bool Socket::setOption_IpAddMembership(const IPv4Address& ipMulticast, const IPv4Address& ipInterface)
 	{
 		ip_mreq mreq;
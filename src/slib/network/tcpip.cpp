@@ -23,30 +23,93 @@
 #include "slib/network/tcpip.h"
 
 #include "slib/core/mio.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+#	include <immintrin.h>
+#endif
 
 namespace slib
 {
 
-	sl_uint16 TCP_IP::calculateOneComplementSum(const void* data, sl_size size, sl_uint32 add)
-	{
-		sl_uint32 sum = add;
-		sl_uint8* p = (sl_uint8*)data;
-		while (size > 1) {
-			sl_uint16 w = *((sl_uint8*)(p));
-			w = (w << 8) | *((sl_uint8*)(p + 1));
-			sum += w; // can be computed in either byte order
-			p += 2;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+	static sl_bool _priv_TCP_IP_isAVX2()
+	{
+		static sl_bool flag = Cpu::isAVX2Supported();
+		return flag;
+	}
+
+	// Adds 32-bit words of the 64-byte blocks into 64-bit lanes
+	SLIB_CPU_TARGET("avx2")
+	static sl_uint64 _priv_TCP_IP_addWords_avx2(const sl_uint8* data, sl_size nBlocks)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i sum1 = zero;
+		__m256i sum2 = zero;
+		for (sl_size i = 0; i < nBlocks; i++) {
+			__m256i v1 = _mm256_loadu_si256((const __m256i*)data);
+			__m256i v2 = _mm256_loadu_si256((const __m256i*)(data + 32));
+			sum1 = _mm256_add_epi64(sum1, _mm256_unpacklo_epi32(v1, zero));
+			sum2 = _mm256_add_epi64(sum2, _mm256_unpackhi_epi32(v1, zero));
+			sum1 = _mm256_add_epi64(sum1, _mm256_unpacklo_epi32(v2, zero));
+			sum2 = _mm256_add_epi64(sum2, _mm256_unpackhi_epi32(v2, zero));
+			data += 64;
+		}
+		sl_uint64 lanes[4];
+		_mm256_storeu_si256((__m256i*)lanes, _mm256_add_epi64(sum1, sum2));
+		return (lanes[0] & 0xffffffff) + (lanes[0] >> 32) + (lanes[1] & 0xffffffff) + (lanes[1] >> 32) +
+			(lanes[2] & 0xffffffff) + (lanes[2] >> 32) + (lanes[3] & 0xffffffff) + (lanes[3] >> 32);
+	}
+#endif
+
+	/*
+		Words are added in little-endian order into a 64-bit accumulator and swapped to network order after folding,
+		because 1's complement sum is independent of the byte order (RFC 1071)
+	*/
+	sl_uint16 TCP_IP::calculateOneComplementSum(const void* _data, sl_size size, sl_uint32 add)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		sl_uint64 sum = 0;
+#if defined(SLIB_CPU_SUPPORT_SIMD_X86)
+		if (size >= 128 && _priv_TCP_IP_isAVX2()) {
+			sl_size nBlocks = size >> 6;
+			sum = _priv_TCP_IP_addWords_avx2(data, nBlocks);
+			nBlocks <<= 6;
+			data += nBlocks;
+			size -= nBlocks;
+		}
+#endif
+		while (size >= 16) {
+			sum += MIO::readUint32LE(data);
+			sum += MIO::readUint32LE(data + 4);
+			sum += MIO::readUint32LE(data + 8);
+			sum += MIO::readUint32LE(data + 12);
+			data += 16;
+			size -= 16;
+		}
+		while (size >= 4) {
+			sum += MIO::readUint32LE(data);
+			data += 4;
+			size -= 4;
+		}
+		if (size >= 2) {
+			sum += MIO::readUint16LE(data);
+			data += 2;
 			size -= 2;
 		}
 		if (size) {
-			sl_uint16 w = *((sl_uint8*)p);
-			w = w << 8;
-			sum += w;
+			sum += *data;
 		}
+		sum = (sum >> 32) + (sum & 0xffffffff);
+		while (sum >> 16) {
+			sum = (sum >> 16) + (sum & 0xffff);
+		}
+		sum = ((sum >> 8) & 0xff) | ((sum & 0xff) << 8);
+		sum += add;
 		while (sum >> 16) {
 			sum = (sum >> 16) + (sum & 0xffff); // 1's complement sum
 		}
-		return sum;
+		return (sl_uint16)sum;
 	}
 	
 	// Referenced from RFC 1071
@@ -57,6 +120,38 @@ namespace slib
 	}
 	
 	
+	// RFC 1624: HC' = ~(~HC + ~m + m')
+	sl_uint16 TCP_IP::adjustChecksum(sl_uint16 checksum, sl_uint16 oldValue, sl_uint16 newValue)
+	{
+		sl_uint32 sum = (sl_uint32)((sl_uint16)(~checksum)) + (sl_uint32)((sl_uint16)(~oldValue)) + newValue;
+		sum = (sum >> 16) + (sum & 0xffff);
+		sum += sum >> 16;
+		return (sl_uint16)(~sum);
+	}
+	
+	sl_uint16 TCP_IP::adjustChecksum(sl_uint16 checksum, const void* _oldData, const void* _newData, sl_size size)
+	{
+		const sl_uint8* oldData = (const sl_uint8*)_oldData;
+		const sl_uint8* newData = (const sl_uint8*)_newData;
+		sl_uint64 sum = (sl_uint16)(~checksum);
+		while (size >= 2) {
+			sum += (sl_uint16)(~MIO::readUint16BE(oldData));
+			sum += MIO::readUint16BE(newData);
+			oldData += 2;
+			newData += 2;
+			size -= 2;
+		}
+		if (size) {
+			sum += (sl_uint16)(~(((sl_uint32)(*oldData)) << 8));
+			sum += ((sl_uint32)(*newData)) << 8;
+		}
+		while (sum >> 16) {
+			sum = (sum >> 16) + (sum & 0xffff);
+		}
+		return (sl_uint16)(~sum);
+	}
+	
+	
 	void IPv4Packet::updateChecksum()
 	{
 		_headerChecksum[0] = 0;
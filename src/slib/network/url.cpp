@@ -151,7 +151,7 @@ namespace slib
 	{
 	}
 	
-	void Url::parse(const String& url)
+	void Url::parse(const StringView& url)
 	{
 		const sl_char8* str = url.getData();
 		sl_reg n = url.getLength();
@@ -221,7 +221,7 @@ namespace slib
 		}
 	}
 	
-	String _priv_URL_encodePercentByUTF8(const String& value, const sl_bool patternUnreserved[128])
+	String _priv_URL_encodePercentByUTF8(const StringView& value, const sl_bool patternUnreserved[128])
 	{
 		sl_size n = value.getLength();
 		if (n > 0) {
@@ -247,20 +247,28 @@ namespace slib
 		}
 	}
 	
-	String Url::encodePercentByUTF8(const String& value)
+	String Url::encodePercentByUTF8(const StringView& value)
 	{
 		return _priv_URL_encodePercentByUTF8(value, _priv_URL_unreserved_pattern);
 	}
 	
-	String Url::decodePercentByUTF8(const String& value)
+	String Url::decodePercentByUTF8(const StringView& value)
 	{
 		sl_size n = value.getLength();
 		if (n > 0) {
 			const sl_char8* src = value.getData();
-			sl_char8* dst = (sl_char8*)(Base::createMemory(n));
-			sl_size k = 0;
-			for (sl_size i = 0; i < n; i++) {
-				sl_uint32 v = (sl_uint32)(src[i]);
+			sl_reg indexPercent = value.indexOf('%');
+			if (indexPercent < 0) {
+				return String(value);
+			}
+			SLIB_SCOPED_BUFFER(sl_char8, 1024, dst, n);
+			if (dst == sl_null) {
+				return sl_null;
+			}
+			sl_size k = indexPercent;
+			Base::copyMemory(dst, src, k);
+			for (sl_size i = k; i < n; i++) {
+				sl_uint32 v = (sl_uint32)(sl_uint8)(src[i]);
 				if (v == '%') {
 					if (i + 2 < n) {
 						sl_uint32 a1 = (sl_uint32)(src[i + 1]);
@@ -276,34 +284,32 @@ namespace slib
 					} else {
 						dst[k++] = '%';
 					}
-				} else if (v < 256) {
+				} else {
 					dst[k++] = (sl_char8)(v);
 				}
 			}
-			String ret = String::fromUtf8(dst, k);
-			Base::freeMemory(dst);
-			return ret;
+			return String::fromUtf8(dst, k);
 		} else {
 			return sl_null;
 		}
 	}
 	
-	String Url::encodeUriComponentByUTF8(const String& value)
+	String Url::encodeUriComponentByUTF8(const StringView& value)
 	{
 		return _priv_URL_encodePercentByUTF8(value, _priv_URL_unreserved_pattern_uri_components);
 	}
 	
-	String Url::decodeUriComponentByUTF8(const String& value)
+	String Url::decodeUriComponentByUTF8(const StringView& value)
 	{
 		return decodePercentByUTF8(value);
 	}
 	
-	String Url::encodeUriByUTF8(const String& value)
+	String Url::encodeUriByUTF8(const StringView& value)
 	{
 		return _priv_URL_encodePercentByUTF8(value, _priv_URL_unreserved_pattern_uri);
 	}
 	
-	String Url::decodeUriByUTF8(const String& value)
+	String Url::decodeUriByUTF8(const StringView& value)
 	{
 		return decodePercentByUTF8(value);
 	}